@@ -68,6 +68,9 @@ float rf_gain = 70.0;
 char* rf_args = "";
 char* rf_dev  = "";
 
+double   wb_srate   = 0; // Wideband search sampling rate, 0 searches one EARFCN at a time
+uint32_t wb_workers = 0;
+
 void usage(char* prog)
 {
   printf("Usage: %s [agsendtvb] -b band\n", prog);
@@ -77,13 +80,15 @@ void usage(char* prog)
   printf("\t-s earfcn_start [Default All]\n");
   printf("\t-e earfcn_end [Default All]\n");
   printf("\t-n nof_frames_total [Default 100]\n");
+  printf("\t-w wideband search sampling rate, e.g. 19.2e6 [Default disabled]\n");
+  printf("\t-W wideband search worker threads [Default %d]\n", wb_workers);
   printf("\t-v [set srsran_verbose to debug, default none]\n");
 }
 
 void parse_args(int argc, char** argv)
 {
   int opt;
-  while ((opt = getopt(argc, argv, "agsendvb")) != -1) {
+  while ((opt = getopt(argc, argv, "agsendvbwW")) != -1) {
     switch (opt) {
       case 'a':
         rf_args = argv[optind];
@@ -106,6 +111,12 @@ void parse_args(int argc, char** argv)
       case 'g':
         rf_gain = strtof(argv[optind], NULL);
         break;
+      case 'w':
+        wb_srate = strtod(argv[optind], NULL);
+        break;
+      case 'W':
+        wb_workers = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
       case 'v':
         increase_srsran_verbose_level();
         break;
@@ -141,6 +152,106 @@ static SRSRAN_AGC_CALLBACK(srsran_rf_set_rx_gain_wrapper)
   srsran_rf_set_rx_gain((srsran_rf_t*)h, gain_db);
 }
 
+/* Decodes the MIB of a cell found by the PSS search on a channel, and keeps it if successful */
+static void decode_found_cell(srsran_rf_t*                         rf,
+                              const srsran_earfcn_t*               channel,
+                              const srsran_ue_cellsearch_result_t* found_cell,
+                              int                                  N_id_2,
+                              uint32_t*                            n_found_cells)
+{
+  srsran_cell_t cell;
+  cell.id = found_cell->cell_id;
+  cell.cp = found_cell->cp;
+  int ret = rf_mib_decoder(rf, 1, &cell_detect_config, &cell, NULL);
+  if (ret < 0) {
+    ERROR("Error decoding MIB");
+    exit(-1);
+  }
+  if (ret == SRSRAN_UE_MIB_FOUND) {
+    printf("Found CELL ID %d. %d PRB, %d ports\n", cell.id, cell.nof_prb, cell.nof_ports);
+    if (cell.nof_ports > 0) {
+      results[*n_found_cells].cell      = cell;
+      results[*n_found_cells].freq      = channel->fd;
+      results[*n_found_cells].dl_earfcn = channel->id;
+      results[*n_found_cells].power     = found_cell->peak;
+      results[*n_found_cells].N_id_2    = N_id_2;
+      (*n_found_cells)++;
+    }
+  }
+}
+
+/* Searches the EARFCN list in chunks as wide as the wideband sampling rate allows, with one capture per chunk. The
+ * EARFCNs are consecutive, so a carrier offset in raster steps is an offset in the list */
+static void scan_wideband(srsran_rf_t* rf, srsran_earfcn_t* channels, int nof_freqs, uint32_t* n_found_cells)
+{
+  srsran_ue_cellsearch_wb_t        cs_wb             = {};
+  srsran_ue_cellsearch_wb_args_t   wb_args           = {};
+  srsran_ue_cellsearch_wb_result_t found[MAX_EARFCN] = {};
+
+  srsran_ue_cellsearch_wb_args_default(&wb_args);
+  wb_args.srate_hz    = wb_srate;
+  wb_args.max_samples = (uint32_t)(wb_srate * FLEN_PERIOD) * cell_detect_config.max_frames_pss;
+  wb_args.nof_workers = wb_workers;
+  if (cell_detect_config.max_frames_pss) {
+    wb_args.nof_valid_frames = cell_detect_config.nof_valid_pss_frames;
+  }
+  if (srsran_ue_cellsearch_wb_init(&cs_wb, &wb_args)) {
+    ERROR("Error initiating wideband cell search");
+    exit(-1);
+  }
+
+  cf_t* capture = srsran_vec_cf_malloc(wb_args.max_samples);
+  if (capture == NULL) {
+    perror("malloc");
+    exit(-1);
+  }
+
+  int half_span = (int)cs_wb.nof_carriers / 2;
+  for (int start = 0; start < nof_freqs && !go_exit; start += 2 * half_span + 1) {
+    int center = SRSRAN_MIN(start + half_span, nof_freqs - 1);
+
+    srsran_rf_set_rx_freq(rf, 0, (double)channels[center].fd * MHZ);
+    srsran_rf_set_rx_srate(rf, wb_srate);
+    printf("[%3d/%d]: EARFCN %d-%d around %.2f MHz looking for PSS.\n",
+           start,
+           nof_freqs,
+           channels[start].id,
+           channels[SRSRAN_MIN(start + 2 * half_span, nof_freqs - 1)].id,
+           channels[center].fd);
+    fflush(stdout);
+
+    // Capture the whole chunk at once
+    srsran_rf_start_rx_stream(rf, false);
+    uint32_t nof_samples = 0;
+    while (nof_samples < wb_args.max_samples) {
+      int n = srsran_rf_recv_with_time(rf, &capture[nof_samples], wb_args.max_samples - nof_samples, true, NULL, NULL);
+      if (n < 0) {
+        ERROR("Error receiving samples");
+        exit(-1);
+      }
+      nof_samples += (uint32_t)n;
+    }
+    srsran_rf_stop_rx_stream(rf);
+
+    int n = srsran_ue_cellsearch_wb_scan(&cs_wb, capture, nof_samples, found, MAX_EARFCN);
+    if (n < 0) {
+      ERROR("Error searching cell");
+      exit(-1);
+    }
+    for (int i = 0; i < n; i++) {
+      int idx = center + (int)lround(found[i].freq_offset_hz / SRSRAN_CS_WB_RASTER_HZ);
+      if (idx < start || idx >= nof_freqs || idx > start + 2 * half_span || found[i].cell.psr <= 2.0) {
+        continue;
+      }
+      srsran_rf_set_rx_freq(rf, 0, (double)channels[idx].fd * MHZ);
+      decode_found_cell(rf, &channels[idx], &found[i].cell, (int)(found[i].cell.cell_id % 3), n_found_cells);
+    }
+  }
+
+  free(capture);
+  srsran_ue_cellsearch_wb_free(&cs_wb);
+}
+
 int main(int argc, char** argv)
 {
   int                           n;
@@ -205,6 +316,11 @@ int main(int argc, char** argv)
                              cell_detect_config.init_agc);
   }
 
+  if (wb_srate > 0) {
+    scan_wideband(&rf, channels, nof_freqs, &n_found_cells);
+    nof_freqs = 0;
+  }
+
   for (freq = 0; freq < nof_freqs && !go_exit; freq++) {
     /* set rf_freq */
     srsran_rf_set_rx_freq(&rf, 0, (double)channels[freq].fd * MHZ);
@@ -232,25 +348,7 @@ int main(int argc, char** argv)
     } else if (n > 0) {
       for (int i = 0; i < 3; i++) {
         if (found_cells[i].psr > 2.0) {
-          srsran_cell_t cell;
-          cell.id = found_cells[i].cell_id;
-          cell.cp = found_cells[i].cp;
-          int ret = rf_mib_decoder(&rf, 1, &cell_detect_config, &cell, NULL);
-          if (ret < 0) {
-            ERROR("Error decoding MIB");
-            exit(-1);
-          }
-          if (ret == SRSRAN_UE_MIB_FOUND) {
-            printf("Found CELL ID %d. %d PRB, %d ports\n", cell.id, cell.nof_prb, cell.nof_ports);
-            if (cell.nof_ports > 0) {
-              results[n_found_cells].cell      = cell;
-              results[n_found_cells].freq      = channels[freq].fd;
-              results[n_found_cells].dl_earfcn = channels[freq].id;
-              results[n_found_cells].power     = found_cells[i].peak;
-              results[n_found_cells].N_id_2    = i;
-              n_found_cells++;
-            }
-          }
+          decode_found_cell(&rf, &channels[freq], &found_cells[i], i, &n_found_cells);
         }
       }
     }
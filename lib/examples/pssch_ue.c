@@ -28,14 +28,11 @@
 #include <unistd.h>
 
 #include "srsran/common/pcap.h"
-#include "srsran/phy/ch_estimation/chest_sl.h"
 #include "srsran/phy/common/phy_common_sl.h"
 #include "srsran/phy/dft/ofdm.h"
-#include "srsran/phy/phch/pscch.h"
-#include "srsran/phy/phch/pssch.h"
-#include "srsran/phy/phch/ra_sl.h"
 #include "srsran/phy/phch/sci.h"
 #include "srsran/phy/rf/rf.h"
+#include "srsran/phy/ue/ue_sl_rx.h"
 #include "srsran/phy/ue/ue_sync.h"
 #include "srsran/phy/utils/bit.h"
 #include "srsran/phy/utils/debug.h"
@@ -55,6 +52,7 @@ typedef struct {
   char*    input_file_name;
   uint32_t file_start_sf_idx;
   uint32_t nof_rx_antennas;
+  uint32_t nof_workers;
   char*    rf_dev;
   char*    rf_args;
   double   rf_freq;
@@ -72,6 +70,7 @@ void args_default(prog_args_t* args)
   args->input_file_name        = NULL;
   args->file_start_sf_idx      = 0;
   args->nof_rx_antennas        = 1;
+  args->nof_workers            = 0;
   args->rf_dev                 = "";
   args->rf_args                = "";
   args->rf_freq                = 5.92e9;
@@ -80,8 +79,7 @@ void args_default(prog_args_t* args)
   args->num_sub_channel        = 5;
 }
 
-static srsran_pscch_t pscch = {}; // Defined global for plotting thread
-static srsran_pssch_t pssch = {};
+static srsran_ue_sl_rx_t ue_sl_rx = {};
 
 #ifndef DISABLE_RF
 static srsran_rf_t radio;
@@ -96,6 +94,9 @@ static srsran_filesource_t fsrc = {};
 void             init_plots();
 static pthread_t plot_thread;
 static sem_t     plot_sem;
+
+// Last decoded result, defined global for plotting thread
+static const srsran_ue_sl_rx_result_t* plot_result = NULL;
 #endif // ENABLE_GUI
 
 void sig_int_handler(int signo)
@@ -142,6 +143,7 @@ void usage(prog_args_t* args, char* prog)
   printf("\t-m Start subframe_idx [Default %d]\n", args->file_start_sf_idx);
   printf("\t-g RF Gain [Default %.2f dB]\n", args->rf_gain);
   printf("\t-A nof_rx_antennas [Default %d]\n", args->nof_rx_antennas);
+  printf("\t-W nof_workers searching sub-channels in parallel [Default %d]\n", args->nof_workers);
   printf("\t-c N_sl_id [Default %d]\n", cell_sl.N_sl_id);
   printf("\t-p nof_prb [Default %d]\n", cell_sl.nof_prb);
   printf("\t-s size_sub_channel [Default for 50 prbs %d]\n", args->size_sub_channel);
@@ -159,7 +161,7 @@ void parse_args(prog_args_t* args, int argc, char** argv)
   int opt;
   args_default(args);
 
-  while ((opt = getopt(argc, argv, "acdimgpvwrxfA")) != -1) {
+  while ((opt = getopt(argc, argv, "acdimgpvwrxfAW")) != -1) {
     switch (opt) {
       case 'a':
         args->rf_args = argv[optind];
@@ -188,6 +190,9 @@ void parse_args(prog_args_t* args, int argc, char** argv)
       case 'A':
         args->nof_rx_antennas = (int32_t)strtol(argv[optind], NULL, 10);
         break;
+      case 'W':
+        args->nof_workers = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
       case 'v':
         increase_srsran_verbose_level();
         break;
@@ -301,9 +306,6 @@ int main(int argc, char** argv)
     }
   }
 
-  uint32_t sf_n_re             = SRSRAN_CP_NSYMB(SRSRAN_CP_NORM) * SRSRAN_NRE * 2 * cell_sl.nof_prb;
-  cf_t*    equalized_sf_buffer = srsran_vec_malloc(sizeof(cf_t) * sf_n_re);
-
   // RX
   srsran_ofdm_t     fft[SRSRAN_MAX_PORTS] = {};
   srsran_ofdm_cfg_t ofdm_cfg = {};
@@ -323,44 +325,21 @@ int main(int argc, char** argv)
     }
   }
 
-  // SCI
-  srsran_sci_t sci;
-  srsran_sci_init(&sci, &cell_sl, &sl_comm_resource_pool);
-  uint8_t sci_rx[SRSRAN_SCI_MAX_LEN]      = {};
-  char    sci_msg[SRSRAN_SCI_MSG_MAX_LEN] = {};
-
-  // init PSCCH object
-  if (srsran_pscch_init(&pscch, SRSRAN_MAX_PRB) != SRSRAN_SUCCESS) {
-    ERROR("Error in PSCCH init");
-    return SRSRAN_ERROR;
-  }
-
-  if (srsran_pscch_set_cell(&pscch, cell_sl) != SRSRAN_SUCCESS) {
-    ERROR("Error in PSCCH set cell");
-    return SRSRAN_ERROR;
-  }
-
-  // PSCCH Channel estimation
-  srsran_chest_sl_cfg_t pscch_chest_sl_cfg = {};
-  srsran_chest_sl_t     pscch_chest        = {};
-  if (srsran_chest_sl_init(&pscch_chest, SRSRAN_SIDELINK_PSCCH, cell_sl, &sl_comm_resource_pool) != SRSRAN_SUCCESS) {
-    ERROR("Error in chest PSCCH init");
-    return SRSRAN_ERROR;
-  }
-
-  if (srsran_pssch_init(&pssch, &cell_sl, &sl_comm_resource_pool) != SRSRAN_SUCCESS) {
-    ERROR("Error initializing PSSCH");
-    return SRSRAN_ERROR;
-  }
-
-  srsran_chest_sl_cfg_t pssch_chest_sl_cfg = {};
-  srsran_chest_sl_t     pssch_chest        = {};
-  if (srsran_chest_sl_init(&pssch_chest, SRSRAN_SIDELINK_PSSCH, cell_sl, &sl_comm_resource_pool) != SRSRAN_SUCCESS) {
-    ERROR("Error in chest PSSCH init");
+  // Sidelink receiver, searching every sub-channel of the pool
+  srsran_ue_sl_rx_args_t ue_sl_rx_args = {};
+  srsran_ue_sl_rx_args_default(&ue_sl_rx_args);
+  ue_sl_rx_args.nof_workers  = prog_args.nof_workers;
+  ue_sl_rx_args.decode_pssch = true;
+  ue_sl_rx_args.keep_symbols = SRSRAN_VERBOSE_ISDEBUG();
+#ifdef ENABLE_GUI
+  ue_sl_rx_args.keep_symbols |= !prog_args.disable_plots;
+#endif
+  if (srsran_ue_sl_rx_init(&ue_sl_rx, cell_sl, &sl_comm_resource_pool, &ue_sl_rx_args) != SRSRAN_SUCCESS) {
+    ERROR("Error initializing sidelink receiver");
     return SRSRAN_ERROR;
   }
 
-  uint8_t tb[SRSRAN_SL_SCH_MAX_TB_LEN]            = {};
+  char    sci_msg[SRSRAN_SCI_MSG_MAX_LEN]         = {};
   uint8_t packed_tb[SRSRAN_SL_SCH_MAX_TB_LEN / 8] = {};
 
 #ifndef DISABLE_RF
@@ -399,8 +378,7 @@ int main(int argc, char** argv)
   }
 #endif
 
-  uint32_t subframe_count      = 0;
-  uint32_t pscch_prb_start_idx = 0;
+  uint32_t subframe_count = 0;
 
   uint32_t current_sf_idx = 0;
   if (prog_args.input_file_name) {
@@ -436,106 +414,60 @@ int main(int argc, char** argv)
     // do FFT (on first port)
     srsran_ofdm_rx_sf(&fft[0]);
 
-    for (int sub_channel_idx = 0; sub_channel_idx < sl_comm_resource_pool.num_sub_channel; sub_channel_idx++) {
-      pscch_prb_start_idx = sub_channel_idx * sl_comm_resource_pool.size_sub_channel;
+    if (srsran_ue_sl_rx_decode_sf(&ue_sl_rx, sf_buffer[0], current_sf_idx) < SRSRAN_SUCCESS) {
+      ERROR("Error decoding sidelink subframe");
+      goto clean_exit;
+    }
 
-      for (uint32_t cyclic_shift = 0; cyclic_shift <= 9; cyclic_shift += 3) {
-        // PSCCH Channel estimation
-        pscch_chest_sl_cfg.cyclic_shift  = cyclic_shift;
-        pscch_chest_sl_cfg.prb_start_idx = pscch_prb_start_idx;
-        srsran_chest_sl_set_cfg(&pscch_chest, pscch_chest_sl_cfg);
-        srsran_chest_sl_ls_estimate_equalize(&pscch_chest, sf_buffer[0], equalized_sf_buffer);
+    for (uint32_t sub_channel_idx = 0; sub_channel_idx < sl_comm_resource_pool.num_sub_channel; sub_channel_idx++) {
+      const srsran_ue_sl_rx_result_t* res = &ue_sl_rx.results[sub_channel_idx];
+      if (!res->sci_decoded) {
+        continue;
+      }
 
-        if (srsran_pscch_decode(&pscch, equalized_sf_buffer, sci_rx, pscch_prb_start_idx) == SRSRAN_SUCCESS) {
-          if (srsran_sci_format1_unpack(&sci, sci_rx) == SRSRAN_SUCCESS) {
-            srsran_sci_info(&sci, sci_msg, sizeof(sci_msg));
-            fprintf(stdout, "%s", sci_msg);
+      srsran_sci_info(&res->sci, sci_msg, sizeof(sci_msg));
+      fprintf(stdout, "%s", sci_msg);
 
-            num_decoded_sci++;
+      num_decoded_sci++;
 
-            // plot PSCCH
 #ifdef ENABLE_GUI
-            if (!prog_args.disable_plots) {
-              sem_post(&plot_sem);
-            }
+      // plot PSCCH
+      if (!prog_args.disable_plots) {
+        plot_result = res;
+        sem_post(&plot_sem);
+      }
 #endif
 
-            // Decode PSSCH
-            uint32_t sub_channel_start_idx = 0;
-            uint32_t L_subCH               = 0;
-            srsran_ra_sl_type0_from_riv(
-                sci.riv, sl_comm_resource_pool.num_sub_channel, &L_subCH, &sub_channel_start_idx);
-
-            // 3GPP TS 36.213 Section 14.1.1.4C
-            uint32_t pssch_prb_start_idx = (sub_channel_idx * sl_comm_resource_pool.size_sub_channel) +
-                                           pscch.pscch_nof_prb + sl_comm_resource_pool.start_prb_sub_channel;
-            uint32_t nof_prb_pssch = ((L_subCH + sub_channel_idx) * sl_comm_resource_pool.size_sub_channel) -
-                                     pssch_prb_start_idx + sl_comm_resource_pool.start_prb_sub_channel;
-
-            // make sure PRBs are valid for DFT precoding
-            nof_prb_pssch = srsran_dft_precoding_get_valid_prb(nof_prb_pssch);
-
-            uint32_t N_x_id = 0;
-            for (int j = 0; j < SRSRAN_SCI_CRC_LEN; j++) {
-              N_x_id += pscch.sci_crc[j] * exp2(SRSRAN_SCI_CRC_LEN - 1 - j);
-            }
-
-            uint32_t rv_idx = 0;
-            if (sci.retransmission == true) {
-              rv_idx = 1;
-            }
-
-            // PSSCH Channel estimation
-            pssch_chest_sl_cfg.N_x_id        = N_x_id;
-            pssch_chest_sl_cfg.sf_idx        = current_sf_idx;
-            pssch_chest_sl_cfg.prb_start_idx = pssch_prb_start_idx;
-            pssch_chest_sl_cfg.nof_prb       = nof_prb_pssch;
-            srsran_chest_sl_set_cfg(&pssch_chest, pssch_chest_sl_cfg);
-            srsran_chest_sl_ls_estimate_equalize(&pssch_chest, sf_buffer[0], equalized_sf_buffer);
-
-            srsran_pssch_cfg_t pssch_cfg = {
-                pssch_prb_start_idx, nof_prb_pssch, N_x_id, sci.mcs_idx, rv_idx, current_sf_idx};
-            if (srsran_pssch_set_cfg(&pssch, pssch_cfg) == SRSRAN_SUCCESS) {
-              if (srsran_pssch_decode(&pssch, equalized_sf_buffer, tb, SRSRAN_SL_SCH_MAX_TB_LEN) == SRSRAN_SUCCESS) {
-                num_decoded_tb++;
-
-                // pack bit sand write to PCAP
-                srsran_bit_pack_vector(tb, packed_tb, pssch.sl_sch_tb_len);
-                pcap_pack_and_write(pcap_file,
-                                    packed_tb,
-                                    pssch.sl_sch_tb_len / 8,
-                                    0,
-                                    true,
-                                    current_sf_idx,
-                                    0x1001,
-                                    DIRECTION_UPLINK,
-                                    SL_RNTI);
+      if (SRSRAN_VERBOSE_ISDEBUG() && res->nof_pscch_symbols > 0) {
+        char filename[64];
+        snprintf(filename,
+                 64,
+                 "pscch_rx_syms_sf%d_shift%d_prbidx%d.bin",
+                 subframe_count,
+                 res->cyclic_shift,
+                 sub_channel_idx * sl_comm_resource_pool.size_sub_channel);
+        printf("Saving PSCCH symbols (%d) to %s\n", res->nof_pscch_symbols, filename);
+        srsran_vec_save_file(filename, res->pscch_symbols, res->nof_pscch_symbols * sizeof(cf_t));
+      }
+
+      if (res->tb_decoded) {
+        num_decoded_tb++;
+
+        // pack bit sand write to PCAP
+        srsran_bit_pack_vector(res->tb, packed_tb, res->tb_len);
+        pcap_pack_and_write(
+            pcap_file, packed_tb, res->tb_len / 8, 0, true, current_sf_idx, 0x1001, DIRECTION_UPLINK, SL_RNTI);
 
 #ifdef ENABLE_GUI
-                // plot PSSCH
-                if (!prog_args.disable_plots) {
-                  sem_post(&plot_sem);
-                }
-                if (prog_args.input_file_name) {
-                  printf("Press Enter to continue ...\n");
-                  getchar();
-                }
-#endif
-              }
-            }
-          }
+        // plot PSSCH
+        if (!prog_args.disable_plots) {
+          sem_post(&plot_sem);
         }
-        if (SRSRAN_VERBOSE_ISDEBUG()) {
-          char filename[64];
-          snprintf(filename,
-                   64,
-                   "pscch_rx_syms_sf%d_shift%d_prbidx%d.bin",
-                   subframe_count,
-                   cyclic_shift,
-                   pscch_prb_start_idx);
-          printf("Saving PSCCH symbols (%d) to %s\n", pscch.E / SRSRAN_PSCCH_QM, filename);
-          srsran_vec_save_file(filename, pscch.mod_symbols, pscch.E / SRSRAN_PSCCH_QM * sizeof(cf_t));
+        if (prog_args.input_file_name) {
+          printf("Press Enter to continue ...\n");
+          getchar();
         }
+#endif
       }
     }
 
@@ -569,10 +501,7 @@ clean_exit:
   srsran_ue_sync_free(&ue_sync);
 #endif // DISABLE_RF
 
-  srsran_sci_free(&sci);
-  srsran_pscch_free(&pscch);
-  srsran_chest_sl_free(&pscch_chest);
-  srsran_chest_sl_free(&pssch_chest);
+  srsran_ue_sl_rx_free(&ue_sl_rx);
 
   for (int i = 0; i < prog_args.nof_rx_antennas; i++) {
     if (rx_buffer[i]) {
@@ -584,10 +513,6 @@ clean_exit:
     srsran_ofdm_rx_free(&fft[i]);
   }
 
-  if (equalized_sf_buffer) {
-    free(equalized_sf_buffer);
-  }
-
   return SRSRAN_SUCCESS;
 }
 
@@ -616,9 +541,13 @@ void* plot_thread_run(void* arg)
 
   while (keep_running) {
     sem_wait(&plot_sem);
-    plot_scatter_setNewData(&pscatequal_pscch, pscch.mod_symbols, pscch.E / SRSRAN_PSCCH_QM);
-    if (pssch.G > 0 && pssch.Qm > 0) {
-      plot_scatter_setNewData(&pscatequal_pssch, pssch.symbols, pssch.G / pssch.Qm);
+    const srsran_ue_sl_rx_result_t* res = plot_result;
+    if (res == NULL) {
+      continue;
+    }
+    plot_scatter_setNewData(&pscatequal_pscch, res->pscch_symbols, res->nof_pscch_symbols);
+    if (res->nof_pssch_symbols > 0) {
+      plot_scatter_setNewData(&pscatequal_pssch, res->pssch_symbols, res->nof_pssch_symbols);
     }
   }
 
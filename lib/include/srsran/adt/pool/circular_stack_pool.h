@@ -24,6 +24,7 @@
 
 #include "batch_mem_pool.h"
 #include "linear_allocator.h"
+#include "pool_interface.h"
 #include "srsran/adt/circular_array.h"
 #include <mutex>
 
@@ -0,0 +1,173 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSRAN_TTI_ARENA_H
+#define SRSRAN_TTI_ARENA_H
+
+#include "linear_allocator.h"
+#include <memory>
+#include <string>
+
+namespace srsran {
+
+/**
+ * Bump arena owned by a single PHY worker. Scratch memory requested while processing a TTI is served from a
+ * preallocated memory block and released in one go when the TTI finishes, avoiding malloc/free in the real-time path.
+ * Requests that do not fit in the arena are counted and served from the heap. This class is not thread-safe.
+ */
+class tti_arena
+{
+public:
+  explicit tti_arena(size_t sz) : mem(new uint8_t[sz]), alloc(mem.get(), sz) {}
+  tti_arena(const tti_arena&) = delete;
+  tti_arena& operator=(const tti_arena&) = delete;
+
+  /// Allocates "sz" bytes from the arena. Returns nullptr if the arena is exhausted
+  void* allocate(size_t sz, size_t alignment)
+  {
+    void* p = alloc.allocate(sz, alignment);
+    if (p == nullptr) {
+      nof_overflows++;
+    }
+    return p;
+  }
+
+  bool contains(const void* p) const
+  {
+    return static_cast<const uint8_t*>(p) >= mem.get() and static_cast<const uint8_t*>(p) < mem.get() + alloc.size();
+  }
+
+  /// Releases all the memory allocated since the last reset
+  void reset()
+  {
+    max_bytes_used = std::max(max_bytes_used, alloc.nof_bytes_allocated());
+    alloc          = linear_allocator(mem.get(), alloc.size());
+  }
+
+  size_t size() const { return alloc.size(); }
+  size_t nof_bytes_allocated() const { return alloc.nof_bytes_allocated(); }
+  size_t max_bytes_allocated() const { return std::max(max_bytes_used, alloc.nof_bytes_allocated()); }
+  size_t get_nof_overflows() const { return nof_overflows; }
+
+  /// Arena of the TTI currently being processed by the calling thread, or nullptr if none
+  static tti_arena* current() { return current_arena_ptr(); }
+
+private:
+  friend class tti_arena_scope;
+
+  static tti_arena*& current_arena_ptr()
+  {
+    static thread_local tti_arena* arena = nullptr;
+    return arena;
+  }
+
+  std::unique_ptr<uint8_t[]> mem;
+  linear_allocator           alloc;
+  size_t                     max_bytes_used = 0;
+  size_t                     nof_overflows  = 0;
+};
+
+/// RAII scope that makes an arena the current arena of the calling thread and resets it when the TTI ends
+class tti_arena_scope
+{
+public:
+  explicit tti_arena_scope(tti_arena& arena_) : arena(arena_), prev(tti_arena::current_arena_ptr())
+  {
+    tti_arena::current_arena_ptr() = &arena;
+  }
+  tti_arena_scope(const tti_arena_scope&) = delete;
+  tti_arena_scope& operator=(const tti_arena_scope&) = delete;
+  ~tti_arena_scope()
+  {
+    tti_arena::current_arena_ptr() = prev;
+    arena.reset();
+  }
+
+private:
+  tti_arena& arena;
+  tti_arena* prev;
+};
+
+/**
+ * STL allocator that takes memory from the arena that is current at construction time, and falls back to the heap
+ * if there is none or if it is exhausted. Containers using it must not outlive the TTI in which they were created.
+ * @tparam T object type
+ */
+template <typename T>
+class tti_arena_allocator
+{
+public:
+  using value_type = T;
+
+  tti_arena_allocator() noexcept : arena(tti_arena::current()) {}
+  explicit tti_arena_allocator(tti_arena* arena_) noexcept : arena(arena_) {}
+  template <typename U>
+  tti_arena_allocator(const tti_arena_allocator<U>& other) noexcept : arena(other.get_arena())
+  {}
+
+  T* allocate(size_t n)
+  {
+    if (arena != nullptr) {
+      void* p = arena->allocate(n * sizeof(T), alignof(T));
+      if (p != nullptr) {
+        return static_cast<T*>(p);
+      }
+    }
+    return std::allocator<T>().allocate(n);
+  }
+  void deallocate(T* p, size_t n) noexcept
+  {
+    if (arena != nullptr and arena->contains(p)) {
+      // released in bulk when the arena is reset
+      return;
+    }
+    std::allocator<T>().deallocate(p, n);
+  }
+
+  tti_arena* get_arena() const { return arena; }
+
+  template <typename U>
+  struct rebind {
+    using other = tti_arena_allocator<U>;
+  };
+
+private:
+  tti_arena* arena;
+};
+
+template <typename T1, typename T2>
+bool operator==(const tti_arena_allocator<T1>& lhs, const tti_arena_allocator<T2>& rhs) noexcept
+{
+  return lhs.get_arena() == rhs.get_arena();
+}
+
+template <typename T1, typename T2>
+bool operator!=(const tti_arena_allocator<T1>& lhs, const tti_arena_allocator<T2>& rhs) noexcept
+{
+  return not(lhs == rhs);
+}
+
+/// String whose storage is taken from the TTI arena. It must not outlive the TTI in which it was created
+using tti_arena_string = std::basic_string<char, std::char_traits<char>, tti_arena_allocator<char>>;
+
+} // namespace srsran
+
+#endif // SRSRAN_TTI_ARENA_H
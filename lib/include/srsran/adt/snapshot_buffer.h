@@ -0,0 +1,94 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSRAN_SNAPSHOT_BUFFER_H
+#define SRSRAN_SNAPSHOT_BUFFER_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/**
+ *
+ * @file snapshot_buffer.h
+ *
+ * @brief Lock-free hand-over of the latest value of an object from one writer thread to one reader thread
+ *
+ * The object is stored three times. The writer fills its own copy and publishes it, the reader takes the last
+ * published copy, and the third one is exchanged between them with a single atomic operation. Neither side ever
+ * waits for the other or sees a copy the other side is modifying, so T does not need to be trivially copyable and a
+ * published snapshot is never torn. Snapshots published before the reader takes one are overwritten.
+ */
+
+namespace srsran {
+
+template <typename T>
+class snapshot_buffer
+{
+  static constexpr uint8_t index_mask = 0x3;
+  static constexpr uint8_t fresh_flag = 0x4;
+
+public:
+  snapshot_buffer() = default;
+  explicit snapshot_buffer(const T& init_val) : slots{{init_val, init_val, init_val}} {}
+
+  snapshot_buffer(const snapshot_buffer&) = delete;
+  snapshot_buffer& operator=(const snapshot_buffer&) = delete;
+
+  /// Writer side. Copy owned by the writer until publish() is called
+  T& write_buffer() { return slots[back]; }
+
+  /// Writer side. Makes the write buffer the latest snapshot and hands the writer a copy the reader released
+  void publish()
+  {
+    uint8_t prev = middle.exchange(back | fresh_flag, std::memory_order_acq_rel);
+    back         = prev & index_mask;
+  }
+
+  /// Reader side. Takes the latest snapshot if one was published since the last call, returns whether it did
+  bool update()
+  {
+    if ((middle.load(std::memory_order_relaxed) & fresh_flag) == 0) {
+      return false;
+    }
+    uint8_t prev = middle.exchange(front, std::memory_order_acq_rel);
+    front        = prev & index_mask;
+    nof_reads++;
+    return true;
+  }
+
+  /// Reader side. Snapshot taken by the last successful update(), owned by the reader
+  const T& read_buffer() const { return slots[front]; }
+
+  /// Reader side. Whether update() ever took a snapshot
+  bool has_snapshot() const { return nof_reads > 0; }
+
+private:
+  std::array<T, 3>     slots{};
+  uint8_t              back  = 0; ///< Only accessed by the writer
+  uint8_t              front = 1; ///< Only accessed by the reader
+  std::atomic<uint8_t> middle{2};
+  uint64_t             nof_reads = 0; ///< Only accessed by the reader
+};
+
+} // namespace srsran
+
+#endif // SRSRAN_SNAPSHOT_BUFFER_H
@@ -0,0 +1,114 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSRAN_CPU_TOPOLOGY_H
+#define SRSRAN_CPU_TOPOLOGY_H
+
+#include <pthread.h>
+#include <sched.h>
+#include <string>
+#include <vector>
+
+namespace srsran {
+
+/// Description of a logical CPU of the host
+struct cpu_desc_t {
+  uint32_t id         = 0;
+  uint32_t core_id    = 0; ///< Physical core within the package. SMT siblings share the same core_id and package_id
+  uint32_t package_id = 0;
+  uint32_t numa_node  = 0;
+  bool     isolated   = false; ///< CPU listed in the kernel "isolcpus" set
+};
+
+/// Layout of the online CPUs of the host, as reported by sysfs
+class cpu_topology
+{
+public:
+  /// Reads the topology from "<sysfs_root>/cpu" and "<sysfs_root>/node". Returns an empty topology on failure
+  static cpu_topology from_sysfs(const std::string& sysfs_root = "/sys/devices/system");
+
+  const std::vector<cpu_desc_t>& cpus() const { return cpu_list; }
+  bool                           empty() const { return cpu_list.empty(); }
+  uint32_t                       nof_numa_nodes() const;
+  uint32_t                       nof_physical_cores() const;
+
+private:
+  std::vector<cpu_desc_t> cpu_list;
+};
+
+/**
+ * Assignment of the application threads to CPUs. Each real-time thread gets a physical core of its own, preferring
+ * isolated cores and keeping the SMT siblings of the reserved cores idle. Remaining CPUs are shared by the
+ * non real-time threads (stack, logging, gateway).
+ */
+class cpu_placement
+{
+public:
+  explicit cpu_placement(cpu_topology topo_);
+
+  /**
+   * Reserves a physical core for a real-time thread.
+   * @param thread_name name printed in the placement report
+   * @param numa_node preferred NUMA node, or -1 to use the node with the most free cores
+   * @return logical CPU id, or -1 if there are no free physical cores left
+   */
+  int reserve_rt_cpu(const std::string& thread_name, int numa_node = -1);
+
+  /// CPUs not reserved by real-time threads or their SMT siblings. If all are reserved, all CPUs are returned
+  std::vector<uint32_t> get_shared_cpus() const;
+  int                   get_numa_node(uint32_t cpu) const;
+
+  const cpu_topology& topology() const { return topo; }
+  std::string         to_string() const;
+
+private:
+  struct rt_thread_t {
+    std::string name;
+    uint32_t    cpu;
+  };
+
+  bool is_core_free(const cpu_desc_t& c) const;
+
+  cpu_topology             topo;
+  std::vector<bool>        core_reserved; ///< indexed by position in topo.cpus()
+  std::vector<rt_thread_t> rt_threads;
+};
+
+/**
+ * Restricts the calling thread to a set of CPUs and restores its previous affinity on destruction. Memory first
+ * touched within this scope is placed by the kernel on the NUMA node of those CPUs.
+ */
+class scoped_cpu_affinity
+{
+public:
+  explicit scoped_cpu_affinity(const std::vector<uint32_t>& cpus);
+  scoped_cpu_affinity(const scoped_cpu_affinity&) = delete;
+  scoped_cpu_affinity& operator=(const scoped_cpu_affinity&) = delete;
+  ~scoped_cpu_affinity();
+
+private:
+  cpu_set_t prev_set = {};
+  bool      restore  = false;
+};
+
+} // namespace srsran
+
+#endif // SRSRAN_CPU_TOPOLOGY_H
@@ -0,0 +1,116 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSRAN_METRICS_PERIOD_H
+#define SRSRAN_METRICS_PERIOD_H
+
+#include "srsran/adt/snapshot_buffer.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/**
+ *
+ * @file metrics_period.h
+ *
+ * @brief Metrics published per reporting period by the thread of each layer
+ *
+ * Reporting periods are numbered from the steady clock, so every layer agrees on the period a counter belongs to
+ * without synchronising with the others. A layer closes a period from its own thread the first time it runs in the
+ * next one and publishes what it counted through a snapshot_buffer. The metrics thread then asks every layer for the
+ * same closed period, so that the metrics of different layers always cover the same time.
+ */
+
+namespace srsran {
+
+class metrics_period_clock
+{
+public:
+  explicit metrics_period_clock(uint32_t period_ms = 0) { set_period(period_ms); }
+
+  /// Sets the length of the periods. 0 selects the default of 1 s
+  void set_period(uint32_t period_ms) { period = std::chrono::milliseconds(period_ms > 0 ? period_ms : 1000); }
+
+  /// Index of the period in progress
+  uint64_t current() const { return std::chrono::steady_clock::now().time_since_epoch() / period; }
+
+  /// Last period the layers have had at least \p grace to close
+  uint64_t last_closed(std::chrono::milliseconds grace = std::chrono::milliseconds(10)) const
+  {
+    return (std::chrono::steady_clock::now().time_since_epoch() - grace) / period - 1;
+  }
+
+private:
+  std::chrono::milliseconds period;
+};
+
+/// Values counted by a layer in each period, handed from the thread that counts them to the metrics thread
+template <typename T>
+class metrics_period_buffer
+{
+  struct entry_t {
+    uint64_t period = 0;
+    T        value  = {};
+  };
+
+public:
+  /// Writer side. Whether \p now is past the period the writer was counting in. If so, the values counted so far
+  /// belong to the period before \p now and have to be written to write_buffer() and published
+  bool closes(uint64_t now)
+  {
+    if (now == open_period.load(std::memory_order_relaxed)) {
+      return false;
+    }
+    open_period.store(now, std::memory_order_relaxed);
+    return true;
+  }
+
+  /// Writer side. Copy owned by the writer until publish() is called
+  T& write_buffer() { return buf.write_buffer().value; }
+
+  /// Writer side. Publishes the values of the period that was just closed
+  void publish()
+  {
+    buf.write_buffer().period = open_period.load(std::memory_order_relaxed) - 1;
+    buf.publish();
+  }
+
+  /// Period the writer is counting in. Can be called from any thread
+  uint64_t get_open_period() const { return open_period.load(std::memory_order_relaxed); }
+
+  /// Reader side. Values of \p period, or nullptr if the writer has not published them (yet)
+  const T* find(uint64_t period)
+  {
+    buf.update();
+    if (not buf.has_snapshot() or buf.read_buffer().period != period) {
+      return nullptr;
+    }
+    return &buf.read_buffer().value;
+  }
+
+private:
+  snapshot_buffer<entry_t> buf;
+  std::atomic<uint64_t>    open_period{0};
+};
+
+} // namespace srsran
+
+#endif // SRSRAN_METRICS_PERIOD_H
@@ -0,0 +1,146 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSRAN_PARALLEL_TASK_RUNNER_H
+#define SRSRAN_PARALLEL_TASK_RUNNER_H
+
+#include "srsran/common/thread_pool.h"
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+namespace srsran {
+
+/**
+ * Runs batches of independent tasks on the calling thread and on the idle threads of a shared task_thread_pool.
+ * Tasks are claimed one at a time from a shared index, so a thread that finishes early keeps taking the pending tasks
+ * of the batch instead of sitting idle, and the calling thread never blocks while tasks are pending. run() returns
+ * once every task of the batch has completed, which preserves the ordering between consecutive batches.
+ * Only one thread may call run() at a time.
+ */
+class parallel_task_runner
+{
+public:
+  /// If pool is nullptr, the tasks are run serially by the calling thread
+  explicit parallel_task_runner(task_thread_pool* pool_ = nullptr) : pool(pool_) {}
+  parallel_task_runner(const parallel_task_runner&) = delete;
+  parallel_task_runner& operator=(const parallel_task_runner&) = delete;
+  ~parallel_task_runner()
+  {
+    // Helper tasks of previous batches may still be in the pool queue, or may have been dropped by the pool. Wait for
+    // the ones running, and stop the others from touching this object when they start
+    std::unique_lock<std::mutex> lock(helpers->mutex);
+    helpers->closed = true;
+    helpers->cvar.wait(lock, [this]() { return helpers->nof_running == 0; });
+  }
+
+  void set_pool(task_thread_pool* pool_) { pool = pool_; }
+
+  /// Calls task(i) for i in [0, nof_tasks) and waits for all the calls to complete
+  template <typename Task>
+  void run(uint32_t nof_tasks, Task& task)
+  {
+    if (pool == nullptr or pool->nof_workers() == 0 or nof_tasks <= 1) {
+      for (uint32_t i = 0; i < nof_tasks; ++i) {
+        task(i);
+      }
+      return;
+    }
+
+    // Set up the batch before publishing it through the state word
+    batch_fn    = [](void* ctx, uint32_t idx) { (*static_cast<Task*>(ctx))(idx); };
+    batch_ctx   = &task;
+    batch_size  = nof_tasks;
+    nof_done    = 0;
+    uint32_t id = ++batch_id;
+    state.store((uint64_t)id << 32U, std::memory_order_release);
+
+    uint32_t nof_helpers = std::min((uint32_t)pool->nof_workers(), nof_tasks - 1);
+    for (uint32_t i = 0; i < nof_helpers; ++i) {
+      pool->push_task([this, state = helpers, id]() {
+        {
+          std::lock_guard<std::mutex> lock(state->mutex);
+          if (state->closed) {
+            return;
+          }
+          state->nof_running++;
+        }
+        execute(id);
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->nof_running--;
+        state->cvar.notify_all();
+      });
+    }
+
+    execute(id);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    cvar.wait(lock, [this]() { return nof_done == batch_size; });
+  }
+
+private:
+  /// Claims and runs tasks of batch "id" until none are left. Returns immediately if the batch has finished
+  void execute(uint32_t id)
+  {
+    uint64_t s = state.load(std::memory_order_acquire);
+    while ((uint32_t)(s >> 32U) == id and (uint32_t)s < batch_size) {
+      if (not state.compare_exchange_weak(s, s + 1, std::memory_order_acq_rel)) {
+        continue;
+      }
+      batch_fn(batch_ctx, (uint32_t)s);
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        nof_done++;
+        if (nof_done == batch_size) {
+          cvar.notify_all();
+        }
+      }
+      s = state.load(std::memory_order_acquire);
+    }
+  }
+
+  task_thread_pool* pool = nullptr;
+
+  // Current batch. The state word holds the batch id in the upper 32 bits and the next task index in the lower ones
+  std::atomic<uint64_t> state{0};
+  std::atomic<uint32_t> batch_size{0};
+  uint32_t              batch_id = 0;
+  void (*batch_fn)(void*, uint32_t) = nullptr;
+  void* batch_ctx                   = nullptr;
+
+  std::mutex              mutex;
+  std::condition_variable cvar;
+  uint32_t                nof_done = 0;
+
+  /// Helper tasks that have started running. Shared with the tasks, as they may start after this object is destroyed
+  struct helper_state_t {
+    std::mutex              mutex;
+    std::condition_variable cvar;
+    uint32_t                nof_running = 0;
+    bool                    closed      = false;
+  };
+  std::shared_ptr<helper_state_t> helpers = std::make_shared<helper_state_t>();
+};
+
+} // namespace srsran
+
+#endif // SRSRAN_PARALLEL_TASK_RUNNER_H
@@ -0,0 +1,101 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSRAN_RCU_PTR_H
+#define SRSRAN_RCU_PTR_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace srsran {
+
+/**
+ * Pointer to an immutable object that is read without locks and replaced as a whole, in the style of RCU.
+ *
+ * Readers create a read_guard, which counts them in one of two counters selected by the current period, and use the
+ * object it points to until the guard is destroyed. A writer publishes the new object with an atomic swap and then,
+ * twice, starts a new period, so that new readers use the other counter, and waits for the counter of the previous
+ * period to drain. A reader delayed between reading the period and incrementing its counter may end up in either
+ * counter, hence the two periods. After that no reader can hold the replaced object and it is deleted. Readers never
+ * wait; writers are serialized among themselves and wait for the readers in flight, which are expected to be short.
+ */
+template <typename T>
+class rcu_ptr
+{
+public:
+  class read_guard
+  {
+  public:
+    explicit read_guard(const rcu_ptr& parent_) : parent(parent_)
+    {
+      // The increment and the load of the object are seq_cst, as are the swap and the counter loads of reset(): either
+      // the writer sees this reader or this reader sees the new object
+      period = parent.period.load(std::memory_order_seq_cst) & 1U;
+      parent.nof_readers[period].fetch_add(1, std::memory_order_seq_cst);
+      ptr = parent.current.load(std::memory_order_seq_cst);
+    }
+    read_guard(const read_guard&) = delete;
+    read_guard& operator=(const read_guard&) = delete;
+    ~read_guard() { parent.nof_readers[period].fetch_sub(1, std::memory_order_release); }
+
+    const T* get() const { return ptr; }
+    const T* operator->() const { return ptr; }
+    const T& operator*() const { return *ptr; }
+    explicit operator bool() const { return ptr != nullptr; }
+
+  private:
+    const rcu_ptr& parent;
+    uint32_t       period;
+    const T*       ptr;
+  };
+
+  rcu_ptr() = default;
+  rcu_ptr(const rcu_ptr&) = delete;
+  rcu_ptr& operator=(const rcu_ptr&) = delete;
+  ~rcu_ptr() { delete current.load(); }
+
+  /// Publishes obj, which may be null, and deletes the previous object once no reader uses it
+  void reset(std::unique_ptr<const T> obj)
+  {
+    std::lock_guard<std::mutex> lock(writer_mutex);
+    const T*                    old = current.exchange(obj.release(), std::memory_order_seq_cst);
+
+    for (uint32_t i = 0; i < 2; i++) {
+      uint32_t old_period = period.fetch_add(1, std::memory_order_seq_cst) & 1U;
+      while (nof_readers[old_period].load(std::memory_order_seq_cst) != 0) {
+        std::this_thread::yield();
+      }
+    }
+    delete old;
+  }
+
+private:
+  std::atomic<const T*>         current{nullptr};
+  std::atomic<uint32_t>         period{0};
+  mutable std::atomic<uint32_t> nof_readers[2] = {{0}, {0}};
+  std::mutex                    writer_mutex;
+};
+
+} // namespace srsran
+
+#endif // SRSRAN_RCU_PTR_H
@@ -0,0 +1,112 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSRAN_RT_ALLOC_CHECK_H
+#define SRSRAN_RT_ALLOC_CHECK_H
+
+#include "srsran/srslog/srslog.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cstdint>
+
+namespace srsran {
+
+/// Number of heap allocations (operator new and srsran_vec_malloc) made so far by the calling thread.
+/// Allocations are only counted when compiled with ENABLE_RT_ALLOC_CHECK, otherwise it always returns 0
+uint64_t get_nof_thread_heap_allocs();
+
+/**
+ * Detects heap allocations in real-time processing paths (e.g. PHY worker TTI processing). A warning is logged for
+ * the first processing window that performs heap allocations and then, every report_period windows, a warning with
+ * the totals of the period if there were more. Each window with allocations is logged at debug level. No-op if
+ * ENABLE_RT_ALLOC_CHECK is not defined.
+ */
+class rt_alloc_checker
+{
+public:
+  rt_alloc_checker(srslog::basic_logger& logger_, const char* name_, uint32_t report_period_ = 1000) :
+    logger(logger_), name(name_), report_period(std::max(report_period_, 1U))
+  {
+  }
+
+#ifdef ENABLE_RT_ALLOC_CHECK
+  void begin() { start_count = get_nof_thread_heap_allocs(); }
+  void end()
+  {
+    uint64_t nof_allocs = get_nof_thread_heap_allocs() - start_count;
+    if (nof_allocs > 0) {
+      if (total_allocs == 0) {
+        logger.warning("%s: %" PRIu64 " heap allocation(s) in real-time path", name, nof_allocs);
+      } else {
+        logger.debug("%s: %" PRIu64 " heap allocation(s) in real-time path", name, nof_allocs);
+        period_allocs += nof_allocs;
+        period_windows++;
+      }
+      total_allocs += nof_allocs;
+      max_allocs = std::max(max_allocs, nof_allocs);
+    }
+    if (++nof_windows % report_period == 0 and period_allocs > 0) {
+      logger.warning("%s: %" PRIu64 " heap allocation(s) in %u of the last %u real-time windows, %" PRIu64 " in total",
+                     name,
+                     period_allocs,
+                     period_windows,
+                     report_period,
+                     total_allocs);
+      period_allocs  = 0;
+      period_windows = 0;
+    }
+  }
+#else
+  void begin() {}
+  void end() {}
+#endif
+
+  uint64_t get_max_allocs() const { return max_allocs; }
+  uint64_t get_total_allocs() const { return total_allocs; }
+
+private:
+  srslog::basic_logger& logger;
+  const char*           name;
+  uint32_t              report_period; ///< Number of windows between warnings with the totals
+  uint64_t              start_count    = 0;
+  uint64_t              nof_windows    = 0;
+  uint64_t              max_allocs     = 0;
+  uint64_t              total_allocs   = 0;
+  uint64_t              period_allocs  = 0; ///< Allocations of the current period not yet reported
+  uint32_t              period_windows = 0; ///< Windows of the current period with allocations not yet reported
+};
+
+/// RAII helper that counts the heap allocations made during its lifetime
+class rt_alloc_check_scope
+{
+public:
+  explicit rt_alloc_check_scope(rt_alloc_checker& checker_) : checker(checker_) { checker.begin(); }
+  rt_alloc_check_scope(const rt_alloc_check_scope&) = delete;
+  rt_alloc_check_scope& operator=(const rt_alloc_check_scope&) = delete;
+  ~rt_alloc_check_scope() { checker.end(); }
+
+private:
+  rt_alloc_checker& checker;
+};
+
+} // namespace srsran
+
+#endif // SRSRAN_RT_ALLOC_CHECK_H
@@ -123,8 +123,8 @@ static inline void string_parse_list(const std::string& input, char delimiter, I
   }
 }
 
-template <size_t N>
-const char* to_c_str(fmt::basic_memory_buffer<char, N>& mem_buffer)
+template <size_t N, typename Allocator>
+const char* to_c_str(fmt::basic_memory_buffer<char, N, Allocator>& mem_buffer)
 {
   mem_buffer.push_back('\0');
   return mem_buffer.data();
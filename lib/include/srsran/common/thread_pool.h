@@ -79,6 +79,7 @@ public:
   worker*     wait_worker_id(uint32_t id);
   worker*     wait_worker(uint32_t tti);
   worker*     wait_worker_nb(uint32_t tti);
+  worker*     wait_worker_id_nb(uint32_t id);
   void        start_worker(worker*);
   void        start_worker(uint32_t id);
   worker*     get_worker(uint32_t id);
@@ -53,6 +53,7 @@ public:
     bool     flush_before_teidin_present = false;
     uint32_t forward_from_teidin         = 0;
     uint32_t flush_before_teidin         = 0;
+    uint32_t pdcp_sn_len                 = 0; ///< PDCP SN length of the bearer, 0 if unknown
   };
 
   virtual srsran::expected<uint32_t> add_bearer(uint16_t            rnti,
@@ -35,6 +35,9 @@ struct mac_args_t {
   uint32_t                      nof_prealloc_ues; ///< Number of UE resources to pre-allocate at eNB startup
   uint32_t                      max_nof_kos;
   int                           rlf_min_ul_snr_estim;
+  uint32_t softbuffer_pool_max_cb; ///< Max UL code blocks shared by all UEs, 0 allocates them per HARQ process instead
+  bool     softbuffer_pool_8bit;   ///< Store UL soft bits in 8-bit, requires the PUSCH 8-bit decoder
+  uint32_t metrics_period_ms;      ///< Metrics reporting period of the MAC and the stack, 0 for the default
 };
 
 /* Interface PHY -> MAC */
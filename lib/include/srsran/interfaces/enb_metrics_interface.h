@@ -57,6 +57,7 @@ struct stack_metrics_t {
 struct enb_metrics_t {
   srsran::rf_metrics_t       rf;
   std::vector<phy_metrics_t> phy;
+  nr_phy_metrics_t           nr_phy;
   stack_metrics_t            stack;
   stack_metrics_t            nr_stack;
   srsran::sys_metrics_t      sys;
@@ -289,6 +289,10 @@ public:
 
     // PUSCH signal measurements
     srsran_csi_trs_measurements_t csi; ///< DMRS based signal Channel State Information (CSI)
+
+    // PUSCH overload control actions
+    bool overload_reduced_its = false; ///< The TB was decoded with reduced iterations
+    bool overload_nack        = false; ///< The TB was NACKed without decoding
   };
 
   struct rach_info_t {
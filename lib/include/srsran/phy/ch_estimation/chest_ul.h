@@ -63,9 +63,10 @@ typedef struct SRSRAN_API {
 typedef struct {
   srsran_cell_t cell;
 
-  srsran_refsignal_ul_t             dmrs_signal;
-  srsran_refsignal_ul_dmrs_pregen_t dmrs_pregen;
-  bool                              dmrs_signal_configured;
+  srsran_refsignal_ul_t                    dmrs_signal;
+  srsran_refsignal_ul_dmrs_pregen_t        dmrs_pregen;
+  const srsran_refsignal_ul_dmrs_pregen_t* dmrs_pregen_shared; // Used instead of dmrs_pregen when set
+  bool                                     dmrs_signal_configured;
 
   srsran_refsignal_srs_pregen_t srs_pregen;
   bool                          srs_signal_configured;
@@ -99,9 +100,11 @@ SRSRAN_API void srsran_chest_ul_res_free(srsran_chest_ul_res_t* q);
 
 SRSRAN_API int srsran_chest_ul_set_cell(srsran_chest_ul_t* q, srsran_cell_t cell);
 
-SRSRAN_API void srsran_chest_ul_pregen(srsran_chest_ul_t*                 q,
-                                       srsran_refsignal_dmrs_pusch_cfg_t* cfg,
-                                       srsran_refsignal_srs_cfg_t*        srs_cfg);
+SRSRAN_API void srsran_chest_ul_set_dmrs_pregen(srsran_chest_ul_t* q, const srsran_refsignal_ul_dmrs_pregen_t* pregen);
+
+SRSRAN_API int srsran_chest_ul_pregen(srsran_chest_ul_t*                 q,
+                                      srsran_refsignal_dmrs_pusch_cfg_t* cfg,
+                                      srsran_refsignal_srs_cfg_t*        srs_cfg);
 
 SRSRAN_API int srsran_chest_ul_estimate_pusch(srsran_chest_ul_t*     q,
                                               srsran_ul_sf_cfg_t*    sf,
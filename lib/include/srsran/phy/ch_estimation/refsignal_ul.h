@@ -105,6 +105,8 @@ SRSRAN_API int srsran_refsignal_dmrs_pusch_pregen(srsran_refsignal_ul_t*
 SRSRAN_API void srsran_refsignal_dmrs_pusch_pregen_free(srsran_refsignal_ul_t*             q,
                                                         srsran_refsignal_ul_dmrs_pregen_t* pregen);
 
+SRSRAN_API uint32_t srsran_refsignal_dmrs_pusch_pregen_nof_bytes(const srsran_refsignal_ul_dmrs_pregen_t* pregen);
+
 SRSRAN_API int srsran_refsignal_dmrs_pusch_pregen_put(srsran_refsignal_ul_t*             q,
                                                       srsran_ul_sf_cfg_t*                sf_cfg,
                                                       srsran_refsignal_ul_dmrs_pregen_t* pregen,
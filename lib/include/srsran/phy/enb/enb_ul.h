@@ -68,6 +68,9 @@ SRSRAN_API int srsran_enb_ul_init(srsran_enb_ul_t* q, cf_t* in_buffer, uint32_t
 
 SRSRAN_API void srsran_enb_ul_free(srsran_enb_ul_t* q);
 
+/* Makes the channel estimator use DMRS pregenerated elsewhere for the cell, shall be called before set_cell */
+SRSRAN_API void srsran_enb_ul_set_dmrs_pregen(srsran_enb_ul_t* q, const srsran_refsignal_ul_dmrs_pregen_t* pregen);
+
 SRSRAN_API int srsran_enb_ul_set_cell(srsran_enb_ul_t*                   q,
                                       srsran_cell_t                      cell,
                                       srsran_refsignal_dmrs_pusch_cfg_t* pusch_cfg,
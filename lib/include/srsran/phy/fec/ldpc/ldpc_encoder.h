@@ -70,6 +70,8 @@ typedef struct SRSRAN_API {
   void (*encode_high_rate_avx2)(void*);
   /*!  \brief Pointer to the encoder for the high-rate region (SIMD-AVX512-optimized version). */
   void (*encode_high_rate_avx512)(void*);
+  /*! \brief Packed-bit encoder auxiliary registers, available for all encoder types. */
+  void* ptr_packed;
 
 } srsran_ldpc_encoder_t;
 
@@ -117,4 +119,20 @@ SRSRAN_API int srsran_ldpc_encoder_encode_rm(srsran_ldpc_encoder_t* q,
                                              uint32_t               input_length,
                                              uint32_t               cdwd_rm_length);
 
+/*!
+ * Encodes a packed message into a packed codeword with the specified encoder, regardless of its type. Bits are packed
+ * MSB first. The filler bits of the message shall be set to zero, they are zero in the resulting codeword too.
+ * \param[in] q A pointer to the desired encoder.
+ * \param[in] input The packed message to encode.
+ * \param[out] output The resulting packed codeword.
+ * \param[in] input_length The number of uncoded bits in the input message.
+ * \param[in] cdwd_rm_length The codeword length after rate matching.
+ * \return An integer: 0 if the function executes correctly, -1 otherwise.
+ */
+SRSRAN_API int srsran_ldpc_encoder_encode_packed(srsran_ldpc_encoder_t* q,
+                                                 const uint8_t*         input,
+                                                 uint8_t*               output,
+                                                 uint32_t               input_length,
+                                                 uint32_t               cdwd_rm_length);
+
 #endif // SRSRAN_LDPCENCODER_H
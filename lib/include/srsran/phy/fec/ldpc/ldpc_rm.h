@@ -83,6 +83,37 @@ SRSRAN_API int srsran_ldpc_rm_tx(srsran_ldpc_rm_t*        q,
                                  const srsran_mod_t       mod_type,
                                  const uint32_t           Nref);
 
+/*!
+ * Carries out the rate-matching of a packed codeword, bit selection and bit interleaving in a single pass. Bits are
+ * packed MSB first. The rate-matched codeword is written at bit w_offset of the output, the preceding bits of the first
+ * byte are kept.
+ * \param[in] q            A pointer to the Rate-Matcher (a srsran_ldpc_rm_t structure
+ *                         instance) that carries out the rate matching.
+ * \param[in] input        The packed codeword obtained from the packed-bit ldpc encoder.
+ * \param[out] output      The packed rate-matched codeword resulting from the rate-matching
+ *                         operation.
+ * \param[in]  w_offset    Bit offset (0 to 7) of the rate-matched codeword in the first output byte.
+ * \param[in]  E           Rate-matched codeword length.
+ * \param[in]  F           Number of filler bits.
+ * \param[in]  bg;         Current base graph.
+ * \param[in]  ls          Current lifting size.
+ * \param[in]  rv          Redundancy version 0,1,2,3.
+ * \param[in]  mod_type    Modulation type.
+ * \param[in]  Nref        Size of limited buffer.
+ * \return An integer: 0 if the function executes correctly, -1 otherwise.
+ */
+SRSRAN_API int srsran_ldpc_rm_tx_packed(srsran_ldpc_rm_t*        q,
+                                        const uint8_t*           input,
+                                        uint8_t*                 output,
+                                        const uint32_t           w_offset,
+                                        const uint32_t           E,
+                                        const uint32_t           F,
+                                        const srsran_basegraph_t bg,
+                                        const uint32_t           ls,
+                                        const uint8_t            rv,
+                                        const srsran_mod_t       mod_type,
+                                        const uint32_t           Nref);
+
 /*!
  * Initializes all the Rate DeMatcher variables.
  * \param[out] q           A pointer to a srsran_ldpc_rm_t structure.
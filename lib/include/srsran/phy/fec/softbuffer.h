@@ -32,31 +32,103 @@
 #define SRSRAN_SOFTBUFFER_H
 
 #include "srsran/config.h"
+#include <pthread.h>
+#include <stdbool.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**
+ * @brief Shared slab of code block buffers for Rx soft-buffers
+ *
+ * Soft-buffers bound to a pool do not own any code block storage. They borrow from the pool only as many code block
+ * buffers as the transport block being received needs, and give them back when they are reset. The pool grows in
+ * chunks of slots up to max_slots, so the memory follows the actual load instead of the worst case for every HARQ
+ * process.
+ */
 typedef struct SRSRAN_API {
-  uint32_t  max_cb;
-  uint32_t  max_cb_size;
-  int16_t** buffer_f;
-  uint8_t** data;
-  bool*     cb_crc;
-  bool      tb_crc;
+  uint32_t        max_cb_size;
+  bool            llr_8bit;        ///< Soft bits are stored as int8_t, halving the slot size
+  uint32_t        slot_size;       ///< Number of bytes per slot: soft bits followed by the decoded data
+  uint32_t        slots_per_chunk; ///< Number of slots allocated each time the pool grows
+  uint32_t        max_slots;       ///< Maximum number of slots the pool can grow to
+  uint32_t        nof_slots;       ///< Number of slots currently allocated
+  uint8_t**       chunks;
+  uint8_t**       free_slots;
+  uint32_t        nof_free;
+  uint32_t        peak_used;
+  uint64_t        nof_alloc;
+  uint64_t        nof_alloc_fail;
+  pthread_mutex_t mutex;
+} srsran_softbuffer_pool_t;
+
+typedef struct SRSRAN_API {
+  uint32_t nof_slots;      ///< Number of slots currently allocated
+  uint32_t max_slots;      ///< Maximum number of slots
+  uint32_t nof_used;       ///< Number of slots currently attached to soft-buffers
+  uint32_t peak_used;      ///< Maximum number of slots simultaneously attached
+  uint64_t nof_alloc;      ///< Total number of successful code block attachments
+  uint64_t nof_alloc_fail; ///< Number of code block attachments that failed because the pool was exhausted
+} srsran_softbuffer_pool_stats_t;
+
+typedef struct SRSRAN_API {
+  uint32_t                  max_cb;
+  uint32_t                  max_cb_size;
+  int16_t**                 buffer_f;
+  uint8_t**                 data;
+  bool*                     cb_crc;
+  bool                      tb_crc;
+  srsran_softbuffer_pool_t* pool;     ///< Pool the code block buffers are borrowed from, NULL if they are owned
+  uint32_t                  nof_cb;   ///< Number of code block buffers currently borrowed from the pool
+  bool                      llr_8bit; ///< Code block buffers only hold 8-bit soft bits
 } srsran_softbuffer_rx_t;
 
 typedef struct SRSRAN_API {
   uint32_t  max_cb;
   uint32_t  max_cb_size;
   uint8_t** buffer_b;
+  uint64_t  encoded_id; ///< Identifies the transport block encoded in buffer_b for reuse by retransmissions, 0 if none
 } srsran_softbuffer_tx_t;
 
 #define SOFTBUFFER_SIZE 18600
 
+/**
+ * @brief Initialises a pool of code block buffers shared by Rx soft-buffers
+ * @param pool The pool pointer
+ * @param max_cb_size The code block size in soft bits
+ * @param llr_8bit Set to true for storing 8-bit soft bits, only valid for 8-bit decoders
+ * @param slots_per_chunk Number of code block buffers allocated every time the pool grows
+ * @param max_slots Maximum number of code block buffers
+ * @param init_slots Number of code block buffers to allocate during the initialisation
+ * @return SRSRAN_SUCCESS if the pool is initialised successfully, SRSRAN_ERROR code otherwise
+ */
+SRSRAN_API int srsran_softbuffer_pool_init(srsran_softbuffer_pool_t* pool,
+                                           uint32_t                  max_cb_size,
+                                           bool                      llr_8bit,
+                                           uint32_t                  slots_per_chunk,
+                                           uint32_t                  max_slots,
+                                           uint32_t                  init_slots);
+
+SRSRAN_API void srsran_softbuffer_pool_free(srsran_softbuffer_pool_t* pool);
+
+SRSRAN_API void srsran_softbuffer_pool_get_stats(srsran_softbuffer_pool_t* pool, srsran_softbuffer_pool_stats_t* stats);
+
 SRSRAN_API int srsran_softbuffer_rx_init(srsran_softbuffer_rx_t* q, uint32_t nof_prb);
 
+/**
+ * @brief Initialises an Rx soft-buffer that borrows its code block buffers from a pool
+ * @note The code block buffers are attached by srsran_softbuffer_rx_reset_tbs(), srsran_softbuffer_rx_reset_tbs_nr()
+ * and srsran_softbuffer_rx_reset_cb(), which must be called before every new transport block.
+ * srsran_softbuffer_rx_reset() gives them all back to the pool
+ * @param q The Rx soft-buffer pointer
+ * @param pool The pool to borrow the code block buffers from
+ * @param max_cb The maximum number of code blocks
+ * @return SRSRAN_SUCCESS if the soft-buffer is initialised successfully, SRSRAN_ERROR code otherwise
+ */
+SRSRAN_API int srsran_softbuffer_rx_init_pool(srsran_softbuffer_rx_t* q, srsran_softbuffer_pool_t* pool, uint32_t max_cb);
+
 /**
  * @brief Initialises Rx soft-buffer for a number of code blocks and their size
  * @param q The Rx soft-buffer pointer
@@ -71,6 +143,13 @@ SRSRAN_API void srsran_softbuffer_rx_reset(srsran_softbuffer_rx_t* p);
 
 SRSRAN_API void srsran_softbuffer_rx_reset_tbs(srsran_softbuffer_rx_t* q, uint32_t tbs);
 
+/**
+ * @brief Resets an Rx soft-buffer for an NR transport block, counting its code blocks with the LDPC segmentation
+ * @param q The Rx soft-buffer pointer
+ * @param tbs The transport block size in bits
+ */
+SRSRAN_API void srsran_softbuffer_rx_reset_tbs_nr(srsran_softbuffer_rx_t* q, uint32_t tbs);
+
 SRSRAN_API void srsran_softbuffer_rx_reset_cb(srsran_softbuffer_rx_t* q, uint32_t nof_cb);
 
 SRSRAN_API void srsran_softbuffer_rx_free(srsran_softbuffer_rx_t* p);
@@ -72,6 +72,9 @@ typedef struct SRSRAN_API {
   srsran_modem_table_t mod;
   srsran_sequence_t    seq[SRSRAN_NOF_SF_X_FRAME];
 
+  /* precoded symbols of every CFI and subframe, computed when the cell is set */
+  cf_t tx_symbols[SRSRAN_NOF_CFI][SRSRAN_NOF_SF_X_FRAME][SRSRAN_MAX_PORTS][PCFICH_RE];
+
 } srsran_pcfich_t;
 
 SRSRAN_API int srsran_pcfich_init(srsran_pcfich_t* q, uint32_t nof_rx_antennas);
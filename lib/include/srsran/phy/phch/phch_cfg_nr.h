@@ -229,6 +229,9 @@ typedef struct SRSRAN_API {
   srsran_beta_offsets_t beta_offsets;              /// Semi-static only.
   bool                  enable_transform_precoder; /// Enables transform precoding
   float scaling; /// Indicates a scaling factor to limit the number of resource elements assigned to UCI on PUSCH.
+
+  /// Optional grant parameters precomputed at cell setup, see srsran_ra_nr_tb_cache_init(). Not owned, NULL if absent
+  const struct srsran_ra_nr_tb_cache_s* tb_cache;
 } srsran_sch_hl_cfg_nr_t;
 
 /**
@@ -247,6 +250,7 @@ typedef struct SRSRAN_API {
   srsran_uci_cfg_nr_t uci; ///< Uplink Control Information configuration
   bool                enable_transform_precoder;
   bool                freq_hopping_enabled;
+  bool                uci_only; ///< Skips the UL-SCH decoding, the transport block is reported with CRC KO
 } srsran_sch_cfg_nr_t;
 
 SRSRAN_API uint32_t srsran_sch_cfg_nr_nof_re(const srsran_sch_cfg_nr_t* sch_cfg);
@@ -77,6 +77,9 @@ typedef struct SRSRAN_API {
   srsran_modem_table_t mod;
   srsran_sequence_t    seq[SRSRAN_NOF_SF_X_FRAME];
 
+  /* spread and scrambled symbols of every subframe, ACK value and orthogonal sequence, computed when the cell is set */
+  cf_t tx_d[SRSRAN_NOF_SF_X_FRAME][2][SRSRAN_PHICH_NORM_NSEQUENCES][SRSRAN_PHICH_MAX_NSYMB];
+
 } srsran_phich_t;
 
 typedef struct SRSRAN_API {
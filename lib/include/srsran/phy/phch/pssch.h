@@ -87,6 +87,7 @@ typedef struct SRSRAN_API {
   uint8_t* e_r;
   int16_t* e_r_16;
   uint8_t* buff_b;
+  bool     rm_tables_ref; // Holds a reference to the shared rate matching tables
 
   uint8_t* codeword;
   uint8_t* codeword_bytes;
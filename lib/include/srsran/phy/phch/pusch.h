@@ -105,6 +105,22 @@ SRSRAN_API int srsran_pusch_set_cell(srsran_pusch_t* q, srsran_cell_t cell);
  */
 SRSRAN_API int srsran_pusch_assert_grant(const srsran_pusch_grant_t* grant);
 
+/**
+ * Generates the scrambling sequence of an RNTI and subframe as packed bits, most significant bit first, for the
+ * receiver to keep it and reuse it for every grant of the RNTI in that subframe.
+ * @param c_packed Sequence of len bits, takes ceil(len / 8) bytes
+ */
+SRSRAN_API void
+srsran_pusch_scrambling_gen(uint8_t* c_packed, uint16_t rnti, uint32_t sf_idx, uint32_t cell_id, uint32_t len);
+
+/**
+ * Unpacks the first len bits of a sequence generated by srsran_pusch_scrambling_gen() as +1/-1 values, to fill a
+ * srsran_pusch_scrambling_t
+ * @param c_char Sequence for the 8-bit descrambling and the UCI decoder
+ * @param c_short Sequence for the 16-bit descrambling. Not unpacked if NULL
+ */
+SRSRAN_API void srsran_pusch_scrambling_unpack(const uint8_t* c_packed, int8_t* c_char, int16_t* c_short, uint32_t len);
+
 /* These functions do not modify the state and run in real-time */
 SRSRAN_API int srsran_pusch_encode(srsran_pusch_t*      q,
                                    srsran_ul_sf_cfg_t*  sf,
@@ -56,6 +56,13 @@ typedef struct SRSRAN_API {
 
 } srsran_pusch_grant_t;
 
+/* PUSCH scrambling sequence of an RNTI and subframe, pre-generated by the receiver */
+typedef struct SRSRAN_API {
+  const int8_t*  c_char;  // Sequence as +1/-1, used by the 8-bit descrambling and by the UCI decoder
+  const int16_t* c_short; // Sequence as +1/-1, used by the 16-bit descrambling
+  uint32_t       len;     // Number of generated bits, 0 if the sequence is not available
+} srsran_pusch_scrambling_t;
+
 typedef struct SRSRAN_API {
 
   uint16_t rnti;
@@ -65,6 +72,7 @@ typedef struct SRSRAN_API {
   srsran_pusch_grant_t    grant;
 
   uint32_t max_nof_iterations;
+  bool     uci_only; ///< Decodes the UCI only. The transport block is not decoded and it is reported with CRC KO
   uint32_t last_O_cqi;
   uint32_t K_segm;
   uint32_t current_tx_nb;
@@ -76,6 +84,8 @@ typedef struct SRSRAN_API {
     srsran_softbuffer_rx_t* rx;
   } softbuffers;
 
+  srsran_pusch_scrambling_t scrambling; ///< Used by the decoder if it covers the grant, generated on the fly otherwise
+
   bool     meas_time_en;
   uint32_t meas_time_value;
 
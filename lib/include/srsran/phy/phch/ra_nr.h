@@ -38,6 +38,45 @@
 #include "srsran/phy/phch/dci_nr.h"
 #include "srsran/phy/phch/phch_cfg_nr.h"
 
+#define SRSRAN_RA_NR_TB_CACHE_MAX_DMRS 3
+#define SRSRAN_RA_NR_TB_CACHE_MAX_NRE 16
+#define SRSRAN_RA_NR_TB_CACHE_NOF_TABLES 3
+#define SRSRAN_RA_NR_TB_CACHE_NOF_MCS 29
+
+/**
+ * @brief Transport block parameters of a single layer grant without TB scaling
+ */
+typedef struct SRSRAN_API {
+  uint32_t tbs;          ///< Transport block size
+  uint32_t nof_crc_bits; ///< Transport block and code block CRC bits after segmentation
+} srsran_ra_nr_tb_cache_entry_t;
+
+/**
+ * @brief Grant parameters precomputed from the PDSCH or PUSCH configuration of a cell
+ *
+ * Holds the DMRS RE per PRB of the time domain allocations the configuration can schedule and, for every reachable MCS
+ * table, MCS, resulting number of RE per PRB and number of PRB, the TBS and CRC bits of a single layer transport block.
+ * The scheduler and the PHY reach it through srsran_sch_hl_cfg_nr_t::tb_cache. Grants it does not cover, such as other
+ * DMRS configurations, TB scaling or several layers, are computed as without it.
+ */
+typedef struct srsran_ra_nr_tb_cache_s {
+  srsran_xoverhead_t    xoverhead;
+  uint32_t              max_nof_prb;
+  uint32_t              nof_dmrs;
+  srsran_dmrs_sch_cfg_t dmrs[SRSRAN_RA_NR_TB_CACHE_MAX_DMRS];
+
+  /// DMRS RE per PRB, indexed by [DMRS][mapping][S][L - 1][CDM groups without data - 1], -1 if not cached
+  int8_t dmrs_re[SRSRAN_RA_NR_TB_CACHE_MAX_DMRS][2][SRSRAN_NSYMB_PER_SLOT_NR][SRSRAN_NSYMB_PER_SLOT_NR][3];
+
+  /// Cached numbers of RE per PRB and the index of each of them, -1 if not cached
+  uint32_t nof_nre;
+  uint32_t nre[SRSRAN_RA_NR_TB_CACHE_MAX_NRE];
+  int8_t   nre_idx[SRSRAN_MAX_NRE_NR + 1];
+
+  /// Entries indexed by [MCS][RE per PRB index][number of PRB - 1] for each MCS table, NULL if it is not reachable
+  srsran_ra_nr_tb_cache_entry_t* tb[SRSRAN_RA_NR_TB_CACHE_NOF_TABLES];
+} srsran_ra_nr_tb_cache_t;
+
 /**
  * @brief Determines target rate
  * @param mcs_table Configured MCS table
@@ -91,6 +130,19 @@ SRSRAN_API int srsran_ra_nr_fill_tb(const srsran_sch_cfg_nr_t*   pdsch_cfg,
                                     const srsran_sch_grant_nr_t* grant,
                                     uint32_t                     mcs_idx,
                                     srsran_sch_tb_t*             tb);
+
+/**
+ * @brief Precomputes the grant parameters of a PDSCH or PUSCH configuration, see srsran_ra_nr_tb_cache_t
+ * @param q Object to initialise
+ * @param hl_cfg PDSCH or PUSCH configuration provided by higher layers
+ * @param max_nof_prb Maximum number of PRB of a grant
+ * @return SRSRAN_SUCCESS if the tables are built, SRSRAN_ERROR code otherwise
+ */
+SRSRAN_API int
+srsran_ra_nr_tb_cache_init(srsran_ra_nr_tb_cache_t* q, const srsran_sch_hl_cfg_nr_t* hl_cfg, uint32_t max_nof_prb);
+
+SRSRAN_API void srsran_ra_nr_tb_cache_free(srsran_ra_nr_tb_cache_t* q);
+
 /**
  * @brief Converts an unpacked DL DCI message to a PDSCH grant structure.
  * Implements the procedures defined in Section 5 of 38.214 to compute the resource allocation (5.1.2)
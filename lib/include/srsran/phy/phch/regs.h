@@ -52,6 +52,7 @@ typedef struct SRSRAN_API {
 typedef struct SRSRAN_API {
   uint32_t            nof_regs;
   srsran_regs_reg_t** regs;
+  uint32_t*           re_idx; // Resource element index of every REG, REGS_RE_X_REG per REG in the order of regs
 } srsran_regs_ch_t;
 
 typedef struct SRSRAN_API {
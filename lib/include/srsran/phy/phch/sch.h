@@ -55,6 +55,7 @@ typedef struct SRSRAN_API {
   float    avg_iterations;
 
   bool llr_is_8bit;
+  bool rm_tables_ref; // Holds a reference to the shared rate matching tables
 
   /* buffers */
   uint8_t*         cb_in;
@@ -33,6 +33,8 @@ typedef struct SRSRAN_API {
 
   bool limited_buffer_rm; ///< @brief Enables LBRM (Limited buffer rate-matching). Given by rateMatching parameter in
                           ///< PUSCH-ServingCellConfig or PDSCH-ServingCellConfig ASN1 sequences
+
+  uint32_t max_nof_iter; ///< Overrides the decoder maximum number of LDPC iterations if not zero
 } srsran_sch_cfg_t;
 
 typedef struct SRSRAN_API {
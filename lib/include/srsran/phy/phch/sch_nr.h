@@ -76,6 +76,13 @@ typedef struct SRSRAN_API {
   /// LDPC Rate matcher
   srsran_ldpc_rm_t tx_rm;
   srsran_ldpc_rm_t rx_rm;
+
+  /// Threads encoding code blocks together with the caller, NULL if code blocks are encoded serially
+  void* enc_coworkers;
+
+  /// Tx soft-buffer reuse counters
+  uint64_t nof_tx_cache_hit;  ///< Transport blocks rate matched from the code blocks kept in the soft-buffer
+  uint64_t nof_tx_cache_miss; ///< Transport blocks encoded
 } srsran_sch_nr_t;
 
 /**
@@ -85,7 +92,8 @@ typedef struct SRSRAN_API {
   bool     disable_simd;
   bool     decoder_use_flooded;
   float    decoder_scaling_factor;
-  uint32_t max_nof_iter; ///< Maximum number of LDPC iterations
+  uint32_t max_nof_iter;          ///< Maximum number of LDPC iterations
+  uint32_t nof_encoder_coworkers; ///< Threads encoding the code blocks of a TB with the caller, 0 for serial encoding
 } srsran_sch_nr_args_t;
 
 /**
@@ -171,6 +179,25 @@ SRSRAN_API int srsran_dlsch_nr_encode(srsran_sch_nr_t*        q,
                                       const uint8_t*          data,
                                       uint8_t*                e_bits);
 
+/**
+ * @brief Encodes a DL-SCH transport block into packed bits (MSB first), ready for packed scrambling and modulation
+ * @remark The Tx soft-buffer keeps the packed codewords, so the transmissions of a transport block shall not mix this
+ * function with srsran_dlsch_nr_encode()
+ * @remark Retransmissions (RV other than 0) of the transport block held in the soft-buffer, with the same TBS and NDI,
+ * reuse its encoded code blocks and only redo the rate matching
+ * @param q Points at the SCH object
+ * @param cfg SCH configuration
+ * @param tb Transport block configuration
+ * @param data Transport block payload, NULL to rate match the codewords kept in the soft-buffer
+ * @param e_bytes Packed rate-matched codewords
+ * @return SRSRAN_SUCCESS if the encoding is successful, SRSRAN_ERROR code otherwise
+ */
+SRSRAN_API int srsran_dlsch_nr_encode_packed(srsran_sch_nr_t*        q,
+                                             const srsran_sch_cfg_t* cfg,
+                                             const srsran_sch_tb_t*  tb,
+                                             const uint8_t*          data,
+                                             uint8_t*                e_bytes);
+
 SRSRAN_API int srsran_dlsch_nr_decode(srsran_sch_nr_t*        q,
                                       const srsran_sch_cfg_t* sch_cfg,
                                       const srsran_sch_tb_t*  tb,
@@ -0,0 +1,120 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ *  File:         channelizer.h
+ *
+ *  Description:  Oversampled polyphase analysis filter bank.
+ *
+ *                Splits a wideband stream into nof_channels channels spaced
+ *                srate / nof_channels apart, each one low-pass filtered and
+ *                decimated by decimation. The decimation does not need to
+ *                divide the number of channels, so that channels can be
+ *                narrower than the spacing between them, e.g. 1.92 MHz
+ *                channels on the 100 kHz LTE raster.
+ *
+ *  Reference:    fred harris, "Multirate Signal Processing for Communication
+ *                Systems", Chapter 9
+ *****************************************************************************/
+
+#ifndef SRSRAN_CHANNELIZER_H
+#define SRSRAN_CHANNELIZER_H
+
+#include <stdint.h>
+
+#include "srsran/config.h"
+#include "srsran/phy/dft/dft.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Channelizer internal buffers and subcomponents
+ */
+typedef struct {
+  uint32_t          nof_channels; ///< Number of channels, M
+  uint32_t          decimation;   ///< Decimation of every channel, D
+  uint32_t          nof_taps;     ///< Prototype filter length, a multiple of M
+  float*            taps;         ///< Prototype filter, time reversed
+  srsran_dft_plan_t fft;          ///< M points forward DFT
+  cf_t*             fft_in;       ///< Polyphase filter output
+  cf_t*             fft_out;      ///< DFT output, one sample per channel
+  cf_t*             tmp;          ///< Polyphase branch product
+  uint32_t          nof_rows;     ///< Number of distinct phase corrections
+  uint32_t          row;          ///< Phase correction of the next output
+  cf_t*             phase;        ///< Phase corrections, nof_rows x M
+  uint32_t          buffer_sz;    ///< Input delay line capacity
+  uint32_t          buffer_len;   ///< Samples in the input delay line
+  cf_t*             buffer;       ///< Input delay line
+} srsran_channelizer_t;
+
+/**
+ * Initialise a channelizer. The prototype filter passes half the output sampling rate.
+ * @param q Object pointer
+ * @param nof_channels Number of channels
+ * @param decimation Decimation of every channel, not greater than the number of channels
+ * @return SRSRAN_SUCCESS if no error, otherwise an SRSRAN error code
+ */
+SRSRAN_API int srsran_channelizer_init(srsran_channelizer_t* q, uint32_t nof_channels, uint32_t decimation);
+
+/**
+ * @brief Clears the filter state
+ * @param q Object pointer
+ */
+SRSRAN_API void srsran_channelizer_reset(srsran_channelizer_t* q);
+
+/**
+ * Get the frequency of a channel, relative to the input sampling rate. Channels are in DFT order, the ones from
+ * nof_channels / 2 on have negative frequencies.
+ * @param q Object pointer
+ * @param channel_idx Channel index
+ * @return Normalised channel frequency, in [-0.5, 0.5)
+ */
+SRSRAN_API float srsran_channelizer_get_freq(const srsran_channelizer_t* q, uint32_t channel_idx);
+
+/**
+ * @brief Run the channelizer on a block of input samples.
+ *
+ * @note Output pointers set to NULL drop the samples of that channel
+ *
+ * @param q Object pointer, make sure it has been initialised
+ * @param input Points at the input complex buffer
+ * @param nsamples Number of input samples
+ * @param output Points at nof_channels output buffers, with room for nsamples / decimation + 1 samples each
+ * @return The number of samples written to each channel
+ */
+SRSRAN_API uint32_t srsran_channelizer_run(srsran_channelizer_t* q,
+                                           const cf_t*           input,
+                                           uint32_t              nsamples,
+                                           cf_t**                output);
+
+/**
+ * Free channelizer buffers and subcomponents
+ * @param q Object pointer
+ */
+SRSRAN_API void srsran_channelizer_free(srsran_channelizer_t* q);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SRSRAN_CHANNELIZER_H
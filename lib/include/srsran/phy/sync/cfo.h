@@ -45,6 +45,7 @@ typedef struct SRSRAN_API {
   int              max_samples;
   srsran_cexptab_t tab;
   cf_t*            cur_cexp;
+  double           nco_phase; // Phase of srsran_cfo_nco_correct() oscillator, in cycles
 } srsran_cfo_t;
 
 SRSRAN_API int srsran_cfo_init(srsran_cfo_t* h, uint32_t nsamples);
@@ -60,6 +61,19 @@ SRSRAN_API void srsran_cfo_correct(srsran_cfo_t* h, const cf_t* input, cf_t* out
 SRSRAN_API void
 srsran_cfo_correct_offset(srsran_cfo_t* h, const cf_t* input, cf_t* output, float freq, int cexp_offset, int nsamples);
 
+/* Phase-continuous CFO correction. The oscillator phase carries over from the previous call, and only the frequency
+ * changes between calls, so consecutive blocks of samples are corrected as a single block. The same phase is applied
+ * to the nof_channels inputs, skipping NULL ones. Input and output may differ, to correct while copying samples.
+ */
+SRSRAN_API void srsran_cfo_nco_correct(srsran_cfo_t* h,
+                                       cf_t**        input,
+                                       cf_t**        output,
+                                       uint32_t      nof_channels,
+                                       float         freq,
+                                       uint32_t      nsamples);
+
+SRSRAN_API void srsran_cfo_nco_reset(srsran_cfo_t* h);
+
 SRSRAN_API float srsran_cfo_est_corr_cp(cf_t* input_buffer, uint32_t nof_prb);
 
 #endif // SRSRAN_CFO_H
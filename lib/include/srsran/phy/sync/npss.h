@@ -34,6 +34,13 @@
  *                centered at the carrier frequency. Thus, downsampling is required
  *                if the signal is sampled at higher frequencies.
  *
+ *                The srsran_npss_stream_t object searches the NPSS in a continuous
+ *                stream, fed with buffers of any size. The stream is decimated
+ *                to 32 samples per OFDM symbol, which still passes the 180 kHz
+ *                NB-IoT carrier, and correlated block by block (overlap-save).
+ *                Every radio frame worth of correlation, the peak and its peak to
+ *                side-lobe ratio are reported.
+ *
  *  Reference:    3GPP TS 36.211 version 13.2.0 Release 13 Sec. 10.x.x
  *****************************************************************************/
 
@@ -45,6 +52,8 @@
 
 #include "srsran/config.h"
 #include "srsran/phy/common/phy_common.h"
+#include "srsran/phy/dft/dft.h"
+#include "srsran/phy/resampling/resampler.h"
 #include "srsran/phy/utils/convolution.h"
 
 #define CONVOLUTION_FFT
@@ -81,6 +90,10 @@
 
 #define SRSRAN_NPSS_RETURN_PSR // If enabled returns peak to side-lobe ratio, otherwise returns absolute peak value
 
+// Streaming detection options
+#define SRSRAN_NPSS_STREAM_SYMBOL_SZ 32    // Samples per OFDM symbol after decimation
+#define SRSRAN_NPSS_STREAM_BLOCK_SZ 1024   // Overlap-save DFT size
+
 /* Low-level API */
 typedef struct SRSRAN_API {
 #ifdef CONVOLUTION_FFT
@@ -99,6 +112,41 @@ typedef struct SRSRAN_API {
   float  peak_value;
 } srsran_npss_synch_t;
 
+typedef struct SRSRAN_API {
+  srsran_resampler_fft_t decimator;
+  srsran_dft_plan_t      fft;
+  srsran_dft_plan_t      ifft;
+
+  uint32_t fft_size;
+  uint32_t decimation; // Input samples per decimated sample
+  uint32_t delay;      // Decimator delay in input samples
+  uint32_t frame_len;  // Radio frame in decimated samples
+  uint32_t filter_len; // NPSS template in decimated samples
+  uint32_t step;       // New decimated samples per overlap-save block
+
+  cf_t*    filter_fft;
+  cf_t*    block;
+  cf_t*    block_fft;
+  cf_t*    corr;
+  float*   corr_abs;
+  float*   corr_avg; // Correlation averaged over frames, indexed by template start modulo frame_len
+  cf_t*    decim_buffer;
+  cf_t*    pending; // Input samples short of a whole decimated sample
+  uint32_t nof_pending;
+  uint32_t block_fill;
+  uint32_t corr_idx;     // corr_avg index of the next correlation output
+  uint32_t nof_corr;     // Correlation outputs in the current frame
+  int64_t  corr_start;   // Decimated sample index of the template start of the next correlation output
+  uint64_t nof_samples;  // Input samples since the last reset
+  float    ema_alpha;
+  float    cfo;          // Frequency correction, normalised to the input rate
+  double   cfo_phase;
+
+  int64_t peak_pos;   // Input sample index of the template start of the last peak, as srsran_npss_sync_find()
+  float   peak_value; // Averaged correlation at the last peak
+  float   psr;        // Peak to side-lobe ratio of the last peak
+} srsran_npss_stream_t;
+
 // Basic functionality
 SRSRAN_API int srsran_npss_synch_init(srsran_npss_synch_t* q, uint32_t frame_size, uint32_t fft_size);
 
@@ -112,6 +160,25 @@ SRSRAN_API void srsran_npss_synch_free(srsran_npss_synch_t* q);
 
 SRSRAN_API int srsran_npss_sync_find(srsran_npss_synch_t* q, cf_t* input, float* corr_peak_value);
 
+// Streaming detection
+SRSRAN_API int srsran_npss_stream_init(srsran_npss_stream_t* q, uint32_t fft_size);
+
+SRSRAN_API void srsran_npss_stream_reset(srsran_npss_stream_t* q);
+
+SRSRAN_API void srsran_npss_stream_set_ema_alpha(srsran_npss_stream_t* q, float alpha);
+
+SRSRAN_API void srsran_npss_stream_set_cfo(srsran_npss_stream_t* q, float cfo);
+
+/**
+ * Feeds nsamples of the stream. Whenever a radio frame worth of correlation is complete, the NPSS peak is searched in
+ * the averaged correlation and peak_pos, peak_value and psr are updated.
+ *
+ * @return The number of radio frames completed, or SRSRAN_ERROR
+ */
+SRSRAN_API int srsran_npss_stream_run(srsran_npss_stream_t* q, const cf_t* input, uint32_t nsamples);
+
+SRSRAN_API void srsran_npss_stream_free(srsran_npss_stream_t* q);
+
 // Internal functions
 SRSRAN_API int srsran_npss_corr_init(cf_t* npss_signal_time, uint32_t fft_size, uint32_t frame_size);
 
@@ -25,6 +25,10 @@
  *  Description:  Narrowband secondary synchronization signal (NSSS)
  *                generation and detection.
  *
+ *                Detection works on subframe aligned input, as delivered once
+ *                the NPSS has been found. The NSSS resource elements are taken
+ *                to the frequency domain and correlated coherently against
+ *                every cell ID and cyclic shift theta_f.
  *
  *  Reference:    3GPP TS 36.211 version 13.2.0 Release 13 Sec. 10.2.7.2
  *****************************************************************************/
@@ -39,7 +43,6 @@
 #include "srsran/config.h"
 #include "srsran/phy/common/phy_common.h"
 #include "srsran/phy/dft/dft.h"
-#include "srsran/phy/utils/convolution.h"
 
 #define SRSRAN_NSSS_NSYMB 11
 #define SRSRAN_NSSS_NSC 12
@@ -47,8 +50,7 @@
 #define SRSRAN_NSSS_NUM_SEQ 4
 #define SRSRAN_NSSS_TOT_LEN (SRSRAN_NSSS_NUM_SEQ * SRSRAN_NSSS_LEN)
 
-#define SRSRAN_NSSS_CORR_FILTER_LEN 1508
-#define SRSRAN_NSSS_CORR_OFFSET 412
+#define SRSRAN_NSSS_NUM_ROOTS 126
 
 #define SRSRAN_NSSS_PERIOD 2
 #define SRSRAN_NSSS_NUM_SF_DETECT (SRSRAN_NSSS_PERIOD)
@@ -76,17 +78,22 @@ static const int b_q_m[SRSRAN_NSSS_NUM_SEQ][128] = {
 
 /* Low-level API */
 typedef struct SRSRAN_API {
-  uint32_t             input_size;
-  uint32_t             subframe_sz;
-  uint32_t             fft_size, max_fft_size;
-  srsran_conv_fft_cc_t conv_fft;
-
-  cf_t*  nsss_signal_time[SRSRAN_NUM_PCI];
-  cf_t*  tmp_input;
-  cf_t*  conv_output;
-  float* conv_output_abs;
-  float  peak_values[SRSRAN_NUM_PCI];
-  float  corr_peak_threshold;
+  uint32_t          input_size;
+  uint32_t          subframe_sz;
+  uint32_t          fft_size, max_fft_size;
+  srsran_dft_plan_t fft;
+
+  cf_t*    fft_in;
+  cf_t*    fft_out;
+  cf_t*    window_shift;                     // Removes the half-subcarrier shift from the FFT window
+  cf_t     re_shift[SRSRAN_NSSS_NSC];        // Compensates the FFT window starting inside the CP
+  cf_t*    zc_conj;                          // Conjugated Zadoff-Chu sequence of every root
+  cf_t*    cover_conj;                       // Conjugated b_q(m) and theta_f shift of every q and theta_f
+  cf_t     re[SRSRAN_NSSS_LEN];
+  cf_t     tmp[SRSRAN_NSSS_LEN];
+  float    peak_values[SRSRAN_NUM_PCI];      // Normalised correlation of every cell ID, between 0 and 1
+  uint32_t peak_theta_f[SRSRAN_NUM_PCI];     // Cyclic shift index of the correlation of every cell ID
+  float    corr_peak_threshold;
 } srsran_nsss_synch_t;
 
 SRSRAN_API int srsran_nsss_synch_init(srsran_nsss_synch_t* q, uint32_t input_size, uint32_t fft_size);
@@ -95,14 +102,21 @@ SRSRAN_API void srsran_nsss_synch_free(srsran_nsss_synch_t* q);
 
 SRSRAN_API int srsran_nsss_synch_resize(srsran_nsss_synch_t* q, uint32_t fft_size);
 
+/**
+ * Searches the NSSS in input_size samples made of whole subframes, aligned to the subframe boundary within half a CP.
+ * If *cell_id is SRSRAN_CELL_ID_UNKNOWN every cell ID is searched and the best one is returned in *cell_id,
+ * otherwise only the given cell ID is verified.
+ *
+ * @param corr_peak_value Ratio of the correlation of the cell ID to the best correlation of any other cell ID
+ * @param sfn_partial Index of the cyclic shift theta_f found, that is (n_f / 2) mod 4
+ * @return SRSRAN_SUCCESS if the ratio exceeds corr_peak_threshold, SRSRAN_ERROR otherwise
+ */
 SRSRAN_API int srsran_nsss_sync_find(srsran_nsss_synch_t* q,
                                      cf_t*                input,
                                      float*               corr_peak_value,
                                      uint32_t*            cell_id,
                                      uint32_t*            sfn_partial);
 
-void srsran_nsss_sync_find_pci(srsran_nsss_synch_t* q, cf_t* input, uint32_t cell_id);
-
 SRSRAN_API int srsran_nsss_corr_init(srsran_nsss_synch_t* q);
 
 SRSRAN_API void srsran_nsss_generate(cf_t* signal, uint32_t cell_id);
@@ -118,6 +118,15 @@ typedef struct SRSRAN_API {
   cf_t* tmp_corr;                     ///< Temporal correlation frequency domain buffer
   cf_t* sf_buffer;                    ///< subframe buffer
   cf_t* pss_seq[SRSRAN_NOF_NID_2_NR]; ///< Possible frequency domain PSS for find
+  float pss_pwr[SRSRAN_NOF_NID_2_NR]; ///< Average power of each frequency domain PSS
+
+  /// PSS search batch, holds the correlation of every N_id_2 and coarse CFO shift hypothesis of a window
+  srsran_dft_plan_t ifft_corr_batch;      ///< IFFT of all the hypotheses at once, in place
+  cf_t*             pss_corr_batch;       ///< Batch buffer
+  uint32_t          pss_corr_batch_sz;    ///< Number of hypotheses that fit in the batch buffer
+  int               pss_shift_range;      ///< Maximum coarse CFO shift, in correlation subcarriers
+  int               pss_shift_coarse_inc; ///< Coarse CFO shift increment, in correlation subcarriers
+  uint32_t          pss_nof_hyp;          ///< Number of hypotheses of the current configuration
 } srsran_ssb_t;
 
 /**
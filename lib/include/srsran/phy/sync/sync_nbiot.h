@@ -49,10 +49,11 @@
 #define MAX_NUM_CFO_CANDITATES 50
 
 typedef struct SRSRAN_API {
-  srsran_npss_synch_t npss;
-  srsran_nsss_synch_t nsss;
-  srsran_cp_synch_t   cp_synch;
-  uint32_t            n_id_ncell;
+  srsran_npss_synch_t  npss;
+  srsran_npss_stream_t npss_stream;
+  srsran_nsss_synch_t  nsss;
+  srsran_cp_synch_t    cp_synch;
+  uint32_t             n_id_ncell;
 
   float        threshold;
   float        peak_value;
@@ -92,6 +93,10 @@ SRSRAN_API srsran_sync_find_ret_t srsran_sync_nbiot_find(srsran_sync_nbiot_t* q,
                                                          uint32_t             find_offset,
                                                          uint32_t*            peak_position);
 
+SRSRAN_API srsran_sync_find_ret_t srsran_sync_nbiot_find_stream(srsran_sync_nbiot_t* q,
+                                                                cf_t*                input,
+                                                                uint32_t*            peak_position);
+
 SRSRAN_API float cfo_estimate_nbiot(srsran_sync_nbiot_t* q, cf_t* input);
 
 SRSRAN_API void srsran_sync_nbiot_set_threshold(srsran_sync_nbiot_t* q, float threshold);
@@ -0,0 +1,107 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ *  File:         ue_cell_search_wb.h
+ *
+ *  Description:  Wideband cell search.
+ *
+ *                Searches LTE cells on every carrier of the 100 kHz raster
+ *                within a wideband capture. A polyphase channelizer brings
+ *                each candidate carrier to a 1.92 MHz stream, which is
+ *                searched for PSS/SSS as srsran_ue_cellsearch_scan() does
+ *                on a single carrier. Carriers are shared out between the
+ *                caller and a number of worker threads.
+ *
+ *                The capture sampling rate must be a multiple of both the
+ *                raster and SRSRAN_CS_SAMP_FREQ, e.g. 9.6, 19.2 or 38.4 MHz,
+ *                and centred on the raster.
+ *
+ *  Reference:    3GPP TS 36.104 version 10.0.0 Section 5.7.2
+ *****************************************************************************/
+
+#ifndef SRSRAN_UE_CELL_SEARCH_WB_H
+#define SRSRAN_UE_CELL_SEARCH_WB_H
+
+#include "srsran/config.h"
+#include "srsran/phy/resampling/channelizer.h"
+#include "srsran/phy/ue/ue_cell_search.h"
+#include "srsran/phy/utils/coworker_group.h"
+
+#define SRSRAN_CS_WB_RASTER_HZ (100e3)
+#define SRSRAN_CS_WB_MAX_WORKERS (16)
+#define SRSRAN_CS_WB_DEFAULT_MIN_PSR (3.0f)
+
+typedef struct SRSRAN_API {
+  double   srate_hz;         ///< Capture sampling rate
+  double   span_hz;          ///< Span of carriers searched, centred on the capture, 0 for as wide as the rate allows
+  uint32_t max_samples;      ///< Maximum capture length in samples
+  uint32_t nof_valid_frames; ///< Frames with a PSS detection to decide a cell, as srsran_ue_cellsearch_t
+  float    min_psr;          ///< Minimum peak to side-lobe ratio of a cell to be reported
+  uint32_t nof_workers;      ///< Threads searching carriers together with the caller, 0 for a serial search
+} srsran_ue_cellsearch_wb_args_t;
+
+typedef struct SRSRAN_API {
+  double                        freq_offset_hz; ///< Carrier frequency relative to the centre of the capture
+  srsran_ue_cellsearch_result_t cell;
+} srsran_ue_cellsearch_wb_result_t;
+
+typedef struct SRSRAN_API {
+  srsran_ue_cellsearch_wb_args_t args;
+  srsran_channelizer_t           channelizer;
+
+  uint32_t  nof_carriers;        ///< Candidate carriers on the raster
+  uint32_t* carrier_channel;     ///< Channelizer channel of each carrier
+  cf_t**    carrier_samples;     ///< Samples of each carrier at SRSRAN_CS_SAMP_FREQ
+  cf_t**    channel_output;      ///< Channelizer outputs, NULL for the channels which are not carriers
+  uint32_t  nof_carrier_samples; ///< Samples of each carrier in the last capture
+
+  srsran_ue_cellsearch_result_t* found;       ///< Cell found for each carrier and N_id_2
+  bool*                          found_valid; ///< Whether a cell was found for each carrier and N_id_2
+
+  void*                   lanes; ///< Cell search state of the caller and of each worker
+  srsran_coworker_group_t group; ///< Worker threads
+} srsran_ue_cellsearch_wb_t;
+
+SRSRAN_API void srsran_ue_cellsearch_wb_args_default(srsran_ue_cellsearch_wb_args_t* args);
+
+SRSRAN_API int srsran_ue_cellsearch_wb_init(srsran_ue_cellsearch_wb_t* q, const srsran_ue_cellsearch_wb_args_t* args);
+
+/**
+ * Searches cells on every carrier of a wideband capture. A cell seen by the neighbouring carriers, through the
+ * channelizer passband, is only reported on the carrier where its PSS is strongest.
+ *
+ * @param q Wideband cell search object
+ * @param samples Capture at the configured sampling rate
+ * @param nof_samples Number of samples, up to max_samples
+ * @param results Cells found, sorted by frequency
+ * @param max_results Capacity of results
+ * @return The number of cells found or SRSRAN_ERROR
+ */
+SRSRAN_API int srsran_ue_cellsearch_wb_scan(srsran_ue_cellsearch_wb_t*        q,
+                                            const cf_t*                       samples,
+                                            uint32_t                          nof_samples,
+                                            srsran_ue_cellsearch_wb_result_t* results,
+                                            uint32_t                          max_results);
+
+SRSRAN_API void srsran_ue_cellsearch_wb_free(srsran_ue_cellsearch_wb_t* q);
+
+#endif // SRSRAN_UE_CELL_SEARCH_WB_H
@@ -0,0 +1,117 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ *  File:         ue_sl_rx.h
+ *
+ *  Description:  Sidelink receiver for transmission modes 3 and 4. Searches
+ *                the PSCCH of every sub-channel of the pool and decodes the
+ *                PSSCH scheduled by each SCI found.
+ *
+ *                The DMRS of each sub-channel are correlated with the four
+ *                PSCCH cyclic shifts and only the hypotheses passing the
+ *                correlation threshold are equalized and decoded, the best
+ *                one first. Sub-channels are shared out between the caller
+ *                and a number of worker threads.
+ *
+ *  Reference:    3GPP TS 36.213 version 15.6.0 Section 14.1.1.4C
+ *****************************************************************************/
+
+#ifndef SRSRAN_UE_SL_RX_H
+#define SRSRAN_UE_SL_RX_H
+
+#include "srsran/config.h"
+#include "srsran/phy/common/phy_common_sl.h"
+#include "srsran/phy/phch/sci.h"
+#include "srsran/phy/utils/coworker_group.h"
+
+#define SRSRAN_UE_SL_RX_MAX_WORKERS (16)
+#define SRSRAN_UE_SL_RX_NOF_CYCLIC_SHIFTS (4)
+#define SRSRAN_UE_SL_RX_DEFAULT_CS_THRESHOLD (0.3f)
+
+typedef struct SRSRAN_API {
+  uint32_t nof_workers;  ///< Threads searching sub-channels together with the caller, 0 for a serial search
+  float    cs_threshold; ///< Minimum normalised DMRS correlation of a cyclic shift hypothesis, 0 decodes them all
+  bool     decode_pssch; ///< Set to decode the PSSCH scheduled by each SCI found
+  bool     keep_symbols; ///< Set to keep a copy of the equalized PSCCH and PSSCH symbols of each result
+} srsran_ue_sl_rx_args_t;
+
+/**
+ * Result of the search of one sub-channel. The buffers belong to the receiver and are overwritten by the next
+ * subframe.
+ */
+typedef struct SRSRAN_API {
+  bool         sci_decoded;
+  uint32_t     sub_channel_idx;
+  uint32_t     cyclic_shift;
+  float        corr; ///< Normalised DMRS correlation of the decoded hypothesis
+  srsran_sci_t sci;
+  uint32_t     N_x_id;
+
+  // PSSCH
+  uint32_t pssch_prb_start_idx;
+  uint32_t pssch_nof_prb;
+  bool     tb_decoded;
+  uint32_t tb_len; ///< Transport block length in bits
+  uint8_t* tb;     ///< Transport block, one bit per byte
+
+  // Equalized symbols, only if keep_symbols is set
+  cf_t*    pscch_symbols;
+  uint32_t nof_pscch_symbols;
+  cf_t*    pssch_symbols;
+  uint32_t nof_pssch_symbols;
+} srsran_ue_sl_rx_result_t;
+
+typedef struct SRSRAN_API {
+  srsran_cell_sl_t               cell;
+  srsran_sl_comm_resource_pool_t sl_comm_resource_pool;
+  srsran_ue_sl_rx_args_t         args;
+
+  srsran_ue_sl_rx_result_t* results; ///< One per sub-channel
+
+  void*                   lanes; ///< Decoding state of the caller and of each worker
+  srsran_coworker_group_t group; ///< Worker threads
+
+  // Counters since initialisation
+  uint64_t nof_hypotheses_decoded; ///< Cyclic shift hypotheses equalized and decoded
+  uint64_t nof_hypotheses_skipped; ///< Cyclic shift hypotheses rejected by the DMRS correlation
+} srsran_ue_sl_rx_t;
+
+SRSRAN_API int srsran_ue_sl_rx_init(srsran_ue_sl_rx_t*                    q,
+                                    srsran_cell_sl_t                      cell,
+                                    const srsran_sl_comm_resource_pool_t* sl_comm_resource_pool,
+                                    const srsran_ue_sl_rx_args_t*         args);
+
+SRSRAN_API void srsran_ue_sl_rx_args_default(srsran_ue_sl_rx_args_t* args);
+
+/**
+ * Searches the PSCCH in every sub-channel of a subframe and decodes the PSSCH it schedules.
+ *
+ * @param q Receiver object
+ * @param sf_symbols Resource grid of the subframe, after the FFT
+ * @param sf_idx Subframe index, used for the PSSCH
+ * @return The number of SCI decoded, with the results in q->results, or SRSRAN_ERROR
+ */
+SRSRAN_API int srsran_ue_sl_rx_decode_sf(srsran_ue_sl_rx_t* q, cf_t* sf_symbols, uint32_t sf_idx);
+
+SRSRAN_API void srsran_ue_sl_rx_free(srsran_ue_sl_rx_t* q);
+
+#endif // SRSRAN_UE_SL_RX_H
@@ -0,0 +1,101 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+
+/******************************************************************************
+ *  File:         coworker_group.h
+ *
+ *  Description:  Threads processing the items of a job together with the
+ *                calling thread. The items are claimed one at a time from a
+ *                shared index, so a thread finishing early keeps taking the
+ *                pending ones. Each thread works with its own lane, the state
+ *                it needs to process an item.
+ *
+ *  Reference:
+ *****************************************************************************/
+
+#ifndef SRSRAN_COWORKER_GROUP_H
+#define SRSRAN_COWORKER_GROUP_H
+
+#include "srsran/config.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Processes item idx of a job with the given lane
+ * @return SRSRAN_SUCCESS, or SRSRAN_ERROR if the item failed
+ */
+typedef int (*srsran_coworker_fn_t)(void* ctx, void* lane, uint32_t idx);
+
+struct srsran_coworker_s;
+
+typedef struct SRSRAN_API {
+  struct srsran_coworker_s* coworkers;
+  uint32_t                  nof_coworkers; ///< Number of coworkers whose thread is running
+  pthread_mutex_t           mutex;
+
+  // Current job
+  srsran_coworker_fn_t fn;
+  void*                ctx;
+  uint32_t             nof_items;
+  uint32_t             next_item; ///< Next item to process, protected by mutex
+  int                  ret;       ///< SRSRAN_ERROR if any item of the job failed, protected by mutex
+  bool                 quit;
+} srsran_coworker_group_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Starts the coworker threads of a group
+ * @param q Coworker group, it must be zeroed or freed before
+ * @param nof_coworkers Number of threads, 0 for a group where the caller processes every item alone
+ * @param lanes Array of nof_coworkers lanes, the i-th coworker uses the one at lanes + i * lane_sz bytes
+ * @param lane_sz Size of a lane in bytes
+ * @return SRSRAN_SUCCESS if every thread started, SRSRAN_ERROR code otherwise
+ */
+SRSRAN_API int
+srsran_coworker_group_init(srsran_coworker_group_t* q, uint32_t nof_coworkers, void* lanes, size_t lane_sz);
+
+/**
+ * @brief Calls fn for every item in [0, nof_items), from the calling thread with caller_lane and from the coworkers
+ * with their own lanes, and returns once every item has been processed
+ * @return SRSRAN_SUCCESS if every item succeeded, SRSRAN_ERROR otherwise
+ */
+SRSRAN_API int srsran_coworker_group_run(srsran_coworker_group_t* q,
+                                         uint32_t                 nof_items,
+                                         srsran_coworker_fn_t     fn,
+                                         void*                    ctx,
+                                         void*                    caller_lane);
+
+/**
+ * @brief Stops the coworker threads. Their lanes are not touched and can be released afterwards
+ */
+SRSRAN_API void srsran_coworker_group_free(srsran_coworker_group_t* q);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SRSRAN_COWORKER_GROUP_H
@@ -136,6 +136,9 @@ SRSRAN_API uint8_t* srsran_vec_u8_malloc(uint32_t nsamples);
 
 SRSRAN_API void* srsran_vec_realloc(void* ptr, uint32_t old_size, uint32_t new_size);
 
+/* Number of srsran_vec_malloc() calls made by the calling thread. Only counted if built with ENABLE_RT_ALLOC_CHECK */
+SRSRAN_API uint64_t srsran_vec_get_nof_thread_allocs();
+
 /* Zero memory */
 SRSRAN_API void srsran_vec_zero(void* ptr, uint32_t nsamples);
 SRSRAN_API void srsran_vec_cf_zero(cf_t* ptr, uint32_t nsamples);
@@ -369,6 +372,9 @@ SRSRAN_API cf_t srsran_vec_gen_sine(cf_t amplitude, float freq, cf_t* z, int len
 
 SRSRAN_API void srsran_vec_apply_cfo(const cf_t* x, float cfo, cf_t* z, int len);
 
+/* Same as srsran_vec_apply_cfo() starting from the given phase, returns the phase of the sample following z[len - 1] */
+SRSRAN_API cf_t srsran_vec_apply_cfo_phase(const cf_t* x, float cfo, cf_t phase, cf_t* z, int len);
+
 SRSRAN_API float srsran_vec_estimate_frequency(const cf_t* x, int len);
 
 /*!
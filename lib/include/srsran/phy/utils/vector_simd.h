@@ -136,6 +136,8 @@ SRSRAN_API cf_t srsran_vec_gen_sine_simd(cf_t amplitude, float freq, cf_t* z, in
 
 SRSRAN_API void srsran_vec_apply_cfo_simd(const cf_t* x, float cfo, cf_t* z, int len);
 
+SRSRAN_API cf_t srsran_vec_apply_cfo_phase_simd(const cf_t* x, float cfo, cf_t phase, cf_t* z, int len);
+
 SRSRAN_API float srsran_vec_estimate_frequency_simd(const cf_t* x, int len);
 
 /* SIMD Find Max functions */
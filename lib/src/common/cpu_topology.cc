@@ -0,0 +1,315 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/common/cpu_topology.h"
+#include "srsran/common/threads.h"
+#include "srsran/srslog/bundled/fmt/format.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <set>
+
+namespace srsran {
+
+namespace {
+
+bool read_line(const std::string& path, std::string& line)
+{
+  std::ifstream f(path);
+  if (not f.is_open()) {
+    return false;
+  }
+  std::getline(f, line);
+  return true;
+}
+
+/// Parses a decimal number spanning the whole of "str", leaving "end" after it. Returns false if there is none
+bool parse_uint(const char* str, const char** end, uint32_t& value)
+{
+  if (*str < '0' or *str > '9') {
+    return false;
+  }
+  char*         endptr = nullptr;
+  unsigned long v      = strtoul(str, &endptr, 10);
+  if (endptr == str or v > UINT32_MAX) {
+    return false;
+  }
+  value = (uint32_t)v;
+  *end  = endptr;
+  return true;
+}
+
+bool read_uint(const std::string& path, uint32_t& value)
+{
+  std::string line;
+  if (not read_line(path, line)) {
+    return false;
+  }
+  const char* end = nullptr;
+  return parse_uint(line.c_str(), &end, value) and (*end == '\0' or *end == '\n');
+}
+
+/// Parses a sysfs CPU list such as "0-3,8,10-11". Returns false if the list is malformed
+bool parse_cpu_list(const std::string& list, std::vector<uint32_t>& cpus)
+{
+  cpus.clear();
+  const char* p = list.c_str();
+  while (*p != '\0' and *p != '\n') {
+    uint32_t first = 0, last = 0;
+    if (not parse_uint(p, &p, first)) {
+      return false;
+    }
+    last = first;
+    if (*p == '-' and (not parse_uint(p + 1, &p, last) or last < first)) {
+      return false;
+    }
+    for (uint32_t c = first; c <= last; ++c) {
+      cpus.push_back(c);
+    }
+    if (*p == ',') {
+      p++;
+    } else if (*p != '\0' and *p != '\n') {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::string format_cpu_list(const std::vector<uint32_t>& cpus)
+{
+  fmt::memory_buffer fmtbuf;
+  for (size_t i = 0; i < cpus.size();) {
+    size_t j = i;
+    while (j + 1 < cpus.size() and cpus[j + 1] == cpus[j] + 1) {
+      j++;
+    }
+    const char* sep = fmtbuf.size() > 0 ? "," : "";
+    if (j == i) {
+      fmt::format_to(fmtbuf, "{}{}", sep, cpus[i]);
+    } else {
+      fmt::format_to(fmtbuf, "{}{}-{}", sep, cpus[i], cpus[j]);
+    }
+    i = j + 1;
+  }
+  return fmt::to_string(fmtbuf);
+}
+
+} // namespace
+
+cpu_topology cpu_topology::from_sysfs(const std::string& sysfs_root)
+{
+  cpu_topology          topo;
+  std::string           line;
+  std::vector<uint32_t> online, cpus;
+  if (not read_line(sysfs_root + "/cpu/online", line) or not parse_cpu_list(line, online)) {
+    return topo;
+  }
+
+  std::set<uint32_t> isolated;
+  if (read_line(sysfs_root + "/cpu/isolated", line)) {
+    if (not parse_cpu_list(line, cpus)) {
+      return topo;
+    }
+    isolated.insert(cpus.begin(), cpus.end());
+  }
+
+  for (uint32_t c : online) {
+    cpu_desc_t  desc;
+    std::string cpu_dir = fmt::format("{}/cpu/cpu{}/topology/", sysfs_root, c);
+    desc.id             = c;
+    desc.isolated       = isolated.count(c) > 0;
+    if (not read_uint(cpu_dir + "core_id", desc.core_id)) {
+      // No topology information. Consider each CPU a physical core
+      desc.core_id = c;
+    }
+    read_uint(cpu_dir + "physical_package_id", desc.package_id);
+    topo.cpu_list.push_back(desc);
+  }
+
+  // NUMA node ids may have gaps, so iterate the list of nodes. Hosts without NUMA support have no "node" directory
+  std::vector<uint32_t> nodes;
+  if (read_line(sysfs_root + "/node/online", line) or read_line(sysfs_root + "/node/possible", line)) {
+    if (not parse_cpu_list(line, nodes)) {
+      topo.cpu_list.clear();
+      return topo;
+    }
+  }
+  for (uint32_t node : nodes) {
+    if (not read_line(fmt::format("{}/node/node{}/cpulist", sysfs_root, node), line)) {
+      continue;
+    }
+    if (not parse_cpu_list(line, cpus)) {
+      // Malformed sysfs content. Return an empty topology, so that no thread is pinned
+      topo.cpu_list.clear();
+      return topo;
+    }
+    for (uint32_t c : cpus) {
+      for (cpu_desc_t& desc : topo.cpu_list) {
+        if (desc.id == c) {
+          desc.numa_node = node;
+        }
+      }
+    }
+  }
+
+  return topo;
+}
+
+uint32_t cpu_topology::nof_numa_nodes() const
+{
+  std::set<uint32_t> nodes;
+  for (const cpu_desc_t& c : cpu_list) {
+    nodes.insert(c.numa_node);
+  }
+  return nodes.size();
+}
+
+uint32_t cpu_topology::nof_physical_cores() const
+{
+  std::set<std::pair<uint32_t, uint32_t> > cores;
+  for (const cpu_desc_t& c : cpu_list) {
+    cores.emplace(c.package_id, c.core_id);
+  }
+  return cores.size();
+}
+
+cpu_placement::cpu_placement(cpu_topology topo_) : topo(std::move(topo_)), core_reserved(topo.cpus().size(), false) {}
+
+bool cpu_placement::is_core_free(const cpu_desc_t& c) const
+{
+  const std::vector<cpu_desc_t>& cpus = topo.cpus();
+  for (size_t i = 0; i < cpus.size(); ++i) {
+    if (core_reserved[i] and cpus[i].package_id == c.package_id and cpus[i].core_id == c.core_id) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int cpu_placement::reserve_rt_cpu(const std::string& thread_name, int numa_node)
+{
+  const std::vector<cpu_desc_t>& cpus = topo.cpus();
+
+  if (numa_node < 0) {
+    // Select the node with the most free physical cores
+    std::map<uint32_t, std::set<std::pair<uint32_t, uint32_t> > > free_cores;
+    for (const cpu_desc_t& c : cpus) {
+      if (is_core_free(c)) {
+        free_cores[c.numa_node].emplace(c.package_id, c.core_id);
+      }
+    }
+    size_t max_free = 0;
+    for (const auto& node_cores : free_cores) {
+      if (node_cores.second.size() > max_free) {
+        max_free  = node_cores.second.size();
+        numa_node = (int)node_cores.first;
+      }
+    }
+    if (numa_node < 0) {
+      return -1;
+    }
+  }
+
+  // Rank candidates: isolated cores first, and CPU 0 last, as it usually handles the OS housekeeping
+  int best_idx  = -1;
+  int best_rank = 0;
+  for (size_t i = 0; i < cpus.size(); ++i) {
+    const cpu_desc_t& c = cpus[i];
+    if (c.numa_node != (uint32_t)numa_node or not is_core_free(c)) {
+      continue;
+    }
+    int rank = (c.isolated ? 2 : 0) + (c.id != 0 ? 1 : 0);
+    if (best_idx < 0 or rank > best_rank) {
+      best_idx  = (int)i;
+      best_rank = rank;
+    }
+  }
+  if (best_idx < 0) {
+    return -1;
+  }
+
+  core_reserved[best_idx] = true;
+  rt_threads.push_back({thread_name, cpus[best_idx].id});
+  return (int)cpus[best_idx].id;
+}
+
+std::vector<uint32_t> cpu_placement::get_shared_cpus() const
+{
+  std::vector<uint32_t> shared, all;
+  for (const cpu_desc_t& c : topo.cpus()) {
+    all.push_back(c.id);
+    if (is_core_free(c) and not c.isolated) {
+      shared.push_back(c.id);
+    }
+  }
+  return shared.empty() ? all : shared;
+}
+
+int cpu_placement::get_numa_node(uint32_t cpu) const
+{
+  for (const cpu_desc_t& c : topo.cpus()) {
+    if (c.id == cpu) {
+      return (int)c.numa_node;
+    }
+  }
+  return -1;
+}
+
+std::string cpu_placement::to_string() const
+{
+  std::vector<uint32_t> isolated;
+  for (const cpu_desc_t& c : topo.cpus()) {
+    if (c.isolated) {
+      isolated.push_back(c.id);
+    }
+  }
+
+  fmt::memory_buffer fmtbuf;
+  fmt::format_to(fmtbuf,
+                 "CPU placement: {} NUMA node(s), {} physical core(s), {} CPU(s), isolated=[{}]\n",
+                 topo.nof_numa_nodes(),
+                 topo.nof_physical_cores(),
+                 topo.cpus().size(),
+                 format_cpu_list(isolated));
+  for (const rt_thread_t& t : rt_threads) {
+    fmt::format_to(fmtbuf, "  {:<10} -> CPU {} (node {})\n", t.name, t.cpu, get_numa_node(t.cpu));
+  }
+  fmt::format_to(fmtbuf, "  {:<10} -> CPUs {}\n", "non-RT", format_cpu_list(get_shared_cpus()));
+  return fmt::to_string(fmtbuf);
+}
+
+scoped_cpu_affinity::scoped_cpu_affinity(const std::vector<uint32_t>& cpus)
+{
+  if (cpus.empty() or pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &prev_set) != 0) {
+    return;
+  }
+  restore = threads_set_affinity(pthread_self(), cpus.data(), (uint32_t)cpus.size());
+}
+
+scoped_cpu_affinity::~scoped_cpu_affinity()
+{
+  if (restore) {
+    pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &prev_set);
+  }
+}
+
+} // namespace srsran
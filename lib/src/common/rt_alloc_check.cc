@@ -0,0 +1,80 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/common/rt_alloc_check.h"
+#include "srsran/phy/utils/vector.h"
+
+#ifdef ENABLE_RT_ALLOC_CHECK
+
+#include <cstdlib>
+#include <new>
+
+static thread_local uint64_t nof_thread_new_calls = 0;
+
+static void* counted_alloc(std::size_t sz)
+{
+  nof_thread_new_calls++;
+  return std::malloc(sz == 0 ? 1 : sz);
+}
+
+// The replacements below allocate with malloc, so the default operator delete (which calls free) remains valid
+
+void* operator new(std::size_t sz)
+{
+  void* p = counted_alloc(sz);
+  if (p == nullptr) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void* operator new[](std::size_t sz)
+{
+  void* p = counted_alloc(sz);
+  if (p == nullptr) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void* operator new(std::size_t sz, const std::nothrow_t&) noexcept
+{
+  return counted_alloc(sz);
+}
+
+void* operator new[](std::size_t sz, const std::nothrow_t&) noexcept
+{
+  return counted_alloc(sz);
+}
+
+uint64_t srsran::get_nof_thread_heap_allocs()
+{
+  return nof_thread_new_calls + srsran_vec_get_nof_thread_allocs();
+}
+
+#else
+
+uint64_t srsran::get_nof_thread_heap_allocs()
+{
+  return 0;
+}
+
+#endif
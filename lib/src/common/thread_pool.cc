@@ -226,6 +226,18 @@ thread_pool::worker* thread_pool::wait_worker_nb(uint32_t tti)
   return ret;
 }
 
+thread_pool::worker* thread_pool::wait_worker_id_nb(uint32_t id)
+{
+  std::unique_lock<std::mutex> lock(mutex_queue);
+
+  thread_pool::worker* ret = nullptr;
+  if (id < nof_workers && status[id] == IDLE && running) {
+    ret        = workers[id];
+    status[id] = WORKER_READY;
+  }
+  return ret;
+}
+
 void thread_pool::start_worker(uint32_t id)
 {
   std::unique_lock<std::mutex> lock(mutex_queue);
@@ -94,10 +94,8 @@ int srsran_chest_ul_init(srsran_chest_ul_t* q, uint32_t max_prb)
 
     q->dmrs_signal_configured = false;
 
-    if (srsran_refsignal_dmrs_pusch_pregen_init(&q->dmrs_pregen, max_prb)) {
-      ERROR("Error allocating memory for pregenerated signals");
-      goto clean_exit;
-    }
+    // The pregenerated DMRS are allocated by srsran_chest_ul_pregen(), unless a shared table is provided before
+    q->dmrs_pregen.max_prb = max_prb;
   }
 
   ret = SRSRAN_SUCCESS;
@@ -183,17 +181,35 @@ int srsran_chest_ul_set_cell(srsran_chest_ul_t* q, srsran_cell_t cell)
   return ret;
 }
 
-void srsran_chest_ul_pregen(srsran_chest_ul_t*                 q,
-                            srsran_refsignal_dmrs_pusch_cfg_t* cfg,
-                            srsran_refsignal_srs_cfg_t*        srs_cfg)
+void srsran_chest_ul_set_dmrs_pregen(srsran_chest_ul_t* q, const srsran_refsignal_ul_dmrs_pregen_t* pregen)
+{
+  srsran_refsignal_dmrs_pusch_pregen_free(&q->dmrs_signal, &q->dmrs_pregen);
+  q->dmrs_pregen_shared = pregen;
+}
+
+int srsran_chest_ul_pregen(srsran_chest_ul_t*                 q,
+                           srsran_refsignal_dmrs_pusch_cfg_t* cfg,
+                           srsran_refsignal_srs_cfg_t*        srs_cfg)
 {
-  srsran_refsignal_dmrs_pusch_pregen(&q->dmrs_signal, &q->dmrs_pregen, cfg);
+  // A shared table is generated by its owner
+  if (q->dmrs_pregen_shared == NULL) {
+    bool allocated = q->dmrs_pregen.r[0][0] != NULL;
+    if (!allocated && srsran_refsignal_dmrs_pusch_pregen_init(&q->dmrs_pregen, q->dmrs_pregen.max_prb)) {
+      ERROR("Error allocating memory for pregenerated signals");
+      return SRSRAN_ERROR;
+    }
+    if (srsran_refsignal_dmrs_pusch_pregen(&q->dmrs_signal, &q->dmrs_pregen, cfg)) {
+      ERROR("Error generating PUSCH DMRS signals");
+      return SRSRAN_ERROR;
+    }
+  }
   q->dmrs_signal_configured = true;
 
   if (srs_cfg) {
     srsran_refsignal_srs_pregen(&q->dmrs_signal, &q->srs_pregen, srs_cfg, cfg);
     q->srs_signal_configured = true;
   }
+  return SRSRAN_SUCCESS;
 }
 
 /* Uses the difference between the averaged and non-averaged pilot estimates */
@@ -406,8 +422,9 @@ int srsran_chest_ul_estimate_pusch(srsran_chest_ul_t*     q,
   srsran_refsignal_dmrs_pusch_get(&q->dmrs_signal, cfg, input, q->pilot_recv_signal);
 
   // Use the known DMRS signal to compute Least-squares estimates
+  const srsran_refsignal_ul_dmrs_pregen_t* pregen = q->dmrs_pregen_shared ? q->dmrs_pregen_shared : &q->dmrs_pregen;
   srsran_vec_prod_conj_ccc(q->pilot_recv_signal,
-                           q->dmrs_pregen.r[cfg->grant.n_dmrs][sf->tti % SRSRAN_NOF_SF_X_FRAME][nof_prb],
+                           pregen->r[cfg->grant.n_dmrs][sf->tti % SRSRAN_NOF_SF_X_FRAME][nof_prb],
                            q->pilot_estimates,
                            nrefs_sf);
 
@@ -312,11 +312,30 @@ void srsran_refsignal_dmrs_pusch_pregen_free(srsran_refsignal_ul_t* q, srsran_re
           }
         }
         free(pregen->r[cs][sf_idx]);
+        pregen->r[cs][sf_idx] = NULL;
       }
     }
   }
 }
 
+uint32_t srsran_refsignal_dmrs_pusch_pregen_nof_bytes(const srsran_refsignal_ul_dmrs_pregen_t* pregen)
+{
+  uint32_t nof_bytes = 0;
+  for (uint32_t sf_idx = 0; sf_idx < SRSRAN_NOF_SF_X_FRAME; sf_idx++) {
+    for (uint32_t cs = 0; cs < SRSRAN_NOF_CSHIFT; cs++) {
+      if (pregen->r[cs][sf_idx]) {
+        nof_bytes += sizeof(cf_t*) * (pregen->max_prb + 1);
+        for (uint32_t n = 0; n <= pregen->max_prb; n++) {
+          if (pregen->r[cs][sf_idx][n]) {
+            nof_bytes += sizeof(cf_t) * n * 2 * SRSRAN_NRE;
+          }
+        }
+      }
+    }
+  }
+  return nof_bytes;
+}
+
 int srsran_refsignal_dmrs_pusch_pregen_put(srsran_refsignal_ul_t*             q,
                                            srsran_ul_sf_cfg_t*                sf_cfg,
                                            srsran_refsignal_ul_dmrs_pregen_t* pregen,
@@ -94,6 +94,11 @@ void srsran_enb_ul_free(srsran_enb_ul_t* q)
   }
 }
 
+void srsran_enb_ul_set_dmrs_pregen(srsran_enb_ul_t* q, const srsran_refsignal_ul_dmrs_pregen_t* pregen)
+{
+  srsran_chest_ul_set_dmrs_pregen(&q->chest, pregen);
+}
+
 int srsran_enb_ul_set_cell(srsran_enb_ul_t*                   q,
                            srsran_cell_t                      cell,
                            srsran_refsignal_dmrs_pusch_cfg_t* pusch_cfg,
@@ -138,7 +143,10 @@ int srsran_enb_ul_set_cell(srsran_enb_ul_t*                   q,
       }
 
       // SRS is a dedicated configuration
-      srsran_chest_ul_pregen(&q->chest, pusch_cfg, srs_cfg);
+      if (srsran_chest_ul_pregen(&q->chest, pusch_cfg, srs_cfg)) {
+        ERROR("Error pregenerating UL reference signals");
+        return SRSRAN_ERROR;
+      }
 
       ret = SRSRAN_SUCCESS;
     }
@@ -417,4 +417,49 @@ void encode_high_rate_case4_avx512(void* o);
  */
 void encode_ext_region_avx512(srsran_ldpc_encoder_t* q, uint8_t n_layers);
 
+/*!
+ * Creates the inner registers required by the packed-bit LDPC encoder.
+ * \param[in] q A pointer to an encoder.
+ * \return A pointer to the newly created structure of registers.
+ */
+void* create_ldpc_enc_packed(srsran_ldpc_encoder_t* q);
+
+/*!
+ * Deletes the inner registers of the packed-bit LDPC encoder.
+ * \param[in] p A pointer to the register structure.
+ */
+void delete_ldpc_enc_packed(void* p);
+
+/*!
+ * Loads the packed message in the packed-bit encoder registers.
+ * \param[in,out] q     A pointer to an encoder.
+ * \param[in]     input The packed message to encode.
+ */
+void load_packed(srsran_ldpc_encoder_t* q, const uint8_t* input);
+
+/*! Computes the product between the first (K - 2) columns of the PCM and the systematic bits (packed-bit version).
+ * \param[in,out] q        A pointer to an encoder.
+ * \param[in]     n_layers The number of layers to process.
+ */
+void preprocess_systematic_bits_packed(srsran_ldpc_encoder_t* q, uint8_t n_layers);
+
+/*! Computes the high-rate parity bits for any base graph and lifting size (packed-bit version).
+ * \param[in,out] q A pointer to an encoder.
+ */
+void encode_high_rate_packed(srsran_ldpc_encoder_t* q);
+
+/*! Computes the extended-region parity bits (packed-bit version).
+ * \param[in,out] q        A pointer to an encoder.
+ * \param[in]     n_layers The number of layers to process (when doing rate matching not all
+ *                         layers are needed).
+ */
+void encode_ext_region_packed(srsran_ldpc_encoder_t* q, uint8_t n_layers);
+
+/*! Extracts the final packed codeword from the packed-bit encoder registers.
+ * \param[in]  q        A pointer to an encoder.
+ * \param[out] output   The packed output codeword.
+ * \param[in]  n_layers The number of parity layers (after rate-matching, if enabled).
+ */
+void return_codeword_packed(srsran_ldpc_encoder_t* q, uint8_t* output, uint8_t n_layers);
+
 #endif // SRSRAN_LDPCENC_ALL_H
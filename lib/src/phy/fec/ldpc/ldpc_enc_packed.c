@@ -0,0 +1,246 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/*!
+ * \file ldpc_enc_packed.c
+ * \brief Definition of the LDPC encoder inner functions working on packed bits.
+ *
+ * Each lifted block of ls bits is stored MSB first in a few 64-bit words, so that circular shifts and XORs process
+ * 64 bits per operation instead of one bit per byte. The word loops have no dependencies and are vectorized by the
+ * compiler.
+ *
+ * \copyright Software Radio Systems Limited
+ *
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <strings.h>
+
+#include "ldpc_enc_all.h"
+#include "ldpc_packed_bits.h"
+#include "srsran/phy/fec/ldpc/base_graph.h"
+#include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/vector.h"
+
+#define WORDS_MAX ((MAX_LIFTSIZE + 63) / 64) /*!< \brief Maximum number of words in a lifted block. */
+
+/*!
+ * \brief Inner registers of the packed-bit LDPC encoder.
+ */
+typedef struct {
+  uint32_t nof_words;               /*!< \brief Number of words in a lifted block. */
+  uint64_t last_word_mask;          /*!< \brief Valid bits of the last word of a lifted block. */
+  uint8_t  high_rate_case;          /*!< \brief High-rate region structure, from 1 to 4 (see ldpc_enc_c.c). */
+  uint16_t high_rate_shift;         /*!< \brief Circular shift of the first high-rate parity block. */
+  uint64_t msg[BG1K][WORDS_MAX];    /*!< \brief Message blocks. */
+  uint64_t aux[BG1M][WORDS_MAX];    /*!< \brief Products between the PCM and the message blocks. */
+  uint64_t parity[BG1M][WORDS_MAX]; /*!< \brief Parity blocks. */
+} ldpc_enc_packed_t;
+
+/*!
+ * Reads the 64 bits of a lifted block starting at bit pos. Bits past the end of the block are zero.
+ */
+static inline uint64_t block_word(const ldpc_enc_packed_t* p, const uint64_t* block, uint32_t pos)
+{
+  uint32_t w   = pos / 64;
+  uint32_t bit = pos % 64;
+  uint64_t hi  = w < p->nof_words ? block[w] : 0;
+  if (bit == 0) {
+    return hi;
+  }
+  uint64_t lo = w + 1 < p->nof_words ? block[w + 1] : 0;
+  return (hi << bit) | (lo >> (64U - bit));
+}
+
+/*!
+ * XORs into acc the block in circularly shifted by shift positions, that is, acc[i] ^= in[(i + shift) % ls].
+ */
+static inline void
+xor_shifted(const ldpc_enc_packed_t* p, uint64_t* acc, const uint64_t* in, uint32_t shift, uint32_t ls)
+{
+  for (uint32_t w = 0; w < p->nof_words; w++) {
+    // Bits from the shifted position up to the end of the block, followed by the bits from the start of the block
+    uint32_t start = (64 * w + shift) % ls;
+    uint32_t first = ls - start;
+    uint64_t word  = block_word(p, in, start);
+    if (first < 64) {
+      word |= in[0] >> first;
+    }
+    acc[w] ^= word;
+  }
+  acc[p->nof_words - 1] &= p->last_word_mask;
+}
+
+/*!
+ * Circularly shifts a block, that is, out[i] = in[(i + shift) % ls].
+ */
+static inline void
+shift_block(const ldpc_enc_packed_t* p, uint64_t* out, const uint64_t* in, uint32_t shift, uint32_t ls)
+{
+  bzero(out, p->nof_words * sizeof(uint64_t));
+  xor_shifted(p, out, in, shift, ls);
+}
+
+void* create_ldpc_enc_packed(srsran_ldpc_encoder_t* q)
+{
+  uint8_t ls_index = get_ls_index(q->ls);
+  if (ls_index == VOID_LIFTSIZE) {
+    ERROR("Invalid lifting size %d", q->ls);
+    return NULL;
+  }
+
+  ldpc_enc_packed_t* p = srsran_vec_malloc(sizeof(ldpc_enc_packed_t));
+  if (p == NULL) {
+    return NULL;
+  }
+  bzero(p, sizeof(ldpc_enc_packed_t));
+
+  p->nof_words      = (q->ls + 63) / 64;
+  p->last_word_mask = UINT64_MAX << (64 * p->nof_words - q->ls);
+
+  // Same selection as the other encoder types. The shift gives out[k] = t[k + 1] (cases 1 and 4), t[k - 105] (case 2)
+  // and t[k - 1] (case 3)
+  if (q->bg == BG1 && ls_index != 6) {
+    p->high_rate_case  = 1;
+    p->high_rate_shift = 1 % q->ls;
+  } else if (q->bg == BG1 && ls_index == 6) {
+    p->high_rate_case  = 2;
+    p->high_rate_shift = (q->ls - 105 % q->ls) % q->ls;
+  } else if (q->bg == BG2 && ls_index != 3 && ls_index != 7) {
+    p->high_rate_case  = 3;
+    p->high_rate_shift = q->ls - 1;
+  } else {
+    p->high_rate_case  = 4;
+    p->high_rate_shift = 1 % q->ls;
+  }
+
+  return p;
+}
+
+void delete_ldpc_enc_packed(void* p)
+{
+  if (p != NULL) {
+    free(p);
+  }
+}
+
+void load_packed(srsran_ldpc_encoder_t* q, const uint8_t* input)
+{
+  ldpc_enc_packed_t* p = q->ptr_packed;
+
+  for (uint32_t k = 0; k < q->bgK; k++) {
+    for (uint32_t w = 0; w < p->nof_words; w++) {
+      uint32_t nof_bits = SRSRAN_MIN(64, q->ls - 64 * w);
+      p->msg[k][w]      = ldpc_packed_load(input, k * q->ls + 64 * w, nof_bits);
+    }
+  }
+}
+
+void preprocess_systematic_bits_packed(srsran_ldpc_encoder_t* q, uint8_t n_layers)
+{
+  ldpc_enc_packed_t* p = q->ptr_packed;
+
+  // Only the check nodes of the transmitted layers are needed
+  for (uint32_t m = 0; m < n_layers; m++) {
+    bzero(p->aux[m], p->nof_words * sizeof(uint64_t));
+    const uint16_t* this_shift = q->pcm + m * q->bgN;
+    for (uint32_t k = 0; k < q->bgK; k++) {
+      if (this_shift[k] != NO_CNCT) {
+        xor_shifted(p, p->aux[m], p->msg[k], this_shift[k], q->ls);
+      }
+    }
+  }
+}
+
+void encode_high_rate_packed(srsran_ldpc_encoder_t* q)
+{
+  ldpc_enc_packed_t* p  = q->ptr_packed;
+  uint32_t           nw = p->nof_words;
+
+  uint64_t sum[WORDS_MAX];
+  uint64_t shifted[WORDS_MAX];
+  for (uint32_t w = 0; w < nw; w++) {
+    sum[w] = p->aux[0][w] ^ p->aux[1][w] ^ p->aux[2][w] ^ p->aux[3][w];
+  }
+
+  if (p->high_rate_case == 1 || p->high_rate_case == 4) {
+    // The first chunk is the sum and the others depend on its shifted version
+    shift_block(p, shifted, sum, p->high_rate_shift, q->ls);
+    for (uint32_t w = 0; w < nw; w++) {
+      p->parity[0][w] = sum[w];
+      p->parity[1][w] = p->aux[0][w] ^ shifted[w];
+      p->parity[3][w] = p->aux[3][w] ^ shifted[w];
+      if (p->high_rate_case == 1) {
+        p->parity[2][w] = p->aux[2][w] ^ p->parity[3][w];
+      } else {
+        p->parity[2][w] = p->aux[1][w] ^ p->parity[1][w];
+      }
+    }
+  } else {
+    // The first chunk is the shifted sum and the others depend on it directly
+    shift_block(p, p->parity[0], sum, p->high_rate_shift, q->ls);
+    for (uint32_t w = 0; w < nw; w++) {
+      p->parity[1][w] = p->aux[0][w] ^ p->parity[0][w];
+      p->parity[3][w] = p->aux[3][w] ^ p->parity[0][w];
+      if (p->high_rate_case == 2) {
+        p->parity[2][w] = p->aux[2][w] ^ p->parity[3][w];
+      } else {
+        p->parity[2][w] = p->aux[1][w] ^ p->parity[1][w];
+      }
+    }
+  }
+}
+
+void encode_ext_region_packed(srsran_ldpc_encoder_t* q, uint8_t n_layers)
+{
+  ldpc_enc_packed_t* p = q->ptr_packed;
+
+  for (uint32_t m = 4; m < n_layers; m++) {
+    for (uint32_t w = 0; w < p->nof_words; w++) {
+      p->parity[m][w] = p->aux[m][w];
+    }
+    // sum the contribution due to the high-rate region, with the proper circular shifts
+    const uint16_t* this_shift = q->pcm + q->bgK + m * q->bgN;
+    for (uint32_t k = 0; k < 4; k++) {
+      if (this_shift[k] != NO_CNCT) {
+        xor_shifted(p, p->parity[m], p->parity[k], this_shift[k], q->ls);
+      }
+    }
+  }
+}
+
+void return_codeword_packed(srsran_ldpc_encoder_t* q, uint8_t* output, uint8_t n_layers)
+{
+  ldpc_enc_packed_t*   p = q->ptr_packed;
+  ldpc_packed_writer_t writer;
+  ldpc_packed_writer_init(&writer, output, 0);
+
+  // The first two systematic blocks are punctured
+  for (uint32_t k = 2; k < q->bgK + n_layers; k++) {
+    const uint64_t* block = (k < q->bgK) ? p->msg[k] : p->parity[k - q->bgK];
+    for (uint32_t w = 0; w < p->nof_words; w++) {
+      ldpc_packed_writer_put_msb(&writer, block[w], SRSRAN_MIN(64, q->ls - 64 * w));
+    }
+  }
+
+  ldpc_packed_writer_flush(&writer);
+}
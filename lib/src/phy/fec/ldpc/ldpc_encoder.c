@@ -544,6 +544,12 @@ int srsran_ldpc_encoder_init(srsran_ldpc_encoder_t*     q,
     return -1;
   }
 
+  // The packed-bit encoder is available regardless of the encoder type
+  if ((q->ptr_packed = create_ldpc_enc_packed(q)) == NULL) {
+    ERROR("Create_ldpc_enc_packed");
+    return -1;
+  }
+
   switch (type) {
     case SRSRAN_LDPC_ENCODER_C:
       return init_c(q);
@@ -573,6 +579,9 @@ void srsran_ldpc_encoder_free(srsran_ldpc_encoder_t* q)
   if (q->free) {
     q->free(q);
   }
+  if (q->ptr_packed) {
+    delete_ldpc_enc_packed(q->ptr_packed);
+  }
   bzero(q, sizeof(srsran_ldpc_encoder_t));
 }
 
@@ -589,3 +598,49 @@ int srsran_ldpc_encoder_encode_rm(srsran_ldpc_encoder_t* q,
 {
   return q->encode(q, input, output, input_length, cdwd_rm_length);
 }
+
+int srsran_ldpc_encoder_encode_packed(srsran_ldpc_encoder_t* q,
+                                      const uint8_t*         input,
+                                      uint8_t*               output,
+                                      uint32_t               input_length,
+                                      uint32_t               cdwd_rm_length)
+{
+  if (q->ptr_packed == NULL) {
+    ERROR("Encoder not initialized.");
+    return -1;
+  }
+
+  if (input_length / q->bgK != q->ls) {
+    ERROR("Dimension mismatch.");
+    return -1;
+  }
+
+  // it must be smaller than the codeword size
+  if (cdwd_rm_length > q->liftN - 2 * q->ls) {
+    cdwd_rm_length = q->liftN - 2 * q->ls;
+  }
+  // We need at least q->bgK + 4 variable nodes to cover the high-rate region. However,
+  // 2 variable nodes are systematically punctured by the encoder.
+  if (cdwd_rm_length < (q->bgK + 2) * q->ls) {
+    cdwd_rm_length = (q->bgK + 2) * q->ls;
+  }
+  if (cdwd_rm_length % q->ls) {
+    cdwd_rm_length = (cdwd_rm_length / q->ls + 1) * q->ls;
+  }
+
+  // When computing the number of layers, we need to recall that the standard always removes
+  // the first two variable nodes from the final codeword.
+  uint8_t n_layers = cdwd_rm_length / q->ls - q->bgK + 2;
+
+  load_packed(q, input);
+
+  preprocess_systematic_bits_packed(q, n_layers);
+
+  encode_high_rate_packed(q);
+
+  encode_ext_region_packed(q, n_layers);
+
+  return_codeword_packed(q, output, n_layers);
+
+  return 0;
+}
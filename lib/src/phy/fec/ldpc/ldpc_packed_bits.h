@@ -0,0 +1,115 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/*!
+ * \file ldpc_packed_bits.h
+ * \brief Helpers for reading and writing bit sequences packed MSB first, shared by the packed-bit LDPC encoder and
+ * rate matcher.
+ *
+ * \copyright Software Radio Systems Limited
+ *
+ */
+
+#ifndef SRSRAN_LDPC_PACKED_BITS_H
+#define SRSRAN_LDPC_PACKED_BITS_H
+
+#include <stdint.h>
+
+/*!
+ * Reads nof_bits (1 to 64) bits starting at bit position pos of a packed buffer. Only the bytes holding the requested
+ * bits are accessed.
+ * \return The bits, aligned to the MSB of the returned word. The remaining bits are zero.
+ */
+static inline uint64_t ldpc_packed_load(const uint8_t* buffer, uint32_t pos, uint32_t nof_bits)
+{
+  const uint8_t* ptr       = buffer + pos / 8;
+  uint32_t       offset    = pos % 8;
+  uint32_t       nof_bytes = (offset + nof_bits + 7) / 8;
+
+  uint64_t value = 0;
+  for (uint32_t i = 0; i < nof_bytes && i < 8; i++) {
+    value |= (uint64_t)ptr[i] << (56U - 8U * i);
+  }
+  value <<= offset;
+  if (nof_bytes > 8) {
+    value |= (uint64_t)ptr[8] >> (8U - offset);
+  }
+
+  return nof_bits < 64 ? value & ~(UINT64_MAX >> nof_bits) : value;
+}
+
+/*!
+ * \brief Appends bits to a packed buffer.
+ */
+typedef struct {
+  uint8_t* ptr;      /*!< \brief Next byte to write. */
+  uint64_t acc;      /*!< \brief Pending bits, aligned to the LSB. */
+  uint32_t nof_bits; /*!< \brief Number of pending bits, always lower than 8 between calls. */
+} ldpc_packed_writer_t;
+
+/*!
+ * Starts writing at bit w_offset (0 to 7) of output. The first w_offset bits of the first byte are kept.
+ */
+static inline void ldpc_packed_writer_init(ldpc_packed_writer_t* w, uint8_t* output, uint32_t w_offset)
+{
+  w->ptr      = output;
+  w->nof_bits = w_offset;
+  w->acc      = w_offset ? (uint64_t)(output[0] >> (8U - w_offset)) : 0;
+}
+
+/*!
+ * Appends the nof_bits (up to 32) LSBs of value.
+ */
+static inline void ldpc_packed_writer_put(ldpc_packed_writer_t* w, uint64_t value, uint32_t nof_bits)
+{
+  w->acc = (w->acc << nof_bits) | value;
+  w->nof_bits += nof_bits;
+  while (w->nof_bits >= 8) {
+    w->nof_bits -= 8;
+    *(w->ptr++) = (uint8_t)(w->acc >> w->nof_bits);
+  }
+}
+
+/*!
+ * Appends the nof_bits (1 to 64) MSBs of value.
+ */
+static inline void ldpc_packed_writer_put_msb(ldpc_packed_writer_t* w, uint64_t value, uint32_t nof_bits)
+{
+  uint64_t lsb = value >> (64U - nof_bits);
+  if (nof_bits > 32) {
+    ldpc_packed_writer_put(w, lsb >> 32U, nof_bits - 32);
+    ldpc_packed_writer_put(w, lsb & UINT32_MAX, 32);
+  } else {
+    ldpc_packed_writer_put(w, lsb, nof_bits);
+  }
+}
+
+/*!
+ * Writes the pending bits. The bits of the last byte after the written ones are set to zero.
+ */
+static inline void ldpc_packed_writer_flush(ldpc_packed_writer_t* w)
+{
+  if (w->nof_bits > 0) {
+    *w->ptr = (uint8_t)(w->acc << (8U - w->nof_bits));
+  }
+}
+
+#endif // SRSRAN_LDPC_PACKED_BITS_H
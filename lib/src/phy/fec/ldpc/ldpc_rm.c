@@ -34,6 +34,7 @@
 #include <stdint.h>
 #include <stdio.h>
 
+#include "ldpc_packed_bits.h"
 #include "srsran/phy/fec/ldpc/ldpc_common.h" //FILLER_BIT definition
 #include "srsran/phy/fec/ldpc/ldpc_rm.h"
 #include "srsran/phy/utils/vector.h"
@@ -410,6 +411,75 @@ bit_interleaver_rm_rx_c(const int8_t* input, int8_t* output, const uint32_t in_o
   }
 }
 
+/*!
+ * \brief Reads the circular buffer of a packed codeword, skipping the filler bits.
+ */
+typedef struct {
+  const uint8_t* input;      /*!< \brief Packed codeword. */
+  uint32_t       pos;        /*!< \brief Next bit to read. */
+  uint32_t       seg_end;    /*!< \brief End of the contiguous segment being read. */
+  uint32_t       filler_ini; /*!< \brief First filler bit, limited to the circular buffer size. */
+  uint32_t       filler_end; /*!< \brief End of the filler bits, limited to the circular buffer size. */
+  uint32_t       Ncb;        /*!< \brief Circular buffer size. */
+} rm_tx_reader_t;
+
+/*!
+ * Places the reader at the given position of the circular buffer once the filler bits are removed.
+ */
+static void rm_tx_reader_init(rm_tx_reader_t* r,
+                              const uint8_t*  input,
+                              const uint32_t  pos,
+                              const uint32_t  filler_ini,
+                              const uint32_t  filler_end,
+                              const uint32_t  Ncb)
+{
+  r->input      = input;
+  r->filler_ini = filler_ini;
+  r->filler_end = filler_end;
+  r->Ncb        = Ncb;
+  if (pos < filler_ini) {
+    r->pos     = pos;
+    r->seg_end = filler_ini;
+  } else {
+    r->pos     = pos + (filler_end - filler_ini);
+    r->seg_end = Ncb;
+  }
+}
+
+/*!
+ * Reads the next nof_bits (up to 8) bits, the first one is the MSB of the returned value.
+ */
+static inline uint32_t rm_tx_reader_get(rm_tx_reader_t* r, uint32_t nof_bits)
+{
+  uint32_t value = 0;
+  while (nof_bits > 0) {
+    // Jump over the filler bits or wrap around the circular buffer
+    while (r->pos == r->seg_end) {
+      if (r->seg_end == r->filler_ini && r->filler_end < r->Ncb) {
+        r->pos     = r->filler_end;
+        r->seg_end = r->Ncb;
+      } else {
+        r->pos     = 0;
+        r->seg_end = r->filler_ini;
+      }
+    }
+
+    uint32_t n = SRSRAN_MIN(nof_bits, r->seg_end - r->pos);
+    value      = (value << n) | (uint32_t)(ldpc_packed_load(r->input, r->pos, n) >> (64U - n));
+    r->pos += n;
+    nof_bits -= n;
+  }
+  return value;
+}
+
+/*!
+ * Moves bit (7 - k) of a byte to the LSB of byte k of the result, for k = 0, ..., 7.
+ */
+static inline uint64_t rm_tx_spread(uint32_t byte)
+{
+  return (((uint64_t)byte * 0x8040201008040201ULL) & 0x8080808080808080ULL) >> 7U;
+}
+
 int srsran_ldpc_rm_tx_init(srsran_ldpc_rm_t* p)
 {
   if (p == NULL) {
@@ -609,6 +679,83 @@ int srsran_ldpc_rm_tx(srsran_ldpc_rm_t*        q,
   return 0;
 }
 
+int srsran_ldpc_rm_tx_packed(srsran_ldpc_rm_t*        q,
+                             const uint8_t*           input,
+                             uint8_t*                 output,
+                             const uint32_t           w_offset,
+                             const uint32_t           E,
+                             const uint32_t           F,
+                             const srsran_basegraph_t bg,
+                             const uint32_t           ls,
+                             const uint8_t            rv,
+                             const srsran_mod_t       mod_type,
+                             const uint32_t           Nref)
+{
+  if (input == NULL || output == NULL || w_offset > 7) {
+    return -1;
+  }
+
+  if (init_rm(q, E, F, bg, ls, rv, mod_type, Nref) != 0) {
+    return -1;
+  }
+
+  // Filler bits within the circular buffer
+  uint32_t end_exclude = SRSRAN_MIN(q->K - 2 * q->ls, q->Ncb);
+  uint32_t ini_exclude = SRSRAN_MIN(q->K - 2 * q->ls - q->F, q->Ncb);
+  uint32_t nof_filler  = end_exclude - ini_exclude;
+  uint32_t Lcb         = q->Ncb - nof_filler;
+  if (Lcb == 0) {
+    ERROR("The circular buffer only contains filler bits");
+    return -1;
+  }
+
+  // Position of k0 in the circular buffer once the filler bits are removed
+  uint32_t k0 = q->k0;
+  if (k0 >= end_exclude) {
+    k0 -= nof_filler;
+  } else if (k0 > ini_exclude) {
+    k0 = ini_exclude;
+  }
+  k0 %= Lcb;
+
+  // The bit interleaver writes the selected bits in mod_order rows. Each row is a run of E / mod_order consecutive
+  // bits of the circular buffer, so every row gets its own reader and the symbols are assembled row by row
+  uint32_t       rows = q->mod_order;
+  uint32_t       cols = q->E / rows;
+  rm_tx_reader_t readers[8];
+  for (uint32_t i = 0; i < rows; i++) {
+    rm_tx_reader_init(&readers[i], input, (k0 + i * cols) % Lcb, ini_exclude, end_exclude, q->Ncb);
+  }
+
+  ldpc_packed_writer_t writer;
+  ldpc_packed_writer_init(&writer, output, w_offset);
+
+  for (uint32_t j = 0; j < cols; j += 8) {
+    uint32_t n = SRSRAN_MIN(8, cols - j);
+
+    if (rows == 1) { // interleaver can be skipped
+      ldpc_packed_writer_put(&writer, rm_tx_reader_get(&readers[0], n), n);
+      continue;
+    }
+
+    // Byte k of spread holds the bits of the symbol j + k
+    uint64_t spread = 0;
+    for (uint32_t i = 0; i < rows; i++) {
+      spread |= rm_tx_spread(rm_tx_reader_get(&readers[i], n) << (8 - n)) << (rows - 1 - i);
+    }
+
+    uint64_t symbols = 0;
+    for (uint32_t k = 0; k < n; k++) {
+      symbols = (symbols << rows) | ((spread >> (8 * k)) & 0xffU);
+    }
+    ldpc_packed_writer_put_msb(&writer, symbols << (64 - n * rows), n * rows);
+  }
+
+  ldpc_packed_writer_flush(&writer);
+
+  return 0;
+}
+
 int srsran_ldpc_rm_rx_f(srsran_ldpc_rm_t*        q,
                         const float*             input,
                         float*                   output,
@@ -26,13 +26,164 @@
 #include <strings.h>
 
 #include "srsran/phy/common/phy_common.h"
+#include "srsran/phy/fec/cbsegm.h"
 #include "srsran/phy/fec/softbuffer.h"
 #include "srsran/phy/fec/turbo/turbodecoder_gen.h"
 #include "srsran/phy/phch/ra.h"
+#include "srsran/phy/utils/simd.h"
 #include "srsran/phy/utils/vector.h"
 
 #define MAX_PDSCH_RE(cp) (2 * SRSRAN_CP_NSYMB(cp) * 12)
 
+// Soft bits and decoded data are kept in the same slot, both aligned to the SIMD boundary
+#define SOFTBUFFER_POOL_ALIGN_BYTES (SRSRAN_SIMD_BIT_ALIGN / 8)
+#define SOFTBUFFER_POOL_ALIGN(x)                                                                                       \
+  ((((x) + SOFTBUFFER_POOL_ALIGN_BYTES - 1) / SOFTBUFFER_POOL_ALIGN_BYTES) * SOFTBUFFER_POOL_ALIGN_BYTES)
+
+static int softbuffer_pool_grow(srsran_softbuffer_pool_t* pool)
+{
+  if (pool->nof_slots >= pool->max_slots) {
+    return SRSRAN_ERROR;
+  }
+
+  uint32_t nof_new_slots = SRSRAN_MIN(pool->slots_per_chunk, pool->max_slots - pool->nof_slots);
+  uint8_t* chunk         = srsran_vec_u8_malloc(nof_new_slots * pool->slot_size);
+  if (chunk == NULL) {
+    perror("malloc");
+    return SRSRAN_ERROR;
+  }
+
+  // The number of chunks is bounded by max_slots / slots_per_chunk, rounded up
+  uint32_t chunk_idx      = (pool->nof_slots + pool->slots_per_chunk - 1) / pool->slots_per_chunk;
+  pool->chunks[chunk_idx] = chunk;
+  for (uint32_t i = 0; i < nof_new_slots; i++) {
+    pool->free_slots[pool->nof_free++] = &chunk[i * pool->slot_size];
+  }
+  pool->nof_slots += nof_new_slots;
+
+  return SRSRAN_SUCCESS;
+}
+
+int srsran_softbuffer_pool_init(srsran_softbuffer_pool_t* pool,
+                                uint32_t                  max_cb_size,
+                                bool                      llr_8bit,
+                                uint32_t                  slots_per_chunk,
+                                uint32_t                  max_slots,
+                                uint32_t                  init_slots)
+{
+  if (pool == NULL || max_cb_size == 0 || slots_per_chunk == 0 || max_slots == 0) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  SRSRAN_MEM_ZERO(pool, srsran_softbuffer_pool_t, 1);
+
+  pool->max_cb_size     = max_cb_size;
+  pool->llr_8bit        = llr_8bit;
+  pool->slot_size       = SOFTBUFFER_POOL_ALIGN(max_cb_size * (llr_8bit ? sizeof(int8_t) : sizeof(int16_t))) +
+                    SOFTBUFFER_POOL_ALIGN(max_cb_size / 8);
+  pool->slots_per_chunk = slots_per_chunk;
+  pool->max_slots       = max_slots;
+
+  uint32_t max_chunks = (max_slots + slots_per_chunk - 1) / slots_per_chunk;
+  pool->chunks        = SRSRAN_MEM_ALLOC(uint8_t*, max_chunks);
+  pool->free_slots    = SRSRAN_MEM_ALLOC(uint8_t*, max_slots);
+  if (pool->chunks == NULL || pool->free_slots == NULL) {
+    perror("malloc");
+    srsran_softbuffer_pool_free(pool);
+    return SRSRAN_ERROR;
+  }
+  SRSRAN_MEM_ZERO(pool->chunks, uint8_t*, max_chunks);
+
+  if (pthread_mutex_init(&pool->mutex, NULL)) {
+    perror("pthread_mutex_init");
+    srsran_softbuffer_pool_free(pool);
+    return SRSRAN_ERROR;
+  }
+
+  while (pool->nof_slots < SRSRAN_MIN(init_slots, max_slots)) {
+    if (softbuffer_pool_grow(pool) < SRSRAN_SUCCESS) {
+      srsran_softbuffer_pool_free(pool);
+      return SRSRAN_ERROR;
+    }
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+void srsran_softbuffer_pool_free(srsran_softbuffer_pool_t* pool)
+{
+  if (pool == NULL) {
+    return;
+  }
+
+  if (pool->chunks) {
+    uint32_t max_chunks = (pool->max_slots + pool->slots_per_chunk - 1) / pool->slots_per_chunk;
+    for (uint32_t i = 0; i < max_chunks; i++) {
+      if (pool->chunks[i]) {
+        free(pool->chunks[i]);
+      }
+    }
+    free(pool->chunks);
+    pthread_mutex_destroy(&pool->mutex);
+  }
+  if (pool->free_slots) {
+    free(pool->free_slots);
+  }
+
+  SRSRAN_MEM_ZERO(pool, srsran_softbuffer_pool_t, 1);
+}
+
+void srsran_softbuffer_pool_get_stats(srsran_softbuffer_pool_t* pool, srsran_softbuffer_pool_stats_t* stats)
+{
+  if (pool == NULL || stats == NULL) {
+    return;
+  }
+
+  pthread_mutex_lock(&pool->mutex);
+  stats->nof_slots      = pool->nof_slots;
+  stats->max_slots      = pool->max_slots;
+  stats->nof_used       = pool->nof_slots - pool->nof_free;
+  stats->peak_used      = pool->peak_used;
+  stats->nof_alloc      = pool->nof_alloc;
+  stats->nof_alloc_fail = pool->nof_alloc_fail;
+  pthread_mutex_unlock(&pool->mutex);
+}
+
+// Makes the soft-buffer hold exactly nof_cb code block buffers from the pool. It returns the number it holds.
+static uint32_t softbuffer_rx_pool_resize(srsran_softbuffer_rx_t* q, uint32_t nof_cb)
+{
+  srsran_softbuffer_pool_t* pool = q->pool;
+
+  pthread_mutex_lock(&pool->mutex);
+
+  // Give back the code block buffers that are not needed
+  while (q->nof_cb > nof_cb) {
+    q->nof_cb--;
+    pool->free_slots[pool->nof_free++] = (uint8_t*)q->buffer_f[q->nof_cb];
+    q->buffer_f[q->nof_cb]             = NULL;
+    q->data[q->nof_cb]                 = NULL;
+  }
+
+  // Borrow the missing ones, growing the pool if it is exhausted
+  while (q->nof_cb < nof_cb) {
+    if (pool->nof_free == 0 && softbuffer_pool_grow(pool) < SRSRAN_SUCCESS) {
+      pool->nof_alloc_fail++;
+      break;
+    }
+    uint8_t* slot          = pool->free_slots[--pool->nof_free];
+    q->buffer_f[q->nof_cb] = (int16_t*)slot;
+    q->data[q->nof_cb]     = &slot[pool->slot_size - SOFTBUFFER_POOL_ALIGN(pool->max_cb_size / 8)];
+    q->nof_cb++;
+    pool->nof_alloc++;
+  }
+
+  pool->peak_used = SRSRAN_MAX(pool->peak_used, pool->nof_slots - pool->nof_free);
+
+  pthread_mutex_unlock(&pool->mutex);
+
+  return q->nof_cb;
+}
+
 int srsran_softbuffer_rx_init(srsran_softbuffer_rx_t* q, uint32_t nof_prb)
 {
   int ret = srsran_ra_tbs_from_idx(SRSRAN_RA_NOF_TBS_IDX - 1, nof_prb);
@@ -109,9 +260,54 @@ clean_exit:
   return ret;
 }
 
+int srsran_softbuffer_rx_init_pool(srsran_softbuffer_rx_t* q, srsran_softbuffer_pool_t* pool, uint32_t max_cb)
+{
+  // Protect pointers
+  if (!q || !pool) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  // Initialise object
+  SRSRAN_MEM_ZERO(q, srsran_softbuffer_rx_t, 1);
+
+  // Set internal attributes, the code block buffers are borrowed from the pool when needed
+  q->max_cb      = max_cb;
+  q->max_cb_size = pool->max_cb_size;
+  q->pool        = pool;
+  q->llr_8bit    = pool->llr_8bit;
+
+  q->buffer_f = SRSRAN_MEM_ALLOC(int16_t*, q->max_cb);
+  q->data     = SRSRAN_MEM_ALLOC(uint8_t*, q->max_cb);
+  q->cb_crc   = SRSRAN_MEM_ALLOC(bool, q->max_cb);
+  if (!q->buffer_f || !q->data || !q->cb_crc) {
+    perror("malloc");
+    srsran_softbuffer_rx_free(q);
+    return SRSRAN_ERROR;
+  }
+  SRSRAN_MEM_ZERO(q->buffer_f, int16_t*, q->max_cb);
+  SRSRAN_MEM_ZERO(q->data, uint8_t*, q->max_cb);
+  SRSRAN_MEM_ZERO(q->cb_crc, bool, q->max_cb);
+
+  return SRSRAN_SUCCESS;
+}
+
 void srsran_softbuffer_rx_free(srsran_softbuffer_rx_t* q)
 {
-  if (q) {
+  if (q && q->pool) {
+    if (q->buffer_f && q->data) {
+      softbuffer_rx_pool_resize(q, 0);
+    }
+    if (q->buffer_f) {
+      free(q->buffer_f);
+    }
+    if (q->data) {
+      free(q->data);
+    }
+    if (q->cb_crc) {
+      free(q->cb_crc);
+    }
+    SRSRAN_MEM_ZERO(q, srsran_softbuffer_rx_t, 1);
+  } else if (q) {
     if (q->buffer_f) {
       for (uint32_t i = 0; i < q->max_cb; i++) {
         if (q->buffer_f[i]) {
@@ -142,9 +338,21 @@ void srsran_softbuffer_rx_reset_tbs(srsran_softbuffer_rx_t* q, uint32_t tbs)
   srsran_softbuffer_rx_reset_cb(q, SRSRAN_MIN(nof_cb, q->max_cb));
 }
 
+void srsran_softbuffer_rx_reset_tbs_nr(srsran_softbuffer_rx_t* q, uint32_t tbs)
+{
+  // The base graph depends on the code rate, base graph 2 gives the most code blocks for a TBS
+  srsran_cbsegm_t cbsegm = {};
+  if (srsran_cbsegm_ldpc_bg2(&cbsegm, tbs) < SRSRAN_SUCCESS) {
+    srsran_softbuffer_rx_reset_cb(q, q->max_cb);
+    return;
+  }
+  srsran_softbuffer_rx_reset_cb(q, SRSRAN_MIN(cbsegm.C, q->max_cb));
+}
+
 void srsran_softbuffer_rx_reset(srsran_softbuffer_rx_t* q)
 {
-  srsran_softbuffer_rx_reset_cb(q, q->max_cb);
+  // Soft-buffers bound to a pool give back all their code block buffers
+  srsran_softbuffer_rx_reset_cb(q, q->pool ? 0 : q->max_cb);
 }
 
 void srsran_softbuffer_rx_reset_cb(srsran_softbuffer_rx_t* q, uint32_t nof_cb)
@@ -153,9 +361,16 @@ void srsran_softbuffer_rx_reset_cb(srsran_softbuffer_rx_t* q, uint32_t nof_cb)
     if (nof_cb > q->max_cb) {
       nof_cb = q->max_cb;
     }
+    if (q->pool) {
+      nof_cb = softbuffer_rx_pool_resize(q, nof_cb);
+    }
     for (uint32_t i = 0; i < nof_cb; i++) {
       if (q->buffer_f[i]) {
-        srsran_vec_i16_zero(q->buffer_f[i], q->max_cb_size);
+        if (q->llr_8bit) {
+          srsran_vec_i8_zero((int8_t*)q->buffer_f[i], q->max_cb_size);
+        } else {
+          srsran_vec_i16_zero(q->buffer_f[i], q->max_cb_size);
+        }
       }
       if (q->data[i]) {
         srsran_vec_u8_zero(q->data[i], q->max_cb_size / 8);
@@ -252,6 +467,7 @@ void srsran_softbuffer_tx_reset(srsran_softbuffer_tx_t* q)
 
 void srsran_softbuffer_tx_reset_cb(srsran_softbuffer_tx_t* q, uint32_t nof_cb)
 {
+  q->encoded_id = 0;
   if (q->buffer_b) {
     if (nof_cb > q->max_cb) {
       nof_cb = q->max_cb;
@@ -0,0 +1,206 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/phy/fec/softbuffer.h"
+#include "srsran/phy/fec/turbo/turbodecoder_gen.h"
+#include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/vector.h"
+#include "srsran/support/srsran_test.h"
+#include <getopt.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CB_SIZE 18600
+#define MAX_CB 13
+
+static uint32_t nof_softbuffers = 8;
+static uint32_t slots_per_chunk = 4;
+static uint32_t max_slots       = 16;
+
+static uint32_t nof_cb_from_tbs(uint32_t tbs)
+{
+  return SRSRAN_MIN((tbs + 24) / (SRSRAN_TCOD_MAX_LEN_CB - 24) + 1, MAX_CB);
+}
+
+static int test_pool(bool llr_8bit)
+{
+  srsran_softbuffer_pool_t       pool  = {};
+  srsran_softbuffer_pool_stats_t stats = {};
+  srsran_softbuffer_rx_t         softbuffers[nof_softbuffers];
+
+  TESTASSERT(srsran_softbuffer_pool_init(&pool, CB_SIZE, llr_8bit, slots_per_chunk, max_slots, 0) == SRSRAN_SUCCESS);
+  for (uint32_t i = 0; i < nof_softbuffers; i++) {
+    TESTASSERT(srsran_softbuffer_rx_init_pool(&softbuffers[i], &pool, MAX_CB) == SRSRAN_SUCCESS);
+  }
+
+  // No code block buffer is allocated before a transport block is received
+  srsran_softbuffer_pool_get_stats(&pool, &stats);
+  TESTASSERT(stats.nof_slots == 0);
+  TESTASSERT(softbuffers[0].buffer_f[0] == NULL);
+
+  // A small transport block only takes one code block buffer and the pool grows one chunk
+  srsran_softbuffer_rx_reset_tbs(&softbuffers[0], 1000);
+  TESTASSERT(softbuffers[0].nof_cb == 1);
+  TESTASSERT(softbuffers[0].buffer_f[0] != NULL && softbuffers[0].buffer_f[1] == NULL);
+  srsran_softbuffer_pool_get_stats(&pool, &stats);
+  TESTASSERT(stats.nof_slots == slots_per_chunk);
+  TESTASSERT(stats.nof_used == 1);
+
+  // The soft bits are cleared and can be written over the whole code block
+  if (llr_8bit) {
+    int8_t* llr = (int8_t*)softbuffers[0].buffer_f[0];
+    for (uint32_t i = 0; i < CB_SIZE; i++) {
+      TESTASSERT(llr[i] == 0);
+    }
+    memset(llr, 0x7f, CB_SIZE);
+  } else {
+    for (uint32_t i = 0; i < CB_SIZE; i++) {
+      TESTASSERT(softbuffers[0].buffer_f[0][i] == 0);
+    }
+    memset(softbuffers[0].buffer_f[0], 0x7f, CB_SIZE * sizeof(int16_t));
+  }
+  memset(softbuffers[0].data[0], 0xff, CB_SIZE / 8);
+
+  // A larger transport block reuses the code block buffers it already holds
+  uint32_t nof_cb = nof_cb_from_tbs(30000);
+  srsran_softbuffer_rx_reset_tbs(&softbuffers[0], 30000);
+  TESTASSERT(softbuffers[0].nof_cb == nof_cb);
+  srsran_softbuffer_pool_get_stats(&pool, &stats);
+  TESTASSERT(stats.nof_used == nof_cb);
+  TESTASSERT(stats.peak_used == nof_cb);
+
+  // Exhaust the pool
+  for (uint32_t i = 1; i < nof_softbuffers; i++) {
+    srsran_softbuffer_rx_reset_tbs(&softbuffers[i], 30000);
+  }
+  srsran_softbuffer_pool_get_stats(&pool, &stats);
+  TESTASSERT(stats.nof_slots == max_slots);
+  TESTASSERT(stats.nof_used == max_slots);
+  TESTASSERT(stats.nof_alloc_fail > 0);
+  TESTASSERT(softbuffers[nof_softbuffers - 1].nof_cb < nof_cb);
+  TESTASSERT(softbuffers[nof_softbuffers - 1].buffer_f[nof_cb - 1] == NULL);
+
+  // Resetting gives all code block buffers back to the pool
+  for (uint32_t i = 0; i < nof_softbuffers; i++) {
+    srsran_softbuffer_rx_reset(&softbuffers[i]);
+    TESTASSERT(softbuffers[i].nof_cb == 0);
+  }
+  srsran_softbuffer_pool_get_stats(&pool, &stats);
+  TESTASSERT(stats.nof_used == 0);
+  TESTASSERT(stats.peak_used == max_slots);
+
+  // Freed soft-buffers also give back their code block buffers
+  srsran_softbuffer_rx_reset_cb(&softbuffers[0], 2);
+  srsran_softbuffer_rx_free(&softbuffers[0]);
+  srsran_softbuffer_pool_get_stats(&pool, &stats);
+  TESTASSERT(stats.nof_used == 0);
+
+  for (uint32_t i = 1; i < nof_softbuffers; i++) {
+    srsran_softbuffer_rx_free(&softbuffers[i]);
+  }
+  srsran_softbuffer_pool_free(&pool);
+
+  return SRSRAN_SUCCESS;
+}
+
+static int test_pool_nr()
+{
+  srsran_softbuffer_pool_t       pool       = {};
+  srsran_softbuffer_pool_stats_t stats      = {};
+  srsran_softbuffer_rx_t         softbuffer = {};
+  uint32_t                       max_cb     = 16;
+
+  TESTASSERT(srsran_softbuffer_pool_init(&pool, CB_SIZE, false, slots_per_chunk, max_cb, 0) == SRSRAN_SUCCESS);
+  TESTASSERT(srsran_softbuffer_rx_init_pool(&softbuffer, &pool, max_cb) == SRSRAN_SUCCESS);
+
+  // LDPC base graph 2 segments a 20000 bit transport block in 6 code blocks, more than the turbo segmentation
+  srsran_softbuffer_rx_reset_tbs_nr(&softbuffer, 20000);
+  TESTASSERT(softbuffer.nof_cb == 6);
+  for (uint32_t i = 0; i < softbuffer.nof_cb; i++) {
+    TESTASSERT(softbuffer.buffer_f[i] != NULL);
+  }
+  srsran_softbuffer_pool_get_stats(&pool, &stats);
+  TESTASSERT(stats.nof_used == 6);
+
+  // A transport block that fits in one code block gives back the others
+  srsran_softbuffer_rx_reset_tbs_nr(&softbuffer, 3000);
+  TESTASSERT(softbuffer.nof_cb == 1);
+  srsran_softbuffer_pool_get_stats(&pool, &stats);
+  TESTASSERT(stats.nof_used == 1);
+
+  srsran_softbuffer_rx_free(&softbuffer);
+  srsran_softbuffer_pool_free(&pool);
+
+  return SRSRAN_SUCCESS;
+}
+
+static void usage(char* prog)
+{
+  printf("Usage: %s [nmcv]\n", prog);
+  printf("\t-n Number of soft-buffers [default %d]\n", nof_softbuffers);
+  printf("\t-m Maximum number of code blocks in the pool [default %d]\n", max_slots);
+  printf("\t-c Number of code blocks per chunk [default %d]\n", slots_per_chunk);
+  printf("\t-v Increase verbose [default none]\n");
+}
+
+static void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "nmcv")) != -1) {
+    switch (opt) {
+      case 'n':
+        nof_softbuffers = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'm':
+        max_slots = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'c':
+        slots_per_chunk = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'v':
+        increase_srsran_verbose_level();
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+
+  if (test_pool(false) < SRSRAN_SUCCESS) {
+    return SRSRAN_ERROR;
+  }
+
+  if (test_pool(true) < SRSRAN_SUCCESS) {
+    return SRSRAN_ERROR;
+  }
+
+  if (test_pool_nr() < SRSRAN_SUCCESS) {
+    return SRSRAN_ERROR;
+  }
+
+  printf("Ok\n");
+  return SRSRAN_SUCCESS;
+}
@@ -19,6 +19,7 @@
  *
  */
 
+#include <pthread.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -44,33 +45,42 @@ static tcod_lut_t               tcod_lut[8][256];
 static uint16_t                 tcod_per_fw[188][6144];
 static srsran_bit_interleaver_t tcod_interleavers[188];
 
-static bool table_initiated = false;
+// The tables are shared by every encoder, they are generated by the first one and freed by the last one
+static pthread_mutex_t tcod_tables_mutex    = PTHREAD_MUTEX_INITIALIZER;
+static uint32_t        tcod_tables_refcount = 0;
 
 int srsran_tcod_init(srsran_tcod_t* h, uint32_t max_long_cb)
 {
   h->max_long_cb = max_long_cb;
   h->temp        = srsran_vec_malloc(max_long_cb / 8);
+  if (!h->temp) {
+    return -1;
+  }
 
-  if (!table_initiated) {
-    table_initiated = true;
+  pthread_mutex_lock(&tcod_tables_mutex);
+  if (tcod_tables_refcount++ == 0) {
     srsran_tcod_gentable();
   }
+  pthread_mutex_unlock(&tcod_tables_mutex);
   return 0;
 }
 
 void srsran_tcod_free(srsran_tcod_t* h)
 {
   h->max_long_cb = 0;
-  if (h->temp) {
-    free(h->temp);
+  if (!h->temp) {
+    return;
   }
+  free(h->temp);
+  h->temp = NULL;
 
-  if (table_initiated) {
+  pthread_mutex_lock(&tcod_tables_mutex);
+  if (tcod_tables_refcount > 0 && --tcod_tables_refcount == 0) {
     for (int i = 0; i < 188; i++) {
       srsran_bit_interleaver_free(&tcod_interleavers[i]);
     }
-    table_initiated = false;
   }
+  pthread_mutex_unlock(&tcod_tables_mutex);
 }
 
 /* Expects bits (1 byte = 1 bit) and produces bits. The systematic and parity bits are interlaced in the output */
@@ -93,19 +93,69 @@ void srsran_pcfich_free(srsran_pcfich_t* q)
   bzero(q, sizeof(srsran_pcfich_t));
 }
 
+/** Encodes the CFI producing a vector of 32 bits.
+ *  36.211 10.3 section 5.3.4
+ */
+int srsran_pcfich_cfi_encode(uint32_t cfi, uint8_t bits[PCFICH_CFI_LEN])
+{
+  if (cfi < 1 || cfi > 3) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  } else {
+    memcpy(bits, cfi_table[cfi - 1], PCFICH_CFI_LEN * sizeof(uint8_t));
+    return SRSRAN_SUCCESS;
+  }
+}
+
+/* The PCFICH only carries the CFI, so its symbols for every CFI and subframe are scrambled, modulated and precoded
+ * once and each subframe only maps them to the resource grid.
+ */
+static void pcfich_tx_symbols_init(srsran_pcfich_t* q)
+{
+  cf_t* x[SRSRAN_MAX_LAYERS] = {};
+  for (int i = 0; i < q->cell.nof_ports; i++) {
+    x[i] = q->x[i];
+  }
+
+  for (uint32_t cfi = 1; cfi <= SRSRAN_NOF_CFI; cfi++) {
+    for (uint32_t nsf = 0; nsf < SRSRAN_NOF_SF_X_FRAME; nsf++) {
+      cf_t* q_symbols[SRSRAN_MAX_PORTS];
+      for (int i = 0; i < SRSRAN_MAX_PORTS; i++) {
+        q_symbols[i] = q->tx_symbols[SRSRAN_CFI_IDX(cfi)][nsf][i];
+      }
+
+      /* pack CFI */
+      srsran_pcfich_cfi_encode(cfi, q->data);
+
+      /* scramble for slot sequence nslot */
+      srsran_scrambling_b(&q->seq[nsf], q->data);
+
+      srsran_mod_modulate(&q->mod, q->data, q->d, PCFICH_CFI_LEN);
+
+      /* layer mapping & precoding */
+      if (q->cell.nof_ports > 1) {
+        srsran_layermap_diversity(q->d, x, q->cell.nof_ports, q->nof_symbols);
+        srsran_precoding_diversity(x, q_symbols, q->cell.nof_ports, q->nof_symbols / q->cell.nof_ports, 1.0f);
+      } else {
+        memcpy(q_symbols[0], q->d, q->nof_symbols * sizeof(cf_t));
+      }
+    }
+  }
+}
+
 int srsran_pcfich_set_cell(srsran_pcfich_t* q, srsran_regs_t* regs, srsran_cell_t cell)
 {
   int ret = SRSRAN_ERROR_INVALID_INPUTS;
 
   if (q != NULL && regs != NULL && srsran_cell_isvalid(&cell)) {
     q->regs = regs;
-    if (cell.id != q->cell.id || q->cell.nof_prb == 0) {
+    if (cell.id != q->cell.id || cell.nof_ports != q->cell.nof_ports || q->cell.nof_prb == 0) {
       q->cell = cell;
       for (int nsf = 0; nsf < SRSRAN_NOF_SF_X_FRAME; nsf++) {
         if (srsran_sequence_pcfich(&q->seq[nsf], 2 * nsf, q->cell.id)) {
           return SRSRAN_ERROR;
         }
       }
+      pcfich_tx_symbols_init(q);
     }
     ret = SRSRAN_SUCCESS;
   }
@@ -136,19 +186,6 @@ float srsran_pcfich_cfi_decode(srsran_pcfich_t* q, uint32_t* cfi)
   return max_corr;
 }
 
-/** Encodes the CFI producing a vector of 32 bits.
- *  36.211 10.3 section 5.3.4
- */
-int srsran_pcfich_cfi_encode(uint32_t cfi, uint8_t bits[PCFICH_CFI_LEN])
-{
-  if (cfi < 1 || cfi > 3) {
-    return SRSRAN_ERROR_INVALID_INPUTS;
-  } else {
-    memcpy(bits, cfi_table[cfi - 1], PCFICH_CFI_LEN * sizeof(uint8_t));
-    return SRSRAN_SUCCESS;
-  }
-}
-
 /* Decodes the PCFICH channel and saves the CFI in the cfi pointer.
  *
  * Returns 1 if successfully decoded the CFI, 0 if not and -1 on error
@@ -225,42 +262,12 @@ int srsran_pcfich_decode(srsran_pcfich_t*       q,
  */
 int srsran_pcfich_encode(srsran_pcfich_t* q, srsran_dl_sf_cfg_t* sf, cf_t* slot_symbols[SRSRAN_MAX_PORTS])
 {
-  int i;
-
-  if (q != NULL && slot_symbols != NULL) {
-    uint32_t sf_idx = sf->tti % 10;
-
-    /* Set pointers for layermapping & precoding */
-    cf_t* x[SRSRAN_MAX_LAYERS];
-    cf_t* q_symbols[SRSRAN_MAX_PORTS];
-
-    /* number of layers equals number of ports */
-    for (i = 0; i < q->cell.nof_ports; i++) {
-      x[i] = q->x[i];
-    }
-    for (i = 0; i < SRSRAN_MAX_PORTS; i++) {
-      q_symbols[i] = q->symbols[i];
-    }
-
-    /* pack CFI */
-    srsran_pcfich_cfi_encode(sf->cfi, q->data);
-
-    /* scramble for slot sequence nslot */
-    srsran_scrambling_b(&q->seq[sf_idx], q->data);
-
-    srsran_mod_modulate(&q->mod, q->data, q->d, PCFICH_CFI_LEN);
-
-    /* layer mapping & precoding */
-    if (q->cell.nof_ports > 1) {
-      srsran_layermap_diversity(q->d, x, q->cell.nof_ports, q->nof_symbols);
-      srsran_precoding_diversity(x, q_symbols, q->cell.nof_ports, q->nof_symbols / q->cell.nof_ports, 1.0f);
-    } else {
-      memcpy(q->symbols[0], q->d, q->nof_symbols * sizeof(cf_t));
-    }
+  if (q != NULL && slot_symbols != NULL && SRSRAN_CFI_ISVALID(sf->cfi)) {
+    uint32_t sf_idx = sf->tti % SRSRAN_NOF_SF_X_FRAME;
 
-    /* mapping to resource elements */
-    for (i = 0; i < q->cell.nof_ports; i++) {
-      if (srsran_regs_pcfich_put(q->regs, q->symbols[i], slot_symbols[i]) < 0) {
+    /* mapping of the symbols precoded for this CFI and subframe to resource elements */
+    for (int i = 0; i < q->cell.nof_ports; i++) {
+      if (srsran_regs_pcfich_put(q->regs, q->tx_symbols[SRSRAN_CFI_IDX(sf->cfi)][sf_idx][i], slot_symbols[i]) < 0) {
         ERROR("Error putting PCHICH resource elements");
         return SRSRAN_ERROR;
       }
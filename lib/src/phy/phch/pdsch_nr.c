@@ -62,9 +62,8 @@ int pdsch_nr_init_common(srsran_pdsch_nr_t* q, const srsran_pdsch_nr_args_t* arg
       ERROR("Error initialising modem table for %s", srsran_mod_string(mod));
       return SRSRAN_ERROR;
     }
-    if (args->measure_evm) {
-      srsran_modem_table_bytes(&q->modem_tables[mod]);
-    }
+    // The encoder modulates packed bits and the EVM measurement uses the same tables
+    srsran_modem_table_bytes(&q->modem_tables[mod]);
   }
 
   if (pdsch_nr_alloc(q, args->max_layers, args->max_prb) < SRSRAN_SUCCESS) {
@@ -324,23 +323,23 @@ static inline int pdsch_nr_encode_codeword(srsran_pdsch_nr_t*         q,
     return SRSRAN_ERROR_OUT_OF_BOUNDS;
   }
 
-  // Encode SCH
-  if (srsran_dlsch_nr_encode(&q->sch, &cfg->sch_cfg, tb, data, q->b[tb->cw_idx]) < SRSRAN_SUCCESS) {
+  // Encode SCH, the codeword is kept packed through scrambling and modulation
+  if (srsran_dlsch_nr_encode_packed(&q->sch, &cfg->sch_cfg, tb, data, q->b[tb->cw_idx]) < SRSRAN_SUCCESS) {
     ERROR("Error in DL-SCH encoding");
     return SRSRAN_ERROR;
   }
 
   if (SRSRAN_DEBUG_ENABLED && get_srsran_verbose_level() >= SRSRAN_VERBOSE_DEBUG && !is_handler_registered()) {
     DEBUG("b=");
-    srsran_vec_fprint_b(stdout, q->b[tb->cw_idx], tb->nof_bits);
+    srsran_vec_fprint_byte(stdout, q->b[tb->cw_idx], SRSRAN_CEIL(tb->nof_bits, 8));
   }
 
   // 7.3.1.1 Scrambling
   uint32_t cinit = pdsch_nr_cinit(&q->carrier, cfg, rnti, tb->cw_idx);
-  srsran_sequence_apply_bit(q->b[tb->cw_idx], q->b[tb->cw_idx], tb->nof_bits, cinit);
+  srsran_sequence_apply_packed(q->b[tb->cw_idx], q->b[tb->cw_idx], tb->nof_bits, cinit);
 
   // 7.3.1.2 Modulation
-  srsran_mod_modulate(&q->modem_tables[tb->mod], q->b[tb->cw_idx], q->d[tb->cw_idx], tb->nof_bits);
+  srsran_mod_modulate_bytes(&q->modem_tables[tb->mod], q->b[tb->cw_idx], q->d[tb->cw_idx], tb->nof_bits);
 
   if (SRSRAN_DEBUG_ENABLED && get_srsran_verbose_level() >= SRSRAN_VERBOSE_DEBUG && !is_handler_registered()) {
     DEBUG("d=");
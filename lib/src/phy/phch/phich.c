@@ -107,6 +107,49 @@ void srsran_phich_set_regs(srsran_phich_t* q, srsran_regs_t* regs)
   q->regs = regs;
 }
 
+/** Encodes the ACK
+ *  36.212
+ */
+void srsran_phich_ack_encode(uint8_t ack, uint8_t bits[SRSRAN_PHICH_NBITS])
+{
+  memset(bits, ack, 3 * sizeof(uint8_t));
+}
+
+/* The PHICH only carries one bit per orthogonal sequence, so its symbols up to the layer mapping are computed once
+ * for every subframe, ACK value and sequence.
+ */
+static void phich_tx_d_init(srsran_phich_t* q)
+{
+  uint32_t nof_seq = SRSRAN_CP_ISEXT(q->cell.cp) ? SRSRAN_PHICH_EXT_NSEQUENCES : SRSRAN_PHICH_NORM_NSEQUENCES;
+
+  srsran_vec_cf_zero(&q->tx_d[0][0][0][0], sizeof(q->tx_d) / sizeof(cf_t));
+  for (uint32_t nsf = 0; nsf < SRSRAN_NOF_SF_X_FRAME; nsf++) {
+    for (uint32_t ack = 0; ack < 2; ack++) {
+      /* encode ACK/NACK bit */
+      srsran_phich_ack_encode(ack, q->data);
+
+      srsran_mod_modulate(&q->mod, q->data, q->z, SRSRAN_PHICH_NBITS);
+
+      for (uint32_t nseq = 0; nseq < nof_seq; nseq++) {
+        cf_t* d = q->tx_d[nsf][ack][nseq];
+
+        /* Spread with w */
+        if (SRSRAN_CP_ISEXT(q->cell.cp)) {
+          for (int i = 0; i < SRSRAN_PHICH_EXT_MSYMB; i++) {
+            d[i] = w_ext[nseq][i % SRSRAN_PHICH_EXT_NSF] * q->z[i / SRSRAN_PHICH_EXT_NSF];
+          }
+        } else {
+          for (int i = 0; i < SRSRAN_PHICH_NORM_MSYMB; i++) {
+            d[i] = w_normal[nseq][i % SRSRAN_PHICH_NORM_NSF] * q->z[i / SRSRAN_PHICH_NORM_NSF];
+          }
+        }
+
+        srsran_scrambling_c(&q->seq[nsf], d);
+      }
+    }
+  }
+}
+
 int srsran_phich_set_cell(srsran_phich_t* q, srsran_regs_t* regs, srsran_cell_t cell)
 {
   int ret = SRSRAN_ERROR_INVALID_INPUTS;
@@ -114,13 +157,14 @@ int srsran_phich_set_cell(srsran_phich_t* q, srsran_regs_t* regs, srsran_cell_t
   if (q != NULL && regs != NULL && srsran_cell_isvalid(&cell)) {
     q->regs = regs;
 
-    if (cell.id != q->cell.id || q->cell.nof_prb == 0) {
+    if (cell.id != q->cell.id || cell.cp != q->cell.cp || q->cell.nof_prb == 0) {
       q->cell = cell;
       for (int nsf = 0; nsf < SRSRAN_NOF_SF_X_FRAME; nsf++) {
         if (srsran_sequence_phich(&q->seq[nsf], 2 * nsf, q->cell.id)) {
           return SRSRAN_ERROR;
         }
       }
+      phich_tx_d_init(q);
     }
     ret = SRSRAN_SUCCESS;
   }
@@ -170,14 +214,6 @@ uint8_t srsran_phich_ack_decode(float bits[SRSRAN_PHICH_NBITS], float* distance)
   return index;
 }
 
-/** Encodes the ACK
- *  36.212
- */
-void srsran_phich_ack_encode(uint8_t ack, uint8_t bits[SRSRAN_PHICH_NBITS])
-{
-  memset(bits, ack, 3 * sizeof(uint8_t));
-}
-
 int srsran_phich_decode(srsran_phich_t*         q,
                         srsran_dl_sf_cfg_t*     sf,
                         srsran_chest_dl_res_t*  channel,
@@ -351,32 +387,13 @@ int srsran_phich_encode(srsran_phich_t*         q,
     symbols_precoding[i] = q->sf_symbols[i];
   }
 
-  /* encode ACK/NACK bit */
-  srsran_phich_ack_encode(ack, q->data);
-
-  srsran_mod_modulate(&q->mod, q->data, q->z, SRSRAN_PHICH_NBITS);
-
-  DEBUG("data: ");
-  if (SRSRAN_VERBOSE_ISDEBUG())
-    srsran_vec_fprint_c(stdout, q->z, SRSRAN_PHICH_NBITS);
-
-  /* Spread with w */
-  if (SRSRAN_CP_ISEXT(q->cell.cp)) {
-    for (i = 0; i < SRSRAN_PHICH_EXT_MSYMB; i++) {
-      q->d[i] = w_ext[n_phich.nseq][i % SRSRAN_PHICH_EXT_NSF] * q->z[i / SRSRAN_PHICH_EXT_NSF];
-    }
-  } else {
-    for (i = 0; i < SRSRAN_PHICH_NORM_MSYMB; i++) {
-      q->d[i] = w_normal[n_phich.nseq][i % SRSRAN_PHICH_NORM_NSF] * q->z[i / SRSRAN_PHICH_NORM_NSF];
-    }
-  }
+  /* encoded, spread and scrambled ACK/NACK, computed when the cell was set */
+  srsran_vec_cf_copy(q->d, q->tx_d[sf_idx][ack ? 1 : 0][n_phich.nseq], SRSRAN_PHICH_MAX_NSYMB);
 
   DEBUG("d: ");
   if (SRSRAN_VERBOSE_ISDEBUG())
     srsran_vec_fprint_c(stdout, q->d, SRSRAN_PHICH_EXT_MSYMB);
 
-  srsran_scrambling_c(&q->seq[sf_idx], q->d);
-
   /* align to REG */
   if (SRSRAN_CP_ISEXT(q->cell.cp)) {
     if (n_phich.ngroup % 2) {
@@ -38,6 +38,8 @@ int srsran_pssch_init(srsran_pssch_t*                       q,
     return SRSRAN_ERROR_INVALID_INPUTS;
   }
 
+  q->rm_tables_ref = false;
+
   q->cell                  = *cell;
   q->sl_comm_resource_pool = *sl_comm_resource_pool;
 
@@ -138,6 +140,7 @@ int srsran_pssch_init(srsran_pssch_t*                       q,
     return SRSRAN_ERROR;
   }
   srsran_rm_turbo_gentables();
+  q->rm_tables_ref = true;
 
   // Code Block Concatenation
   q->f = srsran_vec_u8_malloc(SRSRAN_MAX_CODEWORD_LEN);
@@ -592,7 +595,9 @@ void srsran_pssch_free(srsran_pssch_t* q)
     srsran_tcod_free(&q->tcod);
     srsran_tdec_free(&q->tdec);
     srsran_sequence_free(&q->scrambling_seq);
-    srsran_rm_turbo_free_tables();
+    if (q->rm_tables_ref) {
+      srsran_rm_turbo_free_tables();
+    }
 
     for (int i = 0; i < SRSRAN_MOD_NITEMS; i++) {
       srsran_modem_table_free(&q->mod[i]);
@@ -29,6 +29,10 @@
 #include <string.h>
 #include <strings.h>
 
+#ifdef LV_HAVE_SSE
+#include <immintrin.h>
+#endif /* LV_HAVE_SSE */
+
 #include "srsran/phy/ch_estimation/refsignal_ul.h"
 #include "srsran/phy/common/phy_common.h"
 #include "srsran/phy/dft/dft_precoding.h"
@@ -254,6 +258,42 @@ int srsran_pusch_assert_grant(const srsran_pusch_grant_t* grant)
   return SRSRAN_SUCCESS;
 }
 
+void srsran_pusch_scrambling_gen(uint8_t* c_packed, uint16_t rnti, uint32_t sf_idx, uint32_t cell_id, uint32_t len)
+{
+  // Scrambling a vector of zeros gives the sequence bits
+  memset(c_packed, 0, SRSRAN_CEIL(len, 8));
+  srsran_sequence_pusch_apply_pack(c_packed, c_packed, rnti, 2 * sf_idx, cell_id, len);
+}
+
+void srsran_pusch_scrambling_unpack(const uint8_t* c_packed, int8_t* c_char, int16_t* c_short, uint32_t len)
+{
+  uint32_t i = 0;
+
+#ifdef LV_HAVE_SSE
+  for (; i + 16 <= len; i += 16) {
+    // Two packed bytes, the first one in the 8 lower lanes, most significant bit first
+    uint32_t bytes = (uint32_t)c_packed[i / 8] | ((uint32_t)c_packed[i / 8 + 1] << 8U);
+    __m128i  mask  = _mm_set1_epi32(bytes);
+    mask           = _mm_shuffle_epi8(mask, _mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1));
+    mask           = _mm_and_si128(mask, _mm_set1_epi64x(0x0102040810204080));
+    mask           = _mm_cmpeq_epi8(mask, _mm_set1_epi64x(0x0102040810204080));
+
+    // Set bits give -1 (all ones), clear bits give +1
+    _mm_storeu_si128((__m128i*)&c_char[i], _mm_or_si128(mask, _mm_set1_epi8(1)));
+  }
+#endif /* LV_HAVE_SSE */
+
+  for (; i < len; i++) {
+    c_char[i] = ((c_packed[i / 8] >> (7U - i % 8U)) & 1U) ? -1 : +1;
+  }
+
+  if (c_short != NULL) {
+    for (i = 0; i < len; i++) {
+      c_short[i] = c_char[i];
+    }
+  }
+}
+
 /** Converts the PUSCH data bits to symbols mapped to the slot ready for transmission
  */
 int srsran_pusch_encode(srsran_pusch_t*      q,
@@ -432,19 +472,31 @@ int srsran_pusch_decode(srsran_pusch_t*        q,
       out->evm = NAN;
     }
 
-    // Descrambling
-    if (q->llr_is_8bit) {
-      srsran_sequence_pusch_apply_c(
-          q->q, q->q, cfg->rnti, 2 * (sf->tti % SRSRAN_NOF_SF_X_FRAME), q->cell.id, cfg->grant.tb.nof_bits);
+    // Descrambling, with the pre-generated sequence if it covers the grant
+    const srsran_pusch_scrambling_t* seq = &cfg->scrambling;
+    uint8_t*                         c   = (uint8_t*)q->z; // Reuse Z
+    if (seq->len >= cfg->grant.tb.nof_bits && seq->c_char != NULL && (q->llr_is_8bit || seq->c_short != NULL)) {
+      if (q->llr_is_8bit) {
+        srsran_vec_neg_bbb(q->q, seq->c_char, q->q, cfg->grant.tb.nof_bits);
+      } else {
+        srsran_vec_neg_sss(q->q, seq->c_short, q->q, cfg->grant.tb.nof_bits);
+      }
+
+      // The UCI decoder only compares sequence bits, so it takes the +1/-1 sequence as it is
+      c = (uint8_t*)seq->c_char;
     } else {
-      srsran_sequence_pusch_apply_s(
-          q->q, q->q, cfg->rnti, 2 * (sf->tti % SRSRAN_NOF_SF_X_FRAME), q->cell.id, cfg->grant.tb.nof_bits);
-    }
+      if (q->llr_is_8bit) {
+        srsran_sequence_pusch_apply_c(
+            q->q, q->q, cfg->rnti, 2 * (sf->tti % SRSRAN_NOF_SF_X_FRAME), q->cell.id, cfg->grant.tb.nof_bits);
+      } else {
+        srsran_sequence_pusch_apply_s(
+            q->q, q->q, cfg->rnti, 2 * (sf->tti % SRSRAN_NOF_SF_X_FRAME), q->cell.id, cfg->grant.tb.nof_bits);
+      }
 
-    // Generate packed sequence for UCI decoder
-    uint8_t* c = (uint8_t*)q->z; // Reuse Z
-    srsran_sequence_pusch_gen_unpack(
-        c, cfg->rnti, 2 * (sf->tti % SRSRAN_NOF_SF_X_FRAME), q->cell.id, cfg->grant.tb.nof_bits);
+      // Generate unpacked sequence for UCI decoder
+      srsran_sequence_pusch_gen_unpack(
+          c, cfg->rnti, 2 * (sf->tti % SRSRAN_NOF_SF_X_FRAME), q->cell.id, cfg->grant.tb.nof_bits);
+    }
 
     // Set max number of iterations
     srsran_sch_set_max_noi(&q->ul_sch, cfg->max_nof_iterations);
@@ -454,7 +506,7 @@ int srsran_pusch_decode(srsran_pusch_t*        q,
     out->crc = (ret == 0);
 
     // Save number of iterations
-    out->avg_iterations_block = q->ul_sch.avg_iterations;
+    out->avg_iterations_block = cfg->uci_only ? 0.0f : q->ul_sch.avg_iterations;
 
     // Save O_cqi for power control
     cfg->last_O_cqi = srsran_cqi_size(&cfg->uci_cfg.cqi);
@@ -917,7 +917,7 @@ static inline int pusch_nr_decode_codeword(srsran_pusch_nr_t*         q,
   }
 
   // Decode Ul-SCH
-  if (nof_bits != 0) {
+  if (nof_bits != 0 && !cfg->uci_only) {
     if (srsran_ulsch_nr_decode(&q->sch, &cfg->sch_cfg, tb, llr, &res->tb[tb->cw_idx]) < SRSRAN_SUCCESS) {
       ERROR("Error in SCH decoding");
       return SRSRAN_ERROR;
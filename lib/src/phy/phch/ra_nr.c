@@ -21,6 +21,7 @@
 
 #include "srsran/phy/phch/ra_nr.h"
 #include "srsran/phy/ch_estimation/csi_rs.h"
+#include "srsran/phy/common/sliv.h"
 #include "srsran/phy/fec/cbsegm.h"
 #include "srsran/phy/phch/csi.h"
 #include "srsran/phy/phch/pdsch_nr.h"
@@ -361,14 +362,8 @@ static int ra_nr_dmrs_power_offset(srsran_sch_grant_nr_t* grant)
   return SRSRAN_SUCCESS;
 }
 
-double srsran_ra_nr_R_from_mcs(srsran_mcs_table_t         mcs_table,
-                               srsran_dci_format_nr_t     dci_format,
-                               srsran_search_space_type_t search_space_type,
-                               srsran_rnti_type_t         rnti_type,
-                               uint32_t                   mcs_idx)
+static double ra_nr_R_from_table(ra_nr_table_idx_t table, uint32_t mcs_idx)
 {
-  ra_nr_table_idx_t table = ra_nr_select_table(mcs_table, dci_format, search_space_type, rnti_type);
-
   switch (table) {
     case ra_nr_table_idx_1:
       return srsran_ra_nr_R_from_mcs_table1(mcs_idx) / 1024.0;
@@ -383,14 +378,8 @@ double srsran_ra_nr_R_from_mcs(srsran_mcs_table_t         mcs_table,
   return NAN;
 }
 
-srsran_mod_t srsran_ra_nr_mod_from_mcs(srsran_mcs_table_t         mcs_table,
-                                       srsran_dci_format_nr_t     dci_format,
-                                       srsran_search_space_type_t search_space_type,
-                                       srsran_rnti_type_t         rnti_type,
-                                       uint32_t                   mcs_idx)
+static srsran_mod_t ra_nr_mod_from_table(ra_nr_table_idx_t table, uint32_t mcs_idx)
 {
-  ra_nr_table_idx_t table = ra_nr_select_table(mcs_table, dci_format, search_space_type, rnti_type);
-
   switch (table) {
     case ra_nr_table_idx_1:
       return srsran_ra_nr_modulation_from_mcs_table1(mcs_idx);
@@ -405,21 +394,32 @@ srsran_mod_t srsran_ra_nr_mod_from_mcs(srsran_mcs_table_t         mcs_table,
   return SRSRAN_MOD_NITEMS;
 }
 
-int srsran_ra_dl_nr_slot_nof_re(const srsran_sch_cfg_nr_t* pdsch_cfg, const srsran_sch_grant_nr_t* grant)
+double srsran_ra_nr_R_from_mcs(srsran_mcs_table_t         mcs_table,
+                               srsran_dci_format_nr_t     dci_format,
+                               srsran_search_space_type_t search_space_type,
+                               srsran_rnti_type_t         rnti_type,
+                               uint32_t                   mcs_idx)
 {
-  // the number of symbols of the PDSCH allocation within the slot
-  int n_sh_symb = grant->L;
+  return ra_nr_R_from_table(ra_nr_select_table(mcs_table, dci_format, search_space_type, rnti_type), mcs_idx);
+}
 
-  // the number of REs for DM-RS per PRB in the scheduled duration
-  int n_prb_dmrs = srsran_dmrs_sch_get_N_prb(&pdsch_cfg->dmrs, grant);
-  if (n_prb_dmrs < SRSRAN_SUCCESS) {
-    ERROR("Invalid number of DMRS RE");
-    return SRSRAN_ERROR;
-  }
+srsran_mod_t srsran_ra_nr_mod_from_mcs(srsran_mcs_table_t         mcs_table,
+                                       srsran_dci_format_nr_t     dci_format,
+                                       srsran_search_space_type_t search_space_type,
+                                       srsran_rnti_type_t         rnti_type,
+                                       uint32_t                   mcs_idx)
+{
+  return ra_nr_mod_from_table(ra_nr_select_table(mcs_table, dci_format, search_space_type, rnti_type), mcs_idx);
+}
+
+static uint32_t ra_nr_nof_re_prb(uint32_t L, int n_prb_dmrs, srsran_xoverhead_t xoverhead)
+{
+  // the number of symbols of the PDSCH allocation within the slot
+  int n_sh_symb = (int)L;
 
   // the overhead configured by higher layer parameter xOverhead in PDSCH-ServingCellConfig
   uint32_t n_prb_oh = 0;
-  switch (pdsch_cfg->sch_cfg.xoverhead) {
+  switch (xoverhead) {
     case srsran_xoverhead_0:
       n_prb_oh = 0;
       break;
@@ -437,17 +437,41 @@ int srsran_ra_dl_nr_slot_nof_re(const srsran_sch_cfg_nr_t* pdsch_cfg, const srsr
   // Compute total number of n_re used for PDSCH
   uint32_t n_re_prime = SRSRAN_NRE * n_sh_symb - n_prb_dmrs - n_prb_oh;
 
+  return SRSRAN_MIN(SRSRAN_MAX_NRE_NR, n_re_prime);
+}
+
+static uint32_t ra_nr_nof_prb(const srsran_sch_grant_nr_t* grant)
+{
   uint32_t n_prb = 0;
   for (uint32_t i = 0; i < SRSRAN_MAX_PRB_NR; i++) {
     n_prb += (uint32_t)grant->prb_idx[i];
   }
+  return n_prb;
+}
+
+int srsran_ra_dl_nr_slot_nof_re(const srsran_sch_cfg_nr_t* pdsch_cfg, const srsran_sch_grant_nr_t* grant)
+{
+  // the number of REs for DM-RS per PRB in the scheduled duration
+  int n_prb_dmrs = srsran_dmrs_sch_get_N_prb(&pdsch_cfg->dmrs, grant);
+  if (n_prb_dmrs < SRSRAN_SUCCESS) {
+    ERROR("Invalid number of DMRS RE");
+    return SRSRAN_ERROR;
+  }
 
   // Return the number of resource elements for PDSCH
-  return SRSRAN_MIN(SRSRAN_MAX_NRE_NR, n_re_prime) * n_prb;
+  return ra_nr_nof_re_prb(grant->L, n_prb_dmrs, pdsch_cfg->sch_cfg.xoverhead) * ra_nr_nof_prb(grant);
 }
 
 #define POW2(N) (1U << (N))
 
+/**
+ * @brief TBS of every intermediate number of information bits N_info <= 3824, TS 38.214 5.1.3.2 step 3. The MCS
+ * table, MCS, number of PRB and symbols, DMRS, xOverhead and layers of a grant only reach the TBS through N_info, so
+ * this table serves the scheduler and the PHY for any cell configuration
+ */
+#define RA_NR_TBS_N_INFO3_MAX 3824
+static uint16_t ra_nr_tbs_n_info3_lut[RA_NR_TBS_N_INFO3_MAX + 1];
+
 static uint32_t ra_nr_tbs_from_n_info3(uint32_t n_info)
 {
   // quantized intermediate number of information bits
@@ -464,10 +488,17 @@ static uint32_t ra_nr_tbs_from_n_info3(uint32_t n_info)
   return ra_nr_tbs_table[RA_NR_TBS_SIZE_TABLE - 1];
 }
 
+__attribute__((constructor)) static void ra_nr_tbs_lut_init()
+{
+  for (uint32_t n_info = 0; n_info <= RA_NR_TBS_N_INFO3_MAX; n_info++) {
+    ra_nr_tbs_n_info3_lut[n_info] = (uint16_t)ra_nr_tbs_from_n_info3(n_info);
+  }
+}
+
 static uint32_t ra_nr_tbs_from_n_info4(uint32_t n_info, double R)
 {
-  // quantized intermediate number of information bits
-  uint32_t n            = (uint32_t)(floor(log2(n_info - 24.0)) - 5.0);
+  // quantized intermediate number of information bits, floor(log2(n_info - 24)) computed on the integer
+  uint32_t n            = (31U - (uint32_t)__builtin_clz(n_info - 24U)) - 5U;
   uint32_t n_info_prime = SRSRAN_MAX(3840, POW2(n) * SRSRAN_ROUND(n_info - 24.0, POW2(n)));
 
   if (R <= 0.25) {
@@ -514,8 +545,8 @@ uint32_t srsran_ra_nr_tbs(uint32_t N_re, double S, double R, uint32_t Qm, uint32
   uint32_t n_info = (uint32_t)(N_re * S * R * Qm * nof_layers);
 
   // 3) When n_info ≤ 3824
-  if (n_info <= 3824) {
-    return ra_nr_tbs_from_n_info3(n_info);
+  if (n_info <= RA_NR_TBS_N_INFO3_MAX) {
+    return ra_nr_tbs_n_info3_lut[n_info];
   }
   // 4) When n_info > 3824
   return ra_nr_tbs_from_n_info4(n_info, R);
@@ -530,6 +561,11 @@ static int ra_nr_assert_csi_rs_dmrs_collision(const srsran_sch_cfg_nr_t* pdsch_c
     return SRSRAN_ERROR;
   }
 
+  // Nothing can collide without reserved RE
+  if (pdsch_cfg->rvd_re.count == 0) {
+    return SRSRAN_SUCCESS;
+  }
+
   // Check for collision
   if (srsran_re_pattern_check_collision(&pdsch_cfg->rvd_re, &dmrs_re_pattern) < SRSRAN_SUCCESS) {
     // Create reserved info string
@@ -571,21 +607,248 @@ uint32_t ra_nr_nof_crc_bits(uint32_t tbs, double R)
   return cbsegm.C * cbsegm.L_cb + cbsegm.L_tb;
 }
 
-int srsran_ra_nr_fill_tb(const srsran_sch_cfg_nr_t*   pdsch_cfg,
-                         const srsran_sch_grant_nr_t* grant,
-                         uint32_t                     mcs_idx,
-                         srsran_sch_tb_t*             tb)
+static bool ra_nr_tb_cache_dmrs_equal(const srsran_dmrs_sch_cfg_t* a, const srsran_dmrs_sch_cfg_t* b)
 {
+  return a->type == b->type && a->additional_pos == b->additional_pos && a->length == b->length &&
+         a->typeA_pos == b->typeA_pos && a->lte_CRS_to_match_around == b->lte_CRS_to_match_around &&
+         a->additional_DMRS_DL_Alt == b->additional_DMRS_DL_Alt;
+}
+
+static int ra_nr_tb_cache_dmrs_idx(const srsran_ra_nr_tb_cache_t* q, const srsran_dmrs_sch_cfg_t* dmrs)
+{
+  for (uint32_t i = 0; i < q->nof_dmrs; i++) {
+    if (ra_nr_tb_cache_dmrs_equal(&q->dmrs[i], dmrs)) {
+      return (int)i;
+    }
+  }
+  return SRSRAN_ERROR;
+}
+
+static int ra_nr_tb_cache_add_dmrs(srsran_ra_nr_tb_cache_t*    q,
+                                   srsran_dmrs_sch_type_t      type,
+                                   srsran_dmrs_sch_add_pos_t   additional_pos,
+                                   srsran_dmrs_sch_typeA_pos_t typeA_pos)
+{
+  // Only single symbol DMRS is cached, double symbol is selected per DCI
+  srsran_dmrs_sch_cfg_t dmrs = {};
+  dmrs.type                  = type;
+  dmrs.additional_pos        = additional_pos;
+  dmrs.length                = srsran_dmrs_sch_len_1;
+  dmrs.typeA_pos             = typeA_pos;
+
+  int idx = ra_nr_tb_cache_dmrs_idx(q, &dmrs);
+  if (idx < SRSRAN_SUCCESS && q->nof_dmrs < SRSRAN_RA_NR_TB_CACHE_MAX_DMRS) {
+    idx                    = (int)q->nof_dmrs;
+    q->dmrs[q->nof_dmrs++] = dmrs;
+  }
+  return idx;
+}
+
+static void ra_nr_tb_cache_add_alloc(srsran_ra_nr_tb_cache_t* q, int dmrs_idx, const srsran_sch_grant_nr_t* grant)
+{
+  if (dmrs_idx < SRSRAN_SUCCESS || grant->S >= SRSRAN_NSYMB_PER_SLOT_NR || grant->L == 0 ||
+      grant->S + grant->L > SRSRAN_NSYMB_PER_SLOT_NR || grant->mapping > srsran_sch_mapping_type_B) {
+    return;
+  }
+
+  srsran_sch_grant_nr_t alloc = {};
+  alloc.S                     = grant->S;
+  alloc.L                     = grant->L;
+  alloc.mapping               = grant->mapping;
+  for (uint32_t cdm = 1; cdm <= 3; cdm++) {
+    int8_t* dmrs_re = &q->dmrs_re[dmrs_idx][alloc.mapping][alloc.S][alloc.L - 1][cdm - 1];
+    if (*dmrs_re >= 0) {
+      continue;
+    }
+
+    alloc.nof_dmrs_cdm_groups_without_data = cdm;
+    int n_prb_dmrs                         = srsran_dmrs_sch_get_N_prb(&q->dmrs[dmrs_idx], &alloc);
+    if (n_prb_dmrs < SRSRAN_SUCCESS || n_prb_dmrs > INT8_MAX) {
+      continue;
+    }
+
+    // Allocations without RE are left to the per grant computation, which reports them
+    uint32_t nre = ra_nr_nof_re_prb(alloc.L, n_prb_dmrs, q->xoverhead);
+    if (nre == 0) {
+      continue;
+    }
+    if (q->nre_idx[nre] < 0) {
+      if (q->nof_nre >= SRSRAN_RA_NR_TB_CACHE_MAX_NRE) {
+        continue;
+      }
+      q->nre_idx[nre]      = (int8_t)q->nof_nre;
+      q->nre[q->nof_nre++] = nre;
+    }
+    *dmrs_re = (int8_t)n_prb_dmrs;
+  }
+}
+
+int srsran_ra_nr_tb_cache_init(srsran_ra_nr_tb_cache_t* q, const srsran_sch_hl_cfg_nr_t* hl_cfg, uint32_t max_nof_prb)
+{
+  if (q == NULL || hl_cfg == NULL || max_nof_prb == 0 || max_nof_prb > SRSRAN_MAX_PRB_NR) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  SRSRAN_MEM_ZERO(q, srsran_ra_nr_tb_cache_t, 1);
+  q->xoverhead   = hl_cfg->sch_cfg.xoverhead;
+  q->max_nof_prb = max_nof_prb;
+  memset(q->dmrs_re, -1, sizeof(q->dmrs_re));
+  memset(q->nre_idx, -1, sizeof(q->nre_idx));
+
+  // DMRS of the fallback DCI formats and of absent dedicated configurations, see ra_dl_dmrs() and ra_ul_dmrs()
+  int dmrs_default = ra_nr_tb_cache_add_dmrs(q, srsran_dmrs_sch_type_1, srsran_dmrs_sch_add_pos_2, hl_cfg->typeA_pos);
+  int dmrs_A = dmrs_default;
+  if (hl_cfg->dmrs_typeA.present) {
+    dmrs_A = ra_nr_tb_cache_add_dmrs(q, hl_cfg->dmrs_type, hl_cfg->dmrs_typeA.additional_pos, hl_cfg->typeA_pos);
+  }
+
+  srsran_sch_grant_nr_t grant = {};
+
+  // Higher layer time domain allocations with every DMRS their mapping type can use, first as they carry UE data.
+  // Mapping type B is left out, its DMRS is not supported by srsran_dmrs_sch_get_N_prb()
+  const srsran_sch_time_ra_t* time_ra[2]     = {hl_cfg->common_time_ra, hl_cfg->dedicated_time_ra};
+  uint32_t                    nof_time_ra[2] = {hl_cfg->nof_common_time_ra, hl_cfg->nof_dedicated_time_ra};
+  for (uint32_t i = 0; i < 2; i++) {
+    for (uint32_t m = 0; m < SRSRAN_MIN(nof_time_ra[i], SRSRAN_MAX_NOF_TIME_RA); m++) {
+      srsran_sliv_to_s_and_l(SRSRAN_NSYMB_PER_SLOT_NR, time_ra[i][m].sliv, &grant.S, &grant.L);
+      grant.mapping = time_ra[i][m].mapping_type;
+      if (grant.mapping == srsran_sch_mapping_type_A) {
+        ra_nr_tb_cache_add_alloc(q, dmrs_default, &grant);
+        ra_nr_tb_cache_add_alloc(q, dmrs_A, &grant);
+      }
+    }
+  }
+
+  // Default time domain allocations, used by SI and in absence of higher layer lists, with the fallback DMRS
+  for (uint32_t m = 0; m < SRSRAN_MAX_NOF_TIME_RA; m++) {
+    if (srsran_ra_dl_nr_time_default_A(m, hl_cfg->typeA_pos, &grant) == SRSRAN_SUCCESS &&
+        grant.mapping == srsran_sch_mapping_type_A) {
+      ra_nr_tb_cache_add_alloc(q, dmrs_default, &grant);
+    }
+    if (hl_cfg->scs_cfg < 4 &&
+        srsran_ra_ul_nr_pusch_time_resource_default_A(hl_cfg->scs_cfg, m, &grant) == SRSRAN_SUCCESS &&
+        grant.mapping == srsran_sch_mapping_type_A) {
+      ra_nr_tb_cache_add_alloc(q, dmrs_default, &grant);
+    }
+  }
+
+  if (q->nof_nre == 0) {
+    return SRSRAN_SUCCESS;
+  }
+
+  // Table 1 serves the fallback DCI formats and the common search spaces, the configured table the rest
+  bool reachable[SRSRAN_RA_NR_TB_CACHE_NOF_TABLES] = {true,
+                                                      hl_cfg->mcs_table == srsran_mcs_table_256qam,
+                                                      hl_cfg->mcs_table == srsran_mcs_table_qam64LowSE};
+  for (uint32_t t = 0; t < SRSRAN_RA_NR_TB_CACHE_NOF_TABLES; t++) {
+    if (!reachable[t]) {
+      continue;
+    }
+
+    uint32_t nof_entries = SRSRAN_RA_NR_TB_CACHE_NOF_MCS * q->nof_nre * max_nof_prb;
+    q->tb[t]             = SRSRAN_MEM_ALLOC(srsran_ra_nr_tb_cache_entry_t, nof_entries);
+    if (q->tb[t] == NULL) {
+      ERROR("Error allocating TB cache");
+      srsran_ra_nr_tb_cache_free(q);
+      return SRSRAN_ERROR;
+    }
+    SRSRAN_MEM_ZERO(q->tb[t], srsran_ra_nr_tb_cache_entry_t, nof_entries);
+
+    for (uint32_t mcs = 0; mcs < SRSRAN_RA_NR_TB_CACHE_NOF_MCS; mcs++) {
+      double       R = ra_nr_R_from_table((ra_nr_table_idx_t)t, mcs);
+      srsran_mod_t m = ra_nr_mod_from_table((ra_nr_table_idx_t)t, mcs);
+      if (!isnormal(R) || m >= SRSRAN_MOD_NITEMS) {
+        continue;
+      }
+      uint32_t Qm = srsran_mod_bits_x_symbol(m);
+
+      srsran_ra_nr_tb_cache_entry_t* entry = &q->tb[t][mcs * q->nof_nre * max_nof_prb];
+      for (uint32_t i = 0; i < q->nof_nre; i++) {
+        for (uint32_t nof_prb = 1; nof_prb <= max_nof_prb; nof_prb++, entry++) {
+          entry->tbs          = srsran_ra_nr_tbs(q->nre[i] * nof_prb, 1.0, R, Qm, 1);
+          entry->nof_crc_bits = ra_nr_nof_crc_bits(entry->tbs, R);
+        }
+      }
+    }
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+void srsran_ra_nr_tb_cache_free(srsran_ra_nr_tb_cache_t* q)
+{
+  if (q == NULL) {
+    return;
+  }
+
+  for (uint32_t t = 0; t < SRSRAN_RA_NR_TB_CACHE_NOF_TABLES; t++) {
+    if (q->tb[t] != NULL) {
+      free(q->tb[t]);
+    }
+  }
+  SRSRAN_MEM_ZERO(q, srsran_ra_nr_tb_cache_t, 1);
+}
+
+/**
+ * @brief Looks a single layer grant without TB scaling up in the cache
+ * @return The cached entry and its number of RE, NULL if the cache does not cover the grant
+ */
+static const srsran_ra_nr_tb_cache_entry_t* ra_nr_tb_cache_get(const srsran_ra_nr_tb_cache_t* q,
+                                                               const srsran_sch_cfg_nr_t*     cfg,
+                                                               const srsran_sch_grant_nr_t*   grant,
+                                                               ra_nr_table_idx_t              table,
+                                                               uint32_t                       mcs_idx,
+                                                               uint32_t*                      N_re)
+{
+  if (q == NULL || (uint32_t)table >= SRSRAN_RA_NR_TB_CACHE_NOF_TABLES || q->tb[table] == NULL ||
+      mcs_idx >= SRSRAN_RA_NR_TB_CACHE_NOF_MCS || grant->nof_layers != 1 || cfg->sch_cfg.xoverhead != q->xoverhead) {
+    return NULL;
+  }
+
+  if (grant->S >= SRSRAN_NSYMB_PER_SLOT_NR || grant->L == 0 || grant->L > SRSRAN_NSYMB_PER_SLOT_NR ||
+      grant->mapping > srsran_sch_mapping_type_B || grant->nof_dmrs_cdm_groups_without_data == 0 ||
+      grant->nof_dmrs_cdm_groups_without_data > 3) {
+    return NULL;
+  }
+
+  int dmrs_idx = ra_nr_tb_cache_dmrs_idx(q, &cfg->dmrs);
+  if (dmrs_idx < SRSRAN_SUCCESS) {
+    return NULL;
+  }
+
+  int8_t n_prb_dmrs =
+      q->dmrs_re[dmrs_idx][grant->mapping][grant->S][grant->L - 1][grant->nof_dmrs_cdm_groups_without_data - 1];
+  if (n_prb_dmrs < 0) {
+    return NULL;
+  }
+
+  uint32_t nre     = ra_nr_nof_re_prb(grant->L, n_prb_dmrs, q->xoverhead);
+  uint32_t nof_prb = ra_nr_nof_prb(grant);
+  if (q->nre_idx[nre] < 0 || nof_prb == 0 || nof_prb > q->max_nof_prb) {
+    return NULL;
+  }
+
+  *N_re = nre * nof_prb;
+  return &q->tb[table][(mcs_idx * q->nof_nre + (uint32_t)q->nre_idx[nre]) * q->max_nof_prb + nof_prb - 1];
+}
+
+static int ra_nr_fill_tb(const srsran_sch_cfg_nr_t*     pdsch_cfg,
+                         const srsran_ra_nr_tb_cache_t* tb_cache,
+                         const srsran_sch_grant_nr_t*   grant,
+                         uint32_t                       mcs_idx,
+                         srsran_sch_tb_t*               tb)
+{
+  ra_nr_table_idx_t table =
+      ra_nr_select_table(pdsch_cfg->sch_cfg.mcs_table, grant->dci_format, grant->dci_search_space, grant->rnti_type);
+
   // Get target Rate
-  double R = srsran_ra_nr_R_from_mcs(
-      pdsch_cfg->sch_cfg.mcs_table, grant->dci_format, grant->dci_search_space, grant->rnti_type, mcs_idx);
+  double R = ra_nr_R_from_table(table, mcs_idx);
   if (!isnormal(R)) {
     return SRSRAN_ERROR;
   }
 
   // Get modulation
-  srsran_mod_t m = srsran_ra_nr_mod_from_mcs(
-      pdsch_cfg->sch_cfg.mcs_table, grant->dci_format, grant->dci_search_space, grant->rnti_type, mcs_idx);
+  srsran_mod_t m = ra_nr_mod_from_table(table, mcs_idx);
   if (m >= SRSRAN_MOD_NITEMS) {
     return SRSRAN_ERROR;
   }
@@ -613,7 +876,12 @@ int srsran_ra_nr_fill_tb(const srsran_sch_cfg_nr_t*   pdsch_cfg,
   }
 
   // 1) The UE shall first determine the number of REs (N RE ) within the slot.
-  int N_re = srsran_ra_dl_nr_slot_nof_re(pdsch_cfg, grant);
+  uint32_t                             N_re_cached = 0;
+  const srsran_ra_nr_tb_cache_entry_t* cached      = NULL;
+  if (S == 1.0) {
+    cached = ra_nr_tb_cache_get(tb_cache, pdsch_cfg, grant, table, mcs_idx, &N_re_cached);
+  }
+  int N_re = (cached != NULL) ? (int)N_re_cached : srsran_ra_dl_nr_slot_nof_re(pdsch_cfg, grant);
   if (N_re <= SRSRAN_SUCCESS) {
     ERROR("Invalid number of RE (%d)", N_re);
     return SRSRAN_ERROR;
@@ -636,7 +904,7 @@ int srsran_ra_nr_fill_tb(const srsran_sch_cfg_nr_t*   pdsch_cfg,
 
   // Steps 2,3,4
   tb->mcs      = mcs_idx;
-  tb->tbs      = (int)srsran_ra_nr_tbs(N_re, S, R, Qm, tb->N_L);
+  tb->tbs      = (cached != NULL) ? (int)cached->tbs : (int)srsran_ra_nr_tbs(N_re, S, R, Qm, tb->N_L);
   tb->R        = R;
   tb->mod      = m;
   tb->nof_re   = (N_re - N_re_rvd) * grant->nof_layers;
@@ -646,12 +914,21 @@ int srsran_ra_nr_fill_tb(const srsran_sch_cfg_nr_t*   pdsch_cfg,
   // Calculate actual rate
   tb->R_prime = 0.0;
   if (tb->nof_re != 0) {
-    tb->R_prime = (double)(tb->tbs + ra_nr_nof_crc_bits(tb->tbs, tb->R)) / (double)tb->nof_bits;
+    uint32_t nof_crc_bits = (cached != NULL) ? cached->nof_crc_bits : ra_nr_nof_crc_bits(tb->tbs, tb->R);
+    tb->R_prime           = (double)(tb->tbs + nof_crc_bits) / (double)tb->nof_bits;
   }
 
   return SRSRAN_SUCCESS;
 }
 
+int srsran_ra_nr_fill_tb(const srsran_sch_cfg_nr_t*   pdsch_cfg,
+                         const srsran_sch_grant_nr_t* grant,
+                         uint32_t                     mcs_idx,
+                         srsran_sch_tb_t*             tb)
+{
+  return ra_nr_fill_tb(pdsch_cfg, NULL, grant, mcs_idx, tb);
+}
+
 static int ra_dl_dmrs(const srsran_sch_hl_cfg_nr_t* hl_cfg, const srsran_dci_dl_nr_t* dci, srsran_sch_cfg_nr_t* cfg)
 {
   const bool dedicated_dmrs_present =
@@ -824,7 +1101,8 @@ int srsran_ra_dl_dci_to_grant_nr(const srsran_carrier_nr_t*    carrier,
   }
 
   // 5.1.3 Modulation order, target code rate, redundancy version and transport block size determination
-  if (srsran_ra_nr_fill_tb(pdsch_cfg, pdsch_grant, dci_dl->mcs, &pdsch_grant->tb[0]) < SRSRAN_SUCCESS) {
+  if (ra_nr_fill_tb(pdsch_cfg, pdsch_hl_cfg->tb_cache, pdsch_grant, dci_dl->mcs, &pdsch_grant->tb[0]) <
+      SRSRAN_SUCCESS) {
     ERROR("Error filing tb");
     return SRSRAN_ERROR;
   }
@@ -933,7 +1211,8 @@ int srsran_ra_ul_dci_to_grant_nr(const srsran_carrier_nr_t*    carrier,
   }
 
   // 5.1.3 Modulation order, target code rate, redundancy version and transport block size determination
-  if (srsran_ra_nr_fill_tb(pusch_cfg, pusch_grant, dci_ul->mcs, &pusch_grant->tb[0]) < SRSRAN_SUCCESS) {
+  if (ra_nr_fill_tb(pusch_cfg, pusch_hl_cfg->tb_cache, pusch_grant, dci_ul->mcs, &pusch_grant->tb[0]) <
+      SRSRAN_SUCCESS) {
     ERROR("Error filing tb");
     return SRSRAN_ERROR;
   }
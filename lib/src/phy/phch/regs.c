@@ -27,17 +27,21 @@
 #include "srsran/phy/common/phy_common.h"
 #include "srsran/phy/phch/regs.h"
 #include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/vector.h"
 
 #define REG_IDX(r, i, n) r->k[i] + r->l* n* SRSRAN_NRE
 
 srsran_regs_reg_t* regs_find_reg(srsran_regs_t* h, uint32_t k, uint32_t l);
-int                regs_put_reg(srsran_regs_reg_t* reg, cf_t* reg_data, cf_t* slot_symbols, uint32_t nof_prb);
 
-int regs_add_reg(srsran_regs_reg_t* reg, cf_t* reg_data, cf_t* slot_symbols, uint32_t nof_prb);
+int  regs_ch_map_init(srsran_regs_ch_t* ch, uint32_t nof_prb);
+void regs_ch_map_free(srsran_regs_ch_t* ch);
 
-int regs_get_reg(srsran_regs_reg_t* reg, cf_t* slot_symbols, cf_t* reg_data, uint32_t nof_prb);
+void regs_ch_put(srsran_regs_ch_t* ch, uint32_t start_reg, uint32_t nof_regs, const cf_t* data, cf_t* slot_symbols);
+void regs_ch_add(srsran_regs_ch_t* ch, uint32_t start_reg, uint32_t nof_regs, const cf_t* data, cf_t* slot_symbols);
+void regs_ch_get(srsran_regs_ch_t* ch, uint32_t start_reg, uint32_t nof_regs, const cf_t* slot_symbols, cf_t* data);
+void regs_ch_reset(srsran_regs_ch_t* ch, uint32_t start_reg, uint32_t nof_regs, cf_t* slot_symbols);
 
-int regs_reset_reg(srsran_regs_reg_t* reg, cf_t* slot_symbols, uint32_t nof_prb);
+int regs_map_init(srsran_regs_t* h);
 
 /***************************************************************
  *
@@ -53,6 +57,7 @@ void regs_pdcch_free(srsran_regs_t* h)
       free(h->pdcch[i].regs);
       h->pdcch[i].regs = NULL;
     }
+    regs_ch_map_free(&h->pdcch[i]);
   }
 }
 
@@ -181,13 +186,8 @@ int srsran_regs_pdcch_put_offset(srsran_regs_t* h,
     return SRSRAN_ERROR;
   }
   if (start_reg + nof_regs <= h->pdcch[cfi - 1].nof_regs) {
-    uint32_t i, k;
-    k = 0;
-    for (i = start_reg; i < start_reg + nof_regs; i++) {
-      regs_put_reg(h->pdcch[cfi - 1].regs[i], &d[k], slot_symbols, h->cell.nof_prb);
-      k += 4;
-    }
-    return k;
+    regs_ch_put(&h->pdcch[cfi - 1], start_reg, nof_regs, d, slot_symbols);
+    return nof_regs * REGS_RE_X_REG;
   } else {
     ERROR("Out of range: start_reg + nof_reg must be lower than %d", h->pdcch[cfi - 1].nof_regs);
     return SRSRAN_ERROR;
@@ -215,13 +215,8 @@ int srsran_regs_pdcch_get_offset(srsran_regs_t* h,
     return SRSRAN_ERROR;
   }
   if (start_reg + nof_regs <= h->pdcch[cfi - 1].nof_regs) {
-    uint32_t i, k;
-    k = 0;
-    for (i = start_reg; i < start_reg + nof_regs; i++) {
-      regs_get_reg(h->pdcch[cfi - 1].regs[i], slot_symbols, &d[k], h->cell.nof_prb);
-      k += 4;
-    }
-    return k;
+    regs_ch_get(&h->pdcch[cfi - 1], start_reg, nof_regs, slot_symbols, d);
+    return nof_regs * REGS_RE_X_REG;
   } else {
     ERROR("Out of range: start_reg + nof_reg must be lower than %d", h->pdcch[cfi - 1].nof_regs);
     return SRSRAN_ERROR;
@@ -287,6 +282,7 @@ int regs_phich_init(srsran_regs_t* h, uint32_t phich_mi, bool mbsfn_or_sf1_6_tdd
        ng);
   for (i = 0; i < h->ngroups_phich; i++) {
     h->phich[i].nof_regs = REGS_PHICH_REGS_X_GROUP;
+    h->phich[i].re_idx   = NULL;
     h->phich[i].regs     = malloc(sizeof(srsran_regs_reg_t*) * REGS_PHICH_REGS_X_GROUP);
     if (!h->phich[i].regs) {
       perror("malloc");
@@ -384,6 +380,7 @@ void regs_phich_free(srsran_regs_t* h)
         free(h->phich[i].regs);
         h->phich[i].regs = NULL;
       }
+      regs_ch_map_free(&h->phich[i]);
     }
     free(h->phich);
     h->phich = NULL;
@@ -429,9 +426,8 @@ int srsran_regs_phich_add(srsran_regs_t* h, cf_t symbols[REGS_PHICH_NSYM], uint3
     ngroup /= 2;
   }
   srsran_regs_ch_t* rch = &h->phich[ngroup];
-  for (i = 0; i < rch->nof_regs && i * REGS_RE_X_REG < REGS_PHICH_NSYM; i++) {
-    regs_add_reg(rch->regs[i], &symbols[i * REGS_RE_X_REG], slot_symbols, h->cell.nof_prb);
-  }
+  i                     = SRSRAN_MIN(rch->nof_regs, REGS_PHICH_NSYM / REGS_RE_X_REG);
+  regs_ch_add(rch, 0, i, symbols, slot_symbols);
   return i * REGS_RE_X_REG;
 }
 
@@ -451,9 +447,8 @@ int srsran_regs_phich_reset(srsran_regs_t* h, cf_t* slot_symbols)
       ng = ngroup;
     }
     srsran_regs_ch_t* rch = &h->phich[ng];
-    for (i = 0; i < rch->nof_regs && i * REGS_RE_X_REG < REGS_PHICH_NSYM; i++) {
-      regs_reset_reg(rch->regs[i], slot_symbols, h->cell.nof_prb);
-    }
+    i                     = SRSRAN_MIN(rch->nof_regs, REGS_PHICH_NSYM / REGS_RE_X_REG);
+    regs_ch_reset(rch, 0, i, slot_symbols);
   }
   return SRSRAN_SUCCESS;
 }
@@ -474,9 +469,8 @@ int srsran_regs_phich_get(srsran_regs_t* h, cf_t* slot_symbols, cf_t symbols[REG
     ngroup /= 2;
   }
   srsran_regs_ch_t* rch = &h->phich[ngroup];
-  for (i = 0; i < rch->nof_regs && i * REGS_RE_X_REG < REGS_PHICH_NSYM; i++) {
-    regs_get_reg(rch->regs[i], slot_symbols, &symbols[i * REGS_RE_X_REG], h->cell.nof_prb);
-  }
+  i                     = SRSRAN_MIN(rch->nof_regs, REGS_PHICH_NSYM / REGS_RE_X_REG);
+  regs_ch_get(rch, 0, i, slot_symbols, symbols);
   return i * REGS_RE_X_REG;
 }
 
@@ -528,6 +522,7 @@ void regs_pcfich_free(srsran_regs_t* h)
     free(h->pcfich.regs);
     h->pcfich.regs = NULL;
   }
+  regs_ch_map_free(&h->pcfich);
 }
 
 uint32_t srsran_regs_pcfich_nregs(srsran_regs_t* h)
@@ -544,10 +539,8 @@ int srsran_regs_pcfich_put(srsran_regs_t* h, cf_t symbols[REGS_PCFICH_NSYM], cf_
 {
   srsran_regs_ch_t* rch = &h->pcfich;
 
-  uint32_t i;
-  for (i = 0; i < rch->nof_regs && i * REGS_RE_X_REG < REGS_PCFICH_NSYM; i++) {
-    regs_put_reg(rch->regs[i], &symbols[i * REGS_RE_X_REG], slot_symbols, h->cell.nof_prb);
-  }
+  uint32_t i = SRSRAN_MIN(rch->nof_regs, REGS_PCFICH_NSYM / REGS_RE_X_REG);
+  regs_ch_put(rch, 0, i, symbols, slot_symbols);
   return i * REGS_RE_X_REG;
 }
 
@@ -559,10 +552,8 @@ int srsran_regs_pcfich_put(srsran_regs_t* h, cf_t symbols[REGS_PCFICH_NSYM], cf_
 int srsran_regs_pcfich_get(srsran_regs_t* h, cf_t* slot_symbols, cf_t ch_data[REGS_PCFICH_NSYM])
 {
   srsran_regs_ch_t* rch = &h->pcfich;
-  uint32_t          i;
-  for (i = 0; i < rch->nof_regs && i * REGS_RE_X_REG < REGS_PCFICH_NSYM; i++) {
-    regs_get_reg(rch->regs[i], slot_symbols, &ch_data[i * REGS_RE_X_REG], h->cell.nof_prb);
-  }
+  uint32_t          i   = SRSRAN_MIN(rch->nof_regs, REGS_PCFICH_NSYM / REGS_RE_X_REG);
+  regs_ch_get(rch, 0, i, slot_symbols, ch_data);
   return i * REGS_RE_X_REG;
 }
 
@@ -769,6 +760,10 @@ int srsran_regs_init_opts(srsran_regs_t* h, srsran_cell_t cell, uint32_t phich_m
       ERROR("Error initializing PDCCH REGs");
       goto clean_and_exit;
     }
+    if (regs_map_init(h)) {
+      ERROR("Error initializing REG maps");
+      goto clean_and_exit;
+    }
 
     ret = SRSRAN_SUCCESS;
   }
@@ -782,50 +777,98 @@ clean_and_exit:
 }
 
 /**
- * Puts one REG data (4 symbols) in the slot symbols array
+ * Computes the resource element indices of the REGs of a channel. Mapping a channel is then a scatter or gather
+ * through a flat table, with no REG lookups left for every subframe.
  */
-int regs_put_reg(srsran_regs_reg_t* reg, cf_t* reg_data, cf_t* slot_symbols, uint32_t nof_prb)
+int regs_ch_map_init(srsran_regs_ch_t* ch, uint32_t nof_prb)
 {
-  uint32_t i;
-  for (i = 0; i < REGS_RE_X_REG; i++) {
-    slot_symbols[REG_IDX(reg, i, nof_prb)] = reg_data[i];
+  if (ch->nof_regs == 0) {
+    return SRSRAN_SUCCESS;
+  }
+  ch->re_idx = malloc(sizeof(uint32_t) * ch->nof_regs * REGS_RE_X_REG);
+  if (!ch->re_idx) {
+    perror("malloc");
+    return SRSRAN_ERROR;
+  }
+  for (uint32_t r = 0; r < ch->nof_regs; r++) {
+    for (uint32_t i = 0; i < REGS_RE_X_REG; i++) {
+      ch->re_idx[r * REGS_RE_X_REG + i] = REG_IDX(ch->regs[r], i, nof_prb);
+    }
+  }
+  return SRSRAN_SUCCESS;
+}
+
+void regs_ch_map_free(srsran_regs_ch_t* ch)
+{
+  if (ch->re_idx) {
+    free(ch->re_idx);
+    ch->re_idx = NULL;
   }
-  return REGS_RE_X_REG;
 }
 
 /**
- * Adds one REG data (4 symbols) in the slot symbols array
+ * Computes the resource element indices of PCFICH, PHICH and PDCCH once all REGs have been assigned
+ */
+int regs_map_init(srsran_regs_t* h)
+{
+  if (regs_ch_map_init(&h->pcfich, h->cell.nof_prb)) {
+    return SRSRAN_ERROR;
+  }
+  uint32_t nof_phich_units = SRSRAN_CP_ISEXT(h->cell.cp) ? h->ngroups_phich / 2 : h->ngroups_phich;
+  for (uint32_t i = 0; i < nof_phich_units; i++) {
+    if (regs_ch_map_init(&h->phich[i], h->cell.nof_prb)) {
+      return SRSRAN_ERROR;
+    }
+  }
+  for (uint32_t cfi = 0; cfi < 3; cfi++) {
+    if (regs_ch_map_init(&h->pdcch[cfi], h->cell.nof_prb)) {
+      return SRSRAN_ERROR;
+    }
+  }
+  return SRSRAN_SUCCESS;
+}
+
+/**
+ * Puts the data of nof_regs REGs (4 symbols each), starting at start_reg, in the slot symbols array
+ */
+void regs_ch_put(srsran_regs_ch_t* ch, uint32_t start_reg, uint32_t nof_regs, const cf_t* data, cf_t* slot_symbols)
+{
+  const uint32_t* re_idx = &ch->re_idx[start_reg * REGS_RE_X_REG];
+  for (uint32_t i = 0; i < nof_regs * REGS_RE_X_REG; i++) {
+    slot_symbols[re_idx[i]] = data[i];
+  }
+}
+
+/**
+ * Adds the data of nof_regs REGs (4 symbols each) to the slot symbols array
  * Used by PHICH
  */
-int regs_add_reg(srsran_regs_reg_t* reg, cf_t* reg_data, cf_t* slot_symbols, uint32_t nof_prb)
+void regs_ch_add(srsran_regs_ch_t* ch, uint32_t start_reg, uint32_t nof_regs, const cf_t* data, cf_t* slot_symbols)
 {
-  uint32_t i;
-  for (i = 0; i < REGS_RE_X_REG; i++) {
-    slot_symbols[REG_IDX(reg, i, nof_prb)] += reg_data[i];
+  const uint32_t* re_idx = &ch->re_idx[start_reg * REGS_RE_X_REG];
+  for (uint32_t i = 0; i < nof_regs * REGS_RE_X_REG; i++) {
+    slot_symbols[re_idx[i]] += data[i];
   }
-  return REGS_RE_X_REG;
 }
 
 /**
- * Reset REG data (4 symbols) in the slot symbols array
+ * Gets the data of nof_regs REGs (4 symbols each) from the slot symbols array
  */
-int regs_reset_reg(srsran_regs_reg_t* reg, cf_t* slot_symbols, uint32_t nof_prb)
+void regs_ch_get(srsran_regs_ch_t* ch, uint32_t start_reg, uint32_t nof_regs, const cf_t* slot_symbols, cf_t* data)
 {
-  uint32_t i;
-  for (i = 0; i < REGS_RE_X_REG; i++) {
-    slot_symbols[REG_IDX(reg, i, nof_prb)] = 0;
+  const uint32_t* re_idx = &ch->re_idx[start_reg * REGS_RE_X_REG];
+  for (uint32_t i = 0; i < nof_regs * REGS_RE_X_REG; i++) {
+    data[i] = slot_symbols[re_idx[i]];
   }
-  return REGS_RE_X_REG;
 }
 
 /**
- * Gets one REG data (4 symbols) from the slot symbols array
+ * Resets the symbols of nof_regs REGs in the slot symbols array
  */
-int regs_get_reg(srsran_regs_reg_t* reg, cf_t* slot_symbols, cf_t* reg_data, uint32_t nof_prb)
+void regs_ch_reset(srsran_regs_ch_t* ch, uint32_t start_reg, uint32_t nof_regs, cf_t* slot_symbols)
 {
-  uint32_t i;
-  for (i = 0; i < REGS_RE_X_REG; i++) {
-    reg_data[i] = slot_symbols[REG_IDX(reg, i, nof_prb)];
+  const uint32_t* re_idx = &ch->re_idx[start_reg * REGS_RE_X_REG];
+  for (uint32_t i = 0; i < nof_regs * REGS_RE_X_REG; i++) {
+    slot_symbols[re_idx[i]] = 0;
   }
-  return REGS_RE_X_REG;
 }
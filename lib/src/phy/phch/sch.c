@@ -165,6 +165,7 @@ int srsran_sch_init(srsran_sch_t* q)
     q->max_iterations = SRSRAN_PDSCH_MAX_TDEC_ITERS;
 
     srsran_rm_turbo_gentables();
+    q->rm_tables_ref = true;
 
     // Allocate int16 for reception (LLRs)
     q->cb_in = srsran_vec_u8_malloc((SRSRAN_TCOD_MAX_LEN_CB + 8) / 8);
@@ -200,7 +201,9 @@ clean:
 
 void srsran_sch_free(srsran_sch_t* q)
 {
-  srsran_rm_turbo_free_tables();
+  if (q->rm_tables_ref) {
+    srsran_rm_turbo_free_tables();
+  }
 
   if (q->cb_in) {
     free(q->cb_in);
@@ -385,9 +388,20 @@ bool decode_tb_cb(srsran_sch_t*           q,
     return false;
   }
 
+  if (softbuffer->llr_8bit && !q->llr_is_8bit) {
+    ERROR("Error 8-bit soft-buffer requires 8-bit LLR decoding");
+    return false;
+  }
+
   q->avg_iterations = 0;
 
   for (int cb_idx = 0; cb_idx < cb_segm->C; cb_idx++) {
+    // Soft-buffers bound to an exhausted pool may not hold all the code blocks
+    if (softbuffer->buffer_f[cb_idx] == NULL) {
+      ERROR("Error soft-buffer provided NULL buffer for cb_idx=%d", cb_idx);
+      return false;
+    }
+
     /* Do not process blocks with CRC Ok */
     if (softbuffer->cb_crc[cb_idx] == false) {
       uint32_t cb_len     = cb_idx < cb_segm->C1 ? cb_segm->K1 : cb_segm->K2;
@@ -1185,7 +1199,9 @@ int srsran_ulsch_decode(srsran_sch_t*       q,
   e_offset += Q_prime_cqi * Qm;
 
   // Decode ULSCH
-  if (cb_segm.tbs > 0) {
+  if (cfg->uci_only) {
+    ret = SRSRAN_ERROR;
+  } else if (cb_segm.tbs > 0) {
     uint32_t G = nb_q / Qm - Q_prime_ri - Q_prime_cqi;
     ret        = decode_tb(q, cfg->softbuffers.rx, &cb_segm, Qm, cfg->grant.tb.rv, G * Qm, &g_bits[e_offset], data);
   }
@@ -26,6 +26,7 @@
 #include "srsran/phy/fec/ldpc/ldpc_rm.h"
 #include "srsran/phy/phch/ra_nr.h"
 #include "srsran/phy/utils/bit.h"
+#include "srsran/phy/utils/coworker_group.h"
 #include "srsran/phy/utils/debug.h"
 #include "srsran/phy/utils/vector.h"
 
@@ -216,67 +217,222 @@ static inline int sch_nr_init_common(srsran_sch_nr_t* q)
   return SRSRAN_SUCCESS;
 }
 
-int srsran_sch_nr_init_tx(srsran_sch_nr_t* q, const srsran_sch_nr_args_t* args)
+static int sch_nr_init_encoders(srsran_ldpc_encoder_t**   encoder_bg1,
+                                srsran_ldpc_encoder_t**   encoder_bg2,
+                                srsran_ldpc_encoder_type_t encoder_type)
 {
-  int ret = sch_nr_init_common(q);
-  if (ret < SRSRAN_SUCCESS) {
-    return ret;
-  }
-
-  srsran_ldpc_encoder_type_t encoder_type = SRSRAN_LDPC_ENCODER_C;
-
-#ifdef LV_HAVE_AVX512
-  if (!args->disable_simd) {
-    encoder_type = SRSRAN_LDPC_ENCODER_AVX512;
-  }
-#else // LV_HAVE_AVX512
-#ifdef LV_HAVE_AVX2
-  if (!args->disable_simd) {
-    encoder_type = SRSRAN_LDPC_ENCODER_AVX2;
-  }
-#endif // LV_HAVE_AVX2
-#endif // LV_HAVE_AVX612
-
   // Iterate over all possible lifting sizes
   for (uint16_t ls = 0; ls <= MAX_LIFTSIZE; ls++) {
     uint8_t ls_index = get_ls_index(ls);
 
     // Invalid lifting size
     if (ls_index == VOID_LIFTSIZE) {
-      q->encoder_bg1[ls] = NULL;
-      q->encoder_bg2[ls] = NULL;
+      encoder_bg1[ls] = NULL;
+      encoder_bg2[ls] = NULL;
       continue;
     }
 
-    q->encoder_bg1[ls] = SRSRAN_MEM_ALLOC(srsran_ldpc_encoder_t, 1);
-    if (!q->encoder_bg1[ls]) {
+    encoder_bg1[ls] = SRSRAN_MEM_ALLOC(srsran_ldpc_encoder_t, 1);
+    if (!encoder_bg1[ls]) {
       ERROR("Error: calloc");
       return SRSRAN_ERROR;
     }
-    SRSRAN_MEM_ZERO(q->encoder_bg1[ls], srsran_ldpc_encoder_t, 1);
+    SRSRAN_MEM_ZERO(encoder_bg1[ls], srsran_ldpc_encoder_t, 1);
 
-    if (srsran_ldpc_encoder_init(q->encoder_bg1[ls], encoder_type, BG1, ls) < SRSRAN_SUCCESS) {
+    if (srsran_ldpc_encoder_init(encoder_bg1[ls], encoder_type, BG1, ls) < SRSRAN_SUCCESS) {
       ERROR("Error: initialising BG1 LDPC encoder for ls=%d", ls);
       return SRSRAN_ERROR;
     }
 
-    q->encoder_bg2[ls] = SRSRAN_MEM_ALLOC(srsran_ldpc_encoder_t, 1);
-    if (!q->encoder_bg2[ls]) {
+    encoder_bg2[ls] = SRSRAN_MEM_ALLOC(srsran_ldpc_encoder_t, 1);
+    if (!encoder_bg2[ls]) {
       return SRSRAN_ERROR;
     }
-    SRSRAN_MEM_ZERO(q->encoder_bg2[ls], srsran_ldpc_encoder_t, 1);
+    SRSRAN_MEM_ZERO(encoder_bg2[ls], srsran_ldpc_encoder_t, 1);
 
-    if (srsran_ldpc_encoder_init(q->encoder_bg2[ls], encoder_type, BG2, ls) < SRSRAN_SUCCESS) {
+    if (srsran_ldpc_encoder_init(encoder_bg2[ls], encoder_type, BG2, ls) < SRSRAN_SUCCESS) {
       ERROR("Error: initialising BG2 LDPC encoder for ls=%d", ls);
       return SRSRAN_ERROR;
     }
   }
 
+  return SRSRAN_SUCCESS;
+}
+
+static void sch_nr_free_encoders(srsran_ldpc_encoder_t** encoder_bg1, srsran_ldpc_encoder_t** encoder_bg2)
+{
+  for (uint16_t ls = 0; ls <= MAX_LIFTSIZE; ls++) {
+    if (encoder_bg1[ls]) {
+      srsran_ldpc_encoder_free(encoder_bg1[ls]);
+      free(encoder_bg1[ls]);
+      encoder_bg1[ls] = NULL;
+    }
+    if (encoder_bg2[ls]) {
+      srsran_ldpc_encoder_free(encoder_bg2[ls]);
+      free(encoder_bg2[ls]);
+      encoder_bg2[ls] = NULL;
+    }
+  }
+}
+
+/**
+ * Resources used for encoding a code block. Every thread encoding code blocks of the same TB has its own.
+ */
+typedef struct {
+  uint8_t*                temp_cb;
+  srsran_crc_t*           crc_cb;
+  srsran_ldpc_encoder_t** encoder_bg1;
+  srsran_ldpc_encoder_t** encoder_bg2;
+} sch_nr_enc_lane_t;
+
+/**
+ * Transport block whose code blocks are being encoded into the Tx soft-buffer
+ */
+typedef struct {
+  const srsran_sch_nr_tb_info_t* cfg;
+  const srsran_sch_tb_t*         tb;
+  const uint8_t*                 data;
+  uint32_t                       checksum_tb;
+  bool                           packed;
+} sch_nr_enc_job_t;
+
+/**
+ * Code block encoding resources owned by a coworker
+ */
+typedef struct {
+  uint8_t*               temp_cb;
+  srsran_crc_t           crc_cb;
+  srsran_ldpc_encoder_t* encoder_bg1[MAX_LIFTSIZE + 1];
+  srsran_ldpc_encoder_t* encoder_bg2[MAX_LIFTSIZE + 1];
+} sch_nr_enc_coworker_t;
+
+/**
+ * Threads encoding the code blocks of a transport block together with the caller
+ */
+typedef struct {
+  srsran_coworker_group_t group;
+  sch_nr_enc_coworker_t*  coworkers;
+  sch_nr_enc_lane_t*      lanes;         ///< Lane of each coworker, pointing to its resources
+  uint32_t                nof_coworkers; ///< Number of coworkers whose resources are initialised
+} sch_nr_enc_group_t;
+
+static int sch_nr_encode_cb(const sch_nr_enc_lane_t* lane, const sch_nr_enc_job_t* job, uint32_t r);
+
+static int sch_nr_enc_group_encode_cb(void* ctx, void* lane, uint32_t r)
+{
+  return sch_nr_encode_cb((const sch_nr_enc_lane_t*)lane, (const sch_nr_enc_job_t*)ctx, r);
+}
+
+static void sch_nr_enc_coworker_free(sch_nr_enc_coworker_t* h)
+{
+  sch_nr_free_encoders(h->encoder_bg1, h->encoder_bg2);
+  if (h->temp_cb) {
+    free(h->temp_cb);
+  }
+}
+
+static void sch_nr_enc_group_free(sch_nr_enc_group_t* g)
+{
+  if (g == NULL) {
+    return;
+  }
+
+  // Stop the threads before releasing their resources
+  srsran_coworker_group_free(&g->group);
+  for (uint32_t i = 0; i < g->nof_coworkers; i++) {
+    sch_nr_enc_coworker_free(&g->coworkers[i]);
+  }
+
+  if (g->coworkers) {
+    free(g->coworkers);
+  }
+  if (g->lanes) {
+    free(g->lanes);
+  }
+  free(g);
+}
+
+static sch_nr_enc_group_t* sch_nr_enc_group_init(uint32_t nof_coworkers, srsran_ldpc_encoder_type_t encoder_type)
+{
+  sch_nr_enc_group_t* g = SRSRAN_MEM_ALLOC(sch_nr_enc_group_t, 1);
+  if (g == NULL) {
+    return NULL;
+  }
+  SRSRAN_MEM_ZERO(g, sch_nr_enc_group_t, 1);
+
+  g->coworkers = SRSRAN_MEM_ALLOC(sch_nr_enc_coworker_t, nof_coworkers);
+  g->lanes     = SRSRAN_MEM_ALLOC(sch_nr_enc_lane_t, nof_coworkers);
+  if (g->coworkers == NULL || g->lanes == NULL) {
+    sch_nr_enc_group_free(g);
+    return NULL;
+  }
+  SRSRAN_MEM_ZERO(g->coworkers, sch_nr_enc_coworker_t, nof_coworkers);
+
+  for (uint32_t i = 0; i < nof_coworkers; i++) {
+    sch_nr_enc_coworker_t* h = &g->coworkers[i];
+
+    h->temp_cb = srsran_vec_u8_malloc(SRSRAN_LDPC_MAX_LEN_CB * 8);
+    if (h->temp_cb == NULL || srsran_crc_init(&h->crc_cb, SRSRAN_LTE_CRC24B, 24) < SRSRAN_SUCCESS ||
+        sch_nr_init_encoders(h->encoder_bg1, h->encoder_bg2, encoder_type) < SRSRAN_SUCCESS) {
+      sch_nr_enc_coworker_free(h);
+      sch_nr_enc_group_free(g);
+      return NULL;
+    }
+    g->nof_coworkers++;
+
+    g->lanes[i].temp_cb     = h->temp_cb;
+    g->lanes[i].crc_cb      = &h->crc_cb;
+    g->lanes[i].encoder_bg1 = h->encoder_bg1;
+    g->lanes[i].encoder_bg2 = h->encoder_bg2;
+  }
+
+  if (srsran_coworker_group_init(&g->group, nof_coworkers, g->lanes, sizeof(sch_nr_enc_lane_t)) < SRSRAN_SUCCESS) {
+    ERROR("Error: starting encoder coworker threads");
+    sch_nr_enc_group_free(g);
+    return NULL;
+  }
+
+  return g;
+}
+
+int srsran_sch_nr_init_tx(srsran_sch_nr_t* q, const srsran_sch_nr_args_t* args)
+{
+  int ret = sch_nr_init_common(q);
+  if (ret < SRSRAN_SUCCESS) {
+    return ret;
+  }
+
+  srsran_ldpc_encoder_type_t encoder_type = SRSRAN_LDPC_ENCODER_C;
+
+#ifdef LV_HAVE_AVX512
+  if (!args->disable_simd) {
+    encoder_type = SRSRAN_LDPC_ENCODER_AVX512;
+  }
+#else // LV_HAVE_AVX512
+#ifdef LV_HAVE_AVX2
+  if (!args->disable_simd) {
+    encoder_type = SRSRAN_LDPC_ENCODER_AVX2;
+  }
+#endif // LV_HAVE_AVX2
+#endif // LV_HAVE_AVX612
+
+  if (sch_nr_init_encoders(q->encoder_bg1, q->encoder_bg2, encoder_type) < SRSRAN_SUCCESS) {
+    return SRSRAN_ERROR;
+  }
+
   if (srsran_ldpc_rm_tx_init(&q->tx_rm) < SRSRAN_SUCCESS) {
     ERROR("Error: initialising Tx LDPC Rate matching");
     return SRSRAN_ERROR;
   }
 
+  if (args->nof_encoder_coworkers > 0 && q->enc_coworkers == NULL) {
+    q->enc_coworkers = sch_nr_enc_group_init(args->nof_encoder_coworkers, encoder_type);
+    if (q->enc_coworkers == NULL) {
+      ERROR("Error: initialising %d encoder coworkers", args->nof_encoder_coworkers);
+      return SRSRAN_ERROR;
+    }
+  }
+
   return SRSRAN_SUCCESS;
 }
 
@@ -381,15 +537,12 @@ void srsran_sch_nr_free(srsran_sch_nr_t* q)
     free(q->temp_cb);
   }
 
+  sch_nr_enc_group_free((sch_nr_enc_group_t*)q->enc_coworkers);
+  q->enc_coworkers = NULL;
+
+  sch_nr_free_encoders(q->encoder_bg1, q->encoder_bg2);
+
   for (uint16_t ls = 0; ls <= MAX_LIFTSIZE; ls++) {
-    if (q->encoder_bg1[ls]) {
-      srsran_ldpc_encoder_free(q->encoder_bg1[ls]);
-      free(q->encoder_bg1[ls]);
-    }
-    if (q->encoder_bg2[ls]) {
-      srsran_ldpc_encoder_free(q->encoder_bg2[ls]);
-      free(q->encoder_bg2[ls]);
-    }
     if (q->decoder_bg1[ls]) {
       srsran_ldpc_decoder_free(q->decoder_bg1[ls]);
       free(q->decoder_bg1[ls]);
@@ -404,11 +557,131 @@ void srsran_sch_nr_free(srsran_sch_nr_t* q)
   srsran_ldpc_rm_rx_free_c(&q->rx_rm);
 }
 
+static int sch_nr_encode_cb(const sch_nr_enc_lane_t* lane, const sch_nr_enc_job_t* job, uint32_t r)
+{
+  const srsran_sch_nr_tb_info_t* cfg     = job->cfg;
+  srsran_ldpc_encoder_t*         encoder = (cfg->bg == BG1) ? lane->encoder_bg1[cfg->Z] : lane->encoder_bg2[cfg->Z];
+  uint8_t*                       temp_cb = lane->temp_cb;
+  bool                           packed  = job->packed;
+
+  // Select rate matching circular buffer
+  uint8_t* rm_buffer = job->tb->softbuffer.tx->buffer_b[r];
+  if (rm_buffer == NULL) {
+    ERROR("Error: soft-buffer provided NULL buffer for cb_idx=%d", r);
+    return SRSRAN_ERROR;
+  }
+
+  // All code blocks carry the same number of payload bits
+  uint32_t       cb_len    = cfg->Kp - cfg->L_cb;
+  const uint8_t* input_ptr = &job->data[r * (cb_len / 8)];
+
+  // If it is the last segment...
+  if (r == cfg->C - 1) {
+    cb_len -= cfg->L_tb;
+
+    // Copy payload without TB CRC and append TB CRC
+    if (packed) {
+      srsran_vec_u8_copy(temp_cb, input_ptr, cb_len / 8);
+      for (uint32_t i = 0; i < cfg->L_tb / 8; i++) {
+        temp_cb[cb_len / 8 + i] = (uint8_t)(job->checksum_tb >> (cfg->L_tb - 8 * (i + 1)));
+      }
+    } else {
+      srsran_bit_unpack_vector(input_ptr, temp_cb, (int)cb_len);
+      uint8_t* ptr = &temp_cb[cb_len];
+      srsran_bit_unpack(job->checksum_tb, &ptr, cfg->L_tb);
+    }
+    SCH_INFO_TX("CB %d: appending TB CRC=%06x", r, job->checksum_tb);
+  } else {
+    // Copy payload
+    if (packed) {
+      srsran_vec_u8_copy(temp_cb, input_ptr, cb_len / 8);
+    } else {
+      srsran_bit_unpack_vector(input_ptr, temp_cb, (int)cb_len);
+    }
+  }
+
+  if (SRSRAN_DEBUG_ENABLED && get_srsran_verbose_level() >= SRSRAN_VERBOSE_DEBUG && !is_handler_registered()) {
+    DEBUG("cb%d=", r);
+    srsran_vec_fprint_byte(stdout, input_ptr, cb_len / 8);
+  }
+
+  // Attach code block CRC if required
+  if (cfg->L_cb) {
+    if (packed) {
+      srsran_crc_attach_byte(lane->crc_cb, temp_cb, (int)(cfg->Kp - cfg->L_cb));
+    } else {
+      srsran_crc_attach(lane->crc_cb, temp_cb, (int)(cfg->Kp - cfg->L_cb));
+    }
+    SCH_INFO_TX("CB %d: CRC=%06x", r, (uint32_t)srsran_crc_checksum_get(lane->crc_cb));
+  }
+
+  if (packed) {
+    // Filler bits are zero in the packed message, both Kp and the payload are multiple of 8
+    srsran_vec_u8_zero(&temp_cb[cfg->Kp / 8], SRSRAN_CEIL(cfg->Kr, 8) - cfg->Kp / 8);
+
+    // Encode code block into a packed codeword
+    if (srsran_ldpc_encoder_encode_packed(encoder, temp_cb, rm_buffer, cfg->Kr, encoder->liftN - 2 * encoder->ls) <
+        SRSRAN_SUCCESS) {
+      ERROR("Error encoding CB %d", r);
+      return SRSRAN_ERROR;
+    }
+  } else {
+    // Insert filler bits
+    for (uint32_t i = cfg->Kp; i < cfg->Kr; i++) {
+      temp_cb[i] = FILLER_BIT;
+    }
+
+    // Encode code block
+    srsran_ldpc_encoder_encode(encoder, temp_cb, rm_buffer, cfg->Kr);
+  }
+
+  if (SRSRAN_DEBUG_ENABLED && get_srsran_verbose_level() >= SRSRAN_VERBOSE_DEBUG && !is_handler_registered()) {
+    DEBUG("encoded=");
+    if (packed) {
+      srsran_vec_fprint_byte(stdout, rm_buffer, SRSRAN_CEIL(encoder->liftN - 2 * encoder->ls, 8));
+    } else {
+      srsran_vec_fprint_b(stdout, rm_buffer, encoder->liftN - 2 * encoder->ls);
+    }
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+static int sch_nr_encode_cbs(srsran_sch_nr_t* q, const sch_nr_enc_job_t* job)
+{
+  sch_nr_enc_lane_t   lane = {q->temp_cb, &q->crc_cb, q->encoder_bg1, q->encoder_bg2};
+  sch_nr_enc_group_t* g    = (sch_nr_enc_group_t*)q->enc_coworkers;
+
+  // Serial encoding
+  if (g == NULL || job->cfg->C < 2) {
+    for (uint32_t r = 0; r < job->cfg->C; r++) {
+      if (sch_nr_encode_cb(&lane, job, r) < SRSRAN_SUCCESS) {
+        return SRSRAN_ERROR;
+      }
+    }
+    return SRSRAN_SUCCESS;
+  }
+
+  // Share the code blocks out between the caller and the coworkers
+  return srsran_coworker_group_run(&g->group, job->cfg->C, sch_nr_enc_group_encode_cb, (void*)job, &lane);
+}
+
+/**
+ * Identifies the encoded code blocks of a transport block held in a Tx soft-buffer. The TBS and the base graph set the
+ * code block segmentation, and the NDI tells consecutive transport blocks of the same size apart.
+ */
+static inline uint64_t sch_nr_tx_encoded_id(const srsran_sch_nr_tb_info_t* cfg, const srsran_sch_tb_t* tb, bool packed)
+{
+  return ((uint64_t)cfg->A << 8U) | ((uint64_t)(cfg->bg == BG2) << 3U) | ((uint64_t)(tb->ndi & 1) << 2U) |
+         ((uint64_t)packed << 1U) | 1U;
+}
+
 static inline int sch_nr_encode(srsran_sch_nr_t*        q,
                                 const srsran_sch_cfg_t* sch_cfg,
                                 const srsran_sch_tb_t*  tb,
                                 const uint8_t*          data,
-                                uint8_t*                e_bits)
+                                uint8_t*                e_bits,
+                                bool                    packed)
 {
   // Pointer protection
   if (!q || !sch_cfg || !tb || !data || !e_bits) {
@@ -420,8 +693,7 @@ static inline int sch_nr_encode(srsran_sch_nr_t*        q,
     return SRSRAN_ERROR;
   }
 
-  const uint8_t* input_ptr  = data;
-  uint8_t*       output_ptr = e_bits;
+  uint32_t e_idx = 0; ///< Number of bits written in e_bits
 
   srsran_sch_nr_tb_info_t cfg = {};
   if (srsran_sch_nr_fill_tb_info(&q->carrier, sch_cfg, tb, &cfg) < SRSRAN_SUCCESS) {
@@ -461,75 +733,40 @@ static inline int sch_nr_encode(srsran_sch_nr_t*        q,
     return SRSRAN_ERROR;
   }
 
-  // Calculate TB CRC
-  uint32_t checksum_tb = srsran_crc_checksum_byte(crc_tb, data, tb->tbs);
-  if (SRSRAN_DEBUG_ENABLED && get_srsran_verbose_level() >= SRSRAN_VERBOSE_DEBUG && !is_handler_registered()) {
-    DEBUG("tb=");
-    srsran_vec_fprint_byte(stdout, data, tb->tbs / 8);
-  }
+  // Retransmissions of the transport block held in the soft-buffer only redo the rate matching
+  uint64_t encoded_id = sch_nr_tx_encoded_id(&cfg, tb, packed);
+  if (tb->rv != 0 && tb->softbuffer.tx->encoded_id == encoded_id) {
+    q->nof_tx_cache_hit++;
+  } else {
+    q->nof_tx_cache_miss++;
+    tb->softbuffer.tx->encoded_id = 0;
 
-  // For each code block...
-  uint32_t j = 0;
-  for (uint32_t r = 0; r < cfg.C; r++) {
-    // Select rate matching circular buffer
-    uint8_t* rm_buffer = tb->softbuffer.tx->buffer_b[r];
-    if (rm_buffer == NULL) {
-      ERROR("Error: soft-buffer provided NULL buffer for cb_idx=%d", r);
-      return SRSRAN_ERROR;
+    // Calculate TB CRC
+    uint32_t checksum_tb = srsran_crc_checksum_byte(crc_tb, data, tb->tbs);
+    if (SRSRAN_DEBUG_ENABLED && get_srsran_verbose_level() >= SRSRAN_VERBOSE_DEBUG && !is_handler_registered()) {
+      DEBUG("tb=");
+      srsran_vec_fprint_byte(stdout, data, tb->tbs / 8);
     }
 
-    // If data provided, encode and store in RM circular buffer
-    if (data != NULL) {
-      uint32_t cb_len = cfg.Kp - cfg.L_cb;
-
-      // If it is the last segment...
-      if (r == cfg.C - 1) {
-        cb_len -= cfg.L_tb;
-
-        // Copy payload without TB CRC
-        srsran_bit_unpack_vector(input_ptr, q->temp_cb, (int)cb_len);
-
-        // Append TB CRC
-        uint8_t* ptr = &q->temp_cb[cb_len];
-        srsran_bit_unpack(checksum_tb, &ptr, cfg.L_tb);
-        SCH_INFO_TX("CB %d: appending TB CRC=%06x", r, checksum_tb);
-      } else {
-        // Copy payload
-        srsran_bit_unpack_vector(input_ptr, q->temp_cb, (int)cb_len);
-      }
-
-      if (SRSRAN_DEBUG_ENABLED && get_srsran_verbose_level() >= SRSRAN_VERBOSE_DEBUG && !is_handler_registered()) {
-        DEBUG("cb%d=", r);
-        srsran_vec_fprint_byte(stdout, input_ptr, cb_len / 8);
-      }
-
-      input_ptr += cb_len / 8;
-
-      // Attach code block CRC if required
-      if (cfg.L_cb) {
-        srsran_crc_attach(&q->crc_cb, q->temp_cb, (int)(cfg.Kp - cfg.L_cb));
-        SCH_INFO_TX("CB %d: CRC=%06x", r, (uint32_t)srsran_crc_checksum_get(&q->crc_cb));
-      }
-
-      // Insert filler bits
-      for (uint32_t i = cfg.Kp; i < cfg.Kr; i++) {
-        q->temp_cb[i] = FILLER_BIT;
-      }
-
-      // Encode code block
-      srsran_ldpc_encoder_encode(encoder, q->temp_cb, rm_buffer, cfg.Kr);
-
-      if (SRSRAN_DEBUG_ENABLED && get_srsran_verbose_level() >= SRSRAN_VERBOSE_DEBUG && !is_handler_registered()) {
-        DEBUG("encoded=");
-        srsran_vec_fprint_b(stdout, rm_buffer, encoder->liftN - 2 * encoder->ls);
-      }
+    // Encode all code blocks and store them in the RM circular buffers
+    sch_nr_enc_job_t job = {&cfg, tb, data, checksum_tb, packed};
+    if (sch_nr_encode_cbs(q, &job) < SRSRAN_SUCCESS) {
+      return SRSRAN_ERROR;
     }
+    tb->softbuffer.tx->encoded_id = encoded_id;
+  }
 
+  // For each code block...
+  uint32_t j = 0;
+  for (uint32_t r = 0; r < cfg.C; r++) {
     // Skip block
     if (!cfg.mask[r]) {
       continue;
     }
 
+    // Select rate matching circular buffer
+    uint8_t* rm_buffer = tb->softbuffer.tx->buffer_b[r];
+
     // Select rate matching output sequence number of bits
     uint32_t E = sch_nr_get_E(&cfg, j);
     j++;
@@ -544,8 +781,26 @@ static inline int sch_nr_encode(srsran_sch_nr_t*        q,
                 tb->rv,
                 cfg.Qm,
                 cfg.Nref);
-    srsran_ldpc_rm_tx(&q->tx_rm, rm_buffer, output_ptr, E, cfg.bg, cfg.Z, tb->rv, tb->mod, cfg.Nref);
-    output_ptr += E;
+    if (packed) {
+      // Bit selection and interleaving straight from the packed codeword
+      if (srsran_ldpc_rm_tx_packed(&q->tx_rm,
+                                   rm_buffer,
+                                   &e_bits[e_idx / 8],
+                                   e_idx % 8,
+                                   E,
+                                   cfg.F,
+                                   cfg.bg,
+                                   cfg.Z,
+                                   tb->rv,
+                                   tb->mod,
+                                   cfg.Nref) < SRSRAN_SUCCESS) {
+        ERROR("Error in LDPC rate matching");
+        return SRSRAN_ERROR;
+      }
+    } else {
+      srsran_ldpc_rm_tx(&q->tx_rm, rm_buffer, &e_bits[e_idx], E, cfg.bg, cfg.Z, tb->rv, tb->mod, cfg.Nref);
+    }
+    e_idx += E;
   }
 
   return SRSRAN_SUCCESS;
@@ -603,6 +858,13 @@ static int sch_nr_decode(srsran_sch_nr_t*        q,
     return SRSRAN_ERROR;
   }
 
+  // Select the maximum number of iterations for this transmission
+  uint32_t default_max_nof_iter = decoder->max_nof_iter;
+  uint32_t max_nof_iter         = default_max_nof_iter;
+  if (sch_cfg->max_nof_iter > 0 && sch_cfg->max_nof_iter < default_max_nof_iter) {
+    max_nof_iter = sch_cfg->max_nof_iter;
+  }
+
   // Counter of code blocks that have matched CRC
   uint32_t cb_ok = 0;
   res->crc       = false;
@@ -661,14 +923,16 @@ static int sch_nr_decode(srsran_sch_nr_t*        q,
     }
 
     // Decode. if CRC=KO, then ret=0
-    int ret = srsran_ldpc_decoder_decode_crc_c(decoder, rm_buffer, q->temp_cb, n_llr, crc);
+    decoder->max_nof_iter = max_nof_iter;
+    int ret               = srsran_ldpc_decoder_decode_crc_c(decoder, rm_buffer, q->temp_cb, n_llr, crc);
+    decoder->max_nof_iter = default_max_nof_iter;
     if (ret < SRSRAN_SUCCESS) {
       ERROR("Error decoding CB");
       return SRSRAN_ERROR;
     }
 
     // Compute number of iterations
-    uint32_t n_iter_cb = (ret == 0) ? decoder->max_nof_iter : (uint32_t)ret;
+    uint32_t n_iter_cb = (ret == 0) ? max_nof_iter : (uint32_t)ret;
     nof_iter_sum += n_iter_cb;
 
     // Check if CB is all zeros
@@ -755,7 +1019,16 @@ int srsran_dlsch_nr_encode(srsran_sch_nr_t*        q,
                            const uint8_t*          data,
                            uint8_t*                e_bits)
 {
-  return sch_nr_encode(q, pdsch_cfg, tb, data, e_bits);
+  return sch_nr_encode(q, pdsch_cfg, tb, data, e_bits, false);
+}
+
+int srsran_dlsch_nr_encode_packed(srsran_sch_nr_t*        q,
+                                  const srsran_sch_cfg_t* pdsch_cfg,
+                                  const srsran_sch_tb_t*  tb,
+                                  const uint8_t*          data,
+                                  uint8_t*                e_bytes)
+{
+  return sch_nr_encode(q, pdsch_cfg, tb, data, e_bytes, true);
 }
 
 int srsran_dlsch_nr_decode(srsran_sch_nr_t*        q,
@@ -773,7 +1046,7 @@ int srsran_ulsch_nr_encode(srsran_sch_nr_t*        q,
                            const uint8_t*          data,
                            uint8_t*                e_bits)
 {
-  return sch_nr_encode(q, pdsch_cfg, tb, data, e_bits);
+  return sch_nr_encode(q, pdsch_cfg, tb, data, e_bits, false);
 }
 
 int srsran_ulsch_nr_decode(srsran_sch_nr_t*        q,
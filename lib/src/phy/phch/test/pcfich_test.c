@@ -147,6 +147,11 @@ int main(int argc, char** argv)
           exit(-1);
         }
         INFO("cfi_tx: %d, cfi_rx: %d, ns: %d, distance: %f", cfi, dl_sf.cfi, nsf, corr_res);
+        // The ports are combined with an identity channel, which only 1 and 2 port diversity decodes back
+        if (cell.nof_ports <= 2 && dl_sf.cfi != cfi) {
+          ERROR("Decoded CFI %d does not match transmitted CFI %d in subframe %d", dl_sf.cfi, cfi, nsf);
+          exit(-1);
+        }
       }
     }
     srsran_pcfich_free(&pcfich);
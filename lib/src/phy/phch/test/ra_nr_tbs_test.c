@@ -0,0 +1,289 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/common/test_common.h"
+#include "srsran/phy/phch/ra_nr.h"
+#include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/vector.h"
+#include <math.h>
+#include <sys/time.h>
+
+// TS 38.214 Table 5.1.3.2-1
+static const uint32_t tbs_table_ref[93] = {
+    24,   32,   40,   48,   56,   64,   72,   80,   88,   96,   104,  112,  120,  128,  136,  144,
+    152,  160,  168,  176,  184,  192,  208,  224,  240,  256,  272,  288,  304,  320,  336,  352,
+    368,  384,  408,  432,  456,  480,  504,  528,  552,  576,  608,  640,  672,  704,  736,  768,
+    808,  848,  888,  928,  984,  1032, 1064, 1128, 1160, 1192, 1224, 1256, 1288, 1320, 1352, 1416,
+    1480, 1544, 1608, 1672, 1736, 1800, 1864, 1928, 2024, 2088, 2152, 2216, 2280, 2408, 2472, 2536,
+    2600, 2664, 2728, 2792, 2856, 2976, 3104, 3240, 3368, 3496, 3624, 3752, 3824};
+
+/// TS 38.214 5.1.3.2 steps 2 to 4, computed per call as the PHY used to before the TBS lookup
+static uint32_t tbs_ref(uint32_t N_re, double S, double R, uint32_t Qm, uint32_t nof_layers)
+{
+  if (!isnormal(S)) {
+    S = 1.0;
+  }
+  uint32_t n_info = (uint32_t)(N_re * S * R * Qm * nof_layers);
+
+  if (n_info <= 3824) {
+    uint32_t n            = (uint32_t)SRSRAN_MAX(3.0, floor(log2(n_info)) - 6.0);
+    uint32_t n_info_prime = SRSRAN_MAX(tbs_table_ref[0], (1U << n) * SRSRAN_FLOOR(n_info, (1U << n)));
+    for (uint32_t i = 0; i < 93; i++) {
+      if (n_info_prime <= tbs_table_ref[i]) {
+        return tbs_table_ref[i];
+      }
+    }
+    return tbs_table_ref[92];
+  }
+
+  uint32_t n            = (uint32_t)(floor(log2(n_info - 24.0)) - 5.0);
+  uint32_t n_info_prime = SRSRAN_MAX(3840, (1U << n) * SRSRAN_ROUND(n_info - 24.0, (1U << n)));
+  if (R <= 0.25) {
+    uint32_t C = SRSRAN_CEIL(n_info_prime + 24U, 3816U);
+    return 8U * C * SRSRAN_CEIL(n_info_prime + 24U, 8U * C) - 24U;
+  }
+  if (n_info_prime > 8424) {
+    uint32_t C = SRSRAN_CEIL(n_info_prime + 24U, 8424U);
+    return 8U * C * SRSRAN_CEIL(n_info_prime + 24U, 8U * C) - 24U;
+  }
+  return 8U * SRSRAN_CEIL(n_info_prime + 24U, 8U) - 24U;
+}
+
+int test_tbs()
+{
+  // Every N_info up to the largest grant (275 PRB, 156 RE per PRB, 8 bit/symbol, 4 layers) in both rate regions
+  uint32_t max_n_info = SRSRAN_MAX_PRB_NR * SRSRAN_MAX_NRE_NR * 8 * 4;
+  for (uint32_t n_info = 0; n_info <= max_n_info; n_info++) {
+    TESTASSERT(srsran_ra_nr_tbs(n_info, 1.0, 0.25, 4, 1) == tbs_ref(n_info, 1.0, 0.25, 4, 1));
+    TESTASSERT(srsran_ra_nr_tbs(n_info, 1.0, 0.5, 2, 1) == tbs_ref(n_info, 1.0, 0.5, 2, 1));
+  }
+
+  // Grants of every MCS table, MCS, number of PRB, RE per PRB, TB scaling and layers
+  struct timeval t[3];
+  uint64_t       time_lut = 0, time_ref = 0;
+  uint32_t       count    = 0;
+  for (srsran_mcs_table_t table = srsran_mcs_table_64qam; table < srsran_mcs_table_N; table++) {
+    for (uint32_t mcs = 0; mcs < 32; mcs++) {
+      double       R = srsran_ra_nr_R_from_mcs(table, srsran_dci_format_nr_1_1, srsran_search_space_type_ue, 0, mcs);
+      srsran_mod_t m = srsran_ra_nr_mod_from_mcs(table, srsran_dci_format_nr_1_1, srsran_search_space_type_ue, 0, mcs);
+      if (!isnormal(R) || m >= SRSRAN_MOD_NITEMS) {
+        continue;
+      }
+      uint32_t Qm = srsran_mod_bits_x_symbol(m);
+      for (uint32_t nof_layers = 1; nof_layers <= 4; nof_layers++) {
+        for (double S = 0.25; S <= 1.0; S *= 2) {
+          for (uint32_t n_re_prb = 6; n_re_prb <= SRSRAN_MAX_NRE_NR; n_re_prb += 6) {
+            uint32_t tbs[SRSRAN_MAX_PRB_NR], tbs_expected[SRSRAN_MAX_PRB_NR];
+            gettimeofday(&t[1], NULL);
+            for (uint32_t nof_prb = 1; nof_prb <= SRSRAN_MAX_PRB_NR; nof_prb++) {
+              tbs[nof_prb - 1] = srsran_ra_nr_tbs(n_re_prb * nof_prb, S, R, Qm, nof_layers);
+            }
+            gettimeofday(&t[2], NULL);
+            get_time_interval(t);
+            time_lut += t[0].tv_sec * 1000000UL + t[0].tv_usec;
+
+            gettimeofday(&t[1], NULL);
+            for (uint32_t nof_prb = 1; nof_prb <= SRSRAN_MAX_PRB_NR; nof_prb++) {
+              tbs_expected[nof_prb - 1] = tbs_ref(n_re_prb * nof_prb, S, R, Qm, nof_layers);
+            }
+            gettimeofday(&t[2], NULL);
+            get_time_interval(t);
+            time_ref += t[0].tv_sec * 1000000UL + t[0].tv_usec;
+
+            TESTASSERT(memcmp(tbs, tbs_expected, sizeof(tbs)) == 0);
+            count += SRSRAN_MAX_PRB_NR;
+          }
+        }
+      }
+    }
+  }
+
+  printf("TBS of %d grants bit-exact; %.1f ns/grant with lookup, %.1f ns/grant computed\n",
+         count,
+         1000.0 * time_lut / count,
+         1000.0 * time_ref / count);
+
+  return SRSRAN_SUCCESS;
+}
+
+static void tb_cache_set_time_ra(srsran_sch_time_ra_t* ra, srsran_sch_mapping_type_t mapping, uint32_t S, uint32_t L)
+{
+  ra->k            = 0;
+  ra->mapping_type = mapping;
+  ra->sliv         = srsran_ra_nr_type1_riv(SRSRAN_NSYMB_PER_SLOT_NR, S, L);
+}
+
+static int tb_cache_dci_to_grant(const srsran_sch_hl_cfg_nr_t* hl_cfg,
+                                 bool                          dl,
+                                 srsran_dci_format_nr_t        format,
+                                 uint32_t                      m,
+                                 uint32_t                      ports,
+                                 uint32_t                      mcs,
+                                 uint32_t                      nof_prb,
+                                 srsran_sch_cfg_nr_t*          cfg)
+{
+  srsran_carrier_nr_t carrier = {};
+  carrier.nof_prb             = 52;
+  srsran_slot_cfg_t slot      = {};
+
+  srsran_dci_ctx_t ctx = {};
+  ctx.format           = format;
+  ctx.rnti_type        = srsran_rnti_type_c;
+  ctx.rnti             = 0x4601;
+  ctx.ss_type          = srsran_search_space_type_ue;
+  ctx.coreset_id       = 1;
+
+  if (dl) {
+    srsran_dci_dl_nr_t dci    = {};
+    dci.ctx                   = ctx;
+    dci.time_domain_assigment = m;
+    dci.freq_domain_assigment = srsran_ra_nr_type1_riv(carrier.nof_prb, 0, nof_prb);
+    dci.mcs                   = mcs;
+    dci.ports                 = ports;
+    return srsran_ra_dl_dci_to_grant_nr(&carrier, &slot, hl_cfg, &dci, cfg, &cfg->grant);
+  }
+
+  srsran_dci_ul_nr_t dci    = {};
+  dci.ctx                   = ctx;
+  dci.time_domain_assigment = m;
+  dci.freq_domain_assigment = srsran_ra_nr_type1_riv(carrier.nof_prb, 0, nof_prb);
+  dci.mcs                   = mcs;
+  dci.ports                 = ports;
+  return srsran_ra_ul_dci_to_grant_nr(&carrier, &slot, hl_cfg, &dci, cfg, &cfg->grant);
+}
+
+/// Grants converted from DCI with and without the cache must match field by field
+static int
+test_tb_cache_cfg(const srsran_sch_hl_cfg_nr_t* hl_cfg_ref, bool dl, uint64_t* time_cache, uint64_t* time_ref)
+{
+  srsran_ra_nr_tb_cache_t cache = {};
+  TESTASSERT(srsran_ra_nr_tb_cache_init(&cache, hl_cfg_ref, 52) == SRSRAN_SUCCESS);
+  TESTASSERT(cache.nof_nre > 0);
+
+  srsran_sch_hl_cfg_nr_t hl_cfg = *hl_cfg_ref;
+  hl_cfg.tb_cache               = &cache;
+
+  srsran_dci_format_nr_t formats[2] = {srsran_dci_format_nr_1_0, srsran_dci_format_nr_1_1};
+  if (!dl) {
+    formats[0] = srsran_dci_format_nr_0_0;
+    formats[1] = srsran_dci_format_nr_0_1;
+  }
+
+  for (uint32_t f = 0; f < 2; f++) {
+    for (uint32_t m = 0; m < hl_cfg.nof_dedicated_time_ra; m++) {
+      for (uint32_t ports = 0; ports < 3; ports++) {
+        for (uint32_t mcs = 0; mcs < 28; mcs++) {
+          for (uint32_t nof_prb = 1; nof_prb <= 52; nof_prb += 3) {
+            srsran_sch_cfg_nr_t cfg_ref = {}, cfg = {};
+            struct timeval      t[3];
+
+            gettimeofday(&t[1], NULL);
+            int ret_ref = tb_cache_dci_to_grant(hl_cfg_ref, dl, formats[f], m, ports, mcs, nof_prb, &cfg_ref);
+            gettimeofday(&t[2], NULL);
+            get_time_interval(t);
+            *time_ref += t[0].tv_sec * 1000000UL + t[0].tv_usec;
+
+            gettimeofday(&t[1], NULL);
+            int ret = tb_cache_dci_to_grant(&hl_cfg, dl, formats[f], m, ports, mcs, nof_prb, &cfg);
+            gettimeofday(&t[2], NULL);
+            get_time_interval(t);
+            *time_cache += t[0].tv_sec * 1000000UL + t[0].tv_usec;
+
+            TESTASSERT(ret == ret_ref);
+            if (ret < SRSRAN_SUCCESS) {
+              continue;
+            }
+            const srsran_sch_tb_t* tb_ref = &cfg_ref.grant.tb[0];
+            const srsran_sch_tb_t* tb     = &cfg.grant.tb[0];
+            TESTASSERT(tb->tbs == tb_ref->tbs);
+            TESTASSERT(tb->R == tb_ref->R);
+            TESTASSERT(tb->R_prime == tb_ref->R_prime);
+            TESTASSERT(tb->mod == tb_ref->mod);
+            TESTASSERT(tb->N_L == tb_ref->N_L);
+            TESTASSERT(tb->nof_re == tb_ref->nof_re);
+            TESTASSERT(tb->nof_bits == tb_ref->nof_bits);
+          }
+        }
+      }
+    }
+  }
+
+  // Offset every cached TBS to check the conversion reads the cache
+  srsran_sch_cfg_nr_t cfg_ref = {}, cfg = {};
+  for (uint32_t t = 0; t < SRSRAN_RA_NR_TB_CACHE_NOF_TABLES; t++) {
+    for (uint32_t i = 0; cache.tb[t] != NULL && i < SRSRAN_RA_NR_TB_CACHE_NOF_MCS * cache.nof_nre * 52; i++) {
+      cache.tb[t][i].tbs += 8;
+    }
+  }
+  TESTASSERT(tb_cache_dci_to_grant(hl_cfg_ref, dl, formats[1], 0, 0, 10, 20, &cfg_ref) == SRSRAN_SUCCESS);
+  TESTASSERT(tb_cache_dci_to_grant(&hl_cfg, dl, formats[1], 0, 0, 10, 20, &cfg) == SRSRAN_SUCCESS);
+  TESTASSERT(cfg.grant.tb[0].tbs == cfg_ref.grant.tb[0].tbs + 8);
+
+  srsran_ra_nr_tb_cache_free(&cache);
+  return SRSRAN_SUCCESS;
+}
+
+int test_tb_cache()
+{
+  uint64_t time_cache = 0, time_ref = 0;
+
+  srsran_sch_hl_cfg_nr_t hl_cfg    = {};
+  hl_cfg.typeA_pos                 = srsran_dmrs_sch_typeA_pos_2;
+  hl_cfg.alloc                     = srsran_resource_alloc_type1;
+  hl_cfg.dmrs_type                 = srsran_dmrs_sch_type_1;
+  hl_cfg.dmrs_max_length           = srsran_dmrs_sch_len_1;
+  hl_cfg.dmrs_typeA.present        = true;
+  hl_cfg.dmrs_typeA.additional_pos = srsran_dmrs_sch_add_pos_2;
+  hl_cfg.nof_common_time_ra        = 1;
+  hl_cfg.nof_dedicated_time_ra     = 3;
+  tb_cache_set_time_ra(&hl_cfg.common_time_ra[0], srsran_sch_mapping_type_A, 0, 13);
+  tb_cache_set_time_ra(&hl_cfg.dedicated_time_ra[0], srsran_sch_mapping_type_A, 0, 14);
+  tb_cache_set_time_ra(&hl_cfg.dedicated_time_ra[1], srsran_sch_mapping_type_A, 0, 12);
+  tb_cache_set_time_ra(&hl_cfg.dedicated_time_ra[2], srsran_sch_mapping_type_A, 0, 5);
+
+  // 64QAM table, dedicated and fallback DMRS
+  hl_cfg.mcs_table = srsran_mcs_table_64qam;
+  TESTASSERT(test_tb_cache_cfg(&hl_cfg, true, &time_cache, &time_ref) == SRSRAN_SUCCESS);
+  TESTASSERT(test_tb_cache_cfg(&hl_cfg, false, &time_cache, &time_ref) == SRSRAN_SUCCESS);
+
+  // 256QAM table and other dedicated DMRS
+  hl_cfg.mcs_table                 = srsran_mcs_table_256qam;
+  hl_cfg.dmrs_typeA.additional_pos = srsran_dmrs_sch_add_pos_1;
+  TESTASSERT(test_tb_cache_cfg(&hl_cfg, true, &time_cache, &time_ref) == SRSRAN_SUCCESS);
+  TESTASSERT(test_tb_cache_cfg(&hl_cfg, false, &time_cache, &time_ref) == SRSRAN_SUCCESS);
+
+  // Low SE table with the most DMRS symbols
+  hl_cfg.mcs_table                 = srsran_mcs_table_qam64LowSE;
+  hl_cfg.dmrs_typeA.additional_pos = srsran_dmrs_sch_add_pos_3;
+  TESTASSERT(test_tb_cache_cfg(&hl_cfg, true, &time_cache, &time_ref) == SRSRAN_SUCCESS);
+  TESTASSERT(test_tb_cache_cfg(&hl_cfg, false, &time_cache, &time_ref) == SRSRAN_SUCCESS);
+
+  printf("DCI to grant with TB cache %.1f us, without %.1f us\n", time_cache / 1000.0, time_ref / 1000.0);
+
+  return SRSRAN_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  TESTASSERT(test_tbs() == SRSRAN_SUCCESS);
+  TESTASSERT(test_tb_cache() == SRSRAN_SUCCESS);
+  return SRSRAN_SUCCESS;
+}
@@ -22,6 +22,7 @@
 #include "srsran/phy/phch/ra_dl_nr.h"
 #include "srsran/phy/phch/ra_nr.h"
 #include "srsran/phy/phch/sch_nr.h"
+#include "srsran/phy/utils/bit.h"
 #include "srsran/phy/utils/debug.h"
 #include "srsran/phy/utils/vector.h"
 #include <getopt.h>
@@ -29,10 +30,11 @@
 
 static srsran_carrier_nr_t carrier = SRSRAN_DEFAULT_CARRIER_NR;
 
-static uint32_t            n_prb     = 0;  // Set to 0 for steering
-static uint32_t            mcs       = 30; // Set to 30 for steering
-static uint32_t            rv        = 4;  // Set to 30 for steering
-static srsran_sch_cfg_nr_t pdsch_cfg = {};
+static uint32_t            n_prb         = 0;  // Set to 0 for steering
+static uint32_t            mcs           = 30; // Set to 30 for steering
+static uint32_t            rv            = 4;  // Set to 30 for steering
+static uint32_t            nof_coworkers = 0;
+static srsran_sch_cfg_nr_t pdsch_cfg     = {};
 
 static void usage(char* prog)
 {
@@ -44,13 +46,14 @@ static void usage(char* prog)
   printf("\t-T Provide MCS table (64qam, 256qam, 64qamLowSE) [Default %s]\n",
          srsran_mcs_table_to_str(pdsch_cfg.sch_cfg.mcs_table));
   printf("\t-L Provide number of layers [Default %d]\n", carrier.max_mimo_layers);
+  printf("\t-W Number of encoder coworker threads [Default %d]\n", nof_coworkers);
   printf("\t-v [set srsran_verbose to debug, default none]\n");
 }
 
 int parse_args(int argc, char** argv)
 {
   int opt;
-  while ((opt = getopt(argc, argv, "PpmTLvr")) != -1) {
+  while ((opt = getopt(argc, argv, "PpmTLvrW")) != -1) {
     switch (opt) {
       case 'P':
         carrier.nof_prb = (uint32_t)strtol(argv[optind], NULL, 10);
@@ -70,6 +73,9 @@ int parse_args(int argc, char** argv)
       case 'L':
         carrier.max_mimo_layers = (uint32_t)strtol(argv[optind], NULL, 10);
         break;
+      case 'W':
+        nof_coworkers = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
       case 'v':
         increase_srsran_verbose_level();
         break;
@@ -89,10 +95,12 @@ int main(int argc, char** argv)
   srsran_sch_nr_t sch_nr_rx = {};
   srsran_random_t rand_gen  = srsran_random_init(1234);
 
-  uint8_t* data_tx = srsran_vec_u8_malloc(1024 * 1024);
-  uint8_t* encoded = srsran_vec_u8_malloc(1024 * 1024 * 8);
-  int8_t*  llr     = srsran_vec_i8_malloc(1024 * 1024 * 8);
-  uint8_t* data_rx = srsran_vec_u8_malloc(1024 * 1024);
+  uint8_t* data_tx          = srsran_vec_u8_malloc(1024 * 1024);
+  uint8_t* encoded          = srsran_vec_u8_malloc(1024 * 1024 * 8);
+  uint8_t* encoded_packed   = srsran_vec_u8_malloc(1024 * 1024);
+  uint8_t* encoded_unpacked = srsran_vec_u8_malloc(1024 * 1024 * 8);
+  int8_t*  llr              = srsran_vec_i8_malloc(1024 * 1024 * 8);
+  uint8_t* data_rx          = srsran_vec_u8_malloc(1024 * 1024);
 
   // Set default PDSCH configuration
   pdsch_cfg.sch_cfg.mcs_table = srsran_mcs_table_64qam;
@@ -101,7 +109,7 @@ int main(int argc, char** argv)
     goto clean_exit;
   }
 
-  if (data_tx == NULL || data_rx == NULL) {
+  if (data_tx == NULL || data_rx == NULL || encoded_packed == NULL || encoded_unpacked == NULL) {
     goto clean_exit;
   }
 
@@ -110,6 +118,7 @@ int main(int argc, char** argv)
   args.decoder_use_flooded    = false;
   args.decoder_scaling_factor = 0.8;
   args.max_nof_iter           = 20;
+  args.nof_encoder_coworkers  = nof_coworkers;
   if (srsran_sch_nr_init_tx(&sch_nr_tx, &args) < SRSRAN_SUCCESS) {
     ERROR("Error initiating SCH NR for Tx");
     goto clean_exit;
@@ -199,6 +208,33 @@ int main(int argc, char** argv)
           goto clean_exit;
         }
 
+        // The packed-bit encoder must give the same codeword
+        if (srsran_dlsch_nr_encode_packed(&sch_nr_tx, &pdsch_cfg.sch_cfg, &tb, data_tx, encoded_packed) <
+            SRSRAN_SUCCESS) {
+          ERROR("Error encoding packed");
+          goto clean_exit;
+        }
+        srsran_bit_unpack_vector(encoded_packed, encoded_unpacked, (int)tb.nof_bits);
+        if (memcmp(encoded, encoded_unpacked, tb.nof_bits) != 0) {
+          ERROR("Failed to match packed encoding; n_prb=%d; mcs=%d; TBS=%d; rv=%d;", n_prb, mcs, tb.tbs, rv);
+          goto clean_exit;
+        }
+
+        // A retransmission of the same TB reuses the encoded code blocks, whatever the data
+        if (rv != 0) {
+          uint64_t nof_hit = sch_nr_tx.nof_tx_cache_hit;
+          if (srsran_dlsch_nr_encode_packed(&sch_nr_tx, &pdsch_cfg.sch_cfg, &tb, data_rx, encoded_packed) <
+              SRSRAN_SUCCESS) {
+            ERROR("Error encoding packed retransmission");
+            goto clean_exit;
+          }
+          srsran_bit_unpack_vector(encoded_packed, encoded_unpacked, (int)tb.nof_bits);
+          if (sch_nr_tx.nof_tx_cache_hit != nof_hit + 1 || memcmp(encoded, encoded_unpacked, tb.nof_bits) != 0) {
+            ERROR("Failed to reuse the encoded TB; n_prb=%d; mcs=%d; TBS=%d; rv=%d;", n_prb, mcs, tb.tbs, rv);
+            goto clean_exit;
+          }
+        }
+
         for (uint32_t i = 0; i < tb.nof_bits; i++) {
           llr[i] = encoded[i] ? -10 : +10;
         }
@@ -252,6 +288,12 @@ clean_exit:
   if (encoded) {
     free(encoded);
   }
+  if (encoded_packed) {
+    free(encoded_packed);
+  }
+  if (encoded_unpacked) {
+    free(encoded_unpacked);
+  }
   srsran_softbuffer_tx_free(&softbuffer_tx);
   srsran_softbuffer_rx_free(&softbuffer_rx);
 
@@ -0,0 +1,251 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <complex.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "srsran/phy/resampling/channelizer.h"
+#include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/vector.h"
+
+/**
+ * Minimum prototype filter length in multiples of the decimation, rounded up to a multiple of the number of channels
+ */
+#define CHANNELIZER_TAPS_PER_DECIMATION 16
+
+/**
+ * Number of outputs computed together, with a single batched DFT, before the input delay line is shifted
+ */
+#define CHANNELIZER_BLOCK_OUTPUTS 64
+
+static uint32_t channelizer_gcd(uint32_t a, uint32_t b)
+{
+  while (b != 0) {
+    uint32_t t = a % b;
+    a          = b;
+    b          = t;
+  }
+  return a;
+}
+
+int srsran_channelizer_init(srsran_channelizer_t* q, uint32_t nof_channels, uint32_t decimation)
+{
+  if (q == NULL || nof_channels == 0 || decimation == 0 || decimation > nof_channels) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  SRSRAN_MEM_ZERO(q, srsran_channelizer_t, 1);
+
+  uint32_t M      = nof_channels;
+  uint32_t D      = decimation;
+  q->nof_channels = M;
+  q->decimation   = D;
+  q->nof_taps     = M * SRSRAN_CEIL(CHANNELIZER_TAPS_PER_DECIMATION * D, M);
+
+  // Windowed sinc prototype with cut-off at half the output rate, Blackman-Harris window. Stored time reversed, so
+  // that it is applied to the delay line in increasing time order
+  q->taps = srsran_vec_f_malloc(q->nof_taps);
+  if (q->taps == NULL) {
+    srsran_channelizer_free(q);
+    return SRSRAN_ERROR;
+  }
+  double fc   = 0.5 / (double)D;
+  double half = (double)(q->nof_taps - 1) / 2.0;
+  double sum  = 0.0;
+  for (uint32_t i = 0; i < q->nof_taps; i++) {
+    double t = (double)i - half;
+    double x = 2.0 * M_PI * (double)i / (double)(q->nof_taps - 1);
+    double w = 0.35875 - 0.48829 * cos(x) + 0.14128 * cos(2.0 * x) - 0.01168 * cos(3.0 * x);
+    double h = (fabs(t) < 1e-9) ? 2.0 * fc : sin(2.0 * M_PI * fc * t) / (M_PI * t);
+    q->taps[q->nof_taps - 1 - i] = (float)(h * w);
+    sum += h * w;
+  }
+  srsran_vec_sc_prod_fff(q->taps, (float)(1.0 / sum), q->taps, q->nof_taps);
+
+  q->fft_in  = srsran_vec_cf_malloc(M * CHANNELIZER_BLOCK_OUTPUTS);
+  q->fft_out = srsran_vec_cf_malloc(M * CHANNELIZER_BLOCK_OUTPUTS);
+  q->tmp     = srsran_vec_cf_malloc(M);
+  if (q->fft_in == NULL || q->fft_out == NULL || q->tmp == NULL) {
+    srsran_channelizer_free(q);
+    return SRSRAN_ERROR;
+  }
+  srsran_vec_cf_zero(q->fft_in, M * CHANNELIZER_BLOCK_OUTPUTS);
+  if (srsran_dft_plan_guru_c(
+          &q->fft, (int)M, SRSRAN_DFT_FORWARD, q->fft_in, q->fft_out, 1, 1, CHANNELIZER_BLOCK_OUTPUTS, M, M) !=
+      SRSRAN_SUCCESS) {
+    ERROR("Error initialising channelizer DFT");
+    srsran_channelizer_free(q);
+    return SRSRAN_ERROR;
+  }
+
+  // Output n of channel k is rotated by exp(-j2pi k (nD + 1) / M), which repeats every M / gcd(M, D) outputs
+  q->nof_rows = M / channelizer_gcd(M, D);
+  q->phase    = srsran_vec_cf_malloc(q->nof_rows * M);
+  if (q->phase == NULL) {
+    srsran_channelizer_free(q);
+    return SRSRAN_ERROR;
+  }
+  for (uint32_t r = 0; r < q->nof_rows; r++) {
+    uint32_t n = (r * D + 1) % M;
+    for (uint32_t k = 0; k < M; k++) {
+      double arg          = -2.0 * M_PI * (double)((k * n) % M) / (double)M;
+      q->phase[r * M + k] = (float)cos(arg) + I * (float)sin(arg);
+    }
+  }
+
+  // Room for the filter history and the input of a block of outputs
+  q->buffer_sz = q->nof_taps - 1 + CHANNELIZER_BLOCK_OUTPUTS * D;
+  q->buffer    = srsran_vec_cf_malloc(q->buffer_sz);
+  if (q->buffer == NULL) {
+    srsran_channelizer_free(q);
+    return SRSRAN_ERROR;
+  }
+
+  srsran_channelizer_reset(q);
+
+  return SRSRAN_SUCCESS;
+}
+
+void srsran_channelizer_reset(srsran_channelizer_t* q)
+{
+  if (q == NULL || q->buffer == NULL) {
+    return;
+  }
+
+  // The delay line starts with the filter history zeroed, so that the first output corresponds to the first input
+  q->buffer_len = q->nof_taps - 1;
+  q->row        = 0;
+  srsran_vec_cf_zero(q->buffer, q->buffer_sz);
+}
+
+float srsran_channelizer_get_freq(const srsran_channelizer_t* q, uint32_t channel_idx)
+{
+  if (q == NULL || q->nof_channels == 0) {
+    return 0.0f;
+  }
+
+  int32_t k = (int32_t)(channel_idx % q->nof_channels);
+  if (k >= (int32_t)(q->nof_channels + 1) / 2) {
+    k -= (int32_t)q->nof_channels;
+  }
+  return (float)k / (float)q->nof_channels;
+}
+
+/* Polyphase filter: every branch of M taps is applied to its own M samples of the window and the branches are added */
+static void channelizer_polyphase(srsran_channelizer_t* q, const cf_t* window, cf_t* fft_in)
+{
+  uint32_t M = q->nof_channels;
+
+  srsran_vec_prod_cfc(window, q->taps, fft_in, M);
+  for (uint32_t l = M; l < q->nof_taps; l += M) {
+    srsran_vec_prod_cfc(&window[l], &q->taps[l], q->tmp, M);
+    srsran_vec_sum_ccc(fft_in, q->tmp, fft_in, M);
+  }
+}
+
+/* Computes nof_outputs samples of every channel, one every decimation samples of the delay line */
+static void channelizer_block(srsran_channelizer_t* q, cf_t** output, uint32_t idx, uint32_t nof_outputs)
+{
+  uint32_t M = q->nof_channels;
+
+  for (uint32_t b = 0; b < nof_outputs; b++) {
+    channelizer_polyphase(q, &q->buffer[b * q->decimation], &q->fft_in[b * M]);
+  }
+
+  // Every DFT bin is one channel, brought to baseband by the phase correction
+  srsran_dft_run_guru_c(&q->fft);
+  for (uint32_t b = 0; b < nof_outputs; b++) {
+    srsran_vec_prod_ccc(&q->fft_out[b * M], &q->phase[q->row * M], &q->fft_out[b * M], M);
+    q->row = (q->row + 1) % q->nof_rows;
+  }
+
+  for (uint32_t k = 0; k < M; k++) {
+    if (output[k] != NULL) {
+      for (uint32_t b = 0; b < nof_outputs; b++) {
+        output[k][idx + b] = q->fft_out[b * M + k];
+      }
+    }
+  }
+}
+
+uint32_t srsran_channelizer_run(srsran_channelizer_t* q, const cf_t* input, uint32_t nsamples, cf_t** output)
+{
+  uint32_t count = 0;
+
+  if (q == NULL || input == NULL || output == NULL || q->buffer == NULL) {
+    return 0;
+  }
+
+  while (nsamples > 0) {
+    // Fill the delay line
+    uint32_t n = SRSRAN_MIN(nsamples, q->buffer_sz - q->buffer_len);
+    srsran_vec_cf_copy(&q->buffer[q->buffer_len], input, n);
+    q->buffer_len += n;
+    input += n;
+    nsamples -= n;
+
+    // One output every decimation samples, for as long as there is a full filter length
+    if (q->buffer_len < q->nof_taps) {
+      continue;
+    }
+    uint32_t nof_outputs = (q->buffer_len - q->nof_taps) / q->decimation + 1;
+    channelizer_block(q, output, count, nof_outputs);
+    count += nof_outputs;
+
+    // Keep the samples not consumed yet
+    uint32_t pos = nof_outputs * q->decimation;
+    q->buffer_len -= pos;
+    memmove(q->buffer, &q->buffer[pos], sizeof(cf_t) * q->buffer_len);
+  }
+
+  return count;
+}
+
+void srsran_channelizer_free(srsran_channelizer_t* q)
+{
+  if (q == NULL) {
+    return;
+  }
+
+  srsran_dft_plan_free(&q->fft);
+  if (q->taps) {
+    free(q->taps);
+  }
+  if (q->fft_in) {
+    free(q->fft_in);
+  }
+  if (q->fft_out) {
+    free(q->fft_out);
+  }
+  if (q->tmp) {
+    free(q->tmp);
+  }
+  if (q->phase) {
+    free(q->phase);
+  }
+  if (q->buffer) {
+    free(q->buffer);
+  }
+
+  SRSRAN_MEM_ZERO(q, srsran_channelizer_t, 1);
+}
@@ -0,0 +1,196 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/phy/resampling/channelizer.h"
+#include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/vector.h"
+#include <complex.h>
+#include <getopt.h>
+#include <math.h>
+#include <stdlib.h>
+#include <sys/time.h>
+
+static uint32_t nof_channels = 96;
+static uint32_t decimation   = 5;
+static uint32_t buffer_size  = 96000;
+static uint32_t repetitions  = 1;
+
+static void usage(char* prog)
+{
+  printf("Usage: %s [mdsrv]\n", prog);
+  printf("\t-m Number of channels [Default %d]\n", nof_channels);
+  printf("\t-d Decimation [Default %d]\n", decimation);
+  printf("\t-s Input buffer size [Default %d]\n", buffer_size);
+  printf("\t-r Repetitions for timing [Default %d]\n", repetitions);
+  printf("\t-v increase verbosity\n");
+}
+
+static void parse_args(int argc, char** argv)
+{
+  int opt;
+
+  while ((opt = getopt(argc, argv, "mdsrv")) != -1) {
+    switch (opt) {
+      case 'm':
+        nof_channels = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'd':
+        decimation = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 's':
+        buffer_size = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'r':
+        repetitions = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'v':
+        increase_srsran_verbose_level();
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+/* Power of the samples of a channel around their mean, and the mean */
+static float channel_power(const cf_t* x, uint32_t len, cf_t* mean)
+{
+  cf_t acc = 0;
+  for (uint32_t i = 0; i < len; i++) {
+    acc += x[i];
+  }
+  *mean = acc / (float)len;
+  return srsran_vec_avg_power_cf(x, len);
+}
+
+int main(int argc, char** argv)
+{
+  struct timeval       t[3] = {};
+  srsran_channelizer_t q    = {};
+  int                  ret  = SRSRAN_ERROR;
+
+  parse_args(argc, argv);
+
+  if (srsran_channelizer_init(&q, nof_channels, decimation) < SRSRAN_SUCCESS) {
+    ERROR("Error initialising channelizer");
+    return SRSRAN_ERROR;
+  }
+
+  uint32_t M       = nof_channels;
+  uint32_t out_len = buffer_size / decimation + 1;
+
+  // A tone in the middle of a channel and a second one a third of a channel spacing away from another
+  uint32_t tone_channel  = M / 8;
+  uint32_t other_channel = M - M / 4;
+  float    tone_freq     = srsran_channelizer_get_freq(&q, tone_channel);
+  float    other_freq    = srsran_channelizer_get_freq(&q, other_channel) + 1.0f / (3.0f * M);
+
+  cf_t* input = srsran_vec_cf_malloc(buffer_size);
+  for (uint32_t i = 0; i < buffer_size; i++) {
+    // Phases in double precision, so that the tones are clean over the whole buffer
+    input[i] = (cf_t)(cexp(I * 2.0 * M_PI * tone_freq * i) + 0.5 * cexp(I * 2.0 * M_PI * other_freq * i));
+  }
+
+  cf_t* out[2][SRSRAN_MAX(M, 1)];
+  for (uint32_t i = 0; i < 2; i++) {
+    for (uint32_t k = 0; k < M; k++) {
+      out[i][k] = srsran_vec_cf_malloc(out_len);
+    }
+  }
+
+  // Whole buffer at once
+  gettimeofday(&t[1], NULL);
+  uint32_t nof_out = 0;
+  for (uint32_t r = 0; r < repetitions; r++) {
+    srsran_channelizer_reset(&q);
+    nof_out = srsran_channelizer_run(&q, input, buffer_size, out[0]);
+  }
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+  uint64_t duration_us = (uint64_t)(t[0].tv_sec * 1000000UL + t[0].tv_usec);
+
+  // Same input in blocks of varying size must give the same output
+  srsran_channelizer_reset(&q);
+  uint32_t nof_out_blocks = 0;
+  uint32_t count          = 0;
+  for (uint32_t b = 0; count < buffer_size; b++) {
+    uint32_t n = SRSRAN_MIN(1 + (b * 397) % 2000, buffer_size - count);
+    cf_t*    block_out[SRSRAN_MAX(M, 1)];
+    for (uint32_t k = 0; k < M; k++) {
+      block_out[k] = &out[1][k][nof_out_blocks];
+    }
+    nof_out_blocks += srsran_channelizer_run(&q, &input[count], n, block_out);
+    count += n;
+  }
+
+  float max_diff = 0.0f;
+  for (uint32_t k = 0; k < M; k++) {
+    for (uint32_t i = 0; i < SRSRAN_MIN(nof_out, nof_out_blocks); i++) {
+      max_diff = SRSRAN_MAX(max_diff, cabsf(out[0][k][i] - out[1][k][i]));
+    }
+  }
+
+  // Skip the filter transient
+  uint32_t skip = q.nof_taps / decimation + 1;
+  uint32_t len  = nof_out - skip;
+
+  // The tone is brought to DC in its channel
+  cf_t  mean      = 0;
+  float tone_pwr  = channel_power(&out[0][tone_channel][skip], len, &mean);
+  float tone_ampl = cabsf(mean);
+
+  // Channels whose passband is away from both tones only see the filter stopband
+  float    stop_pwr  = 0.0f;
+  uint32_t stop_dist = (3 * M) / (4 * decimation) + 1;
+  for (uint32_t k = 0; k < M; k++) {
+    uint32_t d1 = SRSRAN_MIN((k + M - tone_channel) % M, (tone_channel + M - k) % M);
+    uint32_t d2 = SRSRAN_MIN((k + M - other_channel) % M, (other_channel + M - k) % M);
+    if (d1 >= stop_dist && d2 >= stop_dist + 1) {
+      stop_pwr = SRSRAN_MAX(stop_pwr, channel_power(&out[0][k][skip], len, &mean));
+    }
+  }
+  float stop_db = srsran_convert_power_to_dB(stop_pwr);
+
+  printf("Done %.1f Msps; outputs=%d/%d; diff=%.2e; tone amplitude=%.4f power=%.4f; stopband=%.1f dB\n",
+         (double)buffer_size * repetitions / (double)duration_us,
+         nof_out,
+         nof_out_blocks,
+         max_diff,
+         tone_ampl,
+         tone_pwr,
+         stop_db);
+
+  if (nof_out == nof_out_blocks && max_diff < 1e-4f && fabsf(tone_ampl - 1.0f) < 0.01f &&
+      fabsf(tone_pwr - 1.0f) < 0.02f && stop_db < -60.0f) {
+    ret = SRSRAN_SUCCESS;
+  }
+
+  for (uint32_t i = 0; i < 2; i++) {
+    for (uint32_t k = 0; k < M; k++) {
+      free(out[i][k]);
+    }
+  }
+  free(input);
+  srsran_channelizer_free(&q);
+
+  return ret;
+}
@@ -58,7 +58,8 @@ clean:
   }
   return ret;
 #else  /* SRSRAN_CFO_USE_EXP_TABLE */
-  h->nsamples = nsamples;
+  h->nsamples  = nsamples;
+  h->nco_phase = 0.0;
   return SRSRAN_SUCCESS;
 #endif /* SRSRAN_CFO_USE_EXP_TABLE */
 }
@@ -127,6 +128,28 @@ void srsran_cfo_correct_offset(srsran_cfo_t* h,
   srsran_vec_prod_ccc(&h->cur_cexp[cexp_offset], input, output, nsamples);
 }
 
+void srsran_cfo_nco_correct(srsran_cfo_t* h,
+                            cf_t**        input,
+                            cf_t**        output,
+                            uint32_t      nof_channels,
+                            float         freq,
+                            uint32_t      nsamples)
+{
+  // The phase is kept in double precision and rebuilt at every call, so it does not drift with the number of calls
+  cf_t phase = (cf_t)cexp(I * 2.0 * M_PI * h->nco_phase);
+  for (uint32_t i = 0; i < nof_channels; i++) {
+    if (input[i] != NULL && output[i] != NULL) {
+      srsran_vec_apply_cfo_phase(input[i], freq, phase, output[i], nsamples);
+    }
+  }
+  h->nco_phase = fmod(h->nco_phase + (double)freq * nsamples, 1.0);
+}
+
+void srsran_cfo_nco_reset(srsran_cfo_t* h)
+{
+  h->nco_phase = 0.0;
+}
+
 float srsran_cfo_est_corr_cp(cf_t* input_buffer, uint32_t nof_prb)
 {
   int   nFFT         = srsran_symbol_sz(nof_prb);
@@ -134,16 +157,14 @@ float srsran_cfo_est_corr_cp(cf_t* input_buffer, uint32_t nof_prb)
   float tFFT         = (float)(1 / 15000.0);
   int   cp_size      = SRSRAN_CP_LEN_NORM(1, nFFT);
 
-  // Compensate for initial SC-FDMA half subcarrier shift
-  srsran_vec_apply_cfo(input_buffer, (float)(1 / (nFFT * 15e3)) * (15e3 / 2.0), input_buffer, sf_n_samples);
-
-  // Conjugate multiply the correlation inputs
-  cf_t cfo_estimated = srsran_vec_dot_prod_conj_ccc(&input_buffer[nFFT + SRSRAN_CP_LEN_NORM(0, nFFT)],
-                                                    &input_buffer[2 * nFFT + SRSRAN_CP_LEN_NORM(0, nFFT)],
-                                                    cp_size);
+  // Conjugate multiply the correlation inputs. The initial SC-FDMA half subcarrier shift rotates the correlation of two
+  // samples nFFT apart by half a cycle, so it is compensated by changing the sign
+  cf_t cfo_estimated = -srsran_vec_dot_prod_conj_ccc(&input_buffer[nFFT + SRSRAN_CP_LEN_NORM(0, nFFT)],
+                                                     &input_buffer[2 * nFFT + SRSRAN_CP_LEN_NORM(0, nFFT)],
+                                                     cp_size);
 
-  // CFO correction and compensation for initial SC-FDMA half subcarrier shift
+  // CFO correction in a single pass, the half subcarrier shift compensation and its removal cancel each other
   float cfo = (float)(-1 * carg(cfo_estimated) / (float)(2 * M_PI * tFFT));
-  srsran_vec_apply_cfo(input_buffer, (float)(1 / (nFFT * 15e3)) * ((-15e3 / 2.0) - cfo), input_buffer, sf_n_samples);
+  srsran_vec_apply_cfo(input_buffer, (float)(1 / (nFFT * 15e3)) * (-cfo), input_buffer, sf_n_samples);
   return cfo;
 }
@@ -389,6 +389,303 @@ void srsran_npss_synch_reset(srsran_npss_synch_t* q)
   }
 }
 
+/* Initializes the streaming NPSS detector for an input sampled with fft_size samples per OFDM symbol.
+ *
+ * The input is decimated down to SRSRAN_NPSS_STREAM_SYMBOL_SZ samples per symbol. At that rate the NPSS template is
+ * exactly the 1.92 MHz template taken one sample out of four, since the NPSS is far narrower than either rate.
+ */
+int srsran_npss_stream_init(srsran_npss_stream_t* q, uint32_t fft_size)
+{
+  int ret = SRSRAN_ERROR_INVALID_INPUTS;
+
+  if (q != NULL && fft_size >= SRSRAN_NPSS_STREAM_SYMBOL_SZ && fft_size % SRSRAN_NPSS_STREAM_SYMBOL_SZ == 0) {
+    ret = SRSRAN_ERROR;
+
+    memset(q, 0, sizeof(srsran_npss_stream_t));
+
+    q->fft_size   = fft_size;
+    q->decimation = fft_size / SRSRAN_NPSS_STREAM_SYMBOL_SZ;
+    q->frame_len  = SRSRAN_NOF_SF_X_FRAME * SRSRAN_SF_LEN(SRSRAN_NPSS_STREAM_SYMBOL_SZ);
+    q->ema_alpha  = 0.2;
+
+    uint32_t template_decimation = SRSRAN_NBIOT_FFT_SIZE / SRSRAN_NPSS_STREAM_SYMBOL_SZ;
+    q->filter_len                = SRSRAN_NPSS_CORR_FILTER_LEN / template_decimation;
+
+    // Largest block that fits the DFT and divides the frame, so that frames end with a block
+    for (q->step = SRSRAN_NPSS_STREAM_BLOCK_SZ - q->filter_len + 1; q->frame_len % q->step != 0; q->step--) {
+    }
+
+    if (q->decimation > 1) {
+      if (srsran_resampler_fft_init(&q->decimator, SRSRAN_RESAMPLER_MODE_DECIMATE, q->decimation)) {
+        fprintf(stderr, "Error initiating NPSS decimator\n");
+        goto clean_and_exit;
+      }
+      q->delay = srsran_resampler_fft_get_delay(&q->decimator);
+    }
+
+    q->filter_fft   = srsran_vec_cf_malloc(SRSRAN_NPSS_STREAM_BLOCK_SZ);
+    q->block        = srsran_vec_cf_malloc(SRSRAN_NPSS_STREAM_BLOCK_SZ);
+    q->block_fft    = srsran_vec_cf_malloc(SRSRAN_NPSS_STREAM_BLOCK_SZ);
+    q->corr         = srsran_vec_cf_malloc(SRSRAN_NPSS_STREAM_BLOCK_SZ);
+    q->corr_abs     = srsran_vec_f_malloc(q->step);
+    q->corr_avg     = srsran_vec_f_malloc(q->frame_len);
+    q->decim_buffer = srsran_vec_cf_malloc(q->step);
+    q->pending      = srsran_vec_cf_malloc(q->decimation);
+    if (!q->filter_fft || !q->block || !q->block_fft || !q->corr || !q->corr_abs || !q->corr_avg || !q->decim_buffer ||
+        !q->pending) {
+      fprintf(stderr, "Error allocating memory\n");
+      goto clean_and_exit;
+    }
+
+    if (srsran_dft_plan(&q->fft, SRSRAN_NPSS_STREAM_BLOCK_SZ, SRSRAN_DFT_FORWARD, SRSRAN_DFT_COMPLEX) ||
+        srsran_dft_plan(&q->ifft, SRSRAN_NPSS_STREAM_BLOCK_SZ, SRSRAN_DFT_BACKWARD, SRSRAN_DFT_COMPLEX)) {
+      fprintf(stderr, "Error initiating NPSS stream DFT\n");
+      goto clean_and_exit;
+    }
+    srsran_dft_plan_set_norm(&q->fft, true);
+
+    // The NPSS is translated into the time domain at 1.92 MHz and decimated
+    cf_t* npss_signal_time = srsran_vec_cf_malloc(SRSRAN_NPSS_CORR_FILTER_LEN + SRSRAN_NBIOT_FFT_SIZE);
+    if (!npss_signal_time) {
+      fprintf(stderr, "Error allocating memory\n");
+      goto clean_and_exit;
+    }
+    if (srsran_npss_corr_init(npss_signal_time, SRSRAN_NBIOT_FFT_SIZE, SRSRAN_NPSS_CORR_FILTER_LEN)) {
+      fprintf(stderr, "Error initiating NPSS detector for fft_size=%d\n", fft_size);
+      free(npss_signal_time);
+      goto clean_and_exit;
+    }
+    srsran_vec_cf_zero(q->block, SRSRAN_NPSS_STREAM_BLOCK_SZ);
+    for (uint32_t i = 0; i < q->filter_len; i++) {
+      q->block[i] = npss_signal_time[i * template_decimation];
+    }
+    free(npss_signal_time);
+    srsran_dft_run_c(&q->fft, q->block, q->filter_fft);
+
+    srsran_npss_stream_reset(q);
+
+    ret = SRSRAN_SUCCESS;
+  }
+
+clean_and_exit:
+  if (ret == SRSRAN_ERROR) {
+    srsran_npss_stream_free(q);
+  }
+  return ret;
+}
+
+void srsran_npss_stream_reset(srsran_npss_stream_t* q)
+{
+  if (q->decimation > 1) {
+    srsran_resampler_fft_reset_state(&q->decimator);
+  }
+
+  // The correlation starts with a template of zeros, so that a frame of input gives a frame of correlation
+  srsran_vec_cf_zero(q->block, SRSRAN_NPSS_STREAM_BLOCK_SZ);
+  srsran_vec_f_zero(q->corr_avg, q->frame_len);
+  q->block_fill  = q->filter_len - 1;
+  q->corr_start  = -(int64_t)(q->filter_len - 1);
+  q->corr_idx    = q->frame_len - (q->filter_len - 1);
+  q->nof_corr    = 0;
+  q->nof_pending = 0;
+  q->nof_samples = 0;
+  q->cfo_phase   = 0.0;
+  q->peak_pos    = 0;
+  q->peak_value  = 0.0f;
+  q->psr         = 0.0f;
+}
+
+void srsran_npss_stream_set_ema_alpha(srsran_npss_stream_t* q, float alpha)
+{
+  q->ema_alpha = alpha;
+}
+
+void srsran_npss_stream_set_cfo(srsran_npss_stream_t* q, float cfo)
+{
+  q->cfo = cfo;
+}
+
+/* Finds the peak of the frame of averaged correlation and its side lobes. The last correlation output, at corr_idx - 1,
+ * had its template starting at decimated sample last_start. */
+static void npss_stream_peak(srsran_npss_stream_t* q, int64_t last_start)
+{
+  const float* avg = q->corr_avg;
+  uint32_t     F   = q->frame_len;
+  uint32_t     pos = srsran_vec_max_fi(avg, F);
+
+  // The peak lobe ends where the correlation stops decreasing, on both sides
+  uint32_t right = 0;
+  while (right < F / 2 && avg[(pos + right + 1) % F] <= avg[(pos + right) % F]) {
+    right++;
+  }
+  uint32_t left = 0;
+  while (left < F / 2 && avg[(pos + F - left - 1) % F] <= avg[(pos + F - left) % F]) {
+    left++;
+  }
+  float side_lobe = 0.0f;
+  for (uint32_t d = right + 1; d < F - left; d++) {
+    side_lobe = SRSRAN_MAX(side_lobe, avg[(pos + d) % F]);
+  }
+
+  // Fractional peak position from a parabola through the peak and its neighbours
+  float y0    = avg[(pos + F - 1) % F];
+  float y1    = avg[pos];
+  float y2    = avg[(pos + 1) % F];
+  float den   = y0 - 2.0f * y1 + y2;
+  float delta = (den < 0.0f) ? SRSRAN_MAX(-0.5f, SRSRAN_MIN(0.5f, 0.5f * (y0 - y2) / den)) : 0.0f;
+
+  // Latest template start with the peak position in the frame
+  uint32_t last_idx = (q->corr_idx + F - 1) % F;
+  int64_t  start    = last_start - (int64_t)((last_idx + F - pos) % F);
+
+  q->peak_pos   = llround(((double)start + delta) * q->decimation) - (int64_t)q->delay;
+  q->peak_value = y1;
+  q->psr        = isnormal(side_lobe) ? y1 / side_lobe : 0.0f;
+
+  DEBUG("NPSS stream peak at %ld (%d%+.2f) value=%.2e PSR=%.2f", (long)q->peak_pos, pos, delta, y1, q->psr);
+}
+
+/* Correlates a full overlap-save block and adds the result to the frame average. Returns the frames completed. */
+static int npss_stream_correlate(srsran_npss_stream_t* q)
+{
+  int nof_frames = 0;
+
+  srsran_vec_cf_zero(&q->block[q->block_fill], SRSRAN_NPSS_STREAM_BLOCK_SZ - q->block_fill);
+  srsran_dft_run_c(&q->fft, q->block, q->block_fft);
+  srsran_vec_prod_conj_ccc(q->block_fft, q->filter_fft, q->block_fft, SRSRAN_NPSS_STREAM_BLOCK_SZ);
+  srsran_dft_run_c(&q->ifft, q->block_fft, q->corr);
+
+#ifdef SRSRAN_NPSS_ABS_SQUARE
+  srsran_vec_abs_square_cf(q->corr, q->corr_abs, q->step);
+#else
+  srsran_vec_abs_cf(q->corr, q->corr_abs, q->step);
+#endif
+
+  for (uint32_t i = 0; i < q->step;) {
+    uint32_t n   = SRSRAN_MIN(q->step - i, SRSRAN_MIN(q->frame_len - q->corr_idx, q->frame_len - q->nof_corr));
+    float*   avg = &q->corr_avg[q->corr_idx];
+    if (q->ema_alpha < 1.0 && q->ema_alpha > 0.0) {
+      srsran_vec_sc_prod_fff(&q->corr_abs[i], q->ema_alpha, &q->corr_abs[i], n);
+      srsran_vec_sc_prod_fff(avg, 1 - q->ema_alpha, avg, n);
+      srsran_vec_sum_fff(&q->corr_abs[i], avg, avg, n);
+    } else {
+      srsran_vec_f_copy(avg, &q->corr_abs[i], n);
+    }
+    q->corr_idx = (q->corr_idx + n) % q->frame_len;
+    q->nof_corr += n;
+    i += n;
+
+    if (q->nof_corr == q->frame_len) {
+      npss_stream_peak(q, q->corr_start + i - 1);
+      q->nof_corr = 0;
+      nof_frames++;
+    }
+  }
+  q->corr_start += q->step;
+
+  // Keep the samples the next templates start with
+  memmove(q->block, &q->block[q->step], sizeof(cf_t) * (q->filter_len - 1));
+  q->block_fill = q->filter_len - 1;
+
+  return nof_frames;
+}
+
+/* Decimates and correlates nsamples, a multiple of the decimation giving at most step decimated samples */
+static int npss_stream_push(srsran_npss_stream_t* q, const cf_t* input, uint32_t nsamples)
+{
+  int      nof_frames = 0;
+  uint32_t nof_decim  = nsamples / q->decimation;
+
+  if (q->decimation > 1) {
+    srsran_resampler_fft_run(&q->decimator, input, q->decim_buffer, nsamples);
+  } else {
+    srsran_vec_cf_copy(q->decim_buffer, input, nsamples);
+  }
+
+  // Frequency correction with a phase that carries on across calls
+  if (isnormal(q->cfo)) {
+    float freq = q->cfo * (float)q->decimation;
+    srsran_vec_apply_cfo(q->decim_buffer, freq, q->decim_buffer, (int)nof_decim);
+    srsran_vec_sc_prod_ccc(q->decim_buffer, (cf_t)cexp(I * q->cfo_phase), q->decim_buffer, nof_decim);
+    q->cfo_phase = fmod(q->cfo_phase + 2.0 * M_PI * (double)freq * nof_decim, 2.0 * M_PI);
+  }
+
+  for (uint32_t i = 0; i < nof_decim;) {
+    uint32_t n = SRSRAN_MIN(nof_decim - i, q->filter_len - 1 + q->step - q->block_fill);
+    srsran_vec_cf_copy(&q->block[q->block_fill], &q->decim_buffer[i], n);
+    q->block_fill += n;
+    i += n;
+    if (q->block_fill == q->filter_len - 1 + q->step) {
+      nof_frames += npss_stream_correlate(q);
+    }
+  }
+
+  return nof_frames;
+}
+
+int srsran_npss_stream_run(srsran_npss_stream_t* q, const cf_t* input, uint32_t nsamples)
+{
+  if (q == NULL || input == NULL) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  int      nof_frames = 0;
+  uint32_t count      = 0;
+  while (count < nsamples) {
+    uint32_t n = 0;
+    if (q->nof_pending > 0 || nsamples - count < q->decimation) {
+      // Gather the samples of a decimated sample split between calls
+      n = SRSRAN_MIN(q->decimation - q->nof_pending, nsamples - count);
+      srsran_vec_cf_copy(&q->pending[q->nof_pending], &input[count], n);
+      q->nof_pending += n;
+      if (q->nof_pending == q->decimation) {
+        nof_frames += npss_stream_push(q, q->pending, q->decimation);
+        q->nof_pending = 0;
+      }
+    } else {
+      n = SRSRAN_MIN((nsamples - count) / q->decimation, q->step) * q->decimation;
+      nof_frames += npss_stream_push(q, &input[count], n);
+    }
+    count += n;
+  }
+  q->nof_samples += nsamples;
+
+  return nof_frames;
+}
+
+void srsran_npss_stream_free(srsran_npss_stream_t* q)
+{
+  if (q) {
+    srsran_resampler_fft_free(&q->decimator);
+    srsran_dft_plan_free(&q->fft);
+    srsran_dft_plan_free(&q->ifft);
+    if (q->filter_fft) {
+      free(q->filter_fft);
+    }
+    if (q->block) {
+      free(q->block);
+    }
+    if (q->block_fft) {
+      free(q->block_fft);
+    }
+    if (q->corr) {
+      free(q->corr);
+    }
+    if (q->corr_abs) {
+      free(q->corr_abs);
+    }
+    if (q->corr_avg) {
+      free(q->corr_avg);
+    }
+    if (q->decim_buffer) {
+      free(q->decim_buffer);
+    }
+    if (q->pending) {
+      free(q->pending);
+    }
+  }
+}
+
 /**
  * This function calculates the Zadoff-Chu sequence.
  * 36.211 13.2.0 section 10.2.7.1.1
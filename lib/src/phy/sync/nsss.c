@@ -19,8 +19,8 @@
  *
  */
 
-#include <assert.h>
 #include <complex.h>
+#include <math.h>
 #include <stdlib.h>
 #include <strings.h>
 
@@ -31,10 +31,6 @@
 
 #define PRINT_ERR(err) fprintf(stderr, "%s: %s", __PRETTY_FUNCTION__, err)
 
-#define DUMP_SIGNALS 0
-#define DO_FREQ_SHIFT 1
-#define SRSRAN_NSSS_RETURN_PSR 0
-
 int srsran_nsss_synch_init(srsran_nsss_synch_t* q, uint32_t input_size, uint32_t fft_size)
 {
   if (q != NULL && fft_size <= 2048) {
@@ -46,37 +42,23 @@ int srsran_nsss_synch_init(srsran_nsss_synch_t* q, uint32_t input_size, uint32_t
     q->input_size          = input_size;
     q->corr_peak_threshold = 2.0;
 
-    uint32_t buffer_size = SRSRAN_NSSS_CORR_FILTER_LEN + q->input_size + 1;
-    DEBUG("NSSS buffer size is %d samples.", buffer_size);
-    q->tmp_input = srsran_vec_cf_malloc(buffer_size);
-    if (!q->tmp_input) {
+    q->fft_in       = srsran_vec_cf_malloc(fft_size);
+    q->fft_out      = srsran_vec_cf_malloc(fft_size);
+    q->window_shift = srsran_vec_cf_malloc(fft_size);
+    q->zc_conj      = srsran_vec_cf_malloc(SRSRAN_NSSS_NUM_ROOTS * SRSRAN_NSSS_LEN);
+    q->cover_conj   = srsran_vec_cf_malloc(SRSRAN_NSSS_NUM_SEQ * SRSRAN_NSSS_NUM_SEQ * SRSRAN_NSSS_LEN);
+    if (!q->fft_in || !q->fft_out || !q->window_shift || !q->zc_conj || !q->cover_conj) {
       fprintf(stderr, "Error allocating memory\n");
       goto clean_and_exit;
     }
-    srsran_vec_cf_zero(q->tmp_input, buffer_size);
 
-    q->conv_output = srsran_vec_cf_malloc(buffer_size);
-    if (!q->conv_output) {
-      fprintf(stderr, "Error allocating memory\n");
+    if (srsran_dft_plan(&q->fft, fft_size, SRSRAN_DFT_FORWARD, SRSRAN_DFT_COMPLEX)) {
+      fprintf(stderr, "Error initiating NSSS FFT\n");
       goto clean_and_exit;
     }
-    srsran_vec_cf_zero(q->conv_output, buffer_size);
-
-    q->conv_output_abs = srsran_vec_f_malloc(buffer_size);
-    if (!q->conv_output_abs) {
-      fprintf(stderr, "Error allocating memory\n");
-      goto clean_and_exit;
-    }
-    srsran_vec_f_zero(q->conv_output_abs, buffer_size);
-
-    for (int i = 0; i < SRSRAN_NUM_PCI; i++) {
-      q->nsss_signal_time[i] = srsran_vec_cf_malloc(buffer_size);
-      if (!q->nsss_signal_time[i]) {
-        fprintf(stderr, "Error allocating memory\n");
-        goto clean_and_exit;
-      }
-      srsran_vec_cf_zero(q->nsss_signal_time[i], buffer_size);
-    }
+    srsran_dft_plan_set_mirror(&q->fft, true);
+    srsran_dft_plan_set_dc(&q->fft, false);
+    srsran_dft_plan_set_norm(&q->fft, true);
 
     // generate NSSS sequences
     if (srsran_nsss_corr_init(q)) {
@@ -84,11 +66,6 @@ int srsran_nsss_synch_init(srsran_nsss_synch_t* q, uint32_t input_size, uint32_t
       goto clean_and_exit;
     }
 
-    if (srsran_conv_fft_cc_init(&q->conv_fft, q->input_size, SRSRAN_NSSS_CORR_FILTER_LEN)) {
-      fprintf(stderr, "Error initiating convolution FFT\n");
-      goto clean_and_exit;
-    }
-
     ret = SRSRAN_SUCCESS;
 
   clean_and_exit:
@@ -103,20 +80,21 @@ int srsran_nsss_synch_init(srsran_nsss_synch_t* q, uint32_t input_size, uint32_t
 void srsran_nsss_synch_free(srsran_nsss_synch_t* q)
 {
   if (q) {
-    for (int i = 0; i < SRSRAN_NUM_PCI; i++) {
-      if (q->nsss_signal_time[i]) {
-        free(q->nsss_signal_time[i]);
-      }
+    srsran_dft_plan_free(&q->fft);
+    if (q->fft_in) {
+      free(q->fft_in);
     }
-    srsran_conv_fft_cc_free(&q->conv_fft);
-    if (q->tmp_input) {
-      free(q->tmp_input);
+    if (q->fft_out) {
+      free(q->fft_out);
     }
-    if (q->conv_output) {
-      free(q->conv_output);
+    if (q->window_shift) {
+      free(q->window_shift);
     }
-    if (q->conv_output_abs) {
-      free(q->conv_output_abs);
+    if (q->zc_conj) {
+      free(q->zc_conj);
+    }
+    if (q->cover_conj) {
+      free(q->cover_conj);
     }
   }
 }
@@ -129,6 +107,10 @@ int srsran_nsss_synch_resize(srsran_nsss_synch_t* q, uint32_t fft_size)
       return SRSRAN_ERROR;
     }
 
+    if (fft_size != q->fft_size && srsran_dft_replan(&q->fft, fft_size)) {
+      PRINT_ERR("Couldn't resize NSSS FFT\n");
+      return SRSRAN_ERROR;
+    }
     q->fft_size = fft_size;
 
     if (srsran_nsss_corr_init(q) != SRSRAN_SUCCESS) {
@@ -141,92 +123,113 @@ int srsran_nsss_synch_resize(srsran_nsss_synch_t* q, uint32_t fft_size)
   return SRSRAN_ERROR_INVALID_INPUTS;
 }
 
+/* Prepares the frequency-domain detection for the current FFT size.
+ *
+ * The NSSS is d(n) = b_q(m) * exp(-j*2*pi*theta_f*n) * exp(-j*pi*u*n'*(n'+1)/131), see 36.211 10.2.7.2.1, with
+ * theta_f = 33/132 * (n_f/2 mod 4). The Zadoff-Chu part only depends on the root and the rest only on q and theta_f,
+ * so both are stored conjugated and a hypothesis is checked with two products.
+ */
 int srsran_nsss_corr_init(srsran_nsss_synch_t* q)
 {
-  srsran_dft_plan_t plan;
-  float complex     nsss_signal_pad[q->fft_size];
-
-  // construct dft plan
-  if (srsran_dft_plan(&plan, q->fft_size, SRSRAN_DFT_BACKWARD, SRSRAN_DFT_COMPLEX)) {
-    return SRSRAN_ERROR;
+  q->subframe_sz = SRSRAN_SF_LEN(q->fft_size);
+
+  for (uint32_t r = 0; r < SRSRAN_NSSS_NUM_ROOTS; r++) {
+    uint32_t u = r + 3;
+    for (uint32_t n = 0; n < SRSRAN_NSSS_LEN; n++) {
+      // The phase is reduced in integers, the argument grows too large for single precision otherwise
+      uint32_t n_prime = n % 131;
+      uint32_t arg     = (u * n_prime * (n_prime + 1)) % 262;
+      q->zc_conj[r * SRSRAN_NSSS_LEN + n] = cexpf(I * M_PI * (float)arg / 131.0f);
+    }
   }
-  srsran_dft_plan_set_mirror(&plan, true);
-  srsran_dft_plan_set_dc(&plan, false);
-  srsran_dft_plan_set_norm(&plan, true);
-
-#if DO_FREQ_SHIFT
-  // shift entire signal in frequency domain by half a subcarrier
-  cf_t  shift_buffer[SRSRAN_SF_LEN(q->fft_size)];
-  cf_t* ptr = shift_buffer;
-  for (uint32_t n = 0; n < 2; n++) {
-    for (uint32_t i = 0; i < 7; i++) {
-      uint32_t cplen = SRSRAN_CP_LEN_NORM(i, q->fft_size);
-      for (uint32_t t = 0; t < q->fft_size + cplen; t++) {
-        ptr[t] = cexpf(I * 2 * M_PI * ((float)t - (float)cplen) * -SRSRAN_NBIOT_FREQ_SHIFT_FACTOR / q->fft_size);
+
+  for (uint32_t b = 0; b < SRSRAN_NSSS_NUM_SEQ; b++) {
+    for (uint32_t theta_f = 0; theta_f < SRSRAN_NSSS_NUM_SEQ; theta_f++) {
+      cf_t* cover = &q->cover_conj[(b * SRSRAN_NSSS_NUM_SEQ + theta_f) * SRSRAN_NSSS_LEN];
+      for (uint32_t n = 0; n < SRSRAN_NSSS_LEN; n++) {
+        cover[n] = b_q_m[b][n % 128] * cexpf(I * M_PI / 2 * (float)((theta_f * n) % 4));
       }
-      ptr += q->fft_size + cplen;
     }
   }
-#endif
-
-  // generate correlation sequences
-  DEBUG("Generating NSSS sequences");
-  for (int i = 0; i < SRSRAN_NUM_PCI; i++) {
-    float complex nsss_signal[SRSRAN_NSSS_TOT_LEN] = {};
-    srsran_nsss_generate(nsss_signal, i);
-
-    // one symbol at a time
-    cf_t* output     = q->nsss_signal_time[i];
-    int   output_len = 0;
-    for (int i = 0; i < SRSRAN_NSSS_NSYMB; i++) {
-      // zero buffer, copy NSSS symbol to appr. pos and transform to time-domain
-      srsran_vec_cf_zero(nsss_signal_pad, q->fft_size);
-
-      // 5th NSSS symbol has CP length of 10 symbols
-      int cp_len =
-          (i != 4) ? SRSRAN_CP_LEN_NORM(1, SRSRAN_NBIOT_FFT_SIZE) : SRSRAN_CP_LEN_NORM(0, SRSRAN_NBIOT_FFT_SIZE);
-      int k = (q->fft_size - SRSRAN_NRE) / 2; // place seq in the centre
-      k     = 57;
-
-      // use generated sequence for theta_f = 0
-      int theta_f = 0;
-      memcpy(&nsss_signal_pad[k],
-             &nsss_signal[(theta_f * SRSRAN_NSSS_LEN) + i * SRSRAN_NSSS_NSC],
-             SRSRAN_NSSS_NSC * sizeof(cf_t));
-      srsran_dft_run_c(&plan, nsss_signal_pad, &output[cp_len]);
-
-      // add CP
-      memcpy(output, &output[q->fft_size], cp_len * sizeof(cf_t));
-
-      // prepare next iteration
-      output += q->fft_size + cp_len;
-      output_len += q->fft_size + cp_len;
-    }
-    assert(output_len == SRSRAN_NSSS_CORR_FILTER_LEN);
-
-#if DO_FREQ_SHIFT
-    srsran_vec_prod_ccc(q->nsss_signal_time[i],
-                        &shift_buffer[SRSRAN_NSSS_CORR_OFFSET],
-                        q->nsss_signal_time[i],
-                        SRSRAN_NSSS_CORR_FILTER_LEN);
-    // srsran_vec_sc_prod_cfc(npss_signal_time, 1.0/3, npss_signal_time, output_len);
-#endif
-
-#if DUMP_SIGNALS
-#define MAX_FNAME_LEN 40
-    char fname[MAX_FNAME_LEN];
-    snprintf(fname, MAX_FNAME_LEN, "nsss_corr_seq_time_id%d.bin", i);
-    srsran_vec_save_file(fname, q->nsss_signal_time[i], SRSRAN_NSSS_CORR_FILTER_LEN * sizeof(cf_t));
-
-    snprintf(fname, MAX_FNAME_LEN, "nsss_corr_seq_freq_id%d.bin", i);
-    srsran_vec_save_file(fname, nsss_signal, SRSRAN_NSSS_TOT_LEN * sizeof(cf_t));
-#endif
+
+  // The FFT window starts half a CP early, within the CP, to tolerate small timing errors in both directions
+  uint32_t cp_adv = SRSRAN_CP_LEN_NORM(1, q->fft_size) / 2;
+  for (uint32_t i = 0; i < q->fft_size; i++) {
+    q->window_shift[i] =
+        cexpf(I * 2 * M_PI * ((float)i - (float)cp_adv) * SRSRAN_NBIOT_FREQ_SHIFT_FACTOR / (float)q->fft_size);
+  }
+  for (uint32_t k = 0; k < SRSRAN_NSSS_NSC; k++) {
+    float bin      = (float)k - SRSRAN_NSSS_NSC / 2;
+    q->re_shift[k] = cexpf(I * 2 * M_PI * bin * (float)cp_adv / (float)q->fft_size);
   }
 
-  srsran_dft_plan_free(&plan);
   return SRSRAN_SUCCESS;
 }
 
+/* Takes the NSSS resource elements of a subframe to the frequency domain and returns their energy */
+static float nsss_extract_re(srsran_nsss_synch_t* q, const cf_t* subframe, cf_t* re)
+{
+  uint32_t    cp_adv = SRSRAN_CP_LEN_NORM(1, q->fft_size) / 2;
+  uint32_t    k0     = (q->fft_size - SRSRAN_NSSS_NSC) / 2;
+  const cf_t* ptr    = subframe;
+
+  for (uint32_t l = 0; l < SRSRAN_CP_NORM_SF_NSYMB; l++) {
+    uint32_t cp_len = SRSRAN_CP_LEN_NORM(l % SRSRAN_CP_NORM_NSYMB, q->fft_size);
+    if (l >= SRSRAN_CP_NORM_SF_NSYMB - SRSRAN_NSSS_NSYMB) {
+      uint32_t nsss_l = l - (SRSRAN_CP_NORM_SF_NSYMB - SRSRAN_NSSS_NSYMB);
+      srsran_vec_prod_ccc(&ptr[cp_len - cp_adv], q->window_shift, q->fft_in, q->fft_size);
+      srsran_dft_run_c(&q->fft, q->fft_in, q->fft_out);
+      srsran_vec_prod_ccc(&q->fft_out[k0], q->re_shift, &re[nsss_l * SRSRAN_NSSS_NSC], SRSRAN_NSSS_NSC);
+    }
+    ptr += cp_len + q->fft_size;
+  }
+
+  return srsran_vec_avg_power_cf(re, SRSRAN_NSSS_LEN) * SRSRAN_NSSS_LEN;
+}
+
+/* Correlates the resource elements of one subframe with every cell ID and theta_f, keeping the best correlation of
+ * each cell ID in peak_values. The correlation is coherent over the whole subframe, as the b_q(m) covers are only
+ * told apart over their full length, and is normalised by the energy so that it lies between 0 and 1.
+ */
+static void nsss_correlate(srsran_nsss_synch_t* q, const cf_t* re, float energy)
+{
+  if (!isnormal(energy)) {
+    return;
+  }
+  float norm = 1.0f / (SRSRAN_NSSS_LEN * energy);
+
+  for (uint32_t r = 0; r < SRSRAN_NSSS_NUM_ROOTS; r++) {
+    srsran_vec_prod_ccc(re, &q->zc_conj[r * SRSRAN_NSSS_LEN], q->tmp, SRSRAN_NSSS_LEN);
+
+    for (uint32_t b = 0; b < SRSRAN_NSSS_NUM_SEQ; b++) {
+      uint32_t cell_id = b * SRSRAN_NSSS_NUM_ROOTS + r;
+
+      for (uint32_t theta_f = 0; theta_f < SRSRAN_NSSS_NUM_SEQ; theta_f++) {
+        const cf_t* cover = &q->cover_conj[(b * SRSRAN_NSSS_NUM_SEQ + theta_f) * SRSRAN_NSSS_LEN];
+        cf_t        acc   = srsran_vec_dot_prod_ccc(q->tmp, cover, SRSRAN_NSSS_LEN);
+        float       corr  = (__real__ acc * __real__ acc + __imag__ acc * __imag__ acc) * norm;
+
+        if (corr > q->peak_values[cell_id]) {
+          q->peak_values[cell_id]  = corr;
+          q->peak_theta_f[cell_id] = theta_f;
+        }
+      }
+    }
+  }
+}
+
+/* Ratio of the correlation of a cell ID to the best correlation of any other cell ID */
+static float nsss_peak_ratio(srsran_nsss_synch_t* q, uint32_t cell_id)
+{
+  float side = 0.0f;
+  for (uint32_t i = 0; i < SRSRAN_NUM_PCI; i++) {
+    if (i != cell_id) {
+      side = SRSRAN_MAX(side, q->peak_values[i]);
+    }
+  }
+  return isnormal(side) ? q->peak_values[cell_id] / side : 0.0f;
+}
+
 int srsran_nsss_sync_find(srsran_nsss_synch_t* q,
                           cf_t*                input,
                           float*               corr_peak_value,
@@ -236,113 +239,38 @@ int srsran_nsss_sync_find(srsran_nsss_synch_t* q,
   int ret = SRSRAN_ERROR_INVALID_INPUTS;
 
   if (q != NULL && input != NULL && corr_peak_value != NULL && cell_id != NULL && sfn_partial != NULL) {
-    float peak_value;
     ret = SRSRAN_ERROR;
 
-    // save input
-    memcpy(q->tmp_input, input, q->input_size * sizeof(cf_t));
+    // Every cell ID is checked even if it is known, the others give the reference for the peak ratio
+    srsran_vec_f_zero(q->peak_values, SRSRAN_NUM_PCI);
+    for (uint32_t sf = 0; sf < q->input_size / q->subframe_sz; sf++) {
+      float energy = nsss_extract_re(q, &input[sf * q->subframe_sz], q->re);
+      nsss_correlate(q, q->re, energy);
+    }
 
-    if (*cell_id == SRSRAN_CELL_ID_UNKNOWN) {
+    uint32_t found_id = *cell_id;
+    if (found_id == SRSRAN_CELL_ID_UNKNOWN) {
       DEBUG("N_id_ncell is not set. Perform exhaustive search on input.");
-
-      // brute-force: correlate with all possible sequences until cell is found
-      for (int i = 0; i < SRSRAN_NUM_PCI; i++) {
-        srsran_nsss_sync_find_pci(q, q->tmp_input, i);
-      }
-
-      // find maximum of all correlation maxima
-      uint32_t max_id = srsran_vec_max_fi(q->peak_values, SRSRAN_NUM_PCI);
-      if (q->peak_values[max_id] > q->corr_peak_threshold) {
-        // cell found, set return values
-        *cell_id = max_id;
-        ret      = SRSRAN_SUCCESS;
-      }
-      peak_value = q->peak_values[max_id];
-
+      found_id = srsran_vec_max_fi(q->peak_values, SRSRAN_NUM_PCI);
     } else {
-      DEBUG("Current N_id_ncell is %d.", *cell_id);
-
-      // run correlation only for given id
-      srsran_nsss_sync_find_pci(q, q->tmp_input, *cell_id);
-
-      if (q->peak_values[*cell_id] > q->corr_peak_threshold) {
-        ret = SRSRAN_SUCCESS;
-      }
-      peak_value = q->peak_values[*cell_id];
-    }
-
-    // set remaining return values
-    if (sfn_partial) {
-      *sfn_partial = 0; // we only search for the first of the four possible shifts
-    }
-    if (corr_peak_value) {
-      *corr_peak_value = peak_value;
+      DEBUG("Current N_id_ncell is %d.", found_id);
     }
-  }
-  return ret;
-}
 
-// Correlates input signal with the NSSS sequence for a given n_id_ncell
-void srsran_nsss_sync_find_pci(srsran_nsss_synch_t* q, cf_t* input, uint32_t cell_id)
-{
-  // correlate input with NSSS sequences
-  uint32_t conv_output_len = srsran_corr_fft_cc_run(&q->conv_fft, input, q->nsss_signal_time[cell_id], q->conv_output);
-  srsran_vec_abs_cf(q->conv_output, q->conv_output_abs, conv_output_len - 1);
-
-  // Find maximum of the absolute value of the correlation
-  uint32_t corr_peak_pos = srsran_vec_max_fi(q->conv_output_abs, conv_output_len - 1);
-
-#if DUMP_SIGNALS
-  printf("Dumping debug signals for cell-id %d.\n", i);
-  srsran_vec_save_file("nsss_find_input.bin", input, q->input_size * sizeof(cf_t));
-  srsran_vec_save_file("nsss_corr_seq_time.bin", q->nsss_signal_time[i], SRSRAN_NSSS_CORR_FILTER_LEN * sizeof(cf_t));
-  srsran_vec_save_file("nsss_find_conv_output_abs.bin", q->conv_output_abs, conv_output_len * sizeof(float));
-#endif
-
-#if SRSRAN_NSSS_RETURN_PSR
-  // Find second side lobe
-
-  // Find end of peak lobe to the right
-  int pl_ub = corr_peak_pos + 1;
-  while (q->conv_output_abs[pl_ub + 1] <= q->conv_output_abs[pl_ub] && pl_ub < conv_output_len) {
-    pl_ub++;
-  }
-  // Find end of peak lobe to the left
-  int pl_lb;
-  if (corr_peak_pos > 2) {
-    pl_lb = corr_peak_pos - 1;
-    while (q->conv_output_abs[pl_lb - 1] <= q->conv_output_abs[pl_lb] && pl_lb > 1) {
-      pl_lb--;
+    float peak_value = nsss_peak_ratio(q, found_id);
+    DEBUG("NSSS n_id_ncell=%d corr=%.3f theta_f=%d ratio=%.2f",
+          found_id,
+          q->peak_values[found_id],
+          q->peak_theta_f[found_id],
+          peak_value);
+    if (peak_value > q->corr_peak_threshold) {
+      *cell_id = found_id;
+      ret      = SRSRAN_SUCCESS;
     }
-  } else {
-    pl_lb = 0;
-  }
 
-  int sl_distance_right = conv_output_len - 1 - pl_ub;
-  if (sl_distance_right < 0) {
-    sl_distance_right = 0;
+    *sfn_partial     = q->peak_theta_f[found_id];
+    *corr_peak_value = peak_value;
   }
-  int sl_distance_left = pl_lb;
-
-  int   sl_right          = pl_ub + srsran_vec_max_fi(&q->conv_output_abs[pl_ub], sl_distance_right);
-  int   sl_left           = srsran_vec_max_fi(q->conv_output_abs, sl_distance_left);
-  float side_lobe_value   = SRSRAN_MAX(q->conv_output_abs[sl_right], q->conv_output_abs[sl_left]);
-  q->peak_values[cell_id] = q->conv_output_abs[corr_peak_pos] / side_lobe_value;
-  DEBUG("NSSS n_id_ncell=%d at peak_pos=%2d, pl_ub=%2d, pl_lb=%2d, sl_right: %2d, sl_left: %2d, PSR: %.2f/%.2f=%.2f",
-        cell_id,
-        corr_peak_pos,
-        pl_ub,
-        pl_lb,
-        sl_right,
-        sl_left,
-        q->conv_output_abs[corr_peak_pos],
-        side_lobe_value,
-        q->peak_values[cell_id]);
-#else
-  // save max. absolute value
-  q->peak_values[cell_id] = q->conv_output_abs[corr_peak_pos];
-  DEBUG("NSSS n_id_ncell=%d with peak=%f found at: %d", cell_id, q->peak_values[cell_id], corr_peak_pos);
-#endif
+  return ret;
 }
 
 // generate the NSSS signal for each of 4 different cyclic shifts
@@ -354,13 +282,13 @@ void srsran_nsss_generate(cf_t* signal, uint32_t cell_id)
     int q    = floor(cell_id / 126.0);
     int sign = -1;
 
-    // iterate over all possible cyclic shifts
+    // iterate over all possible cyclic shifts, theta_f = 33/132 * (n_f/2 mod 4)
     for (int theta_f = 0; theta_f < SRSRAN_NSSS_NUM_SEQ; theta_f++) {
       for (int n = 0; n < SRSRAN_NSSS_LEN; n++) {
         int n_prime = n % 131;
         int m       = n % 128;
 
-        float         arg = (float)sign * 2.0 * M_PI * ((float)theta_f) * ((float)n);
+        float         arg = (float)sign * 2.0 * M_PI * (33.0 / 132.0 * theta_f) * ((float)n);
         float complex tmp1;
         __real__ tmp1 = cosf(arg);
         __imag__ tmp1 = sinf(arg);
@@ -385,7 +313,7 @@ void srsran_nsss_put_subframe(srsran_nsss_synch_t* q,
                               const uint32_t       nof_prb,
                               const uint32_t       nbiot_prb_offset)
 {
-  int theta_f = (int)floor(33 / 132.0 * (nf / 2.0)) % SRSRAN_NSSS_NUM_SEQ;
+  int theta_f = (nf / 2) % SRSRAN_NSSS_NUM_SEQ;
 
   // skip first 3 OFDM symbols over all PRBs completely
   int k = 3 * nof_prb * SRSRAN_NRE + nbiot_prb_offset * SRSRAN_NRE;
@@ -55,6 +55,11 @@ static int ssb_init_corr(srsran_ssb_t* q)
     return SRSRAN_SUCCESS;
   }
 
+  // The PSS search batch is sized when the sampling rate is configured
+  q->pss_corr_batch    = NULL;
+  q->pss_corr_batch_sz = 0;
+  q->pss_nof_hyp       = 0;
+
   // For each PSS sequence allocate
   for (uint32_t N_id_2 = 0; N_id_2 < SRSRAN_NOF_NID_2_NR; N_id_2++) {
     // Allocate sequences
@@ -154,6 +159,10 @@ void srsran_ssb_free(srsran_ssb_t* q)
     free(q->tmp_corr);
   }
 
+  if (q->pss_corr_batch != NULL) {
+    free(q->pss_corr_batch);
+  }
+
   // For each PSS sequence allocate
   for (uint32_t N_id_2 = 0; N_id_2 < SRSRAN_NOF_NID_2_NR; N_id_2++) {
     if (q->pss_seq[N_id_2] != NULL) {
@@ -169,6 +178,7 @@ void srsran_ssb_free(srsran_ssb_t* q)
   srsran_dft_plan_free(&q->fft);
   srsran_dft_plan_free(&q->fft_corr);
   srsran_dft_plan_free(&q->ifft_corr);
+  srsran_dft_plan_free(&q->ifft_corr_batch);
   srsran_pbch_nr_free(&q->pbch);
 
   SRSRAN_MEM_ZERO(q, srsran_ssb_t, 1);
@@ -348,8 +358,14 @@ static int ssb_setup_corr(srsran_ssb_t* q)
   // Compute new correlation size
   uint32_t corr_sz = SSB_CORR_SZ(q->symbol_sz);
 
-  // Skip if the symbol size is unchanged
-  if (q->corr_sz == corr_sz) {
+  // Calculate the coarse CFO shift range to detect the signal with a maximum CFO equal to the SSB subcarrier spacing,
+  // and the increment for half of the subcarrier spacing, at least one correlation subcarrier
+  double coarse_cfo_ref_hz = (q->cfg.srate_hz / corr_sz);
+  int    shift_range       = (int)ceil(SRSRAN_SUBC_SPACING_NR(q->cfg.scs) / coarse_cfo_ref_hz);
+  int    shift_coarse_inc  = SRSRAN_MAX(shift_range / 2, 1);
+
+  // Skip if the correlation size, the symbol size and the shifts are unchanged
+  if (q->corr_sz == corr_sz && q->corr_window == corr_sz - q->symbol_sz && q->pss_shift_range == shift_range) {
     return SRSRAN_SUCCESS;
   }
   q->corr_sz = corr_sz;
@@ -399,6 +415,40 @@ static int ssb_setup_corr(srsran_ssb_t* q)
 
     // Copy frequency domain sequence
     srsran_vec_cf_copy(q->pss_seq[N_id_2], q->tmp_freq, q->corr_sz);
+    q->pss_pwr[N_id_2] = srsran_vec_avg_power_cf(q->pss_seq[N_id_2], q->corr_sz);
+  }
+
+  // Make room for every N_id_2 and shift hypothesis in the PSS search batch
+  q->pss_shift_range      = shift_range;
+  q->pss_shift_coarse_inc = shift_coarse_inc;
+  q->pss_nof_hyp          = SRSRAN_NOF_NID_2_NR * (uint32_t)(2 * shift_range / shift_coarse_inc + 1);
+  if (q->pss_nof_hyp > q->pss_corr_batch_sz) {
+    if (q->pss_corr_batch != NULL) {
+      free(q->pss_corr_batch);
+    }
+    q->pss_corr_batch_sz = 0;
+    q->pss_corr_batch    = srsran_vec_cf_malloc(q->pss_nof_hyp * q->max_corr_sz);
+    if (q->pss_corr_batch == NULL) {
+      ERROR("Malloc");
+      return SRSRAN_ERROR;
+    }
+    q->pss_corr_batch_sz = q->pss_nof_hyp;
+  }
+
+  // Prepare the IFFT of the whole batch
+  srsran_dft_plan_free(&q->ifft_corr_batch);
+  if (srsran_dft_plan_guru_c(&q->ifft_corr_batch,
+                             (int)corr_sz,
+                             SRSRAN_DFT_BACKWARD,
+                             q->pss_corr_batch,
+                             q->pss_corr_batch,
+                             1,
+                             1,
+                             (int)q->pss_nof_hyp,
+                             (int)corr_sz,
+                             (int)corr_sz) < SRSRAN_SUCCESS) {
+    ERROR("Error planning correlation batch DFT");
+    return SRSRAN_ERROR;
   }
 
   return SRSRAN_SUCCESS;
@@ -865,11 +915,9 @@ static int ssb_pss_search(srsran_ssb_t* q,
   // Calculate correlation CFO coarse precision
   double coarse_cfo_ref_hz = (q->cfg.srate_hz / q->corr_sz);
 
-  // Calculate shift integer range to detect the signal with a maximum CFO equal to the SSB subcarrier spacing
-  int shift_range = (int)ceil(SRSRAN_SUBC_SPACING_NR(q->cfg.scs) / coarse_cfo_ref_hz);
-
-  // Calculate the coarse shift increment for half of the subcarrier spacing
-  int shift_coarse_inc = shift_range / 2;
+  // Coarse shifts selected with the correlation size
+  int shift_range      = q->pss_shift_range;
+  int shift_coarse_inc = q->pss_shift_coarse_inc;
 
   // Correlation best sequence
   float    best_corr   = 0;
@@ -899,28 +947,37 @@ static int ssb_pss_search(srsran_ssb_t* q,
     // Convert to frequency domain
     srsran_dft_run_guru_c(&q->fft_corr);
 
-    // Try each N_id_2 sequence
+    // Average power of the window, the same for every hypothesis, skip correlation window if value is invalid (0.0,
+    // nan or inf)
+    float avg_pwr_window = srsran_vec_avg_power_cf(q->tmp_freq, q->corr_sz);
+    if (!isnormal(avg_pwr_window)) {
+      t_offset += q->corr_window;
+      continue;
+    }
+
+    // Actual correlation in frequency domain of each N_id_2 sequence and coarse frequency offset
+    cf_t* corr_hyp = q->pss_corr_batch;
     for (uint32_t N_id_2 = 0; N_id_2 < SRSRAN_NOF_NID_2_NR; N_id_2++) {
-      // Steer coarse frequency offset
       for (int shift = -shift_range; shift <= shift_range; shift += shift_coarse_inc) {
-        // Actual correlation in frequency domain
-        ssb_vec_prod_conj_circ_shift(q->tmp_freq, q->pss_seq[N_id_2], q->tmp_corr, q->corr_sz, shift);
+        ssb_vec_prod_conj_circ_shift(q->tmp_freq, q->pss_seq[N_id_2], corr_hyp, q->corr_sz, shift);
+        corr_hyp += q->corr_sz;
+      }
+    }
 
-        // Convert to time domain
-        srsran_dft_run_guru_c(&q->ifft_corr);
+    // Convert all of them to time domain
+    srsran_dft_run_guru_c(&q->ifft_corr_batch);
 
+    // Try each N_id_2 sequence
+    corr_hyp = q->pss_corr_batch;
+    for (uint32_t N_id_2 = 0; N_id_2 < SRSRAN_NOF_NID_2_NR; N_id_2++) {
+      // Steer coarse frequency offset
+      for (int shift = -shift_range; shift <= shift_range; shift += shift_coarse_inc, corr_hyp += q->corr_sz) {
         // Find maximum
-        uint32_t peak_idx = srsran_vec_max_abs_ci(q->tmp_time, q->corr_window);
-
-        // Average power, take total power of the frequency domain signal after filtering, skip correlation window if
-        // value is invalid (0.0, nan or inf)
-        float avg_pwr_corr = srsran_vec_avg_power_cf(q->tmp_corr, q->corr_sz);
-        if (!isnormal(avg_pwr_corr)) {
-          continue;
-        }
+        uint32_t peak_idx = srsran_vec_max_abs_ci(corr_hyp, q->corr_window);
 
-        // Normalise correlation
-        float corr = SRSRAN_CSQABS(q->tmp_time[peak_idx]) / avg_pwr_corr / sqrtf(SRSRAN_PSS_NR_LEN);
+        // Normalise correlation with the power of the window and of the sequence
+        float corr = SRSRAN_CSQABS(corr_hyp[peak_idx]) / (avg_pwr_window * q->pss_pwr[N_id_2]) /
+                     sqrtf(SRSRAN_PSS_NR_LEN);
 
         // Update if the correlation is better than the current best
         if (best_corr < corr) {
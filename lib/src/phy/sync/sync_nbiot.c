@@ -92,6 +92,11 @@ int srsran_sync_nbiot_init(srsran_sync_nbiot_t* q, uint32_t frame_size, uint32_t
       return SRSRAN_ERROR;
     }
 
+    if (srsran_npss_stream_init(&q->npss_stream, fft_size)) {
+      fprintf(stderr, "Error initializing NPSS stream object\n");
+      goto clean_exit;
+    }
+
     if (srsran_nsss_synch_init(&q->nsss, SRSRAN_NSSS_NUM_SF_DETECT * SRSRAN_SF_LEN_PRB_NBIOT, fft_size)) {
       fprintf(stderr, "Error initializing NSSS object\n");
       exit(-1);
@@ -116,6 +121,7 @@ void srsran_sync_nbiot_free(srsran_sync_nbiot_t* q)
 {
   if (q) {
     srsran_npss_synch_free(&q->npss);
+    srsran_npss_stream_free(&q->npss_stream);
     srsran_nsss_synch_free(&q->nsss);
     srsran_cfo_free(&q->cfocorr);
     srsran_cp_synch_free(&q->cp_synch);
@@ -152,6 +158,13 @@ int srsran_sync_nbiot_resize(srsran_sync_nbiot_t* q, uint32_t frame_size, uint32
       fprintf(stderr, "Error resizing PSS object\n");
       return ret;
     }
+    if (fft_size != q->npss_stream.fft_size) {
+      srsran_npss_stream_free(&q->npss_stream);
+      if (srsran_npss_stream_init(&q->npss_stream, fft_size)) {
+        fprintf(stderr, "Error resizing NPSS stream object\n");
+        return ret;
+      }
+    }
     if (srsran_nsss_synch_resize(&q->nsss, fft_size)) {
       fprintf(stderr, "Error resizing SSS object\n");
       return ret;
@@ -180,6 +193,32 @@ int srsran_sync_nbiot_resize(srsran_sync_nbiot_t* q, uint32_t frame_size, uint32
   return ret;
 }
 
+/* Estimates the CFO with the CP of the second slot of the NPSS starting at peak_pos, if it is within the frame */
+static void sync_nbiot_estimate_cfo(srsran_sync_nbiot_t* q, cf_t* input, int peak_pos)
+{
+  if (!q->enable_cfo_estimation) {
+    return;
+  }
+
+  // check if there are enough samples left
+  if (peak_pos + SRSRAN_NPSS_CFO_OFFSET + SRSRAN_NPSS_CFO_NUM_SAMPS + SRSRAN_NBIOT_FFT_SIZE < q->frame_size) {
+    // shift input signal
+    srsran_vec_prod_ccc(&q->shift_buffer[SRSRAN_SF_LEN(q->fft_size) / 2],
+                        &input[peak_pos + SRSRAN_NPSS_CFO_OFFSET],
+                        &input[peak_pos + SRSRAN_NPSS_CFO_OFFSET],
+                        SRSRAN_NPSS_CFO_NUM_SAMPS);
+
+    // use second slot of the NPSS for CFO estimation
+    float cfo = cfo_estimate_nbiot(q, &input[peak_pos + SRSRAN_NPSS_CFO_OFFSET]);
+
+    // compute exponential moving average CFO
+    q->mean_cfo = SRSRAN_VEC_EMA(cfo, q->mean_cfo, q->cfo_ema_alpha);
+    DEBUG("CFO=%.4f, mean=%.4f (%.2f Hz), ema=%.2f", cfo, q->mean_cfo, q->mean_cfo * 15000, q->cfo_ema_alpha);
+  } else {
+    DEBUG("Not enough samples for CFO estimation. Skipping.");
+  }
+}
+
 /** Finds the NPSS sequence around the position find_offset in the buffer input.
  * Returns 1 if the correlation peak exceeds the threshold set by srsran_sync_set_threshold()
  * or 0 otherwise. Returns a negative number on error.
@@ -220,26 +259,7 @@ srsran_sync_nbiot_find(srsran_sync_nbiot_t* q, cf_t* input, uint32_t find_offset
     ret = SRSRAN_SYNC_FOUND;
   }
 
-  // estimate CFO after NPSS has been detected
-  if (q->enable_cfo_estimation) {
-    // check if there are enough samples left
-    if (peak_pos + SRSRAN_NPSS_CFO_OFFSET + SRSRAN_NPSS_CFO_NUM_SAMPS + SRSRAN_NBIOT_FFT_SIZE < q->frame_size) {
-      // shift input signal
-      srsran_vec_prod_ccc(&q->shift_buffer[SRSRAN_SF_LEN(q->fft_size) / 2],
-                          &input[peak_pos + SRSRAN_NPSS_CFO_OFFSET],
-                          &input[peak_pos + SRSRAN_NPSS_CFO_OFFSET],
-                          SRSRAN_NPSS_CFO_NUM_SAMPS);
-
-      // use second slot of the NPSS for CFO estimation
-      float cfo = cfo_estimate_nbiot(q, &input[peak_pos + SRSRAN_NPSS_CFO_OFFSET]);
-
-      // compute exponential moving average CFO
-      q->mean_cfo = SRSRAN_VEC_EMA(cfo, q->mean_cfo, q->cfo_ema_alpha);
-      DEBUG("CFO=%.4f, mean=%.4f (%.2f Hz), ema=%.2f", cfo, q->mean_cfo, q->mean_cfo * 15000, q->cfo_ema_alpha);
-    } else {
-      DEBUG("Not enough samples for CFO estimation. Skipping.");
-    }
-  }
+  sync_nbiot_estimate_cfo(q, input, peak_pos);
 
   DEBUG("sync_nbiot ret=%d find_offset=%d frame_len=%d, pos=%d peak=%.2f threshold=%.2f, CFO=%.3f kHz",
         ret,
@@ -253,6 +273,61 @@ srsran_sync_nbiot_find(srsran_sync_nbiot_t* q, cf_t* input, uint32_t find_offset
   return ret;
 }
 
+/** Feeds the frame_size samples of input, which continue the samples of the previous call, to the streaming NPSS
+ * detector. Returns 1 if a radio frame of correlation was completed and its peak exceeds the threshold set by
+ * srsran_sync_nbiot_set_threshold() or 0 otherwise. Returns a negative number on error.
+ *
+ * The position of the peak, modulo the radio frame and counted from the start of input, is stored in *peak_position
+ */
+srsran_sync_find_ret_t srsran_sync_nbiot_find_stream(srsran_sync_nbiot_t* q, cf_t* input, uint32_t* peak_position)
+{
+  srsran_sync_find_ret_t ret = SRSRAN_SYNC_NOFOUND;
+
+  if (peak_position) {
+    *peak_position = 0;
+  }
+
+  // Retrieve CFO from a set of candidates
+  if (q->enable_cfo_cand_test) {
+    q->mean_cfo     = q->cfo_cand[q->cfo_cand_idx] / 15000;
+    q->cfo_cand_idx = (q->cfo_cand_idx + 1) % q->cfo_num_cand;
+  }
+  srsran_npss_stream_set_cfo(&q->npss_stream, -q->mean_cfo / q->fft_size);
+
+  int64_t input_start = (int64_t)q->npss_stream.nof_samples;
+  int     nof_frames  = srsran_npss_stream_run(&q->npss_stream, input, q->frame_size);
+  if (nof_frames < 0) {
+    fprintf(stderr, "Error running NPSS stream\n");
+    return SRSRAN_SYNC_ERROR;
+  }
+  if (nof_frames == 0) {
+    return SRSRAN_SYNC_NOFOUND;
+  }
+
+  int64_t frame_len = SRSRAN_NOF_SF_X_FRAME * SRSRAN_SF_LEN(q->fft_size);
+  int     peak_pos  = (int)(((q->npss_stream.peak_pos - input_start) % frame_len + frame_len) % frame_len);
+  if (peak_position) {
+    *peak_position = (uint32_t)peak_pos;
+  }
+
+  q->peak_value = q->npss_stream.psr;
+  if (q->peak_value >= q->threshold) {
+    ret = SRSRAN_SYNC_FOUND;
+  }
+
+  sync_nbiot_estimate_cfo(q, input, peak_pos);
+
+  DEBUG("sync_nbiot stream ret=%d frame_len=%d, pos=%d peak=%.2f threshold=%.2f, CFO=%.3f kHz",
+        ret,
+        q->frame_size,
+        peak_pos,
+        q->peak_value,
+        q->threshold,
+        15 * (q->mean_cfo));
+
+  return ret;
+}
+
 // Use two OFDM symbols to estimate CFO
 float cfo_estimate_nbiot(srsran_sync_nbiot_t* q, cf_t* input)
 {
@@ -305,6 +380,7 @@ void srsran_sync_nbiot_set_cfo_ema_alpha(srsran_sync_nbiot_t* q, float alpha)
 void srsran_sync_nbiot_set_npss_ema_alpha(srsran_sync_nbiot_t* q, float alpha)
 {
   srsran_npss_synch_set_ema_alpha(&q->npss, alpha);
+  srsran_npss_stream_set_ema_alpha(&q->npss_stream, alpha);
 }
 
 /** Determines the N_id_ncell using the samples in the buffer input.
@@ -352,4 +428,5 @@ float srsran_sync_nbiot_get_peak_value(srsran_sync_nbiot_t* q)
 void srsran_sync_nbiot_reset(srsran_sync_nbiot_t* q)
 {
   srsran_npss_synch_reset(&q->npss);
+  srsran_npss_stream_reset(&q->npss_stream);
 }
@@ -31,6 +31,7 @@
 #include "srsran/srsran.h"
 
 #define MAX_MSE 0.1
+#define MAX_NCO_ERROR 1e-3
 
 float freq        = 0;
 int   num_samples = 1000;
@@ -101,9 +102,45 @@ int main(int argc, char** argv)
     mse += cabsf(input[i] - output[i]) / num_samples;
   }
 
+  // Correct a constant signal in blocks of varying size on two channels, the output must be a single continuous tone
+  cf_t* in_ptr[2]  = {input, input};
+  cf_t* out_ptr[2] = {output, NULL};
+  cf_t* output2    = srsran_vec_cf_malloc(num_samples);
+  if (!output2) {
+    perror("malloc");
+    exit(-1);
+  }
+  out_ptr[1] = output2;
+  for (i = 0; i < num_samples; i++) {
+    input[i] = 1.0f;
+  }
+  srsran_cfo_nco_reset(&cfocorr);
+  for (int n = 0, k = 0; n < num_samples; k++) {
+    int len = SRSRAN_MIN(1 + (k * 37) % 101, num_samples - n);
+    srsran_cfo_nco_correct(&cfocorr, in_ptr, out_ptr, 2, freq, len);
+    in_ptr[0] += len;
+    in_ptr[1] += len;
+    out_ptr[0] += len;
+    out_ptr[1] += len;
+    n += len;
+  }
+  float nco_error = 0;
+  for (i = 0; i < num_samples; i++) {
+    cf_t expected = (cf_t)cexp(I * 2.0 * M_PI * fmod((double)freq * i, 1.0));
+    nco_error     = SRSRAN_MAX(nco_error, cabsf(output[i] - expected));
+    nco_error     = SRSRAN_MAX(nco_error, cabsf(output2[i] - expected));
+  }
+  printf("NCO max error: %e\n", nco_error);
+
   srsran_cfo_free(&cfocorr);
   free(input);
   free(output);
+  free(output2);
+
+  if (nco_error > MAX_NCO_ERROR) {
+    printf("NCO error too large\n");
+    exit(-1);
+  }
 
   printf("MSE: %f\n", mse);
   if (mse > MAX_MSE) {
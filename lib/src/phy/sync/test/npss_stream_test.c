@@ -0,0 +1,195 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <complex.h>
+#include <getopt.h>
+#include <math.h>
+#include <stdlib.h>
+#include <sys/time.h>
+
+#include "srsran/phy/channel/ch_awgn.h"
+#include "srsran/phy/sync/npss.h"
+#include "srsran/srsran.h"
+
+#define SF_LEN SRSRAN_SF_LEN(SRSRAN_NBIOT_FFT_SIZE)
+#define FRAME_LEN (SRSRAN_NOF_SF_X_FRAME * SF_LEN)
+
+static uint32_t nof_frames = 8;
+static uint32_t offset     = 5000;
+static float    cfo_hz     = 0.0f;
+static float    snr_db     = 10.0f;
+
+static void usage(char* prog)
+{
+  printf("Usage: %s [nofSv]\n", prog);
+  printf("\t-n Number of frames [Default %d]\n", nof_frames);
+  printf("\t-o Time offset in samples [Default %d]\n", offset);
+  printf("\t-f Frequency offset in Hz, corrected by the detector [Default %.0f]\n", cfo_hz);
+  printf("\t-S SNR in dB [Default %.1f]\n", snr_db);
+  printf("\t-v srsran_verbose\n");
+}
+
+static void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "nofSv")) != -1) {
+    switch (opt) {
+      case 'n':
+        nof_frames = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'o':
+        offset = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'f':
+        cfo_hz = strtof(argv[optind], NULL);
+        break;
+      case 'S':
+        snr_db = strtof(argv[optind], NULL);
+        break;
+      case 'v':
+        increase_srsran_verbose_level();
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+int main(int argc, char** argv)
+{
+  struct timeval       t[3]        = {};
+  srsran_npss_stream_t stream      = {};
+  srsran_npss_synch_t  npss        = {};
+  srsran_ofdm_t        ifft        = {};
+  cf_t*                sf_symbols  = NULL;
+  cf_t*                sf_npss     = NULL;
+  cf_t*                capture     = NULL;
+  int                  ret         = SRSRAN_ERROR;
+  float                peak_value  = 0.0f;
+  uint32_t             nof_samples = 0;
+
+  parse_args(argc, argv);
+
+  nof_samples = offset + nof_frames * FRAME_LEN;
+  sf_symbols  = srsran_vec_cf_malloc(SRSRAN_NRE * SRSRAN_CP_NORM_SF_NSYMB);
+  sf_npss     = srsran_vec_cf_malloc(SF_LEN);
+  capture     = srsran_vec_cf_malloc(nof_samples);
+  if (!sf_symbols || !sf_npss || !capture) {
+    goto clean_exit;
+  }
+  srsran_vec_cf_zero(sf_symbols, SRSRAN_NRE * SRSRAN_CP_NORM_SF_NSYMB);
+  srsran_vec_cf_zero(capture, nof_samples);
+
+  if (srsran_npss_stream_init(&stream, SRSRAN_NBIOT_FFT_SIZE) ||
+      srsran_npss_synch_init(&npss, FRAME_LEN, SRSRAN_NBIOT_FFT_SIZE)) {
+    ERROR("Error initializing NPSS objects");
+    goto clean_exit;
+  }
+
+  // NPSS subframe, as the eNodeB generates it
+  if (srsran_ofdm_tx_init(&ifft, SRSRAN_CP_NORM, sf_symbols, sf_npss, SRSRAN_NBIOT_DEFAULT_NUM_PRB_BASECELL)) {
+    ERROR("Error creating iFFT object");
+    goto clean_exit;
+  }
+  srsran_ofdm_set_freq_shift(&ifft, -SRSRAN_NBIOT_FREQ_SHIFT_FACTOR);
+  cf_t npss_signal[SRSRAN_NPSS_TOT_LEN];
+  srsran_npss_generate(npss_signal);
+  srsran_npss_put_subframe(
+      &npss, npss_signal, sf_symbols, SRSRAN_NBIOT_DEFAULT_NUM_PRB_BASECELL, SRSRAN_NBIOT_DEFAULT_PRB_OFFSET);
+  srsran_ofdm_tx_sf(&ifft);
+
+  // Subframe 5 of every frame, after offset samples, with a frequency offset and noise
+  for (uint32_t f = 0; f < nof_frames; f++) {
+    srsran_vec_cf_copy(&capture[offset + f * FRAME_LEN + 5 * SF_LEN], sf_npss, SF_LEN);
+  }
+  for (uint32_t i = 0; i < nof_samples; i++) {
+    capture[i] *= (cf_t)cexp(I * 2.0 * M_PI * cfo_hz * i / SRSRAN_CS_SAMP_FREQ);
+  }
+  srsran_channel_awgn_t awgn = {};
+  srsran_channel_awgn_init(&awgn, 1234);
+  srsran_channel_awgn_set_n0(&awgn, srsran_convert_power_to_dB(srsran_vec_avg_power_cf(sf_npss, SF_LEN)) - snr_db);
+  srsran_channel_awgn_run_c(&awgn, capture, capture, nof_samples);
+  srsran_channel_awgn_free(&awgn);
+
+  // Feed the stream in buffers of varying size
+  srsran_npss_stream_set_cfo(&stream, -cfo_hz / SRSRAN_CS_SAMP_FREQ);
+  uint32_t nof_detections = 0;
+  gettimeofday(&t[1], NULL);
+  for (uint32_t count = 0, b = 0; count < nof_samples; b++) {
+    uint32_t n = SRSRAN_MIN(1 + (b * 397) % 3000, nof_samples - count);
+    int      r = srsran_npss_stream_run(&stream, &capture[count], n);
+    if (r < SRSRAN_SUCCESS) {
+      ERROR("Error running NPSS stream");
+      goto clean_exit;
+    }
+    nof_detections += r;
+    count += n;
+  }
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+  uint64_t stream_us = (uint64_t)(t[0].tv_sec * 1000000UL + t[0].tv_usec);
+
+  // Full-rate search of every frame, for reference
+  gettimeofday(&t[1], NULL);
+  for (uint32_t f = 0; f < nof_frames; f++) {
+    srsran_npss_sync_find(&npss, &capture[f * FRAME_LEN], &peak_value);
+  }
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+  uint64_t full_us = (uint64_t)(t[0].tv_sec * 1000000UL + t[0].tv_usec);
+
+  // The template starts after the first 3 symbols of subframe 5
+  int64_t expected = offset + 5 * SF_LEN + SRSRAN_NPSS_CORR_OFFSET;
+  int64_t error    = ((stream.peak_pos - expected) % FRAME_LEN + FRAME_LEN) % FRAME_LEN;
+  if (error > FRAME_LEN / 2) {
+    error -= FRAME_LEN;
+  }
+
+  printf("Frames=%d/%d; peak at %ld, error %ld samples; PSR=%.2f; stream %ld us, full-rate %ld us\n",
+         nof_detections,
+         nof_frames,
+         (long)stream.peak_pos,
+         (long)error,
+         stream.psr,
+         (long)stream_us,
+         (long)full_us);
+
+  if (nof_detections == nof_frames && labs((long)error) <= 2 && stream.psr > 2.5f) {
+    ret = SRSRAN_SUCCESS;
+  }
+
+clean_exit:
+  srsran_npss_stream_free(&stream);
+  srsran_npss_synch_free(&npss);
+  srsran_ofdm_tx_free(&ifft);
+  if (sf_symbols) {
+    free(sf_symbols);
+  }
+  if (sf_npss) {
+    free(sf_npss);
+  }
+  if (capture) {
+    free(capture);
+  }
+  printf("%s\n", ret == SRSRAN_SUCCESS ? "Ok" : "Failed");
+  return ret;
+}
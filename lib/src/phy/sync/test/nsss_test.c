@@ -122,6 +122,7 @@ int main(int argc, char** argv)
     fprintf(stderr, "Error creating iFFT object\n");
     goto exit;
   }
+  srsran_ofdm_set_freq_shift(&ifft, -SRSRAN_NBIOT_FREQ_SHIFT_FACTOR);
 
   if (input_file_name != NULL) {
     srsran_filesource_t fsrc;
@@ -184,7 +185,8 @@ int main(int argc, char** argv)
   srsran_nsss_sync_find(&syncobj, fft_buffer, &peak_value, &n_id_ncell_detected, &sfn_partial);
   printf("NSSS with peak=%f, n_id_ncell: %d, partial SFN: %x\n", peak_value, n_id_ncell_detected, sfn_partial);
 
-  if (n_id_ncell_detected == (n_id_ncell == SRSRAN_CELL_ID_UNKNOWN ? 0 : n_id_ncell)) {
+  bool sfn_ok = input_file_name != NULL || sfn_partial == (uint32_t)(sfn / 2) % SRSRAN_NSSS_NUM_SEQ;
+  if (n_id_ncell_detected == (n_id_ncell == SRSRAN_CELL_ID_UNKNOWN ? 0 : n_id_ncell) && sfn_ok) {
     printf("Ok\n");
     ret = SRSRAN_SUCCESS;
   } else {
@@ -198,16 +200,7 @@ int main(int argc, char** argv)
   snprintf(fname, MAX_FNAME_LEN, "nsss_find_input.bin");
   printf("Saving entire sub-frame to %s\n", fname);
   srsran_vec_save_file(fname, fft_buffer, num_sf * SFLEN * sizeof(cf_t));
-  srsran_vec_save_file("nsss_corr_seq_time.bin",
-                       syncobj.nsss_signal_time[n_id_ncell == SRSRAN_CELL_ID_UNKNOWN ? 0 : n_id_ncell],
-                       SRSRAN_NSSS_CORR_FILTER_LEN * sizeof(cf_t));
-  if (n_id_ncell_detected != SRSRAN_CELL_ID_UNKNOWN) {
-    // run correlation again with found cell to populate conv_output_abs
-    srsran_nsss_sync_find(&syncobj, fft_buffer, &peak_value, &n_id_ncell_detected, &sfn_partial);
-  }
-  srsran_vec_save_file("nsss_find_conv_output_abs.bin",
-                       syncobj.conv_output_abs,
-                       (SRSRAN_NSSS_CORR_FILTER_LEN + num_sf * SFLEN) * sizeof(float));
+  srsran_vec_save_file("nsss_find_peak_values.bin", syncobj.peak_values, SRSRAN_NUM_PCI * sizeof(float));
 
   // write Octave script
   write_to_file();
@@ -242,15 +235,6 @@ void write_to_file()
   fprintf(debug_fsink.f, "set(0,'DefaultFigureWindowStyle','docked');\n\n");
   fprintf(debug_fsink.f, "max_len = 1920 * 100;\n");
 
-  // the correlation sequence
-  fprintf(debug_fsink.f, "corr_seq=read_complex('nsss_corr_seq_time.bin', max_len);\n");
-  fprintf(debug_fsink.f, "figure;\n");
-  fprintf(debug_fsink.f, "t=1:length(corr_seq);\n");
-  fprintf(debug_fsink.f, "plot(t,real(corr_seq),t,imag(corr_seq));\n");
-  fprintf(debug_fsink.f, "xlabel('sample index');\n");
-  fprintf(debug_fsink.f, "title('Correlation sequence time-domain');\n");
-  fprintf(debug_fsink.f, "\n\n");
-
   // the generated subframe
   fprintf(debug_fsink.f, "input=read_complex('nsss_find_input.bin', max_len);\n");
   fprintf(debug_fsink.f, "figure;\n");
@@ -260,23 +244,13 @@ void write_to_file()
   fprintf(debug_fsink.f, "title('Subframe time-domain');\n");
   fprintf(debug_fsink.f, "\n\n");
 
-  // the correlation output
-  fprintf(debug_fsink.f, "corr_srsran = read_real('nsss_find_conv_output_abs.bin', max_len);\n");
-  fprintf(debug_fsink.f, "t=1:length(corr_srsran);\n");
+  // the correlation of every cell ID
+  fprintf(debug_fsink.f, "corr_srsran = read_real('nsss_find_peak_values.bin', max_len);\n");
   fprintf(debug_fsink.f, "figure;\n");
-  fprintf(debug_fsink.f, "plot(t,corr_srsran);\n");
-  fprintf(debug_fsink.f, "xlabel('sample index');\n");
-  fprintf(debug_fsink.f, "title('Convolution output absolute');\n");
-  fprintf(debug_fsink.f, "ylabel('Auto-correlation magnitude');\n");
-  fprintf(debug_fsink.f, "\n\n");
-
-  // correlation in octave
-  fprintf(debug_fsink.f, "[corr_oct, lag] = xcorr(input,corr_seq);\n");
-  fprintf(debug_fsink.f, "figure;\n");
-  fprintf(debug_fsink.f, "plot(abs(corr_oct));\n");
-  fprintf(debug_fsink.f, "xlabel('sample index');\n");
-  fprintf(debug_fsink.f, "title('Correlation in Octave');\n");
-  fprintf(debug_fsink.f, "ylabel('Correlation magnitude');\n");
+  fprintf(debug_fsink.f, "plot(0:length(corr_srsran)-1,corr_srsran);\n");
+  fprintf(debug_fsink.f, "xlabel('n_id_ncell');\n");
+  fprintf(debug_fsink.f, "title('NSSS correlation');\n");
+  fprintf(debug_fsink.f, "ylabel('Normalised correlation');\n");
   fprintf(debug_fsink.f, "\n\n");
 
   srsran_filesink_free(&debug_fsink);
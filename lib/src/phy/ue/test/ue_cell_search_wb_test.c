@@ -0,0 +1,304 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/phy/channel/ch_awgn.h"
+#include "srsran/phy/enb/enb_dl.h"
+#include "srsran/phy/io/filesource.h"
+#include "srsran/phy/resampling/resampler.h"
+#include "srsran/phy/ue/ue_cell_search_wb.h"
+#include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/vector.h"
+#include <complex.h>
+#include <getopt.h>
+#include <math.h>
+#include <stdlib.h>
+#include <sys/time.h>
+
+#define MAX_CELLS 8
+#define MAX_RESULTS 64
+
+typedef struct {
+  uint32_t pci;
+  uint32_t nof_prb;
+  double   offset_hz;
+  float    gain_db;
+} test_cell_t;
+
+// Cells of the synthetic capture, with different bandwidths, powers and frame timings
+static test_cell_t cells[MAX_CELLS] = {{1, 6, -5.0e6, 0.0f}, {150, 15, 2.3e6, -3.0f}, {302, 6, 6.8e6, -6.0f}};
+static uint32_t    nof_cells        = 3;
+
+static srsran_ue_cellsearch_wb_args_t args          = {};
+static uint32_t                       duration_ms   = 40;
+static float                          snr_db        = 10.0f;
+static char*                          input_file    = NULL;
+static char*                          output_file   = NULL;
+static uint32_t                       nof_cells_arg = 0;
+
+static void usage(char* prog)
+{
+  printf("Usage: %s [snWSiocv]\n", prog);
+  printf("\t-s Sampling rate [Default %.2f MHz]\n", args.srate_hz / 1e6);
+  printf("\t-n Capture duration in ms [Default %d]\n", duration_ms);
+  printf("\t-W Number of worker threads [Default %d]\n", args.nof_workers);
+  printf("\t-S SNR of the synthetic capture in dB [Default %.1f]\n", snr_db);
+  printf("\t-i Read the capture from a file instead of generating it\n");
+  printf("\t-o Save the synthetic capture to a file\n");
+  printf("\t-c Expected cell pci:nof_prb:offset_khz, can be repeated [Default the synthetic cells]\n");
+  printf("\t-v increase verbosity\n");
+}
+
+static void parse_args(int argc, char** argv)
+{
+  int opt;
+
+  while ((opt = getopt(argc, argv, "snWSiocv")) != -1) {
+    switch (opt) {
+      case 's':
+        args.srate_hz = strtod(argv[optind], NULL);
+        break;
+      case 'n':
+        duration_ms = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'W':
+        args.nof_workers = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'S':
+        snr_db = strtof(argv[optind], NULL);
+        break;
+      case 'i':
+        input_file = argv[optind];
+        break;
+      case 'o':
+        output_file = argv[optind];
+        break;
+      case 'c':
+        if (nof_cells_arg < MAX_CELLS) {
+          double offset_khz = 0;
+          if (sscanf(argv[optind],
+                     "%u:%u:%lf",
+                     &cells[nof_cells_arg].pci,
+                     &cells[nof_cells_arg].nof_prb,
+                     &offset_khz) == 3) {
+            cells[nof_cells_arg].offset_hz = offset_khz * 1e3;
+            cells[nof_cells_arg].gain_db   = -3.0f * nof_cells_arg;
+            nof_cells_arg++;
+            nof_cells = nof_cells_arg;
+          }
+        }
+        break;
+      case 'v':
+        increase_srsran_verbose_level();
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+/* Adds a cell to the capture: enb_dl subframes at the cell rate, interpolated to the capture rate and shifted to the
+ * cell carrier */
+static int add_cell(const test_cell_t* tc, uint32_t cell_idx, cf_t* capture, uint32_t nof_samples)
+{
+  int                    ret       = SRSRAN_ERROR;
+  srsran_enb_dl_t        enb_dl    = {};
+  srsran_resampler_fft_t interp    = {};
+  cf_t*                  sf_buffer = NULL;
+  cf_t*                  sf_interp = NULL;
+
+  uint32_t cell_srate = (uint32_t)srsran_sampling_freq_hz(tc->nof_prb);
+  uint32_t ratio      = (uint32_t)round(args.srate_hz / cell_srate);
+  if (ratio * cell_srate != (uint32_t)args.srate_hz) {
+    ERROR("The capture rate must be a multiple of the %d PRB cell rate", tc->nof_prb);
+    return SRSRAN_ERROR;
+  }
+  uint32_t sf_len = SRSRAN_SF_LEN_PRB(tc->nof_prb);
+
+  srsran_cell_t cell   = {};
+  cell.id              = tc->pci;
+  cell.nof_prb         = tc->nof_prb;
+  cell.nof_ports       = 1;
+  cell.cp              = SRSRAN_CP_NORM;
+  cell.phich_length    = SRSRAN_PHICH_NORM;
+  cell.phich_resources = SRSRAN_PHICH_R_1;
+  cell.frame_type      = SRSRAN_FDD;
+
+  sf_buffer = srsran_vec_cf_malloc(sf_len);
+  sf_interp = srsran_vec_cf_malloc(sf_len * ratio);
+  if (sf_buffer == NULL || sf_interp == NULL) {
+    goto clean_exit;
+  }
+  cf_t* enb_buffer[SRSRAN_MAX_PORTS] = {sf_buffer};
+  if (srsran_enb_dl_init(&enb_dl, enb_buffer, tc->nof_prb) || srsran_enb_dl_set_cell(&enb_dl, cell)) {
+    ERROR("Error initialising enb_dl");
+    goto clean_exit;
+  }
+  if (ratio > 1 && srsran_resampler_fft_init(&interp, SRSRAN_RESAMPLER_MODE_INTERPOLATE, ratio)) {
+    ERROR("Error initialising interpolator");
+    goto clean_exit;
+  }
+
+  // Every cell has a different subframe number and timing at the start of the capture
+  uint32_t           tti     = 3 * cell_idx;
+  uint32_t           delay   = 1013 * cell_idx;
+  float              gain    = srsran_convert_dB_to_amplitude(tc->gain_db);
+  double             phase   = 0.0;
+  double             phase_s = 2.0 * M_PI * tc->offset_hz / args.srate_hz;
+  srsran_dl_sf_cfg_t dl_sf   = {};
+  dl_sf.cfi                  = 1;
+  for (uint32_t pos = delay; pos < nof_samples; tti++) {
+    dl_sf.tti = tti % 10240;
+    srsran_enb_dl_put_base(&enb_dl, &dl_sf);
+    srsran_enb_dl_gen_signal(&enb_dl);
+    if (ratio > 1) {
+      srsran_resampler_fft_run(&interp, sf_buffer, sf_interp, sf_len);
+    } else {
+      srsran_vec_cf_copy(sf_interp, sf_buffer, sf_len);
+    }
+
+    // Shift to the carrier with a double precision phase, continuous over the whole capture
+    uint32_t n = SRSRAN_MIN(sf_len * ratio, nof_samples - pos);
+    for (uint32_t i = 0; i < n; i++) {
+      capture[pos + i] += gain * sf_interp[i] * (cf_t)cexp(I * phase);
+      phase = fmod(phase + phase_s, 2.0 * M_PI);
+    }
+    pos += n;
+  }
+
+  ret = SRSRAN_SUCCESS;
+
+clean_exit:
+  srsran_enb_dl_free(&enb_dl);
+  srsran_resampler_fft_free(&interp);
+  if (sf_buffer) {
+    free(sf_buffer);
+  }
+  if (sf_interp) {
+    free(sf_interp);
+  }
+  return ret;
+}
+
+int main(int argc, char** argv)
+{
+  struct timeval                   t[3]                 = {};
+  srsran_ue_cellsearch_wb_t        cs                   = {};
+  srsran_ue_cellsearch_wb_result_t results[MAX_RESULTS] = {};
+  int                              ret                  = SRSRAN_ERROR;
+
+  srsran_ue_cellsearch_wb_args_default(&args);
+  parse_args(argc, argv);
+
+  uint32_t nof_samples = (uint32_t)(args.srate_hz / 1000) * duration_ms;
+  args.max_samples     = nof_samples;
+  cf_t* capture        = srsran_vec_cf_malloc(nof_samples);
+  if (capture == NULL) {
+    return SRSRAN_ERROR;
+  }
+  srsran_vec_cf_zero(capture, nof_samples);
+
+  if (input_file) {
+    srsran_filesource_t fsrc = {};
+    if (srsran_filesource_init(&fsrc, input_file, SRSRAN_COMPLEX_FLOAT_BIN)) {
+      ERROR("Error opening file %s", input_file);
+      goto clean_exit;
+    }
+    int nread = srsran_filesource_read(&fsrc, capture, nof_samples);
+    srsran_filesource_free(&fsrc);
+    if (nread <= 0) {
+      ERROR("Error reading file %s", input_file);
+      goto clean_exit;
+    }
+    nof_samples = (uint32_t)nread;
+  } else {
+    for (uint32_t i = 0; i < nof_cells; i++) {
+      if (add_cell(&cells[i], i, capture, nof_samples) < SRSRAN_SUCCESS) {
+        goto clean_exit;
+      }
+    }
+
+    srsran_channel_awgn_t awgn = {};
+    srsran_channel_awgn_init(&awgn, 1234);
+    srsran_channel_awgn_set_n0(&awgn, srsran_convert_power_to_dB(srsran_vec_avg_power_cf(capture, nof_samples)) - snr_db);
+    srsran_channel_awgn_run_c(&awgn, capture, capture, nof_samples);
+    srsran_channel_awgn_free(&awgn);
+
+    if (output_file) {
+      printf("Saving capture to %s\n", output_file);
+      srsran_vec_save_file(output_file, capture, sizeof(cf_t) * nof_samples);
+    }
+  }
+
+  if (srsran_ue_cellsearch_wb_init(&cs, &args) < SRSRAN_SUCCESS) {
+    ERROR("Error initialising wideband cell search");
+    goto clean_exit;
+  }
+
+  gettimeofday(&t[1], NULL);
+  int n = srsran_ue_cellsearch_wb_scan(&cs, capture, nof_samples, results, MAX_RESULTS);
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+  if (n < SRSRAN_SUCCESS) {
+    ERROR("Error in wideband cell search");
+    goto clean_exit;
+  }
+
+  // Every cell must be found, with its PCI, on its carrier
+  uint32_t nof_matched = 0;
+  for (int i = 0; i < n; i++) {
+    bool expected = false;
+    for (uint32_t j = 0; j < nof_cells; j++) {
+      if (results[i].cell.cell_id == cells[j].pci &&
+          fabs(results[i].freq_offset_hz - cells[j].offset_hz) < SRSRAN_CS_WB_RASTER_HZ / 2) {
+        expected = true;
+      }
+    }
+    nof_matched += expected ? 1 : 0;
+    printf("%s cell_id=%3d offset=%+7.1f kHz peak=%.2f psr=%.2f cfo=%+.1f kHz\n",
+           expected ? "Found" : "Extra",
+           results[i].cell.cell_id,
+           results[i].freq_offset_hz / 1e3,
+           results[i].cell.peak,
+           results[i].cell.psr,
+           results[i].cell.cfo / 1e3);
+  }
+
+  printf("Searched %d carriers of %.1f ms at %.2f MHz in %ld.%06ld s; found %d/%d cells, %d extra\n",
+         cs.nof_carriers,
+         (double)nof_samples * 1e3 / args.srate_hz,
+         args.srate_hz / 1e6,
+         t[0].tv_sec,
+         t[0].tv_usec,
+         nof_matched,
+         nof_cells,
+         n - (int)nof_matched);
+
+  if (nof_matched == nof_cells && n == (int)nof_matched) {
+    ret = SRSRAN_SUCCESS;
+  }
+
+clean_exit:
+  srsran_ue_cellsearch_wb_free(&cs);
+  free(capture);
+
+  return ret;
+}
@@ -0,0 +1,362 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "srsran/phy/ch_estimation/chest_sl.h"
+#include "srsran/phy/common/phy_common_sl.h"
+#include "srsran/phy/dft/ofdm.h"
+#include "srsran/phy/io/filesource.h"
+#include "srsran/phy/phch/pscch.h"
+#include "srsran/phy/ue/ue_sl_rx.h"
+#include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/vector.h"
+
+/*
+ * Benchmark of the sidelink receiver over recorded IQ. Every subframe of the file is searched with the receiver and,
+ * with -S, with the exhaustive search (channel estimation and PSCCH decoding of every cyclic shift of every
+ * sub-channel) for comparison. Each subframe is processed -R times to time it.
+ */
+
+static char*            input_file_name = NULL;
+static srsran_cell_sl_t cell            = {.nof_prb = 50, .N_sl_id = 0, .tm = SRSRAN_SIDELINK_TM4, .cp = SRSRAN_CP_NORM};
+static bool             use_standard_lte_rates = false;
+static uint32_t         file_offset            = 0;
+static uint32_t         size_sub_channel       = 10;
+static uint32_t         num_sub_channel        = 5;
+static uint32_t         current_sf_idx         = 0;
+static uint32_t         nof_workers            = 0;
+static uint32_t         nof_repetitions        = 1;
+static bool             run_reference          = false;
+
+static srsran_filesource_t            fsrc                  = {};
+static srsran_ofdm_t                  fft                   = {};
+static srsran_sl_comm_resource_pool_t sl_comm_resource_pool = {};
+static srsran_ue_sl_rx_t              ue_sl_rx              = {};
+static cf_t*                          input_buffer          = NULL;
+static cf_t*                          sf_buffer             = NULL;
+
+// Exhaustive search
+static srsran_pscch_t    pscch               = {};
+static srsran_chest_sl_t pscch_chest         = {};
+static srsran_sci_t      sci                 = {};
+static cf_t*             equalized_sf_buffer = NULL;
+
+void usage(char* prog)
+{
+  printf("Usage: %s [dimnoprsStvRW] -i input_file\n", prog);
+  printf("\t-i input_file_name\n");
+  printf("\t-o File offset samples [Default %d]\n", file_offset);
+  printf("\t-p nof_prb [Default %d]\n", cell.nof_prb);
+  printf("\t-s size_sub_channel [Default %d]\n", size_sub_channel);
+  printf("\t-n num_sub_channel [Default %d]\n", num_sub_channel);
+  printf("\t-m Subframe index of the first subframe [Default %d]\n", current_sf_idx);
+  printf("\t-t Sidelink transmission mode {3,4} [Default %d]\n", (cell.tm + 1));
+  printf("\t-d use_standard_lte_rates [Default %i]\n", use_standard_lte_rates);
+  printf("\t-W Number of receiver worker threads [Default %d]\n", nof_workers);
+  printf("\t-R Number of times each subframe is processed [Default %d]\n", nof_repetitions);
+  printf("\t-S Also run the exhaustive search and check both agree [Default %s]\n", run_reference ? "yes" : "no");
+  printf("\t-v [set srsran_verbose to debug, default none]\n");
+}
+
+void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "dimnopstvRSW")) != -1) {
+    switch (opt) {
+      case 'd':
+        use_standard_lte_rates = true;
+        break;
+      case 'i':
+        input_file_name = argv[optind];
+        break;
+      case 'm':
+        current_sf_idx = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'n':
+        num_sub_channel = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'o':
+        file_offset = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'p':
+        cell.nof_prb = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 's':
+        size_sub_channel = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 't':
+        if (srsran_sl_tm_to_cell_sl_tm_t(&cell, strtol(argv[optind], NULL, 10)) != SRSRAN_SUCCESS) {
+          usage(argv[0]);
+          exit(-1);
+        }
+        break;
+      case 'v':
+        increase_srsran_verbose_level();
+        break;
+      case 'R':
+        nof_repetitions = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'S':
+        run_reference = true;
+        break;
+      case 'W':
+        nof_workers = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+  if (input_file_name == NULL || nof_repetitions == 0) {
+    usage(argv[0]);
+    exit(-1);
+  }
+}
+
+static int base_init()
+{
+  uint32_t sf_n_samples = srsran_symbol_sz(cell.nof_prb) * 15;
+  uint32_t sf_n_re      = SRSRAN_SF_LEN_RE(cell.nof_prb, cell.cp);
+
+  if (srsran_sl_comm_resource_pool_get_default_config(&sl_comm_resource_pool, cell) != SRSRAN_SUCCESS) {
+    ERROR("Error initializing sl_comm_resource_pool");
+    return SRSRAN_ERROR;
+  }
+  sl_comm_resource_pool.num_sub_channel  = num_sub_channel;
+  sl_comm_resource_pool.size_sub_channel = size_sub_channel;
+
+  input_buffer        = srsran_vec_cf_malloc(sf_n_samples);
+  sf_buffer           = srsran_vec_cf_malloc(sf_n_re);
+  equalized_sf_buffer = srsran_vec_cf_malloc(sf_n_re);
+  if (input_buffer == NULL || sf_buffer == NULL || equalized_sf_buffer == NULL) {
+    ERROR("Error allocating memory");
+    return SRSRAN_ERROR;
+  }
+  srsran_vec_cf_zero(input_buffer, sf_n_samples);
+  srsran_vec_cf_zero(sf_buffer, sf_n_re);
+
+  srsran_ue_sl_rx_args_t args = {};
+  srsran_ue_sl_rx_args_default(&args);
+  args.nof_workers = nof_workers;
+  if (srsran_ue_sl_rx_init(&ue_sl_rx, cell, &sl_comm_resource_pool, &args) != SRSRAN_SUCCESS) {
+    ERROR("Error initializing sidelink receiver");
+    return SRSRAN_ERROR;
+  }
+
+  if (srsran_sci_init(&sci, &cell, &sl_comm_resource_pool) < SRSRAN_SUCCESS ||
+      srsran_pscch_init(&pscch, SRSRAN_MAX_PRB) != SRSRAN_SUCCESS ||
+      srsran_pscch_set_cell(&pscch, cell) != SRSRAN_SUCCESS ||
+      srsran_chest_sl_init(&pscch_chest, SRSRAN_SIDELINK_PSCCH, cell, &sl_comm_resource_pool) != SRSRAN_SUCCESS) {
+    ERROR("Error initializing PSCCH");
+    return SRSRAN_ERROR;
+  }
+
+  if (srsran_filesource_init(&fsrc, input_file_name, SRSRAN_COMPLEX_FLOAT_BIN)) {
+    ERROR("Error opening file %s", input_file_name);
+    return SRSRAN_ERROR;
+  }
+
+  if (srsran_ofdm_rx_init(&fft, cell.cp, input_buffer, sf_buffer, cell.nof_prb)) {
+    ERROR("Error creating FFT object");
+    return SRSRAN_ERROR;
+  }
+  srsran_ofdm_set_normalize(&fft, true);
+  srsran_ofdm_set_freq_shift(&fft, -0.5);
+
+  return SRSRAN_SUCCESS;
+}
+
+static void base_free()
+{
+  srsran_filesource_free(&fsrc);
+  srsran_ofdm_rx_free(&fft);
+  srsran_ue_sl_rx_free(&ue_sl_rx);
+  srsran_sci_free(&sci);
+  srsran_pscch_free(&pscch);
+  srsran_chest_sl_free(&pscch_chest);
+
+  if (input_buffer) {
+    free(input_buffer);
+  }
+  if (sf_buffer) {
+    free(sf_buffer);
+  }
+  if (equalized_sf_buffer) {
+    free(equalized_sf_buffer);
+  }
+}
+
+/// Exhaustive search, as done by the examples. Returns a bitmap of the sub-channels with a SCI
+static uint64_t reference_search()
+{
+  uint64_t              found                      = 0;
+  uint8_t               sci_rx[SRSRAN_SCI_MAX_LEN] = {};
+  srsran_chest_sl_cfg_t pscch_chest_sl_cfg         = {};
+
+  for (uint32_t sub_channel_idx = 0; sub_channel_idx < sl_comm_resource_pool.num_sub_channel; sub_channel_idx++) {
+    uint32_t pscch_prb_start_idx = sl_comm_resource_pool.size_sub_channel * sub_channel_idx;
+    for (uint32_t cyclic_shift = 0; cyclic_shift <= 9; cyclic_shift += 3) {
+      pscch_chest_sl_cfg.cyclic_shift  = cyclic_shift;
+      pscch_chest_sl_cfg.prb_start_idx = pscch_prb_start_idx;
+      srsran_chest_sl_set_cfg(&pscch_chest, pscch_chest_sl_cfg);
+      srsran_chest_sl_ls_estimate_equalize(&pscch_chest, sf_buffer, equalized_sf_buffer);
+
+      if (srsran_pscch_decode(&pscch, equalized_sf_buffer, sci_rx, pscch_prb_start_idx) == SRSRAN_SUCCESS &&
+          srsran_sci_format1_unpack(&sci, sci_rx) == SRSRAN_SUCCESS) {
+        found |= 1ULL << (sub_channel_idx % 64);
+      }
+    }
+  }
+  return found;
+}
+
+static uint64_t elapsed_us(const struct timeval* t)
+{
+  return (uint64_t)(t[0].tv_sec * 1000000 + t[0].tv_usec);
+}
+
+int main(int argc, char** argv)
+{
+  int ret = SRSRAN_ERROR;
+
+  parse_args(argc, argv);
+  srsran_use_standard_symbol_size(use_standard_lte_rates);
+
+  if (base_init()) {
+    ERROR("Error initializing");
+    base_free();
+    return SRSRAN_ERROR;
+  }
+
+  if (file_offset > 0) {
+    printf("Offsetting file by %d samples.\n", file_offset);
+    srsran_filesource_seek(&fsrc, file_offset * sizeof(cf_t));
+  }
+
+  uint32_t sf_n_samples      = srsran_symbol_sz(cell.nof_prb) * 15;
+  uint32_t num_decoded_sci   = 0;
+  uint32_t num_decoded_tb    = 0;
+  uint32_t num_mismatches    = 0;
+  uint32_t num_subframes     = 0;
+  uint32_t max_num_subframes = 128;
+  uint64_t rx_time_us        = 0;
+  uint64_t reference_time_us = 0;
+  char     sci_msg[SRSRAN_SCI_MSG_MAX_LEN] = {};
+
+  while (num_subframes < max_num_subframes) {
+    int nread = srsran_filesource_read(&fsrc, input_buffer, sf_n_samples);
+    if (nread < 0) {
+      ERROR("Error reading from file");
+      goto clean_exit;
+    } else if (nread == 0) {
+      break;
+    } else if (nread < sf_n_samples) {
+      // Process the partial subframe, with the rest of the buffer zeroed
+      srsran_vec_cf_zero(&input_buffer[nread], sf_n_samples - nread);
+    }
+
+    // Convert to frequency domain
+    srsran_ofdm_rx_sf(&fft);
+
+    struct timeval t[3];
+    int            nof_sci = 0;
+    gettimeofday(&t[1], NULL);
+    for (uint32_t r = 0; r < nof_repetitions; r++) {
+      nof_sci = srsran_ue_sl_rx_decode_sf(&ue_sl_rx, sf_buffer, current_sf_idx);
+    }
+    gettimeofday(&t[2], NULL);
+    get_time_interval(t);
+    rx_time_us += elapsed_us(t);
+    if (nof_sci < SRSRAN_SUCCESS) {
+      ERROR("Error decoding subframe");
+      goto clean_exit;
+    }
+
+    uint64_t found = 0;
+    for (uint32_t i = 0; i < sl_comm_resource_pool.num_sub_channel; i++) {
+      srsran_ue_sl_rx_result_t* res = &ue_sl_rx.results[i];
+      if (!res->sci_decoded) {
+        continue;
+      }
+      found |= 1ULL << (i % 64);
+      num_decoded_sci++;
+      srsran_sci_info(&res->sci, sci_msg, sizeof(sci_msg));
+      printf("sub_channel=%d cyclic_shift=%d corr=%.2f %s\n", i, res->cyclic_shift, res->corr, sci_msg);
+      if (res->tb_decoded) {
+        num_decoded_tb++;
+        if (SRSRAN_VERBOSE_ISINFO()) {
+          srsran_vec_fprint_byte(stdout, res->tb, res->tb_len);
+        }
+      }
+    }
+
+    if (run_reference) {
+      uint64_t reference_found = 0;
+      gettimeofday(&t[1], NULL);
+      for (uint32_t r = 0; r < nof_repetitions; r++) {
+        reference_found = reference_search();
+      }
+      gettimeofday(&t[2], NULL);
+      get_time_interval(t);
+      reference_time_us += elapsed_us(t);
+      if (reference_found != found) {
+        printf("Mismatch in subframe %d: found 0x%lx, exhaustive search found 0x%lx\n",
+               num_subframes,
+               (unsigned long)found,
+               (unsigned long)reference_found);
+        num_mismatches++;
+      }
+    }
+
+    current_sf_idx = (current_sf_idx + 1) % 10;
+    num_subframes++;
+  }
+
+  if (num_subframes > 0) {
+    printf("Processed %d subframes of %d sub-channels with %d workers: %.1f us/subframe\n",
+           num_subframes,
+           sl_comm_resource_pool.num_sub_channel,
+           nof_workers,
+           (double)rx_time_us / (num_subframes * nof_repetitions));
+    printf("Hypotheses decoded=%ld skipped=%ld\n",
+           (long)ue_sl_rx.nof_hypotheses_decoded,
+           (long)ue_sl_rx.nof_hypotheses_skipped);
+    if (run_reference) {
+      printf("Exhaustive search: %.1f us/subframe, mismatches=%d\n",
+             (double)reference_time_us / (num_subframes * nof_repetitions),
+             num_mismatches);
+    }
+  }
+
+  ret = (num_decoded_sci > 0 && num_mismatches == 0) ? SRSRAN_SUCCESS : SRSRAN_ERROR;
+
+clean_exit:
+  base_free();
+
+  printf("num_decoded_sci=%d num_decoded_tb=%d\n", num_decoded_sci, num_decoded_tb);
+
+  return ret;
+}
@@ -0,0 +1,304 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/phy/ue/ue_cell_search_wb.h"
+#include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/vector.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Samples read by srsran_ue_cellsearch_t for each 5 ms frame */
+#define CS_WB_FRAME_LEN ((uint32_t)(SRSRAN_CS_SAMP_FREQ / 200))
+
+/* Carriers closer than this, with the same N_id_2, are the same cell seen through neighbouring channels. Actual
+ * carriers are at least 1.4 MHz apart */
+#define CS_WB_MERGE_DISTANCE_HZ (1.0e6)
+
+/**
+ * Cell search state of a thread. srsran_ue_cellsearch_t reads its samples through a callback, which here reads the
+ * channelizer output of the carrier being searched.
+ */
+typedef struct {
+  srsran_ue_cellsearch_t cs;
+  uint32_t               max_frames; ///< Frames the cell search was allocated for
+  const cf_t*            samples;
+  uint32_t               nof_samples;
+  uint32_t               pos;
+} cs_wb_lane_t;
+
+static int cs_wb_recv(void* h, cf_t* data[SRSRAN_MAX_CHANNELS], uint32_t nsamples, srsran_timestamp_t* t)
+{
+  cs_wb_lane_t* lane = (cs_wb_lane_t*)h;
+
+  // Past the end of the capture the carrier reads zeros
+  uint32_t n = SRSRAN_MIN(nsamples, lane->nof_samples - lane->pos);
+  if (data[0] != NULL) {
+    srsran_vec_cf_copy(data[0], &lane->samples[lane->pos], n);
+    srsran_vec_cf_zero(&data[0][n], nsamples - n);
+  }
+  lane->pos += n;
+
+  if (t != NULL) {
+    srsran_timestamp_init(t, 0, 0);
+  }
+  return (int)nsamples;
+}
+
+static int cs_wb_lane_init(cs_wb_lane_t* lane, const srsran_ue_cellsearch_wb_args_t* args, uint32_t max_frames)
+{
+  if (srsran_ue_cellsearch_init_multi(&lane->cs, max_frames, cs_wb_recv, 1, lane) < SRSRAN_SUCCESS) {
+    ERROR("Error initialising cell search");
+    return SRSRAN_ERROR;
+  }
+  lane->max_frames = max_frames;
+  if (srsran_ue_cellsearch_set_nof_valid_frames(&lane->cs, SRSRAN_MIN(args->nof_valid_frames, max_frames)) <
+      SRSRAN_SUCCESS) {
+    return SRSRAN_ERROR;
+  }
+  return SRSRAN_SUCCESS;
+}
+
+static void cs_wb_search_carrier(srsran_ue_cellsearch_wb_t* q, cs_wb_lane_t* lane, uint32_t carrier_idx)
+{
+  lane->samples     = q->carrier_samples[carrier_idx];
+  lane->nof_samples = q->nof_carrier_samples;
+
+  // Do not scan more frames than the capture has
+  lane->cs.max_frames = SRSRAN_MAX(1, SRSRAN_MIN(q->nof_carrier_samples / CS_WB_FRAME_LEN, lane->max_frames));
+
+  for (uint32_t N_id_2 = 0; N_id_2 < 3; N_id_2++) {
+    uint32_t                       idx   = carrier_idx * 3 + N_id_2;
+    srsran_ue_cellsearch_result_t* found = &q->found[idx];
+
+    // Every N_id_2 is searched from the start of the capture
+    lane->pos           = 0;
+    q->found_valid[idx] =
+        srsran_ue_cellsearch_scan_N_id_2(&lane->cs, N_id_2, found) == 1 && found->psr >= q->args.min_psr;
+  }
+}
+
+static int cs_wb_search_carrier_job(void* ctx, void* lane, uint32_t carrier_idx)
+{
+  cs_wb_search_carrier((srsran_ue_cellsearch_wb_t*)ctx, (cs_wb_lane_t*)lane, carrier_idx);
+  return SRSRAN_SUCCESS;
+}
+
+void srsran_ue_cellsearch_wb_args_default(srsran_ue_cellsearch_wb_args_t* args)
+{
+  if (args == NULL) {
+    return;
+  }
+  args->srate_hz         = 19.2e6;
+  args->span_hz          = 0;
+  args->max_samples      = (uint32_t)(args->srate_hz / 25); // 40 ms
+  args->nof_valid_frames = SRSRAN_DEFAULT_NOF_VALID_PSS_FRAMES;
+  args->min_psr          = SRSRAN_CS_WB_DEFAULT_MIN_PSR;
+  args->nof_workers      = 0;
+}
+
+int srsran_ue_cellsearch_wb_init(srsran_ue_cellsearch_wb_t* q, const srsran_ue_cellsearch_wb_args_t* args)
+{
+  if (q == NULL || args == NULL) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  SRSRAN_MEM_ZERO(q, srsran_ue_cellsearch_wb_t, 1);
+
+  // The channels of the channelizer are the raster and its outputs are at the cell search rate
+  double   nof_channels = args->srate_hz / SRSRAN_CS_WB_RASTER_HZ;
+  double   decimation   = args->srate_hz / SRSRAN_CS_SAMP_FREQ;
+  uint32_t M            = (uint32_t)round(nof_channels);
+  uint32_t D            = (uint32_t)round(decimation);
+  if (fabs(nof_channels - M) > 1e-6 || fabs(decimation - D) > 1e-6 || D == 0 || args->max_samples == 0 ||
+      args->nof_workers > SRSRAN_CS_WB_MAX_WORKERS) {
+    ERROR("Invalid wideband cell search arguments, the rate %.2f MHz must be a multiple of %.2f MHz",
+          args->srate_hz / 1e6,
+          SRSRAN_CS_SAMP_FREQ / 1e6);
+    return SRSRAN_ERROR;
+  }
+  q->args = *args;
+
+  if (srsran_channelizer_init(&q->channelizer, M, D) < SRSRAN_SUCCESS) {
+    ERROR("Error initialising channelizer");
+    return SRSRAN_ERROR;
+  }
+
+  // Carriers whose 1.92 MHz channel fits within the capture and the requested span
+  double max_offset = args->srate_hz / 2 - SRSRAN_CS_SAMP_FREQ / 2;
+  if (args->span_hz > 0) {
+    max_offset = SRSRAN_MIN(max_offset, args->span_hz / 2);
+  }
+  q->carrier_channel = SRSRAN_MEM_ALLOC(uint32_t, M);
+  q->channel_output  = SRSRAN_MEM_ALLOC(cf_t*, M);
+  if (q->carrier_channel == NULL || q->channel_output == NULL) {
+    srsran_ue_cellsearch_wb_free(q);
+    return SRSRAN_ERROR;
+  }
+  SRSRAN_MEM_ZERO(q->channel_output, cf_t*, M);
+  int32_t max_k = (int32_t)floor(max_offset / SRSRAN_CS_WB_RASTER_HZ + 1e-6);
+  for (int32_t k = -max_k; k <= max_k && q->nof_carriers < M; k++) {
+    q->carrier_channel[q->nof_carriers++] = (uint32_t)((k + (int32_t)M) % (int32_t)M);
+  }
+
+  uint32_t max_carrier_samples = args->max_samples / D + 1;
+  q->carrier_samples           = SRSRAN_MEM_ALLOC(cf_t*, q->nof_carriers);
+  q->found                     = SRSRAN_MEM_ALLOC(srsran_ue_cellsearch_result_t, q->nof_carriers * 3);
+  q->found_valid               = SRSRAN_MEM_ALLOC(bool, q->nof_carriers * 3);
+  if (q->carrier_samples == NULL || q->found == NULL || q->found_valid == NULL) {
+    srsran_ue_cellsearch_wb_free(q);
+    return SRSRAN_ERROR;
+  }
+  SRSRAN_MEM_ZERO(q->carrier_samples, cf_t*, q->nof_carriers);
+  for (uint32_t i = 0; i < q->nof_carriers; i++) {
+    q->carrier_samples[i] = srsran_vec_cf_malloc(max_carrier_samples);
+    if (q->carrier_samples[i] == NULL) {
+      srsran_ue_cellsearch_wb_free(q);
+      return SRSRAN_ERROR;
+    }
+    q->channel_output[q->carrier_channel[i]] = q->carrier_samples[i];
+  }
+
+  // One lane for the caller and one for each worker
+  uint32_t      max_frames = SRSRAN_MAX(1, max_carrier_samples / CS_WB_FRAME_LEN);
+  uint32_t      nof_lanes  = args->nof_workers + 1;
+  cs_wb_lane_t* lanes      = SRSRAN_MEM_ALLOC(cs_wb_lane_t, nof_lanes);
+  if (lanes == NULL) {
+    srsran_ue_cellsearch_wb_free(q);
+    return SRSRAN_ERROR;
+  }
+  SRSRAN_MEM_ZERO(lanes, cs_wb_lane_t, nof_lanes);
+  q->lanes = lanes;
+  for (uint32_t i = 0; i < nof_lanes; i++) {
+    if (cs_wb_lane_init(&lanes[i], args, max_frames) < SRSRAN_SUCCESS) {
+      srsran_ue_cellsearch_wb_free(q);
+      return SRSRAN_ERROR;
+    }
+  }
+
+  if (srsran_coworker_group_init(&q->group, args->nof_workers, &lanes[1], sizeof(cs_wb_lane_t)) < SRSRAN_SUCCESS) {
+    ERROR("Error: initialising %d wideband cell search workers", args->nof_workers);
+    srsran_ue_cellsearch_wb_free(q);
+    return SRSRAN_ERROR;
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+static int cs_wb_result_cmp(const void* a, const void* b)
+{
+  double fa = ((const srsran_ue_cellsearch_wb_result_t*)a)->freq_offset_hz;
+  double fb = ((const srsran_ue_cellsearch_wb_result_t*)b)->freq_offset_hz;
+  return (fa > fb) - (fa < fb);
+}
+
+int srsran_ue_cellsearch_wb_scan(srsran_ue_cellsearch_wb_t*        q,
+                                 const cf_t*                       samples,
+                                 uint32_t                          nof_samples,
+                                 srsran_ue_cellsearch_wb_result_t* results,
+                                 uint32_t                          max_results)
+{
+  if (q == NULL || samples == NULL || results == NULL || q->lanes == NULL || nof_samples > q->args.max_samples) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  cs_wb_lane_t* lanes = (cs_wb_lane_t*)q->lanes;
+
+  // Split the capture in carriers
+  srsran_channelizer_reset(&q->channelizer);
+  q->nof_carrier_samples = srsran_channelizer_run(&q->channelizer, samples, nof_samples, q->channel_output);
+
+  SRSRAN_MEM_ZERO(q->found, srsran_ue_cellsearch_result_t, q->nof_carriers * 3);
+  SRSRAN_MEM_ZERO(q->found_valid, bool, q->nof_carriers * 3);
+
+  // Share the carriers out between the caller and the workers
+  srsran_coworker_group_run(&q->group, q->nof_carriers, cs_wb_search_carrier_job, q, &lanes[0]);
+
+  // Report each cell once, on the carrier where its PSS is strongest
+  uint32_t nof_results = 0;
+  for (uint32_t i = 0; i < q->nof_carriers * 3; i++) {
+    if (!q->found_valid[i]) {
+      continue;
+    }
+    bool strongest = true;
+    for (uint32_t j = 0; j < q->nof_carriers * 3 && strongest; j++) {
+      if (j == i || !q->found_valid[j] || j % 3 != i % 3) {
+        continue;
+      }
+      double dist = SRSRAN_CS_WB_RASTER_HZ * fabs((double)(j / 3) - (double)(i / 3));
+      if (dist < CS_WB_MERGE_DISTANCE_HZ &&
+          (q->found[j].peak > q->found[i].peak || (q->found[j].peak == q->found[i].peak && j < i))) {
+        strongest = false;
+      }
+    }
+    if (strongest && nof_results < max_results) {
+      results[nof_results].freq_offset_hz =
+          q->args.srate_hz * srsran_channelizer_get_freq(&q->channelizer, q->carrier_channel[i / 3]);
+      results[nof_results].cell           = q->found[i];
+      nof_results++;
+    }
+  }
+  qsort(results, nof_results, sizeof(srsran_ue_cellsearch_wb_result_t), cs_wb_result_cmp);
+
+  return (int)nof_results;
+}
+
+void srsran_ue_cellsearch_wb_free(srsran_ue_cellsearch_wb_t* q)
+{
+  if (q == NULL) {
+    return;
+  }
+
+  // Stop the workers before releasing their lanes
+  srsran_coworker_group_free(&q->group);
+
+  cs_wb_lane_t* lanes = (cs_wb_lane_t*)q->lanes;
+  if (lanes) {
+    for (uint32_t i = 0; i < q->args.nof_workers + 1; i++) {
+      srsran_ue_cellsearch_free(&lanes[i].cs);
+    }
+    free(lanes);
+  }
+
+  if (q->carrier_samples) {
+    for (uint32_t i = 0; i < q->nof_carriers; i++) {
+      if (q->carrier_samples[i]) {
+        free(q->carrier_samples[i]);
+      }
+    }
+    free(q->carrier_samples);
+  }
+  if (q->carrier_channel) {
+    free(q->carrier_channel);
+  }
+  if (q->channel_output) {
+    free(q->channel_output);
+  }
+  if (q->found) {
+    free(q->found);
+  }
+  if (q->found_valid) {
+    free(q->found_valid);
+  }
+  srsran_channelizer_free(&q->channelizer);
+
+  SRSRAN_MEM_ZERO(q, srsran_ue_cellsearch_wb_t, 1);
+}
@@ -0,0 +1,459 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/phy/ue/ue_sl_rx.h"
+#include "srsran/phy/ch_estimation/chest_sl.h"
+#include "srsran/phy/dft/dft_precoding.h"
+#include "srsran/phy/mimo/precoding.h"
+#include "srsran/phy/phch/pscch.h"
+#include "srsran/phy/phch/pssch.h"
+#include "srsran/phy/phch/ra_sl.h"
+#include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/vector.h"
+#include <string.h>
+
+#define UE_SL_RX_MAX_PSCCH_SYMBOLS (SRSRAN_PSCCH_MAX_CODED_BITS / SRSRAN_PSCCH_QM)
+
+/**
+ * Decoding state of a thread: the PSCCH/PSSCH decoders and channel estimators are stateful, so each thread searching
+ * sub-channels has its own.
+ */
+typedef struct {
+  srsran_pscch_t    pscch;
+  srsran_pssch_t    pssch;
+  srsran_chest_sl_t pscch_chest;
+  srsran_chest_sl_t pssch_chest;
+  srsran_sci_t      sci;
+  cf_t*             equalized;
+  cf_t*             dmrs_rx[SRSRAN_SL_MAX_DMRS_SYMB];
+  cf_t*             dmrs_ls;
+  uint8_t           sci_rx[SRSRAN_SCI_MAX_LEN];
+  uint64_t          nof_decoded;
+  uint64_t          nof_skipped;
+} ue_sl_rx_lane_t;
+
+/**
+ * Subframe whose sub-channels are being searched
+ */
+typedef struct {
+  srsran_ue_sl_rx_t* q;
+  cf_t*              sf_symbols;
+  uint32_t           sf_idx;
+} ue_sl_rx_job_t;
+
+static int ue_sl_rx_lane_init(ue_sl_rx_lane_t* lane, srsran_ue_sl_rx_t* q)
+{
+  uint32_t sf_n_re = SRSRAN_SF_LEN_RE(q->cell.nof_prb, q->cell.cp);
+
+  if (srsran_pscch_init(&lane->pscch, SRSRAN_MAX_PRB) != SRSRAN_SUCCESS ||
+      srsran_pscch_set_cell(&lane->pscch, q->cell) != SRSRAN_SUCCESS) {
+    ERROR("Error initialising PSCCH");
+    return SRSRAN_ERROR;
+  }
+  if (srsran_chest_sl_init(&lane->pscch_chest, SRSRAN_SIDELINK_PSCCH, q->cell, &q->sl_comm_resource_pool) !=
+      SRSRAN_SUCCESS) {
+    ERROR("Error initialising PSCCH channel estimator");
+    return SRSRAN_ERROR;
+  }
+  if (srsran_pssch_init(&lane->pssch, &q->cell, &q->sl_comm_resource_pool) != SRSRAN_SUCCESS) {
+    ERROR("Error initialising PSSCH");
+    return SRSRAN_ERROR;
+  }
+  if (srsran_chest_sl_init(&lane->pssch_chest, SRSRAN_SIDELINK_PSSCH, q->cell, &q->sl_comm_resource_pool) !=
+      SRSRAN_SUCCESS) {
+    ERROR("Error initialising PSSCH channel estimator");
+    return SRSRAN_ERROR;
+  }
+  if (srsran_sci_init(&lane->sci, &q->cell, &q->sl_comm_resource_pool) < SRSRAN_SUCCESS) {
+    ERROR("Error initialising SCI");
+    return SRSRAN_ERROR;
+  }
+
+  lane->equalized = srsran_vec_cf_malloc(sf_n_re);
+  lane->dmrs_ls   = srsran_vec_cf_malloc(SRSRAN_PSCCH_TM34_NOF_PRB * SRSRAN_NRE);
+  if (lane->equalized == NULL || lane->dmrs_ls == NULL) {
+    return SRSRAN_ERROR;
+  }
+  srsran_vec_cf_zero(lane->equalized, sf_n_re);
+  for (uint32_t i = 0; i < SRSRAN_SL_MAX_DMRS_SYMB; i++) {
+    lane->dmrs_rx[i] = srsran_vec_cf_malloc(SRSRAN_PSCCH_TM34_NOF_PRB * SRSRAN_NRE);
+    if (lane->dmrs_rx[i] == NULL) {
+      return SRSRAN_ERROR;
+    }
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+static void ue_sl_rx_lane_free(ue_sl_rx_lane_t* lane)
+{
+  srsran_pscch_free(&lane->pscch);
+  srsran_pssch_free(&lane->pssch);
+  srsran_chest_sl_free(&lane->pscch_chest);
+  srsran_chest_sl_free(&lane->pssch_chest);
+  srsran_sci_free(&lane->sci);
+  if (lane->equalized) {
+    free(lane->equalized);
+  }
+  if (lane->dmrs_ls) {
+    free(lane->dmrs_ls);
+  }
+  for (uint32_t i = 0; i < SRSRAN_SL_MAX_DMRS_SYMB; i++) {
+    if (lane->dmrs_rx[i]) {
+      free(lane->dmrs_rx[i]);
+    }
+  }
+}
+
+/**
+ * Equalizes the PRB of a channel estimate only, in every symbol of the subframe, which is all the PSCCH and PSSCH
+ * decoders read.
+ */
+static void ue_sl_rx_equalize(srsran_chest_sl_t* chest,
+                              cf_t*              sf_symbols,
+                              cf_t*              equalized,
+                              uint32_t           prb_start_idx,
+                              uint32_t           nof_prb)
+{
+  uint32_t nof_symbols = srsran_sl_get_num_symbols(chest->cell.tm, chest->cell.cp);
+  uint32_t k0          = prb_start_idx * SRSRAN_NRE;
+
+  srsran_chest_sl_estimate_noise(chest);
+  for (uint32_t l = 0; l < nof_symbols; l++) {
+    uint32_t idx = l * chest->cell.nof_prb * SRSRAN_NRE + k0;
+    srsran_predecoding_single(&sf_symbols[idx],
+                              &chest->ce_average[idx],
+                              &equalized[idx],
+                              NULL,
+                              nof_prb * SRSRAN_NRE,
+                              1.0f,
+                              chest->noise_estimated);
+  }
+}
+
+/**
+ * Correlates the PSCCH DMRS of a sub-channel with every cyclic shift. The LS estimate obtained with a wrong cyclic shift
+ * keeps a phase ramp of a multiple of pi/2 between adjacent subcarriers, so the hypotheses are told apart by the phase
+ * of the correlation between adjacent LS estimates, which is also insensitive to the timing offset. The result is
+ * normalised by the DMRS energy, so that it is 1 for a noiseless, flat channel.
+ */
+static void ue_sl_rx_cs_correlate(ue_sl_rx_lane_t* lane,
+                                  cf_t*            sf_symbols,
+                                  uint32_t         prb_start_idx,
+                                  float            corr[SRSRAN_UE_SL_RX_NOF_CYCLIC_SHIFTS])
+{
+  srsran_chest_sl_t*    chest = &lane->pscch_chest;
+  srsran_chest_sl_cfg_t cfg   = {};
+
+  cfg.prb_start_idx = prb_start_idx;
+  srsran_chest_sl_set_cfg(chest, cfg);
+  int nof_dmrs = srsran_chest_sl_get_dmrs(chest, sf_symbols, lane->dmrs_rx);
+
+  float energy = 0.0f;
+  for (int l = 0; l < nof_dmrs; l++) {
+    energy += srsran_vec_avg_power_cf(lane->dmrs_rx[l], chest->M_sc_rs) * chest->M_sc_rs;
+  }
+
+  for (uint32_t h = 0; h < SRSRAN_UE_SL_RX_NOF_CYCLIC_SHIFTS; h++) {
+    float sum = 0.0f;
+    for (int l = 0; l < nof_dmrs; l++) {
+      srsran_vec_prod_conj_ccc(lane->dmrs_rx[l], chest->r_sequence[l][h], lane->dmrs_ls, chest->M_sc_rs);
+      sum += __real__ srsran_vec_dot_prod_conj_ccc(&lane->dmrs_ls[1], lane->dmrs_ls, chest->M_sc_rs - 1);
+    }
+    corr[h] = (energy > 0.0f) ? sum / energy : 0.0f;
+  }
+}
+
+static void ue_sl_rx_decode_pssch(srsran_ue_sl_rx_t*        q,
+                                  ue_sl_rx_lane_t*          lane,
+                                  srsran_ue_sl_rx_result_t* res,
+                                  cf_t*                     sf_symbols,
+                                  uint32_t                  sf_idx)
+{
+  srsran_sl_comm_resource_pool_t* pool = &q->sl_comm_resource_pool;
+
+  uint32_t sub_channel_start_idx = 0;
+  uint32_t L_subCH               = 0;
+  srsran_ra_sl_type0_from_riv(res->sci.riv, pool->num_sub_channel, &L_subCH, &sub_channel_start_idx);
+
+  // 3GPP TS 36.213 Section 14.1.1.4C
+  uint32_t pssch_prb_start_idx =
+      (res->sub_channel_idx * pool->size_sub_channel) + lane->pscch.pscch_nof_prb + pool->start_prb_sub_channel;
+  uint32_t nof_prb_pssch =
+      ((L_subCH + res->sub_channel_idx) * pool->size_sub_channel) - pssch_prb_start_idx + pool->start_prb_sub_channel;
+
+  // make sure PRBs are valid for DFT precoding
+  nof_prb_pssch = srsran_dft_precoding_get_valid_prb(nof_prb_pssch);
+
+  res->pssch_prb_start_idx = pssch_prb_start_idx;
+  res->pssch_nof_prb       = nof_prb_pssch;
+
+  srsran_chest_sl_cfg_t chest_cfg = {};
+  chest_cfg.N_x_id                = res->N_x_id;
+  chest_cfg.sf_idx                = sf_idx;
+  chest_cfg.prb_start_idx         = pssch_prb_start_idx;
+  chest_cfg.nof_prb               = nof_prb_pssch;
+  if (srsran_chest_sl_set_cfg(&lane->pssch_chest, chest_cfg) != SRSRAN_SUCCESS) {
+    return;
+  }
+  srsran_chest_sl_ls_estimate(&lane->pssch_chest, sf_symbols);
+  ue_sl_rx_equalize(&lane->pssch_chest, sf_symbols, lane->equalized, pssch_prb_start_idx, nof_prb_pssch);
+
+  uint32_t           rv_idx    = res->sci.retransmission ? 1 : 0;
+  srsran_pssch_cfg_t pssch_cfg = {pssch_prb_start_idx, nof_prb_pssch, res->N_x_id, res->sci.mcs_idx, rv_idx, sf_idx};
+  if (srsran_pssch_set_cfg(&lane->pssch, pssch_cfg) != SRSRAN_SUCCESS) {
+    return;
+  }
+  if (srsran_pssch_decode(&lane->pssch, lane->equalized, res->tb, SRSRAN_SL_SCH_MAX_TB_LEN) == SRSRAN_SUCCESS) {
+    res->tb_decoded = true;
+    res->tb_len     = lane->pssch.sl_sch_tb_len;
+  }
+
+  if (q->args.keep_symbols && lane->pssch.Qm > 0) {
+    res->nof_pssch_symbols = lane->pssch.G / lane->pssch.Qm;
+    srsran_vec_cf_copy(res->pssch_symbols, lane->pssch.symbols, res->nof_pssch_symbols);
+  }
+}
+
+static void ue_sl_rx_search_sub_channel(srsran_ue_sl_rx_t* q,
+                                        ue_sl_rx_lane_t*   lane,
+                                        uint32_t           sub_channel_idx,
+                                        cf_t*              sf_symbols,
+                                        uint32_t           sf_idx)
+{
+  srsran_ue_sl_rx_result_t* res           = &q->results[sub_channel_idx];
+  uint32_t                  prb_start_idx = sub_channel_idx * q->sl_comm_resource_pool.size_sub_channel;
+
+  res->sci_decoded       = false;
+  res->tb_decoded        = false;
+  res->tb_len            = 0;
+  res->nof_pscch_symbols = 0;
+  res->nof_pssch_symbols = 0;
+
+  // Rank the cyclic shift hypotheses
+  float    corr[SRSRAN_UE_SL_RX_NOF_CYCLIC_SHIFTS]  = {};
+  uint32_t order[SRSRAN_UE_SL_RX_NOF_CYCLIC_SHIFTS] = {0, 1, 2, 3};
+  ue_sl_rx_cs_correlate(lane, sf_symbols, prb_start_idx, corr);
+  for (uint32_t i = 1; i < SRSRAN_UE_SL_RX_NOF_CYCLIC_SHIFTS; i++) {
+    for (uint32_t j = i; j > 0 && corr[order[j]] > corr[order[j - 1]]; j--) {
+      uint32_t t   = order[j];
+      order[j]     = order[j - 1];
+      order[j - 1] = t;
+    }
+  }
+
+  for (uint32_t i = 0; i < SRSRAN_UE_SL_RX_NOF_CYCLIC_SHIFTS; i++) {
+    uint32_t h = order[i];
+    if (corr[h] < q->args.cs_threshold) {
+      lane->nof_skipped += SRSRAN_UE_SL_RX_NOF_CYCLIC_SHIFTS - i;
+      return;
+    }
+    lane->nof_decoded++;
+
+    // PSCCH channel estimation and equalization, only in the PSCCH PRB
+    srsran_chest_sl_cfg_t chest_cfg = {};
+    chest_cfg.cyclic_shift          = h * 3;
+    chest_cfg.prb_start_idx         = prb_start_idx;
+    srsran_chest_sl_set_cfg(&lane->pscch_chest, chest_cfg);
+    srsran_chest_sl_ls_estimate(&lane->pscch_chest, sf_symbols);
+    ue_sl_rx_equalize(&lane->pscch_chest, sf_symbols, lane->equalized, prb_start_idx, lane->pscch.pscch_nof_prb);
+
+    if (srsran_pscch_decode(&lane->pscch, lane->equalized, lane->sci_rx, prb_start_idx) != SRSRAN_SUCCESS ||
+        srsran_sci_format1_unpack(&lane->sci, lane->sci_rx) != SRSRAN_SUCCESS) {
+      continue;
+    }
+
+    res->sci_decoded     = true;
+    res->sub_channel_idx = sub_channel_idx;
+    res->cyclic_shift    = h * 3;
+    res->corr            = corr[h];
+    res->sci             = lane->sci;
+    res->N_x_id          = 0;
+    for (uint32_t j = 0; j < SRSRAN_SCI_CRC_LEN; j++) {
+      res->N_x_id += lane->pscch.sci_crc[j] * (1U << (SRSRAN_SCI_CRC_LEN - 1 - j));
+    }
+    if (q->args.keep_symbols) {
+      res->nof_pscch_symbols = SRSRAN_MIN(lane->pscch.E / SRSRAN_PSCCH_QM, UE_SL_RX_MAX_PSCCH_SYMBOLS);
+      srsran_vec_cf_copy(res->pscch_symbols, lane->pscch.mod_symbols, res->nof_pscch_symbols);
+    }
+
+    if (q->args.decode_pssch) {
+      ue_sl_rx_decode_pssch(q, lane, res, sf_symbols, sf_idx);
+    }
+    lane->nof_skipped += SRSRAN_UE_SL_RX_NOF_CYCLIC_SHIFTS - i - 1;
+    return;
+  }
+}
+
+static int ue_sl_rx_search_sub_channel_job(void* ctx, void* lane, uint32_t sub_channel_idx)
+{
+  ue_sl_rx_job_t* job = (ue_sl_rx_job_t*)ctx;
+  ue_sl_rx_search_sub_channel(job->q, (ue_sl_rx_lane_t*)lane, sub_channel_idx, job->sf_symbols, job->sf_idx);
+  return SRSRAN_SUCCESS;
+}
+
+void srsran_ue_sl_rx_args_default(srsran_ue_sl_rx_args_t* args)
+{
+  if (args == NULL) {
+    return;
+  }
+  args->nof_workers  = 0;
+  args->cs_threshold = SRSRAN_UE_SL_RX_DEFAULT_CS_THRESHOLD;
+  args->decode_pssch = true;
+  args->keep_symbols = false;
+}
+
+int srsran_ue_sl_rx_init(srsran_ue_sl_rx_t*                    q,
+                         srsran_cell_sl_t                      cell,
+                         const srsran_sl_comm_resource_pool_t* sl_comm_resource_pool,
+                         const srsran_ue_sl_rx_args_t*         args)
+{
+  if (q == NULL || sl_comm_resource_pool == NULL || args == NULL) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  SRSRAN_MEM_ZERO(q, srsran_ue_sl_rx_t, 1);
+  if (cell.tm != SRSRAN_SIDELINK_TM3 && cell.tm != SRSRAN_SIDELINK_TM4) {
+    ERROR("The sidelink receiver only supports transmission modes 3 and 4");
+    return SRSRAN_ERROR;
+  }
+  if (args->nof_workers > SRSRAN_UE_SL_RX_MAX_WORKERS || sl_comm_resource_pool->num_sub_channel == 0) {
+    ERROR("Invalid sidelink receiver arguments");
+    return SRSRAN_ERROR;
+  }
+
+  q->cell                  = cell;
+  q->sl_comm_resource_pool = *sl_comm_resource_pool;
+  q->args                  = *args;
+
+  uint32_t nof_sub_channel = q->sl_comm_resource_pool.num_sub_channel;
+  q->results               = SRSRAN_MEM_ALLOC(srsran_ue_sl_rx_result_t, nof_sub_channel);
+  if (q->results == NULL) {
+    srsran_ue_sl_rx_free(q);
+    return SRSRAN_ERROR;
+  }
+  SRSRAN_MEM_ZERO(q->results, srsran_ue_sl_rx_result_t, nof_sub_channel);
+  for (uint32_t i = 0; i < nof_sub_channel; i++) {
+    srsran_ue_sl_rx_result_t* res = &q->results[i];
+    res->sub_channel_idx          = i;
+    res->tb                       = srsran_vec_u8_malloc(SRSRAN_SL_SCH_MAX_TB_LEN);
+    if (res->tb == NULL) {
+      srsran_ue_sl_rx_free(q);
+      return SRSRAN_ERROR;
+    }
+    if (args->keep_symbols) {
+      res->pscch_symbols = srsran_vec_cf_malloc(UE_SL_RX_MAX_PSCCH_SYMBOLS);
+      res->pssch_symbols = srsran_vec_cf_malloc(cell.nof_prb * SRSRAN_NRE * SRSRAN_PSSCH_TM34_NUM_DATA_SYMBOLS);
+      if (res->pscch_symbols == NULL || res->pssch_symbols == NULL) {
+        srsran_ue_sl_rx_free(q);
+        return SRSRAN_ERROR;
+      }
+    }
+  }
+
+  // One lane for the caller and one for each worker
+  uint32_t         nof_lanes = args->nof_workers + 1;
+  ue_sl_rx_lane_t* lanes     = SRSRAN_MEM_ALLOC(ue_sl_rx_lane_t, nof_lanes);
+  if (lanes == NULL) {
+    srsran_ue_sl_rx_free(q);
+    return SRSRAN_ERROR;
+  }
+  SRSRAN_MEM_ZERO(lanes, ue_sl_rx_lane_t, nof_lanes);
+  q->lanes = lanes;
+  for (uint32_t i = 0; i < nof_lanes; i++) {
+    if (ue_sl_rx_lane_init(&lanes[i], q) < SRSRAN_SUCCESS) {
+      srsran_ue_sl_rx_free(q);
+      return SRSRAN_ERROR;
+    }
+  }
+
+  if (srsran_coworker_group_init(&q->group, args->nof_workers, &lanes[1], sizeof(ue_sl_rx_lane_t)) <
+      SRSRAN_SUCCESS) {
+    ERROR("Error: initialising %d sidelink receiver workers", args->nof_workers);
+    srsran_ue_sl_rx_free(q);
+    return SRSRAN_ERROR;
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+int srsran_ue_sl_rx_decode_sf(srsran_ue_sl_rx_t* q, cf_t* sf_symbols, uint32_t sf_idx)
+{
+  if (q == NULL || sf_symbols == NULL || q->lanes == NULL) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  ue_sl_rx_lane_t* lanes           = (ue_sl_rx_lane_t*)q->lanes;
+  uint32_t         nof_sub_channel = q->sl_comm_resource_pool.num_sub_channel;
+
+  // Share the sub-channels out between the caller and the workers
+  ue_sl_rx_job_t job = {q, sf_symbols, sf_idx};
+  srsran_coworker_group_run(&q->group, nof_sub_channel, ue_sl_rx_search_sub_channel_job, &job, &lanes[0]);
+
+  // Collect the counters of every lane
+  q->nof_hypotheses_decoded = 0;
+  q->nof_hypotheses_skipped = 0;
+  for (uint32_t i = 0; i < q->args.nof_workers + 1; i++) {
+    q->nof_hypotheses_decoded += lanes[i].nof_decoded;
+    q->nof_hypotheses_skipped += lanes[i].nof_skipped;
+  }
+
+  int nof_sci = 0;
+  for (uint32_t i = 0; i < nof_sub_channel; i++) {
+    nof_sci += q->results[i].sci_decoded ? 1 : 0;
+  }
+  return nof_sci;
+}
+
+void srsran_ue_sl_rx_free(srsran_ue_sl_rx_t* q)
+{
+  if (q == NULL) {
+    return;
+  }
+
+  // Stop the workers before releasing their lanes
+  srsran_coworker_group_free(&q->group);
+
+  ue_sl_rx_lane_t* lanes = (ue_sl_rx_lane_t*)q->lanes;
+  if (lanes) {
+    for (uint32_t i = 0; i < q->args.nof_workers + 1; i++) {
+      ue_sl_rx_lane_free(&lanes[i]);
+    }
+    free(lanes);
+  }
+
+  if (q->results) {
+    for (uint32_t i = 0; i < q->sl_comm_resource_pool.num_sub_channel; i++) {
+      if (q->results[i].tb) {
+        free(q->results[i].tb);
+      }
+      if (q->results[i].pscch_symbols) {
+        free(q->results[i].pscch_symbols);
+      }
+      if (q->results[i].pssch_symbols) {
+        free(q->results[i].pssch_symbols);
+      }
+    }
+    free(q->results);
+  }
+
+  SRSRAN_MEM_ZERO(q, srsran_ue_sl_rx_t, 1);
+}
@@ -139,6 +139,7 @@ void srsran_ue_sync_reset(srsran_ue_sync_t* q)
   q->mean_sample_offset    = 0.0;
   q->next_rf_sample_offset = 0;
   q->frame_find_cnt        = 0;
+  srsran_cfo_nco_reset(&q->strack.cfo_corr_frame);
 }
 
 int srsran_ue_sync_start_agc(srsran_ue_sync_t* q,
@@ -775,14 +776,14 @@ int srsran_ue_sync_zerocopy(srsran_ue_sync_t* q,
 
       switch (q->state) {
         case SF_FIND:
-          // Correct CFO before PSS/SSS find using the sync object corrector (initialized for 1 ms)
+          // Correct CFO before PSS/SSS find using the sync object corrector, keeping the phase across subframes
           if (q->cfo_correct_enable_find) {
-            for (int i = 0; i < q->nof_rx_antennas; i++) {
-              if (input_buffer[i]) {
-                srsran_cfo_correct(
-                    &q->strack.cfo_corr_frame, input_buffer[i], input_buffer[i], -q->cfo_current_value / q->fft_size);
-              }
-            }
+            srsran_cfo_nco_correct(&q->strack.cfo_corr_frame,
+                                   input_buffer,
+                                   input_buffer,
+                                   q->nof_rx_antennas,
+                                   -q->cfo_current_value / q->fft_size,
+                                   q->frame_len);
           }
 
           // Run mode-specific find operation
@@ -807,14 +808,14 @@ int srsran_ue_sync_zerocopy(srsran_ue_sync_t* q,
             q->frame_number = (q->frame_number + 1) % 1024;
           }
 
-          // Correct CFO before PSS/SSS tracking using the sync object corrector (initialized for 1 ms)
+          // Correct CFO before PSS/SSS tracking using the sync object corrector, keeping the phase across subframes
           if (q->cfo_correct_enable_track) {
-            for (int i = 0; i < q->nof_rx_antennas; i++) {
-              if (input_buffer[i]) {
-                srsran_cfo_correct(
-                    &q->strack.cfo_corr_frame, input_buffer[i], input_buffer[i], -q->cfo_current_value / q->fft_size);
-              }
-            }
+            srsran_cfo_nco_correct(&q->strack.cfo_corr_frame,
+                                   input_buffer,
+                                   input_buffer,
+                                   q->nof_rx_antennas,
+                                   -q->cfo_current_value / q->fft_size,
+                                   q->frame_len);
           }
 
           if (q->mode == SYNC_MODE_PSS) {
@@ -375,8 +375,9 @@ static int find_peak_ok(srsran_nbiot_ue_sync_t* q, cf_t* input_buffer[SRSRAN_MAX
     q->nof_recv_sf = 1;
     q->frame_len   = q->nof_recv_sf * q->sf_len;
 
-    ///< go to tracking state
+    ///< go to tracking state, the NPSS stream starts over when coming back to find
     q->state = SF_TRACK;
+    srsran_sync_nbiot_reset(&q->sfind);
 
     ///< Initialize track state CFO
     q->strack.mean_cfo = q->sfind.mean_cfo;
@@ -537,7 +538,7 @@ int srsran_ue_sync_nbiot_zerocopy_multi(srsran_nbiot_ue_sync_t* q, cf_t** input_
 
       switch (q->state) {
         case SF_FIND:
-          switch (srsran_sync_nbiot_find(&q->sfind, input_buffer[0], 0, &q->peak_idx)) {
+          switch (srsran_sync_nbiot_find_stream(&q->sfind, input_buffer[0], &q->peak_idx)) {
             case SRSRAN_SYNC_ERROR:
               ret = SRSRAN_ERROR;
               fprintf(stderr, "Error finding correlation peak (%d)\n", ret);
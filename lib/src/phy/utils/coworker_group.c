@@ -0,0 +1,187 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+
+#include "srsran/phy/utils/coworker_group.h"
+#include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/vector.h"
+#include <semaphore.h>
+#include <stdlib.h>
+
+struct srsran_coworker_s {
+  pthread_t                pthread;
+  srsran_coworker_group_t* group;
+  void*                    lane;
+
+  /* Semaphores */
+  sem_t start;
+  sem_t finish;
+};
+
+static void coworker_group_work(srsran_coworker_group_t* q, void* lane)
+{
+  while (true) {
+    pthread_mutex_lock(&q->mutex);
+    uint32_t idx = q->next_item++;
+    pthread_mutex_unlock(&q->mutex);
+
+    if (idx >= q->nof_items) {
+      return;
+    }
+
+    if (q->fn(q->ctx, lane, idx) < SRSRAN_SUCCESS) {
+      pthread_mutex_lock(&q->mutex);
+      q->ret = SRSRAN_ERROR;
+      pthread_mutex_unlock(&q->mutex);
+    }
+  }
+}
+
+static void* coworker_thread(void* arg)
+{
+  struct srsran_coworker_s* w = (struct srsran_coworker_s*)arg;
+  srsran_coworker_group_t*  q = w->group;
+
+  sem_wait(&w->start);
+  while (!q->quit) {
+    coworker_group_work(q, w->lane);
+
+    /* Post finish semaphore */
+    sem_post(&w->finish);
+
+    /* Wait for next job */
+    sem_wait(&w->start);
+  }
+
+  return NULL;
+}
+
+int srsran_coworker_group_init(srsran_coworker_group_t* q, uint32_t nof_coworkers, void* lanes, size_t lane_sz)
+{
+  if (q == NULL || (nof_coworkers > 0 && lanes == NULL)) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+  SRSRAN_MEM_ZERO(q, srsran_coworker_group_t, 1);
+
+  if (nof_coworkers == 0) {
+    return SRSRAN_SUCCESS;
+  }
+
+  q->coworkers = SRSRAN_MEM_ALLOC(struct srsran_coworker_s, nof_coworkers);
+  if (q->coworkers == NULL) {
+    return SRSRAN_ERROR;
+  }
+  SRSRAN_MEM_ZERO(q->coworkers, struct srsran_coworker_s, nof_coworkers);
+  pthread_mutex_init(&q->mutex, NULL);
+
+  for (uint32_t i = 0; i < nof_coworkers; i++) {
+    struct srsran_coworker_s* w = &q->coworkers[i];
+    w->group                    = q;
+    w->lane                     = (uint8_t*)lanes + i * lane_sz;
+
+    if (sem_init(&w->start, 0, 0)) {
+      ERROR("Error: initialising coworker semaphores");
+      srsran_coworker_group_free(q);
+      return SRSRAN_ERROR;
+    }
+    if (sem_init(&w->finish, 0, 0)) {
+      ERROR("Error: initialising coworker semaphores");
+      sem_destroy(&w->start);
+      srsran_coworker_group_free(q);
+      return SRSRAN_ERROR;
+    }
+
+    if (pthread_create(&w->pthread, NULL, coworker_thread, (void*)w)) {
+      ERROR("Error: creating coworker thread");
+      sem_destroy(&w->start);
+      sem_destroy(&w->finish);
+      srsran_coworker_group_free(q);
+      return SRSRAN_ERROR;
+    }
+    q->nof_coworkers++;
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+int srsran_coworker_group_run(srsran_coworker_group_t* q,
+                              uint32_t                 nof_items,
+                              srsran_coworker_fn_t     fn,
+                              void*                    ctx,
+                              void*                    caller_lane)
+{
+  if (q == NULL || fn == NULL) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  // Serial processing
+  if (q->nof_coworkers == 0 || nof_items < 2) {
+    int ret = SRSRAN_SUCCESS;
+    for (uint32_t i = 0; i < nof_items; i++) {
+      if (fn(ctx, caller_lane, i) < SRSRAN_SUCCESS) {
+        ret = SRSRAN_ERROR;
+      }
+    }
+    return ret;
+  }
+
+  // Share the items out between the caller and the coworkers
+  q->fn        = fn;
+  q->ctx       = ctx;
+  q->nof_items = nof_items;
+  q->next_item = 0;
+  q->ret       = SRSRAN_SUCCESS;
+
+  uint32_t nof_helpers = SRSRAN_MIN(q->nof_coworkers, nof_items - 1);
+  for (uint32_t i = 0; i < nof_helpers; i++) {
+    sem_post(&q->coworkers[i].start);
+  }
+
+  coworker_group_work(q, caller_lane);
+
+  for (uint32_t i = 0; i < nof_helpers; i++) {
+    sem_wait(&q->coworkers[i].finish);
+  }
+
+  return q->ret;
+}
+
+void srsran_coworker_group_free(srsran_coworker_group_t* q)
+{
+  if (q == NULL || q->coworkers == NULL) {
+    return;
+  }
+
+  // Stop the threads
+  q->quit = true;
+  for (uint32_t i = 0; i < q->nof_coworkers; i++) {
+    sem_post(&q->coworkers[i].start);
+  }
+  for (uint32_t i = 0; i < q->nof_coworkers; i++) {
+    pthread_join(q->coworkers[i].pthread, NULL);
+    sem_destroy(&q->coworkers[i].start);
+    sem_destroy(&q->coworkers[i].finish);
+  }
+
+  free(q->coworkers);
+  pthread_mutex_destroy(&q->mutex);
+  SRSRAN_MEM_ZERO(q, srsran_coworker_group_t, 1);
+}
@@ -151,8 +151,24 @@ void srsran_vec_lut_sis(const short* x, const unsigned int* lut, short* y, const
   }
 }
 
+#ifdef ENABLE_RT_ALLOC_CHECK
+static __thread uint64_t nof_thread_allocs = 0;
+#endif
+
+uint64_t srsran_vec_get_nof_thread_allocs()
+{
+#ifdef ENABLE_RT_ALLOC_CHECK
+  return nof_thread_allocs;
+#else
+  return 0;
+#endif
+}
+
 void* srsran_vec_malloc(uint32_t size)
 {
+#ifdef ENABLE_RT_ALLOC_CHECK
+  nof_thread_allocs++;
+#endif
   void* ptr;
   if (posix_memalign(&ptr, SRSRAN_SIMD_BIT_ALIGN, size)) {
     return NULL;
@@ -271,6 +287,9 @@ void* srsran_vec_realloc(void* ptr, uint32_t old_size, uint32_t new_size)
 #ifndef LV_HAVE_SSE
   return realloc(ptr, new_size);
 #else
+#ifdef ENABLE_RT_ALLOC_CHECK
+  nof_thread_allocs++;
+#endif
   void* new_ptr;
   if (posix_memalign(&new_ptr, SRSRAN_SIMD_BIT_ALIGN, new_size)) {
     return NULL;
@@ -857,6 +876,11 @@ void srsran_vec_apply_cfo(const cf_t* x, float cfo, cf_t* z, int len)
   srsran_vec_apply_cfo_simd(x, cfo, z, len);
 }
 
+cf_t srsran_vec_apply_cfo_phase(const cf_t* x, float cfo, cf_t phase, cf_t* z, int len)
+{
+  return srsran_vec_apply_cfo_phase_simd(x, cfo, phase, z, len);
+}
+
 float srsran_vec_estimate_frequency(const cf_t* x, int len)
 {
   return srsran_vec_estimate_frequency_simd(x, len);
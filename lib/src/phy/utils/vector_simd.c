@@ -1721,20 +1721,27 @@ cf_t srsran_vec_gen_sine_simd(cf_t amplitude, float freq, cf_t* z, int len)
 }
 
 void srsran_vec_apply_cfo_simd(const cf_t* x, float cfo, cf_t* z, int len)
+{
+  srsran_vec_apply_cfo_phase_simd(x, cfo, 1.0f, z, len);
+}
+
+cf_t srsran_vec_apply_cfo_phase_simd(const cf_t* x, float cfo, cf_t phase, cf_t* z, int len)
 {
   const float TWOPI = 2.0f * (float)M_PI;
   int         i     = 0;
   cf_t        osc   = cexpf(_Complex_I * TWOPI * cfo);
-  cf_t        phase = 1.0f;
 
 #if SRSRAN_SIMD_CF_SIZE
   // Load initial phases and oscillator
   srsran_simd_aligned cf_t _phase[SRSRAN_SIMD_CF_SIZE];
-  _phase[0] = phase;
+  _phase[0] = 1.0f;
   for (int k = 1; k < SRSRAN_SIMD_CF_SIZE; k++) {
     _phase[k] = _phase[k - 1] * osc;
   }
-  simd_cf_t _simd_osc   = srsran_simd_cf_set1(_phase[SRSRAN_SIMD_CF_SIZE - 1] * osc);
+  simd_cf_t _simd_osc = srsran_simd_cf_set1(_phase[SRSRAN_SIMD_CF_SIZE - 1] * osc);
+  for (int k = 0; k < SRSRAN_SIMD_CF_SIZE; k++) {
+    _phase[k] *= phase;
+  }
   simd_cf_t _simd_phase = srsran_simd_cfi_load(_phase);
 
   if (SRSRAN_IS_ALIGNED(x) && SRSRAN_IS_ALIGNED(z)) {
@@ -1771,6 +1778,8 @@ void srsran_vec_apply_cfo_simd(const cf_t* x, float cfo, cf_t* z, int len)
 
     phase *= osc;
   }
+
+  return phase;
 }
 
 float srsran_vec_estimate_frequency_simd(const cf_t* x, int len)
@@ -0,0 +1,104 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/adt/snapshot_buffer.h"
+#include "srsran/common/test_common.h"
+#include <thread>
+#include <vector>
+
+int test_single_thread()
+{
+  srsran::snapshot_buffer<std::vector<int> > buf;
+
+  // Nothing to read before the first publication
+  TESTASSERT(not buf.update());
+  TESTASSERT(not buf.has_snapshot());
+
+  buf.write_buffer() = {1, 2, 3};
+  buf.publish();
+  TESTASSERT(buf.update());
+  TESTASSERT(buf.has_snapshot());
+  TESTASSERT(buf.read_buffer() == std::vector<int>({1, 2, 3}));
+
+  // The snapshot stays until a new one is published
+  TESTASSERT(not buf.update());
+  TESTASSERT(buf.read_buffer() == std::vector<int>({1, 2, 3}));
+
+  // Only the latest of several publications is read
+  buf.write_buffer() = {4};
+  buf.publish();
+  buf.write_buffer() = {5, 6};
+  buf.publish();
+  TESTASSERT(buf.update());
+  TESTASSERT(buf.read_buffer() == std::vector<int>({5, 6}));
+
+  // The writer never gets the copy held by the reader
+  for (int i = 0; i < 10; i++) {
+    buf.write_buffer().assign(4, i);
+    TESTASSERT(&buf.write_buffer() != &buf.read_buffer());
+    buf.publish();
+  }
+  TESTASSERT(buf.update());
+  TESTASSERT(buf.read_buffer() == std::vector<int>(4, 9));
+
+  return SRSRAN_SUCCESS;
+}
+
+int test_concurrent()
+{
+  const uint32_t                                  nof_snapshots = 200000;
+  srsran::snapshot_buffer<std::vector<uint32_t> > buf;
+
+  // Every snapshot has all its elements equal to its sequence number, a torn read would mix them
+  std::thread writer([&buf, nof_snapshots]() {
+    for (uint32_t i = 1; i <= nof_snapshots; i++) {
+      buf.write_buffer().assign(64 + i % 64, i);
+      buf.publish();
+    }
+  });
+
+  uint32_t last = 0, nof_reads = 0;
+  while (last < nof_snapshots) {
+    if (not buf.update()) {
+      continue;
+    }
+    const std::vector<uint32_t>& v = buf.read_buffer();
+    TESTASSERT(v.size() == 64 + v[0] % 64);
+    for (uint32_t x : v) {
+      TESTASSERT(x == v[0]);
+    }
+    TESTASSERT(v[0] > last);
+    last = v[0];
+    nof_reads++;
+  }
+  writer.join();
+
+  printf("Read %d of %d snapshots\n", nof_reads, nof_snapshots);
+  return SRSRAN_SUCCESS;
+}
+
+int main()
+{
+  TESTASSERT(test_single_thread() == SRSRAN_SUCCESS);
+  TESTASSERT(test_concurrent() == SRSRAN_SUCCESS);
+  printf("Success\n");
+  return SRSRAN_SUCCESS;
+}
@@ -0,0 +1,87 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/adt/pool/tti_arena.h"
+#include "srsran/common/test_common.h"
+#include <vector>
+
+void test_tti_arena_alloc_and_reset()
+{
+  srsran::tti_arena arena(256);
+  TESTASSERT(arena.size() == 256 and arena.nof_bytes_allocated() == 0);
+
+  void* p1 = arena.allocate(100, 8);
+  void* p2 = arena.allocate(100, 64);
+  TESTASSERT(p1 != nullptr and p2 != nullptr);
+  TESTASSERT(arena.contains(p1) and arena.contains(p2));
+  TESTASSERT(reinterpret_cast<std::uintptr_t>(p2) % 64 == 0);
+
+  // Arena exhausted
+  TESTASSERT(arena.allocate(200, 8) == nullptr);
+  TESTASSERT(arena.get_nof_overflows() == 1);
+
+  size_t nof_bytes = arena.nof_bytes_allocated();
+  arena.reset();
+  TESTASSERT(arena.nof_bytes_allocated() == 0);
+  TESTASSERT(arena.max_bytes_allocated() == nof_bytes);
+  TESTASSERT(arena.allocate(100, 8) == p1);
+}
+
+void test_tti_arena_scope()
+{
+  srsran::tti_arena arena(1024);
+  TESTASSERT(srsran::tti_arena::current() == nullptr);
+  {
+    srsran::tti_arena_scope scope(arena);
+    TESTASSERT(srsran::tti_arena::current() == &arena);
+
+    std::vector<int, srsran::tti_arena_allocator<int> > vec;
+    vec.reserve(10);
+    TESTASSERT(arena.contains(vec.data()));
+    TESTASSERT(arena.nof_bytes_allocated() >= 10 * sizeof(int));
+
+    // Containers fall back to the heap when the arena is exhausted
+    std::vector<uint8_t, srsran::tti_arena_allocator<uint8_t> > big_vec(2048);
+    TESTASSERT(not arena.contains(big_vec.data()));
+    TESTASSERT(arena.get_nof_overflows() == 1);
+
+    srsran::tti_arena_string str(64, 'x');
+    TESTASSERT(arena.contains(str.data()));
+  }
+  // Arena is reset when leaving the scope
+  TESTASSERT(srsran::tti_arena::current() == nullptr);
+  TESTASSERT(arena.nof_bytes_allocated() == 0);
+
+  // Without a current arena, the allocator uses the heap
+  std::vector<int, srsran::tti_arena_allocator<int> > vec(4);
+  TESTASSERT(vec.get_allocator().get_arena() == nullptr);
+}
+
+int main(int argc, char** argv)
+{
+  srsran::test_init(argc, argv);
+
+  test_tti_arena_alloc_and_reset();
+  test_tti_arena_scope();
+
+  printf("Success\n");
+  return 0;
+}
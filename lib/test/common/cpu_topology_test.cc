@@ -0,0 +1,126 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/common/cpu_topology.h"
+#include "srsran/support/srsran_test.h"
+#include <fstream>
+#include <ftw.h>
+#include <sys/stat.h>
+
+/// Creates a fake sysfs tree of a dual-socket host with 2 cores per socket and 2 hardware threads per core. The NUMA
+/// node ids are 0 and 2, as on hosts with memory-only or offline nodes
+static std::string create_sysfs_tree()
+{
+  char        tmpl[] = "/tmp/cpu_topology_testXXXXXX";
+  std::string root   = mkdtemp(tmpl);
+
+  auto write_file = [](const std::string& path, const std::string& content) {
+    std::ofstream f(path);
+    f << content << "\n";
+  };
+
+  mkdir((root + "/cpu").c_str(), 0755);
+  mkdir((root + "/node").c_str(), 0755);
+  write_file(root + "/cpu/online", "0-7");
+  write_file(root + "/cpu/isolated", "1,3,5,7");
+  for (uint32_t c = 0; c < 8; ++c) {
+    std::string cpu_dir = root + "/cpu/cpu" + std::to_string(c);
+    mkdir(cpu_dir.c_str(), 0755);
+    mkdir((cpu_dir + "/topology").c_str(), 0755);
+    // CPUs c and c + 4 are SMT siblings
+    write_file(cpu_dir + "/topology/core_id", std::to_string(c % 2));
+    write_file(cpu_dir + "/topology/physical_package_id", std::to_string((c % 4) / 2));
+  }
+  write_file(root + "/node/online", "0,2");
+  for (uint32_t n = 0; n < 3; n += 2) {
+    std::string node_dir = root + "/node/node" + std::to_string(n);
+    mkdir(node_dir.c_str(), 0755);
+    write_file(node_dir + "/cpulist", n == 0 ? "0-1,4-5" : "2-3,6-7");
+  }
+  return root;
+}
+
+/// Removes the fake sysfs tree
+static void remove_sysfs_tree(const std::string& root)
+{
+  nftw(
+      root.c_str(),
+      [](const char* path, const struct stat* sb, int flag, struct FTW* ftw) { return remove(path); },
+      16,
+      FTW_DEPTH | FTW_PHYS);
+}
+
+void test_cpu_topology_parsing(const std::string& root)
+{
+  srsran::cpu_topology topo = srsran::cpu_topology::from_sysfs(root);
+  TESTASSERT(topo.cpus().size() == 8);
+  TESTASSERT(topo.nof_numa_nodes() == 2);
+  TESTASSERT(topo.nof_physical_cores() == 4);
+  TESTASSERT(topo.cpus()[5].isolated and not topo.cpus()[4].isolated);
+  TESTASSERT(topo.cpus()[6].numa_node == 2 and topo.cpus()[6].package_id == 1 and topo.cpus()[6].core_id == 0);
+
+  // Missing sysfs yields an empty topology
+  TESTASSERT(srsran::cpu_topology::from_sysfs(root + "/none").empty());
+
+  // So does malformed sysfs content, so that no thread is pinned
+  std::string node_list = root + "/node/node2/cpulist";
+  {
+    std::ofstream f(node_list);
+    f << "2-x\n";
+  }
+  TESTASSERT(srsran::cpu_topology::from_sysfs(root).empty());
+  {
+    std::ofstream f(node_list);
+    f << "2-3,6-7\n";
+  }
+}
+
+void test_cpu_placement(const std::string& root)
+{
+  srsran::cpu_placement placement(srsran::cpu_topology::from_sysfs(root));
+
+  // Isolated cores are preferred, and the node with most free cores is selected
+  int cpu0 = placement.reserve_rt_cpu("PHY0");
+  int cpu1 = placement.reserve_rt_cpu("PHY1");
+  TESTASSERT(cpu0 == 1 and cpu1 == 3);
+
+  // SMT siblings of reserved cores are not used. CPU 0 is the last choice
+  int cpu2 = placement.reserve_rt_cpu("PHY2", 0);
+  int cpu3 = placement.reserve_rt_cpu("PHY3", 0);
+  TESTASSERT(cpu2 == 4 and cpu3 == -1);
+
+  std::vector<uint32_t> shared = placement.get_shared_cpus();
+  TESTASSERT(shared.size() == 2 and shared[0] == 2 and shared[1] == 6);
+
+  std::string report = placement.to_string();
+  TESTASSERT(report.find("PHY1") != std::string::npos);
+  TESTASSERT(report.find("isolated=[1,3,5,7]") != std::string::npos);
+  printf("%s", report.c_str());
+}
+
+int main()
+{
+  std::string root = create_sysfs_tree();
+  test_cpu_topology_parsing(root);
+  test_cpu_placement(root);
+  remove_sysfs_tree(root);
+  return 0;
+}
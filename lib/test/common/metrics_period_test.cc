@@ -0,0 +1,76 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/common/metrics_period.h"
+#include "srsran/common/test_common.h"
+#include <thread>
+
+int test_clock()
+{
+  srsran::metrics_period_clock clock(10);
+
+  // The period that has just been closed is the one before the period in progress
+  uint64_t now = clock.current();
+  TESTASSERT(clock.last_closed(std::chrono::milliseconds(0)) + 1 >= now);
+  TESTASSERT(clock.last_closed(std::chrono::milliseconds(0)) < now + 1);
+  TESTASSERT(clock.last_closed(std::chrono::milliseconds(20)) + 2 <= clock.current());
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(25));
+  TESTASSERT(clock.current() >= now + 2);
+
+  // A null period selects the default
+  srsran::metrics_period_clock default_clock(0);
+  TESTASSERT(default_clock.current() < now);
+
+  return SRSRAN_SUCCESS;
+}
+
+int test_buffer()
+{
+  srsran::metrics_period_buffer<int> buf;
+
+  // Nothing is published until the writer has been counting in a period that is over
+  TESTASSERT(buf.closes(10));
+  buf.write_buffer() = 1;
+  buf.publish();
+  TESTASSERT(buf.get_open_period() == 10);
+  TESTASSERT(not buf.closes(10));
+  TESTASSERT(buf.find(9) != nullptr and *buf.find(9) == 1);
+  TESTASSERT(buf.find(10) == nullptr);
+
+  // After periods in which the writer did not run, what it counted is published as the period just closed
+  TESTASSERT(buf.closes(13));
+  buf.write_buffer() = 2;
+  buf.publish();
+  TESTASSERT(buf.find(9) == nullptr);
+  TESTASSERT(buf.find(11) == nullptr);
+  TESTASSERT(buf.find(12) != nullptr and *buf.find(12) == 2);
+
+  return SRSRAN_SUCCESS;
+}
+
+int main()
+{
+  TESTASSERT(test_clock() == SRSRAN_SUCCESS);
+  TESTASSERT(test_buffer() == SRSRAN_SUCCESS);
+  printf("Success\n");
+  return SRSRAN_SUCCESS;
+}
@@ -0,0 +1,90 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/common/parallel_task_runner.h"
+#include "srsran/common/test_common.h"
+#include <thread>
+
+void test_serial_runner()
+{
+  srsran::parallel_task_runner runner;
+  std::vector<uint32_t>        calls;
+  auto                         task = [&calls](uint32_t idx) { calls.push_back(idx); };
+  runner.run(4, task);
+  TESTASSERT(calls == std::vector<uint32_t>({0, 1, 2, 3}));
+}
+
+void test_parallel_runner()
+{
+  srsran::task_thread_pool     pool(3);
+  srsran::parallel_task_runner runner(&pool);
+
+  const uint32_t               nof_tasks = 16;
+  std::vector<std::atomic<int> > counters(nof_tasks);
+  std::atomic<uint32_t>        nof_helper_calls{0};
+  std::thread::id              caller_id = std::this_thread::get_id();
+
+  auto task = [&](uint32_t idx) {
+    std::this_thread::sleep_for(std::chrono::microseconds(200));
+    counters[idx]++;
+    if (std::this_thread::get_id() != caller_id) {
+      nof_helper_calls++;
+    }
+  };
+
+  // Consecutive batches must not overlap and every task must run exactly once
+  for (uint32_t batch = 0; batch < 50; ++batch) {
+    runner.run(nof_tasks, task);
+    for (uint32_t i = 0; i < nof_tasks; ++i) {
+      TESTASSERT(counters[i] == (int)batch + 1);
+    }
+  }
+  TESTASSERT(nof_helper_calls > 0);
+
+  // A batch with a single task is run by the caller
+  uint32_t nof_helper_calls_before = nof_helper_calls;
+  runner.run(1, task);
+  TESTASSERT(counters[0] == 51 and nof_helper_calls == nof_helper_calls_before);
+}
+
+void test_runner_with_stopped_pool()
+{
+  srsran::task_thread_pool pool(2);
+  pool.stop();
+
+  std::vector<uint32_t> calls;
+  {
+    srsran::parallel_task_runner runner(&pool);
+    auto                         task = [&calls](uint32_t idx) { calls.push_back(idx); };
+    runner.run(4, task);
+  }
+  // The helper tasks never start, so the caller runs the whole batch and the runner is destroyed without waiting
+  TESTASSERT(calls == std::vector<uint32_t>({0, 1, 2, 3}));
+}
+
+int main()
+{
+  srslog::init();
+  test_serial_runner();
+  test_parallel_runner();
+  test_runner_with_stopped_pool();
+  return 0;
+}
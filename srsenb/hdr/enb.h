@@ -48,6 +48,7 @@
 #include "srsran/common/buffer_pool.h"
 #include "srsran/common/interfaces_common.h"
 #include "srsran/common/mac_pcap.h"
+#include "srsran/common/metrics_period.h"
 #include "srsran/common/security.h"
 #include "srsran/interfaces/enb_command_interface.h"
 #include "srsran/interfaces/enb_metrics_interface.h"
@@ -165,7 +166,8 @@ public:
 private:
   const static int ENB_POOL_SIZE = 1024 * 10;
 
-  int parse_args(const all_args_t& args_, rrc_cfg_t& rrc_cfg_, rrc_nr_cfg_t& rrc_cfg_nr_);
+  int  parse_args(const all_args_t& args_, rrc_cfg_t& rrc_cfg_, rrc_nr_cfg_t& rrc_cfg_nr_);
+  void place_rt_threads();
 
   srslog::sink&         log_sink;
   srslog::basic_logger& enb_log;
@@ -188,6 +190,11 @@ private:
   // System metrics processor.
   srsran::sys_metrics_processor sys_proc;
 
+  // Metrics periods, and the PHY and stack metrics of the last period all the layers published
+  srsran::metrics_period_clock metrics_clock;
+  std::vector<phy_metrics_t>   last_phy_metrics;
+  stack_metrics_t              last_stack_metrics = {};
+
   std::string get_build_mode();
   std::string get_build_info();
   std::string get_build_string();
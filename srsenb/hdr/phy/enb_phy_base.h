@@ -44,7 +44,11 @@ public:
 
   virtual void start_plot() = 0;
 
-  virtual void get_metrics(std::vector<phy_metrics_t>& m) = 0;
+  /// Metrics of a closed metrics period. Returns false if some worker has not published them yet
+  virtual bool get_metrics(std::vector<phy_metrics_t>& m, uint64_t period) = 0;
+
+  /// Metrics of the NR carriers, left untouched if there are none
+  virtual void get_nr_metrics(nr_phy_metrics_t& m) = 0;
 
   virtual void cmd_cell_gain(uint32_t cell_idx, float gain_db) = 0;
 
@@ -25,6 +25,8 @@
 #include <string.h>
 
 #include "../phy_common.h"
+#include "../pusch_overload_ctrl.h"
+#include "pusch_scrambling_cache.h"
 #include "srsran/srslog/srslog.h"
 
 #define LOG_EXECTIME
@@ -55,13 +57,16 @@ public:
   int  read_pucch_d(cf_t* pusch_d);
   void start_plot();
 
-  void work_ul(const srsran_ul_sf_cfg_t& ul_sf, stack_interface_phy_lte::ul_sched_t& ul_grants);
+  void work_ul(const srsran_ul_sf_cfg_t&           ul_sf,
+               stack_interface_phy_lte::ul_sched_t& ul_grants,
+               const pusch_overload_ctrl&           overload_ctrl);
   void work_dl(const srsran_dl_sf_cfg_t&            dl_sf_cfg,
                stack_interface_phy_lte::dl_sched_t& dl_grants,
                stack_interface_phy_lte::ul_sched_t& ul_grants,
                srsran_mbsfn_cfg_t*                  mbsfn_cfg);
 
   uint32_t get_metrics(std::vector<phy_metrics_t>& metrics);
+  void     get_mem_usage(phy_mem_usage_t& usage);
 
 private:
   constexpr static float PUSCH_RL_SNR_DB_TH = 1.0f;
@@ -71,8 +76,11 @@ private:
   int  encode_pmch(stack_interface_phy_lte::dl_sched_grant_t* grant, srsran_mbsfn_cfg_t* mbsfn_cfg);
   bool decode_pusch_rnti(stack_interface_phy_lte::ul_sched_grant_t& ul_grant,
                          srsran_ul_cfg_t&                           ul_cfg,
-                         srsran_pusch_res_t&                        pusch_res);
-  void decode_pusch(stack_interface_phy_lte::ul_sched_grant_t* grants, uint32_t nof_pusch);
+                         srsran_pusch_res_t&                        pusch_res,
+                         const pusch_overload_ctrl&                 overload_ctrl);
+  void decode_pusch(stack_interface_phy_lte::ul_sched_grant_t* grants,
+                    uint32_t                                   nof_pusch,
+                    const pusch_overload_ctrl&                 overload_ctrl);
   int  encode_phich(stack_interface_phy_lte::ul_sched_ack_t* acks, uint32_t nof_acks);
   int  encode_pdcch_dl(stack_interface_phy_lte::dl_sched_grant_t* grants, uint32_t nof_grants);
   int  encode_pdcch_ul(stack_interface_phy_lte::ul_sched_grant_t* grants, uint32_t nof_grants);
@@ -90,6 +98,9 @@ private:
   srsran_enb_dl_t enb_dl = {};
   srsran_enb_ul_t enb_ul = {};
 
+  // Pregenerated PUSCH DMRS of the cell, shared with the other workers
+  std::shared_ptr<const ul_dmrs_pregen> dmrs_pregen;
+
   srsran_dl_sf_cfg_t dl_sf = {};
   srsran_ul_sf_cfg_t ul_sf = {};
 
@@ -99,17 +110,16 @@ private:
   class ue
   {
   public:
-    explicit ue(uint16_t rnti_) : rnti(rnti_)
-    {
-      // Do nothing
-    }
+    explicit ue(uint16_t rnti_) : rnti(rnti_) { pusch_scrambling_cache::reset_ue(scrambling_slots); }
 
-    srsran_phich_grant_t phich_grant = {};
+    srsran_phich_grant_t               phich_grant = {};
+    pusch_scrambling_cache::ue_slots_t scrambling_slots;
 
     void     metrics_read(phy_metrics_t* metrics);
     void     metrics_dl(uint32_t mcs);
     void     metrics_ul(uint32_t mcs, float rssi, float sinr, float turbo_iters);
     void     metrics_ul_pucch(float rssi, float ni, float sinr);
+    void     metrics_ul_overload(pusch_overload_ctrl::action_t action);
     uint32_t get_rnti() const { return rnti; }
 
   private:
@@ -123,6 +133,9 @@ private:
   // Each worker keeps a local copy of the user database. Uses more memory but more efficient to manage concurrency
   std::map<uint16_t, ue*> ue_db;
   std::mutex              mutex;
+
+  // PUSCH scrambling sequences of the users in ue_db
+  pusch_scrambling_cache pusch_scrambling;
 };
 
 } // namespace lte
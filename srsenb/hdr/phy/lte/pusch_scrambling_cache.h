@@ -0,0 +1,120 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSENB_PUSCH_SCRAMBLING_CACHE_H
+#define SRSENB_PUSCH_SCRAMBLING_CACHE_H
+
+#include "srsran/phy/phch/pusch_cfg.h"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace srsenb {
+namespace lte {
+
+/**
+ * Keeps the PUSCH scrambling sequences of the UEs of a carrier, so that they are generated once per RNTI and subframe
+ * instead of once per grant. The sequence of a subframe only depends on the RNTI and the cell, and it is generated
+ * on the first grant that needs it, for the number of bits of that grant. Longer grants extend it later.
+ *
+ * The memory is allocated at init() from a budget and split in slots holding the sequence of one subframe as packed
+ * bits. The sequence returned by get() is unpacked from its slot into a scratch buffer of the cache, it is valid until
+ * the next call to get(). Slots come
+ * in a few size classes, from the largest grant of the cell down to a quarter of it each time, each class taking an
+ * equal share of the budget, so small grants do not take a full-band slot. A sequence is kept in the smallest slot that
+ * fits its grant and moves to a larger one when a longer grant needs it. When no slot is free they are taken back from
+ * their UEs in round-robin order, skipping the slots used since the last round, and grants without a cached sequence
+ * fall back to generating it on the fly. The cache is not thread-safe, it belongs to one worker like the rest of its UE
+ * database, and so does its scratch buffer.
+ */
+class pusch_scrambling_cache
+{
+public:
+  /// Slot of every subframe of a UE, negative if it has none. Owned by the UE, released with release()
+  using ue_slots_t = std::array<int32_t, SRSRAN_NOF_SF_X_FRAME>;
+
+  pusch_scrambling_cache() = default;
+  ~pusch_scrambling_cache();
+  pusch_scrambling_cache(const pusch_scrambling_cache&) = delete;
+  pusch_scrambling_cache& operator=(const pusch_scrambling_cache&) = delete;
+
+  /// Allocates as many slots as fit in budget_bytes for a cell of nof_prb PRB and the scratch buffer, returns false if
+  /// allocation failed
+  bool init(uint32_t budget_bytes, uint32_t cell_id, uint32_t nof_prb, bool llr_is_8bit);
+
+  static void reset_ue(ue_slots_t& ue_slots) { ue_slots.fill(-1); }
+
+  /// Returns the sequence of the RNTI and subframe covering nof_bits, or an empty one if it is not cached. The sequence
+  /// is overwritten by the next call
+  srsran_pusch_scrambling_t get(ue_slots_t& ue_slots, uint16_t rnti, uint32_t sf_idx, uint32_t nof_bits);
+
+  /// Returns the slots of a UE to the cache
+  void release(ue_slots_t& ue_slots);
+
+  /// Detaches every slot from its UE, the UE slot arrays shall be reset with reset_ue()
+  void clear();
+
+  uint32_t nof_slots() const { return slots.size(); }
+  uint32_t nof_free_slots() const;
+  uint32_t nof_classes() const { return classes.size(); }
+  /// Largest sequence held by the slots of a size class, class 0 holding the largest grant of the cell
+  uint32_t class_max_bits(uint32_t cls) const { return classes[cls].max_bits; }
+
+  /// Bytes allocated for the sequences and the scratch buffer
+  uint64_t nof_bytes() const;
+
+private:
+  // Size classes shrink by this factor down to one PRB with QPSK
+  static const uint32_t MAX_CLASSES  = 4;
+  static const uint32_t CLASS_FACTOR = 4;
+
+  struct slot_t {
+    uint8_t* c_packed = nullptr;
+    int32_t* owner    = nullptr; ///< Entry of the UE slot array pointing to this slot
+    uint32_t len      = 0;       ///< Number of bits generated
+    uint32_t cls      = 0;       ///< Size class
+    bool     used     = false;   ///< Used since the victim pointer last went over it
+  };
+
+  struct class_t {
+    uint32_t              max_bits    = 0;
+    uint32_t              first_slot  = 0; ///< Slots of a class are contiguous
+    uint32_t              nof_slots   = 0;
+    uint32_t              next_victim = 0;
+    std::vector<uint32_t> free_slots;
+  };
+
+  int32_t alloc_slot(uint32_t nof_bits);
+  void    free_slot(int32_t idx);
+
+  uint32_t             cell_id       = 0;
+  uint32_t             max_bits      = 0;
+  int8_t*              c_char        = nullptr; ///< Scratch buffer of the unpacked sequence
+  int16_t*             c_short       = nullptr; ///< Scratch buffer of the unpacked sequence, 16-bit descrambling only
+  uint64_t             scratch_bytes = 0;
+  std::vector<slot_t>  slots;
+  std::vector<class_t> classes; ///< From the largest slots to the smallest
+};
+
+} // namespace lte
+} // namespace srsenb
+
+#endif // SRSENB_PUSCH_SCRAMBLING_CACHE_H
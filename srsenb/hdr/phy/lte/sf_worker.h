@@ -26,7 +26,11 @@
 #include <string.h>
 
 #include "../phy_common.h"
+#include "../pusch_overload_ctrl.h"
 #include "cc_worker.h"
+#include "srsran/adt/pool/tti_arena.h"
+#include "srsran/common/parallel_task_runner.h"
+#include "srsran/common/rt_alloc_check.h"
 #include "srsran/srslog/srslog.h"
 #include "srsran/srsran.h"
 
@@ -36,9 +40,9 @@ namespace lte {
 class sf_worker : public srsran::thread_pool::worker
 {
 public:
-  sf_worker(srslog::basic_logger& logger) : logger(logger) {}
+  sf_worker(srslog::basic_logger& logger) : logger(logger), alloc_checker(logger, "sf_worker") {}
   ~sf_worker();
-  void init(phy_common* phy);
+  void init(phy_common* phy, srsran::task_thread_pool* cc_pool = nullptr);
 
   cf_t* get_buffer_rx(uint32_t cc_idx, uint32_t antenna_idx);
   void  set_context(const srsran::phy_common_interface::worker_context_t& w_ctx);
@@ -56,10 +60,17 @@ public:
   int      read_pucch_d(uint32_t cc_idx, cf_t* pusch_d);
   void     start_plot();
 
-  uint32_t get_metrics(std::vector<phy_metrics_t>& metrics);
+  /// Metrics of a closed period, nullptr until the worker has published them. Only called by the metrics thread
+  const std::vector<phy_metrics_t>* get_metrics(uint64_t period) { return period_metrics.find(period); }
+  /// Period in which the worker is counting its metrics
+  uint64_t get_metrics_period() const { return period_metrics.get_open_period(); }
+  /// Makes the next run of the worker close its metrics period without processing a TTI
+  void set_metrics_only() { metrics_only = true; }
+  void get_mem_usage(phy_mem_usage_t& usage);
 
 private:
   void work_imp() final;
+  void publish_metrics();
 
   /* Common objects */
   srslog::basic_logger& logger;
@@ -70,9 +81,21 @@ private:
 
   uint32_t                                       tti_rx = 0, tti_tx_dl = 0, tti_tx_ul = 0;
   std::vector<std::unique_ptr<cc_worker> >       cc_workers;
+  srsran::parallel_task_runner                   cc_runner; ///< Runs the carriers of a TTI, in parallel if possible
+  pusch_overload_ctrl                            overload_ctrl;
   srsran::phy_common_interface::worker_context_t context = {};
 
   srsran_softbuffer_tx_t temp_mbsfn_softbuffer = {};
+
+  /* Metrics of the carriers, published from the worker thread once per period */
+  srsran::metrics_period_buffer<std::vector<phy_metrics_t> > period_metrics;
+  std::vector<phy_metrics_t>                                 cc_metrics;
+  bool                                                       metrics_only = false;
+
+  /* Scratch memory released at the end of every TTI */
+  const static size_t      TTI_ARENA_SIZE = 64 * 1024;
+  srsran::tti_arena        tti_arena{TTI_ARENA_SIZE};
+  srsran::rt_alloc_checker alloc_checker;
 };
 
 } // namespace lte
@@ -0,0 +1,93 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSENB_UL_DMRS_TABLES_H
+#define SRSENB_UL_DMRS_TABLES_H
+
+#include "srsran/srsran.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace srsenb {
+namespace lte {
+
+/**
+ * PUSCH DMRS pregenerated for every cyclic shift, subframe and number of PRB of a cell. It is read-only once generated,
+ * so the workers processing the cell can all use the same table.
+ */
+class ul_dmrs_pregen
+{
+public:
+  ul_dmrs_pregen() = default;
+  ~ul_dmrs_pregen();
+  ul_dmrs_pregen(const ul_dmrs_pregen&) = delete;
+  ul_dmrs_pregen& operator=(const ul_dmrs_pregen&) = delete;
+
+  /// Allocates and generates the table, returns false on error
+  bool init(const srsran_cell_t& cell, const srsran_refsignal_dmrs_pusch_cfg_t& cfg);
+
+  const srsran_refsignal_ul_dmrs_pregen_t* get() const { return &pregen; }
+  uint32_t nof_bytes() const { return srsran_refsignal_dmrs_pusch_pregen_nof_bytes(&pregen); }
+
+private:
+  srsran_refsignal_ul_t             signal = {};
+  srsran_refsignal_ul_dmrs_pregen_t pregen = {};
+};
+
+/**
+ * Hands out the PUSCH DMRS tables of the configured cells. The table of a cell configuration is generated by its
+ * first user and freed with its last one, workers asking for the same configuration get the same table. Thread-safe,
+ * the generation runs outside the registry lock so that only the users of the same configuration wait for it.
+ */
+class ul_dmrs_tables
+{
+public:
+  /// Returns the table of the cell and DMRS configuration, nullptr if it could not be generated
+  std::shared_ptr<const ul_dmrs_pregen> get(const srsran_cell_t&                     cell,
+                                            const srsran_refsignal_dmrs_pusch_cfg_t& cfg);
+
+  /// Number of tables in use and bytes they take
+  uint32_t nof_tables();
+  uint64_t nof_bytes();
+
+private:
+  /// Table shared by the users of a configuration, generated once by the first of them
+  struct table_slot {
+    std::once_flag    once;
+    std::atomic<bool> ready = {false};
+    ul_dmrs_pregen    table;
+  };
+  struct entry_t {
+    srsran_cell_t                     cell;
+    srsran_refsignal_dmrs_pusch_cfg_t cfg;
+    std::weak_ptr<table_slot>         slot;
+  };
+
+  std::mutex           mutex;
+  std::vector<entry_t> entries;
+};
+
+} // namespace lte
+} // namespace srsenb
+
+#endif // SRSENB_UL_DMRS_TABLES_H
@@ -24,14 +24,17 @@
 
 #include "sf_worker.h"
 #include "srsran/common/thread_pool.h"
+#include <memory>
 
 namespace srsenb {
 namespace lte {
 
 class worker_pool
 {
-  srsran::thread_pool                      pool;
-  std::vector<std::unique_ptr<sf_worker> > workers;
+  srsran::thread_pool                       pool;
+  std::unique_ptr<srsran::task_thread_pool> cc_pool; ///< Threads shared by the workers to process carriers in parallel
+  std::vector<std::unique_ptr<sf_worker> >  workers; ///< Destroyed before cc_pool, which they reference
+  uint64_t                                  metrics_period = 0; ///< Last period closed by all the workers
 
 public:
   sf_worker* operator[](std::size_t pos) { return workers.at(pos).get(); }
@@ -42,6 +45,7 @@ public:
   sf_worker* wait_worker(uint32_t tti);
   sf_worker* wait_worker_id(uint32_t id);
   void       start_worker(sf_worker* w);
+  void       close_metrics_period(uint64_t period);
   void       stop();
 };
 
@@ -22,11 +22,16 @@
 #ifndef SRSENB_NR_SLOT_WORKER_H
 #define SRSENB_NR_SLOT_WORKER_H
 
+#include "../phy_metrics.h"
+#include "../pusch_overload_ctrl.h"
+#include "srsran/adt/pool/tti_arena.h"
+#include "srsran/common/rt_alloc_check.h"
 #include "srsran/common/thread_pool.h"
 #include "srsran/interfaces/gnb_interfaces.h"
 #include "srsran/interfaces/phy_common_interface.h"
 #include "srsran/srslog/srslog.h"
 #include "srsran/srsran.h"
+#include <atomic>
 
 namespace srsenb {
 namespace nr {
@@ -59,15 +64,19 @@ public:
   };
 
   struct args_t {
-    uint32_t                    cell_index       = 0;
-    uint32_t                    nof_max_prb      = SRSRAN_MAX_PRB_NR;
-    uint32_t                    nof_tx_ports     = 1;
-    uint32_t                    nof_rx_ports     = 1;
-    uint32_t                    rf_port          = 0;
-    srsran_subcarrier_spacing_t scs              = srsran_subcarrier_spacing_15kHz;
-    uint32_t                    pusch_max_its    = 10;
-    float                       pusch_min_snr_dB = -10.0f;
-    double                      srate_hz         = 0.0;
+    uint32_t                    cell_index         = 0;
+    uint32_t                    nof_max_prb        = SRSRAN_MAX_PRB_NR;
+    uint32_t                    nof_tx_ports       = 1;
+    uint32_t                    nof_rx_ports       = 1;
+    uint32_t                    rf_port            = 0;
+    srsran_subcarrier_spacing_t scs                = srsran_subcarrier_spacing_15kHz;
+    uint32_t                    pusch_max_its      = 10;
+    uint32_t                    pdsch_coworkers    = 0; ///< Threads encoding PDSCH code blocks with the worker
+    uint32_t                    pusch_budget_us    = 0;
+    uint32_t                    pusch_overload_its = 4;
+    uint32_t                    pusch_overload_pct = 50;
+    float                       pusch_min_snr_dB   = -10.0f;
+    double                      srate_hz           = 0.0;
   };
 
   slot_worker(srsran::phy_common_interface& common_,
@@ -88,6 +97,9 @@ public:
   uint32_t get_buffer_len();
   void     set_context(const srsran::phy_common_interface::worker_context_t& w_ctx);
 
+  /// Adds the counters of the worker to the metrics. Can be called from any thread
+  void get_metrics(nr_phy_metrics_t& metrics) const;
+
 private:
   /**
    * @brief Inherited from thread_pool::worker. Function called every slot to run the DL/UL processing
@@ -122,7 +134,17 @@ private:
   srsran_gnb_ul_t                                gnb_ul      = {};
   std::vector<cf_t*>                             tx_buffer; ///< Baseband transmit buffers
   std::vector<cf_t*>                             rx_buffer; ///< Baseband receive buffers
+  pusch_overload_ctrl                            overload_ctrl;
+
+  /* Copies of the PDSCH Tx soft-buffer counters, read by the metrics thread */
+  std::atomic<uint64_t> pdsch_tx_cache_hit  = {0};
+  std::atomic<uint64_t> pdsch_tx_cache_miss = {0};
   std::mutex mutex; ///< Protect concurrent access from workers (and main process that inits the class)
+
+  /* Scratch memory released at the end of every slot */
+  const static size_t      SLOT_ARENA_SIZE = 64 * 1024;
+  srsran::tti_arena        slot_arena{SLOT_ARENA_SIZE};
+  srsran::rt_alloc_checker alloc_checker;
 };
 
 } // namespace nr
@@ -101,13 +101,18 @@ private:
 
 public:
   struct args_t {
-    double                 srate_hz          = 0.0;
-    uint32_t               nof_phy_threads   = 3;
-    uint32_t               nof_prach_workers = 0;
-    uint32_t               prio              = 52;
-    uint32_t               pusch_max_its     = 10;
-    float                  pusch_min_snr_dB  = -10;
-    srsran::phy_log_args_t log               = {};
+    double                 srate_hz           = 0.0;
+    uint32_t               nof_phy_threads    = 3;
+    uint32_t               nof_prach_workers  = 0;
+    uint32_t               prio               = 52;
+    uint32_t               pusch_max_its      = 10;
+    uint32_t               pdsch_coworkers    = 0;
+    uint32_t               pusch_budget_us    = 0;
+    uint32_t               pusch_overload_its = 4;
+    uint32_t               pusch_overload_pct = 50;
+    float                  pusch_min_snr_dB   = -10;
+    srsran::phy_log_args_t log                = {};
+    std::vector<uint32_t>  worker_cpus; ///< CPU of each worker, empty if workers are not pinned
   };
   slot_worker* operator[](std::size_t pos) { return workers.at(pos).get(); }
 
@@ -121,6 +126,7 @@ public:
   void         start_worker(slot_worker* w);
   void         stop();
   int          set_common_cfg(const phy_interface_rrc_nr::common_cfg_t& common_cfg);
+  void         get_metrics(nr_phy_metrics_t& metrics);
 };
 
 } // namespace nr
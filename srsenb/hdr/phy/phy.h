@@ -72,7 +72,9 @@ public:
   void set_config(uint16_t rnti, const phy_rrc_cfg_list_t& phy_cfg_list) override;
   void complete_config(uint16_t rnti) override;
 
-  void get_metrics(std::vector<phy_metrics_t>& metrics) override;
+  bool get_metrics(std::vector<phy_metrics_t>& metrics, uint64_t period) override;
+  void get_nr_metrics(nr_phy_metrics_t& metrics) override;
+  void get_mem_usage(phy_mem_usage_t& usage);
 
   void cmd_cell_gain(uint32_t cell_id, float gain_db) override;
   void cmd_cell_measure() override;
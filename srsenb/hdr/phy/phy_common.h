@@ -23,9 +23,11 @@
 #define SRSENB_PHCH_COMMON_H
 
 #include "phy_interfaces.h"
+#include "srsenb/hdr/phy/lte/ul_dmrs_tables.h"
 #include "srsenb/hdr/phy/phy_ue_db.h"
 #include "srsran/common/gen_mch_tables.h"
 #include "srsran/common/interfaces_common.h"
+#include "srsran/common/metrics_period.h"
 #include "srsran/common/standard_streams.h"
 #include "srsran/common/thread_pool.h"
 #include "srsran/common/threads.h"
@@ -279,6 +281,12 @@ public:
   // Common Physical Uplink DMRS configuration
   srsran_refsignal_dmrs_pusch_cfg_t dmrs_pusch_cfg = {};
 
+  // Pregenerated Physical Uplink DMRS, shared by the workers of each cell
+  lte::ul_dmrs_tables ul_dmrs_tables;
+
+  // Periods in which the workers count their metrics
+  srsran::metrics_period_clock metrics_clock;
+
   srsran::radio_interface_phy* radio      = nullptr;
   stack_interface_phy_lte*     stack      = nullptr;
   srsran::channel_ptr          dl_channel = nullptr;
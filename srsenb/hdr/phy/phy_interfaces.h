@@ -63,9 +63,15 @@ struct phy_args_t {
   float                   max_prach_offset_us = 10;
   uint32_t                pusch_max_its       = 10;
   uint32_t                nr_pusch_max_its    = 10;
+  uint32_t                nr_pdsch_coworkers  = 0; ///< Threads helping each NR worker to encode the PDSCH code blocks
+  uint32_t                pusch_budget_us     = 0; ///< PUSCH decoding budget per TTI, 0 disables the overload control
+  uint32_t                pusch_overload_its  = 4;  ///< Maximum decoder iterations once the budget is partly used
+  uint32_t                pusch_overload_pct  = 50; ///< Share of the budget, in percent, past which they apply
   bool                    pusch_8bit_decoder  = false;
+  uint32_t                pusch_seq_cache_kb  = 0; ///< PUSCH scrambling cache size of each worker and carrier
   float                   tx_amplitude        = 1.0f;
   uint32_t                nof_phy_threads     = 1;
+  uint32_t                nof_phy_cc_threads  = 0;
   std::string             equalizer_mode      = "mmse";
   float                   estimator_fil_w     = 1.0f;
   bool                    pusch_meas_epre     = true;
@@ -73,6 +79,11 @@ struct phy_args_t {
   bool                    pusch_meas_ta       = true;
   bool                    pucch_meas_ta       = true;
   uint32_t                nof_prach_threads   = 1;
+  uint32_t                metrics_period_ms   = 0; ///< Metrics reporting period, 0 for the default
+  bool                    rt_cpu_placement    = false;
+  std::vector<uint32_t>   worker_cpus;              ///< CPU of each PHY worker, empty if workers are not pinned
+  std::vector<uint32_t>   nr_worker_cpus;           ///< CPU of each NR PHY worker, empty if workers are not pinned
+  int                     txrx_cpu            = -1; ///< CPU of the radio thread, -1 if not pinned
   bool                    extended_cp         = false;
   srsran::channel::args_t dl_channel_args;
   srsran::channel::args_t ul_channel_args;
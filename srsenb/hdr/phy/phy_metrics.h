@@ -22,6 +22,7 @@
 #ifndef SRSENB_PHY_METRICS_H
 #define SRSENB_PHY_METRICS_H
 
+#include <cstdint>
 #include <limits>
 
 namespace srsenb {
@@ -40,6 +41,8 @@ struct ul_metrics_t {
   float   mcs;
   int     n_samples;
   int     n_samples_pucch;
+  int     n_overload_reduced_its; ///< TBs decoded with reduced iterations by the PUSCH overload control
+  int     n_overload_nacks;       ///< TBs NACKed without decoding by the PUSCH overload control
 };
 
 struct dl_metrics_t {
@@ -53,6 +56,23 @@ struct phy_metrics_t {
   ul_metrics_t ul;
 };
 
+// NR PHY metrics, cumulative since the PHY started
+
+struct nr_phy_metrics_t {
+  uint64_t pdsch_tx_cache_hit  = 0; ///< PDSCH TBs rate matched from the code blocks kept in the Tx soft-buffer
+  uint64_t pdsch_tx_cache_miss = 0; ///< PDSCH TBs encoded
+};
+
+// PHY memory by category, in bytes
+
+struct phy_mem_usage_t {
+  uint64_t shared_tables      = 0; ///< Read-only tables shared by the workers of a cell, counted once
+  uint32_t nof_shared_tables  = 0;
+  uint64_t shared_tables_refs = 0; ///< What the shared tables would take with a private copy in every worker
+  uint64_t sample_buffers     = 0; ///< Baseband buffers of the carrier workers
+  uint64_t pusch_scrambling   = 0; ///< PUSCH scrambling sequence caches of the carrier workers
+};
+
 } // namespace srsenb
 
 #endif // SRSENB_PHY_METRICS_H
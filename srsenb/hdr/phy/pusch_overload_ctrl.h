@@ -0,0 +1,87 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSENB_PUSCH_OVERLOAD_CTRL_H
+#define SRSENB_PUSCH_OVERLOAD_CTRL_H
+
+#include <chrono>
+#include <cstdint>
+
+namespace srsenb {
+
+/**
+ * Keeps the PUSCH decoding of a TTI within a processing budget. The budget is counted from the start of the UL
+ * processing of the TTI and, as it runs out, the decoding of the remaining grants is degraded, so that an overloaded
+ * TTI only costs the grants it cannot afford instead of delaying every UE of the cell:
+ *  - Past a share of the budget (half by default), the transport blocks are decoded with a reduced maximum number of
+ *    iterations.
+ *  - Past the budget, the transport blocks are not decoded and are NACKed. UCI is still decoded.
+ *
+ * A budget of zero disables the control. get_action() is read-only, so the carriers of a TTI processed in parallel can
+ * share the same instance.
+ */
+class pusch_overload_ctrl
+{
+public:
+  using clock_t = std::chrono::steady_clock;
+
+  enum class action_t { decode, reduce_iterations, skip_data };
+
+  /// reduce_pct_ is the share of the budget, in percent, past which the iterations are reduced
+  void init(uint32_t budget_us_, uint32_t reduced_max_its_, uint32_t reduce_pct_ = 50)
+  {
+    budget          = std::chrono::microseconds(budget_us_);
+    reduced_max_its = reduced_max_its_;
+    reduce_pct      = reduce_pct_;
+  }
+
+  bool     enabled() const { return budget.count() > 0; }
+  uint32_t get_reduced_max_its() const { return reduced_max_its; }
+
+  /// Marks the start of the UL processing of a TTI
+  void start_tti(clock_t::time_point t = clock_t::now()) { tti_start = t; }
+
+  /// Selects how the next grant of the TTI shall be decoded
+  action_t get_action(clock_t::time_point now = clock_t::now()) const
+  {
+    if (not enabled()) {
+      return action_t::decode;
+    }
+    clock_t::duration elapsed = now - tti_start;
+    if (elapsed >= budget) {
+      return action_t::skip_data;
+    }
+    if (100 * elapsed >= reduce_pct * budget) {
+      return action_t::reduce_iterations;
+    }
+    return action_t::decode;
+  }
+
+private:
+  std::chrono::microseconds budget{0};
+  uint32_t                  reduced_max_its = 2;
+  uint32_t                  reduce_pct      = 50;
+  clock_t::time_point       tti_start;
+};
+
+} // namespace srsenb
+
+#endif // SRSENB_PUSCH_OVERLOAD_CTRL_H
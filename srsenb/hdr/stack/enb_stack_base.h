@@ -92,8 +92,8 @@ public:
   virtual void stop() = 0;
 
   virtual void toggle_padding() = 0;
-  // eNB metrics interface
-  virtual bool get_metrics(stack_metrics_t* metrics) = 0;
+  // eNB metrics interface. Fills the metrics of a closed metrics period, returns false if they are not complete yet
+  virtual bool get_metrics(stack_metrics_t* metrics, uint64_t period) = 0;
 
   virtual void tti_clock() = 0;
 };
@@ -38,7 +38,9 @@
 #include "enb_stack_base.h"
 #include "srsran/common/bearer_manager.h"
 #include "srsran/common/mac_pcap_net.h"
+#include "srsran/common/metrics_period.h"
 #include "srsran/interfaces/enb_interfaces.h"
+#include "srsran/interfaces/enb_metrics_interface.h"
 #include "srsran/srslog/srslog.h"
 
 namespace srsenb {
@@ -58,7 +60,7 @@ public:
   int  init(const stack_args_t& args_, const rrc_cfg_t& rrc_cfg_, phy_interface_stack_lte* phy_, x2_interface* x2_);
   void stop() final;
   std::string get_type() final;
-  bool        get_metrics(stack_metrics_t* metrics) final;
+  bool        get_metrics(stack_metrics_t* metrics, uint64_t period) final;
 
   /* PHY-MAC interface */
   int  sr_detected(uint32_t tti, uint16_t rnti) final { return mac.sr_detected(tti, rnti); }
@@ -153,6 +155,7 @@ private:
   void run_thread() override;
   void stop_impl();
   void tti_clock_impl();
+  void publish_upper_metrics();
 
   // args
   stack_args_t args    = {};
@@ -173,7 +176,7 @@ private:
 
   // task handling
   srsran::task_scheduler    task_sched;
-  srsran::task_queue_handle enb_task_queue, sync_task_queue, metrics_task_queue, x2_task_queue;
+  srsran::task_queue_handle enb_task_queue, sync_task_queue, x2_task_queue;
 
   // bearer management
   enb_bearer_manager                 bearers; // helper to manage mapping between EPS and radio bearers
@@ -192,7 +195,10 @@ private:
   // state
   std::atomic<bool> started{false};
 
-  srsran::dyn_blocking_queue<stack_metrics_t> pending_stack_metrics;
+  // metrics of the layers run by the stack thread, published from it once per period
+  srsran::metrics_period_clock                    metrics_clock;
+  srsran::metrics_period_buffer<stack_metrics_t> upper_metrics;
+  uint32_t                                        upper_metrics_nof_tti = 0; ///< TTIs of the period being counted
 };
 
 } // namespace srsenb
@@ -57,6 +57,8 @@ struct mac_ue_metrics_t {
   int   dl_mcs_samples;
   float ul_mcs;
   int   ul_mcs_samples;
+  int   n_overload_reduced_its; ///< TBs decoded with reduced iterations by the PUSCH overload control
+  int   n_overload_nacks;       ///< TBs NACKed without decoding by the PUSCH overload control
 };
 /// MAC misc information for each cc.
 struct mac_cc_info_t {
@@ -66,10 +68,26 @@ struct mac_cc_info_t {
   uint32_t cc_rach_counter;
 };
 
+/// Usage of the UL softbuffer code blocks shared by all UEs.
+struct mac_softbuffer_pool_metrics_t {
+  /// Number of code block buffers allocated.
+  uint32_t nof_cb;
+  /// Maximum number of code block buffers.
+  uint32_t max_cb;
+  /// Number of code block buffers in use by the UEs.
+  uint32_t nof_used_cb;
+  /// Maximum number of code block buffers that have been in use at the same time.
+  uint32_t peak_used_cb;
+  /// Number of code blocks that could not be taken because the pool was exhausted.
+  uint64_t nof_alloc_fail;
+};
+
 /// Main MAC metrics.
 struct mac_metrics_t {
   /// Per CC info.
   std::vector<mac_cc_info_t> cc_info;
+  /// UL softbuffer code block pool usage.
+  mac_softbuffer_pool_metrics_t softbuffer_pool;
   /// Per UE MAC metrics.
   std::vector<mac_ue_metrics_t> ues;
 };
@@ -30,6 +30,7 @@
 #include "srsran/adt/pool/batch_mem_pool.h"
 #include "srsran/common/mac_pcap.h"
 #include "srsran/common/mac_pcap_net.h"
+#include "srsran/common/metrics_period.h"
 #include "srsran/common/task_scheduler.h"
 #include "srsran/common/threads.h"
 #include "srsran/common/tti_sync_cv.h"
@@ -102,7 +103,8 @@ public:
   /* Handover-related */
   uint16_t reserve_new_crnti(const sched_interface::ue_cfg_t& ue_cfg) override;
 
-  void get_metrics(mac_metrics_t& metrics);
+  /// Metrics of a closed metrics period. Returns false if the MAC has not published them yet
+  bool get_metrics(mac_metrics_t& metrics, uint64_t period);
 
   void toggle_padding();
 
@@ -118,6 +120,7 @@ private:
   bool     check_ue_active(uint16_t rnti);
   uint16_t allocate_ue(uint32_t enb_cc_idx);
   bool     is_valid_rnti_unprotected(uint16_t rnti);
+  void     close_metrics_period();
 
   /* helper function for PDCCH orders */
   /**
@@ -203,8 +206,17 @@ private:
   // PDCCH order
   std::vector<sched_interface::dl_sched_po_info_t> pending_po_prachs = {};
 
+  // Pool of UL code block buffers shared by the UE softbuffers. It must outlive softbuffer_pool
+  const static uint32_t    RX_CB_POOL_CHUNK_SIZE = 64;
+  srsran_softbuffer_pool_t rx_cb_pool            = {};
+
   // Softbuffer pool
   std::unique_ptr<srsran::obj_pool_itf<ue_cc_softbuffers> > softbuffer_pool;
+
+  // Metrics of the MAC and the scheduler, published from the PHY workers once per period
+  srsran::metrics_period_clock                  metrics_clock;
+  srsran::metrics_period_buffer<mac_metrics_t> period_metrics;
+  std::atomic_flag                              metrics_busy = ATOMIC_FLAG_INIT; ///< Held by the worker publishing
 };
 
 } // namespace srsenb
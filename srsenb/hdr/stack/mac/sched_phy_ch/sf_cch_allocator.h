@@ -21,6 +21,7 @@
 
 #include "../sched_lte_common.h"
 #include "sched_result.h"
+#include "srsran/adt/pool/tti_arena.h"
 
 #ifndef SRSRAN_PDCCH_SCHED_H
 #define SRSRAN_PDCCH_SCHED_H
@@ -67,7 +68,8 @@ public:
   void        get_allocs(alloc_result_t* vec = nullptr, pdcch_mask_t* tot_mask = nullptr, size_t idx = 0) const;
   uint32_t    nof_cces() const { return cc_cfg->nof_cce_table[current_cfix]; }
   size_t      nof_allocs() const { return dci_record_list.size(); }
-  std::string result_to_string(bool verbose = false) const;
+  /// Returns the PDCCH allocations as text, allocated from the TTI arena of the calling worker
+  srsran::tti_arena_string result_to_string(bool verbose = false) const;
 
 private:
   /// DCI allocation parameters
@@ -19,6 +19,7 @@
  *
  */
 
+#include <array>
 #include <map>
 #include <string.h>
 #include <unordered_map>
@@ -47,14 +48,77 @@ namespace srsenb {
 
 class pdcp_interface_gtpu;
 
-class gtpu_tunnel_manager
+/**
+ * Buffer of the SDUs of a bearer received while its PDCP is still getting configured during handover.
+ * SDUs with a PDCP SN are stored at their SN offset, so they are read in SN order without sorting, and SDUs without
+ * PDCP SN are read after them in arrival order. The storage grows in segments allocated from the byte buffer pool,
+ * so its size follows the rate of the bearer, up to max_sdus SDUs so that a single bearer cannot deplete the pool.
+ */
+class gtpu_sdu_buffer
 {
-  // Buffer used to store SDUs while PDCP is still getting configured during handover.
-  // Note: The buffer cannot be too large, otherwise it risks depleting the byte buffer pool.
-  const static size_t BUFFER_SIZE = 512;
-  using buffered_sdu_list = srsran::bounded_vector<std::pair<uint32_t, srsran::unique_byte_buffer_t>, BUFFER_SIZE>;
-
+public:
   static const uint32_t undefined_pdcp_sn = std::numeric_limits<uint32_t>::max();
+  static const uint32_t default_max_sdus  = 4096;
+
+  /// pdcp_sn_len is the PDCP SN length of the bearer, 0 to use the 16 bits of the PDCP PDU Number extension header
+  explicit gtpu_sdu_buffer(uint32_t pdcp_sn_len = 0, uint32_t max_sdus_ = default_max_sdus) :
+    sn_mod(pdcp_sn_len == 0 or pdcp_sn_len > MAX_SN_LEN ? MAX_SN_MOD : 1U << pdcp_sn_len), max_sdus(max_sdus_)
+  {
+  }
+
+  /// Stores an SDU. Returns false if it could not be stored, in which case the SDU is discarded
+  bool push(uint32_t pdcp_sn, srsran::unique_byte_buffer_t sdu);
+
+  /// Calls func(pdcp_sn, sdu) for every SDU in order and empties the buffer
+  template <typename Func>
+  void flush(Func&& func)
+  {
+    for (uint32_t i = 0; i < sn_segments.size(); ++i) {
+      if (not sn_segments[i].has_value()) {
+        continue;
+      }
+      for (uint32_t j = 0; j < SEGMENT_SIZE; ++j) {
+        srsran::unique_byte_buffer_t& sdu = (*sn_segments[i])[j];
+        if (sdu != nullptr) {
+          func((base_sn + i * SEGMENT_SIZE + j) % sn_mod, std::move(sdu));
+        }
+      }
+    }
+    for (uint32_t i = 0; i < nof_fifo_sdus; ++i) {
+      func(undefined_pdcp_sn, std::move((*fifo_segments[i / SEGMENT_SIZE])[i % SEGMENT_SIZE]));
+    }
+    clear();
+  }
+
+  void   clear();
+  size_t size() const { return nof_sdus; }
+  bool   empty() const { return nof_sdus == 0; }
+  bool   full() const { return nof_sdus >= max_sdus; }
+
+private:
+  // SNs of the PDCP PDU Number extension header are up to 16 bits long
+  static const uint32_t MAX_SN_LEN   = 16;
+  static const uint32_t MAX_SN_MOD   = 1U << MAX_SN_LEN;
+  static const uint32_t SEGMENT_SIZE = 512;
+  static const uint32_t MAX_SEGMENTS = MAX_SN_MOD / SEGMENT_SIZE;
+
+  using segment_t      = std::array<srsran::unique_byte_buffer_t, SEGMENT_SIZE>;
+  using segment_list_t = srsran::bounded_vector<srsran::byte_buffer_pool_ptr<segment_t>, MAX_SEGMENTS>;
+
+  srsran::unique_byte_buffer_t* get_slot(segment_list_t& segments, uint32_t idx);
+
+  uint32_t       sn_mod;   ///< SN modulus of the bearer
+  uint32_t       max_sdus; ///< Maximum number of SDUs buffered for the bearer
+  uint32_t       base_sn = 0;
+  uint32_t       nof_sdus      = 0;
+  uint32_t       nof_fifo_sdus = 0;
+  segment_list_t sn_segments;
+  segment_list_t fifo_segments;
+};
+
+class gtpu_tunnel_manager
+{
+  static const uint32_t undefined_pdcp_sn = gtpu_sdu_buffer::undefined_pdcp_sn;
 
 public:
   // A UE should have <= 3 DRBs active, and each DRB should have two tunnels active at the same time at most
@@ -68,12 +132,13 @@ public:
     uint32_t teid_in       = 0;
     uint32_t teid_out      = 0;
     uint32_t spgw_addr     = 0;
+    uint32_t pdcp_sn_len   = 0; ///< PDCP SN length of the bearer, 0 if unknown
 
-    tunnel_state                                    state = tunnel_state::pdcp_active;
-    srsran::unique_timer                            rx_timer;
-    srsran::byte_buffer_pool_ptr<buffered_sdu_list> buffer;
-    tunnel*                                         fwd_tunnel = nullptr; ///< forward Rx SDUs to this TEID
-    srsran::move_callback<void()>                   on_removal;
+    tunnel_state                                  state = tunnel_state::pdcp_active;
+    srsran::unique_timer                          rx_timer;
+    srsran::byte_buffer_pool_ptr<gtpu_sdu_buffer> buffer;
+    tunnel*                                       fwd_tunnel = nullptr; ///< forward Rx SDUs to this TEID
+    srsran::move_callback<void()>                 on_removal;
 
     tunnel()                             = default;
     tunnel(tunnel&&) noexcept            = default;
@@ -111,7 +176,8 @@ public:
   ue_bearer_tunnel_list*         find_rnti_tunnels(uint16_t rnti);
   srsran::span<bearer_teid_pair> find_rnti_bearer_tunnels(uint16_t rnti, uint32_t eps_bearer_id);
 
-  const tunnel* add_tunnel(uint16_t rnti, uint32_t eps_bearer_id, uint32_t teidout, uint32_t spgw_addr);
+  const tunnel*
+  add_tunnel(uint16_t rnti, uint32_t eps_bearer_id, uint32_t teidout, uint32_t spgw_addr, uint32_t pdcp_sn_len = 0);
   bool          update_rnti(uint16_t old_rnti, uint16_t new_rnti);
 
   void activate_tunnel(uint32_t teid);
@@ -228,7 +294,12 @@ private:
   // Socket file descriptor
   int fd = -1;
 
+  // Maximum number of PDUs sent with a single sendmmsg() when forwarding buffered PDUs
+  static const uint32_t TX_BATCH_SIZE = 32;
+
   void send_pdu_to_tunnel(const gtpu_tunnel& tx_tun, srsran::unique_byte_buffer_t pdu, int pdcp_sn = -1);
+  bool write_tunnel_header(const gtpu_tunnel& tx_tun, srsran::byte_buffer_t* pdu, int pdcp_sn);
+  void send_pdus_to_tunnel(const gtpu_tunnel& tx_tun, std::map<uint32_t, srsran::unique_byte_buffer_t>& pdus);
 
   void echo_response(in_addr_t addr, in_port_t port, uint16_t seq);
   void error_indication(in_addr_t addr, in_port_t port, uint32_t err_teid);
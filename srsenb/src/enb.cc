@@ -25,12 +25,21 @@
 #include "srsenb/src/enb_cfg_parser.h"
 #include "srsgnb/hdr/stack/gnb_stack_nr.h"
 #include "srsran/build_info.h"
+#include "srsran/common/cpu_topology.h"
+#include "srsran/common/threads.h"
 #include "srsran/common/enb_events.h"
 #include "srsran/radio/radio_null.h"
+#include <chrono>
 #include <iostream>
 
 namespace srsenb {
 
+/// Milliseconds elapsed since t, used to report the duration of each startup phase
+static uint32_t elapsed_ms(std::chrono::steady_clock::time_point t)
+{
+  return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - t).count();
+}
+
 enb::enb(srslog::sink& log_sink) :
   started(false), log_sink(log_sink), enb_log(srslog::fetch_basic_logger("ENB", log_sink, false)), sys_proc(enb_log)
 {
@@ -46,7 +55,8 @@ enb::~enb()
 
 int enb::init(const all_args_t& args_)
 {
-  int ret = SRSRAN_SUCCESS;
+  int  ret     = SRSRAN_SUCCESS;
+  auto t_start = std::chrono::steady_clock::now();
 
   // Init eNB log
   enb_log.set_level(srslog::basic_levels::info);
@@ -58,7 +68,13 @@ int enb::init(const all_args_t& args_)
     return SRSRAN_ERROR;
   }
 
+  // Pin the real-time threads before the stacks, radio and PHY start any thread
+  if (args.phy.rt_cpu_placement) {
+    place_rt_threads();
+  }
+
   srsran::byte_buffer_pool::get_instance()->enable_logger(true);
+  metrics_clock.set_period(args.phy.metrics_period_ms);
 
   // Create layers
   std::unique_ptr<enb_stack_lte> tmp_eutra_stack;
@@ -100,32 +116,40 @@ int enb::init(const all_args_t& args_)
   }
 
   // initialize layers, if they exist
+  auto t_phase = std::chrono::steady_clock::now();
   if (tmp_eutra_stack) {
     if (tmp_eutra_stack->init(args.stack, rrc_cfg, tmp_phy.get(), x2.get()) != SRSRAN_SUCCESS) {
       srsran::console("Error initializing EUTRA stack.\n");
       ret = SRSRAN_ERROR;
     }
+    enb_log.info("Startup: EUTRA stack initialised in %u ms", elapsed_ms(t_phase));
   }
 
+  t_phase = std::chrono::steady_clock::now();
   if (tmp_nr_stack) {
     if (tmp_nr_stack->init(args.nr_stack, rrc_nr_cfg, tmp_phy.get(), x2.get()) != SRSRAN_SUCCESS) {
       srsran::console("Error initializing NR stack.\n");
       ret = SRSRAN_ERROR;
     }
+    enb_log.info("Startup: NR stack initialised in %u ms", elapsed_ms(t_phase));
   }
 
   // Init Radio
+  t_phase = std::chrono::steady_clock::now();
   if (tmp_radio->init(args.rf, tmp_phy.get())) {
     srsran::console("Error initializing radio.\n");
     return SRSRAN_ERROR;
   }
+  enb_log.info("Startup: radio initialised in %u ms", elapsed_ms(t_phase));
 
   // Only Init PHY if radio could be initialized
   if (ret == SRSRAN_SUCCESS) {
+    t_phase = std::chrono::steady_clock::now();
     if (tmp_phy->init(args.phy, phy_cfg, tmp_radio.get(), tmp_eutra_stack.get(), *tmp_nr_stack, this)) {
       srsran::console("Error initializing PHY.\n");
       ret = SRSRAN_ERROR;
     }
+    enb_log.info("Startup: PHY initialised in %u ms", elapsed_ms(t_phase));
   }
 
   if (tmp_eutra_stack) {
@@ -146,6 +170,7 @@ int enb::init(const all_args_t& args_)
   }
 
   if (ret == SRSRAN_SUCCESS) {
+    enb_log.info("Startup: eNodeB started in %u ms", elapsed_ms(t_start));
     srsran::console("\n==== eNodeB started ===\n");
     srsran::console("Type <t> to view trace\n");
   } else {
@@ -198,6 +223,46 @@ int enb::parse_args(const all_args_t& args_, rrc_cfg_t& rrc_cfg_, rrc_nr_cfg_t&
   return enb_conf_sections::parse_cfg_files(&args, &rrc_cfg_, &rrc_cfg_nr_, &phy_cfg);
 }
 
+/// Reserves a physical core for the radio thread, each LTE PHY worker and, if there are NR cells, each NR PHY worker.
+/// The calling thread is restricted to the remaining cores, so that every thread created from now on (stack, gateway)
+/// inherits that affinity.
+void enb::place_rt_threads()
+{
+  srsran::cpu_placement placement(srsran::cpu_topology::from_sysfs());
+  if (placement.topology().empty()) {
+    srsran::console("Warning: Could not read the CPU topology. Real-time threads will not be pinned.\n");
+    return;
+  }
+
+  args.phy.txrx_cpu = placement.reserve_rt_cpu("txrx");
+  // Keep the workers on the NUMA node of the radio thread, as they exchange the baseband buffers
+  int node = args.phy.txrx_cpu < 0 ? -1 : placement.get_numa_node(args.phy.txrx_cpu);
+  for (uint32_t i = 0; i < args.phy.nof_phy_threads; ++i) {
+    int cpu = placement.reserve_rt_cpu(fmt::format("PHY{}", i), node);
+    if (cpu < 0) {
+      srsran::console("Warning: Not enough physical cores to pin all PHY workers.\n");
+      args.phy.worker_cpus.clear();
+      break;
+    }
+    args.phy.worker_cpus.push_back(cpu);
+  }
+  if (not rrc_nr_cfg.cell_list.empty()) {
+    for (uint32_t i = 0; i < args.phy.nof_phy_threads; ++i) {
+      int cpu = placement.reserve_rt_cpu(fmt::format("NR-PHY{}", i), node);
+      if (cpu < 0) {
+        srsran::console("Warning: Not enough physical cores to pin all NR PHY workers.\n");
+        args.phy.nr_worker_cpus.clear();
+        break;
+      }
+      args.phy.nr_worker_cpus.push_back(cpu);
+    }
+  }
+
+  std::vector<uint32_t> shared_cpus = placement.get_shared_cpus();
+  threads_set_affinity(pthread_self(), shared_cpus.data(), shared_cpus.size());
+  srsran::console("{}", placement.to_string());
+}
+
 void enb::start_plot()
 {
   phy->start_plot();
@@ -230,12 +295,24 @@ bool enb::get_metrics(enb_metrics_t* m)
     return false;
   }
   radio->get_metrics(&m->rf);
-  phy->get_metrics(m->phy);
+
+  // PHY and MAC metrics are paired by UE, so they always come from the same period. Until all the layers have
+  // published the last period, the previous one is reported again
+  uint64_t period   = metrics_clock.last_closed();
+  bool     complete = phy->get_metrics(m->phy, period);
   if (eutra_stack) {
-    eutra_stack->get_metrics(&m->stack);
+    complete = eutra_stack->get_metrics(&m->stack, period) and complete;
+  }
+  if (complete) {
+    last_phy_metrics   = m->phy;
+    last_stack_metrics = m->stack;
+  } else {
+    m->phy   = last_phy_metrics;
+    m->stack = last_stack_metrics;
   }
   if (nr_stack) {
-    nr_stack->get_metrics(&m->nr_stack);
+    nr_stack->get_metrics(&m->nr_stack, period);
+    phy->get_nr_metrics(m->nr_phy);
   }
   m->running = true;
   m->sys     = sys_proc.get_metrics();
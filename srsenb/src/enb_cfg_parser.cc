@@ -1872,6 +1872,13 @@ int set_derived_args(all_args_t* args_, rrc_cfg_t* rrc_cfg_, phy_cfg_t* phy_cfg_
                    args_->stack.mac.nof_prealloc_ues,
                    SRSENB_MAX_UES);
 
+  // Shared UL soft-buffers only keep 8-bit soft bits if the PUSCH decoder works with them
+  args_->stack.mac.softbuffer_pool_8bit = args_->phy.pusch_8bit_decoder;
+
+  // Every layer closes its metrics periods on the period of the metrics thread
+  args_->phy.metrics_period_ms       = (uint32_t)(args_->general.metrics_period_secs * 1000);
+  args_->stack.mac.metrics_period_ms = args_->phy.metrics_period_ms;
+
   // Check for a forced  DL EARFCN or frequency (only valid for a single cell config
   if (rrc_cfg_->cell_list.size() > 0) {
     if (rrc_cfg_->cell_list.size() == 1) {
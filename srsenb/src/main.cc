@@ -251,10 +251,16 @@ void parse_args(all_args_t* args, int argc, char* argv[])
     ("expert.metrics_csv_enable",  bpo::value<bool>(&args->general.metrics_csv_enable)->default_value(false), "Write metrics to CSV file.")
     ("expert.metrics_csv_filename", bpo::value<string>(&args->general.metrics_csv_filename)->default_value("/tmp/enb_metrics.csv"), "Metrics CSV filename.")
     ("expert.pusch_max_its", bpo::value<uint32_t>(&args->phy.pusch_max_its)->default_value(8), "Maximum number of turbo decoder iterations for LTE.")
+    ("expert.pusch_budget_us", bpo::value<uint32_t>(&args->phy.pusch_budget_us)->default_value(0), "PUSCH decoding time budget per TTI in microseconds. Exceeding it degrades the decoding of the remaining grants (0 to disable).")
+    ("expert.pusch_overload_its", bpo::value<uint32_t>(&args->phy.pusch_overload_its)->default_value(4), "Maximum number of decoder iterations once pusch_overload_pct of the PUSCH decoding budget is used.")
+    ("expert.pusch_overload_pct", bpo::value<uint32_t>(&args->phy.pusch_overload_pct)->default_value(50), "Share of the PUSCH decoding budget, in percent, past which the decoder iterations are reduced.")
     ("expert.pusch_8bit_decoder", bpo::value<bool>(&args->phy.pusch_8bit_decoder)->default_value(false), "Use 8-bit for LLR representation and turbo decoder trellis computation (Experimental).")
+    ("expert.pusch_seq_cache_kb", bpo::value<uint32_t>(&args->phy.pusch_seq_cache_kb)->default_value(0), "Memory in kB of the PUSCH scrambling sequences kept by each PHY worker and carrier (0 to disable).")
     ("expert.pusch_meas_evm", bpo::value<bool>(&args->phy.pusch_meas_evm)->default_value(false), "Enable/Disable PUSCH EVM measure.")
     ("expert.tx_amplitude", bpo::value<float>(&args->phy.tx_amplitude)->default_value(0.6), "Transmit amplitude factor.")
     ("expert.nof_phy_threads", bpo::value<uint32_t>(&args->phy.nof_phy_threads)->default_value(3), "Number of PHY threads.")
+    ("expert.nof_phy_cc_threads", bpo::value<uint32_t>(&args->phy.nof_phy_cc_threads)->default_value(0), "Number of threads shared by the PHY workers to process the carriers of a TTI in parallel (0 for serial processing).")
+    ("expert.rt_cpu_placement", bpo::value<bool>(&args->phy.rt_cpu_placement)->default_value(false), "Pin real-time threads to dedicated physical cores based on the CPU topology.")
     ("expert.nof_prach_threads", bpo::value<uint32_t>(&args->phy.nof_prach_threads)->default_value(1), "Number of PRACH workers per carrier. Only 1 or 0 is supported.")
     ("expert.max_prach_offset_us", bpo::value<float>(&args->phy.max_prach_offset_us)->default_value(30), "Maximum allowed RACH offset (in us).")
     ("expert.equalizer_mode", bpo::value<string>(&args->phy.equalizer_mode)->default_value("mmse"), "Equalizer mode.")
@@ -275,6 +281,7 @@ void parse_args(all_args_t* args, int argc, char* argv[])
     ("expert.eia_pref_list", bpo::value<string>(&args->general.eia_pref_list)->default_value("EIA2, EIA1, EIA0"), "Ordered preference list for the selection of integrity algorithm (EIA) (default: EIA2, EIA1, EIA0).")
     ("expert.nof_prealloc_ues", bpo::value<uint32_t>(&args->stack.mac.nof_prealloc_ues)->default_value(8), "Number of UE resources to preallocate during eNB initialization.")
     ("expert.lcid_padding", bpo::value<int>(&args->stack.mac.lcid_padding)->default_value(3), "LCID on which to put MAC padding")
+    ("expert.softbuffer_pool_max_cb", bpo::value<uint32_t>(&args->stack.mac.softbuffer_pool_max_cb)->default_value(0), "Maximum number of UL soft-buffer code blocks shared by all UEs (0 for per HARQ process allocation).")
     ("expert.max_mac_dl_kos", bpo::value<uint32_t>(&args->general.max_mac_dl_kos)->default_value(100), "Maximum number of consecutive KOs in DL before triggering the UE's release (default 100).")
     ("expert.max_mac_ul_kos", bpo::value<uint32_t>(&args->general.max_mac_ul_kos)->default_value(100), "Maximum number of consecutive KOs in UL before triggering the UE's release (default 100).")
     ("expert.gtpu_tunnel_timeout", bpo::value<uint32_t>(&args->stack.gtpu_indirect_tunnel_timeout_msec)->default_value(0), "Maximum time that GTPU takes to release indirect forwarding tunnel since the last received GTPU PDU (0 for infinity).")
@@ -303,6 +310,7 @@ void parse_args(all_args_t* args, int argc, char* argv[])
     ("scheduler.nr_pdsch_mcs", bpo::value<int>(&args->nr_stack.mac.sched_cfg.fixed_dl_mcs)->default_value(28), "Fixed NR DL MCS (-1 for dynamic).")
     ("scheduler.nr_pusch_mcs", bpo::value<int>(&args->nr_stack.mac.sched_cfg.fixed_ul_mcs)->default_value(28), "Fixed NR UL MCS (-1 for dynamic).")
     ("expert.nr_pusch_max_its", bpo::value<uint32_t>(&args->phy.nr_pusch_max_its)->default_value(10),     "Maximum number of LDPC iterations for NR.")
+    ("expert.nr_pdsch_coworkers", bpo::value<uint32_t>(&args->phy.nr_pdsch_coworkers)->default_value(0),   "Number of threads helping each NR PHY worker to encode the code blocks of a PDSCH transport block (0 for serial encoding).")
   ;
 
   // Positional options - config file location
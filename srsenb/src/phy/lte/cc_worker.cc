@@ -127,6 +127,14 @@ void cc_worker::init(phy_common* phy_, uint32_t cc_idx_)
     return;
   }
 
+  // The pregenerated DMRS only depend on the cell, all the workers of the cell use the same table
+  dmrs_pregen = phy->ul_dmrs_tables.get(cell, phy->dmrs_pusch_cfg);
+  if (dmrs_pregen == nullptr) {
+    ERROR("Error generating the PUSCH DMRS");
+    return;
+  }
+  srsran_enb_ul_set_dmrs_pregen(&enb_ul, dmrs_pregen->get());
+
   if (srsran_enb_ul_set_cell(&enb_ul, cell, &phy->dmrs_pusch_cfg, nullptr)) {
     ERROR("Error initiating ENB UL");
     return;
@@ -156,6 +164,12 @@ void cc_worker::init(phy_common* phy_, uint32_t cc_idx_)
     enb_ul.pusch.llr_is_8bit        = true;
     enb_ul.pusch.ul_sch.llr_is_8bit = true;
   }
+
+  if (not pusch_scrambling.init(
+          phy->params.pusch_seq_cache_kb * 1024, cell.id, nof_prb, phy->params.pusch_8bit_decoder)) {
+    ERROR("Error allocating the PUSCH scrambling cache");
+    return;
+  }
   initiated = true;
 
 #ifdef DEBUG_WRITE_FILE
@@ -167,6 +181,7 @@ void cc_worker::reset()
 {
   initiated = false;
   ue_db.clear();
+  pusch_scrambling.clear();
 }
 
 cf_t* cc_worker::get_buffer_rx(uint32_t antenna_idx)
@@ -201,6 +216,7 @@ void cc_worker::rem_rnti(uint16_t rnti)
 {
   std::lock_guard<std::mutex> lock(mutex);
   if (ue_db.count(rnti)) {
+    pusch_scrambling.release(ue_db[rnti]->scrambling_slots);
     delete ue_db[rnti];
     ue_db.erase(rnti);
   }
@@ -212,7 +228,9 @@ uint32_t cc_worker::get_nof_rnti()
   return ue_db.size();
 }
 
-void cc_worker::work_ul(const srsran_ul_sf_cfg_t& ul_sf_cfg, stack_interface_phy_lte::ul_sched_t& ul_grants)
+void cc_worker::work_ul(const srsran_ul_sf_cfg_t&           ul_sf_cfg,
+                        stack_interface_phy_lte::ul_sched_t& ul_grants,
+                        const pusch_overload_ctrl&           overload_ctrl)
 {
   std::lock_guard<std::mutex> lock(mutex);
   ul_sf = ul_sf_cfg;
@@ -222,7 +240,7 @@ void cc_worker::work_ul(const srsran_ul_sf_cfg_t& ul_sf_cfg, stack_interface_phy
   srsran_enb_ul_fft(&enb_ul);
 
   // Decode pending UL grants for the tti they were scheduled
-  decode_pusch(ul_grants.pusch, ul_grants.nof_grants);
+  decode_pusch(ul_grants.pusch, ul_grants.nof_grants, overload_ctrl);
 
   // Decode remaining PUCCH ACKs not associated with PUSCH transmission and SR signals
   decode_pucch();
@@ -285,7 +303,8 @@ void cc_worker::work_dl(const srsran_dl_sf_cfg_t&            dl_sf_cfg,
 
 bool cc_worker::decode_pusch_rnti(stack_interface_phy_lte::ul_sched_grant_t& ul_grant,
                                   srsran_ul_cfg_t&                           ul_cfg,
-                                  srsran_pusch_res_t&                        pusch_res)
+                                  srsran_pusch_res_t&                        pusch_res,
+                                  const pusch_overload_ctrl&                 overload_ctrl)
 {
   uint16_t rnti = ul_grant.dci.rnti;
 
@@ -338,6 +357,22 @@ bool cc_worker::decode_pusch_rnti(stack_interface_phy_lte::ul_sched_grant_t& ul_
     Error("Error setting last UL TB for RNTI %x, CC %d, PID %d", rnti, cc_idx, ul_grant.pid);
   }
 
+  // Degrade the decoding if the TTI is running out of time
+  pusch_overload_ctrl::action_t overload_action = pusch_overload_ctrl::action_t::decode;
+  if (ul_grant.data != nullptr) {
+    overload_action = overload_ctrl.get_action();
+    if (overload_action == pusch_overload_ctrl::action_t::reduce_iterations) {
+      ul_cfg.pusch.max_nof_iterations =
+          SRSRAN_MIN(ul_cfg.pusch.max_nof_iterations, overload_ctrl.get_reduced_max_its());
+    } else if (overload_action == pusch_overload_ctrl::action_t::skip_data) {
+      ul_cfg.pusch.uci_only = true;
+    }
+  }
+
+  // Descramble with the sequence cached for the UE, it is generated here on the first grant of the subframe
+  ul_cfg.pusch.scrambling = pusch_scrambling.get(
+      ue_db[rnti]->scrambling_slots, rnti, ul_sf.tti % SRSRAN_NOF_SF_X_FRAME, grant.tb.nof_bits);
+
   // Run PUSCH decoder
   ul_cfg.pusch.softbuffers.rx = ul_grant.softbuffer_rx;
   pusch_res.data              = ul_grant.data;
@@ -376,11 +411,14 @@ bool cc_worker::decode_pusch_rnti(stack_interface_phy_lte::ul_sched_grant_t& ul_
                             enb_ul.chest_res.epre_dBfs - phy->params.rx_gain_offset,
                             enb_ul.chest_res.snr_db,
                             pusch_res.avg_iterations_block);
+    ue_db[rnti]->metrics_ul_overload(overload_action);
   }
   return true;
 }
 
-void cc_worker::decode_pusch(stack_interface_phy_lte::ul_sched_grant_t* grants, uint32_t nof_pusch)
+void cc_worker::decode_pusch(stack_interface_phy_lte::ul_sched_grant_t* grants,
+                             uint32_t                                   nof_pusch,
+                             const pusch_overload_ctrl&                 overload_ctrl)
 {
   // Iterate over all the grants, all the grants need to report MAC the CRC status
   for (uint32_t i = 0; i < nof_pusch; i++) {
@@ -392,7 +430,7 @@ void cc_worker::decode_pusch(stack_interface_phy_lte::ul_sched_grant_t* grants,
     srsran_ul_cfg_t    ul_cfg    = {};
 
     // Decodes PUSCH for the given grant
-    if (!decode_pusch_rnti(ul_grant, ul_cfg, pusch_res)) {
+    if (!decode_pusch_rnti(ul_grant, ul_cfg, pusch_res, overload_ctrl)) {
       return;
     }
 
@@ -666,6 +704,19 @@ uint32_t cc_worker::get_metrics(std::vector<phy_metrics_t>& metrics)
   return cnt;
 }
 
+void cc_worker::get_mem_usage(phy_mem_usage_t& usage)
+{
+  uint32_t sf_len = SRSRAN_SF_LEN_PRB(phy->get_nof_prb(cc_idx));
+  for (uint32_t p = 0; p < SRSRAN_MAX_PORTS; p++) {
+    usage.sample_buffers += (signal_buffer_rx[p] != nullptr ? 2 * sf_len * sizeof(cf_t) : 0);
+    usage.sample_buffers += (signal_buffer_tx[p] != nullptr ? 2 * sf_len * sizeof(cf_t) : 0);
+  }
+  usage.pusch_scrambling += pusch_scrambling.nof_bytes();
+  if (dmrs_pregen != nullptr) {
+    usage.shared_tables_refs += dmrs_pregen->nof_bytes();
+  }
+}
+
 void cc_worker::ue::metrics_read(phy_metrics_t* metrics_)
 {
   if (metrics_) {
@@ -703,6 +754,15 @@ void cc_worker::ue::metrics_ul_pucch(float rssi, float ni, float sinr)
   metrics.ul.n_samples_pucch++;
 }
 
+void cc_worker::ue::metrics_ul_overload(pusch_overload_ctrl::action_t action)
+{
+  if (action == pusch_overload_ctrl::action_t::reduce_iterations) {
+    metrics.ul.n_overload_reduced_its++;
+  } else if (action == pusch_overload_ctrl::action_t::skip_data) {
+    metrics.ul.n_overload_nacks++;
+  }
+}
+
 int cc_worker::read_ce_abs(float* ce_abs)
 {
   int sz = srsran_symbol_sz(phy->get_nof_prb(cc_idx));
@@ -0,0 +1,230 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsenb/hdr/phy/lte/pusch_scrambling_cache.h"
+#include "srsran/srsran.h"
+
+namespace srsenb {
+namespace lte {
+
+pusch_scrambling_cache::~pusch_scrambling_cache()
+{
+  for (slot_t& s : slots) {
+    free(s.c_packed);
+  }
+  free(c_char);
+  free(c_short);
+}
+
+bool pusch_scrambling_cache::init(uint32_t budget_bytes, uint32_t cell_id_, uint32_t nof_prb, bool llr_is_8bit)
+{
+  cell_id = cell_id_;
+
+  // Largest PUSCH transmission of the cell, all PRB with 64QAM and no SRS, and smallest one, one PRB with QPSK
+  uint32_t prb_re   = SRSRAN_NRE * 2 * (SRSRAN_CP_NORM_NSYMB - 1);
+  max_bits          = nof_prb * prb_re * srsran_mod_bits_x_symbol(SRSRAN_MOD_64QAM);
+  uint32_t min_bits = prb_re * srsran_mod_bits_x_symbol(SRSRAN_MOD_QPSK);
+
+  // Size classes, each one a fraction of the previous one, down to the smallest grant
+  classes.clear();
+  for (uint32_t cls_bits = max_bits; cls_bits >= min_bits and classes.size() < MAX_CLASSES; cls_bits /= CLASS_FACTOR) {
+    classes.emplace_back();
+    classes.back().max_bits = cls_bits;
+  }
+  if (classes.empty() and max_bits > 0) {
+    classes.emplace_back();
+    classes.back().max_bits = max_bits;
+  }
+
+  // Every class takes an equal share of the budget
+  uint32_t nof_slots = 0;
+  for (class_t& c : classes) {
+    c.first_slot = nof_slots;
+    c.nof_slots  = budget_bytes / classes.size() / SRSRAN_CEIL(c.max_bits, 8);
+    nof_slots += c.nof_slots;
+  }
+
+  slots.resize(nof_slots);
+  for (uint32_t cls = 0; cls < classes.size(); cls++) {
+    class_t& c = classes[cls];
+    c.free_slots.reserve(c.nof_slots);
+    for (uint32_t i = 0; i < c.nof_slots; i++) {
+      slot_t& s = slots[c.first_slot + i];
+      s.cls     = cls;
+      s.c_packed = srsran_vec_u8_malloc(SRSRAN_CEIL(c.max_bits, 8));
+      if (s.c_packed == nullptr) {
+        return false;
+      }
+      c.free_slots.push_back(c.first_slot + c.nof_slots - 1 - i);
+    }
+  }
+
+  // Sequences are unpacked for the descrambling, up to the largest grant
+  if (nof_slots > 0) {
+    c_char = srsran_vec_i8_malloc(max_bits);
+    if (c_char == nullptr) {
+      return false;
+    }
+    scratch_bytes = max_bits * sizeof(int8_t);
+    if (not llr_is_8bit) {
+      c_short = srsran_vec_i16_malloc(max_bits);
+      if (c_short == nullptr) {
+        return false;
+      }
+      scratch_bytes += max_bits * sizeof(int16_t);
+    }
+  }
+  return true;
+}
+
+uint32_t pusch_scrambling_cache::nof_free_slots() const
+{
+  uint32_t nof_free = 0;
+  for (const class_t& c : classes) {
+    nof_free += c.free_slots.size();
+  }
+  return nof_free;
+}
+
+uint64_t pusch_scrambling_cache::nof_bytes() const
+{
+  uint64_t bytes = scratch_bytes;
+  for (const class_t& c : classes) {
+    bytes += (uint64_t)c.nof_slots * SRSRAN_CEIL(c.max_bits, 8);
+  }
+  return bytes;
+}
+
+int32_t pusch_scrambling_cache::alloc_slot(uint32_t nof_bits)
+{
+  // Smallest class fitting the grant, classes go from the largest slots to the smallest
+  int32_t fit = -1;
+  for (uint32_t cls = 0; cls < classes.size() and classes[cls].max_bits >= nof_bits; cls++) {
+    fit = cls;
+  }
+
+  // A free slot of that class, or of a larger one
+  for (int32_t cls = fit; cls >= 0; cls--) {
+    std::vector<uint32_t>& free_slots = classes[cls].free_slots;
+    if (not free_slots.empty()) {
+      int32_t idx = free_slots.back();
+      free_slots.pop_back();
+      return idx;
+    }
+  }
+
+  // Take a slot back from its UE, in the smallest class fitting the grant that has slots. A slot used since the last
+  // time the victim pointer went over it is skipped and the grant is not cached, so that the slots are not taken back
+  // on every grant when the UEs do not fit
+  for (int32_t cls = fit; cls >= 0; cls--) {
+    class_t& c = classes[cls];
+    if (c.nof_slots == 0) {
+      continue;
+    }
+    int32_t idx   = c.first_slot + c.next_victim;
+    c.next_victim = (c.next_victim + 1) % c.nof_slots;
+    if (slots[idx].used) {
+      slots[idx].used = false;
+      return -1;
+    }
+    if (slots[idx].owner != nullptr) {
+      *slots[idx].owner = -1;
+    }
+    return idx;
+  }
+  return -1;
+}
+
+void pusch_scrambling_cache::free_slot(int32_t idx)
+{
+  slots[idx].owner = nullptr;
+  slots[idx].len   = 0;
+  slots[idx].used  = false;
+  classes[slots[idx].cls].free_slots.push_back(idx);
+}
+
+srsran_pusch_scrambling_t
+pusch_scrambling_cache::get(ue_slots_t& ue_slots, uint16_t rnti, uint32_t sf_idx, uint32_t nof_bits)
+{
+  srsran_pusch_scrambling_t seq = {};
+  if (sf_idx >= SRSRAN_NOF_SF_X_FRAME or nof_bits > max_bits) {
+    return seq;
+  }
+
+  // Move the sequence to a larger slot if the grant does not fit, it is generated again from the start
+  int32_t idx = ue_slots[sf_idx];
+  if (idx >= 0 and classes[slots[idx].cls].max_bits < nof_bits) {
+    free_slot(idx);
+    ue_slots[sf_idx] = -1;
+    idx              = -1;
+  }
+
+  if (idx < 0) {
+    idx = alloc_slot(nof_bits);
+    if (idx < 0) {
+      return seq;
+    }
+    slots[idx].owner = &ue_slots[sf_idx];
+    slots[idx].len   = 0;
+    ue_slots[sf_idx] = idx;
+  }
+
+  // Generate the sequence on the first use of the slot, or again for a longer grant
+  slot_t& s = slots[idx];
+  s.used    = true;
+  if (s.len < nof_bits) {
+    srsran_pusch_scrambling_gen(s.c_packed, rnti, sf_idx, cell_id, nof_bits);
+    s.len = nof_bits;
+  }
+
+  srsran_pusch_scrambling_unpack(s.c_packed, c_char, c_short, nof_bits);
+  seq.c_char  = c_char;
+  seq.c_short = c_short;
+  seq.len     = nof_bits;
+  return seq;
+}
+
+void pusch_scrambling_cache::release(ue_slots_t& ue_slots)
+{
+  for (int32_t& idx : ue_slots) {
+    if (idx >= 0) {
+      free_slot(idx);
+      idx = -1;
+    }
+  }
+}
+
+void pusch_scrambling_cache::clear()
+{
+  for (class_t& c : classes) {
+    c.free_slots.clear();
+    for (uint32_t i = 0; i < c.nof_slots; i++) {
+      slots[c.first_slot + i].owner = nullptr;
+      slots[c.first_slot + i].len   = 0;
+      slots[c.first_slot + i].used  = false;
+      c.free_slots.push_back(c.first_slot + c.nof_slots - 1 - i);
+    }
+    c.next_victim = 0;
+  }
+}
+
+} // namespace lte
+} // namespace srsenb
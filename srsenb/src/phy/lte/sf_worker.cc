@@ -72,9 +72,11 @@ namespace lte {
 FILE* f;
 #endif
 
-void sf_worker::init(phy_common* phy_)
+void sf_worker::init(phy_common* phy_, srsran::task_thread_pool* cc_pool)
 {
   phy = phy_;
+  cc_runner.set_pool(cc_pool);
+  overload_ctrl.init(phy->params.pusch_budget_us, phy->params.pusch_overload_its, phy->params.pusch_overload_pct);
 
   // Initialise each component carrier workers
   for (uint32_t i = 0; i < phy->get_nof_carriers_lte(); i++) {
@@ -149,7 +151,18 @@ uint32_t sf_worker::get_nof_rnti()
 
 void sf_worker::work_imp()
 {
-  std::lock_guard<std::mutex> lock(work_mutex);
+  std::lock_guard<std::mutex>  lock(work_mutex);
+  srsran::tti_arena_scope      arena_scope(tti_arena);
+  srsran::rt_alloc_check_scope alloc_scope(alloc_checker);
+
+  // The metrics thread only reads what the worker publishes, so the metrics period is closed from here
+  if (period_metrics.closes(phy->metrics_clock.current())) {
+    publish_metrics();
+  }
+  if (metrics_only) {
+    metrics_only = false;
+    return;
+  }
 
   srsran_ul_sf_cfg_t ul_sf = {};
   srsran_dl_sf_cfg_t dl_sf = {};
@@ -163,6 +176,9 @@ void sf_worker::work_imp()
     return;
   }
 
+  // The PUSCH decoding budget counts from here
+  overload_ctrl.start_tti();
+
   srsran_mbsfn_cfg_t mbsfn_cfg;
   srsran_sf_t        sf_type = phy->is_mbsfn_sf(&mbsfn_cfg, tti_tx_dl) ? SRSRAN_SF_MBSFN : SRSRAN_SF_NORM;
 
@@ -188,10 +204,11 @@ void sf_worker::work_imp()
     Info("Failed setting UL grants. Some grant's RNTI does not exist.");
   }
 
-  // Process UL
-  for (uint32_t cc = 0; cc < cc_workers.size(); cc++) {
-    cc_workers[cc]->work_ul(ul_sf, ul_grants[cc]);
-  }
+  // Process UL. All carriers must be done before getting the DL scheduling, as it depends on the UL feedback
+  auto work_ul_cc = [this, &ul_sf, &ul_grants](uint32_t cc) {
+    cc_workers[cc]->work_ul(ul_sf, ul_grants[cc], overload_ctrl);
+  };
+  cc_runner.run(cc_workers.size(), work_ul_cc);
 
   // Get DL scheduling for the TX TTI from MAC
   if (sf_type == SRSRAN_SF_NORM) {
@@ -225,14 +242,16 @@ void sf_worker::work_imp()
   phy->ue_db.clear_tti_pending_ack(tti_tx_ul);
 
   // Process DL
-  for (uint32_t cc = 0; cc < cc_workers.size(); cc++) {
+  auto work_dl_cc = [this, &dl_sf, &dl_grants, &ul_grants_tx, &mbsfn_cfg](uint32_t cc) {
     // Select CFI and make sure it is in the right range
-    dl_sf.cfi = dl_grants[cc].cfi;
-    dl_sf.cfi = SRSRAN_MAX(dl_sf.cfi, 1);
-    dl_sf.cfi = SRSRAN_MIN(dl_sf.cfi, 3);
+    srsran_dl_sf_cfg_t dl_sf_cc = dl_sf;
+    dl_sf_cc.cfi                = dl_grants[cc].cfi;
+    dl_sf_cc.cfi                = SRSRAN_MAX(dl_sf_cc.cfi, 1);
+    dl_sf_cc.cfi                = SRSRAN_MIN(dl_sf_cc.cfi, 3);
 
-    cc_workers[cc]->work_dl(dl_sf, dl_grants[cc], ul_grants_tx[cc], &mbsfn_cfg);
-  }
+    cc_workers[cc]->work_dl(dl_sf_cc, dl_grants[cc], ul_grants_tx[cc], &mbsfn_cfg);
+  };
+  cc_runner.run(cc_workers.size(), work_dl_cc);
 
   // Save grants
   phy->set_ul_grants(tti_tx_ul, ul_grants_tx);
@@ -267,16 +286,23 @@ void sf_worker::work_imp()
 }
 
 /************ METRICS interface ********************/
-uint32_t sf_worker::get_metrics(std::vector<phy_metrics_t>& metrics)
+void sf_worker::get_mem_usage(phy_mem_usage_t& usage)
+{
+  for (auto& q : cc_workers) {
+    q->get_mem_usage(usage);
+  }
+}
+
+void sf_worker::publish_metrics()
 {
-  uint32_t                   cnt = 0;
-  std::vector<phy_metrics_t> metrics_;
+  std::vector<phy_metrics_t>& metrics = period_metrics.write_buffer();
+  metrics.clear();
   for (uint32_t cc = 0; cc < phy->get_nof_carriers_lte(); cc++) {
-    cnt = cc_workers[cc]->get_metrics(metrics_);
-    metrics.resize(std::max(metrics_.size(), metrics.size()));
+    uint32_t cnt = cc_workers[cc]->get_metrics(cc_metrics);
+    metrics.resize(std::max(cc_metrics.size(), metrics.size()));
     for (uint32_t r = 0; r < cnt; r++) {
       phy_metrics_t* m  = &metrics[r];
-      phy_metrics_t* m_ = &metrics_[r];
+      phy_metrics_t* m_ = &cc_metrics[r];
       m->dl.mcs         = SRSRAN_VEC_SAFE_PMA(m->dl.mcs, m->dl.n_samples, m_->dl.mcs, m_->dl.n_samples);
       m->dl.n_samples += m_->dl.n_samples;
       m->ul.n          = SRSRAN_VEC_SAFE_PMA(m->ul.n, m->ul.n_samples, m_->ul.n, m_->ul.n_samples);
@@ -292,9 +318,11 @@ uint32_t sf_worker::get_metrics(std::vector<phy_metrics_t>& metrics)
       m->ul.turbo_iters = SRSRAN_VEC_SAFE_PMA(m->ul.turbo_iters, m->ul.n_samples, m_->ul.turbo_iters, m_->ul.n_samples);
       m->ul.n_samples += m_->ul.n_samples;
       m->ul.n_samples_pucch += m_->ul.n_samples_pucch;
+      m->ul.n_overload_reduced_its += m_->ul.n_overload_reduced_its;
+      m->ul.n_overload_nacks += m_->ul.n_overload_nacks;
     }
   }
-  return cnt;
+  period_metrics.publish();
 }
 
 void sf_worker::start_plot()
@@ -0,0 +1,113 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsenb/hdr/phy/lte/ul_dmrs_tables.h"
+
+namespace srsenb {
+namespace lte {
+
+ul_dmrs_pregen::~ul_dmrs_pregen()
+{
+  srsran_refsignal_dmrs_pusch_pregen_free(&signal, &pregen);
+}
+
+bool ul_dmrs_pregen::init(const srsran_cell_t& cell, const srsran_refsignal_dmrs_pusch_cfg_t& cfg)
+{
+  if (srsran_refsignal_ul_set_cell(&signal, cell) < SRSRAN_SUCCESS) {
+    return false;
+  }
+  if (srsran_refsignal_dmrs_pusch_pregen_init(&pregen, cell.nof_prb) < SRSRAN_SUCCESS) {
+    return false;
+  }
+  srsran_refsignal_dmrs_pusch_cfg_t dmrs_cfg = cfg;
+  return srsran_refsignal_dmrs_pusch_pregen(&signal, &pregen, &dmrs_cfg) == SRSRAN_SUCCESS;
+}
+
+/// The table only depends on the cell identity, bandwidth and cyclic prefix, and on the DMRS configuration
+static bool same_config(const srsran_cell_t&                     c1,
+                        const srsran_refsignal_dmrs_pusch_cfg_t& cfg1,
+                        const srsran_cell_t&                     c2,
+                        const srsran_refsignal_dmrs_pusch_cfg_t& cfg2)
+{
+  return c1.id == c2.id and c1.nof_prb == c2.nof_prb and c1.cp == c2.cp and cfg1.cyclic_shift == cfg2.cyclic_shift and
+         cfg1.delta_ss == cfg2.delta_ss and cfg1.group_hopping_en == cfg2.group_hopping_en and
+         cfg1.sequence_hopping_en == cfg2.sequence_hopping_en;
+}
+
+std::shared_ptr<const ul_dmrs_pregen> ul_dmrs_tables::get(const srsran_cell_t&                     cell,
+                                                          const srsran_refsignal_dmrs_pusch_cfg_t& cfg)
+{
+  std::shared_ptr<table_slot> slot;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto it = entries.begin(); it != entries.end() and slot == nullptr;) {
+      std::shared_ptr<table_slot> s = it->slot.lock();
+      if (s == nullptr) {
+        // Released by its last user
+        it = entries.erase(it);
+        continue;
+      }
+      if (same_config(it->cell, it->cfg, cell, cfg)) {
+        slot = std::move(s);
+      }
+      ++it;
+    }
+    if (slot == nullptr) {
+      slot = std::make_shared<table_slot>();
+      entries.push_back({cell, cfg, slot});
+    }
+  }
+
+  // Users of the same configuration wait here for the first one to generate the table
+  std::call_once(slot->once, [&slot, &cell, &cfg]() { slot->ready = slot->table.init(cell, cfg); });
+  if (not slot->ready) {
+    return nullptr;
+  }
+  return std::shared_ptr<const ul_dmrs_pregen>(slot, &slot->table);
+}
+
+uint32_t ul_dmrs_tables::nof_tables()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  uint32_t                    count = 0;
+  for (const entry_t& e : entries) {
+    std::shared_ptr<table_slot> slot = e.slot.lock();
+    count += (slot != nullptr and slot->ready) ? 1 : 0;
+  }
+  return count;
+}
+
+uint64_t ul_dmrs_tables::nof_bytes()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  uint64_t                    bytes = 0;
+  for (const entry_t& e : entries) {
+    std::shared_ptr<table_slot> slot = e.slot.lock();
+    // Tables still being generated are not read
+    if (slot != nullptr and slot->ready) {
+      bytes += slot->table.nof_bytes();
+    }
+  }
+  return bytes;
+}
+
+} // namespace lte
+} // namespace srsenb
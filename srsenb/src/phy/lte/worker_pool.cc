@@ -19,6 +19,8 @@
  *
  */
 #include "srsenb/hdr/phy/lte/worker_pool.h"
+#include "srsran/common/cpu_topology.h"
+#include <thread>
 
 namespace srsenb {
 namespace lte {
@@ -27,17 +29,44 @@ worker_pool::worker_pool(uint32_t max_workers) : pool(max_workers) {}
 
 bool worker_pool::init(const phy_args_t& args, phy_common* common, srslog::sink& log_sink, int prio)
 {
-  // Add workers to workers pool and start threads.
+  // Carrier processing threads run with the same priority as the workers that hand them the carriers
+  if (args.nof_phy_cc_threads > 0) {
+    cc_pool.reset(new srsran::task_thread_pool(args.nof_phy_cc_threads, false, prio));
+  }
+
+  // Create the workers
   srslog::basic_levels log_level = srslog::str_to_basic_level(args.log.phy_level);
   for (uint32_t i = 0; i < args.nof_phy_threads; i++) {
     auto& log = srslog::fetch_basic_logger(fmt::format("PHY{}", i), log_sink);
     log.set_level(log_level);
     log.set_hex_dump_max_size(args.log.phy_hex_limit);
 
-    auto w = std::unique_ptr<lte::sf_worker>(new sf_worker(log));
-    w->init(common);
-    pool.init_worker(i, w.get(), prio);
-    workers.push_back(std::move(w));
+    workers.push_back(std::unique_ptr<lte::sf_worker>(new sf_worker(log)));
+  }
+
+  // Initialise the workers in parallel, the initialisation of a worker does not depend on the others
+  std::vector<std::thread> init_threads;
+  for (uint32_t i = 0; i < args.nof_phy_threads; i++) {
+    init_threads.emplace_back([this, &args, common, i]() {
+      // Initialise the worker from its own CPU, so that its buffers are first touched on the right NUMA node
+      std::vector<uint32_t> cpus;
+      if (i < args.worker_cpus.size()) {
+        cpus = {args.worker_cpus[i]};
+      }
+      srsran::scoped_cpu_affinity affinity(cpus);
+      workers[i]->init(common, cc_pool.get());
+    });
+  }
+  for (std::thread& t : init_threads) {
+    t.join();
+  }
+
+  // Add workers to workers pool and start threads.
+  for (uint32_t i = 0; i < args.nof_phy_threads; i++) {
+    pool.init_worker(i, workers[i].get(), prio);
+    if (i < args.worker_cpus.size()) {
+      workers[i]->set_cpu_affinity({args.worker_cpus[i]});
+    }
   }
 
   return true;
@@ -58,9 +87,39 @@ sf_worker* worker_pool::wait_worker_id(uint32_t id)
   return (sf_worker*)pool.wait_worker_id(id);
 }
 
+/// Called by the radio thread every TTI. Workers close their metrics period when they get a TTI, the ones left idle
+/// since the period started are run without a TTI, so that every worker publishes the period from its own thread
+void worker_pool::close_metrics_period(uint64_t period)
+{
+  if (period == metrics_period) {
+    return;
+  }
+
+  bool all_closed = true;
+  for (uint32_t i = 0; i < workers.size(); i++) {
+    if (workers[i]->get_metrics_period() == period) {
+      continue;
+    }
+    all_closed = false;
+
+    // Busy workers are retried on the next TTI
+    sf_worker* w = (sf_worker*)pool.wait_worker_id_nb(i);
+    if (w != nullptr) {
+      w->set_metrics_only();
+      pool.start_worker(w);
+    }
+  }
+  if (all_closed) {
+    metrics_period = period;
+  }
+}
+
 void worker_pool::stop()
 {
   pool.stop();
+  if (cc_pool != nullptr) {
+    cc_pool->stop();
+  }
 }
 
 }; // namespace lte
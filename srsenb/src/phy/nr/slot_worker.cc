@@ -37,7 +37,7 @@ slot_worker::slot_worker(srsran::phy_common_interface& common_,
                          stack_interface_phy_nr&       stack_,
                          sync_interface&               sync_,
                          srslog::basic_logger&         logger_) :
-  common(common_), stack(stack_), sync(sync_), logger(logger_)
+  common(common_), stack(stack_), sync(sync_), logger(logger_), alloc_checker(logger_, "slot_worker")
 {
   // Do nothing
 }
@@ -74,13 +74,14 @@ bool slot_worker::init(const args_t& args)
   }
 
   // Prepare DL arguments
-  srsran_gnb_dl_args_t dl_args = {};
-  dl_args.pdsch.measure_time   = true;
-  dl_args.pdsch.max_layers     = args.nof_tx_ports;
-  dl_args.pdsch.max_prb        = args.nof_max_prb;
-  dl_args.nof_tx_antennas      = args.nof_tx_ports;
-  dl_args.nof_max_prb          = args.nof_max_prb;
-  dl_args.srate_hz             = args.srate_hz;
+  srsran_gnb_dl_args_t dl_args            = {};
+  dl_args.pdsch.measure_time              = true;
+  dl_args.pdsch.max_layers                = args.nof_tx_ports;
+  dl_args.pdsch.max_prb                   = args.nof_max_prb;
+  dl_args.pdsch.sch.nof_encoder_coworkers = args.pdsch_coworkers;
+  dl_args.nof_tx_antennas                 = args.nof_tx_ports;
+  dl_args.nof_max_prb                     = args.nof_max_prb;
+  dl_args.srate_hz                        = args.srate_hz;
 
   // Initialise DL
   if (srsran_gnb_dl_init(&gnb_dl, tx_buffer.data(), &dl_args) < SRSRAN_SUCCESS) {
@@ -97,6 +98,7 @@ bool slot_worker::init(const args_t& args)
   ul_args.pusch.max_prb          = args.nof_max_prb;
   ul_args.nof_max_prb            = args.nof_max_prb;
   ul_args.pusch_min_snr_dB       = args.pusch_min_snr_dB;
+  overload_ctrl.init(args.pusch_budget_us, args.pusch_overload_its, args.pusch_overload_pct);
 
   // Initialise UL
   if (srsran_gnb_ul_init(&gnb_ul, rx_buffer[0], &ul_args) < SRSRAN_SUCCESS) {
@@ -249,6 +251,18 @@ bool slot_worker::work_ul()
     pusch_info.pdu->N_bytes             = pusch.sch.grant.tb[0].tbs / 8;
     pusch_info.pusch_data.tb[0].payload = pusch_info.pdu->data();
 
+    // Degrade the decoding if the slot is running out of time
+    pusch_overload_ctrl::action_t overload_action = overload_ctrl.get_action();
+    if (overload_action == pusch_overload_ctrl::action_t::reduce_iterations) {
+      pusch.sch.sch_cfg.max_nof_iter  = overload_ctrl.get_reduced_max_its();
+      pusch_info.overload_reduced_its = true;
+      logger.info("PUSCH: rnti=0x%x decoded with reduced iterations due to overload", pusch.sch.grant.rnti);
+    } else if (overload_action == pusch_overload_ctrl::action_t::skip_data) {
+      pusch.sch.uci_only       = true;
+      pusch_info.overload_nack = true;
+      logger.warning("PUSCH: rnti=0x%x not decoded due to overload", pusch.sch.grant.rnti);
+    }
+
     // Decode PUSCH
     if (srsran_gnb_ul_get_pusch(&gnb_ul, &ul_slot_cfg, &pusch.sch, &pusch.sch.grant, &pusch_info.pusch_data) <
         SRSRAN_SUCCESS) {
@@ -283,6 +297,12 @@ bool slot_worker::work_ul()
   return true;
 }
 
+void slot_worker::get_metrics(nr_phy_metrics_t& metrics) const
+{
+  metrics.pdsch_tx_cache_hit += pdsch_tx_cache_hit.load(std::memory_order_relaxed);
+  metrics.pdsch_tx_cache_miss += pdsch_tx_cache_miss.load(std::memory_order_relaxed);
+}
+
 bool slot_worker::work_dl()
 {
   // The Scheduler interface needs to be called synchronously, wait for the sync to be available
@@ -387,6 +407,9 @@ bool slot_worker::work_dl()
     }
   }
 
+  pdsch_tx_cache_hit.store(gnb_dl.pdsch.sch.nof_tx_cache_hit, std::memory_order_relaxed);
+  pdsch_tx_cache_miss.store(gnb_dl.pdsch.sch.nof_tx_cache_miss, std::memory_order_relaxed);
+
   // Generate baseband signal
   srsran_gnb_dl_gen_signal(&gnb_dl);
 
@@ -403,6 +426,12 @@ bool slot_worker::work_dl()
 
 void slot_worker::work_imp()
 {
+  srsran::tti_arena_scope      arena_scope(slot_arena);
+  srsran::rt_alloc_check_scope alloc_scope(alloc_checker);
+
+  // The PUSCH decoding budget counts from here
+  overload_ctrl.start_tti();
+
   // Inform Scheduler about new slot
   stack.slot_indication(dl_slot_cfg);
 
@@ -20,6 +20,9 @@
  */
 #include "srsenb/hdr/phy/nr/worker_pool.h"
 #include "srsran/common/band_helper.h"
+#include "srsran/common/cpu_topology.h"
+#include <atomic>
+#include <thread>
 
 namespace srsenb {
 namespace nr {
@@ -63,23 +66,47 @@ bool worker_pool::init(const args_t& args, const phy_cell_cfg_list_nr_t& cell_li
     pool.init_worker(i, w, args.prio);
     workers.push_back(std::unique_ptr<slot_worker>(w));
 
-    slot_worker::args_t w_args     = {};
-    uint32_t            cell_index = 0;
-    w_args.cell_index              = cell_index;
-    w_args.nof_max_prb             = cell_list[cell_index].carrier.nof_prb;
-    w_args.nof_tx_ports            = cell_list[cell_index].carrier.max_mimo_layers;
-    w_args.nof_rx_ports            = cell_list[cell_index].carrier.max_mimo_layers;
-    w_args.rf_port                 = cell_list[cell_index].rf_port;
-    w_args.srate_hz                = srate_hz;
-    w_args.pusch_max_its           = args.pusch_max_its;
-    w_args.pusch_min_snr_dB        = args.pusch_min_snr_dB;
-
-    if (not w->init(w_args)) {
-      return false;
+    if (i < args.worker_cpus.size()) {
+      w->set_cpu_affinity({args.worker_cpus[i]});
     }
   }
 
-  return true;
+  slot_worker::args_t w_args     = {};
+  uint32_t            cell_index = 0;
+  w_args.cell_index              = cell_index;
+  w_args.nof_max_prb             = cell_list[cell_index].carrier.nof_prb;
+  w_args.nof_tx_ports            = cell_list[cell_index].carrier.max_mimo_layers;
+  w_args.nof_rx_ports            = cell_list[cell_index].carrier.max_mimo_layers;
+  w_args.rf_port                 = cell_list[cell_index].rf_port;
+  w_args.srate_hz                = srate_hz;
+  w_args.pusch_max_its           = args.pusch_max_its;
+  w_args.pdsch_coworkers         = args.pdsch_coworkers;
+  w_args.pusch_budget_us         = args.pusch_budget_us;
+  w_args.pusch_overload_its      = args.pusch_overload_its;
+  w_args.pusch_overload_pct      = args.pusch_overload_pct;
+  w_args.pusch_min_snr_dB        = args.pusch_min_snr_dB;
+
+  // Initialise the workers in parallel, the initialisation of a worker does not depend on the others
+  std::vector<std::thread> init_threads;
+  std::atomic<bool>        init_ok = {true};
+  for (uint32_t i = 0; i < args.nof_phy_threads; i++) {
+    init_threads.emplace_back([this, &args, &w_args, &init_ok, i]() {
+      // Initialise the worker from its own CPU, so that its buffers are first touched on the right NUMA node
+      std::vector<uint32_t> cpus;
+      if (i < args.worker_cpus.size()) {
+        cpus = {args.worker_cpus[i]};
+      }
+      srsran::scoped_cpu_affinity affinity(cpus);
+      if (not workers[i]->init(w_args)) {
+        init_ok = false;
+      }
+    });
+  }
+  for (std::thread& t : init_threads) {
+    t.join();
+  }
+
+  return init_ok;
 }
 
 void worker_pool::start_worker(slot_worker* w)
@@ -116,6 +143,14 @@ void worker_pool::stop()
   prach.stop();
 }
 
+void worker_pool::get_metrics(nr_phy_metrics_t& metrics)
+{
+  metrics = {};
+  for (const std::unique_ptr<slot_worker>& w : workers) {
+    w->get_metrics(metrics);
+  }
+}
+
 int worker_pool::set_common_cfg(const phy_interface_rrc_nr::common_cfg_t& common_cfg)
 {
   // Best effort to convert NR carrier into LTE cell
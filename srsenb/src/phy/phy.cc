@@ -23,6 +23,7 @@
 #include "srsran/common/band_helper.h"
 #include "srsran/common/phy_cfg_nr_default.h"
 #include "srsran/common/threads.h"
+#include <chrono>
 #include <pthread.h>
 #include <sstream>
 #include <string.h>
@@ -48,6 +49,12 @@ using namespace asn1::rrc;
 
 namespace srsenb {
 
+/// Milliseconds elapsed since t, used to report the duration of each startup phase
+static uint32_t elapsed_ms(std::chrono::steady_clock::time_point t)
+{
+  return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - t).count();
+}
+
 static void srsran_phy_handler(phy_logger_level_t log_level, void* ctx, char* str)
 {
   phy* r = (phy*)ctx;
@@ -120,6 +127,9 @@ int phy::init(const phy_args_t&            args,
   }
 
   tx_rx.init(enb_, radio, &lte_workers, &workers_common, &prach, SF_RECV_THREAD_PRIO);
+  if (args.txrx_cpu >= 0) {
+    tx_rx.set_cpu_affinity({(uint32_t)args.txrx_cpu});
+  }
   initialized = true;
 
   return SRSRAN_SUCCESS;
@@ -137,6 +147,9 @@ int phy::init(const phy_args_t&            args,
   }
 
   tx_rx.init(enb_, radio, &lte_workers, &workers_common, &prach, SF_RECV_THREAD_PRIO);
+  if (args.txrx_cpu >= 0) {
+    tx_rx.set_cpu_affinity({(uint32_t)args.txrx_cpu});
+  }
   initialized = true;
 
   return SRSRAN_SUCCESS;
@@ -172,6 +185,7 @@ int phy::init_lte(const phy_args_t&            args,
   nof_workers = cfg.phy_cell_cfg.empty() ? 0 : args.nof_phy_threads;
 
   workers_common.params = args;
+  workers_common.metrics_clock.set_period(args.metrics_period_ms);
 
   workers_common.init(cfg.phy_cell_cfg, cfg.phy_cell_cfg_nr, radio, stack_lte_);
   if (cfg.cfr_config.cfr_enable) {
@@ -181,11 +195,14 @@ int phy::init_lte(const phy_args_t&            args,
   parse_common_config(cfg);
 
   // Add workers to workers pool and start threads
+  auto t_phase = std::chrono::steady_clock::now();
   if (not cfg.phy_cell_cfg.empty()) {
     lte_workers.init(args, &workers_common, log_sink, WORKERS_THREAD_PRIO);
   }
+  phy_log.info("Startup: %u LTE workers initialised in %u ms", nof_workers, elapsed_ms(t_phase));
 
   // For each carrier, initialise PRACH worker
+  t_phase = std::chrono::steady_clock::now();
   for (uint32_t cc = 0; cc < cfg.phy_cell_cfg.size(); cc++) {
     prach_cfg.root_seq_idx = cfg.phy_cell_cfg[cc].root_seq_idx;
     prach.init(cc,
@@ -197,6 +214,18 @@ int phy::init_lte(const phy_args_t&            args,
                args.nof_prach_threads);
   }
   prach.set_max_prach_offset_us(args.max_prach_offset_us);
+  phy_log.info(
+      "Startup: %zu PRACH workers initialised in %u ms", cfg.phy_cell_cfg.size(), elapsed_ms(t_phase));
+
+  phy_mem_usage_t mem = {};
+  get_mem_usage(mem);
+  phy_log.info("Memory: %.1f MB in %d shared UL DMRS tables (%.1f MB without sharing), %.1f MB sample buffers, "
+               "%.1f MB PUSCH scrambling cache",
+               mem.shared_tables / 1e6,
+               mem.nof_shared_tables,
+               mem.shared_tables_refs / 1e6,
+               mem.sample_buffers / 1e6,
+               mem.pusch_scrambling / 1e6);
 
   return SRSRAN_SUCCESS;
 }
@@ -247,11 +276,36 @@ void phy::set_activation_deactivation_scell(uint16_t rnti, const std::array<bool
   }
 }
 
-void phy::get_metrics(std::vector<phy_metrics_t>& metrics)
+void phy::get_mem_usage(phy_mem_usage_t& usage)
 {
-  std::vector<phy_metrics_t> metrics_tmp;
   for (uint32_t i = 0; i < nof_workers; i++) {
-    lte_workers[i]->get_metrics(metrics_tmp);
+    lte_workers[i]->get_mem_usage(usage);
+  }
+  usage.shared_tables     = workers_common.ul_dmrs_tables.nof_bytes();
+  usage.nof_shared_tables = workers_common.ul_dmrs_tables.nof_tables();
+}
+
+void phy::get_nr_metrics(nr_phy_metrics_t& metrics)
+{
+  if (nr_workers != nullptr) {
+    nr_workers->get_metrics(metrics);
+  }
+}
+
+bool phy::get_metrics(std::vector<phy_metrics_t>& metrics, uint64_t period)
+{
+  // Workers publish their metrics from their own thread once the period is over
+  std::vector<const std::vector<phy_metrics_t>*> worker_metrics(nof_workers);
+  for (uint32_t i = 0; i < nof_workers; i++) {
+    worker_metrics[i] = lte_workers[i]->get_metrics(period);
+    if (worker_metrics[i] == nullptr) {
+      return false;
+    }
+  }
+
+  metrics.clear();
+  for (const std::vector<phy_metrics_t>* w : worker_metrics) {
+    const std::vector<phy_metrics_t>& metrics_tmp = *w;
     metrics.resize(std::max(metrics_tmp.size(), metrics.size()));
     for (uint32_t j = 0; j < metrics_tmp.size(); j++) {
       metrics[j].dl.n_samples += metrics_tmp[j].dl.n_samples;
@@ -259,6 +313,8 @@ void phy::get_metrics(std::vector<phy_metrics_t>& metrics)
 
       metrics[j].ul.n_samples += metrics_tmp[j].ul.n_samples;
       metrics[j].ul.n_samples_pucch += metrics_tmp[j].ul.n_samples_pucch;
+      metrics[j].ul.n_overload_reduced_its += metrics_tmp[j].ul.n_overload_reduced_its;
+      metrics[j].ul.n_overload_nacks += metrics_tmp[j].ul.n_overload_nacks;
       metrics[j].ul.mcs += metrics_tmp[j].ul.n_samples * metrics_tmp[j].ul.mcs;
       metrics[j].ul.n += metrics_tmp[j].ul.n_samples * metrics_tmp[j].ul.n;
       metrics[j].ul.pusch_rssi += metrics_tmp[j].ul.n_samples * metrics_tmp[j].ul.pusch_rssi;
@@ -284,6 +340,7 @@ void phy::get_metrics(std::vector<phy_metrics_t>& metrics)
       metrics[j].ul.turbo_iters /= metrics[j].ul.n_samples;
     }
   }
+  return true;
 }
 
 void phy::cmd_cell_gain(uint32_t cell_id, float gain_db)
@@ -376,10 +433,17 @@ int phy::init_nr(const phy_args_t& args, const phy_cfg_t& cfg, stack_interface_p
   worker_args.log.phy_level           = args.log.phy_level;
   worker_args.log.phy_hex_limit       = args.log.phy_hex_limit;
   worker_args.pusch_max_its           = args.nr_pusch_max_its;
+  worker_args.pdsch_coworkers         = args.nr_pdsch_coworkers;
+  worker_args.pusch_budget_us         = args.pusch_budget_us;
+  worker_args.pusch_overload_its      = args.pusch_overload_its;
+  worker_args.pusch_overload_pct      = args.pusch_overload_pct;
+  worker_args.worker_cpus             = args.nr_worker_cpus;
 
+  auto t_phase = std::chrono::steady_clock::now();
   if (not nr_workers->init(worker_args, cfg.phy_cell_cfg_nr)) {
     return SRSRAN_ERROR;
   }
+  phy_log.info("Startup: %u NR workers initialised in %u ms", args.nof_phy_threads, elapsed_ms(t_phase));
 
   tx_rx.set_nr_workers(nr_workers.get());
 
@@ -149,6 +149,7 @@ void txrx::run_thread()
         running = false;
         continue;
       }
+      lte_workers->close_metrics_period(worker_com->metrics_clock.current());
     }
 
     nr::slot_worker* nr_worker = nullptr;
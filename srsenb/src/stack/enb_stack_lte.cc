@@ -48,12 +48,10 @@ enb_stack_lte::enb_stack_lte(srslog::sink& log_sink) :
   gtpu(&task_sched, gtpu_logger, srsran::srsran_rat_t::lte, &get_rx_io_manager()),
   s1ap(&task_sched, s1ap_logger, &get_rx_io_manager()),
   rrc(&task_sched, bearers),
-  mac_pcap(),
-  pending_stack_metrics(64)
+  mac_pcap()
 {
   get_background_workers().set_nof_workers(2);
-  enb_task_queue     = task_sched.make_task_queue();
-  metrics_task_queue = task_sched.make_task_queue();
+  enb_task_queue = task_sched.make_task_queue();
   // sync_queue is added in init()
 }
 
@@ -128,6 +126,9 @@ int enb_stack_lte::init(const stack_args_t&      args_,
   // setup bearer managers
   gtpu_adapter.reset(new gtpu_pdcp_adapter(stack_logger, &pdcp, x2_, &gtpu, bearers));
 
+  // The stack thread closes the metrics periods of its layers on the same period as the MAC
+  metrics_clock.set_period(args.mac.metrics_period_ms);
+
   // Init all LTE layers
   if (!mac.init(args.mac, rrc_cfg.cell_list, phy, &rlc, &rrc)) {
     stack_logger.error("Couldn't initialize MAC");
@@ -173,6 +174,12 @@ void enb_stack_lte::tti_clock_impl()
 {
   task_sched.tic();
   rrc.tti_clock();
+
+  // The metrics thread only reads what this thread publishes, so the metrics period of its layers is closed here
+  if (upper_metrics.closes(metrics_clock.current())) {
+    publish_upper_metrics();
+  }
+  upper_metrics_nof_tti++;
 }
 
 void enb_stack_lte::stop()
@@ -212,29 +219,29 @@ void enb_stack_lte::stop_impl()
   started = false;
 }
 
-bool enb_stack_lte::get_metrics(stack_metrics_t* metrics)
+void enb_stack_lte::publish_upper_metrics()
+{
+  stack_metrics_t& metrics = upper_metrics.write_buffer();
+  metrics                  = {};
+  if (upper_metrics_nof_tti > 0) {
+    rlc.get_metrics(metrics.rlc, upper_metrics_nof_tti);
+    pdcp.get_metrics(metrics.pdcp, upper_metrics_nof_tti);
+  }
+  rrc.get_metrics(metrics.rrc);
+  s1ap.get_metrics(metrics.s1ap);
+  upper_metrics.publish();
+  upper_metrics_nof_tti = 0;
+}
+
+bool enb_stack_lte::get_metrics(stack_metrics_t* metrics, uint64_t period)
 {
-  // use stack thread to query metrics
-  auto ret = metrics_task_queue.try_push([this]() {
-    stack_metrics_t metrics{};
-    mac.get_metrics(metrics.mac);
-    if (not metrics.mac.ues.empty()) {
-      rlc.get_metrics(metrics.rlc, metrics.mac.ues[0].nof_tti);
-      pdcp.get_metrics(metrics.pdcp, metrics.mac.ues[0].nof_tti);
-    }
-    rrc.get_metrics(metrics.rrc);
-    s1ap.get_metrics(metrics.s1ap);
-    if (not pending_stack_metrics.try_push(metrics)) {
-      stack_logger.error("Unable to push metrics to queue");
-    }
-  });
-
-  if (ret.has_value()) {
-    // wait for result
-    *metrics = pending_stack_metrics.pop_blocking();
-    return true;
+  // The MAC publishes from the PHY workers and the other layers from the stack thread, nothing is read from here
+  const stack_metrics_t* upper = upper_metrics.find(period);
+  if (upper == nullptr) {
+    return false;
   }
-  return false;
+  *metrics = *upper;
+  return mac.get_metrics(metrics->mac, period);
 }
 
 void enb_stack_lte::run_thread()
@@ -47,6 +47,8 @@ mac::mac(srsran::ext_task_sched_handle task_sched_, srslog::basic_logger& logger
 mac::~mac()
 {
   stop();
+  softbuffer_pool.reset();
+  srsran_softbuffer_pool_free(&rx_cb_pool);
   pthread_rwlock_destroy(&rwlock);
 }
 
@@ -65,6 +67,7 @@ bool mac::init(const mac_args_t&        args_,
   cells = cells_;
 
   scheduler.init(rrc, args.sched);
+  metrics_clock.set_period(args.metrics_period_ms);
 
   // Init softbuffer for SI messages
   common_buffers.resize(cells.size());
@@ -79,10 +82,25 @@ bool mac::init(const mac_args_t&        args_,
     srsran_softbuffer_tx_init(&cc.rar_softbuffer_tx, args.nof_prb);
   }
 
+  // Initiate pool of UL code block buffers shared by all UEs
+  srsran_softbuffer_pool_t* rx_pool = nullptr;
+  if (args.softbuffer_pool_max_cb > 0) {
+    if (srsran_softbuffer_pool_init(&rx_cb_pool,
+                                    SOFTBUFFER_SIZE,
+                                    args.softbuffer_pool_8bit,
+                                    RX_CB_POOL_CHUNK_SIZE,
+                                    args.softbuffer_pool_max_cb,
+                                    RX_CB_POOL_CHUNK_SIZE) < SRSRAN_SUCCESS) {
+      logger.error("Error initiating pool of %d UL softbuffer code blocks", args.softbuffer_pool_max_cb);
+      return false;
+    }
+    rx_pool = &rx_cb_pool;
+  }
+
   // Initiate common pool of softbuffers
   uint32_t nof_prb          = args.nof_prb;
-  auto     init_softbuffers = [nof_prb](void* ptr) {
-    new (ptr) ue_cc_softbuffers(nof_prb, SRSRAN_FDD_NOF_HARQ, SRSRAN_FDD_NOF_HARQ);
+  auto     init_softbuffers = [nof_prb, rx_pool](void* ptr) {
+    new (ptr) ue_cc_softbuffers(nof_prb, SRSRAN_FDD_NOF_HARQ, SRSRAN_FDD_NOF_HARQ, rx_pool);
   };
   auto recycle_softbuffers = [](ue_cc_softbuffers& softbuffers) { softbuffers.clear(); };
   softbuffer_pool.reset(new srsran::background_obj_pool<ue_cc_softbuffers>(
@@ -244,10 +262,29 @@ int mac::cell_cfg(const std::vector<sched_interface::cell_cfg_t>& cell_cfg_)
   return scheduler.cell_cfg(cell_config);
 }
 
-void mac::get_metrics(mac_metrics_t& metrics)
+bool mac::get_metrics(mac_metrics_t& metrics, uint64_t period)
 {
-  srsran::rwlock_read_guard lock(rwlock);
-  metrics.ues.reserve(ue_db.size());
+  const mac_metrics_t* m = period_metrics.find(period);
+  if (m == nullptr) {
+    return false;
+  }
+  metrics = *m;
+  return true;
+}
+
+/// Called by the PHY workers with the rwlock held. Several workers may get here at once, one of them closes the period
+void mac::close_metrics_period()
+{
+  if (metrics_busy.test_and_set(std::memory_order_acquire)) {
+    return;
+  }
+  if (not period_metrics.closes(metrics_clock.current())) {
+    metrics_busy.clear(std::memory_order_release);
+    return;
+  }
+
+  mac_metrics_t& metrics = period_metrics.write_buffer();
+  metrics.ues.clear();
   for (auto& u : ue_db) {
     if (not scheduler.ue_exists(u.first)) {
       continue;
@@ -264,6 +301,17 @@ void mac::get_metrics(mac_metrics_t& metrics)
     metrics.cc_info[cc].cc_rach_counter = detected_rachs[cc];
     metrics.cc_info[cc].pci             = (cc < cell_config.size()) ? cell_config[cc].cell.id : 0;
   }
+  if (args.softbuffer_pool_max_cb > 0) {
+    srsran_softbuffer_pool_stats_t stats = {};
+    srsran_softbuffer_pool_get_stats(&rx_cb_pool, &stats);
+    metrics.softbuffer_pool.nof_cb         = stats.nof_slots;
+    metrics.softbuffer_pool.max_cb         = stats.max_slots;
+    metrics.softbuffer_pool.nof_used_cb    = stats.nof_used;
+    metrics.softbuffer_pool.peak_used_cb   = stats.peak_used;
+    metrics.softbuffer_pool.nof_alloc_fail = stats.nof_alloc_fail;
+  }
+  period_metrics.publish();
+  metrics_busy.clear(std::memory_order_release);
 }
 
 void mac::toggle_padding()
@@ -817,6 +865,7 @@ int mac::get_dl_sched(uint32_t tti_tx_dl, dl_sched_list_t& dl_sched_res_list)
   for (auto& u : ue_db) {
     u.second->metrics_cnt();
   }
+  close_metrics_period();
 
   return SRSRAN_SUCCESS;
 }
@@ -924,6 +973,7 @@ int mac::get_mch_sched(uint32_t tti, bool is_mcch, dl_sched_list_t& dl_sched_res
   for (auto& u : ue_db) {
     u.second->metrics_cnt();
   }
+  close_metrics_period();
   return SRSRAN_SUCCESS;
 }
 
@@ -20,11 +20,13 @@
  */
 
 #include "srsenb/hdr/stack/mac/sched_helpers.h"
+#include "srsran/adt/pool/tti_arena.h"
 #include "srsran/common/standard_streams.h"
 #include "srsran/common/string_helpers.h"
 #include "srsran/mac/pdu.h"
 #include "srsran/srslog/bundled/fmt/format.h"
 #include <array>
+#include <iterator>
 
 #define Debug(fmt, ...) get_mac_logger().debug(fmt, ##__VA_ARGS__)
 #define Info(fmt, ...) get_mac_logger().info(fmt, ##__VA_ARGS__)
@@ -35,7 +37,8 @@ namespace srsenb {
 
 using dl_sched_res_t    = sched_interface::dl_sched_res_t;
 using dl_sched_data_t   = sched_interface::dl_sched_data_t;
-using custom_mem_buffer = fmt::basic_memory_buffer<char, 1024>;
+/// Log buffer that grows into the worker TTI arena rather than the heap when its inline storage is not enough
+using custom_mem_buffer = fmt::basic_memory_buffer<char, 1024, srsran::tti_arena_allocator<char>>;
 
 static srslog::basic_logger& get_mac_logger()
 {
@@ -78,18 +81,18 @@ void fill_dl_cc_result_info(custom_mem_buffer& strbuf, const dl_sched_data_t& da
     return;
   }
   const char* prefix = strbuf.size() > 0 ? " | " : "";
-  fmt::format_to(strbuf, "{}rnti=0x{:0x}: [", prefix, data.dci.rnti);
+  fmt::format_to(std::back_inserter(strbuf), "{}rnti=0x{:0x}: [", prefix, data.dci.rnti);
   bool ces_found = false;
   for (uint32_t i = 0; i < data.nof_pdu_elems[0]; ++i) {
     const auto& pdu          = data.pdu[0][i];
     prefix                   = (ces_found) ? " | " : "";
     srsran::dl_sch_lcid lcid = static_cast<srsran::dl_sch_lcid>(pdu.lcid);
     if (srsran::is_mac_ce(lcid)) {
-      fmt::format_to(strbuf, "{}CE \"{}\"", prefix, srsran::to_string_short(lcid));
+      fmt::format_to(std::back_inserter(strbuf), "{}CE \"{}\"", prefix, srsran::to_string_short(lcid));
       ces_found = true;
     }
   }
-  fmt::format_to(strbuf, "]");
+  fmt::format_to(std::back_inserter(strbuf), "]");
 }
 
 void fill_dl_cc_result_debug(custom_mem_buffer& strbuf, const dl_sched_data_t& data)
@@ -97,7 +100,7 @@ void fill_dl_cc_result_debug(custom_mem_buffer& strbuf, const dl_sched_data_t& d
   if (data.nof_pdu_elems[0] == 0 and data.nof_pdu_elems[1] == 0) {
     return;
   }
-  fmt::format_to(strbuf,
+  fmt::format_to(std::back_inserter(strbuf),
                  "  > rnti=0x{:0x}, tbs={}, f={}, mcs={}: [",
                  data.dci.rnti,
                  data.tbs[0],
@@ -109,13 +112,13 @@ void fill_dl_cc_result_debug(custom_mem_buffer& strbuf, const dl_sched_data_t& d
       const char*         prefix = (i == 0) ? "" : " | ";
       srsran::dl_sch_lcid lcid   = static_cast<srsran::dl_sch_lcid>(pdu.lcid);
       if (srsran::is_mac_ce(lcid)) {
-        fmt::format_to(strbuf, "{}CE \"{}\"", prefix, srsran::to_string_short(lcid));
+        fmt::format_to(std::back_inserter(strbuf), "{}CE \"{}\"", prefix, srsran::to_string_short(lcid));
       } else {
-        fmt::format_to(strbuf, "{}SDU lcid={}, tb={}, len={} B", prefix, pdu.lcid, tb, pdu.nbytes);
+        fmt::format_to(std::back_inserter(strbuf), "{}SDU lcid={}, tb={}, len={} B", prefix, pdu.lcid, tb, pdu.nbytes);
       }
     }
   }
-  fmt::format_to(strbuf, "]");
+  fmt::format_to(std::back_inserter(strbuf), "]");
 }
 
 void log_dl_cc_results(srslog::basic_logger& logger, uint32_t enb_cc_idx, const sched_interface::dl_sched_res_t& result)
@@ -154,7 +157,7 @@ void log_phich_cc_results(srslog::basic_logger&                  logger,
     const phich_t& phich  = result.phich[i];
     const char*    prefix = strbuf.size() > 0 ? " | " : "";
     const char*    val    = phich.phich == phich_t::ACK ? "ACK" : "NACK";
-    fmt::format_to(strbuf, "{}rnti=0x{:0x}, val={}", prefix, phich.rnti, val);
+    fmt::format_to(std::back_inserter(strbuf), "{}rnti=0x{:0x}, val={}", prefix, phich.rnti, val);
   }
   if (strbuf.size() != 0) {
     logger.debug("SCHED: Allocated PHICHs, cc=%d: [%s]", enb_cc_idx, srsran::to_c_str(strbuf));
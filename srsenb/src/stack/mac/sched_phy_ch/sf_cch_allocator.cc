@@ -22,6 +22,7 @@
 #include "srsenb/hdr/stack/mac/sched_phy_ch/sf_cch_allocator.h"
 #include "srsenb/hdr/stack/mac/sched_grid.h"
 #include "srsran/srslog/bundled/fmt/format.h"
+#include <iterator>
 
 namespace srsenb {
 
@@ -252,13 +253,16 @@ void sf_cch_allocator::get_allocs(alloc_result_t* vec, pdcch_mask_t* tot_mask, s
   }
 }
 
-std::string sf_cch_allocator::result_to_string(bool verbose) const
+srsran::tti_arena_string sf_cch_allocator::result_to_string(bool verbose) const
 {
-  fmt::basic_memory_buffer<char, 1024> strbuf;
+  fmt::basic_memory_buffer<char, 1024, srsran::tti_arena_allocator<char>> strbuf;
   if (dci_record_list.empty()) {
-    fmt::format_to(strbuf, "SCHED: PDCCH allocations cfi={}, nof_cce={}, No allocations.\n", get_cfi(), nof_cces());
+    fmt::format_to(std::back_inserter(strbuf),
+                   "SCHED: PDCCH allocations cfi={}, nof_cce={}, No allocations.\n",
+                   get_cfi(),
+                   nof_cces());
   } else {
-    fmt::format_to(strbuf,
+    fmt::format_to(std::back_inserter(strbuf),
                    "SCHED: PDCCH allocations cfi={}, nof_cce={}, nof_allocs={}, total PDCCH mask=0x{:x}",
                    get_cfi(),
                    nof_cces(),
@@ -267,19 +271,19 @@ std::string sf_cch_allocator::result_to_string(bool verbose) const
     alloc_result_t vec;
     get_allocs(&vec);
     if (verbose) {
-      fmt::format_to(strbuf, ", allocations:\n");
+      fmt::format_to(std::back_inserter(strbuf), ", allocations:\n");
       for (const auto& dci_alloc : vec) {
-        fmt::format_to(strbuf,
+        fmt::format_to(std::back_inserter(strbuf),
                        "  > rnti=0x{:0x}: 0x{:x} / 0x{:x}\n",
                        dci_alloc->rnti,
                        dci_alloc->current_mask,
                        dci_alloc->total_mask);
       }
     } else {
-      fmt::format_to(strbuf, ".\n");
+      fmt::format_to(std::back_inserter(strbuf), ".\n");
     }
   }
-  return fmt::to_string(strbuf);
+  return srsran::tti_arena_string(strbuf.data(), strbuf.size());
 }
 
 } // namespace srsenb
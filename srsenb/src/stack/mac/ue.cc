@@ -32,13 +32,21 @@
 
 namespace srsenb {
 
-ue_cc_softbuffers::ue_cc_softbuffers(uint32_t nof_prb, uint32_t nof_tx_harq_proc_, uint32_t nof_rx_harq_proc_) :
+ue_cc_softbuffers::ue_cc_softbuffers(uint32_t                  nof_prb,
+                                     uint32_t                  nof_tx_harq_proc_,
+                                     uint32_t                  nof_rx_harq_proc_,
+                                     srsran_softbuffer_pool_t* rx_pool) :
   nof_tx_harq_proc(nof_tx_harq_proc_), nof_rx_harq_proc(nof_rx_harq_proc_)
 {
-  // Create and init Rx buffers
+  // Create and init Rx buffers. If a pool is given, the code blocks are taken from it when a TB is scheduled
   softbuffer_rx_list.resize(nof_rx_harq_proc);
   for (srsran_softbuffer_rx_t& buffer : softbuffer_rx_list) {
-    srsran_softbuffer_rx_init(&buffer, nof_prb);
+    if (rx_pool != nullptr) {
+      uint32_t max_tbs = srsran_ra_tbs_from_idx(SRSRAN_RA_NOF_TBS_IDX - 1, nof_prb);
+      srsran_softbuffer_rx_init_pool(&buffer, rx_pool, max_tbs / (SRSRAN_TCOD_MAX_LEN_CB - 24) + 1);
+    } else {
+      srsran_softbuffer_rx_init(&buffer, nof_prb);
+    }
   }
 
   // Create and init Tx buffers
@@ -133,6 +133,18 @@ std::string to_string(const cells_to_add_mod_s& obj)
   return {buf};
 }
 
+//! PDCP SN length of the DRB of an E-RAB in the radio resource config of the UE, 0 if the DRB is not found
+uint32_t get_erab_pdcp_sn_len(const rr_cfg_ded_s& rr_cfg, const bearer_cfg_handler::erab_t& erab)
+{
+  lte_drb drb_id = lte_lcid_to_drb(erab.lcid);
+  for (const drb_to_add_mod_s& drb : rr_cfg.drb_to_add_mod_list) {
+    if ((lte_drb)drb.drb_id == drb_id and drb.pdcp_cfg_present) {
+      return srsran::get_pdcp_drb_sn_len(drb.pdcp_cfg);
+    }
+  }
+  return 0;
+}
+
 } // namespace rrc_details
 
 /*************************************************************************************************
@@ -895,9 +907,13 @@ void rrc::ue::rrc_mobility::handle_ho_requested(idle_st& s, const ho_req_rx_ev&
       if (fwd_erab.dl_forwarding_present and
           fwd_erab.dl_forwarding.value == asn1::s1ap::dl_forwarding_opts::dl_forwarding_proposed) {
         admitted_erab.dl_g_tp_teid_present = true;
+        // Forwarded SDUs are buffered in the order of the PDCP SNs of the source
+        uint32_t pdcp_sn_len = rrc_details::get_erab_pdcp_sn_len(rrc_ue->current_ue_cfg.rr_cfg, erab.second);
+
         gtpu_interface_rrc::bearer_props props;
         props.flush_before_teidin_present     = true;
         props.flush_before_teidin             = erab.second.teid_in;
+        props.pdcp_sn_len                     = pdcp_sn_len;
         srsran::expected<uint32_t> dl_teid_in = rrc_ue->bearer_list.add_gtpu_bearer(
             erab.second.id, erab.second.teid_out, erab.second.address.to_number(), &props);
         if (not dl_teid_in.has_value()) {
@@ -42,6 +42,73 @@ namespace srsenb {
 #define TEID_IN_FMT "TEID In=0x%x"
 #define TEID_OUT_FMT "TEID Out=0x%x"
 
+/****************************************************************************
+ * Handover SDU buffer
+ ***************************************************************************/
+
+srsran::unique_byte_buffer_t* gtpu_sdu_buffer::get_slot(segment_list_t& segments, uint32_t idx)
+{
+  uint32_t seg_idx = idx / SEGMENT_SIZE;
+  while (seg_idx >= segments.size()) {
+    segments.emplace_back();
+  }
+  if (not segments[seg_idx].has_value()) {
+    segments[seg_idx].emplace();
+    if (not segments[seg_idx].has_value()) {
+      return nullptr;
+    }
+  }
+  return &(*segments[seg_idx])[idx % SEGMENT_SIZE];
+}
+
+bool gtpu_sdu_buffer::push(uint32_t pdcp_sn, srsran::unique_byte_buffer_t sdu)
+{
+  if (full()) {
+    return false;
+  }
+  srsran::unique_byte_buffer_t* slot = nullptr;
+  if (pdcp_sn == undefined_pdcp_sn) {
+    if (nof_fifo_sdus >= MAX_SEGMENTS * SEGMENT_SIZE) {
+      return false;
+    }
+    slot = get_slot(fifo_segments, nof_fifo_sdus);
+    if (slot == nullptr) {
+      return false;
+    }
+    nof_fifo_sdus++;
+  } else {
+    if (pdcp_sn >= sn_mod) {
+      // SN longer than the PDCP SN of the bearer
+      return false;
+    }
+    if (nof_sdus == nof_fifo_sdus) {
+      // First SDU with SN, which sets the start of the SN window. SDUs with SNs up to a quarter of the SN space
+      // behind it are still read before it
+      base_sn = (pdcp_sn + sn_mod - sn_mod / 4) % sn_mod;
+    }
+    slot = get_slot(sn_segments, (pdcp_sn + sn_mod - base_sn) % sn_mod);
+    if (slot == nullptr or *slot != nullptr) {
+      // Out of pool blocks or repeated SN
+      return false;
+    }
+  }
+  *slot = std::move(sdu);
+  nof_sdus++;
+  return true;
+}
+
+void gtpu_sdu_buffer::clear()
+{
+  sn_segments.clear();
+  fifo_segments.clear();
+  nof_sdus      = 0;
+  nof_fifo_sdus = 0;
+}
+
+/****************************************************************************
+ * GTPU tunnel manager
+ ***************************************************************************/
+
 gtpu_tunnel_manager::gtpu_tunnel_manager(srsran::task_sched_handle task_sched_,
                                          srslog::basic_logger&     logger,
                                          srsran::srsran_rat_t      ran_type_) :
@@ -89,7 +156,11 @@ gtpu_tunnel_manager::find_rnti_bearer_tunnels(uint16_t rnti, uint32_t eps_bearer
 }
 
 const gtpu_tunnel*
-gtpu_tunnel_manager::add_tunnel(uint16_t rnti, uint32_t eps_bearer_id, uint32_t teidout, uint32_t spgw_addr)
+gtpu_tunnel_manager::add_tunnel(uint16_t rnti,
+                                uint32_t eps_bearer_id,
+                                uint32_t teidout,
+                                uint32_t spgw_addr,
+                                uint32_t pdcp_sn_len)
 {
   if (ran_type == srsran::srsran_rat_t::lte and not is_eps_bearer_id(eps_bearer_id)) {
     logger.warning("Adding TEID with invalid eps-BearerID=%d", eps_bearer_id);
@@ -110,6 +181,7 @@ gtpu_tunnel_manager::add_tunnel(uint16_t rnti, uint32_t eps_bearer_id, uint32_t
   tun->eps_bearer_id = eps_bearer_id;
   tun->teid_out      = teidout;
   tun->spgw_addr     = spgw_addr;
+  tun->pdcp_sn_len   = pdcp_sn_len;
 
   if (ue_teidin_db.find(rnti) == ue_teidin_db.end()) {
     auto ret = ue_teidin_db.emplace(rnti, ue_bearer_tunnel_list());
@@ -234,16 +306,10 @@ void gtpu_tunnel_manager::activate_tunnel(uint32_t teid)
               tun.rnti,
               tun.teid_in,
               tun.buffer->size());
-  // Forward buffered SDUs to lower layers and delete buffer
-  auto lower_sn = [](const std::pair<uint32_t, srsran::unique_byte_buffer_t>& lhs,
-                     const std::pair<uint32_t, srsran::unique_byte_buffer_t>& rhs) { return lhs.first < rhs.first; };
-  std::stable_sort(tun.buffer->begin(), tun.buffer->end(), lower_sn);
-
-  for (auto& sdu_pair : *tun.buffer) {
-    uint32_t pdcp_sn = sdu_pair.first;
-    pdcp->write_sdu(
-        tun.rnti, tun.eps_bearer_id, std::move(sdu_pair.second), pdcp_sn == undefined_pdcp_sn ? -1 : pdcp_sn);
-  }
+  // Forward buffered SDUs to lower layers in PDCP SN order and delete buffer
+  tun.buffer->flush([this, &tun](uint32_t pdcp_sn, srsran::unique_byte_buffer_t sdu) {
+    pdcp->write_sdu(tun.rnti, tun.eps_bearer_id, std::move(sdu), pdcp_sn == undefined_pdcp_sn ? -1 : pdcp_sn);
+  });
   tun.buffer.reset();
   tun.state = tunnel_state::pdcp_active;
 }
@@ -255,8 +321,8 @@ void gtpu_tunnel_manager::suspend_tunnel(uint32_t teid)
     logger.error("Invalid TEID transition detected");
     return;
   }
-  // Create a container for buffering SDUs
-  tun.buffer.emplace();
+  // Create a container for buffering SDUs, ordered with the PDCP SN length of the bearer
+  tun.buffer.emplace(tun.pdcp_sn_len);
   tun.state = tunnel_state::buffering;
 }
 
@@ -325,17 +391,17 @@ void gtpu_tunnel_manager::buffer_pdcp_sdu(uint32_t teid, uint32_t pdcp_sn, srsra
   tunnel& rx_tun = tunnels[teid];
 
   srsran_assert(rx_tun.state == tunnel_state::buffering, "Buffering of PDCP SDUs only enabled when PDCP is not active");
-  if (not rx_tun.buffer->full()) {
-    rx_tun.buffer->push_back(std::make_pair(pdcp_sn, std::move(sdu)));
-  } else {
+  bool full = rx_tun.buffer->full();
+  if (not rx_tun.buffer->push(pdcp_sn, std::move(sdu))) {
     fmt::memory_buffer str_buffer;
     if (pdcp_sn != undefined_pdcp_sn) {
       fmt::format_to(str_buffer, " PDCP SN={}", pdcp_sn);
     }
-    logger.warning("GTPU tunnel " TEID_IN_FMT " internal buffer of size=%zd is full. Discarding SDU%s.",
+    logger.warning("GTPU tunnel " TEID_IN_FMT " could not buffer SDU%s. %zd SDUs currently buffered%s. Discarding SDU.",
                    teid,
+                   to_c_str(str_buffer),
                    rx_tun.buffer->size(),
-                   to_c_str(str_buffer));
+                   full ? ", buffer full" : "");
   }
 }
 
@@ -471,6 +537,22 @@ void gtpu::send_pdu_to_tunnel(const gtpu_tunnel& tx_tun, srsran::unique_byte_buf
     return;
   }
 
+  if (not write_tunnel_header(tx_tun, pdu.get(), pdcp_sn)) {
+    return;
+  }
+
+  struct sockaddr_in servaddr;
+  servaddr.sin_family      = AF_INET;
+  servaddr.sin_addr.s_addr = htonl(tx_tun.spgw_addr);
+  servaddr.sin_port        = htons(GTPU_PORT);
+
+  if (sendto(fd, pdu->msg, pdu->N_bytes, MSG_EOR, (struct sockaddr*)&servaddr, sizeof(struct sockaddr_in)) < 0) {
+    perror("sendto");
+  }
+}
+
+bool gtpu::write_tunnel_header(const gtpu_tunnel& tx_tun, srsran::byte_buffer_t* pdu, int pdcp_sn)
+{
   gtpu_header_t header;
   header.flags        = GTPU_FLAGS_VERSION_V1 | GTPU_FLAGS_GTP_PROTOCOL;
   header.message_type = GTPU_MSG_DATA_PDU;
@@ -487,18 +569,61 @@ void gtpu::send_pdu_to_tunnel(const gtpu_tunnel& tx_tun, srsran::unique_byte_buf
     header.ext_buffer[3] = 0;
   }
 
+  if (!gtpu_write_header(&header, pdu, logger)) {
+    logger.error("Error writing GTP-U Header. Flags 0x%x, Message Type 0x%x", header.flags, header.message_type);
+    return false;
+  }
+  return true;
+}
+
+/// Sends PDUs in PDCP SN order, in batches of up to TX_BATCH_SIZE PDUs per system call
+void gtpu::send_pdus_to_tunnel(const gtpu_tunnel& tx_tun, std::map<uint32_t, srsran::unique_byte_buffer_t>& pdus)
+{
   struct sockaddr_in servaddr;
   servaddr.sin_family      = AF_INET;
   servaddr.sin_addr.s_addr = htonl(tx_tun.spgw_addr);
   servaddr.sin_port        = htons(GTPU_PORT);
 
-  if (!gtpu_write_header(&header, pdu.get(), logger)) {
-    logger.error("Error writing GTP-U Header. Flags 0x%x, Message Type 0x%x", header.flags, header.message_type);
-    return;
-  }
-  if (sendto(fd, pdu->msg, pdu->N_bytes, MSG_EOR, (struct sockaddr*)&servaddr, sizeof(struct sockaddr_in)) < 0) {
-    perror("sendto");
+  std::array<struct iovec, TX_BATCH_SIZE>   iov;
+  std::array<struct mmsghdr, TX_BATCH_SIZE> msgs;
+  auto                                      it = pdus.begin();
+  while (it != pdus.end()) {
+    uint32_t nof_msgs = 0;
+    for (; it != pdus.end() and nof_msgs < TX_BATCH_SIZE; ++it) {
+      srsran::byte_buffer_t* pdu    = it->second.get();
+      struct iphdr*          ip_pkt = (struct iphdr*)pdu->msg;
+      if (ip_pkt->version != 4 && ip_pkt->version != 6) {
+        logger.error("Invalid IP version to SPGW");
+        continue;
+      }
+      log_message(tx_tun, false, srsran::make_span(it->second), it->first);
+      if (not write_tunnel_header(tx_tun, pdu, it->first)) {
+        continue;
+      }
+      iov[nof_msgs]                      = {pdu->msg, pdu->N_bytes};
+      msgs[nof_msgs]                     = {};
+      msgs[nof_msgs].msg_hdr.msg_name    = &servaddr;
+      msgs[nof_msgs].msg_hdr.msg_namelen = sizeof(servaddr);
+      msgs[nof_msgs].msg_hdr.msg_iov     = &iov[nof_msgs];
+      msgs[nof_msgs].msg_hdr.msg_iovlen  = 1;
+      nof_msgs++;
+    }
+    uint32_t nof_sent = 0;
+    while (nof_sent < nof_msgs) {
+      int n = sendmmsg(fd, &msgs[nof_sent], nof_msgs - nof_sent, 0);
+      if (n < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        // Skip the PDU that failed and retry the rest of the batch
+        logger.error("Error sending PDU to " TEID_OUT_FMT ". Error: %s", tx_tun.teid_out, strerror(errno));
+        nof_sent++;
+        continue;
+      }
+      nof_sent += n;
+    }
   }
+  pdus.clear();
 }
 
 srsran::expected<uint32_t> gtpu::add_bearer(uint16_t            rnti,
@@ -509,7 +634,8 @@ srsran::expected<uint32_t> gtpu::add_bearer(uint16_t            rnti,
                                             const bearer_props* props)
 {
   // Allocate a TEID for the incoming tunnel
-  const gtpu_tunnel* new_tun = tunnels.add_tunnel(rnti, eps_bearer_id, teid_out, addr_out);
+  uint32_t           pdcp_sn_len = props != nullptr ? props->pdcp_sn_len : 0;
+  const gtpu_tunnel* new_tun     = tunnels.add_tunnel(rnti, eps_bearer_id, teid_out, addr_out, pdcp_sn_len);
   if (new_tun == nullptr) {
     return default_error_t();
   }
@@ -737,11 +863,7 @@ int gtpu::create_dl_fwd_tunnel(uint32_t rx_teid_in, uint32_t tx_teid_in)
 
   // Get all buffered PDCP PDUs, and forward them through tx tunnel
   std::map<uint32_t, srsran::unique_byte_buffer_t> pdus = pdcp->get_buffered_pdus(rx_tun->rnti, rx_tun->eps_bearer_id);
-  for (auto& pdu_pair : pdus) {
-    uint32_t pdcp_sn = pdu_pair.first;
-    log_message(*tx_tun, false, srsran::make_span(pdu_pair.second), pdcp_sn);
-    send_pdu_to_tunnel(*tx_tun, std::move(pdu_pair.second), pdcp_sn);
-  }
+  send_pdus_to_tunnel(*tx_tun, pdus);
 
   return SRSRAN_SUCCESS;
 }
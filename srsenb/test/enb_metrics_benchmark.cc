@@ -0,0 +1,238 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/*
+ * Measures the TTI latency of a stack thread while a metrics hub collects per-UE metrics from it, either by posting a
+ * task to the stack thread and blocking until it answers, or by letting the stack thread publish the metrics of every
+ * metrics period from its first TTI in the next one and reading the last period published.
+ */
+
+#include "srsran/adt/circular_buffer.h"
+#include "srsran/common/metrics_hub.h"
+#include "srsran/common/metrics_period.h"
+#include "srsran/common/task_scheduler.h"
+#include "srsran/common/test_common.h"
+#include "srsran/interfaces/enb_metrics_interface.h"
+#include <algorithm>
+#include <future>
+#include <getopt.h>
+#include <thread>
+
+using namespace srsenb;
+using std::chrono::steady_clock;
+
+static uint32_t nof_ttis = 2000;
+static uint32_t nof_ues  = 1000;
+
+enum class collect_mode { blocking, snapshot };
+
+/// Stack thread model, with a per-UE state updated every TTI and collected as stack_metrics_t
+class stack_model : public srsran::metrics_interface<stack_metrics_t>
+{
+public:
+  stack_model(collect_mode mode_, uint32_t nof_ues_, uint32_t period_ms) :
+    mode(mode_), ue_state(nof_ues_), pending_metrics(1), metrics_clock(period_ms)
+  {
+    sync_queue    = task_sched.make_task_queue();
+    metrics_queue = task_sched.make_task_queue();
+    for (uint32_t i = 0; i < ue_state.size(); i++) {
+      ue_state[i].rnti = 0x46 + i;
+    }
+    thread = std::thread([this]() {
+      while (task_sched.run_next_task()) {
+      }
+    });
+  }
+  ~stack_model()
+  {
+    task_sched.stop();
+    pending_metrics.stop();
+    thread.join();
+  }
+
+  void push_tti(steady_clock::time_point deadline)
+  {
+    sync_queue.push([this, deadline]() {
+      auto start = steady_clock::now();
+      if (mode == collect_mode::snapshot and metrics_snapshot.closes(metrics_clock.current())) {
+        collect(metrics_snapshot.write_buffer());
+        metrics_snapshot.publish();
+      }
+      for (auto& u : ue_state) {
+        u.nof_tti++;
+        u.tx_pkts++;
+        u.rx_pkts++;
+      }
+      auto end = steady_clock::now();
+      late_us.push_back(std::chrono::duration_cast<std::chrono::microseconds>(start - deadline).count());
+      total_us.push_back(std::chrono::duration_cast<std::chrono::microseconds>(end - deadline).count());
+    });
+  }
+
+  bool get_metrics(stack_metrics_t* m) override
+  {
+    if (mode == collect_mode::snapshot) {
+      // The last complete period is reported again if the stack thread has not published the new one yet
+      const stack_metrics_t* snapshot = metrics_snapshot.find(metrics_clock.last_closed());
+      if (snapshot != nullptr) {
+        last_metrics = *snapshot;
+      } else if (nof_reads == 0) {
+        return false;
+      }
+      *m = last_metrics;
+    } else {
+      auto ret = metrics_queue.try_push([this]() {
+        stack_metrics_t metrics{};
+        collect(metrics);
+        pending_metrics.try_push(metrics);
+      });
+      if (not ret.has_value()) {
+        return false;
+      }
+      bool success = false;
+      *m           = pending_metrics.pop_blocking(&success);
+      if (not success) {
+        return false;
+      }
+    }
+    nof_reads++;
+    return true;
+  }
+
+  /// Waits for the stack thread to process every TTI pushed so far
+  void flush()
+  {
+    std::promise<void> p;
+    sync_queue.push([&p]() { p.set_value(); });
+    p.get_future().wait();
+  }
+
+  std::vector<int64_t> late_us;
+  std::vector<int64_t> total_us;
+  std::atomic<int>     nof_reads{0};
+
+private:
+  void collect(stack_metrics_t& metrics)
+  {
+    metrics = {};
+    metrics.mac.ues.assign(ue_state.begin(), ue_state.end());
+    metrics.rlc.ues.resize(ue_state.size());
+    metrics.pdcp.ues.resize(ue_state.size());
+    metrics.rrc.ues.resize(ue_state.size());
+    for (auto& u : metrics.rrc.ues) {
+      u.drb_qci_map.emplace_back(1, 9);
+    }
+  }
+
+  collect_mode                                   mode;
+  std::vector<mac_ue_metrics_t>                  ue_state;
+  srsran::task_scheduler                         task_sched;
+  srsran::task_queue_handle                      sync_queue;
+  srsran::task_queue_handle                      metrics_queue;
+  srsran::dyn_blocking_queue<stack_metrics_t>    pending_metrics;
+  srsran::metrics_period_clock                   metrics_clock;
+  srsran::metrics_period_buffer<stack_metrics_t> metrics_snapshot;
+  stack_metrics_t                                last_metrics; ///< Only accessed by the metrics thread
+  std::thread                                    thread;
+};
+
+class dummy_listener : public srsran::metrics_listener<stack_metrics_t>
+{
+public:
+  void set_metrics(const stack_metrics_t& m, const uint32_t period_usec) override { nof_ues += m.mac.ues.size(); }
+  void stop() override {}
+
+  size_t nof_ues = 0;
+};
+
+static int64_t percentile(std::vector<int64_t> v, double p)
+{
+  std::sort(v.begin(), v.end());
+  return v[std::min(v.size() - 1, (size_t)(p * v.size()))];
+}
+
+int run_benchmark(collect_mode mode, uint32_t period_ms)
+{
+  dummy_listener                       listener;
+  srsran::metrics_hub<stack_metrics_t> hub;
+  std::unique_ptr<stack_model>         stack(new stack_model(mode, nof_ues, period_ms));
+  hub.init(stack.get(), period_ms / 1000.0f);
+  hub.add_listener(&listener);
+
+  // 1 ms TTI clock
+  auto deadline = steady_clock::now();
+  for (uint32_t tti = 0; tti < nof_ttis; tti++) {
+    deadline += std::chrono::milliseconds(1);
+    std::this_thread::sleep_until(deadline);
+    stack->push_tti(deadline);
+  }
+  stack->flush();
+  hub.stop();
+
+  printf("%-8s period=%4d ms: reads=%4d; TTI start late p99=%5ld us, max=%5ld us; TTI end late p99=%5ld us, "
+         "max=%5ld us\n",
+         mode == collect_mode::snapshot ? "snapshot" : "blocking",
+         period_ms,
+         stack->nof_reads.load(),
+         (long)percentile(stack->late_us, 0.99),
+         (long)percentile(stack->late_us, 1.0),
+         (long)percentile(stack->total_us, 0.99),
+         (long)percentile(stack->total_us, 1.0));
+  TESTASSERT(stack->late_us.size() == nof_ttis);
+  return SRSRAN_SUCCESS;
+}
+
+void usage(char* prog)
+{
+  printf("Usage: %s [tu]\n", prog);
+  printf("\t-t Number of TTIs per run [Default %d]\n", nof_ttis);
+  printf("\t-u Number of UEs [Default %d]\n", nof_ues);
+}
+
+void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "tu")) != -1) {
+    switch (opt) {
+      case 't':
+        nof_ttis = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'u':
+        nof_ues = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+  printf("%d UEs, %d TTIs per run\n", nof_ues, nof_ttis);
+
+  for (uint32_t period_ms : {10, 100, 1000}) {
+    TESTASSERT(run_benchmark(collect_mode::blocking, period_ms) == SRSRAN_SUCCESS);
+    TESTASSERT(run_benchmark(collect_mode::snapshot, period_ms) == SRSRAN_SUCCESS);
+  }
+  return SRSRAN_SUCCESS;
+}
@@ -335,6 +335,7 @@ private:
   std::queue<tti_sr_info_t>  tti_sr_info_queue;
   std::queue<tti_cqi_info_t> tti_cqi_info_queue;
   std::vector<uint32_t>      active_cell_list;
+  bool                       check_ul_crc = true;
 
   uint32_t              nof_locations[SRSRAN_NOF_SF_X_FRAME]                           = {};
   srsran_dci_location_t dci_locations[SRSRAN_NOF_SF_X_FRAME][SRSRAN_MAX_CANDIDATES_UE] = {};
@@ -719,6 +720,11 @@ public:
     return SRSRAN_SUCCESS;
   }
   void set_sched_dl_tti_mask(uint8_t* tti_mask, uint32_t nof_sfs) override { notify_set_sched_dl_tti_mask(); }
+  void set_check_ul_crc(bool enable)
+  {
+    std::lock_guard<std::mutex> lock(phy_mac_mutex);
+    check_ul_crc = enable;
+  }
   void tti_clock() { notify_tti_clock(); }
   int  run_tti(bool enable_assert)
   {
@@ -754,7 +760,7 @@ public:
       if (enable_assert) {
         TESTASSERT(tti_ul_sched.tti == tti_ul_ack.tti);
         TESTASSERT(tti_ul_sched.cc_idx == tti_ul_ack.cc_idx);
-        TESTASSERT(tti_ul_sched.crc == tti_ul_ack.crc);
+        TESTASSERT(not check_ul_crc or tti_ul_sched.crc == tti_ul_ack.crc);
       }
 
       tti_ul_info_sched_queue.pop();
@@ -1175,6 +1181,8 @@ public:
     uint32_t              period_pcell_rotate = 0;
     srsran_tm_t           tm                  = SRSRAN_TM1;
     bool                  extended_cp         = false;
+    uint32_t              nof_cc_threads      = 0;
+    std::string           pusch_overload      = "none"; ///< PUSCH overload control action forced on every TB
     args_t()
     {
       cell.nof_prb   = 6;
@@ -1222,6 +1230,13 @@ private:
   srsenb::phy_cfg_t                                 phy_cfg  = {};   ///< eNb Cell/Carrier configuration
   srsenb::phy_interface_rrc_lte::phy_rrc_cfg_list_t phy_rrc_cfg; ///< UE PHY configuration
 
+  // Short metrics periods, so that the PUSCH overload counters are published several times during the test
+  static const uint32_t        metrics_period_ms = 10;
+  srsran::metrics_period_clock metrics_clock{metrics_period_ms};
+  uint64_t                     last_metrics_period = 0;
+  int                          nof_reduced_its     = 0;
+  int                          nof_nacks           = 0;
+
   uint64_t tti_counter = 0;
   typedef enum {
     change_state_assert = 0,
@@ -1242,7 +1257,18 @@ public:
 
     // PHY arguments
     phy_args.log.phy_level   = args.log_level;
-    phy_args.nof_phy_threads = 1; ///< Set number of phy threads to 1 for avoiding concurrency issues
+    phy_args.nof_phy_threads    = 1; ///< Set number of phy threads to 1 for avoiding concurrency issues
+    phy_args.nof_phy_cc_threads = args.nof_cc_threads;
+    if (args.pusch_overload == "reduce") {
+      // The budget is never exceeded and the iterations are reduced from the start of the TTI
+      phy_args.pusch_budget_us    = 1000000;
+      phy_args.pusch_overload_pct = 0;
+      phy_args.pusch_overload_its = 2;
+    } else if (args.pusch_overload == "nack") {
+      // The budget is exceeded before the first TB is decoded
+      phy_args.pusch_budget_us = 1;
+    }
+    phy_args.metrics_period_ms = metrics_period_ms;
 
     // Create cell configuration
     phy_cfg.phy_cell_cfg.resize(args.nof_enb_cells);
@@ -1334,6 +1360,9 @@ public:
 
     /// Create Dummy Stack instance
     stack = unique_dummy_stack_t(new dummy_stack(phy_cfg, phy_rrc_cfg, args.log_level, args.rnti));
+
+    // The PUSCH overload control NACKs TBs, UCI must still match. TBs decoded with reduced iterations must still pass
+    stack->set_check_ul_crc(args.pusch_overload != "nack");
     stack->set_active_cell_list(args.ue_cell_list);
 
     /// Initiate eNb PHY with the given RNTI
@@ -1359,14 +1388,52 @@ public:
     enb_phy->stop();
   }
 
+  /// Checks that the PUSCH overload control has degraded the decoding, if it was enabled
+  int check_pusch_overload()
+  {
+    if (args.pusch_overload == "none") {
+      return SRSRAN_SUCCESS;
+    }
+
+    logger.info("PUSCH overload: %d TBs with reduced iterations, %d TBs NACKed", nof_reduced_its, nof_nacks);
+
+    if (args.pusch_overload == "reduce") {
+      TESTASSERT(nof_reduced_its > 0 and nof_nacks == 0);
+    } else {
+      TESTASSERT(nof_nacks > 0);
+    }
+    return SRSRAN_SUCCESS;
+  }
+
   virtual ~phy_test_bench() = default;
 
+  /// Adds up the PUSCH overload counters of the metrics periods published so far
+  void collect_pusch_overload()
+  {
+    uint64_t period = metrics_clock.last_closed(std::chrono::milliseconds(0));
+    if (period == last_metrics_period) {
+      return;
+    }
+
+    // Retried on the next TTI if the workers have not published the period yet
+    std::vector<srsenb::phy_metrics_t> metrics;
+    if (not enb_phy->get_metrics(metrics, period)) {
+      return;
+    }
+    last_metrics_period = period;
+    for (const srsenb::phy_metrics_t& m : metrics) {
+      nof_reduced_its += m.ul.n_overload_reduced_its;
+      nof_nacks += m.ul.n_overload_nacks;
+    }
+  }
+
   int run_tti()
   {
     int ret = SRSRAN_SUCCESS;
 
     TESTASSERT(ue_phy->run_tti() >= SRSRAN_SUCCESS);
     TESTASSERT(stack->run_tti(change_state == change_state_assert) >= SRSRAN_SUCCESS);
+    collect_pusch_overload();
 
     // Change state FSM
     switch (change_state) {
@@ -1462,6 +1529,8 @@ int parse_args(int argc, char** argv, phy_test_bench::args_t& args)
       ("cell.cp",        bpo::value<bool>(&args.extended_cp)->default_value(false),                      "use extended CP")
       ("tm", bpo::value<uint32_t>(&args.tm_u32)->default_value(args.tm_u32),                             "Transmission mode")
       ("rotation", bpo::value<uint32_t>(&args.period_pcell_rotate),                      "Serving cells rotation period in ms, set to zero to disable")
+      ("nof_cc_threads", bpo::value<uint32_t>(&args.nof_cc_threads),                    "Number of threads processing the carriers in parallel, set to zero for serial processing")
+      ("pusch_overload", bpo::value<std::string>(&args.pusch_overload),                "PUSCH overload control action forced on every TB: none, reduce (fewer decoder iterations) or nack")
       ;
   options.add(common).add_options()("help", "Show this message");
   // clang-format on
@@ -1524,6 +1593,10 @@ int main(int argc, char** argv)
     err_code = test_bench->run_tti();
   }
 
+  if (err_code >= SRSRAN_SUCCESS) {
+    err_code = test_bench->check_pusch_overload();
+  }
+
   test_bench->stop();
 
   srslog::flush();
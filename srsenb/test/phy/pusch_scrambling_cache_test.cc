@@ -0,0 +1,320 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsenb/hdr/phy/lte/pusch_scrambling_cache.h"
+#include "srsran/common/test_common.h"
+#include "srsran/srsran.h"
+#include <algorithm>
+#include <chrono>
+#include <getopt.h>
+#include <random>
+
+using namespace srsenb::lte;
+
+static uint32_t nof_prb    = 100;
+static uint32_t nof_ues    = 32;
+static uint32_t nof_ttis   = 1000;
+static uint32_t nof_grants = 8;
+static uint32_t budget_kb  = 1024;
+static bool     llr_8bit   = false;
+
+static std::mt19937 rand_gen(0);
+
+/// Checks a cached sequence against the one generated on the fly
+static int check_sequence(const srsran_pusch_scrambling_t& seq, uint16_t rnti, uint32_t sf_idx, uint32_t len)
+{
+  std::vector<int8_t>  c_char(len, 1);
+  std::vector<int16_t> c_short(len, 1);
+  srsran_sequence_pusch_apply_c(c_char.data(), c_char.data(), rnti, 2 * sf_idx, 1, len);
+  srsran_sequence_pusch_apply_s(c_short.data(), c_short.data(), rnti, 2 * sf_idx, 1, len);
+
+  TESTASSERT(seq.len >= len);
+  TESTASSERT(memcmp(seq.c_char, c_char.data(), len * sizeof(int8_t)) == 0);
+  if (seq.c_short != nullptr) {
+    TESTASSERT(memcmp(seq.c_short, c_short.data(), len * sizeof(int16_t)) == 0);
+  }
+  return SRSRAN_SUCCESS;
+}
+
+int test_cache(bool llr_is_8bit)
+{
+  uint32_t max_bits     = 6 * SRSRAN_NRE * 2 * (SRSRAN_CP_NORM_NSYMB - 1) * 6;
+  uint32_t scratch_size = max_bits * (llr_is_8bit ? 1 : 3);
+  uint32_t share        = 16 * SRSRAN_CEIL(max_bits / 16, 8);
+
+  // A third of the budget per class, one full-band slot, 4 slots of a quarter of it and 16 of a sixteenth, holding
+  // packed bits, plus the scratch buffer where they are unpacked
+  pusch_scrambling_cache cache;
+  TESTASSERT(cache.init(3 * share, 1, 6, llr_is_8bit));
+  TESTASSERT(cache.nof_classes() == 3);
+  TESTASSERT(cache.class_max_bits(0) == max_bits);
+  TESTASSERT(cache.class_max_bits(1) == max_bits / 4);
+  TESTASSERT(cache.class_max_bits(2) == max_bits / 16);
+  TESTASSERT(cache.nof_slots() == 1 + 4 + 16);
+  TESTASSERT(cache.nof_bytes() == max_bits / 8 + 4 * (max_bits / 32) + share + scratch_size);
+
+  pusch_scrambling_cache::ue_slots_t ue1, ue2, ue3;
+  pusch_scrambling_cache::reset_ue(ue1);
+  pusch_scrambling_cache::reset_ue(ue2);
+  pusch_scrambling_cache::reset_ue(ue3);
+
+  // Generated on first use in the smallest slot and extended by a longer grant
+  srsran_pusch_scrambling_t seq = cache.get(ue1, 0x46, 3, 100);
+  TESTASSERT(check_sequence(seq, 0x46, 3, 100) == SRSRAN_SUCCESS);
+  TESTASSERT((llr_is_8bit and seq.c_short == nullptr) or (not llr_is_8bit and seq.c_short != nullptr));
+  int32_t small_slot = ue1[3];
+  seq                = cache.get(ue1, 0x46, 3, max_bits / 16);
+  TESTASSERT(check_sequence(seq, 0x46, 3, max_bits / 16) == SRSRAN_SUCCESS);
+  TESTASSERT(ue1[3] == small_slot);
+  TESTASSERT(cache.nof_free_slots() == 20);
+
+  // Moved to a larger slot when the grant does not fit
+  seq = cache.get(ue1, 0x46, 3, max_bits);
+  TESTASSERT(check_sequence(seq, 0x46, 3, max_bits) == SRSRAN_SUCCESS);
+  TESTASSERT(ue1[3] != small_slot);
+  int32_t large_slot = ue1[3];
+  seq                = cache.get(ue1, 0x46, 3, 50);
+  TESTASSERT(check_sequence(seq, 0x46, 3, 50) == SRSRAN_SUCCESS);
+  TESTASSERT(ue1[3] == large_slot);
+  TESTASSERT(cache.nof_free_slots() == 20);
+
+  // Unpacked sequences of any length match the generated ones, past the vectorised part too
+  for (uint32_t len = 1; len < 40; len++) {
+    seq = cache.get(ue1, 0x46, 3, len);
+    TESTASSERT(check_sequence(seq, 0x46, 3, len) == SRSRAN_SUCCESS);
+  }
+
+  // Grants larger than the cell are not cached
+  seq = cache.get(ue1, 0x46, 4, max_bits + 1);
+  TESTASSERT(seq.len == 0);
+
+  // The full-band slot is taken back for another full-band grant, once it has not been used for a round
+  TESTASSERT(cache.get(ue2, 0x47, 4, max_bits).len == 0);
+  TESTASSERT(ue1[3] >= 0);
+  seq = cache.get(ue2, 0x47, 4, max_bits);
+  TESTASSERT(check_sequence(seq, 0x47, 4, max_bits) == SRSRAN_SUCCESS);
+  TESTASSERT(ue1[3] < 0);
+
+  // Small grants use larger slots once their class is full
+  for (uint32_t sf_idx = 0; sf_idx < SRSRAN_NOF_SF_X_FRAME; sf_idx++) {
+    TESTASSERT(cache.get(ue1, 0x46, sf_idx, 100).len >= 100);
+  }
+  for (uint32_t sf_idx = 0; sf_idx < 6; sf_idx++) {
+    TESTASSERT(cache.get(ue3, 0x48, sf_idx, 100).len >= 100);
+  }
+  TESTASSERT(cache.nof_free_slots() == 4);
+  for (uint32_t sf_idx = 6; sf_idx < SRSRAN_NOF_SF_X_FRAME; sf_idx++) {
+    seq = cache.get(ue3, 0x48, sf_idx, 100);
+    TESTASSERT(check_sequence(seq, 0x48, sf_idx, 100) == SRSRAN_SUCCESS);
+  }
+  TESTASSERT(cache.nof_free_slots() == 0);
+
+  // Slots are taken back from the smallest class fitting the grant when the cache is full, after a round over the
+  // slots of the class clearing their use
+  uint32_t nof_tries = 1;
+  while ((seq = cache.get(ue2, 0x47, 5, 300)).len == 0 and nof_tries <= 16) {
+    nof_tries++;
+  }
+  TESTASSERT(nof_tries == 17);
+  TESTASSERT(check_sequence(seq, 0x47, 5, 300) == SRSRAN_SUCCESS);
+  TESTASSERT(ue2[4] >= 0);
+  TESTASSERT(ue1[0] < 0);
+
+  // Releasing a UE frees its slots
+  cache.release(ue2);
+  TESTASSERT(ue2[4] < 0 and ue2[5] < 0);
+  TESTASSERT(cache.nof_free_slots() == 2);
+  seq = cache.get(ue2, 0x49, 4, 400);
+  TESTASSERT(check_sequence(seq, 0x49, 4, 400) == SRSRAN_SUCCESS);
+
+  cache.clear();
+  TESTASSERT(cache.nof_free_slots() == cache.nof_slots());
+
+  // Without budget nothing is cached
+  pusch_scrambling_cache empty_cache;
+  TESTASSERT(empty_cache.init(0, 1, 6, llr_is_8bit));
+  TESTASSERT(empty_cache.get(ue1, 0x46, 0, 100).len == 0);
+  TESTASSERT(empty_cache.nof_bytes() == 0);
+
+  return SRSRAN_SUCCESS;
+}
+
+/// Measures the PUSCH descrambling of nof_grants grants per TTI, picked among nof_ues UEs, with and without cache.
+/// The grants share the cell bandwidth, and the descrambling follows the PUSCH decoder for the LLR width in use.
+int run_benchmark()
+{
+  uint32_t max_bits = nof_prb * SRSRAN_NRE * 2 * (SRSRAN_CP_NORM_NSYMB - 1) * 6;
+
+  pusch_scrambling_cache cache;
+  TESTASSERT(cache.init(budget_kb * 1024, 1, nof_prb, llr_8bit));
+  std::vector<pusch_scrambling_cache::ue_slots_t> ue_slots(nof_ues);
+  for (auto& s : ue_slots) {
+    pusch_scrambling_cache::reset_ue(s);
+  }
+
+  int16_t* llr_ref = srsran_vec_i16_malloc(max_bits);
+  int16_t* llr_s   = srsran_vec_i16_malloc(max_bits);
+  int8_t*  llr_b   = srsran_vec_i8_malloc(max_bits);
+  uint8_t* c       = srsran_vec_u8_malloc(max_bits);
+  TESTASSERT(llr_ref != nullptr and llr_s != nullptr and llr_b != nullptr and c != nullptr);
+  for (uint32_t i = 0; i < max_bits; i++) {
+    llr_ref[i] = (int16_t)(rand_gen() % 255 - 127);
+  }
+
+  // Descrambles the LLR of a grant like the PUSCH decoder, with the cached sequence if there is one
+  auto descramble = [&](const srsran_pusch_scrambling_t* seq, uint16_t rnti, uint32_t sf_idx, uint32_t nof_bits) {
+    if (seq != nullptr and seq->len >= nof_bits) {
+      if (llr_8bit) {
+        srsran_vec_neg_bbb(llr_b, seq->c_char, llr_b, nof_bits);
+      } else {
+        srsran_vec_neg_sss(llr_s, seq->c_short, llr_s, nof_bits);
+      }
+      return;
+    }
+    if (llr_8bit) {
+      srsran_sequence_pusch_apply_c(llr_b, llr_b, rnti, 2 * sf_idx, 1, nof_bits);
+    } else {
+      srsran_sequence_pusch_apply_s(llr_s, llr_s, rnti, 2 * sf_idx, 1, nof_bits);
+    }
+    srsran_sequence_pusch_gen_unpack(c, rnti, 2 * sf_idx, 1, nof_bits);
+  };
+  auto load_llr = [&](uint32_t nof_bits) {
+    for (uint32_t i = 0; i < nof_bits; i++) {
+      llr_s[i] = llr_ref[i];
+      llr_b[i] = (int8_t)llr_ref[i];
+    }
+  };
+
+  std::chrono::nanoseconds time_on_the_fly{0}, time_cached{0};
+  uint32_t                 nof_reused    = 0;
+  uint32_t                 max_grant_prb = SRSRAN_MIN(nof_prb, SRSRAN_MAX(1, 2 * nof_prb / nof_grants));
+  std::vector<int16_t>     expected_s(max_bits);
+  std::vector<int8_t>      expected_b(max_bits);
+  for (uint32_t tti = 0; tti < nof_ttis; tti++) {
+    uint32_t sf_idx = tti % SRSRAN_NOF_SF_X_FRAME;
+    for (uint32_t g = 0; g < nof_grants; g++) {
+      uint32_t ue_idx = rand_gen() % nof_ues;
+      uint16_t rnti   = 0x46 + ue_idx;
+      uint32_t L_prb  = 1 + rand_gen() % max_grant_prb;
+      while (not srsran_dft_precoding_valid_prb(L_prb)) {
+        L_prb--;
+      }
+      uint32_t nof_bits = L_prb * SRSRAN_NRE * 2 * (SRSRAN_CP_NORM_NSYMB - 1) * (2 + 2 * (rand_gen() % 3));
+
+      // Sequence generated for the grant, as decoded without cache
+      load_llr(nof_bits);
+      auto t0 = std::chrono::steady_clock::now();
+      descramble(nullptr, rnti, sf_idx, nof_bits);
+      auto t1 = std::chrono::steady_clock::now();
+      std::copy(llr_s, llr_s + nof_bits, expected_s.begin());
+      std::copy(llr_b, llr_b + nof_bits, expected_b.begin());
+
+      // Cached sequence, reused if the UE kept its slot
+      int32_t slot = ue_slots[ue_idx][sf_idx];
+      load_llr(nof_bits);
+      auto                      t2  = std::chrono::steady_clock::now();
+      srsran_pusch_scrambling_t seq = cache.get(ue_slots[ue_idx], rnti, sf_idx, nof_bits);
+      descramble(&seq, rnti, sf_idx, nof_bits);
+      auto t3 = std::chrono::steady_clock::now();
+      if (llr_8bit) {
+        TESTASSERT(memcmp(llr_b, expected_b.data(), nof_bits * sizeof(int8_t)) == 0);
+      } else {
+        TESTASSERT(memcmp(llr_s, expected_s.data(), nof_bits * sizeof(int16_t)) == 0);
+      }
+
+      nof_reused += (slot >= 0 and ue_slots[ue_idx][sf_idx] == slot) ? 1 : 0;
+      time_on_the_fly += t1 - t0;
+      time_cached += t3 - t2;
+    }
+  }
+
+  uint32_t total = nof_ttis * nof_grants;
+  printf("%d PRB, %d-bit LLR, %d kB: %d UEs, %d grants: on the fly %.2f us/grant, cached %.2f us/grant "
+         "(%.1f%% reused a cached sequence, %d slots)\n",
+         nof_prb,
+         llr_8bit ? 8 : 16,
+         budget_kb,
+         nof_ues,
+         total,
+         time_on_the_fly.count() / 1000.0 / total,
+         time_cached.count() / 1000.0 / total,
+         100.0 * nof_reused / total,
+         cache.nof_slots());
+
+  free(llr_ref);
+  free(llr_s);
+  free(llr_b);
+  free(c);
+  return SRSRAN_SUCCESS;
+}
+
+void usage(char* prog)
+{
+  printf("Usage: %s [pugtmb]\n", prog);
+  printf("\t-p Number of cell PRB [Default %d]\n", nof_prb);
+  printf("\t-u Number of UEs [Default %d]\n", nof_ues);
+  printf("\t-g Number of grants per TTI [Default %d]\n", nof_grants);
+  printf("\t-t Number of TTIs [Default %d]\n", nof_ttis);
+  printf("\t-m Cache memory budget in kB [Default %d]\n", budget_kb);
+  printf("\t-b Use 8-bit LLR [Default %s]\n", llr_8bit ? "true" : "false");
+}
+
+void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "pugtmb")) != -1) {
+    switch (opt) {
+      case 'p':
+        nof_prb = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'u':
+        nof_ues = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'g':
+        nof_grants = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 't':
+        nof_ttis = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'm':
+        budget_kb = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'b':
+        llr_8bit = true;
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+
+  TESTASSERT(test_cache(true) == SRSRAN_SUCCESS);
+  TESTASSERT(test_cache(false) == SRSRAN_SUCCESS);
+  TESTASSERT(run_benchmark() == SRSRAN_SUCCESS);
+
+  printf("Success\n");
+  return SRSRAN_SUCCESS;
+}
@@ -0,0 +1,151 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsenb/hdr/phy/lte/ul_dmrs_tables.h"
+#include "srsran/common/test_common.h"
+#include "srsran/srsran.h"
+#include <thread>
+
+using namespace srsenb::lte;
+
+static srsran_cell_t make_cell(uint32_t id, uint32_t nof_prb)
+{
+  srsran_cell_t cell = {};
+  cell.id            = id;
+  cell.nof_prb       = nof_prb;
+  cell.nof_ports     = 1;
+  cell.cp            = SRSRAN_CP_NORM;
+  return cell;
+}
+
+/// Checks a shared table against the DMRS generated on the fly
+static int check_table(const ul_dmrs_pregen& table, const srsran_cell_t& cell, srsran_refsignal_dmrs_pusch_cfg_t cfg)
+{
+  srsran_refsignal_ul_t signal = {};
+  TESTASSERT_SUCCESS(srsran_refsignal_ul_set_cell(&signal, cell));
+
+  std::vector<cf_t> r(2 * SRSRAN_NRE * cell.nof_prb);
+  for (uint32_t sf_idx = 0; sf_idx < SRSRAN_NOF_SF_X_FRAME; sf_idx++) {
+    for (uint32_t cs = 0; cs < SRSRAN_NOF_CSHIFT; cs++) {
+      for (uint32_t n = 1; n <= cell.nof_prb; n++) {
+        if (srsran_dft_precoding_valid_prb(n)) {
+          TESTASSERT_SUCCESS(srsran_refsignal_dmrs_pusch_gen(&signal, &cfg, n, sf_idx, cs, r.data()));
+          TESTASSERT(memcmp(table.get()->r[cs][sf_idx][n], r.data(), 2 * SRSRAN_NRE * n * sizeof(cf_t)) == 0);
+        }
+      }
+    }
+  }
+  return SRSRAN_SUCCESS;
+}
+
+int test_sharing()
+{
+  ul_dmrs_tables                    tables;
+  srsran_refsignal_dmrs_pusch_cfg_t cfg = {};
+  cfg.group_hopping_en                  = true;
+  cfg.delta_ss                          = 3;
+  srsran_cell_t cell1                   = make_cell(1, 25);
+  srsran_cell_t cell2                   = make_cell(2, 25);
+
+  // Workers of the same cell get the same table
+  std::shared_ptr<const ul_dmrs_pregen> t1 = tables.get(cell1, cfg);
+  std::shared_ptr<const ul_dmrs_pregen> t2 = tables.get(cell1, cfg);
+  TESTASSERT(t1 != nullptr and t1 == t2);
+  TESTASSERT(check_table(*t1, cell1, cfg) == SRSRAN_SUCCESS);
+  TESTASSERT_EQ(1U, tables.nof_tables());
+  TESTASSERT_EQ((uint64_t)t1->nof_bytes(), tables.nof_bytes());
+
+  // Other cells or DMRS configurations get their own
+  std::shared_ptr<const ul_dmrs_pregen> t3 = tables.get(cell2, cfg);
+  TESTASSERT(t3 != nullptr and t3 != t1);
+  TESTASSERT(check_table(*t3, cell2, cfg) == SRSRAN_SUCCESS);
+  srsran_refsignal_dmrs_pusch_cfg_t cfg2 = cfg;
+  cfg2.group_hopping_en                  = false;
+  std::shared_ptr<const ul_dmrs_pregen> t4 = tables.get(cell1, cfg2);
+  TESTASSERT(t4 != nullptr and t4 != t1);
+  TESTASSERT(check_table(*t4, cell1, cfg2) == SRSRAN_SUCCESS);
+  TESTASSERT_EQ(3U, tables.nof_tables());
+
+  // A table is freed with its last user
+  t1.reset();
+  TESTASSERT_EQ(3U, tables.nof_tables());
+  t2.reset();
+  TESTASSERT_EQ(2U, tables.nof_tables());
+  t1 = tables.get(cell1, cfg);
+  TESTASSERT(check_table(*t1, cell1, cfg) == SRSRAN_SUCCESS);
+  TESTASSERT_EQ(3U, tables.nof_tables());
+
+  return SRSRAN_SUCCESS;
+}
+
+int test_concurrent_workers()
+{
+  ul_dmrs_tables                    tables;
+  srsran_refsignal_dmrs_pusch_cfg_t cfg  = {};
+  srsran_cell_t                     cell = make_cell(7, 100);
+
+  // Workers initialised in parallel end up with a single table
+  std::vector<std::shared_ptr<const ul_dmrs_pregen> > worker_tables(8);
+  std::vector<std::thread>                           threads;
+  for (auto& t : worker_tables) {
+    threads.emplace_back([&tables, &t, &cell, &cfg]() { t = tables.get(cell, cfg); });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  for (auto& t : worker_tables) {
+    TESTASSERT(t != nullptr and t == worker_tables[0]);
+  }
+  TESTASSERT_EQ(1U, tables.nof_tables());
+  printf("%zd workers share %.1f MB of UL DMRS for a %d PRB cell\n",
+         worker_tables.size(),
+         tables.nof_bytes() / 1e6,
+         cell.nof_prb);
+
+  // Workers of two cells initialised in parallel get the table of their own cell
+  srsran_cell_t cell2 = make_cell(8, 50);
+  worker_tables.assign(8, nullptr);
+  threads.clear();
+  for (uint32_t i = 0; i < worker_tables.size(); ++i) {
+    const srsran_cell_t& c = i % 2 == 0 ? cell : cell2;
+    threads.emplace_back([&tables, &worker_tables, i, &c, &cfg]() { worker_tables[i] = tables.get(c, cfg); });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  for (uint32_t i = 0; i < worker_tables.size(); ++i) {
+    TESTASSERT(worker_tables[i] != nullptr and worker_tables[i] == worker_tables[i % 2]);
+  }
+  TESTASSERT(worker_tables[0] != worker_tables[1]);
+  TESTASSERT(check_table(*worker_tables[1], cell2, cfg) == SRSRAN_SUCCESS);
+  TESTASSERT_EQ(2U, tables.nof_tables());
+
+  return SRSRAN_SUCCESS;
+}
+
+int main()
+{
+  TESTASSERT(test_sharing() == SRSRAN_SUCCESS);
+  TESTASSERT(test_concurrent_workers() == SRSRAN_SUCCESS);
+
+  printf("Success\n");
+  return SRSRAN_SUCCESS;
+}
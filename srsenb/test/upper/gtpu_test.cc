@@ -215,6 +215,113 @@ void test_gtpu_tunnel_manager()
   TESTASSERT(after_tun->state == gtpu_tunnel_manager::tunnel_state::pdcp_active);
 }
 
+void test_gtpu_sdu_buffer()
+{
+  gtpu_sdu_buffer       buffer;
+  std::vector<uint32_t> sent_sns, read_sns;
+
+  // SDUs without PDCP SN are read last, in arrival order
+  for (uint32_t i = 0; i < 3; ++i) {
+    srsran::unique_byte_buffer_t sdu = srsran::make_byte_buffer();
+    sdu->N_bytes                     = 1000 + i;
+    TESTASSERT(buffer.push(gtpu_sdu_buffer::undefined_pdcp_sn, std::move(sdu)));
+  }
+
+  // More SDUs than the previous fixed-size buffer, out of order and wrapping around the SN space
+  const uint32_t nof_sdus = 3000, first_sn = 65000;
+  for (uint32_t i = 0; i < nof_sdus; ++i) {
+    sent_sns.push_back((first_sn + i) % 65536);
+  }
+  std::swap(sent_sns[0], sent_sns[5]);
+  std::swap(sent_sns[100], sent_sns[2000]);
+  std::swap(sent_sns[535], sent_sns[537]);
+  for (uint32_t sn : sent_sns) {
+    srsran::unique_byte_buffer_t sdu = srsran::make_byte_buffer();
+    sdu->N_bytes                     = sn % 1000;
+    TESTASSERT(buffer.push(sn, std::move(sdu)));
+  }
+  // Repeated SN is discarded
+  TESTASSERT(not buffer.push(first_sn + 10, srsran::make_byte_buffer()));
+  TESTASSERT(buffer.size() == nof_sdus + 3);
+
+  uint32_t nof_no_sn = 0;
+  buffer.flush([&](uint32_t sn, srsran::unique_byte_buffer_t sdu) {
+    if (sn == gtpu_sdu_buffer::undefined_pdcp_sn) {
+      TESTASSERT(sdu->N_bytes == 1000 + nof_no_sn);
+      nof_no_sn++;
+      return;
+    }
+    TESTASSERT(nof_no_sn == 0);
+    TESTASSERT(sdu->N_bytes == sn % 1000);
+    read_sns.push_back(sn);
+  });
+  TESTASSERT(nof_no_sn == 3);
+  TESTASSERT(read_sns.size() == nof_sdus);
+  for (uint32_t i = 0; i < nof_sdus; ++i) {
+    TESTASSERT(read_sns[i] == (first_sn + i) % 65536);
+  }
+  TESTASSERT(buffer.empty());
+
+  // An SN behind the first buffered one is still read before it
+  TESTASSERT(buffer.push(10, srsran::make_byte_buffer()));
+  TESTASSERT(buffer.push(4, srsran::make_byte_buffer()));
+  read_sns.clear();
+  buffer.flush([&read_sns](uint32_t sn, srsran::unique_byte_buffer_t sdu) { read_sns.push_back(sn); });
+  TESTASSERT(read_sns == std::vector<uint32_t>({4, 10}));
+}
+
+void test_gtpu_sdu_buffer_max_sdus()
+{
+  gtpu_sdu_buffer buffer(0, 4);
+
+  // SDUs above the cap of the bearer are discarded, with or without PDCP SN
+  for (uint32_t sn = 0; sn < 3; ++sn) {
+    TESTASSERT(buffer.push(sn, srsran::make_byte_buffer()));
+  }
+  TESTASSERT(not buffer.full());
+  TESTASSERT(buffer.push(gtpu_sdu_buffer::undefined_pdcp_sn, srsran::make_byte_buffer()));
+  TESTASSERT(buffer.full());
+  TESTASSERT(not buffer.push(3, srsran::make_byte_buffer()));
+  TESTASSERT(not buffer.push(gtpu_sdu_buffer::undefined_pdcp_sn, srsran::make_byte_buffer()));
+  TESTASSERT(buffer.size() == 4);
+
+  // Flushing frees the room again
+  uint32_t nof_read = 0;
+  buffer.flush([&nof_read](uint32_t sn, srsran::unique_byte_buffer_t sdu) { nof_read++; });
+  TESTASSERT(nof_read == 4);
+  TESTASSERT(buffer.push(3, srsran::make_byte_buffer()));
+}
+
+void test_gtpu_sdu_buffer_12bit_sn()
+{
+  gtpu_sdu_buffer       buffer(srsran::PDCP_SN_LEN_12);
+  std::vector<uint32_t> sent_sns, read_sns;
+
+  // The SNs of a bearer with 12-bit PDCP SNs wrap from 4095 to 0
+  const uint32_t nof_sdus = 20, first_sn = 4085;
+  for (uint32_t i = 0; i < nof_sdus; ++i) {
+    sent_sns.push_back((first_sn + i) % 4096);
+  }
+  std::swap(sent_sns[9], sent_sns[12]);
+  for (uint32_t sn : sent_sns) {
+    srsran::unique_byte_buffer_t sdu = srsran::make_byte_buffer();
+    sdu->N_bytes                     = sn % 1000;
+    TESTASSERT(buffer.push(sn, std::move(sdu)));
+  }
+  // SNs out of the 12-bit range are discarded
+  TESTASSERT(not buffer.push(4096, srsran::make_byte_buffer()));
+  TESTASSERT(buffer.size() == nof_sdus);
+
+  buffer.flush([&read_sns](uint32_t sn, srsran::unique_byte_buffer_t sdu) {
+    TESTASSERT(sdu->N_bytes == sn % 1000);
+    read_sns.push_back(sn);
+  });
+  TESTASSERT(read_sns.size() == nof_sdus);
+  for (uint32_t i = 0; i < nof_sdus; ++i) {
+    TESTASSERT(read_sns[i] == (first_sn + i) % 4096);
+  }
+}
+
 enum class tunnel_test_event { success, wait_end_marker_timeout, ue_removal_no_marker, reest_senb };
 
 int test_gtpu_direct_tunneling(tunnel_test_event event)
@@ -395,6 +502,9 @@ int main(int argc, char** argv)
   srsran::test_init(argc, argv);
 
   srsenb::test_gtpu_tunnel_manager();
+  srsenb::test_gtpu_sdu_buffer();
+  srsenb::test_gtpu_sdu_buffer_12bit_sn();
+  srsenb::test_gtpu_sdu_buffer_max_sdus();
   TESTASSERT(srsenb::test_gtpu_direct_tunneling(srsenb::tunnel_test_event::success) == SRSRAN_SUCCESS);
   TESTASSERT(srsenb::test_gtpu_direct_tunneling(srsenb::tunnel_test_event::wait_end_marker_timeout) == SRSRAN_SUCCESS);
   TESTASSERT(srsenb::test_gtpu_direct_tunneling(srsenb::tunnel_test_event::ue_removal_no_marker) == SRSRAN_SUCCESS);
@@ -34,11 +34,18 @@
 #include "srsran/srslog/srslog.h"
 #include "srsran/srsran.h"
 #include <cstddef>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unordered_map>
+#include <vector>
 
 namespace srsepc {
 
 const uint16_t GTPU_RX_PORT = 2152;
 
+// Maximum number of SGi-mb packets read before they are sent together on M1-U
+const uint32_t MBMS_GW_BATCH_SIZE = 32;
+
 typedef struct {
   std::string name;
   std::string sgi_mb_if_name;
@@ -47,8 +54,79 @@ typedef struct {
   std::string m1u_multi_addr;
   std::string m1u_multi_if;
   int         m1u_multi_ttl;
+  // MBMS sessions, each one as "tmgi,dst_addr[/prefix_len],teid[,m1u_multi_addr]"
+  std::vector<std::string> sessions;
 } mbms_gw_args_t;
 
+// MBMS session, fed by the SGi-mb packets sent to its destination address or prefix
+typedef struct {
+  std::string        tmgi;
+  uint32_t           dst_addr; // Host byte order
+  uint32_t           dst_mask; // Host byte order
+  uint32_t           teid;
+  struct sockaddr_in m1u_addr;
+  uint64_t           rx_pkts;
+  uint64_t           rx_bytes;
+  uint64_t           tx_pkts;
+  uint64_t           tx_bytes;
+  uint64_t           tx_errors;
+} mbms_gw_session_t;
+
+// Gateway counters, logged with the per-session ones
+typedef struct {
+  uint64_t rx_dropped;   // SGi-mb packets dropped as malformed, not IPv4 or without session
+  uint64_t nof_batches;  // Batches sent on M1-U
+  uint64_t nof_sendmmsg; // sendmmsg() calls, more than one per batch if a call sends part of it
+} mbms_gw_metrics_t;
+
+// MBMS sessions, looked up by exact destination address first and then by longest prefix
+class mbms_gw_sessions
+{
+public:
+  explicit mbms_gw_sessions(srslog::basic_logger& logger_) : logger(logger_) {}
+
+  void clear();
+  // Parses "tmgi,dst_addr[/prefix_len],teid[,m1u_multi_addr]", sending to default_m1u_addr if no address is given
+  int add(const std::string& session_str, const struct sockaddr_in& default_m1u_addr);
+  // Session of a destination address in host byte order, size() if there is none
+  uint32_t find(uint32_t dst_addr) const;
+
+  uint32_t                 size() const { return sessions.size(); }
+  mbms_gw_session_t&       operator[](uint32_t idx) { return sessions[idx]; }
+  const mbms_gw_session_t& operator[](uint32_t idx) const { return sessions[idx]; }
+
+private:
+  srslog::basic_logger&                  logger;
+  std::vector<mbms_gw_session_t>         sessions;
+  std::unordered_map<uint32_t, uint32_t> session_by_addr;
+  std::vector<uint32_t>                  session_by_prefix;
+};
+
+// Batch of GTP-U PDUs sent on M1-U with sendmmsg()
+class mbms_gw_batch
+{
+public:
+  // Allocates the PDU buffers, returns false on failure
+  bool init();
+
+  // Buffer of the next PDU, valid while the batch is not full
+  srsran::byte_buffer_t* next_pdu() { return pdus[nof_pdus].get(); }
+  // Queues the next PDU for the M1-U group of a session
+  void     push(uint32_t session_idx, const mbms_gw_session_t& session);
+  bool     full() const { return nof_pdus == MBMS_GW_BATCH_SIZE; }
+  uint32_t size() const { return nof_pdus; }
+
+  // Sends the queued PDUs and empties the batch, updating the session and gateway counters
+  void send(int fd, mbms_gw_sessions& sessions, mbms_gw_metrics_t& metrics, srslog::basic_logger& logger);
+
+private:
+  srsran::unique_byte_buffer_t pdus[MBMS_GW_BATCH_SIZE];
+  uint32_t                     pdu_session[MBMS_GW_BATCH_SIZE];
+  struct iovec                 iov[MBMS_GW_BATCH_SIZE];
+  struct mmsghdr               hdr[MBMS_GW_BATCH_SIZE];
+  uint32_t                     nof_pdus = 0;
+};
+
 struct pseudo_hdr {
   uint32_t src_addr;
   uint32_t dst_addr;
@@ -74,7 +152,10 @@ private:
 
   int      init_sgi_mb_if(mbms_gw_args_t* args);
   int      init_m1_u(mbms_gw_args_t* args);
-  void     handle_sgi_md_pdu(srsran::byte_buffer_t* msg);
+  int      init_sessions(mbms_gw_args_t* args);
+  void     read_sgi_mb_batch();
+  bool     handle_sgi_md_pdu(srsran::byte_buffer_t* msg);
+  void     log_metrics();
   uint16_t in_cksum(uint16_t* iphdr, int count);
 
   /* Members */
@@ -87,6 +168,10 @@ private:
   bool               m_m1u_up;
   int                m_m1u;
   struct sockaddr_in m_m1u_multi_addr;
+
+  mbms_gw_sessions  m_sessions;
+  mbms_gw_batch     m_batch;
+  mbms_gw_metrics_t m_metrics;
 };
 
 } // namespace srsepc
@@ -24,6 +24,9 @@
 #include "srsran/common/network_utils.h"
 #include "srsran/upper/gtpu.h"
 #include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <climits>
 #include <fcntl.h>
 #include <iostream>
 #include <linux/if.h>
@@ -31,6 +34,8 @@
 #include <linux/ip.h>
 #include <netinet/in.h>
 #include <netinet/udp.h>
+#include <poll.h>
+#include <sstream>
 #include <sys/ioctl.h>
 #include <sys/socket.h>
 
@@ -41,7 +46,7 @@ pthread_mutex_t mbms_gw_instance_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 const uint16_t MBMS_GW_BUFFER_SIZE = 2500;
 
-mbms_gw::mbms_gw() : m_running(false), m_sgi_mb_up(false), thread("MBMS_GW")
+mbms_gw::mbms_gw() : m_running(false), m_sgi_mb_up(false), m_sessions(m_logger), m_metrics(), thread("MBMS_GW")
 {
   return;
 }
@@ -87,6 +92,12 @@ int mbms_gw::init(mbms_gw_args_t* args)
     m_logger.error("Error initializing SGi-MB.");
     return SRSRAN_ERROR_CANT_START;
   }
+  err = init_sessions(args);
+  if (err != SRSRAN_SUCCESS) {
+    srsran::console("Error initializing MBMS sessions.\n");
+    m_logger.error("Error initializing MBMS sessions.");
+    return SRSRAN_ERROR_CANT_START;
+  }
   m_logger.info("MBMS GW Initiated");
   srsran::console("MBMS GW Initiated\n");
   return SRSRAN_SUCCESS;
@@ -102,6 +113,7 @@ void mbms_gw::stop()
     m_running = false;
     thread_cancel();
     wait_thread_finish();
+    log_metrics();
   }
   return;
 }
@@ -137,6 +149,13 @@ int mbms_gw::init_sgi_mb_if(mbms_gw_args_t* args)
     m_logger.debug("Set TUN device name: %s", args->sgi_mb_if_name.c_str());
   }
 
+  // Packets are read in batches until the TUN device is empty
+  if (fcntl(m_sgi_mb_if, F_SETFL, fcntl(m_sgi_mb_if, F_GETFL) | O_NONBLOCK) < 0) {
+    m_logger.error("Failed to set TUN device non-blocking: %s", strerror(errno));
+    close(m_sgi_mb_if);
+    return SRSRAN_ERROR_CANT_START;
+  }
+
   // Bring up the interface
   int sgi_mb_sock = socket(AF_INET, SOCK_DGRAM, 0);
   if (sgi_mb_sock < 0) {
@@ -254,68 +273,290 @@ int mbms_gw::init_m1_u(mbms_gw_args_t* args)
   return SRSRAN_SUCCESS;
 }
 
+int mbms_gw::init_sessions(mbms_gw_args_t* args)
+{
+  m_sessions.clear();
+
+  // Without configured sessions, all SGi-mb traffic goes to the M1-U multicast group with the legacy TEID
+  if (args->sessions.empty()) {
+    return m_sessions.add("000001,0.0.0.0/0,0xAAAA", m_m1u_multi_addr);
+  }
+  for (const std::string& session_str : args->sessions) {
+    if (m_sessions.add(session_str, m_m1u_multi_addr) != SRSRAN_SUCCESS) {
+      return SRSRAN_ERROR;
+    }
+  }
+  return SRSRAN_SUCCESS;
+}
+
+void mbms_gw_sessions::clear()
+{
+  sessions.clear();
+  session_by_addr.clear();
+  session_by_prefix.clear();
+}
+
+int mbms_gw_sessions::add(const std::string& session_str, const struct sockaddr_in& default_m1u_addr)
+{
+  std::vector<std::string> fields;
+  std::stringstream        ss(session_str);
+  std::string              field;
+  while (std::getline(ss, field, ',')) {
+    field.erase(std::remove_if(field.begin(), field.end(), ::isspace), field.end());
+    fields.push_back(field);
+  }
+  if (fields.size() < 3 || fields.size() > 4) {
+    logger.error("Invalid MBMS session \"%s\", expected tmgi,dst_addr[/prefix_len],teid[,m1u_multi_addr]",
+                 session_str.c_str());
+    return SRSRAN_ERROR;
+  }
+
+  mbms_gw_session_t session = {};
+  session.tmgi              = fields[0];
+
+  // Destination address or prefix of the flow
+  std::string   addr_str   = fields[1];
+  unsigned long prefix_len = 32;
+  size_t        slash      = addr_str.find('/');
+  if (slash != std::string::npos) {
+    const char* prefix_str = addr_str.c_str() + slash + 1;
+    char*       prefix_end = nullptr;
+    prefix_len             = isdigit(*prefix_str) ? strtoul(prefix_str, &prefix_end, 10) : ULONG_MAX;
+    if (prefix_end == nullptr || *prefix_end != '\0') {
+      prefix_len = ULONG_MAX;
+    }
+    addr_str = addr_str.substr(0, slash);
+  }
+  struct in_addr dst_addr;
+  if (prefix_len > 32 || inet_pton(AF_INET, addr_str.c_str(), &dst_addr) != 1) {
+    logger.error("Invalid destination of MBMS session %s: %s", session.tmgi.c_str(), fields[1].c_str());
+    return SRSRAN_ERROR;
+  }
+  session.dst_mask = prefix_len == 0 ? 0 : 0xffffffff << (32 - prefix_len);
+  session.dst_addr = ntohl(dst_addr.s_addr) & session.dst_mask;
+
+  // Reject signs, which strtoul would wrap around, and TEIDs that do not fit in 32 bits
+  char*         end  = nullptr;
+  unsigned long teid = 0;
+  errno              = 0;
+  if (isdigit(fields[2][0])) {
+    teid = strtoul(fields[2].c_str(), &end, 0);
+  }
+  if (end == nullptr || *end != '\0' || errno == ERANGE || teid > UINT32_MAX) {
+    logger.error("Invalid TEID of MBMS session %s: %s", session.tmgi.c_str(), fields[2].c_str());
+    return SRSRAN_ERROR;
+  }
+  session.teid = teid;
+
+  // M1-U multicast group of the session, the default one if not given
+  session.m1u_addr = default_m1u_addr;
+  if (fields.size() == 4 && inet_pton(AF_INET, fields[3].c_str(), &session.m1u_addr.sin_addr.s_addr) != 1) {
+    logger.error("Invalid M1-U multicast address of MBMS session %s: %s", session.tmgi.c_str(), fields[3].c_str());
+    return SRSRAN_ERROR;
+  }
+
+  uint32_t idx = sessions.size();
+  if (prefix_len == 32) {
+    if (not session_by_addr.emplace(session.dst_addr, idx).second) {
+      logger.error("MBMS session %s has the same destination as another session", session.tmgi.c_str());
+      return SRSRAN_ERROR;
+    }
+  } else {
+    // Longest prefix first
+    auto it = std::find_if(session_by_prefix.begin(), session_by_prefix.end(), [this, &session](uint32_t i) {
+      return sessions[i].dst_mask < session.dst_mask;
+    });
+    session_by_prefix.insert(it, idx);
+  }
+  sessions.push_back(session);
+
+  char m1u_str[INET_ADDRSTRLEN];
+  inet_ntop(AF_INET, &session.m1u_addr.sin_addr, m1u_str, sizeof(m1u_str));
+  logger.info("Added MBMS session TMGI=%s, destination=%s/%d, TEID=0x%x, M1-U=%s",
+              session.tmgi.c_str(),
+              addr_str.c_str(),
+              prefix_len,
+              session.teid,
+              m1u_str);
+  return SRSRAN_SUCCESS;
+}
+
+uint32_t mbms_gw_sessions::find(uint32_t dst_addr) const
+{
+  auto it = session_by_addr.find(dst_addr);
+  if (it != session_by_addr.end()) {
+    return it->second;
+  }
+  for (uint32_t i : session_by_prefix) {
+    if ((dst_addr & sessions[i].dst_mask) == sessions[i].dst_addr) {
+      return i;
+    }
+  }
+  return sessions.size();
+}
+
 void mbms_gw::run_thread()
 {
   // Mark the thread as running
-  m_running                        = true;
-  srsran::unique_byte_buffer_t msg = srsran::make_byte_buffer();
-  if (msg == nullptr) {
+  m_running = true;
+  if (not m_batch.init()) {
     m_logger.error("Couldn't allocate PDU in %s().", __FUNCTION__);
+    m_running = false;
     return;
   }
 
-  uint8_t seq = 0;
+  struct pollfd pfd = {};
+  pfd.fd            = m_sgi_mb_if;
+  pfd.events        = POLLIN;
   while (m_running) {
-    msg->clear();
-    int n;
-    do {
-      n = read(m_sgi_mb_if, msg->msg, SRSRAN_MAX_BUFFER_SIZE_BYTES);
-    } while (n == -1 && errno == EAGAIN);
+    if (poll(&pfd, 1, -1) < 0) {
+      if (errno != EINTR) {
+        m_logger.error("Error polling TUN interface. Error: %s", strerror(errno));
+      }
+      continue;
+    }
+    read_sgi_mb_batch();
+    if (m_batch.size() > 0) {
+      m_batch.send(m_m1u, m_sessions, m_metrics, m_logger);
+    }
+  }
+  return;
+}
 
+void mbms_gw::read_sgi_mb_batch()
+{
+  // TUN devices return one packet per read(), drain them into the batch before sending
+  while (not m_batch.full()) {
+    srsran::byte_buffer_t* msg = m_batch.next_pdu();
+    msg->clear();
+    int n = read(m_sgi_mb_if, msg->msg, SRSRAN_MAX_BUFFER_SIZE_BYTES - SRSRAN_BUFFER_HEADER_OFFSET);
     if (n < 0) {
-      m_logger.error("Error reading from TUN interface. Error: %s", strerror(errno));
-    } else {
-      msg->N_bytes = n;
-      handle_sgi_md_pdu(msg.get());
+      if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+        m_logger.error("Error reading from TUN interface. Error: %s", strerror(errno));
+      }
+      break;
+    }
+    msg->N_bytes = n;
+    if (not handle_sgi_md_pdu(msg)) {
+      m_metrics.rx_dropped++;
     }
   }
-  return;
 }
 
-void mbms_gw::handle_sgi_md_pdu(srsran::byte_buffer_t* msg)
+bool mbms_gw::handle_sgi_md_pdu(srsran::byte_buffer_t* msg)
 {
-  uint8_t               version;
   srsran::gtpu_header_t header;
 
-  // Setup GTP-U header
-  header.flags        = GTPU_FLAGS_VERSION_V1 | GTPU_FLAGS_GTP_PROTOCOL;
-  header.message_type = GTPU_MSG_DATA_PDU;
-  header.length       = msg->N_bytes;
-  header.teid         = 0xAAAA; // TODO Harcoded TEID for now
-
   // Sanity Check IP packet
   if (msg->N_bytes < 20) {
     m_logger.error("IPv4 min len: %d, drop msg len %d", 20, msg->N_bytes);
-    return;
+    return false;
   }
 
   // IP Headers
   struct iphdr* iph = (struct iphdr*)msg->msg;
   if (iph->version != 4) {
     m_logger.info("IPv6 not supported yet.");
-    return;
+    return false;
   }
 
-  // Write GTP-U header into packet
+  // Session of the destination address
+  uint32_t dst_addr    = ntohl(iph->daddr);
+  uint32_t session_idx = m_sessions.find(dst_addr);
+  if (session_idx == m_sessions.size()) {
+    m_logger.debug("No MBMS session for destination 0x%x, drop msg len %d", dst_addr, msg->N_bytes);
+    return false;
+  }
+  mbms_gw_session_t& session = m_sessions[session_idx];
+  session.rx_pkts++;
+  session.rx_bytes += msg->N_bytes;
+
+  // Setup GTP-U header
+  header.flags        = GTPU_FLAGS_VERSION_V1 | GTPU_FLAGS_GTP_PROTOCOL;
+  header.message_type = GTPU_MSG_DATA_PDU;
+  header.length       = msg->N_bytes;
+  header.teid         = session.teid;
+
+  // Write GTP-U header into the headroom of the packet
   if (!srsran::gtpu_write_header(&header, msg, m_logger)) {
     srsran::console("Error writing GTP-U header on PDU\n");
+    return false;
   }
 
-  int n = sendto(m_m1u, msg->msg, msg->N_bytes, 0, (sockaddr*)&m_m1u_multi_addr, sizeof(struct sockaddr));
-  if (n < 0) {
-    srsran::console("Error writing to M1-U socket.\n");
-  } else {
-    m_logger.debug("Sent %d Bytes", msg->N_bytes);
+  m_batch.push(session_idx, session);
+  return true;
+}
+
+bool mbms_gw_batch::init()
+{
+  for (uint32_t i = 0; i < MBMS_GW_BATCH_SIZE; i++) {
+    pdus[i] = srsran::make_byte_buffer();
+    if (pdus[i] == nullptr) {
+      return false;
+    }
+  }
+  nof_pdus = 0;
+  return true;
+}
+
+void mbms_gw_batch::push(uint32_t session_idx, const mbms_gw_session_t& session)
+{
+  srsran::byte_buffer_t* msg = pdus[nof_pdus].get();
+  pdu_session[nof_pdus]      = session_idx;
+  iov[nof_pdus]              = {msg->msg, msg->N_bytes};
+  struct msghdr& msg_hdr     = hdr[nof_pdus].msg_hdr;
+  msg_hdr                    = {};
+  msg_hdr.msg_name           = (void*)&session.m1u_addr;
+  msg_hdr.msg_namelen        = sizeof(session.m1u_addr);
+  msg_hdr.msg_iov            = &iov[nof_pdus];
+  msg_hdr.msg_iovlen         = 1;
+  nof_pdus++;
+}
+
+void mbms_gw_batch::send(int fd, mbms_gw_sessions& sessions, mbms_gw_metrics_t& metrics, srslog::basic_logger& logger)
+{
+  uint32_t nof_sent = 0;
+  while (nof_sent < nof_pdus) {
+    int n = sendmmsg(fd, &hdr[nof_sent], nof_pdus - nof_sent, 0);
+    metrics.nof_sendmmsg++;
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      // Skip the packet that failed and retry the rest of the batch
+      srsran::console("Error writing to M1-U socket.\n");
+      logger.error("Error writing to M1-U socket. Error: %s", strerror(errno));
+      sessions[pdu_session[nof_sent]].tx_errors++;
+      nof_sent++;
+      continue;
+    }
+    for (int i = 0; i < n; i++, nof_sent++) {
+      mbms_gw_session_t& session = sessions[pdu_session[nof_sent]];
+      session.tx_pkts++;
+      session.tx_bytes += hdr[nof_sent].msg_len;
+    }
+  }
+  metrics.nof_batches++;
+  logger.debug("Sent %d M1-U PDUs", nof_pdus);
+  nof_pdus = 0;
+}
+
+void mbms_gw::log_metrics()
+{
+  m_logger.info("MBMS GW: %" PRIu64 " SGi-mb PDUs dropped, %" PRIu64 " M1-U batches in %" PRIu64 " sendmmsg() calls",
+                m_metrics.rx_dropped,
+                m_metrics.nof_batches,
+                m_metrics.nof_sendmmsg);
+  for (uint32_t i = 0; i < m_sessions.size(); i++) {
+    const mbms_gw_session_t& session = m_sessions[i];
+    m_logger.info("MBMS session TMGI=%s: rx %" PRIu64 " PDUs/%" PRIu64 " bytes, tx %" PRIu64 " PDUs/%" PRIu64
+                  " bytes, %" PRIu64 " tx errors",
+                  session.tmgi.c_str(),
+                  session.rx_pkts,
+                  session.rx_bytes,
+                  session.tx_pkts,
+                  session.tx_bytes,
+                  session.tx_errors);
   }
 }
 
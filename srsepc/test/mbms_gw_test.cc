@@ -0,0 +1,224 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsepc/hdr/mbms-gw/mbms-gw.h"
+#include "srsran/common/test_common.h"
+#include <arpa/inet.h>
+#include <unistd.h>
+
+using namespace srsepc;
+
+static srslog::basic_logger& logger = srslog::fetch_basic_logger("MBMS", false);
+
+static uint32_t to_host_addr(const char* str)
+{
+  struct in_addr addr;
+  inet_pton(AF_INET, str, &addr);
+  return ntohl(addr.s_addr);
+}
+
+static struct sockaddr_in make_sockaddr(const char* str, uint16_t port)
+{
+  struct sockaddr_in addr = {};
+  addr.sin_family         = AF_INET;
+  addr.sin_port           = htons(port);
+  inet_pton(AF_INET, str, &addr.sin_addr);
+  return addr;
+}
+
+int test_session_parsing()
+{
+  mbms_gw_sessions   sessions(logger);
+  struct sockaddr_in default_m1u = make_sockaddr("239.255.0.1", GTPU_RX_PORT + 1);
+
+  TESTASSERT(sessions.add("000001, 10.0.0.1, 0x10", default_m1u) == SRSRAN_SUCCESS);
+  TESTASSERT(sessions.add("000002,10.1.0.0/16,32,239.255.0.2", default_m1u) == SRSRAN_SUCCESS);
+  // Host bits of a prefix are ignored
+  TESTASSERT(sessions.add("000003,10.2.3.4/8,1", default_m1u) == SRSRAN_SUCCESS);
+  TESTASSERT(sessions.size() == 3);
+
+  TESTASSERT(sessions[0].tmgi == "000001");
+  TESTASSERT(sessions[0].dst_addr == to_host_addr("10.0.0.1"));
+  TESTASSERT(sessions[0].dst_mask == 0xffffffff);
+  TESTASSERT(sessions[0].teid == 0x10);
+  TESTASSERT(sessions[0].m1u_addr.sin_addr.s_addr == default_m1u.sin_addr.s_addr);
+  TESTASSERT(sessions[0].m1u_addr.sin_port == default_m1u.sin_port);
+
+  TESTASSERT(sessions[1].tmgi == "000002");
+  TESTASSERT(sessions[1].dst_addr == to_host_addr("10.1.0.0"));
+  TESTASSERT(sessions[1].dst_mask == 0xffff0000);
+  TESTASSERT(sessions[1].teid == 32);
+  TESTASSERT(ntohl(sessions[1].m1u_addr.sin_addr.s_addr) == to_host_addr("239.255.0.2"));
+  TESTASSERT(sessions[1].m1u_addr.sin_port == default_m1u.sin_port);
+
+  TESTASSERT(sessions[2].dst_addr == to_host_addr("10.0.0.0"));
+  TESTASSERT(sessions[2].dst_mask == 0xff000000);
+
+  // Malformed sessions are rejected
+  TESTASSERT(sessions.add("000004,10.0.0.2", default_m1u) != SRSRAN_SUCCESS);
+  TESTASSERT(sessions.add("000004,10.0.0.2,1,239.255.0.3,1", default_m1u) != SRSRAN_SUCCESS);
+  TESTASSERT(sessions.add("000004,10.0.0.2/33,1", default_m1u) != SRSRAN_SUCCESS);
+  TESTASSERT(sessions.add("000004,10.0.0.256,1", default_m1u) != SRSRAN_SUCCESS);
+  TESTASSERT(sessions.add("000004,10.0.0.2,0x1g", default_m1u) != SRSRAN_SUCCESS);
+  TESTASSERT(sessions.add("000004,10.0.0.2/x8,1", default_m1u) != SRSRAN_SUCCESS);
+  TESTASSERT(sessions.add("000004,10.0.0.2/,1", default_m1u) != SRSRAN_SUCCESS);
+  TESTASSERT(sessions.add("000004,10.0.0.2/-8,1", default_m1u) != SRSRAN_SUCCESS);
+  TESTASSERT(sessions.add("000004,10.0.0.2,0x100000000", default_m1u) != SRSRAN_SUCCESS);
+  TESTASSERT(sessions.add("000004,10.0.0.2,-1", default_m1u) != SRSRAN_SUCCESS);
+  TESTASSERT(sessions.add("000004,10.0.0.2,1,239.255.0", default_m1u) != SRSRAN_SUCCESS);
+  // Two sessions cannot have the same destination address
+  TESTASSERT(sessions.add("000004,10.0.0.1,1", default_m1u) != SRSRAN_SUCCESS);
+  TESTASSERT(sessions.size() == 3);
+
+  sessions.clear();
+  TESTASSERT(sessions.size() == 0);
+  TESTASSERT(sessions.find(to_host_addr("10.0.0.1")) == sessions.size());
+
+  return SRSRAN_SUCCESS;
+}
+
+int test_session_classification()
+{
+  mbms_gw_sessions   sessions(logger);
+  struct sockaddr_in default_m1u = make_sockaddr("239.255.0.1", GTPU_RX_PORT + 1);
+
+  // Prefixes are added out of order
+  TESTASSERT(sessions.add("000001,10.1.0.0/16,1", default_m1u) == SRSRAN_SUCCESS);
+  TESTASSERT(sessions.add("000002,10.0.0.0/8,2", default_m1u) == SRSRAN_SUCCESS);
+  TESTASSERT(sessions.add("000003,10.1.2.3,3", default_m1u) == SRSRAN_SUCCESS);
+  TESTASSERT(sessions.add("000004,10.1.2.0/24,4", default_m1u) == SRSRAN_SUCCESS);
+
+  // Exact address first, then longest prefix
+  TESTASSERT(sessions.find(to_host_addr("10.1.2.3")) == 2);
+  TESTASSERT(sessions.find(to_host_addr("10.1.2.4")) == 3);
+  TESTASSERT(sessions.find(to_host_addr("10.1.3.1")) == 0);
+  TESTASSERT(sessions.find(to_host_addr("10.2.0.1")) == 1);
+
+  // Without a default session other destinations are dropped
+  TESTASSERT(sessions.find(to_host_addr("192.168.0.1")) == sessions.size());
+  TESTASSERT(sessions.find(to_host_addr("11.1.2.3")) == sessions.size());
+
+  TESTASSERT(sessions.add("000005,0.0.0.0/0,5", default_m1u) == SRSRAN_SUCCESS);
+  TESTASSERT(sessions.find(to_host_addr("192.168.0.1")) == 4);
+  TESTASSERT(sessions.find(to_host_addr("10.1.2.4")) == 3);
+
+  return SRSRAN_SUCCESS;
+}
+
+static void fill_pdu(srsran::byte_buffer_t* pdu, uint32_t len)
+{
+  pdu->clear();
+  for (uint32_t i = 0; i < len; i++) {
+    pdu->msg[i] = (uint8_t)len;
+  }
+  pdu->N_bytes = len;
+}
+
+int test_batch_send()
+{
+  // M1-U group replaced by a local socket
+  int rx_sock = socket(AF_INET, SOCK_DGRAM, 0);
+  int tx_sock = socket(AF_INET, SOCK_DGRAM, 0);
+  TESTASSERT(rx_sock >= 0 && tx_sock >= 0);
+  struct sockaddr_in rx_addr = make_sockaddr("127.0.0.1", 0);
+  socklen_t          addrlen = sizeof(rx_addr);
+  TESTASSERT(bind(rx_sock, (struct sockaddr*)&rx_addr, sizeof(rx_addr)) == 0);
+  TESTASSERT(getsockname(rx_sock, (struct sockaddr*)&rx_addr, &addrlen) == 0);
+  struct timeval timeout = {1, 0};
+  TESTASSERT(setsockopt(rx_sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) == 0);
+
+  mbms_gw_sessions sessions(logger);
+  TESTASSERT(sessions.add("000001,10.0.0.1,1", rx_addr) == SRSRAN_SUCCESS);
+  TESTASSERT(sessions.add("000002,10.0.0.2,2,127.0.0.1", rx_addr) == SRSRAN_SUCCESS);
+
+  mbms_gw_batch     batch;
+  mbms_gw_metrics_t metrics = {};
+  TESTASSERT(batch.init());
+  TESTASSERT(batch.size() == 0);
+
+  // PDUs of both sessions go out in a single call, in order
+  const uint32_t nof_pdus = 5;
+  for (uint32_t i = 0; i < nof_pdus; i++) {
+    fill_pdu(batch.next_pdu(), 10 + i);
+    batch.push(i % 2, sessions[i % 2]);
+  }
+  TESTASSERT(batch.size() == nof_pdus);
+  TESTASSERT(not batch.full());
+
+  batch.send(tx_sock, sessions, metrics, logger);
+  TESTASSERT(batch.size() == 0);
+  TESTASSERT(metrics.nof_batches == 1);
+  TESTASSERT(metrics.nof_sendmmsg == 1);
+  TESTASSERT(sessions[0].tx_pkts == 3 && sessions[0].tx_bytes == 10 + 12 + 14);
+  TESTASSERT(sessions[1].tx_pkts == 2 && sessions[1].tx_bytes == 11 + 13);
+  TESTASSERT(sessions[0].tx_errors == 0 && sessions[1].tx_errors == 0);
+
+  uint8_t buf[64];
+  for (uint32_t i = 0; i < nof_pdus; i++) {
+    ssize_t n = recv(rx_sock, buf, sizeof(buf), 0);
+    TESTASSERT(n == (ssize_t)(10 + i));
+    TESTASSERT(buf[0] == 10 + i);
+  }
+
+  // The batch takes up to MBMS_GW_BATCH_SIZE PDUs
+  for (uint32_t i = 0; i < MBMS_GW_BATCH_SIZE; i++) {
+    TESTASSERT(not batch.full());
+    fill_pdu(batch.next_pdu(), 20);
+    batch.push(0, sessions[0]);
+  }
+  TESTASSERT(batch.full());
+  batch.send(tx_sock, sessions, metrics, logger);
+  TESTASSERT(metrics.nof_batches == 2);
+  TESTASSERT(sessions[0].tx_pkts == 3 + MBMS_GW_BATCH_SIZE);
+  for (uint32_t i = 0; i < MBMS_GW_BATCH_SIZE; i++) {
+    TESTASSERT(recv(rx_sock, buf, sizeof(buf), 0) == 20);
+  }
+
+  // A PDU that fails is counted as a send error and the rest of the batch is still sent
+  uint64_t nof_calls = metrics.nof_sendmmsg;
+  for (uint32_t i = 0; i < 2; i++) {
+    fill_pdu(batch.next_pdu(), 30);
+    batch.push(1, sessions[1]);
+  }
+  batch.send(-1, sessions, metrics, logger);
+  TESTASSERT(batch.size() == 0);
+  TESTASSERT(metrics.nof_batches == 3);
+  TESTASSERT(metrics.nof_sendmmsg == nof_calls + 2);
+  TESTASSERT(sessions[1].tx_errors == 2);
+  TESTASSERT(sessions[1].tx_pkts == 2);
+
+  close(rx_sock);
+  close(tx_sock);
+  return SRSRAN_SUCCESS;
+}
+
+int main()
+{
+  srslog::init();
+
+  TESTASSERT(test_session_parsing() == SRSRAN_SUCCESS);
+  TESTASSERT(test_session_classification() == SRSRAN_SUCCESS);
+  TESTASSERT(test_batch_send() == SRSRAN_SUCCESS);
+
+  srslog::flush();
+  printf("Success\n");
+  return SRSRAN_SUCCESS;
+}
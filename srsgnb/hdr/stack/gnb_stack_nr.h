@@ -72,7 +72,7 @@ public:
   // eNB stack base interface
   void        stop() final;
   std::string get_type() final;
-  bool        get_metrics(srsenb::stack_metrics_t* metrics) final;
+  bool        get_metrics(srsenb::stack_metrics_t* metrics, uint64_t period) final;
 
   // GW srsue stack_interface_gw dummy interface
   bool is_registered() override { return true; };
@@ -84,6 +84,11 @@ public:
     // Note: for now we use same size regardless of nof_prb_
     srsran_softbuffer_rx_init_guru(&buffer, SRSRAN_SCH_NR_MAX_NOF_CB_LDPC, SRSRAN_LDPC_MAX_LEN_ENCODED_CB);
   }
+  /// Soft-buffer whose code blocks are taken from cb_pool when a TB is scheduled and given back on reset()
+  rx_harq_softbuffer(uint32_t nof_prb_, srsran_softbuffer_pool_t* cb_pool)
+  {
+    srsran_softbuffer_rx_init_pool(&buffer, cb_pool, SRSRAN_SCH_NR_MAX_NOF_CB_LDPC);
+  }
   rx_harq_softbuffer(const rx_harq_softbuffer&) = delete;
   rx_harq_softbuffer(rx_harq_softbuffer&& other) noexcept
   {
@@ -103,7 +108,7 @@ public:
   ~rx_harq_softbuffer() { destroy(); }
 
   void reset() { srsran_softbuffer_rx_reset(&buffer); }
-  void reset(uint32_t tbs_bits) { srsran_softbuffer_rx_reset_tbs(&buffer, tbs_bits); }
+  void reset(uint32_t tbs_bits) { srsran_softbuffer_rx_reset_tbs_nr(&buffer, tbs_bits); }
 
   srsran_softbuffer_rx_t&       operator*() { return buffer; }
   const srsran_softbuffer_rx_t& operator*() const { return buffer; }
@@ -131,6 +136,9 @@ public:
   srsran::unique_pool_ptr<tx_harq_softbuffer> get_tx(uint32_t nof_prb);
   srsran::unique_pool_ptr<rx_harq_softbuffer> get_rx(uint32_t nof_prb);
 
+  /// Usage of the code blocks shared by all Rx soft-buffers
+  srsran_softbuffer_pool_stats_t get_rx_cb_stats();
+
   static harq_softbuffer_pool& get_instance()
   {
     static harq_softbuffer_pool pool;
@@ -139,8 +147,15 @@ public:
 
 private:
   const static uint32_t MAX_HARQ = 16;
+  // Rx code blocks are allocated in chunks of 4 TBs of the largest size, up to 16384 code blocks (8-bit LLR)
+  const static uint32_t RX_CB_CHUNK_SIZE = SRSRAN_SCH_NR_MAX_NOF_CB_LDPC * 4;
+  const static uint32_t MAX_RX_CB        = 16384;
 
   harq_softbuffer_pool() = default;
+  ~harq_softbuffer_pool();
+
+  // LDPC decoding works with 8-bit LLRs, so the Rx code blocks only need one byte per soft bit
+  srsran_softbuffer_pool_t rx_cb_pool = {};
 
   std::array<std::unique_ptr<srsran::obj_pool_itf<tx_harq_softbuffer> >, SRSRAN_MAX_PRB_NR> tx_pool;
   std::array<std::unique_ptr<srsran::obj_pool_itf<rx_harq_softbuffer> >, SRSRAN_MAX_PRB_NR> rx_pool;
@@ -26,6 +26,8 @@
 #include "sched_nr_rb.h"
 #include "srsenb/hdr/common/common_enb.h"
 #include "srsran/adt/optional_array.h"
+#include "srsran/phy/phch/ra_nr.h"
+#include <memory>
 
 namespace srsenb {
 
@@ -70,6 +72,18 @@ struct cell_config_manager;
 /// Structure that extends the sched_nr_interface::bwp_cfg_t passed by upper layers with other
 /// derived BWP-specific params
 struct bwp_params_t {
+private:
+  struct tb_cache_deleter {
+    void operator()(srsran_ra_nr_tb_cache_t* p);
+  };
+  using tb_cache_ptr = std::unique_ptr<srsran_ra_nr_tb_cache_t, tb_cache_deleter>;
+  static tb_cache_ptr make_tb_cache(const srsran_sch_hl_cfg_nr_t& hl_cfg, uint32_t nof_prb);
+
+  /// Grant parameters precomputed at cell setup. Declared before cfg, whose PDSCH/PUSCH configs point to them
+  tb_cache_ptr pdsch_tb_cache;
+  tb_cache_ptr pusch_tb_cache;
+
+public:
   const uint32_t             bwp_id;
   const uint32_t             cc;
   const bwp_cfg_t            cfg;
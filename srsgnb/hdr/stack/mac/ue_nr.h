@@ -73,6 +73,7 @@ public:
   void       metrics_ul_mcs(uint32_t mcs);
   void       metrics_pucch_sinr(float sinr);
   void       metrics_pusch_sinr(float sinr);
+  void       metrics_pusch_overload(bool reduced_its, bool nack);
   void       metrics_cnt();
 
   uint32_t read_pdu(uint32_t lcid, uint8_t* payload, uint32_t requested_bytes) final;
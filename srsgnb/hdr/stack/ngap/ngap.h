@@ -25,6 +25,7 @@
 #include "srsenb/hdr/common/common_enb.h"
 #include "srsran/adt/circular_map.h"
 #include "srsran/adt/optional.h"
+#include "srsran/adt/pool/circular_stack_pool.h"
 #include "srsran/asn1/asn1_utils.h"
 #include "srsran/asn1/ngap.h"
 #include "srsran/common/bcd_helpers.h"
@@ -157,7 +158,7 @@ private:
   class user_list
   {
   public:
-    using value_type     = std::unique_ptr<ue>;
+    using value_type     = srsran::unique_pool_ptr<ue>;
     using iterator       = std::unordered_map<uint32_t, value_type>::iterator;
     using const_iterator = std::unordered_map<uint32_t, value_type>::const_iterator;
     using pair_type      = std::unordered_map<uint32_t, value_type>::value_type;
@@ -174,9 +175,11 @@ private:
     size_t         size() const { return users.size(); }
 
   private:
-    std::unordered_map<uint32_t, std::unique_ptr<ue> > users; // maps ran_ue_ngap_id to user
+    std::unordered_map<uint32_t, value_type> users; // maps ran_ue_ngap_id to user
   };
-  user_list users;
+  // UE contexts are allocated from a pool keyed by RNTI. Declared before the users, so that it outlives them
+  std::unique_ptr<srsran::circular_stack_pool<SRSENB_MAX_UES> > ue_pool;
+  user_list                                                     users;
 
   // procedures
   class ng_setup_proc_t
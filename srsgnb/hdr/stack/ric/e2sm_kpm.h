@@ -25,6 +25,7 @@
 #include "srsran/asn1/e2sm.h"
 #include "srsran/asn1/e2sm_kpm_v2.h"
 #include "srsran/srsran.h"
+#include <mutex>
 
 #ifndef RIC_E2SM_KPM_H
 #define RIC_E2SM_KPM_H
@@ -67,10 +68,13 @@ private:
   bool                     _get_meas_definition(std::string meas_name, e2sm_kpm_metric_t& def);
   std::vector<std::string> _get_supported_meas(uint32_t level_mask);
 
-  bool _collect_meas_value(e2sm_kpm_meas_def_t& meas_value, meas_record_item_c& item);
+  bool _sample_meas_value(const e2sm_kpm_meas_def_t& meas_value, const enb_metrics_t& enb_metrics, double& value);
+  bool _collect_meas_value(const e2sm_kpm_compiled_meas_t& meas, meas_record_item_c& item);
+  bool _extract_integer_type_meas_value(const e2sm_kpm_meas_def_t& meas_value,
+                                        const enb_metrics_t&       enb_metrics,
+                                        uint32_t&                  value);
   bool
-  _extract_integer_type_meas_value(e2sm_kpm_meas_def_t& meas_value, const enb_metrics_t& enb_metrics, uint32_t& value);
-  bool _extract_real_type_meas_value(e2sm_kpm_meas_def_t& meas_value, const enb_metrics_t& enb_metrics, float& value);
+  _extract_real_type_meas_value(const e2sm_kpm_meas_def_t& meas_value, const enb_metrics_t& enb_metrics, float& value);
 
   srslog::basic_logger&                        logger;
   std::vector<e2sm_kpm_metric_t>               supported_meas_types;
@@ -78,7 +82,8 @@ private:
 
   srsran_random_t random_gen;
 
-  enb_metrics_t last_enb_metrics;
+  // protects the registered actions and their accumulated measurements, which are sampled from the metrics thread
+  std::mutex meas_mutex;
 };
 
 #endif /*E2SM_KPM*/
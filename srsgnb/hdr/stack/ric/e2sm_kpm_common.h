@@ -32,17 +32,31 @@ using namespace asn1::e2sm_kpm;
 
 enum e2_metric_data_type_t { INTEGER, REAL };
 
+/* Measurements known by the E2 node, so that an admitted action does not need to compare names */
+enum e2sm_kpm_metric_id_enum {
+  KPM_METRIC_RRU_PRB_TOT_DL,
+  KPM_METRIC_RRU_PRB_TOT_UL,
+  KPM_METRIC_RRU_RACH_PREAMBLE_DED_MEAN,
+  KPM_METRIC_TEST,
+  KPM_METRIC_RANDOM_INT,
+  KPM_METRIC_CPU0_LOAD,
+  KPM_METRIC_CPU_LOAD,
+  KPM_METRIC_TEST123,
+  KPM_METRIC_UNKNOWN
+};
+
 typedef struct {
-  std::string           name;
-  bool                  supported;
-  e2_metric_data_type_t data_type;
-  std::string           units;
-  bool                  min_val_present;
-  double                min_val;
-  bool                  max_val_present;
-  double                max_val;
-  uint32_t              supported_labels;
-  uint32_t              supported_scopes;
+  e2sm_kpm_metric_id_enum id;
+  std::string             name;
+  bool                    supported;
+  e2_metric_data_type_t   data_type;
+  std::string             units;
+  bool                    min_val_present;
+  double                  min_val;
+  bool                    max_val_present;
+  double                  max_val;
+  uint32_t                supported_labels;
+  uint32_t                supported_scopes;
 } e2sm_kpm_metric_t;
 
 // TODO: define all labels and scopes
@@ -70,6 +84,7 @@ enum e2sm_kpm_metric_scope_enum {
 
 typedef struct {
   std::string                name;
+  e2sm_kpm_metric_id_enum    id;
   e2sm_kpm_label_enum        label;
   e2sm_kpm_metric_scope_enum scope;
   meas_record_item_c::types  data_type;
@@ -77,4 +92,25 @@ typedef struct {
   uint32_t                   cell_id; // TODO: do we need to use type cgi_c? or we translate to local cell_id?
 } e2sm_kpm_meas_def_t;
 
+/* Samples of a measurement accumulated over a granularity period */
+typedef struct {
+  uint32_t nof_samples;
+  double   min;
+  double   max;
+  double   sum;
+  bool     last_present;
+  double   last; // kept across periods, reported when no sample arrives within a period
+} e2sm_kpm_meas_acc_t;
+
+void e2sm_kpm_meas_acc_reset(e2sm_kpm_meas_acc_t& acc);
+void e2sm_kpm_meas_acc_add(e2sm_kpm_meas_acc_t& acc, double value);
+bool e2sm_kpm_meas_acc_get(const e2sm_kpm_meas_acc_t& acc, e2sm_kpm_label_enum label, double& value);
+
+/* Measurement of an admitted action, resolved once when the action is admitted */
+typedef struct {
+  e2sm_kpm_meas_def_t def;
+  uint32_t            meas_data_idx; // record list of the measurement in the indication message
+  e2sm_kpm_meas_acc_t acc;
+} e2sm_kpm_compiled_meas_t;
+
 #endif // SRSRAN_E2SM_KPM_COMMON_H
@@ -32,10 +32,10 @@ std::vector<e2sm_kpm_metric_t> get_e2sm_kpm_28_552_metrics()
   // TODO: add all metrics from 3GPP TS 28.552
   std::vector<e2sm_kpm_metric_t> metrics;
   // not supported metrics
-  metrics.push_back({"RRU.PrbTotDl", false, REAL, "%", true, 0, true, 100, NO_LABEL | AVG_LABEL, CELL_LEVEL | UE_LEVEL });
-  metrics.push_back({"RRU.PrbTotUl", false, REAL, "%", true, 0, true, 100, NO_LABEL | AVG_LABEL, CELL_LEVEL | UE_LEVEL });
+  metrics.push_back({KPM_METRIC_RRU_PRB_TOT_DL, "RRU.PrbTotDl", false, REAL, "%", true, 0, true, 100, NO_LABEL | AVG_LABEL, CELL_LEVEL | UE_LEVEL });
+  metrics.push_back({KPM_METRIC_RRU_PRB_TOT_UL, "RRU.PrbTotUl", false, REAL, "%", true, 0, true, 100, NO_LABEL | AVG_LABEL, CELL_LEVEL | UE_LEVEL });
   // not supported metrics
-  metrics.push_back({"RRU.RachPreambleDedMean", false, REAL, "-", false, 0, false, 100, NO_LABEL, CELL_LEVEL | UE_LEVEL });
+  metrics.push_back({KPM_METRIC_RRU_RACH_PREAMBLE_DED_MEAN, "RRU.RachPreambleDedMean", false, REAL, "-", false, 0, false, 100, NO_LABEL, CELL_LEVEL | UE_LEVEL });
   return metrics;
 }
 
@@ -60,12 +60,12 @@ std::vector<e2sm_kpm_metric_t> e2sm_kpm_custom_metrics()
 {
   std::vector<e2sm_kpm_metric_t> metrics;
   // supported metrics
-  metrics.push_back({"test", true, INTEGER, "", true, 0, true, 100, NO_LABEL, ENB_LEVEL | CELL_LEVEL | UE_LEVEL });
-  metrics.push_back({"random_int", true, INTEGER, "", true, 0, true, 100, NO_LABEL, CELL_LEVEL });
-  metrics.push_back({"cpu0_load", true, REAL, "", true, 0, true, 100, NO_LABEL, ENB_LEVEL });
-  metrics.push_back({"cpu_load", true, REAL, "", true, 0, true, 100, MIN_LABEL|MAX_LABEL|AVG_LABEL, ENB_LEVEL });
+  metrics.push_back({KPM_METRIC_TEST, "test", true, INTEGER, "", true, 0, true, 100, NO_LABEL, ENB_LEVEL | CELL_LEVEL | UE_LEVEL });
+  metrics.push_back({KPM_METRIC_RANDOM_INT, "random_int", true, INTEGER, "", true, 0, true, 100, NO_LABEL, CELL_LEVEL });
+  metrics.push_back({KPM_METRIC_CPU0_LOAD, "cpu0_load", true, REAL, "", true, 0, true, 100, NO_LABEL, ENB_LEVEL });
+  metrics.push_back({KPM_METRIC_CPU_LOAD, "cpu_load", true, REAL, "", true, 0, true, 100, MIN_LABEL|MAX_LABEL|AVG_LABEL, ENB_LEVEL });
   // not supported metrics
-  metrics.push_back({"test123", false,  REAL, "", true, 0, true, 100, NO_LABEL, CELL_LEVEL | UE_LEVEL });
+  metrics.push_back({KPM_METRIC_TEST123, "test123", false,  REAL, "", true, 0, true, 100, NO_LABEL, CELL_LEVEL | UE_LEVEL });
   return metrics;
 }
 
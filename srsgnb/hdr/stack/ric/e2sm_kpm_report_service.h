@@ -30,6 +30,9 @@
 #ifndef SRSRAN_E2SM_KPM_ACTION_DATA_H
 #define SRSRAN_E2SM_KPM_ACTION_DATA_H
 
+// Records preallocated in every record list of an indication message, the lists keep their capacity across reports
+#define E2SM_KPM_RECORD_LIST_PREALLOC 16
+
 using namespace asn1::e2ap;
 using namespace asn1::e2sm_kpm;
 
@@ -46,6 +49,8 @@ public:
   virtual bool is_ric_ind_ready()        = 0;
   virtual bool clear_collected_data()    = 0;
 
+  virtual void _sample_meas_data(const enb_metrics_t& enb_metrics);
+
   virtual bool _start_meas_collection();
   bool         stop();
   virtual bool _stop_meas_collection();
@@ -73,6 +78,9 @@ public:
 
   uint32_t             granul_period = 0;
   srsran::unique_timer meas_collection_timer; // for measurements collection
+
+  // measurements of the action, resolved when admitted and sampled on every enb metrics update
+  std::vector<e2sm_kpm_compiled_meas_t> compiled_meas;
 };
 
 class e2sm_kpm_report_service_style1 : public e2sm_kpm_report_service
@@ -91,9 +99,6 @@ public:
   virtual bool clear_collected_data();
 
 private:
-  meas_data_item_s&
-  _get_meas_data_item(std::string meas_name, e2sm_kpm_label_enum label, uint32_t ue_id, bool& ref_found);
-
   e2_sm_kpm_action_definition_format1_s& action_def;
   e2_sm_kpm_ind_msg_format1_s&           ric_ind_message;
 };
@@ -26,6 +26,7 @@
 #include "srsenb/hdr/stack/rrc/rrc_config_common.h"
 #include "srsenb/hdr/stack/rrc/rrc_metrics.h"
 #include "srsgnb/hdr/stack/rrc/rrc_nr_config.h"
+#include "srsran/adt/pool/circular_stack_pool.h"
 #include "srsran/asn1/rrc_nr.h"
 #include "srsran/common/block_queue.h"
 #include "srsran/common/buffer_pool.h"
@@ -159,9 +160,12 @@ private:
     std::unique_ptr<const asn1::rrc_nr::cell_group_cfg_s> master_cell_group;
     srsran::phy_cfg_nr_t                                  default_phy_ue_cfg_nr;
   };
-  std::unique_ptr<cell_ctxt_t>     cell_ctxt;
-  rnti_map_t<std::unique_ptr<ue> > users;
-  bool                             running = false;
+  std::unique_ptr<cell_ctxt_t> cell_ctxt;
+  // UE contexts are allocated from a pool, so that registration storms do not hit the heap. Declared before the users,
+  // so that it outlives them
+  std::unique_ptr<srsran::circular_stack_pool<SRSENB_MAX_UES> > ue_pool;
+  rnti_map_t<srsran::unique_pool_ptr<ue> >                      users;
+  bool                                                          running = false;
 
   /// Private Methods
   void handle_pdu(uint16_t rnti, uint32_t lcid, srsran::const_byte_span pdu);
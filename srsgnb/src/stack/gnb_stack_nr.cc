@@ -190,8 +190,10 @@ void gnb_stack_nr::process_pdus() {}
  *
  *******************************************************/
 
-bool gnb_stack_nr::get_metrics(srsenb::stack_metrics_t* metrics)
+bool gnb_stack_nr::get_metrics(srsenb::stack_metrics_t* metrics, uint64_t period)
 {
+  // NR layers do not publish per period yet, their metrics are read when requested
+
   bool metrics_ready = false;
 
   // use stack thread to query RRC metrics
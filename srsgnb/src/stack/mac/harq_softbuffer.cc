@@ -42,12 +42,38 @@ void harq_softbuffer_pool::init_pool(uint32_t nof_prb, uint32_t batch_size, uint
   tx_pool[idx].reset(new srsran::background_obj_pool<tx_harq_softbuffer>(
       batch_size, thres, init_size, init_tx_softbuffers, recycle_tx_softbuffers));
 
-  auto init_rx_softbuffers    = [nof_prb](void* ptr) { new (ptr) rx_harq_softbuffer(nof_prb); };
+  if (rx_cb_pool.max_slots == 0) {
+    if (srsran_softbuffer_pool_init(
+            &rx_cb_pool, SRSRAN_LDPC_MAX_LEN_ENCODED_CB, true, RX_CB_CHUNK_SIZE, MAX_RX_CB, RX_CB_CHUNK_SIZE) <
+        SRSRAN_SUCCESS) {
+      srsran_terminate("Failed to initiate pool of Rx soft-buffer code blocks");
+    }
+  }
+  srsran_softbuffer_pool_t* cb_pool                = &rx_cb_pool;
+  auto                      init_rx_softbuffers    = [nof_prb, cb_pool](void* ptr) {
+    new (ptr) rx_harq_softbuffer(nof_prb, cb_pool);
+  };
   auto recycle_rx_softbuffers = [](rx_harq_softbuffer& softbuffer) { softbuffer.reset(); };
   rx_pool[idx].reset(new srsran::background_obj_pool<rx_harq_softbuffer>(
       batch_size, thres, init_size, init_rx_softbuffers, recycle_rx_softbuffers));
 }
 
+harq_softbuffer_pool::~harq_softbuffer_pool()
+{
+  // Soft-buffers give their code blocks back to the shared pool on destruction
+  for (auto& pool : rx_pool) {
+    pool.reset();
+  }
+  srsran_softbuffer_pool_free(&rx_cb_pool);
+}
+
+srsran_softbuffer_pool_stats_t harq_softbuffer_pool::get_rx_cb_stats()
+{
+  srsran_softbuffer_pool_stats_t stats = {};
+  srsran_softbuffer_pool_get_stats(&rx_cb_pool, &stats);
+  return stats;
+}
+
 srsran::unique_pool_ptr<tx_harq_softbuffer> harq_softbuffer_pool::get_tx(uint32_t nof_prb)
 {
   srsran_assert(nof_prb <= SRSRAN_MAX_PRB_NR, "Invalid Nprb=%d", nof_prb);
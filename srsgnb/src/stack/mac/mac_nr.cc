@@ -643,6 +643,7 @@ int mac_nr::pusch_info(const srsran_slot_cfg_t& slot_cfg, mac_interface_phy_nr::
   if (ue_db.contains(rnti)) {
     ue_db[rnti]->metrics_rx(pusch_info.pusch_data.tb[0].crc, nof_bytes);
     ue_db[rnti]->metrics_pusch_sinr(pusch_info.csi.snr_dB);
+    ue_db[rnti]->metrics_pusch_overload(pusch_info.overload_reduced_its, pusch_info.overload_nack);
   }
   return SRSRAN_SUCCESS;
 }
@@ -48,12 +48,42 @@ void get_dci_locs(const srsran_coreset_t&      coreset,
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+void bwp_params_t::tb_cache_deleter::operator()(srsran_ra_nr_tb_cache_t* p)
+{
+  if (p != nullptr) {
+    srsran_ra_nr_tb_cache_free(p);
+    delete p;
+  }
+}
+
+bwp_params_t::tb_cache_ptr bwp_params_t::make_tb_cache(const srsran_sch_hl_cfg_nr_t& hl_cfg, uint32_t nof_prb)
+{
+  tb_cache_ptr cache(new srsran_ra_nr_tb_cache_t{});
+  if (srsran_ra_nr_tb_cache_init(cache.get(), &hl_cfg, nof_prb) < SRSRAN_SUCCESS) {
+    // Without the cache the grants are computed at every allocation
+    cache.reset();
+  }
+  return cache;
+}
+
+static sched_nr_bwp_cfg_t make_bwp_cfg_with_tb_cache(const sched_nr_bwp_cfg_t&      bwp_cfg,
+                                                     const srsran_ra_nr_tb_cache_t* pdsch_tb_cache,
+                                                     const srsran_ra_nr_tb_cache_t* pusch_tb_cache)
+{
+  sched_nr_bwp_cfg_t cfg = bwp_cfg;
+  cfg.pdsch.tb_cache     = pdsch_tb_cache;
+  cfg.pusch.tb_cache     = pusch_tb_cache;
+  return cfg;
+}
+
 bwp_params_t::bwp_params_t(const cell_config_manager& cell, uint32_t bwp_id_, const sched_nr_bwp_cfg_t& bwp_cfg) :
+  pdsch_tb_cache(make_tb_cache(bwp_cfg.pdsch, cell.carrier.nof_prb)),
+  pusch_tb_cache(make_tb_cache(bwp_cfg.pusch, cell.carrier.nof_prb)),
   cell_cfg(cell),
   sched_cfg(cell.sched_args),
   cc(cell.cc),
   bwp_id(bwp_id_),
-  cfg(bwp_cfg),
+  cfg(make_bwp_cfg_with_tb_cache(bwp_cfg, pdsch_tb_cache.get(), pusch_tb_cache.get())),
   nof_prb(cell_cfg.carrier.nof_prb),
   logger(srslog::fetch_basic_logger(sched_cfg.logger_name)),
   cached_empty_prb_mask(bwp_cfg.rb_width, bwp_cfg.start_rb, bwp_cfg.pdsch.rbg_size_cfg_1)
@@ -186,6 +186,10 @@ void ue::set_cfg(const sched_nr_ue_cfg_t& cfg)
   ue_cfg.apply_config_request(cfg);
   for (auto& ue_cc_cfg : cfg.carriers) {
     if (ue_cc_cfg.active) {
+      // Grant parameters precomputed by the cell, the lookup falls back to computing them for other UE configs
+      const bwp_params_t& bwp_params = sched_cfg.cells[ue_cc_cfg.cc].bwps[0];
+      ue_cfg.phy_cfg.pdsch.tb_cache  = bwp_params.cfg.pdsch.tb_cache;
+      ue_cfg.phy_cfg.pusch.tb_cache  = bwp_params.cfg.pusch.tb_cache;
       if (carriers[ue_cc_cfg.cc] == nullptr) {
         carriers[ue_cc_cfg.cc] = std::make_unique<ue_carrier>(rnti,
                                                               ue_cfg,
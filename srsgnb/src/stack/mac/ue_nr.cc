@@ -263,6 +263,13 @@ void ue_nr::metrics_pusch_sinr(float sinr)
   }
 }
 
+void ue_nr::metrics_pusch_overload(bool reduced_its, bool nack)
+{
+  std::lock_guard<std::mutex> lock(metrics_mutex);
+  ue_metrics.n_overload_reduced_its += reduced_its ? 1 : 0;
+  ue_metrics.n_overload_nacks += nack ? 1 : 0;
+}
+
 // Called from Stack thread when demuxing UL PDUs
 void ue_nr::store_msg3(srsran::unique_byte_buffer_t pdu)
 {
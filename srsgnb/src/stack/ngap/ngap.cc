@@ -118,6 +118,9 @@ ngap::ngap(srsran::task_sched_handle   task_sched_,
   ngsetup_proc(this), logger(logger), task_sched(task_sched_), rx_socket_handler(rx_socket_handler_)
 {
   amf_task_queue = task_sched.make_task_queue();
+
+  // Initiate UE memory pool
+  ue_pool.reset(new srsran::circular_stack_pool<SRSENB_MAX_UES>(8, sizeof(ue), 4));
 }
 
 ngap::~ngap() {}
@@ -225,10 +228,10 @@ void ngap::initial_ue(uint16_t                             rnti,
                       asn1::ngap::rrcestablishment_cause_e cause,
                       srsran::const_byte_span              pdu)
 {
-  std::unique_ptr<ue> ue_ptr{new ue{this, rrc, gtpu, logger}};
-  ue_ptr->ctxt.rnti       = rnti;
-  ue_ptr->ctxt.gnb_cc_idx = gnb_cc_idx;
-  ue* u                   = users.add_user(std::move(ue_ptr));
+  user_list::value_type ue_ptr = srsran::make_pool_obj_with_fallback<ue>(*ue_pool, rnti, this, rrc, gtpu, logger);
+  ue_ptr->ctxt.rnti            = rnti;
+  ue_ptr->ctxt.gnb_cc_idx      = gnb_cc_idx;
+  ue* u                        = users.add_user(std::move(ue_ptr));
   if (u == nullptr) {
     logger.error("Failed to add rnti=0x%x", rnti);
     return;
@@ -242,10 +245,10 @@ void ngap::initial_ue(uint16_t                             rnti,
                       srsran::const_byte_span              pdu,
                       uint32_t                             s_tmsi)
 {
-  std::unique_ptr<ue> ue_ptr{new ue{this, rrc, gtpu, logger}};
-  ue_ptr->ctxt.rnti       = rnti;
-  ue_ptr->ctxt.gnb_cc_idx = gnb_cc_idx;
-  ue* u                   = users.add_user(std::move(ue_ptr));
+  user_list::value_type ue_ptr = srsran::make_pool_obj_with_fallback<ue>(*ue_pool, rnti, this, rrc, gtpu, logger);
+  ue_ptr->ctxt.rnti            = rnti;
+  ue_ptr->ctxt.gnb_cc_idx      = gnb_cc_idx;
+  ue* u                        = users.add_user(std::move(ue_ptr));
   if (u == nullptr) {
     logger.error("Failed to add rnti=0x%x", rnti);
     return;
@@ -319,7 +322,7 @@ ngap::ue* ngap::user_list::find_ue_amfid(uint64_t amfid)
   return it != users.end() ? it->second.get() : nullptr;
 }
 
-ngap::ue* ngap::user_list::add_user(std::unique_ptr<ngap::ue> user)
+ngap::ue* ngap::user_list::add_user(value_type user)
 {
   static srslog::basic_logger& logger = srslog::fetch_basic_logger("NGAP");
   // Check for ID repetitions
@@ -581,7 +584,13 @@ bool ngap::handle_ue_context_release_cmd(const asn1::ngap::ue_context_release_cm
     return false;
   }
 
-  return u->handle_ue_context_release_cmd(msg);
+  if (not u->handle_ue_context_release_cmd(msg)) {
+    return false;
+  }
+
+  // The UE Context Release Complete has been sent, the context goes back to the pool
+  users.erase(u);
+  return true;
 }
 
 bool ngap::handle_ue_pdu_session_res_setup_request(const asn1::ngap::pdu_session_res_setup_request_s& msg)
@@ -22,6 +22,7 @@
 #include "srsgnb/hdr/stack/ric/e2sm_kpm.h"
 #include "srsgnb/hdr/stack/ric/e2sm_kpm_metrics.h"
 #include "srsgnb/hdr/stack/ric/e2sm_kpm_report_service.h"
+#include <cmath>
 #include <numeric>
 
 const std::string e2sm_kpm::short_name       = "ORAN-E2SM-KPM";
@@ -238,6 +239,7 @@ bool e2sm_kpm::process_ric_action_definition(ri_caction_to_be_setup_item_s ric_a
 
   _generate_new_local_action_id();
 
+  std::lock_guard<std::mutex> lock(meas_mutex);
   registered_actions_data.insert(
       std::pair<uint32_t, e2sm_kpm_report_service*>(action_entry.sm_local_ric_action_id, report_service));
 
@@ -246,13 +248,19 @@ bool e2sm_kpm::process_ric_action_definition(ri_caction_to_be_setup_item_s ric_a
 
 bool e2sm_kpm::remove_ric_action_definition(E2AP_RIC_action_t& action_entry)
 {
-  if (registered_actions_data.count(action_entry.sm_local_ric_action_id)) {
-    registered_actions_data.at(action_entry.sm_local_ric_action_id)->stop();
-    delete registered_actions_data.at(action_entry.sm_local_ric_action_id);
-    registered_actions_data.erase(action_entry.sm_local_ric_action_id);
-    return true;
+  e2sm_kpm_report_service* report_service = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(meas_mutex);
+    auto                        it = registered_actions_data.find(action_entry.sm_local_ric_action_id);
+    if (it == registered_actions_data.end()) {
+      return false;
+    }
+    report_service = it->second;
+    registered_actions_data.erase(it);
   }
-  return false;
+  report_service->stop();
+  delete report_service;
+  return true;
 }
 
 bool e2sm_kpm::generate_ric_indication_content(E2AP_RIC_action_t& action_entry, ric_indication_t& ric_indication)
@@ -344,27 +352,31 @@ std::vector<std::string> e2sm_kpm::_get_supported_meas(uint32_t level_mask)
 
 void e2sm_kpm::receive_e2_metrics_callback(const enb_metrics_t& m)
 {
-  last_enb_metrics = m;
-  logger.debug("e2sm_kpm received new enb metrics, CPU0 Load: %.1f", last_enb_metrics.sys.cpu_load[0]);
+  logger.debug("e2sm_kpm received new enb metrics, CPU0 Load: %.1f", m.sys.cpu_load[0]);
+
+  // accumulate the new samples in every admitted action, so that the enb metrics are not kept until the next report
+  std::lock_guard<std::mutex> lock(meas_mutex);
+  for (auto& it : registered_actions_data) {
+    it.second->_sample_meas_data(m);
+  }
 }
 
-bool e2sm_kpm::_collect_meas_value(e2sm_kpm_meas_def_t& meas_value, meas_record_item_c& item)
+bool e2sm_kpm::_sample_meas_value(const e2sm_kpm_meas_def_t& meas_value,
+                                  const enb_metrics_t&       enb_metrics,
+                                  double&                    value)
 {
   // here we implement logic of measurement data collection, currently we only read from enb_metrics
   if (meas_value.data_type == meas_record_item_c::types::options::integer) {
-    uint32_t value;
-    if (_extract_integer_type_meas_value(meas_value, last_enb_metrics, value)) {
-      item.set_integer() = value;
+    uint32_t int_value;
+    if (_extract_integer_type_meas_value(meas_value, enb_metrics, int_value)) {
+      value = int_value;
       return true;
     }
   } else {
     // data_type == meas_record_item_c::types::options::real;
-    float value;
-    if (_extract_real_type_meas_value(meas_value, last_enb_metrics, value)) {
-      real_s real_value;
-      // TODO: real value seems to be not supported in asn1???
-      // real_value.value = value;
-      item.set_real() = real_value;
+    float real_value;
+    if (_extract_real_type_meas_value(meas_value, enb_metrics, real_value)) {
+      value = real_value;
       return true;
     }
   }
@@ -372,89 +384,97 @@ bool e2sm_kpm::_collect_meas_value(e2sm_kpm_meas_def_t& meas_value, meas_record_
   return false;
 }
 
-bool e2sm_kpm::_extract_integer_type_meas_value(e2sm_kpm_meas_def_t& meas_value,
-                                                const enb_metrics_t& enb_metrics,
-                                                uint32_t&            value)
+bool e2sm_kpm::_collect_meas_value(const e2sm_kpm_compiled_meas_t& meas, meas_record_item_c& item)
 {
-  // TODO: maybe add ID to metric types in e2sm_kpm_metrics definitions, so we do not have to compare strings?
-  // TODO: make string comparison case insensitive
-  // all integer type measurements
-  // test: no_label
-  if (meas_value.name.c_str() == std::string("test")) {
-    switch (meas_value.label) {
-      case NO_LABEL:
-        if (meas_value.scope & ENB_LEVEL) {
-          value = (int32_t)enb_metrics.sys.cpu_load[0];
-          printf("extract last \"test\" value as int, (filled with ENB_LEVEL metric: CPU0_load) value %i \n", value);
-          return true;
-        }
-        if (meas_value.scope & CELL_LEVEL) {
-          uint32_t cell_id = meas_value.cell_id;
-          value            = (int32_t)enb_metrics.stack.mac.cc_info[cell_id].cc_rach_counter;
-          printf("extract last \"test\" value as int, (filled with CELL_LEVEL metric: cc_rach_counter) value %i \n",
-                 value);
-          return true;
-        }
-        if (meas_value.scope & UE_LEVEL) {
-          uint32_t ue_id = meas_value.ue_id;
-          value          = (int32_t)enb_metrics.stack.mac.ues[ue_id].ul_rssi;
-          printf("extract last \"test\" value as int, (filled with UE_LEVEL metric: ul_rssi) value %i \n", value);
-          return true;
-        }
-      default:
-        return false;
-    }
+  double value;
+  if (not e2sm_kpm_meas_acc_get(meas.acc, meas.def.label, value)) {
+    // nothing sampled since the action was admitted
+    item.set_no_value();
+    return true;
   }
 
-  // random_int: no_label
-  if (meas_value.name.c_str() == std::string("random_int")) {
-    switch (meas_value.label) {
-      case NO_LABEL:
-        value = srsran_random_uniform_int_dist(random_gen, 0, 100);
-        printf("extract last \"random_int\" value as int, random value %i \n", value);
-        return true;
-      default:
-        return false;
-    }
+  if (meas.def.data_type == meas_record_item_c::types::options::integer) {
+    item.set_integer() = (uint64_t)std::lround(value);
+  } else {
+    real_s real_value;
+    // TODO: real value seems to be not supported in asn1???
+    // real_value.value = value;
+    item.set_real() = real_value;
   }
-
-  return false;
+  return true;
 }
 
-bool e2sm_kpm::_extract_real_type_meas_value(e2sm_kpm_meas_def_t& meas_value,
-                                             const enb_metrics_t& enb_metrics,
-                                             float&               value)
+bool e2sm_kpm::_extract_integer_type_meas_value(const e2sm_kpm_meas_def_t& meas_value,
+                                                const enb_metrics_t&       enb_metrics,
+                                                uint32_t&                  value)
 {
-  // all real type measurements
-  // cpu0_load: no_label
-  if (meas_value.name.c_str() == std::string("cpu0_load")) {
-    switch (meas_value.label) {
-      case NO_LABEL:
-        value = enb_metrics.sys.cpu_load[0];
-        return true;
-      default:
+  // all integer type measurements
+  switch (meas_value.id) {
+    // test: no_label
+    case KPM_METRIC_TEST:
+      if (meas_value.label != NO_LABEL) {
         return false;
-    }
-  }
-
-  // cpu_load: min,max,avg
-  if (meas_value.name.c_str() == std::string("cpu_load")) {
-    uint32_t size;
-    switch (meas_value.label) {
-      case MIN_LABEL:
-        value = *std::min_element(enb_metrics.sys.cpu_load.begin(), enb_metrics.sys.cpu_load.end());
+      }
+      if (meas_value.scope & ENB_LEVEL) {
+        // filled with ENB_LEVEL metric: CPU0_load
+        value = (int32_t)enb_metrics.sys.cpu_load[0];
         return true;
-      case MAX_LABEL:
-        value = *std::max_element(enb_metrics.sys.cpu_load.begin(), enb_metrics.sys.cpu_load.end());
+      }
+      if (meas_value.scope & CELL_LEVEL) {
+        // filled with CELL_LEVEL metric: cc_rach_counter
+        uint32_t cell_id = meas_value.cell_id;
+        value            = (int32_t)enb_metrics.stack.mac.cc_info[cell_id].cc_rach_counter;
         return true;
-      case AVG_LABEL:
-        size  = enb_metrics.sys.cpu_load.size();
-        value = std::accumulate(enb_metrics.sys.cpu_load.begin(), enb_metrics.sys.cpu_load.end(), 0.0 / size);
+      }
+      if (meas_value.scope & UE_LEVEL) {
+        // filled with UE_LEVEL metric: ul_rssi
+        uint32_t ue_id = meas_value.ue_id;
+        value          = (int32_t)enb_metrics.stack.mac.ues[ue_id].ul_rssi;
         return true;
-      default:
+      }
+      return false;
+    // random_int: no_label
+    case KPM_METRIC_RANDOM_INT:
+      if (meas_value.label != NO_LABEL) {
         return false;
-    }
+      }
+      value = srsran_random_uniform_int_dist(random_gen, 0, 100);
+      return true;
+    default:
+      return false;
   }
+}
 
-  return false;
+bool e2sm_kpm::_extract_real_type_meas_value(const e2sm_kpm_meas_def_t& meas_value,
+                                             const enb_metrics_t&       enb_metrics,
+                                             float&                     value)
+{
+  // all real type measurements
+  switch (meas_value.id) {
+    // cpu0_load: no_label
+    case KPM_METRIC_CPU0_LOAD:
+      if (meas_value.label != NO_LABEL) {
+        return false;
+      }
+      value = enb_metrics.sys.cpu_load[0];
+      return true;
+    // cpu_load: min,max,avg of all CPUs, accumulated over the granularity period with the same label
+    case KPM_METRIC_CPU_LOAD:
+      switch (meas_value.label) {
+        case MIN_LABEL:
+          value = *std::min_element(enb_metrics.sys.cpu_load.begin(), enb_metrics.sys.cpu_load.end());
+          return true;
+        case MAX_LABEL:
+          value = *std::max_element(enb_metrics.sys.cpu_load.begin(), enb_metrics.sys.cpu_load.end());
+          return true;
+        case AVG_LABEL:
+          value = std::accumulate(enb_metrics.sys.cpu_load.begin(), enb_metrics.sys.cpu_load.end(), 0.0) /
+                  enb_metrics.sys.cpu_load.size();
+          return true;
+        default:
+          return false;
+      }
+    default:
+      return false;
+  }
 }
\ No newline at end of file
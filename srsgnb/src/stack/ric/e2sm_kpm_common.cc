@@ -20,6 +20,7 @@
  */
 
 #include "srsgnb/hdr/stack/ric/e2sm_kpm_common.h"
+#include <algorithm>
 
 std::string e2sm_kpm_label_2_str(e2sm_kpm_label_enum label)
 {
@@ -37,4 +38,56 @@ std::string e2sm_kpm_label_2_str(e2sm_kpm_label_enum label)
     default:
       return "UNKNOWN_LABEL";
   }
-}
\ No newline at end of file
+}
+
+void e2sm_kpm_meas_acc_reset(e2sm_kpm_meas_acc_t& acc)
+{
+  acc.nof_samples = 0;
+  acc.min         = 0;
+  acc.max         = 0;
+  acc.sum         = 0;
+}
+
+void e2sm_kpm_meas_acc_add(e2sm_kpm_meas_acc_t& acc, double value)
+{
+  if (acc.nof_samples == 0) {
+    acc.min = value;
+    acc.max = value;
+  } else {
+    acc.min = std::min(acc.min, value);
+    acc.max = std::max(acc.max, value);
+  }
+  acc.sum += value;
+  acc.nof_samples++;
+  acc.last         = value;
+  acc.last_present = true;
+}
+
+bool e2sm_kpm_meas_acc_get(const e2sm_kpm_meas_acc_t& acc, e2sm_kpm_label_enum label, double& value)
+{
+  // without new samples in the period, repeat the last one
+  if (acc.nof_samples == 0) {
+    value = acc.last;
+    return acc.last_present;
+  }
+
+  switch (label) {
+    case NO_LABEL:
+      value = acc.last;
+      return true;
+    case MIN_LABEL:
+      value = acc.min;
+      return true;
+    case MAX_LABEL:
+      value = acc.max;
+      return true;
+    case AVG_LABEL:
+      value = acc.sum / acc.nof_samples;
+      return true;
+    case SUM_LABEL:
+      value = acc.sum;
+      return true;
+    default:
+      return false;
+  }
+}
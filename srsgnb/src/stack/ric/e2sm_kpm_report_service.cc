@@ -93,6 +93,17 @@ meas_record_item_c::types e2sm_kpm_report_service::_get_meas_data_type(std::stri
   return data_type;
 }
 
+void e2sm_kpm_report_service::_sample_meas_data(const enb_metrics_t& enb_metrics)
+{
+  // called with the parent measurement mutex locked
+  for (auto& meas : compiled_meas) {
+    double value;
+    if (parent->_sample_meas_value(meas.def, enb_metrics, value)) {
+      e2sm_kpm_meas_acc_add(meas.acc, value);
+    }
+  }
+}
+
 bool e2sm_kpm_report_service::_start_meas_collection()
 {
   if (granul_period) {
@@ -196,6 +207,32 @@ bool e2sm_kpm_report_service_style1::_initialize_ric_ind_msg()
         meas_info_item.label_info_list[l].meas_label.sum         = meas_label_s::sum_opts::true_value;
       }
     }
+
+    // resolve every measurement and label once, so that collecting a record does not need any lookup
+    e2sm_kpm_metric_t metric_definition;
+    if (not parent->_get_meas_definition(meas_name, metric_definition)) {
+      parent->logger.info("No definition for measurement type \"%s\"", meas_name.c_str());
+      return false;
+    }
+    for (const auto& label : _get_present_labels(meas_def_item)) {
+      e2sm_kpm_compiled_meas_t meas = {};
+      meas.def.name                 = meas_name;
+      meas.def.id                   = metric_definition.id;
+      meas.def.label                = label;
+      meas.def.scope                = ENB_LEVEL;
+      if (cell_global_id_present) {
+        meas.def.scope   = CELL_LEVEL;
+        meas.def.cell_id = 0;
+      }
+      meas.def.data_type = (metric_definition.data_type == INTEGER) ? meas_record_item_c::types::options::integer
+                                                                     : meas_record_item_c::types::options::real;
+      meas.meas_data_idx = i;
+      compiled_meas.push_back(meas);
+    }
+
+    // allocate the record list once, clearing it after a report keeps its capacity
+    ric_ind_message.meas_data[i].meas_record.resize(E2SM_KPM_RECORD_LIST_PREALLOC);
+    ric_ind_message.meas_data[i].meas_record.clear();
   }
 
   return true;
@@ -304,97 +341,19 @@ bool e2sm_kpm_report_service_style1::process_ric_action_definition(e2sm_kpm*
   return true;
 }
 
-meas_data_item_s& e2sm_kpm_report_service_style1::_get_meas_data_item(std::string         meas_name,
-                                                                      e2sm_kpm_label_enum label,
-                                                                      uint32_t            ue_id,
-                                                                      bool&               ref_found)
-{
-  meas_info_list_l& meas_info_list = ric_ind_message.meas_info_list;
-  ref_found                        = false;
-  // find proper index of the metric
-  for (uint32_t i = 0; i < meas_info_list.size(); i++) {
-    // measurements definition
-    meas_info_item_s meas_def_item = meas_info_list[i];
-    std::string      meas_def_name = meas_def_item.meas_type.meas_name().to_string();
-
-    // check if the metric name matches
-    if (meas_def_name != meas_name.c_str()) {
-      continue;
-    }
-
-    // check if the metric label matches
-    // TODO: add all labels defined in e2sm_kpm doc
-    for (uint32_t l = 0; l < meas_def_item.label_info_list.size(); l++) {
-      if (meas_def_item.label_info_list[l].meas_label.no_label_present and label == NO_LABEL) {
-        ref_found = true;
-        return ric_ind_message.meas_data[i];
-      }
-      if (meas_def_item.label_info_list[l].meas_label.min_present and label == MIN_LABEL) {
-        ref_found = true;
-        return ric_ind_message.meas_data[i];
-      }
-      if (meas_def_item.label_info_list[l].meas_label.max_present and label == MAX_LABEL) {
-        ref_found = true;
-        return ric_ind_message.meas_data[i];
-      }
-      if (meas_def_item.label_info_list[l].meas_label.avg_present and label == AVG_LABEL) {
-        ref_found = true;
-        return ric_ind_message.meas_data[i];
-      }
-      if (meas_def_item.label_info_list[l].meas_label.sum_present and label == SUM_LABEL) {
-        ref_found = true;
-        return ric_ind_message.meas_data[i];
-      }
-    }
-  }
-  // TODO assert if match == false, has to be present as was created during initialization
-  ref_found = false;
-  return ric_ind_message.meas_data[0];
-}
-
 bool e2sm_kpm_report_service_style1::_collect_meas_data()
 {
-  meas_info_list_l& meas_info_list = ric_ind_message.meas_info_list;
-  for (uint32_t i = 0; i < meas_info_list.size(); i++) {
-    meas_info_item_s&                meas_def_item = meas_info_list[i];
-    std::string                      meas_name     = meas_def_item.meas_type.meas_name().to_string();
-    std::vector<e2sm_kpm_label_enum> labels        = _get_present_labels(meas_def_item);
-
-    for (const auto& label : labels) {
-      // TODO: probably some labels need a special processing (e.g., use bin width that needs to be stored)
-      // get a proper record list
-      bool              ref_found      = false;
-      meas_data_item_s& meas_data_item = _get_meas_data_item(meas_name, label, 0, ref_found);
-      if (not ref_found) {
-        parent->logger.info("Cannot find a meas record list, action_id %i, metric \"%s\" label: %i",
-                            action_id,
-                            meas_name.c_str(),
-                            label);
-        return false;
-      }
-
-      // get data type
-      meas_record_item_c::types data_type = _get_meas_data_type(meas_name, label, meas_data_item.meas_record);
-
-      // extract a needed value from enb metrics and add to the proper meas record list
-      e2sm_kpm_meas_def_t meas_value;
-      meas_value.name  = meas_name;
-      meas_value.label = label;
-      meas_value.scope = ENB_LEVEL;
-      if (cell_global_id_present) {
-        meas_value.scope   = CELL_LEVEL;
-        meas_value.cell_id = 0;
-      }
-      meas_value.data_type = data_type;
-
+  {
+    // close the granularity period: add the accumulated value of every measurement to its record list
+    std::lock_guard<std::mutex> lock(parent->meas_mutex);
+    for (auto& meas : compiled_meas) {
       meas_record_item_c item;
-      if (not parent->_collect_meas_value(meas_value, item)) {
-        parent->logger.info("Cannot extract value \"%s\" label: %i", meas_name.c_str(), label);
+      if (not parent->_collect_meas_value(meas, item)) {
+        parent->logger.info("Cannot extract value \"%s\" label: %i", meas.def.name.c_str(), meas.def.label);
         return false;
       }
-
-      // save meas value in the proper record list
-      meas_data_item.meas_record.push_back(item);
+      ric_ind_message.meas_data[meas.meas_data_idx].meas_record.push_back(item);
+      e2sm_kpm_meas_acc_reset(meas.acc);
     }
   }
 
@@ -20,6 +20,7 @@
  */
 
 #include "srsgnb/hdr/stack/ric/e2ap.h"
+#include "srsgnb/hdr/stack/ric/e2sm_kpm.h"
 #include "srsran/asn1/e2ap.h"
 #include "srsran/common/test_common.h"
 #include "srsran/interfaces/e2_metrics_interface.h"
@@ -171,6 +172,89 @@ void test_native_e2ap_reset_response()
   TESTASSERT_EQ(asn1::SRSASN_SUCCESS, unpack_ret);
   printf("Unpacked native E2AP PDU RESET RESPONSE %d\n", (int)unpack_ret);
 }
+void test_e2sm_kpm_meas_accumulation()
+{
+  e2sm_kpm_meas_acc_t acc = {};
+  double              value;
+
+  // nothing to report before the first sample
+  TESTASSERT(not e2sm_kpm_meas_acc_get(acc, NO_LABEL, value));
+
+  e2sm_kpm_meas_acc_add(acc, 20);
+  e2sm_kpm_meas_acc_add(acc, 5);
+  e2sm_kpm_meas_acc_add(acc, 50);
+  TESTASSERT(e2sm_kpm_meas_acc_get(acc, NO_LABEL, value) and value == 50);
+  TESTASSERT(e2sm_kpm_meas_acc_get(acc, MIN_LABEL, value) and value == 5);
+  TESTASSERT(e2sm_kpm_meas_acc_get(acc, MAX_LABEL, value) and value == 50);
+  TESTASSERT(e2sm_kpm_meas_acc_get(acc, AVG_LABEL, value) and value == 25);
+  TESTASSERT(e2sm_kpm_meas_acc_get(acc, SUM_LABEL, value) and value == 75);
+
+  // a period without samples repeats the last one
+  e2sm_kpm_meas_acc_reset(acc);
+  TESTASSERT(e2sm_kpm_meas_acc_get(acc, MAX_LABEL, value) and value == 50);
+  e2sm_kpm_meas_acc_add(acc, 8);
+  TESTASSERT(e2sm_kpm_meas_acc_get(acc, MIN_LABEL, value) and value == 8);
+}
+
+void test_e2sm_kpm_report_service_style1()
+{
+  srslog::basic_logger&  logger = srslog::fetch_basic_logger("E2SM-KPM");
+  srsran::task_scheduler task_sched;
+  e2sm_kpm               kpm(logger, &task_sched);
+
+  // action with one integer measurement, sampled from the enb metrics
+  e2_sm_kpm_action_definition_s action_def;
+  action_def.ric_style_type = 1;
+  e2_sm_kpm_action_definition_format1_s& format1 =
+      action_def.action_definition_formats.set_action_definition_format1();
+  format1.granul_period = 1000;
+  format1.meas_info_list.resize(1);
+  format1.meas_info_list[0].meas_type.set_meas_name().from_string("test");
+  format1.meas_info_list[0].label_info_list.resize(1);
+  format1.meas_info_list[0].label_info_list[0].meas_label.no_label_present = true;
+  format1.meas_info_list[0].label_info_list[0].meas_label.no_label = meas_label_s::no_label_opts::true_value;
+
+  srsran::unique_byte_buffer_t  buf = srsran::make_byte_buffer();
+  asn1::bit_ref                 bref(buf->msg, buf->get_tailroom());
+  ri_caction_to_be_setup_item_s ric_action;
+  TESTASSERT_EQ(asn1::SRSASN_SUCCESS, action_def.pack(bref));
+  ric_action.ric_action_definition.resize(bref.distance_bytes());
+  std::copy(buf->msg, buf->msg + bref.distance_bytes(), ric_action.ric_action_definition.data());
+
+  E2AP_RIC_action_t action_entry = {};
+  TESTASSERT(kpm.process_ric_action_definition(ric_action, action_entry));
+
+  // one record per granularity period, the last sample of the period for NO_LABEL
+  enb_metrics_t metrics   = {};
+  uint32_t      samples[] = {10, 30};
+  for (uint32_t sample : samples) {
+    metrics.sys.cpu_load[0] = sample;
+    kpm.receive_e2_metrics_callback(metrics);
+  }
+  for (uint32_t i = 0; i < 2000; i++) {
+    task_sched.tic();
+  }
+  metrics.sys.cpu_load[0] = 55;
+  kpm.receive_e2_metrics_callback(metrics);
+  for (uint32_t i = 0; i < 1000; i++) {
+    task_sched.tic();
+  }
+
+  ric_indication_t ric_indication;
+  TESTASSERT(kpm.generate_ric_indication_content(action_entry, ric_indication));
+
+  e2_sm_kpm_ind_msg_s ind_msg;
+  asn1::cbit_ref      bref2(ric_indication.ri_cind_msg->msg, ric_indication.ri_cind_msg->N_bytes);
+  TESTASSERT_EQ(asn1::SRSASN_SUCCESS, ind_msg.unpack(bref2));
+  meas_record_l& records = ind_msg.ind_msg_formats.ind_msg_format1().meas_data[0].meas_record;
+  TESTASSERT_EQ(3, records.size());
+  TESTASSERT_EQ(30, records[0].integer());
+  TESTASSERT_EQ(30, records[1].integer());
+  TESTASSERT_EQ(55, records[2].integer());
+
+  TESTASSERT(kpm.remove_ric_action_definition(action_entry));
+}
+
 // add tets for set-up request and response
 
 int main()
@@ -181,6 +265,8 @@ int main()
   test_native_e2ap_subscription_response();
   test_native_e2ap_reset_request();
   test_native_e2ap_reset_response();
+  test_e2sm_kpm_meas_accumulation();
+  test_e2sm_kpm_report_service_style1();
   // call reset test functions here
   return 0;
 }
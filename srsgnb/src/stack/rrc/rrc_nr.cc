@@ -91,6 +91,9 @@ int rrc_nr::init(const rrc_nr_cfg_t&         cfg_,
   srsran_assert(ret == SRSRAN_SUCCESS, "Failed to configure MasterCellGroup");
   cell_ctxt->master_cell_group = std::move(master_cell_group);
 
+  // Initiate UE memory pool
+  ue_pool.reset(new srsran::circular_stack_pool<SRSENB_MAX_UES>(8, sizeof(ue), 4));
+
   // derived
   slot_dur_ms = 1;
 
@@ -194,7 +197,8 @@ int rrc_nr::add_user(uint16_t rnti, uint32_t pcell_cc_idx, bool start_msg3_timer
 {
   if (users.contains(rnti) == 0) {
     // If in the ue ctor, "start_msg3_timer" is set to true, this will start the MSG3 RX TIMEOUT at ue creation
-    users.insert(rnti, std::make_unique<ue>(this, rnti, pcell_cc_idx, start_msg3_timer));
+    users.insert(rnti,
+                 srsran::make_pool_obj_with_fallback<ue>(*ue_pool, rnti, this, rnti, pcell_cc_idx, start_msg3_timer));
     rlc->add_user(rnti);
     pdcp->add_user(rnti);
     logger.info("Added new user rnti=0x%x", rnti);
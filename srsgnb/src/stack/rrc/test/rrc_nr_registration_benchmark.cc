@@ -0,0 +1,282 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/*
+ * Measures the time the stack thread spends on SA registrations, i.e. UE context creation, RRCSetupRequest,
+ * RRCSetup and RRCSetupComplete up to the Initial UE Message sent by the NGAP, and on their release by the AMF, with
+ * the lower layers stubbed. The NGAP is connected over SCTP to an AMF stub on the local host.
+ */
+
+#include "rrc_nr_test_helpers.h"
+#include "srsgnb/hdr/stack/rrc/rrc_nr_config_utils.h"
+#include "srsgnb/src/stack/mac/test/sched_nr_cfg_generators.h"
+#include "srsgnb/src/stack/ngap/test/ngap_test_helpers.h"
+#include "srsran/common/bearer_manager.h"
+#include "srsran/common/rt_alloc_check.h"
+#include "srsran/common/test_common.h"
+#include <algorithm>
+#include <chrono>
+#include <getopt.h>
+
+using namespace asn1::rrc_nr;
+using namespace srsenb;
+using std::chrono::steady_clock;
+
+static uint32_t nof_ues    = SRSENB_MAX_UES;
+static uint32_t nof_rounds = 100;
+
+/// Reads the Initial UE Message sent by the NGAP and returns its RAN UE NGAP ID
+static uint64_t amf_read_initial_ue(amf_dummy& amf)
+{
+  srsran::unique_byte_buffer_t sdu = amf.read_msg();
+  TESTASSERT(sdu->N_bytes > 0);
+  asn1::ngap::ngap_pdu_c pdu;
+  asn1::cbit_ref         cbref(sdu->msg, sdu->N_bytes);
+  TESTASSERT_EQ(asn1::SRSASN_SUCCESS, pdu.unpack(cbref));
+  TESTASSERT_EQ(asn1::ngap::ngap_pdu_c::types_opts::init_msg, pdu.type().value);
+  TESTASSERT_EQ(ASN1_NGAP_ID_INIT_UE_MSG, pdu.init_msg().proc_code);
+  return pdu.init_msg().value.init_ue_msg()->ran_ue_ngap_id.value;
+}
+
+/// Packs the UE Context Release Command of the AMF for a UE
+static srsran::unique_byte_buffer_t amf_make_release_cmd(uint64_t ran_ue_ngap_id, uint64_t amf_ue_ngap_id)
+{
+  asn1::ngap::ngap_pdu_c pdu;
+  pdu.set_init_msg().load_info_obj(ASN1_NGAP_ID_UE_CONTEXT_RELEASE);
+  asn1::ngap::ue_context_release_cmd_s& cmd = pdu.init_msg().value.ue_context_release_cmd();
+  cmd->cause.value.set_nas().value          = asn1::ngap::cause_nas_opts::normal_release;
+
+  asn1::ngap::ue_ngap_id_pair_s& ids = cmd->ue_ngap_ids.value.set_ue_ngap_id_pair();
+  ids.ran_ue_ngap_id                 = ran_ue_ngap_id;
+  ids.amf_ue_ngap_id                 = amf_ue_ngap_id;
+
+  srsran::unique_byte_buffer_t buf = srsran::make_byte_buffer();
+  TESTASSERT(buf != nullptr);
+  asn1::bit_ref bref(buf->msg, buf->get_tailroom());
+  TESTASSERT_EQ(asn1::SRSASN_SUCCESS, pdu.pack(bref));
+  buf->N_bytes = bref.distance_bytes();
+  return buf;
+}
+
+static srsran::unique_byte_buffer_t make_pdu(const std::vector<uint8_t>& bytes)
+{
+  srsran::unique_byte_buffer_t pdu = srsran::make_byte_buffer();
+  if (pdu != nullptr) {
+    memcpy(pdu->msg, bytes.data(), bytes.size());
+    pdu->N_bytes = bytes.size();
+  }
+  return pdu;
+}
+
+template <class T>
+static std::vector<uint8_t> pack_msg(T& msg)
+{
+  std::vector<uint8_t> bytes(1024);
+  asn1::bit_ref        bref(bytes.data(), bytes.size());
+  srsran_assert(msg.pack(bref) == asn1::SRSASN_SUCCESS, "Failed to pack message");
+  bytes.resize(bref.distance_bytes());
+  return bytes;
+}
+
+static int64_t percentile(std::vector<int64_t> v, double p)
+{
+  std::sort(v.begin(), v.end());
+  return v[std::min(v.size() - 1, (size_t)(p * v.size()))];
+}
+
+int run_benchmark()
+{
+  srsran::task_scheduler task_sched;
+  phy_nr_dummy           phy_obj;
+  mac_nr_dummy           mac_obj;
+  rlc_nr_rrc_tester      rlc_obj;
+  pdcp_nr_rrc_tester     pdcp_obj;
+  enb_bearer_manager     bearer_mapper;
+  dummy_socket_manager   rx_sockets;
+
+  rrc_nr rrc_obj(&task_sched);
+  ngap   ngap_obj(&task_sched, srslog::fetch_basic_logger("NGAP"), &rx_sockets);
+
+  // NG Setup with the AMF stub
+  amf_dummy   amf("127.0.0.1", 38412);
+  ngap_args_t ngap_args   = {};
+  ngap_args.cell_id       = 0x01;
+  ngap_args.gnb_id        = 0x19B;
+  ngap_args.mcc           = 907;
+  ngap_args.mnc           = 70;
+  ngap_args.ngc_bind_addr = "127.0.0.100";
+  ngap_args.tac           = 7;
+  ngap_args.gtp_bind_addr = "127.0.0.100";
+  ngap_args.amf_addr      = "127.0.0.1";
+  ngap_args.gnb_name      = "srsgnb01";
+  TESTASSERT_SUCCESS(ngap_obj.init(ngap_args, &rrc_obj, nullptr));
+  run_ng_setup(ngap_obj, amf);
+  TESTASSERT(ngap_obj.is_amf_connected());
+
+  asn1::rrc_nr::rlc_cfg_c rlc_cfg;
+  rlc_cfg.set_um_bi_dir();
+  rlc_cfg.um_bi_dir().dl_um_rlc.t_reassembly = t_reassembly_e::ms50;
+
+  rrc_nr_cfg_t rrc_cfg_nr = {};
+  rrc_cfg_nr.cell_list.emplace_back();
+  generate_default_nr_cell(rrc_cfg_nr.cell_list[0]);
+  rrc_cfg_nr.cell_list[0].phy_cell.carrier.pci     = 500;
+  rrc_cfg_nr.cell_list[0].dl_arfcn                 = 368500;
+  rrc_cfg_nr.cell_list[0].band                     = 3;
+  rrc_cfg_nr.cell_list[0].phy_cell.carrier.nof_prb = 52;
+  rrc_cfg_nr.cell_list[0].duplex_mode              = SRSRAN_DUPLEX_MODE_FDD;
+  rrc_cfg_nr.is_standalone                         = true;
+  rrc_cfg_nr.enb_id                                = 0x19B;
+  rrc_cfg_nr.five_qi_cfg[9].configured             = true;
+  rrc_cfg_nr.five_qi_cfg[9].rlc_cfg                = rlc_cfg;
+  rrc_cfg_nr.five_qi_cfg[9].pdcp_cfg               = {};
+  srsran::string_to_mcc("001", &rrc_cfg_nr.mcc);
+  srsran::string_to_mnc("01", &rrc_cfg_nr.mnc);
+  set_derived_nr_cell_params(rrc_cfg_nr.is_standalone, rrc_cfg_nr.cell_list[0]);
+
+  TESTASSERT_SUCCESS(
+      rrc_obj.init(rrc_cfg_nr, &phy_obj, &mac_obj, &rlc_obj, &pdcp_obj, &ngap_obj, nullptr, bearer_mapper, nullptr));
+
+  // The UE messages are the same for every registration, they are packed once
+  ul_ccch_msg_s            setup_req_msg;
+  rrc_setup_request_ies_s& setup_req = setup_req_msg.msg.set_c1().set_rrc_setup_request().rrc_setup_request;
+  setup_req.establishment_cause.value = establishment_cause_opts::mo_sig;
+  setup_req.ue_id.set_random_value().from_number(0);
+  std::vector<uint8_t> setup_req_bytes = pack_msg(setup_req_msg);
+
+  ul_dcch_msg_s             complete_msg;
+  rrc_setup_complete_s&     complete     = complete_msg.msg.set_c1().set_rrc_setup_complete();
+  rrc_setup_complete_ies_s& complete_ies = complete.crit_exts.set_rrc_setup_complete();
+  complete.rrc_transaction_id            = 0;
+  complete_ies.sel_plmn_id               = 1;
+  complete_ies.ded_nas_msg.from_string("7E004179000D0100F110000000000000000000002E04F0F0F0F0");
+  std::vector<uint8_t> complete_bytes = pack_msg(complete_msg);
+
+  std::vector<int64_t>  reg_ns, rem_ns;
+  std::vector<uint64_t> ran_ue_ngap_ids(nof_ues);
+  uint64_t              reg_allocs = 0, rem_allocs = 0;
+  reg_ns.reserve(nof_ues * nof_rounds);
+  rem_ns.reserve(nof_ues * nof_rounds);
+  for (uint32_t round = 0; round < nof_rounds; round++) {
+    // Storm of registrations, all UEs attach back to back
+    for (uint32_t i = 0; i < nof_ues; i++) {
+      uint16_t                     rnti         = 0x4601 + i;
+      srsran::unique_byte_buffer_t setup_req_pdu = make_pdu(setup_req_bytes);
+      srsran::unique_byte_buffer_t complete_pdu  = make_pdu(complete_bytes);
+      TESTASSERT(setup_req_pdu != nullptr and complete_pdu != nullptr);
+
+      uint64_t allocs = srsran::get_nof_thread_heap_allocs();
+      auto     t0     = steady_clock::now();
+      TESTASSERT_SUCCESS(rrc_obj.add_user(rnti, 0));
+      rrc_obj.write_pdu(rnti, srsran::srb_to_lcid(srsran::nr_srb::srb0), std::move(setup_req_pdu));
+      task_sched.tic();
+      rrc_obj.write_pdu(rnti, srsran::srb_to_lcid(srsran::nr_srb::srb1), std::move(complete_pdu));
+      auto t1 = steady_clock::now();
+      reg_allocs += srsran::get_nof_thread_heap_allocs() - allocs;
+      reg_ns.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+      TESTASSERT_EQ(rnti, rlc_obj.last_sdu_rnti);
+      ran_ue_ngap_ids[i] = amf_read_initial_ue(amf);
+    }
+
+    // The AMF releases the UEs, the NGAP frees their context and the RRC sends the RRCRelease
+    for (uint32_t i = 0; i < nof_ues; i++) {
+      srsran::unique_byte_buffer_t release_cmd = amf_make_release_cmd(ran_ue_ngap_ids[i], i + 1);
+      sockaddr_in                  amf_addr    = {};
+      sctp_sndrcvinfo              rcvinfo     = {};
+
+      uint64_t allocs = srsran::get_nof_thread_heap_allocs();
+      auto     t0     = steady_clock::now();
+      TESTASSERT(ngap_obj.handle_amf_rx_msg(std::move(release_cmd), amf_addr, rcvinfo, 0));
+      auto t1 = steady_clock::now();
+      rem_allocs += srsran::get_nof_thread_heap_allocs() - allocs;
+      rem_ns.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+      TESTASSERT(amf.read_msg()->N_bytes > 0);
+    }
+
+    // The RRC removes the UEs once the RRCRelease delay has expired
+    for (uint32_t t = 0; t < 100; t++) {
+      task_sched.tic();
+    }
+  }
+
+  int64_t total_ns = 0;
+  for (int64_t t : reg_ns) {
+    total_ns += t;
+  }
+  printf("%d UEs x %d rounds: registration mean=%.1f us, p50=%.1f us, p99=%.1f us (%.0f registrations/s); "
+         "release p50=%.1f us\n",
+         nof_ues,
+         nof_rounds,
+         total_ns / 1000.0 / reg_ns.size(),
+         percentile(reg_ns, 0.5) / 1000.0,
+         percentile(reg_ns, 0.99) / 1000.0,
+         reg_ns.size() * 1e9 / total_ns,
+         percentile(rem_ns, 0.5) / 1000.0);
+#ifdef ENABLE_RT_ALLOC_CHECK
+  printf("Heap allocations per UE: registration %.1f, release %.1f\n",
+         (double)reg_allocs / reg_ns.size(),
+         (double)rem_allocs / rem_ns.size());
+#endif
+
+  ngap_obj.stop();
+  rrc_obj.stop();
+  return SRSRAN_SUCCESS;
+}
+
+void usage(char* prog)
+{
+  printf("Usage: %s [ur]\n", prog);
+  printf("\t-u Number of UEs registering in each round [Default %d, max %d]\n", nof_ues, SRSENB_MAX_UES);
+  printf("\t-r Number of rounds [Default %d]\n", nof_rounds);
+}
+
+void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "ur")) != -1) {
+    switch (opt) {
+      case 'u':
+        nof_ues = std::min((uint32_t)strtol(argv[optind], NULL, 10), (uint32_t)SRSENB_MAX_UES);
+        break;
+      case 'r':
+        nof_rounds = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+
+  srslog::fetch_basic_logger("RRC-NR").set_level(srslog::basic_levels::warning);
+  srslog::fetch_basic_logger("NGAP").set_level(srslog::basic_levels::warning);
+  srslog::fetch_basic_logger("ASN1").set_level(srslog::basic_levels::warning);
+  srslog::init();
+
+  TESTASSERT(run_benchmark() == SRSRAN_SUCCESS);
+
+  srslog::flush();
+  return SRSRAN_SUCCESS;
+}
@@ -81,6 +81,9 @@ public:
   void reconfiguration(const uint32_t& cc_idx, const bool& enable);
   void reset();
 
+  /******** Interface from RLC (RLC -> MAC) ****************/
+  void rlc_buffer_state(uint32_t lcid, uint32_t tx_queue, uint32_t prio_tx_queue);
+
   /******** set/get MAC configuration  ****************/
   void set_config(mac_cfg_t& mac_cfg);
   void set_config(sr_cfg_t& sr_cfg);
@@ -28,11 +28,14 @@
 
 #include "proc_bsr.h"
 #include "proc_phr.h"
+#include "srsran/adt/snapshot_buffer.h"
 #include "srsran/common/common.h"
 #include "srsran/interfaces/mac_interface_types.h"
 #include "srsran/mac/pdu.h"
 #include "srsran/srslog/srslog.h"
 #include "srsue/hdr/stack/mac_common/mux_base.h"
+#include <array>
+#include <atomic>
 #include <mutex>
 
 namespace srsue {
@@ -73,14 +76,22 @@ private:
 
   const static int MAX_NOF_SUBHEADERS = 20;
 
-  // Mutex for exclusive access
+  // Serializes the UL PDU assembly of the PHY workers. The stack thread only takes it to flush the Msg3 buffer
   std::mutex mutex;
 
   srslog::basic_logger& logger;
-  rlc_interface_mac*    rlc              = nullptr;
-  bsr_interface_mux*    bsr_procedure    = nullptr;
-  phr_proc*             phr_procedure    = nullptr;
-  uint16_t              pending_crnti_ce = 0;
+  rlc_interface_mac*    rlc           = nullptr;
+  bsr_interface_mux*    bsr_procedure = nullptr;
+  phr_proc*             phr_procedure = nullptr;
+  std::atomic<uint16_t> pending_crnti_ce{0};
+
+  // Logical channels sorted by priority, published by the stack thread on every setup_lcid(). The UL PDU assembly
+  // works on its own copy, which also holds the per-PDU buffer_len and sched_len
+  srsran::snapshot_buffer<std::vector<srsran::logical_channel_config_t>> lc_cfg_snapshot;
+  std::vector<srsran::logical_channel_config_t>                          tx_channels;
+
+  // Bj of each LCID (see 36.321 Sec 5.4.3.1), increased by the stack thread and consumed by the UL PDU assembly
+  std::array<std::atomic<int32_t>, SRSRAN_N_RADIO_BEARERS> bj = {};
 
   /* Msg3 Buffer */
   srsran::byte_buffer_t msg_buff;
@@ -89,8 +100,8 @@ private:
   srsran::sch_pdu pdu_msg;
 
   srsran::byte_buffer_t msg3_buff;
-  bool                  msg3_has_been_transmitted = false;
-  bool                  msg3_pending              = false;
+  std::atomic<bool>     msg3_has_been_transmitted{false};
+  std::atomic<bool>     msg3_pending{false};
 };
 
 } // namespace srsue
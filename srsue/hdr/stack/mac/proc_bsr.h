@@ -22,10 +22,13 @@
 #ifndef SRSUE_PROC_BSR_H
 #define SRSUE_PROC_BSR_H
 
-#include <map>
+#include <array>
+#include <atomic>
 #include <stdint.h>
 
 #include "proc_sr.h"
+#include "srsran/adt/snapshot_buffer.h"
+#include "srsran/common/common.h"
 #include "srsran/common/task_scheduler.h"
 #include "srsran/srslog/srslog.h"
 #include "srsue/hdr/stack/mac_common/mac_common.h"
@@ -55,6 +58,9 @@ public:
 
   /* MUX calls BSR to update buffer state of each LCG after all PDUs for this TTI have been packed */
   virtual void update_bsr_tti_end(const bsr_t* bsr) = 0;
+
+  /* MUX reads the bytes pending in the RLC of a LCID without locking the RLC */
+  virtual uint32_t get_rlc_buffer_state(uint32_t lcid) = 0;
 };
 
 class bsr_proc : public srsran::timer_callback, public bsr_interface_mux
@@ -69,15 +75,17 @@ public:
   void     setup_lcid(uint32_t lcid, uint32_t lcg, uint32_t priority);
   void     timer_expired(uint32_t timer_id);
   uint32_t get_buffer_state();
+  void     rlc_buffer_state(uint32_t lcid, uint32_t tx_queue, uint32_t prio_tx_queue);
+
+  // Called by MUX while assembling an UL PDU, they don't take any lock shared with the stack thread
   bool     need_to_send_bsr_on_ul_grant(uint32_t grant_size, uint32_t total_data, bsr_t* bsr);
   bool     generate_padding_bsr(uint32_t nof_padding_bytes, bsr_t* bsr);
   void     update_bsr_tti_end(const bsr_t* bsr);
+  uint32_t get_rlc_buffer_state(uint32_t lcid);
 
 private:
   const static int QUEUE_STATUS_PERIOD_MS = 1000;
 
-  std::mutex mutex;
-
   srsran::ext_task_sched_handle* task_sched = nullptr;
   srslog::basic_logger&          logger;
   rlc_interface_mac*             rlc = nullptr;
@@ -87,31 +95,39 @@ private:
 
   bool initiated = false;
 
-  const static int NOF_LCG = 4;
+  const static int NOF_LCG  = 4;
+  const static int NOF_LCID = SRSRAN_N_RADIO_BEARERS;
 
   typedef struct {
-    int      priority;
-    uint32_t old_buffer;
-    uint32_t new_buffer;
-  } lcid_t;
+    int lcg      = -1; // negative if the LCID is not configured
+    int priority = 0;
+  } lcid_cfg_t;
+  typedef std::array<lcid_cfg_t, NOF_LCID> lcid_cfg_list_t;
 
-  std::map<uint32_t, lcid_t> lcgs[NOF_LCG]; // groups LCID in LCG
+  // LCG and priority of each LCID. The stack thread owns lcid_cfg and publishes a copy for the UL PDU assembly
+  lcid_cfg_list_t                          lcid_cfg;
+  srsran::snapshot_buffer<lcid_cfg_list_t> lcid_cfg_snapshot;
 
-  mac_buffer_states_t old_buffer_state;
+  // Buffer state of each LCID. new_buffer is only used by the stack thread, old_buffer is also reset by the UL PDU
+  // assembly and rlc_buffer is written by the RLC whenever its buffer changes
+  std::array<uint32_t, NOF_LCID>              new_buffer = {};
+  std::array<std::atomic<uint32_t>, NOF_LCID> old_buffer = {};
+  std::array<std::atomic<uint32_t>, NOF_LCID> rlc_buffer = {};
 
-  uint32_t find_max_priority_lcg_with_data();
+  uint32_t find_max_priority_lcg_with_data(const lcid_cfg_list_t& cfg);
 
-  bsr_trigger_type_t triggered_bsr_type = NONE;
+  std::atomic<bsr_trigger_type_t> triggered_bsr_type{NONE};
 
   void     print_state();
   void     set_trigger(bsr_trigger_type_t new_trigger);
+  void     cancel_trigger(bsr_trigger_type_t trigger);
   void     update_new_data();
   void     update_old_buffer();
   bool     check_highest_channel();
   bool     check_new_data();
   bool     check_any_channel();
   uint32_t get_buffer_state_lcg(uint32_t lcg);
-  bool     generate_bsr(bsr_t* bsr, uint32_t nof_padding_bytes);
+  bool     generate_bsr(bsr_t* bsr, uint32_t nof_padding_bytes, bsr_trigger_type_t trigger);
   char*    bsr_type_tostring(bsr_trigger_type_t type);
   char*    bsr_format_tostring(bsr_format_t format);
 
@@ -61,11 +61,15 @@ public:
     return SRSRAN_SUCCESS;
   }
 
-  void print_logical_channel_state(const std::string& info)
+  void print_logical_channel_state(const std::string& info) { print_logical_channel_state(info, logical_channels); }
+
+protected:
+  static void print_logical_channel_state(const std::string&                                   info,
+                                          const std::vector<srsran::logical_channel_config_t>& channels)
   {
     std::string logline = info;
 
-    for (auto& channel : logical_channels) {
+    for (auto& channel : channels) {
       logline += "\n";
       logline += "- lcid=";
       logline += std::to_string(channel.lcid);
@@ -87,7 +91,6 @@ public:
     srslog::fetch_basic_logger("MAC").debug("%s", logline.c_str());
   }
 
-protected:
   static bool priority_compare(const srsran::logical_channel_config_t& u1, const srsran::logical_channel_config_t& u2)
   {
     return u1.priority <= u2.priority;
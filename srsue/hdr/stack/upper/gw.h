@@ -23,6 +23,7 @@
 #define SRSUE_GW_H
 
 #include "gw_metrics.h"
+#include "srsran/adt/circular_buffer.h"
 #include "srsran/common/buffer_pool.h"
 #include "srsran/common/common.h"
 #include "srsran/common/interfaces_common.h"
@@ -30,7 +31,9 @@
 #include "srsran/interfaces/ue_gw_interfaces.h"
 #include "srsran/srslog/srslog.h"
 #include "tft_packet_filter.h"
+#include "tun_offload.h"
 #include <atomic>
+#include <memory>
 #include <mutex>
 #include <net/if.h>
 #include <netinet/in.h>
@@ -47,6 +50,8 @@ struct gw_args_t {
   std::string netns;
   std::string tun_dev_name;
   std::string tun_dev_netmask;
+  uint32_t    tun_nof_queues = 1;     ///< TUN queues read in parallel, more than one opens it with IFF_MULTI_QUEUE
+  bool        tun_offload    = false; ///< Exchange TCP super-packets with the TUN device using IFF_VNET_HDR
 };
 
 class gw : public gw_interface_stack, public srsran::thread
@@ -74,7 +79,39 @@ public:
   bool is_running();
 
 private:
-  static const int GW_THREAD_PRIO = -1;
+  static const int      GW_THREAD_PRIO      = -1;
+  static const uint32_t TUN_READ_BATCH      = 32;  ///< Packets read from a TUN queue before handing them to the stack
+  static const int      TUN_POLL_TIMEOUT_MS = 100; ///< Period the idle TUN readers check run_enable with
+
+  /// Reader of one of the additional queues of a multi-queue TUN device
+  class tun_queue_reader : public srsran::thread
+  {
+  public:
+    tun_queue_reader(gw* parent_, uint32_t queue_);
+
+  private:
+    void     run_thread() override;
+    gw*      parent;
+    uint32_t queue;
+  };
+
+  /// Writer of the DL packets when the TUN offloads are enabled, coalescing the queued packets before writing them
+  class tun_dl_writer : public srsran::thread
+  {
+  public:
+    explicit tun_dl_writer(gw* parent_);
+    void push(srsran::unique_byte_buffer_t pdu);
+    void stop();
+
+  private:
+    static const uint32_t DL_QUEUE_SIZE = 1024;
+
+    void run_thread() override;
+
+    gw*                                                      parent;
+    srsran::dyn_blocking_queue<srsran::unique_byte_buffer_t> queue;
+    std::atomic<bool>                                        stopped = {false};
+  };
 
   stack_interface_gw* stack = nullptr;
 
@@ -83,7 +120,7 @@ private:
   std::atomic<bool> running    = {false};
   std::atomic<bool> run_enable = {false};
   int32_t           netns_fd   = 0;
-  int32_t           tun_fd     = 0;
+  int32_t           tun_fd     = 0; ///< First TUN queue, used for DL writes
   struct ifreq      ifr        = {};
   int32_t           sock       = 0;
   std::atomic<bool> if_up      = {false};
@@ -101,12 +138,23 @@ private:
   uint32_t                                       dl_tput_bytes = 0;
   std::chrono::high_resolution_clock::time_point metrics_tp; // stores time when last metrics have been taken
 
-  void run_thread();
-  int  init_if(char* err_str);
-  int  setup_if_addr4(uint32_t ip_addr, char* err_str);
-  int  setup_if_addr6(uint8_t* ipv6_if_id, char* err_str);
-  bool find_ipv6_addr(struct in6_addr* in6_out);
-  void del_ipv6_addr(struct in6_addr* in6p);
+  std::vector<int32_t>                           tun_queue_fds;
+  std::vector<std::unique_ptr<tun_queue_reader>> tun_readers;
+  std::unique_ptr<tun_dl_writer>                 dl_writer;
+
+  void    run_thread();
+  void    read_tun_queue(int32_t fd);
+  bool    is_valid_ip_pkt(const srsran::byte_buffer_t& pdu);
+  bool    send_ul_batch(std::vector<srsran::unique_byte_buffer_t>& pdus);
+  void    write_dl_batch(tun_gro_batch& batch);
+  ssize_t write_tun(const struct iovec* iov, int iovcnt);
+  void    stop_tun_readers();
+  void    close_tun_queues();
+  int     init_if(char* err_str);
+  int     setup_if_addr4(uint32_t ip_addr, char* err_str);
+  int     setup_if_addr6(uint8_t* ipv6_if_id, char* err_str);
+  bool    find_ipv6_addr(struct in6_addr* in6_out);
+  void    del_ipv6_addr(struct in6_addr* in6p);
 
   // MBSFN
   int                mbsfn_sock_fd                   = 0;  // Sink UDP socket file descriptor
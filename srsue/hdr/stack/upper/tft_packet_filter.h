@@ -24,8 +24,12 @@
 
 #include "srsran/asn1/liblte_mme.h"
 #include "srsran/common/buffer_pool.h"
+#include "srsran/common/rcu_ptr.h"
 #include "srsran/srslog/srslog.h"
+#include <map>
 #include <mutex>
+#include <unordered_map>
+#include <vector>
 
 namespace srsue {
 
@@ -62,6 +66,51 @@ const uint8_t IPV4_ADDR_SIZE = 4;
 const uint8_t IPV6_ADDR_SIZE = 16;
 const uint8_t UDP_PROTOCOL   = 0x11;
 const uint8_t TCP_PROTOCOL   = 0x06;
+const uint8_t ESP_PROTOCOL   = 0x32;
+
+/// Header fields of an outgoing IP packet compared by the packet filters, parsed once per packet
+struct tft_pkt_fields_t {
+  uint8_t  version        = 0;
+  uint8_t  protocol       = 0;
+  uint8_t  tos            = 0; ///< IPv4 type of service or IPv6 traffic class
+  bool     has_ports      = false;
+  bool     has_spi        = false;
+  uint16_t local_port     = 0; ///< Host byte order
+  uint16_t remote_port    = 0; ///< Host byte order
+  uint32_t flow_label     = 0;
+  uint32_t spi            = 0;
+  uint64_t local_addr[2]  = {}; ///< Source address as in the packet, IPv4 in the first 4 bytes
+  uint64_t remote_addr[2] = {}; ///< Destination address as in the packet, IPv4 in the first 4 bytes
+};
+
+/// Parses the fields of an IPv4 or IPv6 packet. Returns false if it is neither
+bool tft_parse_pkt_fields(const uint8_t* pkt, uint32_t len, tft_pkt_fields_t& fields);
+
+/**
+ * Packet filter in the form compared against the parsed packet fields: addresses and masks as 64-bit words, with the
+ * address already masked, and ports as ranges in host byte order. Components that are not active have masks and
+ * ranges that match any packet.
+ */
+struct tft_filter_rule_t {
+  uint8_t  eps_bearer_id       = 0;
+  uint32_t active_filters      = 0;
+  uint8_t  addr_version        = 0; ///< IP version required by the address components, 0 if there are none
+  uint64_t local_addr[2]       = {};
+  uint64_t local_addr_mask[2]  = {};
+  uint64_t remote_addr[2]      = {};
+  uint64_t remote_addr_mask[2] = {};
+  uint8_t  protocol_id         = 0;
+  uint16_t local_port_min      = 0;
+  uint16_t local_port_max      = UINT16_MAX;
+  uint16_t remote_port_min     = 0;
+  uint16_t remote_port_max     = UINT16_MAX;
+  uint8_t  tos                 = 0;
+  uint8_t  tos_mask            = 0;
+  uint32_t flow_label          = 0;
+  uint32_t spi                 = 0;
+
+  bool match(const tft_pkt_fields_t& pkt) const;
+};
 
 // TS 24.008 Table 10.5.162
 class tft_packet_filter_t
@@ -70,8 +119,8 @@ public:
   tft_packet_filter_t(uint8_t                                eps_bearer_id_,
                       const LIBLTE_MME_PACKET_FILTER_STRUCT& tft_,
                       srslog::basic_logger&                  logger);
-  bool match(const srsran::unique_byte_buffer_t& pdu);
-  bool filter_contains(uint16_t filtertype);
+  bool match(const srsran::unique_byte_buffer_t& pdu) const;
+  bool filter_contains(uint16_t filtertype) const;
 
   uint8_t  eps_bearer_id             = {};
   uint8_t  id                        = {};
@@ -97,17 +146,44 @@ public:
   uint8_t  type_of_service_mask      = {};
   uint8_t  flow_label[3]             = {};
 
+  tft_filter_rule_t rule;
+
   srslog::basic_logger& logger;
 
-  bool match_ip(const srsran::unique_byte_buffer_t& pdu);
-  bool match_protocol(const srsran::unique_byte_buffer_t& pdu);
-  bool match_type_of_service(const srsran::unique_byte_buffer_t& pdu);
-  bool match_flow_label(const srsran::unique_byte_buffer_t& pdu);
-  bool match_port(const srsran::unique_byte_buffer_t& pdu);
+private:
+  void compile_rule();
 };
 
 /**
- * TFT PDU matcher class used by GW and TTCN3 DUT testloop handler
+ * Classifier compiled from the packet filters of all the TFTs. The rules are kept in precedence order and indexed by
+ * single remote port, single local port or protocol, so that a packet is only compared with the rules that can match
+ * it. It is immutable once built.
+ */
+class tft_classifier
+{
+public:
+  explicit tft_classifier(const std::map<uint16_t, tft_packet_filter_t>& filters);
+
+  /// Returns the rule with the highest precedence that matches the packet, or nullptr if none does
+  const tft_filter_rule_t* classify(const tft_pkt_fields_t& pkt) const;
+
+  uint32_t size() const { return rules.size(); }
+
+private:
+  using rule_list_t = std::vector<uint32_t>;
+
+  bool find_first(const rule_list_t& list, const tft_pkt_fields_t& pkt, uint32_t& best) const;
+
+  std::vector<tft_filter_rule_t>            rules;
+  std::unordered_map<uint16_t, rule_list_t> rules_by_remote_port;
+  std::unordered_map<uint16_t, rule_list_t> rules_by_local_port;
+  std::unordered_map<uint8_t, rule_list_t>  rules_by_protocol;
+  rule_list_t                               other_rules;
+};
+
+/**
+ * TFT PDU matcher class used by GW and TTCN3 DUT testloop handler.
+ * The filters are compiled into a classifier on every TFT update, which the data path reads without locking.
  */
 class tft_pdu_matcher
 {
@@ -123,10 +199,13 @@ public:
   void    delete_tft_for_eps_bearer(const uint8_t eps_bearer_id);
 
 private:
+  void update_classifier();
+
   srslog::basic_logger&                           logger;
   std::mutex                                      tft_mutex;
   typedef std::map<uint16_t, tft_packet_filter_t> tft_filter_map_t;
   tft_filter_map_t                                tft_filter_map;
+  srsran::rcu_ptr<tft_classifier>                 classifier;
 };
 
 } // namespace srsue
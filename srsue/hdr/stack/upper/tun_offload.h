@@ -0,0 +1,134 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSUE_TUN_OFFLOAD_H
+#define SRSUE_TUN_OFFLOAD_H
+
+#include "srsran/common/byte_buffer.h"
+#include <functional>
+#include <sys/uio.h>
+#include <vector>
+
+namespace srsue {
+
+/**
+ * Header in front of every packet exchanged with a TUN device opened with IFF_VNET_HDR, in host byte order. Same layout
+ * as struct virtio_net_hdr, whose kernel header can not be included from C++.
+ */
+struct tun_vnet_hdr_t {
+  uint8_t  flags;
+  uint8_t  gso_type;
+  uint16_t hdr_len;     ///< IP and TCP headers
+  uint16_t gso_size;    ///< Payload of each segment
+  uint16_t csum_start;  ///< Start of the data to sum when completing the checksum
+  uint16_t csum_offset; ///< Position of the checksum from csum_start
+};
+
+const uint32_t TUN_VNET_HDR_LEN          = sizeof(tun_vnet_hdr_t);
+const uint8_t  TUN_VNET_HDR_F_NEEDS_CSUM = 1;
+const uint8_t  TUN_VNET_HDR_GSO_NONE     = 0;
+const uint8_t  TUN_VNET_HDR_GSO_TCPV4    = 1;
+const uint8_t  TUN_VNET_HDR_GSO_TCPV6    = 4;
+const uint8_t  TUN_VNET_HDR_GSO_ECN      = 0x80;
+
+/// Largest packet exchanged with a TUN device with TSO enabled, virtio-net header excluded
+const uint32_t TUN_GSO_MAX_PKT_LEN = 65535;
+
+/// Receives the packets split by tun_gso_split(). Each packet is made of the headers followed by the payload
+using tun_gso_segment_fn =
+    std::function<void(const uint8_t* hdr, uint32_t hdr_len, const uint8_t* payload, uint32_t payload_len)>;
+
+/**
+ * Splits a packet read from a TUN device with IFF_VNET_HDR into IP packets. TCP GSO super-packets are cut into
+ * segments of gso_size payload bytes, with the lengths, IPv4 identification, TCP sequence number, flags and checksums
+ * of each segment rebuilt, so that the super-packet is only segmented at the PDCP SDU boundary. Packets with a
+ * partial checksum get it completed. Other packets are passed through unchanged.
+ *
+ * @param vnet_hdr header read in front of the packet
+ * @param pkt packet, modified in place when its checksum is completed
+ * @param len packet length, virtio-net header excluded
+ * @param segment_fn called once per resulting packet
+ * @return number of packets passed to segment_fn, or -1 if the packet is malformed or the GSO type is not supported
+ */
+int tun_gso_split(const tun_vnet_hdr_t&     vnet_hdr,
+                  uint8_t*                  pkt,
+                  uint32_t                  len,
+                  const tun_gso_segment_fn& segment_fn);
+
+/**
+ * Coalesces consecutive in-order TCP segments of the same flow into a GSO super-packet, which is written to a TUN
+ * device with IFF_VNET_HDR in a single system call and handled by the host stack as one packet, as after GRO in a
+ * NIC driver. Segments are not copied: the super-packet is written as an I/O vector made of the first segment,
+ * whose headers are updated in place, and the payload of the following segments.
+ *
+ * Any other packet, or a segment that does not continue the pending flow, is rejected by add(), after which the
+ * pending packet is written and the rejected one added again, so that the packet order is always preserved.
+ */
+class tun_gro_batch
+{
+public:
+  /// Maximum number of segments merged into one super-packet
+  static const uint32_t MAX_SEGMENTS = 64;
+
+  tun_gro_batch();
+
+  bool empty() const { return pdus.empty(); }
+  /// Number of segments of the pending packet
+  uint32_t size() const { return pdus.size(); }
+
+  /**
+   * Takes the packet if the batch is empty or if the packet extends the pending super-packet.
+   * @return true if the packet has been taken, false if the pending packet shall be written first
+   */
+  bool add(srsran::unique_byte_buffer_t& pdu);
+
+  /**
+   * Completes the virtio-net header and the headers of the pending packet.
+   * @return I/O vector holding the packet, valid until clear() or the next add()
+   */
+  const std::vector<struct iovec>& prepare();
+
+  /// Releases the pending packet
+  void clear();
+
+private:
+  struct flow_t {
+    uint32_t ip_hdr_len;
+    uint32_t tcp_hdr_len;
+    uint32_t mss;
+    uint32_t next_seq;
+    uint32_t total_len;
+    uint16_t next_ip_id;
+    bool     closed;
+  };
+
+  bool can_start(const srsran::byte_buffer_t& pdu, flow_t& f) const;
+  bool can_append(const srsran::byte_buffer_t& pdu) const;
+
+  std::vector<srsran::unique_byte_buffer_t> pdus;
+  std::vector<struct iovec>                 iov;
+  tun_vnet_hdr_t                            vnet_hdr = {};
+  flow_t                                    flow     = {};
+};
+
+} // namespace srsue
+
+#endif // SRSUE_TUN_OFFLOAD_H
@@ -632,6 +632,12 @@ void mac::setup_lcid(const logical_channel_config_t& config)
   bsr_procedure.setup_lcid(config.lcid, config.lcg, config.priority);
 }
 
+// Called by the RLC whenever the buffer of a bearer changes, from the stack thread or from the UL PDU assembly
+void mac::rlc_buffer_state(uint32_t lcid, uint32_t tx_queue, uint32_t prio_tx_queue)
+{
+  bsr_procedure.rlc_buffer_state(lcid, tx_queue, prio_tx_queue);
+}
+
 void mac::mch_start_rx(uint32_t lcid)
 {
   demux_unit.mch_start_rx(lcid);
@@ -45,10 +45,8 @@ void mux::init(rlc_interface_mac* rlc_, bsr_interface_mux* bsr_procedure_, phr_p
 
 void mux::reset()
 {
-  std::lock_guard<std::mutex> lock(mutex);
-
-  for (auto& channel : logical_channels) {
-    channel.Bj = 0;
+  for (auto& b : bj) {
+    b.store(0, std::memory_order_relaxed);
   }
   msg3_pending     = false;
   pending_crnti_ce = 0;
@@ -56,16 +54,20 @@ void mux::reset()
 
 void mux::step()
 {
-  std::lock_guard<std::mutex> lock(mutex);
-
   // update Bj according to 36.321 Sec 5.4.3.1
   for (auto& channel : logical_channels) {
-    // Add PRB unless it's infinity
-    if (channel.PBR >= 0) {
-      channel.Bj += channel.PBR; // PBR is in kByte/s, conversion in Byte and ms not needed
-    }
-    channel.Bj = SRSRAN_MIN((uint32_t)channel.Bj, channel.bucket_size);
-    Debug("Update Bj: lcid=%d, Bj=%d", channel.lcid, channel.Bj);
+    std::atomic<int32_t>& channel_bj = bj[channel.lcid];
+    int32_t               cur_bj     = channel_bj.load(std::memory_order_relaxed);
+    int32_t               new_bj;
+    do {
+      new_bj = cur_bj;
+      // Add PRB unless it's infinity
+      if (channel.PBR >= 0) {
+        new_bj += channel.PBR; // PBR is in kByte/s, conversion in Byte and ms not needed
+      }
+      new_bj = SRSRAN_MIN((uint32_t)new_bj, channel.bucket_size);
+    } while (not channel_bj.compare_exchange_weak(cur_bj, new_bj, std::memory_order_relaxed));
+    Debug("Update Bj: lcid=%d, Bj=%d", channel.lcid, new_bj);
   }
 }
 
@@ -82,8 +84,15 @@ bool mux::is_pending_any_sdu()
 // This is called by RRC (stack thread) during bearer addition
 void mux::setup_lcid(const logical_channel_config_t& config)
 {
-  std::lock_guard<std::mutex> lock(mutex);
+  if (config.lcid >= SRSRAN_N_RADIO_BEARERS) {
+    Error("Invalid lcid=%d", config.lcid);
+    return;
+  }
   mux_base::setup_lcid(config);
+  bj[config.lcid].store(config.Bj, std::memory_order_relaxed);
+
+  lc_cfg_snapshot.write_buffer() = logical_channels;
+  lc_cfg_snapshot.publish();
 }
 
 // mutex should be hold by caller
@@ -114,33 +123,39 @@ uint8_t* mux::pdu_get(srsran::byte_buffer_t* payload, uint32_t pdu_sz)
 // Multiplexing and logical channel priorization as defined in Section 5.4.3
 uint8_t* mux::pdu_get_nolock(srsran::byte_buffer_t* payload, uint32_t pdu_sz)
 {
+  // Take the last logical channel configuration published by the stack thread
+  if (lc_cfg_snapshot.update()) {
+    tx_channels = lc_cfg_snapshot.read_buffer();
+  }
+
   // Logical Channel Procedure
   payload->clear();
   pdu_msg.init_tx(payload, pdu_sz, true);
 
   // MAC control element for C-RNTI or data from UL-CCCH
+  uint16_t crnti_ce = pending_crnti_ce.exchange(0, std::memory_order_relaxed);
   if (!allocate_sdu(0, &pdu_msg, pdu_sz)) {
-    if (pending_crnti_ce) {
+    if (crnti_ce) {
       if (pdu_msg.new_subh()) {
-        if (!pdu_msg.get()->set_c_rnti(pending_crnti_ce)) {
+        if (!pdu_msg.get()->set_c_rnti(crnti_ce)) {
           Warning("Pending C-RNTI CE could not be inserted in MAC PDU");
         }
       }
     }
   } else {
-    if (pending_crnti_ce) {
+    if (crnti_ce) {
       Warning("Pending C-RNTI CE was not inserted because message was for CCCH");
     }
   }
-  pending_crnti_ce = 0;
 
   // Calculate pending UL data per LCID and LCG as well as the total amount
   bsr_proc::bsr_t bsr                = {}; // pending data per LCG
   int             total_pending_data = 0;
   int             last_sdu_len       = 0;
-  for (auto& channel : logical_channels) {
+  for (auto& channel : tx_channels) {
+    channel.Bj         = bj[channel.lcid].load(std::memory_order_relaxed);
     channel.sched_len  = 0; // reset sched_len for LCID
-    channel.buffer_len = rlc->get_buffer_state(channel.lcid);
+    channel.buffer_len = bsr_procedure->get_rlc_buffer_state(channel.lcid);
     total_pending_data += channel.buffer_len + sch_pdu::size_header_sdu(channel.buffer_len);
     last_sdu_len = channel.buffer_len;
     bsr.buff_size[channel.lcg] += channel.buffer_len;
@@ -184,11 +199,12 @@ uint8_t* mux::pdu_get_nolock(srsran::byte_buffer_t* payload, uint32_t pdu_sz)
   // data from any Logical Channel, except data from UL-CCCH;
   // first only those with positive Bj
   uint32_t last_sdu_subheader_len = 0; // needed to keep track of added SDUs and actual required subheades
-  for (auto& channel : logical_channels) {
+  for (auto& channel : tx_channels) {
     int max_sdu_sz = (channel.PBR < 0) ? -1 : channel.Bj; // this can be zero if no PBR has been allocated
     if (max_sdu_sz != 0) {
       if (sched_sdu(&channel, &sdu_space, max_sdu_sz)) {
         channel.Bj -= channel.sched_len;
+        bj[channel.lcid].fetch_sub(channel.sched_len, std::memory_order_relaxed);
         // account for (possible) subheader needed for next SDU
         last_sdu_subheader_len = SRSRAN_MIN((uint32_t)sdu_space, sch_pdu::size_header_sdu(channel.sched_len));
         sdu_space -= last_sdu_subheader_len;
@@ -200,10 +216,10 @@ uint8_t* mux::pdu_get_nolock(srsran::byte_buffer_t* payload, uint32_t pdu_sz)
     sdu_space += last_sdu_subheader_len;
   }
 
-  print_logical_channel_state("First round of allocation:");
+  mux_base::print_logical_channel_state("First round of allocation:", tx_channels);
 
   // If resources remain, allocate regardless of their Bj value
-  for (auto& channel : logical_channels) {
+  for (auto& channel : tx_channels) {
     if (channel.lcid != 0) {
       // allocate subheader if this LCID has not been scheduled yet but there is data to send
       if (channel.sched_len == 0 && channel.buffer_len > 0) {
@@ -213,9 +229,9 @@ uint8_t* mux::pdu_get_nolock(srsran::byte_buffer_t* payload, uint32_t pdu_sz)
     }
   }
 
-  print_logical_channel_state("Second round of allocation:");
+  mux_base::print_logical_channel_state("Second round of allocation:", tx_channels);
 
-  for (auto& channel : logical_channels) {
+  for (auto& channel : tx_channels) {
     if (channel.sched_len != 0) {
       uint32_t sdu_len = allocate_sdu(channel.lcid, &pdu_msg, channel.sched_len);
 
@@ -253,7 +269,6 @@ uint8_t* mux::pdu_get_nolock(srsran::byte_buffer_t* payload, uint32_t pdu_sz)
 
 void mux::append_crnti_ce_next_tx(uint16_t crnti)
 {
-  std::lock_guard<std::mutex> lock(mutex);
   pending_crnti_ce = crnti;
 }
 
@@ -286,7 +301,7 @@ uint32_t mux::allocate_sdu(uint32_t lcid, srsran::sch_pdu* pdu_msg, int max_sdu_
 {
   uint32_t total_sdu_len = 0;
   int32_t  sdu_space     = max_sdu_sz;
-  int32_t  buffer_state  = rlc->get_buffer_state(lcid);
+  int32_t  buffer_state  = bsr_procedure->get_rlc_buffer_state(lcid);
 
   while (buffer_state > 0 && sdu_space > 0) { // there is pending SDU to allocate
     int requested_sdu_len = SRSRAN_MIN(buffer_state, sdu_space);
@@ -306,7 +321,7 @@ uint32_t mux::allocate_sdu(uint32_t lcid, srsran::sch_pdu* pdu_msg, int max_sdu_
         sdu_space -= sdu_len;
         total_sdu_len += sdu_len;
 
-        buffer_state = rlc->get_buffer_state(lcid);
+        buffer_state = bsr_procedure->get_rlc_buffer_state(lcid);
       } else {
         Debug("Couldn't allocate new SDU (buffer_state=%d, requested_sdu_len=%d, sdu_len=%d, sdu_space=%d, "
               "remaining=%d, get_sdu_space=%d)",
@@ -344,20 +359,17 @@ void mux::msg3_flush()
 
 bool mux::msg3_is_transmitted()
 {
-  std::lock_guard<std::mutex> lock(mutex);
   return msg3_has_been_transmitted;
 }
 
 void mux::msg3_prepare()
 {
-  std::lock_guard<std::mutex> lock(mutex);
   msg3_has_been_transmitted = false;
   msg3_pending              = true;
 }
 
 bool mux::msg3_is_pending()
 {
-  std::lock_guard<std::mutex> lock(mutex);
   return msg3_pending;
 }
 
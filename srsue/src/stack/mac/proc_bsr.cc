@@ -54,14 +54,14 @@ void bsr_proc::print_state()
     return;
   }
 
-  std::lock_guard<std::mutex> lock(mutex);
-
   char str[128];
   str[0] = '\0';
   int n  = 0;
-  for (auto& lcg : lcgs) {
-    for (auto& iter : lcg) {
-      n = srsran_print_check(str, 128, n, "%d: %d ", iter.first, iter.second.old_buffer);
+  for (int i = 0; i < NOF_LCG; i++) {
+    for (uint32_t lcid = 0; lcid < NOF_LCID; lcid++) {
+      if (lcid_cfg[lcid].lcg == i) {
+        n = srsran_print_check(str, 128, n, "%d: %d ", lcid, old_buffer[lcid].load(std::memory_order_relaxed));
+      }
     }
   }
   logger.info(
@@ -70,29 +70,31 @@ void bsr_proc::print_state()
 
 void bsr_proc::set_trigger(bsr_trigger_type_t new_trigger)
 {
-  triggered_bsr_type = new_trigger;
+  triggered_bsr_type.store(new_trigger, std::memory_order_relaxed);
 
   // Trigger SR always when Regular BSR is triggered in the current TTI. Will be cancelled if a grant is received
-  if (triggered_bsr_type == REGULAR) {
+  if (new_trigger == REGULAR) {
     logger.debug("BSR:   Triggering SR procedure");
     sr->start();
   }
 }
 
-void bsr_proc::reset()
+// Cancels the trigger seen by the UL PDU assembly, unless the stack thread has set a new one in the meantime
+void bsr_proc::cancel_trigger(bsr_trigger_type_t trigger)
 {
-  std::lock_guard<std::mutex> lock(mutex);
+  triggered_bsr_type.compare_exchange_strong(trigger, NONE, std::memory_order_relaxed);
+}
 
+void bsr_proc::reset()
+{
   timer_periodic.stop();
   timer_retx.stop();
 
-  triggered_bsr_type = NONE;
+  set_trigger(NONE);
 }
 
 void bsr_proc::set_config(srsran::bsr_cfg_t& bsr_cfg_)
 {
-  std::lock_guard<std::mutex> lock(mutex);
-
   bsr_cfg = bsr_cfg_;
 
   if (bsr_cfg_.periodic_timer > 0) {
@@ -108,8 +110,6 @@ void bsr_proc::set_config(srsran::bsr_cfg_t& bsr_cfg_)
 /* Process Periodic BSR */
 void bsr_proc::timer_expired(uint32_t timer_id)
 {
-  std::lock_guard<std::mutex> lock(mutex);
-
   // periodicBSR-Timer
   if (timer_id == timer_periodic.id()) {
     if (triggered_bsr_type == NONE) {
@@ -130,35 +130,45 @@ void bsr_proc::timer_expired(uint32_t timer_id)
 
 uint32_t bsr_proc::get_buffer_state()
 {
-  std::lock_guard<std::mutex> lock(mutex);
-
   uint32_t buffer = 0;
-  for (int i = 0; i < NOF_LCG; i++) {
-    buffer += get_buffer_state_lcg(i);
+  for (const auto& b : old_buffer) {
+    buffer += b.load(std::memory_order_relaxed);
   }
   return buffer;
 }
 
+// Called by the RLC whenever the buffer of a LCID changes, from the thread that changed it
+void bsr_proc::rlc_buffer_state(uint32_t lcid, uint32_t tx_queue, uint32_t prio_tx_queue)
+{
+  if (lcid < NOF_LCID) {
+    rlc_buffer[lcid].store(tx_queue + prio_tx_queue, std::memory_order_relaxed);
+  }
+}
+
+uint32_t bsr_proc::get_rlc_buffer_state(uint32_t lcid)
+{
+  return lcid < NOF_LCID ? rlc_buffer[lcid].load(std::memory_order_relaxed) : 0;
+}
+
 // Checks if data is available for a channel with higher priority than others
 bool bsr_proc::check_highest_channel()
 {
   for (int i = 0; i < NOF_LCG; i++) {
-    for (std::map<uint32_t, lcid_t>::iterator iter = lcgs[i].begin(); iter != lcgs[i].end(); ++iter) {
+    for (uint32_t lcid = 0; lcid < NOF_LCID; lcid++) {
       // If new data available
-      if (iter->second.new_buffer > iter->second.old_buffer) {
+      if (lcid_cfg[lcid].lcg == i && new_buffer[lcid] > old_buffer[lcid].load(std::memory_order_relaxed)) {
         // Check if this LCID has higher priority than any other LCID ("belong to any LCG") for which data is already
         // available for transmission
         bool is_max_priority = true;
-        for (int j = 0; j < NOF_LCG; j++) {
-          for (std::map<uint32_t, lcid_t>::iterator iter2 = lcgs[j].begin(); iter2 != lcgs[j].end(); ++iter2) {
-            // No max prio LCG if prio isn't higher or LCID already had buffered data
-            if (iter2->second.priority <= iter->second.priority && (iter2->second.old_buffer > 0)) {
-              is_max_priority = false;
-            }
+        for (uint32_t lcid2 = 0; lcid2 < NOF_LCID; lcid2++) {
+          // No max prio LCG if prio isn't higher or LCID already had buffered data
+          if (lcid_cfg[lcid2].lcg >= 0 && lcid_cfg[lcid2].priority <= lcid_cfg[lcid].priority &&
+              old_buffer[lcid2].load(std::memory_order_relaxed) > 0) {
+            is_max_priority = false;
           }
         }
         if (is_max_priority) {
-          logger.debug("BSR:   New data for lcid=%d with maximum priority in lcg=%d", iter->first, i);
+          logger.debug("BSR:   New data for lcid=%d with maximum priority in lcg=%d", lcid, i);
           return true;
         }
       }
@@ -183,9 +193,9 @@ bool bsr_proc::check_new_data()
   for (int i = 0; i < NOF_LCG; i++) {
     // If there was no data available in any LCID belonging to this LCG
     if (get_buffer_state_lcg(i) == 0) {
-      for (std::map<uint32_t, lcid_t>::iterator iter = lcgs[i].begin(); iter != lcgs[i].end(); ++iter) {
-        if (iter->second.new_buffer > 0) {
-          logger.debug("BSR:   New data available for lcid=%d", iter->first);
+      for (uint32_t lcid = 0; lcid < NOF_LCID; lcid++) {
+        if (lcid_cfg[lcid].lcg == i && new_buffer[lcid] > 0) {
+          logger.debug("BSR:   New data available for lcid=%d", lcid);
           return true;
         }
       }
@@ -194,20 +204,22 @@ bool bsr_proc::check_new_data()
   return false;
 }
 
+// Also refreshes the RLC buffer state of each LCID, in case the RLC has not reported a change
 void bsr_proc::update_new_data()
 {
-  for (int i = 0; i < NOF_LCG; i++) {
-    for (std::map<uint32_t, lcid_t>::iterator iter = lcgs[i].begin(); iter != lcgs[i].end(); ++iter) {
-      iter->second.new_buffer = rlc->get_buffer_state(iter->first);
+  for (uint32_t lcid = 0; lcid < NOF_LCID; lcid++) {
+    if (lcid_cfg[lcid].lcg >= 0) {
+      new_buffer[lcid] = rlc->get_buffer_state(lcid);
+      rlc_buffer[lcid].store(new_buffer[lcid], std::memory_order_relaxed);
     }
   }
 }
 
 void bsr_proc::update_old_buffer()
 {
-  for (int i = 0; i < NOF_LCG; i++) {
-    for (std::map<uint32_t, lcid_t>::iterator iter = lcgs[i].begin(); iter != lcgs[i].end(); ++iter) {
-      iter->second.old_buffer = iter->second.new_buffer;
+  for (uint32_t lcid = 0; lcid < NOF_LCID; lcid++) {
+    if (lcid_cfg[lcid].lcg >= 0) {
+      old_buffer[lcid].store(new_buffer[lcid], std::memory_order_relaxed);
     }
   }
 }
@@ -215,15 +227,17 @@ void bsr_proc::update_old_buffer()
 uint32_t bsr_proc::get_buffer_state_lcg(uint32_t lcg)
 {
   uint32_t n = 0;
-  for (std::map<uint32_t, lcid_t>::iterator iter = lcgs[lcg].begin(); iter != lcgs[lcg].end(); ++iter) {
-    n += iter->second.old_buffer;
+  for (uint32_t lcid = 0; lcid < NOF_LCID; lcid++) {
+    if (lcid_cfg[lcid].lcg == (int)lcg) {
+      n += old_buffer[lcid].load(std::memory_order_relaxed);
+    }
   }
   return n;
 }
 
 // Checks if a BSR needs to be generated and, if so, configures the BSR format
 // It does not update the BSR values of the LCGs
-bool bsr_proc::generate_bsr(bsr_t* bsr, uint32_t pdu_space)
+bool bsr_proc::generate_bsr(bsr_t* bsr, uint32_t pdu_space, bsr_trigger_type_t trigger)
 {
   bool     send_bsr = false;
   uint32_t nof_lcg  = 0;
@@ -237,7 +251,7 @@ bool bsr_proc::generate_bsr(bsr_t* bsr, uint32_t pdu_space)
 
   if (pdu_space >= CE_SUBHEADER_LEN + ce_size(srsran::ul_sch_lcid::LONG_BSR)) {
     // we could fit a long BSR
-    if (triggered_bsr_type != PADDING && nof_lcg <= 1) {
+    if (trigger != PADDING && nof_lcg <= 1) {
       // for Regular and periodic BSR we still send a short BSR if only one LCG has data to send
       bsr->format = SHORT_BSR;
     } else {
@@ -249,7 +263,8 @@ bool bsr_proc::generate_bsr(bsr_t* bsr, uint32_t pdu_space)
     if (nof_lcg > 1) {
       // send truncated BSR
       bsr->format           = TRUNC_BSR;
-      uint32_t max_prio_lcg = find_max_priority_lcg_with_data();
+      lcid_cfg_snapshot.update();
+      uint32_t max_prio_lcg = find_max_priority_lcg_with_data(lcid_cfg_snapshot.read_buffer());
       for (uint32_t i = 0; i < NOF_LCG; i++) {
         if (max_prio_lcg != i) {
           bsr->buff_size[i] = 0;
@@ -268,7 +283,7 @@ bool bsr_proc::generate_bsr(bsr_t* bsr, uint32_t pdu_space)
       logger.debug("BSR:   Started periodicBSR-Timer");
     }
     // reset trigger to avoid another BSR in the next UL grant
-    triggered_bsr_type = NONE;
+    cancel_trigger(trigger);
   }
 
   return send_bsr;
@@ -281,19 +296,17 @@ bool bsr_proc::generate_bsr(bsr_t* bsr, uint32_t pdu_space)
  */
 void bsr_proc::update_bsr_tti_end(const bsr_t* bsr)
 {
-  std::lock_guard<std::mutex> lock(mutex);
-
   // Don't handle TBSR as it would reset old state for all non-reported LCGs, which might be wrong.
   if (bsr->format == TRUNC_BSR) {
     return;
   }
 
-  for (uint32_t i = 0; i < NOF_LCG; i++) {
-    if (bsr->buff_size[i] == 0) {
-      for (std::map<uint32_t, lcid_t>::iterator iter = lcgs[i].begin(); iter != lcgs[i].end(); ++iter) {
-        // Reset buffer state for all LCIDs of that the LCG for which we reported no further data to transmit
-        iter->second.old_buffer = 0;
-      }
+  lcid_cfg_snapshot.update();
+  const lcid_cfg_list_t& cfg = lcid_cfg_snapshot.read_buffer();
+  for (uint32_t lcid = 0; lcid < NOF_LCID; lcid++) {
+    // Reset buffer state for all LCIDs of that the LCG for which we reported no further data to transmit
+    if (cfg[lcid].lcg >= 0 && bsr->buff_size[cfg[lcid].lcg] == 0) {
+      old_buffer[lcid].store(0, std::memory_order_relaxed);
     }
   }
 }
@@ -303,8 +316,6 @@ void bsr_proc::update_bsr_tti_end(const bsr_t* bsr)
 // Periodic BSR is triggered by the expiration of the timers
 void bsr_proc::step(uint32_t tti)
 {
-  std::lock_guard<std::mutex> lock(mutex);
-
   if (!initiated) {
     return;
   }
@@ -336,15 +347,14 @@ char* bsr_proc::bsr_format_tostring(bsr_format_t format)
 
 bool bsr_proc::need_to_send_bsr_on_ul_grant(uint32_t grant_size, uint32_t total_data, bsr_t* bsr)
 {
-  std::lock_guard<std::mutex> lock(mutex);
-
-  bool send_bsr = false;
-  if (triggered_bsr_type == PERIODIC || triggered_bsr_type == REGULAR) {
+  bool               send_bsr = false;
+  bsr_trigger_type_t trigger  = triggered_bsr_type.load(std::memory_order_relaxed);
+  if (trigger == PERIODIC || trigger == REGULAR) {
     // All triggered BSRs shall be cancelled in case the UL grant can accommodate all pending data
     if (grant_size >= total_data) {
-      triggered_bsr_type = NONE;
+      cancel_trigger(trigger);
     } else {
-      send_bsr = generate_bsr(bsr, grant_size);
+      send_bsr = generate_bsr(bsr, grant_size, trigger);
     }
   }
 
@@ -363,46 +373,41 @@ bool bsr_proc::need_to_send_bsr_on_ul_grant(uint32_t grant_size, uint32_t total_
 // This function is called by MUX only if Regular BSR has not been triggered before
 bool bsr_proc::generate_padding_bsr(uint32_t nof_padding_bytes, bsr_t* bsr)
 {
-  std::lock_guard<std::mutex> lock(mutex);
-
   if (nof_padding_bytes >= CE_SUBHEADER_LEN + ce_size(srsran::ul_sch_lcid::SHORT_BSR)) {
-    // generate padding BSR
-    set_trigger(PADDING);
-    generate_bsr(bsr, nof_padding_bytes);
-    set_trigger(NONE);
+    // generate padding BSR, which also cancels any triggered BSR
+    bsr_trigger_type_t trigger = triggered_bsr_type.load(std::memory_order_relaxed);
+    generate_bsr(bsr, nof_padding_bytes, PADDING);
+    cancel_trigger(trigger);
     return true;
   }
 
   return false;
 }
 
+// Called by the stack thread, the new configuration is published to the UL PDU assembly
 void bsr_proc::setup_lcid(uint32_t lcid, uint32_t new_lcg, uint32_t priority)
 {
-  std::lock_guard<std::mutex> lock(mutex);
-
-  if (new_lcg < NOF_LCG) {
-    // First see if it already exists and eliminate it
-    for (int i = 0; i < NOF_LCG; i++) {
-      if (lcgs[i].count(lcid)) {
-        lcgs[i].erase(lcid);
-      }
-    }
-    // Now add it
-    lcgs[new_lcg][lcid].priority   = priority;
-    lcgs[new_lcg][lcid].old_buffer = 0;
+  if (new_lcg < NOF_LCG && lcid < NOF_LCID) {
+    lcid_cfg[lcid].lcg      = new_lcg;
+    lcid_cfg[lcid].priority = priority;
+    new_buffer[lcid]        = 0;
+    old_buffer[lcid].store(0, std::memory_order_relaxed);
+
+    lcid_cfg_snapshot.write_buffer() = lcid_cfg;
+    lcid_cfg_snapshot.publish();
   } else {
     logger.error("BSR:   Invalid lcg=%d for lcid=%d", new_lcg, lcid);
   }
 }
 
-uint32_t bsr_proc::find_max_priority_lcg_with_data()
+uint32_t bsr_proc::find_max_priority_lcg_with_data(const lcid_cfg_list_t& cfg)
 {
   int32_t  max_prio = 99;
   uint32_t max_idx  = 0;
   for (int i = 0; i < NOF_LCG; i++) {
-    for (std::map<uint32_t, lcid_t>::iterator iter = lcgs[i].begin(); iter != lcgs[i].end(); ++iter) {
-      if (iter->second.priority < max_prio && iter->second.old_buffer > 0) {
-        max_prio = iter->second.priority;
+    for (uint32_t lcid = 0; lcid < NOF_LCID; lcid++) {
+      if (cfg[lcid].lcg == i && cfg[lcid].priority < max_prio && old_buffer[lcid].load(std::memory_order_relaxed) > 0) {
+        max_prio = cfg[lcid].priority;
         max_idx  = i;
       }
     }
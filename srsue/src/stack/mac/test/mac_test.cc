@@ -63,6 +63,7 @@ public:
 
     // remove from UL queue
     ul_queues[lcid] -= len;
+    update_bsr(lcid);
 
     return len;
   };
@@ -72,9 +73,16 @@ public:
     received_bytes += nof_bytes;
   }
 
-  void     write_sdu(uint32_t lcid, uint32_t nof_bytes) { ul_queues[lcid] += nof_bytes; }
+  void write_sdu(uint32_t lcid, uint32_t nof_bytes)
+  {
+    ul_queues[lcid] += nof_bytes;
+    update_bsr(lcid);
+  }
   uint32_t get_received_bytes() { return received_bytes; }
 
+  // Reports every buffer change to the MAC, like the RLC does through its BSR callback
+  void set_mac(srsue::mac* mac_) { mac = mac_; }
+
   void disable_read() { read_enable = false; }
   void set_read_len(uint32_t len) { read_len = len; }
   void set_read_min(uint32_t len) { read_min = len; }
@@ -82,10 +90,19 @@ public:
   {
     for (auto& q : ul_queues) {
       q.second = 0;
+      update_bsr(q.first);
     }
   }
 
 private:
+  void update_bsr(uint32_t lcid)
+  {
+    if (mac != nullptr) {
+      mac->rlc_buffer_state(lcid, ul_queues[lcid], 0);
+    }
+  }
+
+  srsue::mac*           mac         = nullptr;
   bool                  read_enable = true;
   int32_t               read_len    = -1; // read all
   uint32_t              read_min    = 0;  // minimum "grant size" for read_pdu() to return data
@@ -383,6 +400,7 @@ int mac_unpack_test()
   mac mac("MAC", &stack.task_sched);
   stack.init(&mac, &phy);
   mac.init(&phy, &rlc, &rrc);
+  rlc.set_mac(&mac);
 
   // create dummy DL action and grant and push MAC PDU
   mac_interface_phy_lte::tb_action_dl_t dl_action;
@@ -430,6 +448,7 @@ int mac_ul_sch_pdu_test1()
   mac mac("MAC", &stack.task_sched);
   stack.init(&mac, &phy);
   mac.init(&phy, &rlc, &rrc);
+  rlc.set_mac(&mac);
   const uint16_t crnti = 0x1001;
   mac.set_ho_rnti(crnti, 0);
 
@@ -491,6 +510,7 @@ int mac_ul_logical_channel_prioritization_test1()
   mac mac("MAC", &stack.task_sched);
   stack.init(&mac, &phy);
   mac.init(&phy, &rlc, &rrc);
+  rlc.set_mac(&mac);
   const uint16_t crnti = 0x1001;
   mac.set_ho_rnti(crnti, 0);
 
@@ -594,6 +614,7 @@ int mac_ul_logical_channel_prioritization_test2()
   mac mac("MAC", &stack.task_sched);
   stack.init(&mac, &phy);
   mac.init(&phy, &rlc, &rrc);
+  rlc.set_mac(&mac);
   const uint16_t crnti = 0x1001;
   mac.set_ho_rnti(crnti, 0);
 
@@ -686,6 +707,7 @@ int mac_ul_logical_channel_prioritization_test3()
   mac mac("MAC", &stack.task_sched);
   stack.init(&mac, &phy);
   mac.init(&phy, &rlc, &rrc);
+  rlc.set_mac(&mac);
   const uint16_t crnti = 0x1001;
   mac.set_ho_rnti(crnti, 0);
 
@@ -767,6 +789,7 @@ int mac_ul_logical_channel_prioritization_test4()
   mac mac("MAC", &stack.task_sched);
   stack.init(&mac, &phy);
   mac.init(&phy, &rlc, &rrc);
+  rlc.set_mac(&mac);
   const uint16_t crnti = 0x1001;
   mac.set_ho_rnti(crnti, 0);
 
@@ -915,6 +938,7 @@ int mac_ul_sch_pdu_with_short_bsr_test()
   mac mac("MAC", &stack.task_sched);
   stack.init(&mac, &phy);
   mac.init(&phy, &rlc, &rrc);
+  rlc.set_mac(&mac);
   const uint16_t crnti = 0x1001;
   mac.set_ho_rnti(crnti, 0);
 
@@ -972,6 +996,7 @@ int mac_ul_sch_pdu_with_short_bsr_zero_test()
   mac mac("MAC", &stack.task_sched);
   stack.init(&mac, &phy);
   mac.init(&phy, &rlc, &rrc);
+  rlc.set_mac(&mac);
   const uint16_t crnti = 0x1001;
   mac.set_ho_rnti(crnti, 0);
 
@@ -1028,6 +1053,7 @@ int mac_ul_sch_pdu_with_padding_long_bsr_test()
   mac mac("MAC", &stack.task_sched);
   stack.init(&mac, &phy);
   mac.init(&phy, &rlc, &rrc);
+  rlc.set_mac(&mac);
   const uint16_t crnti = 0x1001;
   mac.set_ho_rnti(crnti, 0);
 
@@ -1077,6 +1103,7 @@ int mac_ul_sch_pdu_with_padding_long_bsr_test2()
   mac mac("MAC", &stack.task_sched);
   stack.init(&mac, &phy);
   mac.init(&phy, &rlc, &rrc);
+  rlc.set_mac(&mac);
   const uint16_t crnti = 0x1001;
   mac.set_ho_rnti(crnti, 0);
 
@@ -1150,6 +1177,7 @@ int mac_ul_sch_pdu_with_padding_trunc_bsr_test()
   mac mac("MAC", &stack.task_sched);
   stack.init(&mac, &phy);
   mac.init(&phy, &rlc, &rrc);
+  rlc.set_mac(&mac);
   const uint16_t crnti = 0x1001;
   mac.set_ho_rnti(crnti, 0);
 
@@ -1235,6 +1263,7 @@ int mac_ul_sch_regular_bsr_retx_test()
   mac mac("MAC", &stack.task_sched);
   stack.init(&mac, &phy);
   mac.init(&phy, &rlc, &rrc);
+  rlc.set_mac(&mac);
   const uint16_t crnti = 0x1001;
   mac.set_ho_rnti(crnti, 0);
 
@@ -1396,6 +1425,7 @@ int mac_ul_sch_periodic_bsr_test()
   mac mac("MAC", &stack.task_sched);
   stack.init(&mac, &phy);
   mac.init(&phy, &rlc, &rrc);
+  rlc.set_mac(&mac);
 
   mac_cfg_t mac_cfg              = {};
   mac_cfg.bsr_cfg.periodic_timer = 20;
@@ -1668,6 +1698,7 @@ int mac_ul_sch_trunc_bsr_test2()
   mac mac("MAC", &stack.task_sched);
   stack.init(&mac, &phy);
   mac.init(&phy, &rlc, &rrc);
+  rlc.set_mac(&mac);
 
   mac_cfg_t mac_cfg              = {};
   mac_cfg.bsr_cfg.periodic_timer = 20;
@@ -1818,6 +1849,7 @@ int mac_ul_sch_pdu_one_byte_test()
   mac mac("MAC", &stack.task_sched);
   stack.init(&mac, &phy);
   mac.init(&phy, &rlc, &rrc);
+  rlc.set_mac(&mac);
   const uint16_t crnti = 0x1001;
   mac.set_ho_rnti(crnti, 0);
 
@@ -1870,6 +1902,7 @@ int mac_ul_sch_pdu_two_byte_test()
   mac mac("MAC", &stack.task_sched);
   stack.init(&mac, &phy);
   mac.init(&phy, &rlc, &rrc);
+  rlc.set_mac(&mac);
   const uint16_t crnti = 0x1001;
   mac.set_ho_rnti(crnti, 0);
 
@@ -1922,6 +1955,7 @@ int mac_ul_sch_pdu_three_byte_test()
   mac mac("MAC", &stack.task_sched);
   stack.init(&mac, &phy);
   mac.init(&phy, &rlc, &rrc);
+  rlc.set_mac(&mac);
   const uint16_t crnti = 0x1001;
   mac.set_ho_rnti(crnti, 0);
 
@@ -2156,6 +2190,7 @@ int mac_random_access_test()
   mac mac("MAC", &stack.task_sched);
   stack.init(&mac, &phy);
   mac.init(&phy, &rlc, &rrc);
+  rlc.set_mac(&mac);
   srsran::mac_cfg_t mac_cfg;
   set_mac_cfg_t_rach_cfg_common(&mac_cfg, rach_cfg);
   mac.set_config(mac_cfg);
@@ -207,7 +207,7 @@ void dl_harq_entity_nr::dl_harq_process_nr::new_grant_dl(const mac_nr_grant_dl_t
   {
     // New transmission
     n_retx = 0;
-    srsran_softbuffer_rx_reset_tbs(softbuffer_rx.get(), grant.tbs * 8);
+    srsran_softbuffer_rx_reset_tbs_nr(softbuffer_rx.get(), grant.tbs * 8);
 
     action->tb.enabled    = true;
     action->tb.softbuffer = softbuffer_rx.get();
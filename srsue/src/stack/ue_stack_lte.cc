@@ -222,7 +222,13 @@ int ue_stack_lte::init(const stack_args_t& args_)
   sync_task_queue = task_sched.make_task_queue(args.sync_queue_size);
 
   mac.init(phy, &rlc, &rrc);
-  rlc.init(&pdcp, &rrc, task_sched.get_timer_handler(), 0 /* RB_ID_SRB0 */);
+  rlc.init(&pdcp,
+           &rrc,
+           task_sched.get_timer_handler(),
+           0 /* RB_ID_SRB0 */,
+           [this](uint32_t lcid, uint32_t tx_queue, uint32_t prio_tx_queue) {
+             mac.rlc_buffer_state(lcid, tx_queue, prio_tx_queue);
+           });
   nas.init(usim.get(), &rrc, gw, args.nas);
 
   if (!args.sa_mode) {
@@ -32,8 +32,10 @@
 #include <linux/netlink.h>
 #include <linux/rtnetlink.h>
 #include <netinet/in.h>
+#include <poll.h>
 #include <sys/ioctl.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 namespace srsue {
@@ -73,8 +75,11 @@ int gw::init(const gw_args_t& args_, stack_interface_gw* stack_)
 
 gw::~gw()
 {
-  if (tun_fd > 0) {
-    close(tun_fd);
+  if (dl_writer) {
+    dl_writer->stop();
+  }
+  for (int32_t fd : tun_queue_fds) {
+    close(fd);
   }
 }
 
@@ -95,6 +100,10 @@ void gw::stop()
         cnt++;
       }
       wait_thread_finish();
+      stop_tun_readers();
+      if (dl_writer) {
+        dl_writer->stop();
+      }
 
       current_ip_addr = 0;
     }
@@ -150,10 +159,15 @@ void gw::write_pdu(uint32_t lcid, srsran::unique_byte_buffer_t pdu)
   } else {
     // Only handle IPv4 and IPv6 packets
     struct iphdr* ip_pkt = (struct iphdr*)pdu->msg;
-    if (ip_pkt->version == 4 || ip_pkt->version == 6) {
-      int n = write(tun_fd, pdu->msg, pdu->N_bytes);
-      if (n > 0 && (pdu->N_bytes != (uint32_t)n)) {
-        logger.warning("DL TUN/TAP write failure. Wanted to write %d B but only wrote %d B.", pdu->N_bytes, n);
+    if ((ip_pkt->version == 4 || ip_pkt->version == 6) && dl_writer) {
+      dl_writer->push(std::move(pdu));
+    } else if (ip_pkt->version == 4 || ip_pkt->version == 6) {
+      struct iovec iov = {pdu->msg, pdu->N_bytes};
+      ssize_t      n   = write_tun(&iov, 1);
+      if (n < 0) {
+        logger.warning("DL TUN/TAP write failure. Dropping packet with %d B: %s", pdu->N_bytes, strerror(errno));
+      } else if (pdu->N_bytes != (uint32_t)n) {
+        logger.warning("DL TUN/TAP write failure. Wanted to write %d B but only wrote %zd B.", pdu->N_bytes, n);
       }
     } else {
       logger.error("Unsupported IP version. Dropping packet with %d B", pdu->N_bytes);
@@ -184,9 +198,12 @@ void gw::write_pdu_mch(uint32_t lcid, srsran::unique_byte_buffer_t pdu)
       if (run_enable) {
         logger.warning("TUN/TAP not up - dropping gw RX message");
       }
+    } else if (dl_writer) {
+      dl_writer->push(std::move(pdu));
     } else {
-      int n = write(tun_fd, pdu->msg, pdu->N_bytes);
-      if (n > 0 && (pdu->N_bytes != (uint32_t)n)) {
+      struct iovec iov = {pdu->msg, pdu->N_bytes};
+      ssize_t      n   = write_tun(&iov, 1);
+      if (n < 0 || (pdu->N_bytes != (uint32_t)n)) {
         logger.warning("DL TUN/TAP write failure");
       }
     }
@@ -206,6 +223,7 @@ int gw::setup_if_addr(uint32_t eps_bearer_id, uint8_t pdn_type, uint32_t ip_addr
     thread_cancel();
     wait_thread_finish();
   }
+  stop_tun_readers();
   if (pdn_type == LIBLTE_MME_PDN_TYPE_IPV4 || pdn_type == LIBLTE_MME_PDN_TYPE_IPV4V6) {
     err = setup_if_addr4(ip_addr, err_str);
     if (err != SRSRAN_SUCCESS) {
@@ -224,6 +242,10 @@ int gw::setup_if_addr(uint32_t eps_bearer_id, uint8_t pdn_type, uint32_t ip_addr
   // Setup a thread to receive packets from the TUN device
   run_enable = true;
   start(GW_THREAD_PRIO);
+  for (uint32_t i = 1; i < tun_queue_fds.size(); i++) {
+    tun_readers.emplace_back(new tun_queue_reader(this, i));
+    tun_readers.back()->start(GW_THREAD_PRIO);
+  }
 
   return SRSRAN_SUCCESS;
 }
@@ -274,123 +296,291 @@ void gw::add_mch_port(uint32_t lcid, uint32_t port)
 /********************/
 void gw::run_thread()
 {
-  uint32 idx     = 0;
-  int32  N_bytes = 0;
+  logger.info("GW IP packet receiver thread run_enable");
+
+  running = true;
+  read_tun_queue(tun_fd);
+  running = false;
+  logger.info("GW IP receiver thread exiting.");
+}
+
+gw::tun_queue_reader::tun_queue_reader(gw* parent_, uint32_t queue_) :
+  thread("GW_Q" + std::to_string(queue_)), parent(parent_), queue(queue_)
+{}
+
+void gw::tun_queue_reader::run_thread()
+{
+  parent->read_tun_queue(parent->tun_queue_fds[queue]);
+  parent->logger.info("GW IP receiver thread of TUN queue %d exiting.", queue);
+}
 
-  srsran::unique_byte_buffer_t pdu = srsran::make_byte_buffer();
-  if (!pdu) {
-    logger.error("Couldn't allocate PDU in %s().", __FUNCTION__);
+void gw::stop_tun_readers()
+{
+  if (tun_readers.empty()) {
     return;
   }
+  // The readers see run_enable within a poll timeout
+  run_enable = false;
+  for (auto& reader : tun_readers) {
+    reader->wait_thread_finish();
+  }
+  tun_readers.clear();
+}
 
-  const static uint32_t REGISTER_WAIT_TOUT = 40, SERVICE_WAIT_TOUT = 40; // 4 sec
-  uint32_t              register_wait = 0, service_wait = 0;
-
-  logger.info("GW IP packet receiver thread run_enable");
+void gw::read_tun_queue(int32_t fd)
+{
+  std::vector<srsran::unique_byte_buffer_t> pdus;
+  pdus.reserve(TUN_READ_BATCH);
+  std::vector<uint8_t>         offload_buffer(args.tun_offload ? TUN_VNET_HDR_LEN + TUN_GSO_MAX_PKT_LEN : 0);
+  srsran::unique_byte_buffer_t pdu;
 
-  running = true;
   while (run_enable) {
-    // Read packet from TUN
-    if (SRSRAN_MAX_BUFFER_SIZE_BYTES - SRSRAN_BUFFER_HEADER_OFFSET > idx) {
-      N_bytes = read(tun_fd, &pdu->msg[idx], SRSRAN_MAX_BUFFER_SIZE_BYTES - SRSRAN_BUFFER_HEADER_OFFSET - idx);
-    } else {
-      logger.error("GW pdu buffer full - gw receive thread exiting.");
-      srsran::console("GW pdu buffer full - gw receive thread exiting.\n");
+    // Wait for packets, then take the ones already queued without blocking
+    struct pollfd pfd = {fd, POLLIN, 0};
+    int           ret = poll(&pfd, 1, TUN_POLL_TIMEOUT_MS);
+    if (ret < 0 && errno != EINTR) {
+      logger.error("Failed to poll TUN interface - gw receive thread exiting.");
+      srsran::console("Failed to poll TUN interface - gw receive thread exiting.\n");
       break;
     }
-    logger.debug("Read %d bytes from TUN fd=%d, idx=%d", N_bytes, tun_fd, idx);
+    if (ret <= 0) {
+      continue;
+    }
+
+    bool read_error = false;
+    while (pdus.size() < TUN_READ_BATCH) {
+      ssize_t N_bytes = 0;
+      if (args.tun_offload) {
+        N_bytes = read(fd, offload_buffer.data(), offload_buffer.size());
+      } else {
+        while (!pdu) {
+          pdu = srsran::make_byte_buffer();
+          if (!pdu) {
+            logger.error("Fatal Error: Couldn't allocate PDU in %s().", __FUNCTION__);
+            usleep(100000);
+          }
+        }
+        N_bytes = read(fd, pdu->msg, SRSRAN_MAX_BUFFER_SIZE_BYTES - SRSRAN_BUFFER_HEADER_OFFSET);
+      }
+      if (N_bytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+        break;
+      }
+      if (N_bytes <= 0) {
+        read_error = true;
+        break;
+      }
+      logger.debug("Read %d bytes from TUN fd=%d", (int)N_bytes, fd);
+
+      if (!args.tun_offload) {
+        pdu->N_bytes = N_bytes;
+        if (is_valid_ip_pkt(*pdu)) {
+          pdus.push_back(std::move(pdu));
+        }
+        continue;
+      }
+
+      // Split TCP super-packets into SDUs
+      tun_vnet_hdr_t vnet_hdr = {};
+      if ((uint32_t)N_bytes < TUN_VNET_HDR_LEN) {
+        logger.warning("Packet too small to hold virtio-net header. Dropping packet with %d B", (int)N_bytes);
+        continue;
+      }
+      memcpy(&vnet_hdr, offload_buffer.data(), TUN_VNET_HDR_LEN);
+      auto segment_fn = [this, &pdus](const uint8_t* hdr, uint32_t hdr_len, const uint8_t* payload, uint32_t len) {
+        srsran::unique_byte_buffer_t seg = srsran::make_byte_buffer();
+        if (!seg) {
+          logger.error("Couldn't allocate PDU in %s().", __FUNCTION__);
+          return;
+        }
+        if (hdr_len + len > seg->get_tailroom()) {
+          logger.warning("Segment of %d B does not fit in a PDU. Dropping it", hdr_len + len);
+          return;
+        }
+        memcpy(seg->msg, hdr, hdr_len);
+        if (len > 0) {
+          memcpy(&seg->msg[hdr_len], payload, len);
+        }
+        seg->N_bytes = hdr_len + len;
+        if (is_valid_ip_pkt(*seg)) {
+          pdus.push_back(std::move(seg));
+        }
+      };
+      if (tun_gso_split(vnet_hdr, &offload_buffer[TUN_VNET_HDR_LEN], N_bytes - TUN_VNET_HDR_LEN, segment_fn) < 0) {
+        logger.warning("Unsupported TUN offload packet (gso_type=%d). Dropping packet with %d B",
+                       vnet_hdr.gso_type,
+                       (int)N_bytes);
+      }
+    }
 
-    if (N_bytes <= 0) {
+    if (!send_ul_batch(pdus)) {
+      break;
+    }
+    if (read_error) {
       logger.error("Failed to read from TUN interface - gw receive thread exiting.");
       srsran::console("Failed to read from TUN interface - gw receive thread exiting.\n");
       break;
     }
+  }
+}
 
-    {
-      std::unique_lock<std::mutex> lock(gw_mutex);
-      // Check if IP version makes sense and get packtet length
-      struct iphdr*   ip_pkt  = (struct iphdr*)pdu->msg;
-      struct ipv6hdr* ip6_pkt = (struct ipv6hdr*)pdu->msg;
-      uint16_t        pkt_len = 0;
-      pdu->N_bytes            = idx + N_bytes;
-      if (ip_pkt->version == 4) {
-        pkt_len = ntohs(ip_pkt->tot_len);
-      } else if (ip_pkt->version == 6) {
-        pkt_len = ntohs(ip6_pkt->payload_len) + 40;
-      } else {
-        logger.error(pdu->msg, pdu->N_bytes, "Unsupported IP version. Dropping packet.");
-        continue;
-      }
-      logger.debug("IPv%d packet total length: %d Bytes", int(ip_pkt->version), pkt_len);
+bool gw::is_valid_ip_pkt(const srsran::byte_buffer_t& pdu)
+{
+  // Check if IP version makes sense and get packet length
+  struct iphdr*   ip_pkt  = (struct iphdr*)pdu.msg;
+  struct ipv6hdr* ip6_pkt = (struct ipv6hdr*)pdu.msg;
+  uint16_t        pkt_len = 0;
+  if (pdu.N_bytes < 20) {
+    logger.warning("Packet to small to hold IPv4 header. Dropping packet with %d B", pdu.N_bytes);
+    return false;
+  }
+  if (ip_pkt->version == 4) {
+    pkt_len = ntohs(ip_pkt->tot_len);
+  } else if (ip_pkt->version == 6) {
+    pkt_len = ntohs(ip6_pkt->payload_len) + 40;
+  } else {
+    logger.error(pdu.msg, pdu.N_bytes, "Unsupported IP version. Dropping packet.");
+    return false;
+  }
+  logger.debug("IPv%d packet total length: %d Bytes", int(ip_pkt->version), pkt_len);
 
-      // Check if entire packet was received
-      if (pkt_len == pdu->N_bytes) {
-        logger.info(pdu->msg, pdu->N_bytes, "TX PDU");
+  // A read from a TUN device returns one entire packet
+  if (pkt_len != pdu.N_bytes) {
+    logger.warning("IP packet length %d does not match the %d B read. Dropping packet.", pkt_len, pdu.N_bytes);
+    return false;
+  }
+  return true;
+}
 
-        // Make sure UE is attached and has default EPS bearer activated
-        while (run_enable && default_eps_bearer_id == NOT_ASSIGNED && register_wait < REGISTER_WAIT_TOUT) {
-          if (!register_wait) {
-            logger.info("UE is not attached, waiting for NAS attach (%d/%d)", register_wait, REGISTER_WAIT_TOUT);
-          }
-          lock.unlock();
-          std::this_thread::sleep_for(std::chrono::microseconds(100));
-          lock.lock();
-          register_wait++;
-        }
-        register_wait = 0;
+bool gw::send_ul_batch(std::vector<srsran::unique_byte_buffer_t>& pdus)
+{
+  const static uint32_t REGISTER_WAIT_TOUT = 40, SERVICE_WAIT_TOUT = 40; // 4 sec
+  uint32_t              register_wait = 0, service_wait = 0;
 
-        // If we are still not attached by this stage, drop packet
-        if (run_enable && default_eps_bearer_id == NOT_ASSIGNED) {
-          continue;
-        }
+  std::unique_lock<std::mutex> lock(gw_mutex);
+  for (srsran::unique_byte_buffer_t& pdu : pdus) {
+    logger.info(pdu->msg, pdu->N_bytes, "TX PDU");
 
-        if (!run_enable) {
-          break;
-        }
+    // Make sure UE is attached and has default EPS bearer activated
+    while (run_enable && default_eps_bearer_id == NOT_ASSIGNED && register_wait < REGISTER_WAIT_TOUT) {
+      if (!register_wait) {
+        logger.info("UE is not attached, waiting for NAS attach (%d/%d)", register_wait, REGISTER_WAIT_TOUT);
+      }
+      lock.unlock();
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+      lock.lock();
+      register_wait++;
+    }
+    register_wait = 0;
 
-        // Beyond this point we should have a activated default EPS bearer
-        srsran_assert(default_eps_bearer_id != NOT_ASSIGNED, "Default EPS bearer not activated");
+    // If we are still not attached by this stage, drop packet
+    if (run_enable && default_eps_bearer_id == NOT_ASSIGNED) {
+      continue;
+    }
 
-        uint8_t eps_bearer_id = default_eps_bearer_id;
-        tft_matcher.check_tft_filter_match(pdu, eps_bearer_id);
+    if (!run_enable) {
+      pdus.clear();
+      return false;
+    }
 
-        // Wait for service request if necessary
-        while (run_enable && !stack->has_active_radio_bearer(eps_bearer_id) && service_wait < SERVICE_WAIT_TOUT) {
-          if (!service_wait) {
-            logger.info(
-                "UE does not have service, waiting for NAS service request (%d/%d)", service_wait, SERVICE_WAIT_TOUT);
-            stack->start_service_request();
-          }
-          usleep(100000);
-          service_wait++;
-        }
-        service_wait = 0;
+    // Beyond this point we should have a activated default EPS bearer
+    srsran_assert(default_eps_bearer_id != NOT_ASSIGNED, "Default EPS bearer not activated");
 
-        // Quit before writing packet if necessary
-        if (!run_enable) {
-          break;
-        }
+    uint8_t eps_bearer_id = default_eps_bearer_id;
+    tft_matcher.check_tft_filter_match(pdu, eps_bearer_id);
 
-        // Send PDU directly to PDCP
-        pdu->set_timestamp();
-        ul_tput_bytes += pdu->N_bytes;
-        stack->write_sdu(eps_bearer_id, std::move(pdu));
-        do {
-          pdu = srsran::make_byte_buffer();
-          if (!pdu) {
-            logger.error("Fatal Error: Couldn't allocate PDU in run_thread().");
-            usleep(100000);
-          }
-        } while (!pdu);
-        idx = 0;
-      } else {
-        idx += N_bytes;
-        logger.debug("Entire packet not read from socket. Total Length %d, N_Bytes %d.", ip_pkt->tot_len, pdu->N_bytes);
+    // Wait for service request if necessary
+    while (run_enable && !stack->has_active_radio_bearer(eps_bearer_id) && service_wait < SERVICE_WAIT_TOUT) {
+      if (!service_wait) {
+        logger.info(
+            "UE does not have service, waiting for NAS service request (%d/%d)", service_wait, SERVICE_WAIT_TOUT);
+        stack->start_service_request();
       }
-    } // end of holdering gw_mutex
+      usleep(100000);
+      service_wait++;
+    }
+    service_wait = 0;
+
+    // Quit before writing packet if necessary
+    if (!run_enable) {
+      pdus.clear();
+      return false;
+    }
+
+    // Send PDU directly to PDCP
+    pdu->set_timestamp();
+    ul_tput_bytes += pdu->N_bytes;
+    stack->write_sdu(eps_bearer_id, std::move(pdu));
   }
-  running = false;
-  logger.info("GW IP receiver thread exiting.");
+  pdus.clear();
+  return true;
+}
+
+/********************/
+/*    GW Transmit   */
+/********************/
+gw::tun_dl_writer::tun_dl_writer(gw* parent_) : thread("GW_DL"), parent(parent_), queue(DL_QUEUE_SIZE) {}
+
+void gw::tun_dl_writer::push(srsran::unique_byte_buffer_t pdu)
+{
+  if (not queue.try_push(std::move(pdu))) {
+    parent->logger.warning("DL TUN/TAP queue full - dropping gw RX message");
+  }
+}
+
+void gw::tun_dl_writer::stop()
+{
+  if (stopped.exchange(true)) {
+    return;
+  }
+  queue.stop();
+  wait_thread_finish();
+}
+
+void gw::tun_dl_writer::run_thread()
+{
+  tun_gro_batch batch;
+  bool          success = false;
+
+  srsran::unique_byte_buffer_t pdu = queue.pop_blocking(&success);
+  while (success) {
+    // Coalesce the packets already queued and write them once the queue is empty
+    if (not batch.add(pdu)) {
+      parent->write_dl_batch(batch);
+      batch.add(pdu);
+    }
+    if (not queue.try_pop(pdu)) {
+      parent->write_dl_batch(batch);
+      pdu = queue.pop_blocking(&success);
+    }
+  }
+}
+
+void gw::write_dl_batch(tun_gro_batch& batch)
+{
+  if (batch.empty()) {
+    return;
+  }
+  const std::vector<struct iovec>& iov = batch.prepare();
+  if (write_tun(iov.data(), iov.size()) < 0) {
+    logger.warning("DL TUN/TAP write failure: %s", strerror(errno));
+  } else if (batch.size() > 1) {
+    logger.debug("Wrote %d DL segments as one TUN packet", batch.size());
+  }
+  batch.clear();
+}
+
+ssize_t gw::write_tun(const struct iovec* iov, int iovcnt)
+{
+  ssize_t n = writev(tun_fd, iov, iovcnt);
+  // The TUN queues are opened non-blocking for the readers, so wait for room in the device queue instead of dropping
+  while (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK) && run_enable) {
+    struct pollfd pfd = {tun_fd, POLLOUT, 0};
+    if (poll(&pfd, 1, TUN_POLL_TIMEOUT_MS) < 0 && errno != EINTR) {
+      return -1;
+    }
+    n = writev(tun_fd, iov, iovcnt);
+  }
+  return n;
 }
 
 /**************************/
@@ -419,24 +609,45 @@ int gw::init_if(char* err_str)
     }
   }
 
-  // Construct the TUN device
-  tun_fd = open("/dev/net/tun", O_RDWR);
-  logger.info("TUN file descriptor = %d", tun_fd);
-  if (0 > tun_fd) {
-    err_str = strerror(errno);
-    logger.error("Failed to open TUN device: %s", err_str);
-    return SRSRAN_ERROR_CANT_START;
+  // Construct the TUN device, with one file descriptor per queue
+  uint32_t nof_queues = std::max(args.tun_nof_queues, 1U);
+  for (uint32_t i = 0; i < nof_queues; i++) {
+    int32_t fd = open("/dev/net/tun", O_RDWR | O_NONBLOCK);
+    logger.info("TUN file descriptor = %d", fd);
+    if (0 > fd) {
+      err_str = strerror(errno);
+      logger.error("Failed to open TUN device: %s", err_str);
+      close_tun_queues();
+      return SRSRAN_ERROR_CANT_START;
+    }
+    tun_queue_fds.push_back(fd);
+
+    memset(&ifr, 0, sizeof(ifr));
+    ifr.ifr_flags = IFF_TUN | IFF_NO_PI;
+    if (nof_queues > 1) {
+      ifr.ifr_flags |= IFF_MULTI_QUEUE;
+    }
+    if (args.tun_offload) {
+      ifr.ifr_flags |= IFF_VNET_HDR;
+    }
+    strncpy(ifr.ifr_ifrn.ifrn_name,
+            args.tun_dev_name.c_str(),
+            std::min(args.tun_dev_name.length(), (size_t)(IFNAMSIZ - 1)));
+    ifr.ifr_ifrn.ifrn_name[IFNAMSIZ - 1] = 0;
+    if (0 > ioctl(fd, TUNSETIFF, &ifr)) {
+      err_str = strerror(errno);
+      logger.error("Failed to set TUN device name: %s", err_str);
+      close_tun_queues();
+      return SRSRAN_ERROR_CANT_START;
+    }
   }
+  tun_fd = tun_queue_fds[0];
 
-  memset(&ifr, 0, sizeof(ifr));
-  ifr.ifr_flags = IFF_TUN | IFF_NO_PI;
-  strncpy(
-      ifr.ifr_ifrn.ifrn_name, args.tun_dev_name.c_str(), std::min(args.tun_dev_name.length(), (size_t)(IFNAMSIZ - 1)));
-  ifr.ifr_ifrn.ifrn_name[IFNAMSIZ - 1] = 0;
-  if (0 > ioctl(tun_fd, TUNSETIFF, &ifr)) {
+  // Let the host hand over TCP super-packets and packets without checksum, split and completed by the GW
+  if (args.tun_offload && 0 > ioctl(tun_fd, TUNSETOFFLOAD, TUN_F_CSUM | TUN_F_TSO4 | TUN_F_TSO6)) {
     err_str = strerror(errno);
-    logger.error("Failed to set TUN device name: %s", err_str);
-    close(tun_fd);
+    logger.error("Failed to set TUN offloads: %s", err_str);
+    close_tun_queues();
     return SRSRAN_ERROR_CANT_START;
   }
 
@@ -445,14 +656,14 @@ int gw::init_if(char* err_str)
   if (0 > ioctl(sock, SIOCGIFFLAGS, &ifr)) {
     err_str = strerror(errno);
     logger.error("Failed to bring up socket: %s", err_str);
-    close(tun_fd);
+    close_tun_queues();
     return SRSRAN_ERROR_CANT_START;
   }
   ifr.ifr_flags |= IFF_UP | IFF_RUNNING;
   if (0 > ioctl(sock, SIOCSIFFLAGS, &ifr)) {
     err_str = strerror(errno);
     logger.error("Failed to set socket flags: %s", err_str);
-    close(tun_fd);
+    close_tun_queues();
     return SRSRAN_ERROR_CANT_START;
   }
 
@@ -465,11 +676,26 @@ int gw::init_if(char* err_str)
   } else {
     logger.warning("Could not find link-local IPv6 address.");
   }
+
+  // With IFF_VNET_HDR, DL packets are written by a thread of their own that merges them into super-packets
+  if (args.tun_offload) {
+    dl_writer.reset(new tun_dl_writer(this));
+    dl_writer->start(GW_THREAD_PRIO);
+  }
   if_up = true;
 
   return SRSRAN_SUCCESS;
 }
 
+void gw::close_tun_queues()
+{
+  for (int32_t fd : tun_queue_fds) {
+    close(fd);
+  }
+  tun_queue_fds.clear();
+  tun_fd = 0;
+}
+
 int gw::setup_if_addr4(uint32_t ip_addr, char* err_str)
 {
   if (ip_addr != current_ip_addr) {
@@ -490,7 +716,7 @@ int gw::setup_if_addr4(uint32_t ip_addr, char* err_str)
     if (0 > ioctl(sock, SIOCSIFADDR, &ifr)) {
       err_str = strerror(errno);
       logger.debug("Failed to set socket address: %s", err_str);
-      close(tun_fd);
+      close_tun_queues();
       return SRSRAN_ERROR_CANT_START;
     }
     ifr.ifr_netmask.sa_family = AF_INET;
@@ -505,7 +731,7 @@ int gw::setup_if_addr4(uint32_t ip_addr, char* err_str)
     if (0 > ioctl(sock, SIOCSIFNETMASK, &ifr)) {
       err_str = strerror(errno);
       logger.debug("Failed to set socket netmask: %s", err_str);
-      close(tun_fd);
+      close_tun_queues();
       return SRSRAN_ERROR_CANT_START;
     }
     current_ip_addr = ip_addr;
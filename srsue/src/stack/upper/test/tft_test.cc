@@ -24,7 +24,9 @@
 #include "srsran/common/int_helpers.h"
 #include "srsran/srsran.h"
 #include "srsue/hdr/stack/upper/tft_packet_filter.h"
+#include <atomic>
 #include <iostream>
+#include <thread>
 
 #define TESTASSERT(cond)                                                                                               \
   {                                                                                                                    \
@@ -409,6 +411,173 @@ int tft_filter_test_ipv4_tos()
   return 0;
 }
 
+int tft_filter_test_port_range()
+{
+  srslog::basic_logger& logger = srslog::fetch_basic_logger("TFT");
+
+  srsran::unique_byte_buffer_t ip_msg1, ip_msg2;
+  ip_msg1 = make_byte_buffer();
+  TESTASSERT(ip_msg1 != nullptr);
+  ip_msg2 = make_byte_buffer();
+  TESTASSERT(ip_msg2 != nullptr);
+
+  // Filter length: 10 bytes
+  // Filter type:   Local port range, remote port range
+  // Local ports:   2000-3000
+  // Remote ports:  2001-2001
+  uint8_t filter_message[10];
+  filter_message[0] = LOCAL_PORT_RANGE_TYPE;
+  srsran::uint16_to_uint8(2000, &filter_message[1]);
+  srsran::uint16_to_uint8(3000, &filter_message[3]);
+  filter_message[5] = REMOTE_PORT_RANGE_TYPE;
+  srsran::uint16_to_uint8(2001, &filter_message[6]);
+  srsran::uint16_to_uint8(2001, &filter_message[8]);
+
+  // Set IP test messages
+  ip_msg1->N_bytes = ip_message_len1;
+  memcpy(ip_msg1->msg, ip_tst_message1, ip_message_len1);
+  ip_msg2->N_bytes = ip_message_len2;
+  memcpy(ip_msg2->msg, ip_tst_message2, ip_message_len2);
+
+  // Packet filter
+  LIBLTE_MME_PACKET_FILTER_STRUCT packet_filter;
+
+  packet_filter.dir             = LIBLTE_MME_TFT_PACKET_FILTER_DIRECTION_BIDIRECTIONAL;
+  packet_filter.id              = 1;
+  packet_filter.eval_precedence = 0;
+  packet_filter.filter_size     = 10;
+  memcpy(packet_filter.filter, filter_message, 10);
+
+  srsue::tft_packet_filter_t filter(EPS_BEARER_ID, packet_filter, logger);
+
+  // Check filter
+  TESTASSERT(filter.match(ip_msg1));
+  TESTASSERT(!filter.match(ip_msg2));
+
+  // Same local range, remote ports 3000-8999 given in the wrong order
+  srsran::uint16_to_uint8(8999, &packet_filter.filter[6]);
+  srsran::uint16_to_uint8(3000, &packet_filter.filter[8]);
+  srsue::tft_packet_filter_t filter2(EPS_BEARER_ID, packet_filter, logger);
+  TESTASSERT(!filter2.match(ip_msg1));
+
+  printf("Test TFT filter port range successfull\n");
+  return 0;
+}
+
+/// Adds a TFT made of a single packet filter to the matcher
+static int add_tft(tft_pdu_matcher& matcher,
+                   uint8_t          eps_bearer_id,
+                   uint8_t          id,
+                   uint8_t          precedence,
+                   uint8_t*         filter,
+                   uint8_t          filter_size)
+{
+  LIBLTE_MME_TRAFFIC_FLOW_TEMPLATE_STRUCT tft = {};
+
+  tft.tft_op_code                           = LIBLTE_MME_TFT_OPERATION_CODE_CREATE_NEW_TFT;
+  tft.packet_filter_list_size               = 1;
+  tft.packet_filter_list[0].dir             = LIBLTE_MME_TFT_PACKET_FILTER_DIRECTION_BIDIRECTIONAL;
+  tft.packet_filter_list[0].id              = id;
+  tft.packet_filter_list[0].eval_precedence = precedence;
+  tft.packet_filter_list[0].filter_size     = filter_size;
+  memcpy(tft.packet_filter_list[0].filter, filter, filter_size);
+  return matcher.apply_traffic_flow_template(eps_bearer_id, &tft);
+}
+
+int tft_pdu_matcher_test_precedence()
+{
+  srslog::basic_logger& logger = srslog::fetch_basic_logger("TFT");
+  tft_pdu_matcher       matcher(logger);
+  uint8_t               eps_bearer_id = 0;
+
+  srsran::unique_byte_buffer_t ip_msg1, ip_msg2;
+  ip_msg1 = make_byte_buffer();
+  TESTASSERT(ip_msg1 != nullptr);
+  ip_msg2 = make_byte_buffer();
+  TESTASSERT(ip_msg2 != nullptr);
+  ip_msg1->N_bytes = ip_message_len1;
+  memcpy(ip_msg1->msg, ip_tst_message1, ip_message_len1);
+  ip_msg2->N_bytes = ip_message_len2;
+  memcpy(ip_msg2->msg, ip_tst_message2, ip_message_len2);
+
+  // No TFT configured
+  TESTASSERT(matcher.check_tft_filter_match(ip_msg1, eps_bearer_id) == SRSRAN_ERROR);
+
+  // Filters indexed by remote port, protocol and remote address, in precedence order
+  uint8_t remote_port_9000[3] = {SINGLE_REMOTE_PORT_TYPE};
+  srsran::uint16_to_uint8(9000, &remote_port_9000[1]);
+  uint8_t protocol_udp[2]     = {PROTOCOL_ID_TYPE, UDP_PROTOCOL};
+  uint8_t remote_port_2001[3] = {SINGLE_REMOTE_PORT_TYPE};
+  srsran::uint16_to_uint8(2001, &remote_port_2001[1]);
+  uint8_t remote_addr[9] = {IPV4_REMOTE_ADDR_TYPE, 0x7f, 0x00, 0x00, 0x02, 0xff, 0xff, 0xff, 0xff};
+
+  TESTASSERT(add_tft(matcher, 5, 1, 0, remote_port_9000, sizeof(remote_port_9000)) == SRSRAN_SUCCESS);
+  TESTASSERT(add_tft(matcher, 6, 2, 1, protocol_udp, sizeof(protocol_udp)) == SRSRAN_SUCCESS);
+  TESTASSERT(add_tft(matcher, 7, 3, 2, remote_port_2001, sizeof(remote_port_2001)) == SRSRAN_SUCCESS);
+  TESTASSERT(add_tft(matcher, 8, 4, 3, remote_addr, sizeof(remote_addr)) == SRSRAN_SUCCESS);
+
+  // The filter with the highest precedence wins, whatever the table it is indexed by
+  TESTASSERT(matcher.check_tft_filter_match(ip_msg1, eps_bearer_id) == SRSRAN_SUCCESS);
+  TESTASSERT(eps_bearer_id == 6);
+  TESTASSERT(matcher.check_tft_filter_match(ip_msg2, eps_bearer_id) == SRSRAN_SUCCESS);
+  TESTASSERT(eps_bearer_id == 5);
+
+  matcher.delete_tft_for_eps_bearer(6);
+  TESTASSERT(matcher.check_tft_filter_match(ip_msg1, eps_bearer_id) == SRSRAN_SUCCESS);
+  TESTASSERT(eps_bearer_id == 7);
+  matcher.delete_tft_for_eps_bearer(7);
+  TESTASSERT(matcher.check_tft_filter_match(ip_msg1, eps_bearer_id) == SRSRAN_SUCCESS);
+  TESTASSERT(eps_bearer_id == 8);
+  matcher.delete_tft_for_eps_bearer(8);
+  TESTASSERT(matcher.check_tft_filter_match(ip_msg1, eps_bearer_id) == SRSRAN_ERROR);
+
+  matcher.reset();
+  TESTASSERT(matcher.check_tft_filter_match(ip_msg2, eps_bearer_id) == SRSRAN_ERROR);
+
+  printf("Test TFT matcher precedence successfull\n");
+  return 0;
+}
+
+int tft_pdu_matcher_test_concurrent_update()
+{
+  srslog::basic_logger& logger = srslog::fetch_basic_logger("TFT");
+  tft_pdu_matcher       matcher(logger);
+
+  srsran::unique_byte_buffer_t ip_msg1 = make_byte_buffer();
+  TESTASSERT(ip_msg1 != nullptr);
+  ip_msg1->N_bytes = ip_message_len1;
+  memcpy(ip_msg1->msg, ip_tst_message1, ip_message_len1);
+
+  uint8_t protocol_udp[2] = {PROTOCOL_ID_TYPE, UDP_PROTOCOL};
+  TESTASSERT(add_tft(matcher, 5, 1, 1, protocol_udp, sizeof(protocol_udp)) == SRSRAN_SUCCESS);
+
+  // Filters are added and removed while packets are being classified
+  std::atomic<bool> running{true};
+  std::thread       updater([&matcher, &running]() {
+    uint8_t remote_port_2001[3] = {SINGLE_REMOTE_PORT_TYPE};
+    srsran::uint16_to_uint8(2001, &remote_port_2001[1]);
+    for (uint32_t i = 0; i < 2000; i++) {
+      add_tft(matcher, 6, 2, 0, remote_port_2001, sizeof(remote_port_2001));
+      matcher.delete_tft_for_eps_bearer(6);
+    }
+    running = false;
+  });
+
+  uint32_t nof_errors = 0;
+  while (running) {
+    uint8_t eps_bearer_id = 0;
+    if (matcher.check_tft_filter_match(ip_msg1, eps_bearer_id) != SRSRAN_SUCCESS ||
+        (eps_bearer_id != 5 && eps_bearer_id != 6)) {
+      nof_errors++;
+    }
+  }
+  updater.join();
+  TESTASSERT(nof_errors == 0);
+
+  printf("Test TFT matcher concurrent update successfull\n");
+  return 0;
+}
+
 int main(int argc, char** argv)
 {
   srslog::basic_logger& logger = srslog::fetch_basic_logger("TFT", false);
@@ -435,4 +604,13 @@ int main(int argc, char** argv)
   if (tft_filter_test_ipv6_combined()) {
     return -1;
   }
+  if (tft_filter_test_port_range()) {
+    return -1;
+  }
+  if (tft_pdu_matcher_test_precedence()) {
+    return -1;
+  }
+  if (tft_pdu_matcher_test_concurrent_update()) {
+    return -1;
+  }
 }
@@ -0,0 +1,368 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/common/test_common.h"
+#include "srsue/hdr/stack/upper/tun_offload.h"
+#include <netinet/in.h>
+
+using namespace srsue;
+
+namespace {
+
+const uint32_t TEST_MSS     = 1400;
+const uint32_t TEST_SEQ     = 0xfffff000; // wraps around within the super-packet
+const uint16_t TEST_IP_ID   = 0xfffe;     // wraps around within the super-packet
+const uint32_t TCP_HDR_LEN  = 32;         // with timestamps option
+const uint8_t  TCP_ACK      = 0x10;
+const uint8_t  TCP_PSH_ACK  = 0x18;
+const uint32_t IPV6_HDR_LEN = 40;
+
+uint32_t csum_add(uint32_t sum, const uint8_t* data, uint32_t len)
+{
+  for (uint32_t i = 0; i < len; i += 2) {
+    sum += (data[i] << 8U) | (i + 1 < len ? data[i + 1] : 0);
+  }
+  return sum;
+}
+
+uint16_t csum_fold(uint32_t sum)
+{
+  while (sum >> 16U) {
+    sum = (sum & 0xffff) + (sum >> 16U);
+  }
+  return sum;
+}
+
+uint32_t ip_hdr_len(const uint8_t* pkt)
+{
+  return (pkt[0] >> 4U) == 4 ? 20 : IPV6_HDR_LEN;
+}
+
+uint32_t tcp_pseudo_sum(const uint8_t* pkt, uint32_t l4_len)
+{
+  if ((pkt[0] >> 4U) == 4) {
+    return csum_add(IPPROTO_TCP + l4_len, &pkt[12], 8);
+  }
+  return csum_add(IPPROTO_TCP + l4_len, &pkt[8], 32);
+}
+
+bool tcp_csum_ok(const uint8_t* pkt, uint32_t len)
+{
+  uint32_t l3 = ip_hdr_len(pkt);
+  return csum_fold(csum_add(tcp_pseudo_sum(pkt, len - l3), &pkt[l3], len - l3)) == 0xffff;
+}
+
+bool ipv4_csum_ok(const uint8_t* pkt)
+{
+  return (pkt[0] >> 4U) != 4 or csum_fold(csum_add(0, pkt, 20)) == 0xffff;
+}
+
+/// Builds a TCP packet with valid checksums. Payload byte i is (seq + i) % 251
+void build_tcp_pkt(srsran::byte_buffer_t& pdu,
+                   bool                   ipv6,
+                   uint32_t               seq,
+                   uint16_t               ip_id,
+                   uint8_t                flags,
+                   uint32_t               payload_len)
+{
+  uint32_t l3  = ipv6 ? IPV6_HDR_LEN : 20;
+  uint32_t len = l3 + TCP_HDR_LEN + payload_len;
+  memset(pdu.msg, 0, l3 + TCP_HDR_LEN);
+  pdu.N_bytes = len;
+
+  uint8_t* ip = pdu.msg;
+  if (ipv6) {
+    ip[0] = 0x60;
+    ip[4] = (len - l3) >> 8U;
+    ip[5] = (len - l3) & 0xff;
+    ip[6] = IPPROTO_TCP;
+    ip[7] = 64;
+    for (uint32_t i = 0; i < 32; i++) {
+      ip[8 + i] = i;
+    }
+  } else {
+    ip[0]  = 0x45;
+    ip[2]  = len >> 8U;
+    ip[3]  = len & 0xff;
+    ip[4]  = ip_id >> 8U;
+    ip[5]  = ip_id & 0xff;
+    ip[6]  = 0x40; // DF
+    ip[8]  = 64;
+    ip[9]  = IPPROTO_TCP;
+    ip[12] = 10;
+    ip[15] = 1;
+    ip[16] = 10;
+    ip[19] = 2;
+    uint16_t csum = ~csum_fold(csum_add(0, ip, 20));
+    ip[10]        = csum >> 8U;
+    ip[11]        = csum & 0xff;
+  }
+
+  uint8_t* tcp = &ip[l3];
+  tcp[0]       = 0x13; // port 5001
+  tcp[1]       = 0x89;
+  tcp[2]       = 0xa0; // port 41000
+  tcp[3]       = 0x28;
+  for (uint32_t i = 0; i < 4; i++) {
+    tcp[4 + i] = (seq >> (24U - 8U * i)) & 0xff;
+    tcp[8 + i] = 0x11 * (i + 1);
+  }
+  tcp[12] = (TCP_HDR_LEN / 4) << 4U;
+  tcp[13] = flags;
+  tcp[14] = 0x01;
+  // NOP, NOP, timestamps
+  tcp[20] = 1;
+  tcp[21] = 1;
+  tcp[22] = 8;
+  tcp[23] = 10;
+  tcp[24] = 0xab;
+  for (uint32_t i = 0; i < payload_len; i++) {
+    tcp[TCP_HDR_LEN + i] = (seq + i) % 251;
+  }
+  uint16_t csum = ~csum_fold(csum_add(tcp_pseudo_sum(ip, len - l3), tcp, len - l3));
+  tcp[16]       = csum >> 8U;
+  tcp[17]       = csum & 0xff;
+}
+
+/// Builds the TSO super-packet the host hands over when sending payload_len bytes in segments of TEST_MSS bytes
+void build_super_pkt(std::vector<uint8_t>& pkt, tun_vnet_hdr_t& vnet_hdr, bool ipv6, uint32_t payload_len)
+{
+  srsran::byte_buffer_t pdu;
+  build_tcp_pkt(pdu, ipv6, TEST_SEQ, TEST_IP_ID, TCP_PSH_ACK, 0);
+
+  uint32_t l3 = ip_hdr_len(pdu.msg);
+  pkt.assign(pdu.msg, pdu.msg + pdu.N_bytes);
+  for (uint32_t i = 0; i < payload_len; i++) {
+    pkt.push_back((TEST_SEQ + i) % 251);
+  }
+  if (ipv6) {
+    pkt[4] = (pkt.size() - l3) >> 8U;
+    pkt[5] = (pkt.size() - l3) & 0xff;
+  } else {
+    pkt[2]        = pkt.size() >> 8U;
+    pkt[3]        = pkt.size() & 0xff;
+    pkt[10]       = 0;
+    pkt[11]       = 0;
+    uint16_t csum = ~csum_fold(csum_add(0, pkt.data(), 20));
+    pkt[10]       = csum >> 8U;
+    pkt[11]       = csum & 0xff;
+  }
+  // The host leaves the pseudo-header sum in the checksum field
+  uint16_t csum = csum_fold(tcp_pseudo_sum(pkt.data(), pkt.size() - l3));
+  pkt[l3 + 16]  = csum >> 8U;
+  pkt[l3 + 17]  = csum & 0xff;
+
+  vnet_hdr             = {};
+  vnet_hdr.flags       = TUN_VNET_HDR_F_NEEDS_CSUM;
+  vnet_hdr.gso_type    = ipv6 ? TUN_VNET_HDR_GSO_TCPV6 : TUN_VNET_HDR_GSO_TCPV4;
+  vnet_hdr.hdr_len     = l3 + TCP_HDR_LEN;
+  vnet_hdr.gso_size    = TEST_MSS;
+  vnet_hdr.csum_start  = l3;
+  vnet_hdr.csum_offset = 16;
+}
+
+int split(const tun_vnet_hdr_t&                      vnet_hdr,
+          std::vector<uint8_t>&                      pkt,
+          std::vector<srsran::unique_byte_buffer_t>& segments)
+{
+  auto segment_fn = [&segments](const uint8_t* hdr, uint32_t hdr_len, const uint8_t* payload, uint32_t len) {
+    srsran::unique_byte_buffer_t seg = srsran::make_byte_buffer();
+    memcpy(seg->msg, hdr, hdr_len);
+    if (len > 0) {
+      memcpy(&seg->msg[hdr_len], payload, len);
+    }
+    seg->N_bytes = hdr_len + len;
+    segments.push_back(std::move(seg));
+  };
+  return tun_gso_split(vnet_hdr, pkt.data(), pkt.size(), segment_fn);
+}
+
+int test_gso_split(bool ipv6)
+{
+  uint32_t             payload_len = 2 * TEST_MSS + 1200;
+  std::vector<uint8_t> pkt;
+  tun_vnet_hdr_t       vnet_hdr;
+  build_super_pkt(pkt, vnet_hdr, ipv6, payload_len);
+
+  std::vector<srsran::unique_byte_buffer_t> segments;
+  TESTASSERT(split(vnet_hdr, pkt, segments) == 3);
+  TESTASSERT(segments.size() == 3);
+
+  // Each segment is the packet the host would have sent without TSO
+  for (uint32_t i = 0; i < segments.size(); i++) {
+    bool                  last = i + 1 == segments.size();
+    srsran::byte_buffer_t expected;
+    build_tcp_pkt(expected,
+                  ipv6,
+                  TEST_SEQ + i * TEST_MSS,
+                  TEST_IP_ID + i,
+                  last ? TCP_PSH_ACK : TCP_ACK,
+                  last ? payload_len - 2 * TEST_MSS : TEST_MSS);
+    TESTASSERT(segments[i]->N_bytes == expected.N_bytes);
+    TESTASSERT(memcmp(segments[i]->msg, expected.msg, expected.N_bytes) == 0);
+    TESTASSERT(tcp_csum_ok(segments[i]->msg, segments[i]->N_bytes));
+    TESTASSERT(ipv4_csum_ok(segments[i]->msg));
+  }
+
+  // Unsupported GSO type
+  vnet_hdr.gso_type = 3; // UDP fragmentation
+  segments.clear();
+  TESTASSERT(split(vnet_hdr, pkt, segments) < 0);
+  TESTASSERT(segments.empty());
+
+  return SRSRAN_SUCCESS;
+}
+
+int test_partial_csum()
+{
+  srsran::byte_buffer_t pdu;
+  build_tcp_pkt(pdu, false, TEST_SEQ, TEST_IP_ID, TCP_ACK, 100);
+  std::vector<uint8_t> pkt(pdu.msg, pdu.msg + pdu.N_bytes);
+
+  // Replace the checksum with the pseudo-header sum, as the host does with TUN_F_CSUM
+  uint16_t csum = csum_fold(tcp_pseudo_sum(pkt.data(), pkt.size() - 20));
+  pkt[36]       = csum >> 8U;
+  pkt[37]       = csum & 0xff;
+  TESTASSERT(not tcp_csum_ok(pkt.data(), pkt.size()));
+
+  tun_vnet_hdr_t vnet_hdr = {};
+  vnet_hdr.flags          = TUN_VNET_HDR_F_NEEDS_CSUM;
+  vnet_hdr.csum_start     = 20;
+  vnet_hdr.csum_offset    = 16;
+
+  std::vector<srsran::unique_byte_buffer_t> segments;
+  TESTASSERT(split(vnet_hdr, pkt, segments) == 1);
+  TESTASSERT(segments[0]->N_bytes == pdu.N_bytes);
+  TESTASSERT(memcmp(segments[0]->msg, pdu.msg, pdu.N_bytes) == 0);
+
+  return SRSRAN_SUCCESS;
+}
+
+int test_gro_round_trip(bool ipv6)
+{
+  // Segments received from PDCP, merged into one super-packet
+  uint32_t      payload_len = 5 * TEST_MSS + 10;
+  tun_gro_batch batch;
+  for (uint32_t i = 0; i < 6; i++) {
+    bool                         last = i == 5;
+    srsran::unique_byte_buffer_t pdu  = srsran::make_byte_buffer();
+    build_tcp_pkt(*pdu, ipv6, TEST_SEQ + i * TEST_MSS, TEST_IP_ID + i, last ? TCP_PSH_ACK : TCP_ACK, last ? 10 : TEST_MSS);
+    TESTASSERT(batch.add(pdu));
+  }
+  TESTASSERT(batch.size() == 6);
+
+  // The batch is closed by the PSH flag
+  srsran::unique_byte_buffer_t next = srsran::make_byte_buffer();
+  build_tcp_pkt(*next, ipv6, TEST_SEQ + payload_len, (uint16_t)(TEST_IP_ID + 6), TCP_ACK, TEST_MSS);
+  TESTASSERT(not batch.add(next));
+  TESTASSERT(next != nullptr);
+
+  const std::vector<struct iovec>& iov = batch.prepare();
+  TESTASSERT(iov.size() == 7);
+  TESTASSERT(iov[0].iov_len == TUN_VNET_HDR_LEN);
+  tun_vnet_hdr_t vnet_hdr;
+  memcpy(&vnet_hdr, iov[0].iov_base, TUN_VNET_HDR_LEN);
+  uint32_t l3 = ipv6 ? IPV6_HDR_LEN : 20;
+  TESTASSERT(vnet_hdr.gso_type == (ipv6 ? TUN_VNET_HDR_GSO_TCPV6 : TUN_VNET_HDR_GSO_TCPV4));
+  TESTASSERT(vnet_hdr.gso_size == TEST_MSS);
+  TESTASSERT(vnet_hdr.hdr_len == l3 + TCP_HDR_LEN);
+  TESTASSERT(vnet_hdr.csum_start == l3);
+
+  std::vector<uint8_t> pkt;
+  for (uint32_t i = 1; i < iov.size(); i++) {
+    const uint8_t* base = (const uint8_t*)iov[i].iov_base;
+    pkt.insert(pkt.end(), base, base + iov[i].iov_len);
+  }
+  TESTASSERT(pkt.size() == l3 + TCP_HDR_LEN + payload_len);
+
+  // Same super-packet as the one the host would have sent
+  std::vector<uint8_t> expected;
+  tun_vnet_hdr_t       expected_hdr;
+  build_super_pkt(expected, expected_hdr, ipv6, payload_len);
+  TESTASSERT(pkt == expected);
+  batch.clear();
+
+  // Segmented again, it gives back the original segments
+  std::vector<srsran::unique_byte_buffer_t> segments;
+  TESTASSERT(split(vnet_hdr, pkt, segments) == 6);
+  for (uint32_t i = 0; i < segments.size(); i++) {
+    TESTASSERT(tcp_csum_ok(segments[i]->msg, segments[i]->N_bytes));
+    TESTASSERT(ipv4_csum_ok(segments[i]->msg));
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+int test_gro_reject()
+{
+  tun_gro_batch                batch;
+  srsran::unique_byte_buffer_t pdu = srsran::make_byte_buffer();
+  build_tcp_pkt(*pdu, false, TEST_SEQ, TEST_IP_ID, TCP_ACK, TEST_MSS);
+  TESTASSERT(batch.add(pdu));
+
+  // Not the next sequence number
+  pdu = srsran::make_byte_buffer();
+  build_tcp_pkt(*pdu, false, TEST_SEQ + 2 * TEST_MSS, TEST_IP_ID + 1, TCP_ACK, TEST_MSS);
+  TESTASSERT(not batch.add(pdu));
+
+  // Wrong checksum
+  build_tcp_pkt(*pdu, false, TEST_SEQ + TEST_MSS, TEST_IP_ID + 1, TCP_ACK, TEST_MSS);
+  pdu->msg[100] ^= 1;
+  TESTASSERT(not batch.add(pdu));
+
+  // Not a TCP packet
+  build_tcp_pkt(*pdu, false, TEST_SEQ + TEST_MSS, TEST_IP_ID + 1, TCP_ACK, TEST_MSS);
+  pdu->msg[9] = IPPROTO_UDP;
+  TESTASSERT(not batch.add(pdu));
+
+  // A lone segment is written without offload
+  const std::vector<struct iovec>& iov = batch.prepare();
+  TESTASSERT(iov.size() == 2);
+  tun_vnet_hdr_t vnet_hdr;
+  memcpy(&vnet_hdr, iov[0].iov_base, TUN_VNET_HDR_LEN);
+  TESTASSERT(vnet_hdr.gso_type == TUN_VNET_HDR_GSO_NONE and vnet_hdr.flags == 0);
+  TESTASSERT(tcp_csum_ok((const uint8_t*)iov[1].iov_base, iov[1].iov_len));
+  batch.clear();
+
+  // Packets that can not be merged are taken by an empty batch and close it
+  TESTASSERT(batch.add(pdu));
+  pdu = srsran::make_byte_buffer();
+  build_tcp_pkt(*pdu, false, TEST_SEQ, TEST_IP_ID, TCP_ACK, TEST_MSS);
+  TESTASSERT(not batch.add(pdu));
+
+  return SRSRAN_SUCCESS;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+  srslog::init();
+
+  TESTASSERT(test_gso_split(false) == SRSRAN_SUCCESS);
+  TESTASSERT(test_gso_split(true) == SRSRAN_SUCCESS);
+  TESTASSERT(test_partial_csum() == SRSRAN_SUCCESS);
+  TESTASSERT(test_gro_round_trip(false) == SRSRAN_SUCCESS);
+  TESTASSERT(test_gro_round_trip(true) == SRSRAN_SUCCESS);
+  TESTASSERT(test_gro_reject() == SRSRAN_SUCCESS);
+
+  return SRSRAN_SUCCESS;
+}
@@ -20,12 +20,15 @@
  */
 
 #include "srsue/hdr/stack/upper/tft_packet_filter.h"
+#include "srsran/adt/scope_exit.h"
 #include "srsran/upper/ipv6.h"
 
 extern "C" {
 #include "srsran/config.h"
 }
 
+#include <algorithm>
+#include <arpa/inet.h>
 #include <linux/ip.h>
 #include <linux/tcp.h>
 #include <linux/udp.h>
@@ -79,7 +82,7 @@ tft_packet_filter_t::tft_packet_filter_t(uint8_t
         active_filters |= IPV6_REMOTE_ADDR_LENGTH_FLAG;
         memcpy(&ipv6_remote_addr, &tft.filter[idx], IPV6_ADDR_SIZE);
         idx += IPV6_ADDR_SIZE;
-        ipv6_remote_addr_length = tft.filter[idx++];
+        ipv6_remote_addr_length = std::min(tft.filter[idx++], (uint8_t)(IPV6_ADDR_SIZE * 8));
         // convert address length to mask:
         length_in_bytes = ipv6_remote_addr_length / 8;
         remaining_bits  = ipv6_remote_addr_length % 8;
@@ -95,7 +98,7 @@ tft_packet_filter_t::tft_packet_filter_t(uint8_t
         active_filters |= IPV6_LOCAL_ADDR_LENGTH_FLAG;
         memcpy(&ipv6_local_addr, &tft.filter[idx], IPV6_ADDR_SIZE);
         idx += IPV6_ADDR_SIZE;
-        ipv6_local_addr_length = tft.filter[idx++];
+        ipv6_local_addr_length = std::min(tft.filter[idx++], (uint8_t)(IPV6_ADDR_SIZE * 8));
         // convert address length to mask:
         length_in_bytes = ipv6_local_addr_length / 8;
         remaining_bits  = ipv6_local_addr_length % 8;
@@ -173,16 +176,132 @@ tft_packet_filter_t::tft_packet_filter_t(uint8_t
 
       default:
         logger.error("ERROR: wrong type: 0x%02x", filter_type);
+        compile_rule();
         return;
     }
   }
+  compile_rule();
 }
 
-bool inline tft_packet_filter_t::filter_contains(uint16_t filtertype)
+bool inline tft_packet_filter_t::filter_contains(uint16_t filtertype) const
 {
   return (active_filters & filtertype) != 0;
 }
 
+/*
+ * Converts the filter components into the rule compared against the parsed packet fields.
+ */
+void tft_packet_filter_t::compile_rule()
+{
+  uint16_t ipv4_flags = IPV4_REMOTE_ADDR_FLAG | IPV4_LOCAL_ADDR_FLAG;
+  uint16_t ipv6_flags = IPV6_REMOTE_ADDR_FLAG | IPV6_REMOTE_ADDR_LENGTH_FLAG | IPV6_LOCAL_ADDR_LENGTH_FLAG;
+
+  rule                = {};
+  rule.eps_bearer_id  = eps_bearer_id;
+  rule.active_filters = active_filters;
+
+  // Addresses, masked once here. A filter with components of both IP versions matches no packet
+  uint8_t local_addr[IPV6_ADDR_SIZE]  = {};
+  uint8_t local_mask[IPV6_ADDR_SIZE]  = {};
+  uint8_t remote_addr[IPV6_ADDR_SIZE] = {};
+  uint8_t remote_mask[IPV6_ADDR_SIZE] = {};
+  if (filter_contains(ipv4_flags)) {
+    rule.addr_version = filter_contains(ipv6_flags) ? 0xff : 4;
+    if (filter_contains(IPV4_LOCAL_ADDR_FLAG)) {
+      memcpy(local_addr, &ipv4_local_addr, IPV4_ADDR_SIZE);
+      memcpy(local_mask, &ipv4_local_addr_mask, IPV4_ADDR_SIZE);
+    }
+    if (filter_contains(IPV4_REMOTE_ADDR_FLAG)) {
+      memcpy(remote_addr, &ipv4_remote_addr, IPV4_ADDR_SIZE);
+      memcpy(remote_mask, &ipv4_remote_addr_mask, IPV4_ADDR_SIZE);
+    }
+  } else if (filter_contains(ipv6_flags)) {
+    rule.addr_version = 6;
+    if (filter_contains(IPV6_LOCAL_ADDR_LENGTH_FLAG)) {
+      memcpy(local_addr, ipv6_local_addr, IPV6_ADDR_SIZE);
+      memcpy(local_mask, ipv6_local_addr_mask, IPV6_ADDR_SIZE);
+    }
+    if (filter_contains(IPV6_REMOTE_ADDR_FLAG | IPV6_REMOTE_ADDR_LENGTH_FLAG)) {
+      memcpy(remote_addr, ipv6_remote_addr, IPV6_ADDR_SIZE);
+      memcpy(remote_mask, ipv6_remote_addr_mask, IPV6_ADDR_SIZE);
+    }
+  }
+  memcpy(rule.local_addr_mask, local_mask, IPV6_ADDR_SIZE);
+  memcpy(rule.remote_addr_mask, remote_mask, IPV6_ADDR_SIZE);
+  for (uint32_t i = 0; i < IPV6_ADDR_SIZE; i++) {
+    local_addr[i] &= local_mask[i];
+    remote_addr[i] &= remote_mask[i];
+  }
+  memcpy(rule.local_addr, local_addr, IPV6_ADDR_SIZE);
+  memcpy(rule.remote_addr, remote_addr, IPV6_ADDR_SIZE);
+
+  rule.protocol_id = protocol_id;
+
+  // Ports, stored in network byte order by the constructor
+  if (filter_contains(SINGLE_LOCAL_PORT_FLAG)) {
+    rule.local_port_min = rule.local_port_max = ntohs(single_local_port);
+  } else if (filter_contains(LOCAL_PORT_RANGE_FLAG)) {
+    rule.local_port_min = std::min(ntohs(local_port_range[0]), ntohs(local_port_range[1]));
+    rule.local_port_max = std::max(ntohs(local_port_range[0]), ntohs(local_port_range[1]));
+  }
+  if (filter_contains(SINGLE_REMOTE_PORT_FLAG)) {
+    rule.remote_port_min = rule.remote_port_max = ntohs(single_remote_port);
+  } else if (filter_contains(REMOTE_PORT_RANGE_FLAG)) {
+    rule.remote_port_min = std::min(ntohs(remote_port_range[0]), ntohs(remote_port_range[1]));
+    rule.remote_port_max = std::max(ntohs(remote_port_range[0]), ntohs(remote_port_range[1]));
+  }
+
+  rule.tos        = type_of_service;
+  rule.tos_mask   = type_of_service_mask;
+  rule.flow_label = ((flow_label[0] & 0x0fU) << 16U) | (flow_label[1] << 8U) | flow_label[2];
+  rule.spi        = security_parameter_index;
+}
+
+bool tft_parse_pkt_fields(const uint8_t* pkt, uint32_t len, tft_pkt_fields_t& fields)
+{
+  uint32_t l4_offset = 0;
+
+  fields = {};
+  if (len < sizeof(struct iphdr)) {
+    return false;
+  }
+  fields.version = pkt[0] >> 4U;
+  if (fields.version == 4) {
+    const struct iphdr* ip_pkt = (const struct iphdr*)pkt;
+    fields.protocol            = ip_pkt->protocol;
+    fields.tos                 = ip_pkt->tos;
+    memcpy(&fields.local_addr[0], &ip_pkt->saddr, IPV4_ADDR_SIZE);
+    memcpy(&fields.remote_addr[0], &ip_pkt->daddr, IPV4_ADDR_SIZE);
+    l4_offset = ip_pkt->ihl * 4;
+  } else if (fields.version == 6) {
+    if (len < sizeof(struct ipv6hdr)) {
+      return false;
+    }
+    const struct ipv6hdr* ip6_pkt = (const struct ipv6hdr*)pkt;
+    fields.protocol               = ip6_pkt->nexthdr;
+    fields.tos                    = ((pkt[0] & 0x0fU) << 4U) | (pkt[1] >> 4U);
+    fields.flow_label             = ((pkt[1] & 0x0fU) << 16U) | (pkt[2] << 8U) | pkt[3];
+    memcpy(fields.local_addr, &ip6_pkt->saddr, IPV6_ADDR_SIZE);
+    memcpy(fields.remote_addr, &ip6_pkt->daddr, IPV6_ADDR_SIZE);
+    l4_offset = sizeof(struct ipv6hdr);
+  } else {
+    return false;
+  }
+
+  // It is implied, that this is always an OUTGOING packet
+  if (len >= l4_offset + 4) {
+    if (fields.protocol == UDP_PROTOCOL || fields.protocol == TCP_PROTOCOL) {
+      fields.has_ports   = true;
+      fields.local_port  = (pkt[l4_offset] << 8U) | pkt[l4_offset + 1];
+      fields.remote_port = (pkt[l4_offset + 2] << 8U) | pkt[l4_offset + 3];
+    } else if (fields.protocol == ESP_PROTOCOL) {
+      fields.has_spi = true;
+      memcpy(&fields.spi, &pkt[l4_offset], 4);
+    }
+  }
+  return true;
+}
+
 /*
  * Implements packet matching against the packet filter componenets as specified in TS 24.008, section 10.5.6.12.
  *
@@ -191,205 +310,142 @@ bool inline tft_packet_filter_t::filter_contains(uint16_t filtertype)
  *
  * Note: 'active_filters' is a bitmask; bits set to '1' represent active filter components.
  */
-bool tft_packet_filter_t::match(const srsran::unique_byte_buffer_t& pdu)
+bool tft_filter_rule_t::match(const tft_pkt_fields_t& pkt) const
 {
-  uint16_t ip_flags = IPV4_REMOTE_ADDR_FLAG | IPV4_LOCAL_ADDR_FLAG | IPV6_REMOTE_ADDR_FLAG |
-                      IPV6_REMOTE_ADDR_LENGTH_FLAG | IPV6_LOCAL_ADDR_LENGTH_FLAG;
-  uint16_t port_flags =
-      SINGLE_LOCAL_PORT_FLAG | LOCAL_PORT_RANGE_FLAG | SINGLE_REMOTE_PORT_FLAG | REMOTE_PORT_RANGE_FLAG;
-
   // Check if there is any active filter
   if (active_filters == 0) {
     return false;
   }
 
-  // Match IP Header to active filters
-  if (filter_contains(ip_flags) && !match_ip(pdu)) {
-    return false;
+  // Match IP addresses, with the components that are not active fully masked
+  if (addr_version != 0) {
+    if (pkt.version != addr_version) {
+      return false;
+    }
+    uint64_t diff = ((pkt.local_addr[0] & local_addr_mask[0]) ^ local_addr[0]) |
+                    ((pkt.local_addr[1] & local_addr_mask[1]) ^ local_addr[1]) |
+                    ((pkt.remote_addr[0] & remote_addr_mask[0]) ^ remote_addr[0]) |
+                    ((pkt.remote_addr[1] & remote_addr_mask[1]) ^ remote_addr[1]);
+    if (diff != 0) {
+      return false;
+    }
   }
 
   // Check Protocol ID/Next Header Field
-  if (filter_contains(PROTOCOL_ID_FLAG) && !match_protocol(pdu)) {
+  if ((active_filters & PROTOCOL_ID_FLAG) && pkt.protocol != protocol_id) {
     return false;
   }
 
   // Check Ports/Port Range
-  if (filter_contains(port_flags) && !match_port(pdu)) {
-    return false;
+  if (active_filters &
+      (SINGLE_LOCAL_PORT_FLAG | LOCAL_PORT_RANGE_FLAG | SINGLE_REMOTE_PORT_FLAG | REMOTE_PORT_RANGE_FLAG)) {
+    if (!pkt.has_ports || pkt.local_port < local_port_min || pkt.local_port > local_port_max ||
+        pkt.remote_port < remote_port_min || pkt.remote_port > remote_port_max) {
+      return false;
+    }
   }
 
   // Check Type of Service/Traffic class
-  if (filter_contains(TYPE_OF_SERVICE_FLAG) && !match_type_of_service(pdu)) {
+  if ((active_filters & TYPE_OF_SERVICE_FLAG) && ((pkt.tos ^ tos) & tos_mask) != 0) {
     return false;
   }
 
-  return true;
-}
-
-bool tft_packet_filter_t::match_ip(const srsran::unique_byte_buffer_t& pdu)
-{
-  struct iphdr*   ip_pkt  = (struct iphdr*)pdu->msg;
-  struct ipv6hdr* ip6_pkt = (struct ipv6hdr*)pdu->msg;
-  // It is implied, that this is always an OUTGOING packet
-  if (ip_pkt->version == 4) {
-    // Check match on IPv4 packet
-    if (filter_contains(IPV4_LOCAL_ADDR_FLAG)) {
-      if ((ip_pkt->saddr & ipv4_local_addr_mask) != (ipv4_local_addr & ipv4_local_addr_mask)) {
-        return false;
-      }
-    }
+  // Check Flow label, only present in IPv6
+  if ((active_filters & FLOW_LABEL_FLAG) && (pkt.version != 6 || pkt.flow_label != flow_label)) {
+    return false;
+  }
 
-    if (filter_contains(IPV4_REMOTE_ADDR_FLAG)) {
-      if ((ip_pkt->daddr & ipv4_remote_addr_mask) != (ipv4_remote_addr & ipv4_remote_addr_mask)) {
-        return false;
-      }
-    }
-  } else if (ip_pkt->version == 6) {
-    // Check match on IPv6
-    if (filter_contains(IPV6_REMOTE_ADDR_FLAG | IPV6_REMOTE_ADDR_LENGTH_FLAG)) {
-      bool match = true;
-      for (int i = 0; i < ipv6_remote_addr_length; i++) {
-        match &= ((ipv6_remote_addr[i] ^ ip6_pkt->daddr.in6_u.u6_addr8[i]) & ipv6_remote_addr_mask[i]) == 0;
-        if (!match) {
-          return false;
-        }
-      }
-      return true;
-    }
-  } else {
-    // Error
+  // Check IPsec security parameter index
+  if ((active_filters & SECURITY_PARAMETER_INDEX_FLAG) && (!pkt.has_spi || pkt.spi != spi)) {
     return false;
   }
+
   return true;
 }
 
-bool tft_packet_filter_t::match_protocol(const srsran::unique_byte_buffer_t& pdu)
+bool tft_packet_filter_t::match(const srsran::unique_byte_buffer_t& pdu) const
 {
-  struct iphdr*   ip_pkt  = (struct iphdr*)pdu->msg;
-  struct ipv6hdr* ip6_pkt = (struct ipv6hdr*)pdu->msg;
-
-  if (ip_pkt->version == 4) {
-    // Check match on IPv4 packet
-    if (ip_pkt->protocol != protocol_id) {
-      return false;
-    }
-  } else if (ip_pkt->version == 6) {
-    // Check match on IPv6 packet
-    if (ip6_pkt->nexthdr != protocol_id) {
-      return false;
-    }
-  } else {
-    // Error
-    return false;
-  }
-  return true;
+  tft_pkt_fields_t fields;
+  return tft_parse_pkt_fields(pdu->msg, pdu->N_bytes, fields) && rule.match(fields);
 }
 
-bool tft_packet_filter_t::match_type_of_service(const srsran::unique_byte_buffer_t& pdu)
+tft_classifier::tft_classifier(const std::map<uint16_t, tft_packet_filter_t>& filters)
 {
-  struct iphdr* ip_pkt = (struct iphdr*)pdu->msg;
+  rules.reserve(filters.size());
+  for (const std::pair<const uint16_t, tft_packet_filter_t>& filter_pair : filters) {
+    const tft_filter_rule_t& rule = filter_pair.second.rule;
+    if (rule.active_filters == 0) {
+      continue;
+    }
 
-  if (ip_pkt->version == 4) {
-    // Check match on IPv4 packet
-    if ((ip_pkt->tos ^ type_of_service) & type_of_service_mask) {
-      return false;
+    // Rules are added in precedence order, so that every list is sorted by precedence
+    uint32_t idx = rules.size();
+    rules.push_back(rule);
+    if (rule.active_filters & SINGLE_REMOTE_PORT_FLAG) {
+      rules_by_remote_port[rule.remote_port_min].push_back(idx);
+    } else if (rule.active_filters & SINGLE_LOCAL_PORT_FLAG) {
+      rules_by_local_port[rule.local_port_min].push_back(idx);
+    } else if (rule.active_filters & PROTOCOL_ID_FLAG) {
+      rules_by_protocol[rule.protocol_id].push_back(idx);
+    } else {
+      other_rules.push_back(idx);
     }
-  } else if (ip_pkt->version == 6) {
-    // IPv6 traffic class not supported yet
-    return false;
   }
-  return true;
 }
 
-bool tft_packet_filter_t::match_flow_label(const srsran::unique_byte_buffer_t& pdu)
+/// Looks for a rule of the list matching the packet with higher precedence than best, and updates best if found
+bool tft_classifier::find_first(const rule_list_t& list, const tft_pkt_fields_t& pkt, uint32_t& best) const
 {
-  struct ipv6hdr* ip6_pkt = (struct ipv6hdr*)pdu->msg;
-
-  if (ip6_pkt->version == 6 && (active_filters & FLOW_LABEL_FLAG)) {
-    // Check match on IPv4 packet
-    if (memcmp(ip6_pkt->flow_lbl, flow_label, 3) != 0) {
+  for (uint32_t idx : list) {
+    if (idx >= best) {
       return false;
     }
+    if (rules[idx].match(pkt)) {
+      best = idx;
+      return true;
+    }
   }
-  return true;
+  return false;
 }
 
-bool tft_packet_filter_t::match_port(const srsran::unique_byte_buffer_t& pdu)
+const tft_filter_rule_t* tft_classifier::classify(const tft_pkt_fields_t& pkt) const
 {
-  struct iphdr*   ip_pkt  = (struct iphdr*)pdu->msg;
-  struct ipv6hdr* ip6_pkt = (struct ipv6hdr*)pdu->msg;
-  struct udphdr*  udp_pkt;
-  struct tcphdr*  tcp_pkt;
-
-  if (ip_pkt->version == 4) {
-    switch (ip_pkt->protocol) {
-      case UDP_PROTOCOL:
-        udp_pkt = (struct udphdr*)&pdu->msg[ip_pkt->ihl * 4];
-        if (active_filters & SINGLE_LOCAL_PORT_FLAG) {
-          if (udp_pkt->source != single_local_port) {
-            return false;
-          }
-        }
-        if (active_filters & SINGLE_REMOTE_PORT_FLAG) {
-          if (udp_pkt->dest != single_remote_port) {
-            return false;
-          }
-        }
-        break;
-      case TCP_PROTOCOL:
-        tcp_pkt = (struct tcphdr*)&pdu->msg[ip_pkt->ihl * 4];
-        if (active_filters & SINGLE_LOCAL_PORT_FLAG) {
-          if (tcp_pkt->source != single_local_port) {
-            return false;
-          }
-        }
-        if (active_filters & SINGLE_REMOTE_PORT_FLAG) {
-          if (tcp_pkt->dest != single_remote_port) {
-            return false;
-          }
-        }
-        break;
-      default:
-        return false;
+  uint32_t best = rules.size();
+
+  if (pkt.has_ports) {
+    auto remote_it = rules_by_remote_port.find(pkt.remote_port);
+    if (remote_it != rules_by_remote_port.end()) {
+      find_first(remote_it->second, pkt, best);
     }
-  } else if (ip_pkt->version == 6) {
-    switch (ip6_pkt->nexthdr) {
-      case UDP_PROTOCOL:
-        udp_pkt = (struct udphdr*)&pdu->msg[sizeof(ipv6hdr)];
-        if (active_filters & SINGLE_LOCAL_PORT_FLAG) {
-          if (udp_pkt->source != single_local_port) {
-            return false;
-          }
-        }
-        if (active_filters & SINGLE_REMOTE_PORT_FLAG) {
-          if (udp_pkt->dest != single_remote_port) {
-            return false;
-          }
-        }
-        break;
-      case TCP_PROTOCOL:
-        tcp_pkt = (struct tcphdr*)&pdu->msg[sizeof(ipv6hdr)];
-        if (active_filters & SINGLE_LOCAL_PORT_FLAG) {
-          if (tcp_pkt->source != single_local_port) {
-            return false;
-          }
-        }
-        if (active_filters & SINGLE_REMOTE_PORT_FLAG) {
-          if (tcp_pkt->dest != single_remote_port) {
-            return false;
-          }
-        }
-        break;
-      default:
-        return false;
+    auto local_it = rules_by_local_port.find(pkt.local_port);
+    if (local_it != rules_by_local_port.end()) {
+      find_first(local_it->second, pkt, best);
     }
   }
-  return true;
+  auto protocol_it = rules_by_protocol.find(pkt.protocol);
+  if (protocol_it != rules_by_protocol.end()) {
+    find_first(protocol_it->second, pkt, best);
+  }
+  find_first(other_rules, pkt, best);
+
+  return best < rules.size() ? &rules[best] : nullptr;
 }
 
 void tft_pdu_matcher::reset()
 {
+  std::lock_guard<std::mutex> lock(tft_mutex);
   tft_filter_map.clear();
+  classifier.reset(nullptr);
+}
+
+/// Publishes a classifier built from the current filters. Must be called with tft_mutex held
+void tft_pdu_matcher::update_classifier()
+{
+  if (tft_filter_map.empty()) {
+    classifier.reset(nullptr);
+    return;
+  }
+  classifier.reset(std::unique_ptr<const tft_classifier>(new tft_classifier(tft_filter_map)));
 }
 
 /**
@@ -401,16 +457,23 @@ void tft_pdu_matcher::reset()
  */
 int tft_pdu_matcher::check_tft_filter_match(const srsran::unique_byte_buffer_t& pdu, uint8_t& eps_bearer_id)
 {
-  std::lock_guard<std::mutex> lock(tft_mutex);
-  for (std::pair<const uint16_t, tft_packet_filter_t>& filter_pair : tft_filter_map) {
-    bool match = filter_pair.second.match(pdu);
-    if (match) {
-      eps_bearer_id = filter_pair.second.eps_bearer_id;
-      logger.debug("Found filter match -- EPS bearer Id %d", filter_pair.second.eps_bearer_id);
-      return SRSRAN_SUCCESS;
-    }
+  // Lock-free, the classifier is only replaced by the TFT updates
+  srsran::rcu_ptr<tft_classifier>::read_guard current(classifier);
+  if (not current) {
+    return SRSRAN_ERROR;
+  }
+
+  tft_pkt_fields_t fields;
+  if (not tft_parse_pkt_fields(pdu->msg, pdu->N_bytes, fields)) {
+    return SRSRAN_ERROR;
+  }
+  const tft_filter_rule_t* rule = current->classify(fields);
+  if (rule == nullptr) {
+    return SRSRAN_ERROR;
   }
-  return SRSRAN_ERROR;
+  eps_bearer_id = rule->eps_bearer_id;
+  logger.debug("Found filter match -- EPS bearer Id %d", rule->eps_bearer_id);
+  return SRSRAN_SUCCESS;
 }
 
 /**
@@ -421,6 +484,7 @@ int tft_pdu_matcher::check_tft_filter_match(const srsran::unique_byte_buffer_t&
 void tft_pdu_matcher::delete_tft_for_eps_bearer(const uint8_t eps_bearer_id)
 {
   std::lock_guard<std::mutex> lock(tft_mutex);
+  auto                        on_exit = srsran::make_scope_exit([this]() { update_classifier(); });
   auto                        old_filter = std::find_if(
       tft_filter_map.begin(), tft_filter_map.end(), [&](const std::pair<uint16_t, tft_packet_filter_t>& filter) {
         return filter.second.eps_bearer_id == eps_bearer_id;
@@ -435,6 +499,7 @@ int tft_pdu_matcher::apply_traffic_flow_template(const uint8_t&
                                                  const LIBLTE_MME_TRAFFIC_FLOW_TEMPLATE_STRUCT* tft)
 {
   std::lock_guard<std::mutex> lock(tft_mutex);
+  auto                        on_exit = srsran::make_scope_exit([this]() { update_classifier(); });
   switch (tft->tft_op_code) {
     case LIBLTE_MME_TFT_OPERATION_CODE_CREATE_NEW_TFT:
       for (int i = 0; i < tft->packet_filter_list_size; i++) {
@@ -0,0 +1,355 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsue/hdr/stack/upper/tun_offload.h"
+#include <netinet/in.h>
+#include <string.h>
+
+namespace srsue {
+
+namespace {
+
+const uint32_t IPV4_MIN_HDR_LEN = 20;
+const uint32_t IPV6_HDR_LEN     = 40;
+const uint32_t TCP_MIN_HDR_LEN  = 20;
+const uint32_t MAX_HDR_LEN      = 60 + 60; // IPv4 and TCP headers with options
+const uint32_t TCP_CSUM_OFFSET  = 16;
+
+const uint8_t TCP_FLAG_FIN = 0x01;
+const uint8_t TCP_FLAG_PSH = 0x08;
+const uint8_t TCP_FLAG_ACK = 0x10;
+const uint8_t TCP_FLAG_CWR = 0x80;
+
+uint16_t get_be16(const uint8_t* p)
+{
+  return (uint16_t)((p[0] << 8U) | p[1]);
+}
+
+uint32_t get_be32(const uint8_t* p)
+{
+  return ((uint32_t)p[0] << 24U) | ((uint32_t)p[1] << 16U) | ((uint32_t)p[2] << 8U) | p[3];
+}
+
+void set_be16(uint8_t* p, uint16_t v)
+{
+  p[0] = (uint8_t)(v >> 8U);
+  p[1] = (uint8_t)v;
+}
+
+void set_be32(uint8_t* p, uint32_t v)
+{
+  set_be16(p, (uint16_t)(v >> 16U));
+  set_be16(p + 2, (uint16_t)v);
+}
+
+/// Adds data to a one's complement sum. Only the last chunk of a chained sum may have an odd length
+uint64_t csum_add(uint64_t sum, const uint8_t* data, uint32_t len)
+{
+  for (uint32_t i = 0; i + 1 < len; i += 2) {
+    sum += get_be16(&data[i]);
+  }
+  if (len % 2) {
+    sum += (uint32_t)data[len - 1] << 8U;
+  }
+  return sum;
+}
+
+uint16_t csum_fold(uint64_t sum)
+{
+  while (sum >> 16U) {
+    sum = (sum & 0xffff) + (sum >> 16U);
+  }
+  return (uint16_t)sum;
+}
+
+/// Sum of the TCP pseudo-header of an IPv4 or IPv6 packet, for a TCP header and payload of l4_len bytes
+uint64_t tcp_pseudo_hdr_sum(const uint8_t* ip, uint32_t l4_len)
+{
+  if ((ip[0] >> 4U) == 4) {
+    return csum_add(IPPROTO_TCP + l4_len, &ip[12], 8);
+  }
+  return csum_add((uint64_t)IPPROTO_TCP + (l4_len >> 16U) + (l4_len & 0xffff), &ip[8], 32);
+}
+
+/// Fills the lengths of the headers of an IPv4 or IPv6 TCP packet. Returns false if it is not one
+bool parse_tcp(const uint8_t* pkt, uint32_t len, uint32_t& ip_hdr_len, uint32_t& tcp_hdr_len)
+{
+  if (len < IPV4_MIN_HDR_LEN) {
+    return false;
+  }
+  uint8_t version = pkt[0] >> 4U;
+  if (version == 4) {
+    ip_hdr_len = (pkt[0] & 0xfU) * 4;
+    if (ip_hdr_len < IPV4_MIN_HDR_LEN or pkt[9] != IPPROTO_TCP) {
+      return false;
+    }
+  } else if (version == 6) {
+    ip_hdr_len = IPV6_HDR_LEN;
+    if (len < IPV6_HDR_LEN or pkt[6] != IPPROTO_TCP) {
+      return false;
+    }
+  } else {
+    return false;
+  }
+  if (len < ip_hdr_len + TCP_MIN_HDR_LEN) {
+    return false;
+  }
+  tcp_hdr_len = (pkt[ip_hdr_len + 12] >> 4U) * 4;
+  return tcp_hdr_len >= TCP_MIN_HDR_LEN and len >= ip_hdr_len + tcp_hdr_len;
+}
+
+/// Length of an IPv4 or IPv6 packet given by its header
+uint32_t ip_pkt_len(const uint8_t* pkt)
+{
+  return (pkt[0] >> 4U) == 4 ? get_be16(&pkt[2]) : IPV6_HDR_LEN + get_be16(&pkt[4]);
+}
+
+void set_ip_pkt_len(uint8_t* pkt, uint32_t ip_hdr_len, uint32_t len)
+{
+  if ((pkt[0] >> 4U) == 4) {
+    set_be16(&pkt[2], (uint16_t)len);
+    set_be16(&pkt[10], 0);
+    set_be16(&pkt[10], ~csum_fold(csum_add(0, pkt, ip_hdr_len)));
+  } else {
+    set_be16(&pkt[4], (uint16_t)(len - IPV6_HDR_LEN));
+  }
+}
+
+} // namespace
+
+int tun_gso_split(const tun_vnet_hdr_t&     vnet_hdr,
+                  uint8_t*                  pkt,
+                  uint32_t                  len,
+                  const tun_gso_segment_fn& segment_fn)
+{
+  uint8_t gso_type = vnet_hdr.gso_type & ~TUN_VNET_HDR_GSO_ECN;
+
+  if (gso_type == TUN_VNET_HDR_GSO_NONE) {
+    if (vnet_hdr.flags & TUN_VNET_HDR_F_NEEDS_CSUM) {
+      // The checksum field holds the pseudo-header sum, the rest is summed from csum_start to the end of the packet
+      uint32_t start = vnet_hdr.csum_start;
+      uint32_t field = start + vnet_hdr.csum_offset;
+      if (field + 2 > len) {
+        return -1;
+      }
+      uint16_t csum = ~csum_fold(csum_add(0, &pkt[start], len - start));
+      if (csum == 0 and vnet_hdr.csum_offset == 6) {
+        // A zero UDP checksum means no checksum
+        csum = 0xffff;
+      }
+      set_be16(&pkt[field], csum);
+    }
+    segment_fn(pkt, len, nullptr, 0);
+    return 1;
+  }
+
+  if (gso_type != TUN_VNET_HDR_GSO_TCPV4 and gso_type != TUN_VNET_HDR_GSO_TCPV6) {
+    return -1;
+  }
+  uint32_t ip_hdr_len  = 0;
+  uint32_t tcp_hdr_len = 0;
+  if (not parse_tcp(pkt, len, ip_hdr_len, tcp_hdr_len)) {
+    return -1;
+  }
+  if ((gso_type == TUN_VNET_HDR_GSO_TCPV6) != ((pkt[0] >> 4U) == 6)) {
+    return -1;
+  }
+  uint32_t hdr_len     = ip_hdr_len + tcp_hdr_len;
+  uint32_t payload_len = len - hdr_len;
+  uint32_t mss         = vnet_hdr.gso_size;
+  if (mss == 0 or payload_len == 0 or hdr_len > MAX_HDR_LEN) {
+    return -1;
+  }
+
+  const uint8_t* payload = &pkt[hdr_len];
+  uint32_t       seq     = get_be32(&pkt[ip_hdr_len + 4]);
+  uint16_t       ip_id   = get_be16(&pkt[4]);
+  uint8_t        flags   = pkt[ip_hdr_len + 13];
+  uint8_t        hdr[MAX_HDR_LEN];
+
+  int nof_segments = 0;
+  for (uint32_t offset = 0; offset < payload_len; offset += mss) {
+    uint32_t seg_len = std::min(mss, payload_len - offset);
+    bool     last    = offset + seg_len == payload_len;
+
+    memcpy(hdr, pkt, hdr_len);
+    if ((hdr[0] >> 4U) == 4) {
+      set_be16(&hdr[4], ip_id + nof_segments);
+    }
+    set_ip_pkt_len(hdr, ip_hdr_len, hdr_len + seg_len);
+
+    // FIN and PSH belong to the last segment, CWR to the first one
+    uint8_t* tcp = &hdr[ip_hdr_len];
+    set_be32(&tcp[4], seq + offset);
+    tcp[13] = flags & ~(last ? 0 : TCP_FLAG_FIN | TCP_FLAG_PSH) & ~(nof_segments == 0 ? 0 : TCP_FLAG_CWR);
+    set_be16(&tcp[TCP_CSUM_OFFSET], 0);
+    uint64_t sum = tcp_pseudo_hdr_sum(hdr, tcp_hdr_len + seg_len);
+    sum          = csum_add(sum, tcp, tcp_hdr_len);
+    sum          = csum_add(sum, &payload[offset], seg_len);
+    set_be16(&tcp[TCP_CSUM_OFFSET], ~csum_fold(sum));
+
+    segment_fn(hdr, hdr_len, &payload[offset], seg_len);
+    nof_segments++;
+  }
+
+  return nof_segments;
+}
+
+tun_gro_batch::tun_gro_batch()
+{
+  pdus.reserve(MAX_SEGMENTS);
+  iov.reserve(MAX_SEGMENTS + 1);
+}
+
+bool tun_gro_batch::can_start(const srsran::byte_buffer_t& pdu, flow_t& f) const
+{
+  const uint8_t* pkt = pdu.msg;
+  if (not parse_tcp(pkt, pdu.N_bytes, f.ip_hdr_len, f.tcp_hdr_len) or ip_pkt_len(pkt) != pdu.N_bytes) {
+    return false;
+  }
+  // Neither IPv4 options nor fragments
+  if ((pkt[0] >> 4U) == 4 and (f.ip_hdr_len != IPV4_MIN_HDR_LEN or (get_be16(&pkt[6]) & 0x3fffU) != 0)) {
+    return false;
+  }
+  // Only plain data segments
+  const uint8_t* tcp   = &pkt[f.ip_hdr_len];
+  uint8_t        flags = tcp[13];
+  if ((flags & ~TCP_FLAG_PSH) != TCP_FLAG_ACK) {
+    return false;
+  }
+  uint32_t payload_len = pdu.N_bytes - f.ip_hdr_len - f.tcp_hdr_len;
+  if (payload_len == 0) {
+    return false;
+  }
+  // The host does not check the checksums of the merged packet, so do it here
+  uint64_t sum = tcp_pseudo_hdr_sum(pkt, pdu.N_bytes - f.ip_hdr_len);
+  if (csum_fold(csum_add(sum, tcp, pdu.N_bytes - f.ip_hdr_len)) != 0xffff) {
+    return false;
+  }
+
+  f.mss        = payload_len;
+  f.next_seq   = get_be32(&tcp[4]) + payload_len;
+  f.total_len  = pdu.N_bytes;
+  f.next_ip_id = get_be16(&pkt[4]) + 1;
+  f.closed     = (flags & TCP_FLAG_PSH) != 0;
+  return true;
+}
+
+bool tun_gro_batch::can_append(const srsran::byte_buffer_t& pdu) const
+{
+  if (flow.closed or pdus.size() >= MAX_SEGMENTS) {
+    return false;
+  }
+  flow_t f = {};
+  if (not can_start(pdu, f) or f.ip_hdr_len != flow.ip_hdr_len or f.tcp_hdr_len != flow.tcp_hdr_len or
+      f.mss > flow.mss or flow.total_len + f.mss > TUN_GSO_MAX_PKT_LEN) {
+    return false;
+  }
+
+  const uint8_t* first = pdus.front()->msg;
+  const uint8_t* pkt   = pdu.msg;
+  if ((pkt[0] >> 4U) == 4) {
+    // Same TOS, DF flag, TTL and addresses, and consecutive identification
+    if (pkt[1] != first[1] or pkt[6] != first[6] or pkt[8] != first[8] or memcmp(&pkt[12], &first[12], 8) != 0 or
+        get_be16(&pkt[4]) != flow.next_ip_id) {
+      return false;
+    }
+  } else {
+    // Same traffic class, flow label, hop limit and addresses
+    if (memcmp(pkt, first, 4) != 0 or pkt[7] != first[7] or memcmp(&pkt[8], &first[8], 32) != 0) {
+      return false;
+    }
+  }
+
+  // Same ports, acknowledgment, window and options, and the next sequence number
+  const uint8_t* tcp       = &pkt[f.ip_hdr_len];
+  const uint8_t* first_tcp = &first[f.ip_hdr_len];
+  return memcmp(tcp, first_tcp, 4) == 0 and memcmp(&tcp[8], &first_tcp[8], 4) == 0 and
+         memcmp(&tcp[14], &first_tcp[14], 2) == 0 and
+         memcmp(&tcp[TCP_MIN_HDR_LEN], &first_tcp[TCP_MIN_HDR_LEN], f.tcp_hdr_len - TCP_MIN_HDR_LEN) == 0 and
+         get_be32(&tcp[4]) == flow.next_seq;
+}
+
+bool tun_gro_batch::add(srsran::unique_byte_buffer_t& pdu)
+{
+  if (pdus.empty()) {
+    if (not can_start(*pdu, flow)) {
+      // Written on its own
+      flow        = {};
+      flow.closed = true;
+    }
+    pdus.push_back(std::move(pdu));
+    return true;
+  }
+
+  if (not can_append(*pdu)) {
+    return false;
+  }
+  uint32_t payload_len = pdu->N_bytes - flow.ip_hdr_len - flow.tcp_hdr_len;
+  flow.next_seq += payload_len;
+  flow.total_len += payload_len;
+  flow.next_ip_id++;
+  flow.closed = (pdu->msg[flow.ip_hdr_len + 13] & TCP_FLAG_PSH) != 0 or payload_len < flow.mss;
+  pdus.push_back(std::move(pdu));
+  return true;
+}
+
+const std::vector<struct iovec>& tun_gro_batch::prepare()
+{
+  iov.clear();
+  vnet_hdr = {};
+  if (pdus.empty()) {
+    return iov;
+  }
+
+  uint32_t hdr_len = flow.ip_hdr_len + flow.tcp_hdr_len;
+  uint8_t* first   = pdus.front()->msg;
+  if (pdus.size() > 1) {
+    set_ip_pkt_len(first, flow.ip_hdr_len, flow.total_len);
+
+    // The super-packet carries the PSH flag of its last segment and the pseudo-header sum for the host to complete
+    uint8_t* tcp = &first[flow.ip_hdr_len];
+    tcp[13] |= pdus.back()->msg[flow.ip_hdr_len + 13] & TCP_FLAG_PSH;
+    set_be16(&tcp[TCP_CSUM_OFFSET], csum_fold(tcp_pseudo_hdr_sum(first, flow.total_len - flow.ip_hdr_len)));
+
+    vnet_hdr.flags       = TUN_VNET_HDR_F_NEEDS_CSUM;
+    vnet_hdr.gso_type    = (first[0] >> 4U) == 4 ? TUN_VNET_HDR_GSO_TCPV4 : TUN_VNET_HDR_GSO_TCPV6;
+    vnet_hdr.hdr_len     = hdr_len;
+    vnet_hdr.gso_size    = flow.mss;
+    vnet_hdr.csum_start  = flow.ip_hdr_len;
+    vnet_hdr.csum_offset = TCP_CSUM_OFFSET;
+  }
+
+  iov.push_back({&vnet_hdr, TUN_VNET_HDR_LEN});
+  iov.push_back({first, pdus.front()->N_bytes});
+  for (uint32_t i = 1; i < pdus.size(); i++) {
+    iov.push_back({&pdus[i]->msg[hdr_len], pdus[i]->N_bytes - hdr_len});
+  }
+  return iov;
+}
+
+void tun_gro_batch::clear()
+{
+  pdus.clear();
+  iov.clear();
+}
+
+} // namespace srsue